@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "pcap_ingest/ip_reassembler.h"
+#include "pcap_ingest/link_layer_parser.h"
+#include "pcap_ingest/pcap_reader.h"
+#include "pcap_ingest/pcapng_reader.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr size_t kPackets = 200000;
+constexpr size_t kFrameSize = 214;  // Ethernet + IPv4 + UDP + 172 byte RTP-sized payload
+constexpr int DLT_ETHERNET = 1;
+
+void put16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+std::vector<uint8_t> buildFrame(uint32_t index) {
+    std::vector<uint8_t> frame(kFrameSize, 0);
+    frame[12] = 0x08;  // EtherType IPv4
+    uint8_t* ip = frame.data() + 14;
+    uint16_t ip_len = static_cast<uint16_t>(kFrameSize - 14);
+    ip[0] = 0x45;
+    ip[2] = static_cast<uint8_t>(ip_len >> 8);
+    ip[3] = static_cast<uint8_t>(ip_len);
+    ip[8] = 64;
+    ip[9] = 17;
+    ip[12] = 10;
+    ip[15] = static_cast<uint8_t>(index);
+    ip[16] = 10;
+    ip[19] = 2;
+    return frame;
+}
+
+// Capture files are generated once and shared by all runs
+const std::string& capturePath(bool pcapng) {
+    static const std::string paths[2] = {
+        (std::filesystem::temp_directory_path() / "callflow_bench.pcap").string(),
+        (std::filesystem::temp_directory_path() / "callflow_bench.pcapng").string()};
+    static bool written = false;
+    if (!written) {
+        std::vector<uint8_t> pcap;
+        put32(pcap, 0xa1b2c3d4);
+        put16(pcap, 2);
+        put16(pcap, 4);
+        put32(pcap, 0);
+        put32(pcap, 0);
+        put32(pcap, 65535);
+        put32(pcap, DLT_ETHERNET);
+
+        std::vector<uint8_t> ng;
+        put32(ng, 0x0A0D0D0A);
+        put32(ng, 28);
+        put32(ng, 0x1A2B3C4D);
+        put16(ng, 1);
+        put16(ng, 0);
+        put32(ng, 0xFFFFFFFF);
+        put32(ng, 0xFFFFFFFF);
+        put32(ng, 28);
+        put32(ng, 1);
+        put32(ng, 20);
+        put16(ng, DLT_ETHERNET);
+        put16(ng, 0);
+        put32(ng, 65535);
+        put32(ng, 20);
+
+        for (uint32_t i = 0; i < kPackets; ++i) {
+            auto frame = buildFrame(i);
+            put32(pcap, 1700000000 + i / 1000);
+            put32(pcap, (i % 1000) * 1000);
+            put32(pcap, static_cast<uint32_t>(frame.size()));
+            put32(pcap, static_cast<uint32_t>(frame.size()));
+            pcap.insert(pcap.end(), frame.begin(), frame.end());
+
+            uint32_t padded = (static_cast<uint32_t>(frame.size()) + 3) & ~3u;
+            put32(ng, 6);
+            put32(ng, 32 + padded);
+            put32(ng, 0);
+            put32(ng, 0);
+            put32(ng, i);
+            put32(ng, static_cast<uint32_t>(frame.size()));
+            put32(ng, static_cast<uint32_t>(frame.size()));
+            ng.insert(ng.end(), frame.begin(), frame.end());
+            ng.insert(ng.end(), padded - frame.size(), 0);
+            put32(ng, 32 + padded);
+        }
+
+        const std::vector<uint8_t>* contents[2] = {&pcap, &ng};
+        for (int i = 0; i < 2; ++i) {
+            FILE* f = std::fopen(paths[i].c_str(), "wb");
+            std::fwrite(contents[i]->data(), 1, contents[i]->size(), f);
+            std::fclose(f);
+        }
+        written = true;
+    }
+    return paths[pcapng ? 1 : 0];
+}
+
+/**
+ * Read loop as done by the ingest front end: link layer strip + defrag check
+ */
+struct FrontEnd {
+    LinkLayerParser link_parser;
+    IpReassembler reassembler;
+    uint64_t datagram_bytes = 0;
+
+    void onPacket(const uint8_t* data, size_t len, int dlt) {
+        uint16_t eth_type = 0;
+        int offset = link_parser.parse(data, len, dlt, eth_type);
+        if (offset < 0 || static_cast<size_t>(offset) >= len) {
+            return;
+        }
+        auto datagram = reassembler.processPacket(data + offset, len - offset, Timestamp());
+        if (datagram.has_value()) {
+            datagram_bytes += datagram->size();
+        }
+    }
+};
+
+/**
+ * Classic pcap through the memory-mapped reader
+ */
+void BM_PcapMmapRead(benchmark::State& state) {
+    const std::string& path = capturePath(false);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        PcapReader reader;
+        reader.open(path);
+        FrontEnd front_end;
+        int dlt = reader.getDatalinkType();
+        reader.processPackets([&](const uint8_t* data, const pcap_pkthdr* header, void*) {
+            front_end.onPacket(data, header->caplen, dlt);
+        });
+        benchmark::DoNotOptimize(front_end.datagram_bytes);
+        bytes += static_cast<int64_t>(reader.getStats().bytes_processed);
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations() * kPackets);
+}
+BENCHMARK(BM_PcapMmapRead)->Unit(benchmark::kMillisecond);
+
+/**
+ * pcapng, blocks copied into a buffer with fread (previous behaviour)
+ */
+void BM_PcapngStreamRead(benchmark::State& state) {
+    const std::string& path = capturePath(true);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        PcapngReader reader;
+        reader.setUseMmap(false);
+        reader.open(path);
+        FrontEnd front_end;
+        reader.processPackets([&](uint32_t, uint64_t, const uint8_t* data, uint32_t cap_len,
+                                  uint32_t, const PcapngPacketMetadata&) {
+            front_end.onPacket(data, cap_len, DLT_ETHERNET);
+        });
+        benchmark::DoNotOptimize(front_end.datagram_bytes);
+        bytes += static_cast<int64_t>(reader.getStats().bytes_read);
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations() * kPackets);
+}
+BENCHMARK(BM_PcapngStreamRead)->Unit(benchmark::kMillisecond);
+
+/**
+ * pcapng, blocks parsed in place from the mapping
+ */
+void BM_PcapngMmapRead(benchmark::State& state) {
+    const std::string& path = capturePath(true);
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        PcapngReader reader;
+        reader.open(path);
+        FrontEnd front_end;
+        reader.processPackets([&](uint32_t, uint64_t, const uint8_t* data, uint32_t cap_len,
+                                  uint32_t, const PcapngPacketMetadata&) {
+            front_end.onPacket(data, cap_len, DLT_ETHERNET);
+        });
+        benchmark::DoNotOptimize(front_end.datagram_bytes);
+        bytes += static_cast<int64_t>(reader.getStats().bytes_read);
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations() * kPackets);
+}
+BENCHMARK(BM_PcapngMmapRead)->Unit(benchmark::kMillisecond);
+
+}  // namespace
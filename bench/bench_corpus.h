@@ -0,0 +1,609 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "protocol_parsers/hpack_huffman.h"
+
+/**
+ * Synthetic control-plane messages shared by the benchmarks
+ *
+ * Each builder returns one wire-format message for subscriber @p i, so
+ * corpora with distinct IMSIs, TEIDs and session ids can be generated
+ * without capture files. The encodings cover the IEs / AVPs the parsers in
+ * this tree decode on the ingest path.
+ */
+namespace callflow {
+namespace bench {
+
+inline void putBe(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int shift = 8 * (bytes - 1); shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+inline void append(std::vector<uint8_t>& out, const std::vector<uint8_t>& data) {
+    out.insert(out.end(), data.begin(), data.end());
+}
+
+inline void append(std::vector<uint8_t>& out, const std::string& data) {
+    out.insert(out.end(), data.begin(), data.end());
+}
+
+inline std::string imsiOf(uint32_t i) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "00101%010u", i);
+    return buf;
+}
+
+inline std::string msisdnOf(uint32_t i) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "4670%08u", i % 100000000u);
+    return buf;
+}
+
+// 10.x.y.z address of subscriber i
+inline std::vector<uint8_t> ueAddress(uint32_t i) {
+    return {10, static_cast<uint8_t>(i >> 16), static_cast<uint8_t>(i >> 8),
+            static_cast<uint8_t>(i)};
+}
+
+// TBCD digits, low nibble first, 0xF filler
+inline std::vector<uint8_t> tbcd(const std::string& digits) {
+    std::vector<uint8_t> out;
+    for (size_t d = 0; d < digits.size(); d += 2) {
+        uint8_t lo = static_cast<uint8_t>(digits[d] - '0');
+        uint8_t hi = d + 1 < digits.size() ? static_cast<uint8_t>(digits[d + 1] - '0') : 0x0F;
+        out.push_back(static_cast<uint8_t>((hi << 4) | lo));
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Diameter (RFC 6733): Gx Credit-Control-Request (initial)
+// ---------------------------------------------------------------------------
+
+inline void putAvp(std::vector<uint8_t>& out, uint32_t code, const std::vector<uint8_t>& data) {
+    putBe(out, code, 4);
+    out.push_back(0x40);  // Mandatory
+    putBe(out, 8 + data.size(), 3);
+    append(out, data);
+    out.resize((out.size() + 3) & ~size_t(3), 0);
+}
+
+inline void putAvp(std::vector<uint8_t>& out, uint32_t code, const std::string& data) {
+    putAvp(out, code, std::vector<uint8_t>(data.begin(), data.end()));
+}
+
+inline void putAvpU32(std::vector<uint8_t>& out, uint32_t code, uint32_t value) {
+    std::vector<uint8_t> data;
+    putBe(data, value, 4);
+    putAvp(out, code, data);
+}
+
+inline std::vector<uint8_t> diameterCcr(uint32_t i) {
+    const std::string host = "pcef.epc.mnc001.mcc001.3gppnetwork.org";
+    const std::string realm = "epc.mnc001.mcc001.3gppnetwork.org";
+
+    std::vector<uint8_t> avps;
+    putAvp(avps, 263, host + ";" + std::to_string(i) + ";1");  // Session-Id
+    putAvpU32(avps, 258, 16777238);                          // Auth-Application-Id (Gx)
+    putAvp(avps, 264, host);                                 // Origin-Host
+    putAvp(avps, 296, realm);                                // Origin-Realm
+    putAvp(avps, 283, realm);                                // Destination-Realm
+    putAvpU32(avps, 416, 1);                                 // CC-Request-Type INITIAL
+    putAvpU32(avps, 415, 0);                                 // CC-Request-Number
+
+    std::vector<uint8_t> subscription;
+    putAvpU32(subscription, 450, 1);      // Subscription-Id-Type END_USER_IMSI
+    putAvp(subscription, 444, imsiOf(i));  // Subscription-Id-Data
+    putAvp(avps, 443, subscription);
+    putAvp(avps, 8, ueAddress(i));  // Framed-IP-Address
+    putAvp(avps, 30, std::string("ims"));  // Called-Station-Id
+
+    std::vector<uint8_t> msg;
+    msg.push_back(1);
+    putBe(msg, 20 + avps.size(), 3);
+    msg.push_back(0xC0);  // Request, proxiable
+    putBe(msg, 272, 3);   // Credit-Control
+    putBe(msg, 16777238, 4);
+    putBe(msg, i, 4);  // Hop-by-Hop
+    putBe(msg, i, 4);  // End-to-End
+    append(msg, avps);
+    return msg;
+}
+
+// ---------------------------------------------------------------------------
+// Diameter Gy (TS 32.299): Credit-Control-Request (update) with MSCC groups
+// ---------------------------------------------------------------------------
+
+inline void putVendorAvp(std::vector<uint8_t>& out, uint32_t code, uint32_t vendor,
+                         const std::vector<uint8_t>& data) {
+    putBe(out, code, 4);
+    out.push_back(0xC0);  // Vendor-specific, mandatory
+    putBe(out, 12 + data.size(), 3);
+    putBe(out, vendor, 4);
+    append(out, data);
+    out.resize((out.size() + 3) & ~size_t(3), 0);
+}
+
+inline std::vector<uint8_t> diameterGyCcrUpdate(uint32_t i) {
+    const std::string host = "pgw.epc.mnc001.mcc001.3gppnetwork.org";
+    const std::string realm = "epc.mnc001.mcc001.3gppnetwork.org";
+    constexpr uint32_t k3gpp = 10415;
+
+    std::vector<uint8_t> avps;
+    putAvp(avps, 263, host + ";" + std::to_string(i) + ";7");  // Session-Id
+    putAvp(avps, 264, host);                                 // Origin-Host
+    putAvp(avps, 296, realm);                                // Origin-Realm
+    putAvp(avps, 283, realm);                                // Destination-Realm
+    putAvpU32(avps, 258, 4);                                 // Auth-Application-Id (DCCA)
+    putAvp(avps, 461, std::string("32251@3gpp.org"));        // Service-Context-Id
+    putAvpU32(avps, 416, 2);                                 // CC-Request-Type UPDATE
+    putAvpU32(avps, 415, 1 + i % 8);                         // CC-Request-Number
+
+    std::vector<uint8_t> subscription;
+    putAvpU32(subscription, 450, 1);      // Subscription-Id-Type END_USER_IMSI
+    putAvp(subscription, 444, imsiOf(i));  // Subscription-Id-Data
+    putAvp(avps, 443, subscription);
+
+    // One MSCC per rating group: requested units plus the usage report
+    for (uint32_t rg = 1; rg <= 4; ++rg) {
+        std::vector<uint8_t> rsu;
+        std::vector<uint8_t> usu;
+        std::vector<uint8_t> total;
+        putBe(total, uint64_t{1000000} * rg + i, 8);
+        putAvp(usu, 421, total);  // CC-Total-Octets
+        putAvpU32(usu, 420, 60);  // CC-Time
+        putAvpU32(usu, 872, 3);   // Reporting-Reason QUOTA_EXHAUSTED
+
+        std::vector<uint8_t> mscc;
+        putAvp(mscc, 437, rsu);  // Requested-Service-Unit (empty)
+        putAvp(mscc, 446, usu);  // Used-Service-Unit
+        putAvpU32(mscc, 432, 100 + rg);  // Rating-Group
+        putAvpU32(mscc, 439, rg);        // Service-Identifier
+        putAvp(avps, 456, mscc);
+    }
+
+    std::vector<uint8_t> ps_information;
+    std::vector<uint8_t> charging_id;
+    putBe(charging_id, i, 4);
+    putVendorAvp(ps_information, 2, k3gpp, charging_id);  // 3GPP-Charging-Id
+    putAvp(ps_information, 30, std::string("internet"));  // Called-Station-Id
+    std::vector<uint8_t> service_information;
+    putVendorAvp(service_information, 874, k3gpp, ps_information);
+    putVendorAvp(avps, 873, k3gpp, service_information);
+
+    std::vector<uint8_t> msg;
+    msg.push_back(1);
+    putBe(msg, 20 + avps.size(), 3);
+    msg.push_back(0xC0);  // Request, proxiable
+    putBe(msg, 272, 3);   // Credit-Control
+    putBe(msg, 4, 4);     // DCCA
+    putBe(msg, i, 4);     // Hop-by-Hop
+    putBe(msg, i, 4);     // End-to-End
+    append(msg, avps);
+    return msg;
+}
+
+// ---------------------------------------------------------------------------
+// GTPv2-C (TS 29.274): Create Session Request on S11
+// ---------------------------------------------------------------------------
+
+inline void putGtpIe(std::vector<uint8_t>& out, uint8_t type, const std::vector<uint8_t>& value,
+                     uint8_t instance = 0) {
+    out.push_back(type);
+    putBe(out, value.size(), 2);
+    out.push_back(instance);
+    append(out, value);
+}
+
+inline std::vector<uint8_t> fteid(uint8_t interface_type, uint32_t teid,
+                                  const std::vector<uint8_t>& ipv4) {
+    std::vector<uint8_t> value{static_cast<uint8_t>(0x80 | interface_type)};
+    putBe(value, teid, 4);
+    append(value, ipv4);
+    return value;
+}
+
+inline std::vector<uint8_t> gtpv2CreateSession(uint32_t i) {
+    const std::vector<uint8_t> mme{192, 0, 2, 10};
+    const std::vector<uint8_t> enb{192, 0, 2, 20};
+
+    std::vector<uint8_t> ies;
+    putGtpIe(ies, 1, tbcd(imsiOf(i)));                    // IMSI
+    putGtpIe(ies, 76, tbcd(msisdnOf(i)));                 // MSISDN
+    putGtpIe(ies, 82, {6});                               // RAT Type EUTRAN
+    putGtpIe(ies, 87, fteid(10, 0x10000000u + i, mme));  // Sender F-TEID (S11 MME)
+    putGtpIe(ies, 71, {3, 'i', 'm', 's'});                // APN
+    std::vector<uint8_t> paa{1};
+    append(paa, ueAddress(i));
+    putGtpIe(ies, 79, paa);  // PAA
+
+    std::vector<uint8_t> bearer;
+    putGtpIe(bearer, 73, {5});                             // EBI
+    putGtpIe(bearer, 87, fteid(0, 0x20000000u + i, enb));  // S1-U eNB F-TEID
+    putGtpIe(ies, 93, bearer);                             // Bearer Context
+
+    std::vector<uint8_t> msg{0x48, 32};  // Version 2, TEID present; Create Session Request
+    putBe(msg, 8 + ies.size(), 2);
+    putBe(msg, 0, 4);  // TEID (unknown yet)
+    putBe(msg, i & 0xFFFFFF, 3);
+    msg.push_back(0);
+    append(msg, ies);
+    return msg;
+}
+
+// ---------------------------------------------------------------------------
+// PFCP (TS 29.244): Session Establishment Request on N4 / Sxb
+// ---------------------------------------------------------------------------
+
+inline void putPfcpIe(std::vector<uint8_t>& out, uint16_t type, const std::vector<uint8_t>& value) {
+    putBe(out, type, 2);
+    putBe(out, value.size(), 2);
+    append(out, value);
+}
+
+inline std::vector<uint8_t> pfcpSessionEstablishment(uint32_t i) {
+    const std::vector<uint8_t> smf{192, 0, 2, 30};
+
+    std::vector<uint8_t> ies;
+    std::vector<uint8_t> node_id{0};
+    append(node_id, smf);
+    putPfcpIe(ies, 60, node_id);  // Node ID
+    std::vector<uint8_t> fseid{0x02};
+    putBe(fseid, 0x0100000000000000ULL | i, 8);
+    append(fseid, smf);
+    putPfcpIe(ies, 57, fseid);  // CP F-SEID
+
+    std::vector<uint8_t> pdi;
+    putPfcpIe(pdi, 20, {0});  // Source Interface: Access
+    std::vector<uint8_t> ue_ip{0x02};
+    append(ue_ip, ueAddress(i));
+    putPfcpIe(pdi, 93, ue_ip);  // UE IP Address
+
+    std::vector<uint8_t> pdr;
+    putPfcpIe(pdr, 56, {0, 1});        // PDR ID
+    putPfcpIe(pdr, 29, {0, 0, 0, 32});  // Precedence
+    putPfcpIe(pdr, 2, pdi);            // PDI
+    putPfcpIe(ies, 1, pdr);            // Create PDR
+
+    std::vector<uint8_t> msg{0x21, 50};  // Version 1, SEID present; Session Establishment
+    putBe(msg, 12 + ies.size(), 2);
+    putBe(msg, 0, 8);  // SEID (not assigned yet)
+    putBe(msg, i & 0xFFFFFF, 3);
+    msg.push_back(0);
+    append(msg, ies);
+    return msg;
+}
+
+// ---------------------------------------------------------------------------
+// S1AP / NGAP: Initial UE Message, in the simplified IE layout
+// (id, criticality, length, value) the parsers of this tree decode
+// ---------------------------------------------------------------------------
+
+inline void putApIe(std::vector<uint8_t>& out, uint16_t id, const std::vector<uint8_t>& value) {
+    putBe(out, id, 2);
+    out.push_back(0x00);  // Criticality reject
+    out.push_back(static_cast<uint8_t>(value.size()));
+    append(out, value);
+}
+
+// EPS / 5GS mobile identity carrying an IMSI (odd number of digits)
+inline std::vector<uint8_t> imsiIdentity(uint32_t i) {
+    std::string digits = imsiOf(i);
+    std::vector<uint8_t> out{static_cast<uint8_t>(((digits[0] - '0') << 4) | 0x09)};
+    append(out, tbcd(digits.substr(1)));
+    return out;
+}
+
+inline std::vector<uint8_t> s1apInitialUeMessage(uint32_t i) {
+    std::vector<uint8_t> nas{0x07, 0x41, 0x71};  // EMM Attach Request
+    std::vector<uint8_t> identity = imsiIdentity(i);
+    nas.push_back(static_cast<uint8_t>(identity.size()));
+    append(nas, identity);
+    append(nas, std::vector<uint8_t>{0x02, 0xe0, 0xe0, 0x00, 0x04, 0x02, 0x01, 0xd0, 0x11});
+
+    std::vector<uint8_t> msg{0x00, 12, 0x40};  // initiatingMessage, InitialUEMessage
+    std::vector<uint8_t> enb_ue_id;
+    putBe(enb_ue_id, i & 0xFFFFFF, 3);
+    putApIe(msg, 8, enb_ue_id);                                        // eNB-UE-S1AP-ID
+    putApIe(msg, 26, nas);                                             // NAS-PDU
+    putApIe(msg, 67, {0x00, 0xf1, 0x10, 0x00, 0x01});                  // TAI
+    putApIe(msg, 100, {0x00, 0xf1, 0x10, 0x00, 0x00, 0x01, 0x10});     // EUTRAN-CGI
+    putApIe(msg, 134, {0x30});                                         // RRC cause
+    return msg;
+}
+
+inline std::vector<uint8_t> ngapInitialUeMessage(uint32_t i) {
+    std::vector<uint8_t> nas{0x7e, 0x00, 0x41, 0x79};  // 5GMM Registration Request
+    std::vector<uint8_t> identity = imsiIdentity(i);
+    putBe(nas, identity.size(), 2);
+    append(nas, identity);
+
+    std::vector<uint8_t> msg{0x00, 15, 0x40};  // initiatingMessage, InitialUEMessage
+    std::vector<uint8_t> ran_ue_id;
+    putBe(ran_ue_id, i, 4);
+    putApIe(msg, 85, ran_ue_id);  // RAN-UE-NGAP-ID
+    putApIe(msg, 38, nas);        // NAS-PDU
+    putApIe(msg, 121, {0x40, 0x00, 0xf1, 0x10, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0xf1, 0x10,
+                       0x00, 0x00, 0x01});  // User Location Information
+    putApIe(msg, 90, {0x18});               // RRC Establishment Cause
+    return msg;
+}
+
+// ---------------------------------------------------------------------------
+// HTTP/2 (RFC 9113) with HPACK header blocks: SBI requests on one connection
+// ---------------------------------------------------------------------------
+
+inline void putHttp2Frame(std::vector<uint8_t>& out, uint8_t type, uint8_t flags,
+                          uint32_t stream_id, const std::vector<uint8_t>& payload) {
+    putBe(out, payload.size(), 3);
+    out.push_back(type);
+    out.push_back(flags);
+    putBe(out, stream_id, 4);
+    append(out, payload);
+}
+
+// Literal header field with incremental indexing, indexed name (RFC 7541 6.2.1)
+inline void putHpackLiteral(std::vector<uint8_t>& out, uint8_t name_index,
+                            const std::string& value) {
+    out.push_back(static_cast<uint8_t>(0x40 | name_index));
+    out.push_back(static_cast<uint8_t>(value.size()));  // No Huffman, < 127 bytes
+    append(out, value);
+}
+
+/**
+ * Client preface, SETTINGS, then @p streams POST requests (HEADERS + DATA)
+ */
+inline std::vector<uint8_t> http2Connection(uint32_t i, size_t streams) {
+    static const std::string kPreface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    std::vector<uint8_t> out(kPreface.begin(), kPreface.end());
+    putHttp2Frame(out, 0x4, 0, 0, {});  // SETTINGS
+
+    for (size_t s = 0; s < streams; ++s) {
+        std::string supi = "imsi-" + imsiOf(i + static_cast<uint32_t>(s));
+        std::vector<uint8_t> block{0x83, 0x86};  // :method POST, :scheme http
+        putHpackLiteral(block, 4, "/nsmf-pdusession/v1/sm-contexts/" + supi);   // :path
+        putHpackLiteral(block, 1, "smf.5gc.mnc001.mcc001.3gppnetwork.org");   // :authority
+        putHpackLiteral(block, 31, "application/json");                       // content-type
+        putHpackLiteral(block, 58, "AMF");                                     // user-agent
+        uint32_t stream_id = static_cast<uint32_t>(2 * s + 1);
+        putHttp2Frame(out, 0x1, 0x04, stream_id, block);  // HEADERS, END_HEADERS
+
+        std::string body = "{\"supi\":\"" + supi +
+                           "\",\"pduSessionId\":5,\"dnn\":\"internet\",\"sNssai\":{\"sst\":1}}";
+        putHttp2Frame(out, 0x0, 0x01, stream_id,
+                      std::vector<uint8_t>(body.begin(), body.end()));  // DATA, END_STREAM
+    }
+    return out;
+}
+
+/**
+ * Encoder side of one HPACK context, as a peer stack would drive it: fields
+ * already in the dynamic table are sent indexed, the rest as literals with
+ * incremental indexing (name indexed when the static table has it) and
+ * Huffman-coded strings when that is shorter. Indexing the per-request
+ * :path values makes the table fill and evict over a connection.
+ */
+class HpackBlockWriter {
+public:
+    using Fields = std::vector<std::pair<std::string, std::string>>;
+
+    std::vector<uint8_t> block(const Fields& fields) {
+        std::vector<uint8_t> out;
+        for (const auto& [name, value] : fields) {
+            size_t name_index = 0;
+            for (const auto& entry : kStatic) {
+                if (name == entry.name) {
+                    if (value == entry.value) {
+                        putInteger(out, 0x80, 7, entry.index);  // Indexed field
+                        name_index = SIZE_MAX;
+                        break;
+                    }
+                    name_index = name_index ? name_index : entry.index;
+                }
+            }
+            if (name_index == SIZE_MAX) {
+                continue;
+            }
+            auto it = std::find(table_.begin(), table_.end(), std::make_pair(name, value));
+            if (it != table_.end()) {
+                putInteger(out, 0x80, 7, kStaticSize + 1 + (it - table_.begin()));
+                continue;
+            }
+
+            putInteger(out, 0x40, 6, name_index);
+            if (name_index == 0) {
+                putString(out, name);
+            }
+            putString(out, value);
+            insert(name, value);
+        }
+        return out;
+    }
+
+private:
+    struct StaticEntry {
+        size_t index;
+        const char* name;
+        const char* value;
+    };
+    static constexpr size_t kStaticSize = 61;
+    static constexpr size_t kTableSize = 4096;
+    // The static table entries the SBI corpus uses (RFC 7541 Appendix A)
+    static constexpr StaticEntry kStatic[] = {
+        {1, ":authority", ""},      {2, ":method", "GET"},        {3, ":method", "POST"},
+        {4, ":path", "/"},          {7, ":scheme", "https"},      {8, ":status", "200"},
+        {9, ":status", "204"},      {13, ":status", "404"},       {19, "accept", ""},
+        {28, "content-length", ""}, {31, "content-type", ""},     {33, "date", ""},
+        {46, "location", ""},       {58, "user-agent", ""}};
+
+    static void putInteger(std::vector<uint8_t>& out, uint8_t flags, int prefix_bits,
+                           size_t value) {
+        const size_t max_prefix = (size_t{1} << prefix_bits) - 1;
+        if (value < max_prefix) {
+            out.push_back(static_cast<uint8_t>(flags | value));
+            return;
+        }
+        out.push_back(static_cast<uint8_t>(flags | max_prefix));
+        for (value -= max_prefix; value >= 0x80; value >>= 7) {
+            out.push_back(static_cast<uint8_t>(0x80 | (value & 0x7F)));
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static void putString(std::vector<uint8_t>& out, const std::string& text) {
+        const size_t huffman_length = HpackHuffman::encodedLength(text);
+        if (huffman_length < text.size()) {
+            putInteger(out, 0x80, 7, huffman_length);
+            HpackHuffman::encode(text, out);
+        } else {
+            putInteger(out, 0x00, 7, text.size());
+            append(out, text);
+        }
+    }
+
+    void insert(const std::string& name, const std::string& value) {
+        table_.emplace_front(name, value);
+        size_ += name.size() + value.size() + 32;
+        while (size_ > kTableSize) {
+            size_ -= table_.back().first.size() + table_.back().second.size() + 32;
+            table_.pop_back();
+        }
+    }
+
+    std::deque<std::pair<std::string, std::string>> table_;
+    size_t size_ = 0;
+};
+
+/**
+ * Request header blocks of one AMF-to-core SBI connection, in send order:
+ * UDM SDM lookups, AUSF authentications, SMF context creation and PCF
+ * policy updates for subscribers @p i onwards
+ */
+inline std::vector<std::vector<uint8_t>> hpackSbiRequestBlocks(uint32_t i, size_t count) {
+    static const char* kRequests[][4] = {
+        {"GET", "udm.5gc.mnc001.mcc001.3gppnetwork.org", "/nudm-sdm/v2/", "/am-data"},
+        {"POST", "ausf.5gc.mnc001.mcc001.3gppnetwork.org", "/nausf-auth/v1/ue-authentications",
+         ""},
+        {"POST", "smf.5gc.mnc001.mcc001.3gppnetwork.org", "/nsmf-pdusession/v1/sm-contexts", ""},
+        {"POST", "pcf.5gc.mnc001.mcc001.3gppnetwork.org", "/npcf-smpolicycontrol/v1/sm-policies/",
+         "/update"}};
+
+    HpackBlockWriter writer;
+    std::vector<std::vector<uint8_t>> blocks;
+    for (size_t n = 0; n < count; ++n) {
+        const auto& request = kRequests[n % 4];
+        const std::string supi = "imsi-" + imsiOf(i + static_cast<uint32_t>(n / 4));
+        std::string path = request[2];
+        if (*request[3] || path.back() == '/') {
+            path += supi + request[3];
+        }
+
+        HpackBlockWriter::Fields fields = {{":method", request[0]},
+                                           {":scheme", "https"},
+                                           {":authority", request[1]},
+                                           {":path", path},
+                                           {"user-agent", "AMF"},
+                                           {"accept", "application/json"},
+                                           {"3gpp-sbi-target-apiroot", std::string("https://") +
+                                                                           request[1]}};
+        if (request[0][0] == 'P') {
+            fields.emplace_back("content-type", "application/json");
+            fields.emplace_back("content-length", std::to_string(180 + (n * 37) % 400));
+        }
+        fields.emplace_back("3gpp-sbi-correlation-info", supi);
+        blocks.push_back(writer.block(fields));
+    }
+    return blocks;
+}
+
+// ---------------------------------------------------------------------------
+// SCTP (RFC 9260): NGAP signalling on one association
+// ---------------------------------------------------------------------------
+
+// SCTP checksum (RFC 9260 Appendix A), bitwise
+inline uint32_t crc32c(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * One SCTP packet per DATA chunk, @p messages InitialUEMessages alternating
+ * over two streams, each split into @p fragments chunks with consecutive
+ * TSNs (B on the first, E on the last)
+ */
+inline std::vector<std::vector<uint8_t>> sctpNgapAssociation(uint32_t i, size_t messages,
+                                                            size_t fragments) {
+    std::vector<std::vector<uint8_t>> packets;
+    uint32_t tsn = 1000;
+    uint16_t ssn[2] = {0, 0};
+    for (size_t m = 0; m < messages; ++m) {
+        const std::vector<uint8_t> payload = ngapInitialUeMessage(i + static_cast<uint32_t>(m));
+        const uint16_t stream = static_cast<uint16_t>(m % 2);
+        const size_t piece = (payload.size() + fragments - 1) / fragments;
+        for (size_t f = 0; f < fragments; ++f) {
+            const size_t begin = std::min(payload.size(), f * piece);
+            const size_t end = std::min(payload.size(), begin + piece);
+
+            std::vector<uint8_t> out;
+            putBe(out, 38412, 2);
+            putBe(out, 38412, 2);
+            putBe(out, 0x5EED0001, 4);  // Verification tag
+            putBe(out, 0, 4);           // Checksum, filled below
+            out.push_back(0);           // DATA
+            out.push_back(static_cast<uint8_t>((f == 0 ? 0x02 : 0) |
+                                               (f + 1 == fragments ? 0x01 : 0)));
+            putBe(out, 16 + (end - begin), 2);
+            putBe(out, tsn++, 4);
+            putBe(out, stream, 2);
+            putBe(out, ssn[stream], 2);
+            putBe(out, 60, 4);  // NGAP
+            out.insert(out.end(), payload.begin() + begin, payload.begin() + end);
+            out.resize((out.size() + 3) & ~size_t{3}, 0);
+
+            const uint32_t crc = crc32c(out.data(), out.size());
+            for (int b = 0; b < 4; ++b) {
+                out[8 + b] = static_cast<uint8_t>(crc >> (24 - 8 * b));
+            }
+            packets.push_back(std::move(out));
+        }
+        ++ssn[stream];
+    }
+    return packets;
+}
+
+// ---------------------------------------------------------------------------
+// SIP (RFC 3261): IMS INVITE without body
+// ---------------------------------------------------------------------------
+
+inline std::string sipInvite(uint32_t i) {
+    std::string user = "+" + msisdnOf(i);
+    std::string call_id = "call-" + std::to_string(i) + "@pcscf.ims.example.com";
+    return "INVITE sip:" + msisdnOf(i + 1) + "@ims.example.com SIP/2.0\r\n"
+           "Via: SIP/2.0/UDP 10.0.0.1:5060;branch=z9hG4bK" + std::to_string(i) + "\r\n"
+           "Max-Forwards: 70\r\n"
+           "From: <sip:" + user + "@ims.example.com>;tag=" + std::to_string(i) + "\r\n"
+           "To: <sip:" + msisdnOf(i + 1) + "@ims.example.com>\r\n"
+           "Call-ID: " + call_id + "\r\n"
+           "CSeq: 1 INVITE\r\n"
+           "Contact: <sip:" + user + "@10.0.0.1:5060>\r\n"
+           "P-Asserted-Identity: <sip:" + user + "@ims.example.com>\r\n"
+           "P-Charging-Vector: icid-value=icid-" + std::to_string(i) + "\r\n"
+           "Content-Length: 0\r\n\r\n";
+}
+
+}  // namespace bench
+}  // namespace callflow
@@ -0,0 +1,325 @@
+#include <benchmark/benchmark.h>
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/utils.h"
+#include "session/flat_session_index.h"
+#include "session/session_correlator.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr size_t kSubscribers = 1000000;
+
+// Bytes currently allocated from the heap (glibc); unlike RSS this is not
+// affected by how freed pages are returned to the OS
+int64_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<int64_t>(info.uordblks + info.hblkhd);
+}
+
+/**
+ * Correlation keys of one synthetic subscriber
+ */
+struct Subscriber {
+    std::string imsi;
+    std::string ue_ip;
+    std::string icid;
+    uint32_t teid;
+    uint64_t seid;
+};
+
+Subscriber makeSubscriber(uint32_t i) {
+    char buf[48];
+    Subscriber sub;
+    std::snprintf(buf, sizeof(buf), "00101%010u", i);
+    sub.imsi = buf;
+    std::snprintf(buf, sizeof(buf), "10.%u.%u.%u", i >> 16, (i >> 8) & 0xFF, i & 0xFF);
+    sub.ue_ip = buf;
+    std::snprintf(buf, sizeof(buf), "pcscf.ims-%08x", i * 2654435761u);
+    sub.icid = buf;
+    sub.teid = 0x10000000u + i * 7;  // Strided, as allocated by an SGW
+    sub.seid = 0x0100000000000000ULL | i;
+    return sub;
+}
+
+const std::vector<Subscriber>& subscribers() {
+    static const std::vector<Subscriber> subs = [] {
+        std::vector<Subscriber> out;
+        out.reserve(kSubscribers);
+        for (uint32_t i = 0; i < kSubscribers; ++i) {
+            out.push_back(makeSubscriber(i));
+        }
+        return out;
+    }();
+    return subs;
+}
+
+// Subscribers in the order their messages arrive
+std::vector<uint32_t> shuffledOrder(size_t count, uint32_t seed) {
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+    return order;
+}
+
+/**
+ * Index layout used before the flat tables: node-based maps to
+ * vectors of UUID session-id strings
+ */
+struct UnorderedIndexes {
+    std::unordered_map<std::string, std::vector<std::string>> imsi;
+    std::unordered_map<std::string, std::vector<std::string>> ue_ip;
+    std::unordered_map<uint32_t, std::vector<std::string>> teid;
+
+    void add(const Subscriber& sub, uint32_t session) {
+        char id[40];
+        std::snprintf(id, sizeof(id), "%08x-0000-4000-8000-%012x", session, session);
+        imsi[sub.imsi].push_back(id);
+        ue_ip[sub.ue_ip].push_back(id);
+        teid[sub.teid].push_back(id);
+    }
+
+    size_t lookup(const Subscriber& sub) const {
+        size_t hits = 0;
+        auto it1 = imsi.find(sub.imsi);
+        hits += it1 != imsi.end() ? it1->second.size() : 0;
+        auto it2 = ue_ip.find(sub.ue_ip);
+        hits += it2 != ue_ip.end() ? it2->second.size() : 0;
+        auto it3 = teid.find(sub.teid);
+        hits += it3 != teid.end() ? it3->second.size() : 0;
+        return hits;
+    }
+};
+
+/**
+ * Flat open-addressing tables mapping to dense session handles
+ */
+struct FlatIndexes {
+    FlatSessionIndex<std::string> imsi;
+    FlatSessionIndex<std::string> ue_ip;
+    FlatSessionIndex<uint32_t> teid;
+
+    void add(const Subscriber& sub, uint32_t session) {
+        imsi.insert(sub.imsi, session);
+        ue_ip.insert(sub.ue_ip, session);
+        teid.insert(sub.teid, session);
+    }
+
+    size_t lookup(const Subscriber& sub) const {
+        size_t hits = 0;
+        if (auto* handles = imsi.find(sub.imsi)) {
+            hits += handles->size();
+        }
+        if (auto* handles = ue_ip.find(sub.ue_ip)) {
+            hits += handles->size();
+        }
+        if (auto* handles = teid.find(sub.teid)) {
+            hits += handles->size();
+        }
+        return hits;
+    }
+};
+
+/**
+ * Populate IMSI, UE IP and TEID indexes for 1M subscribers; reports the
+ * heap memory the indexes hold
+ */
+template <typename Indexes>
+void BM_IndexBuild(benchmark::State& state) {
+    const auto& subs = subscribers();
+    auto order = shuffledOrder(subs.size(), 1);
+    for (auto _ : state) {
+        int64_t heap_before = heapInUse();
+        Indexes indexes;
+        for (uint32_t i : order) {
+            indexes.add(subs[i], i);
+        }
+        state.counters["index_heap_mb"] =
+            static_cast<double>(heapInUse() - heap_before) / (1024.0 * 1024.0);
+        benchmark::DoNotOptimize(indexes);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(subs.size()));
+}
+BENCHMARK_TEMPLATE(BM_IndexBuild, UnorderedIndexes)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_TEMPLATE(BM_IndexBuild, FlatIndexes)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+/**
+ * Per-message correlation lookups (IMSI + UE IP + TEID) against 1M
+ * subscribers in random order; every third lookup misses
+ */
+template <typename Indexes>
+void BM_IndexLookup(benchmark::State& state) {
+    const auto& subs = subscribers();
+    static const Indexes* indexes = [&] {
+        auto* built = new Indexes();
+        for (uint32_t i = 0; i < subs.size(); i += 3) {
+            built->add(subs[i], i);
+            built->add(subs[i + 1 < subs.size() ? i + 1 : i], i);
+        }
+        return built;
+    }();
+    auto order = shuffledOrder(subs.size(), 2);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(indexes->lookup(subs[order[next]]));
+        if (++next == order.size()) {
+            next = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_IndexLookup, UnorderedIndexes);
+BENCHMARK_TEMPLATE(BM_IndexLookup, FlatIndexes);
+
+/**
+ * Full EnhancedSessionCorrelator replay of a subscriber message mix:
+ * GTPv2 Create Session (IMSI, UE IP, TEID), PFCP (SEID, UE IP), Diameter
+ * Gx CCR (IMSI, ICID) and SIP INVITE (ICID, UE IP), each phase arriving
+ * in shuffled subscriber order. The 1M-subscriber run needs several GB
+ * of memory for the session objects themselves.
+ */
+void BM_CorrelatorReplay(benchmark::State& state) {
+    const auto& subs = subscribers();
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto order = shuffledOrder(count, 3);
+    Logger::getInstance().setLevel(LogLevel::WARN);
+
+    SessionMessageRef templates[4];
+    templates[0].protocol = ProtocolType::GTP_C;
+    templates[0].message_type = MessageType::GTP_CREATE_SESSION_REQ;
+    templates[0].interface = InterfaceType::S11;
+    templates[1].protocol = ProtocolType::PFCP;
+    templates[1].message_type = MessageType::PFCP_SESSION_ESTABLISHMENT_REQ;
+    templates[1].interface = InterfaceType::N4;
+    templates[2].protocol = ProtocolType::DIAMETER;
+    templates[2].message_type = MessageType::DIAMETER_CCR;
+    templates[2].interface = InterfaceType::DIAMETER;
+    templates[3].protocol = ProtocolType::SIP;
+    templates[3].message_type = MessageType::SIP_INVITE;
+    templates[3].interface = InterfaceType::IMS_SIP;
+
+    for (auto _ : state) {
+        EnhancedSessionCorrelator correlator;
+        for (int phase = 0; phase < 4; ++phase) {
+            for (uint32_t i : order) {
+                const Subscriber& sub = subs[i];
+                SessionMessageRef& msg = templates[phase];
+                msg.correlation_key = SessionCorrelationKey{};
+                switch (phase) {
+                    case 0:
+                        msg.correlation_key.imsi = sub.imsi;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        msg.correlation_key.teid_s1u = sub.teid;
+                        break;
+                    case 1:
+                        msg.correlation_key.seid_n4 = sub.seid;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        break;
+                    case 2:
+                        msg.correlation_key.imsi = sub.imsi;
+                        msg.correlation_key.icid = sub.icid;
+                        break;
+                    default:
+                        msg.correlation_key.icid = sub.icid;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        break;
+                }
+                correlator.addMessage(msg);
+            }
+        }
+        state.counters["sessions"] = static_cast<double>(correlator.getSessionCount());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count) * 4);
+}
+BENCHMARK(BM_CorrelatorReplay)
+    ->Arg(100000)
+    ->Arg(kSubscribers)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+/**
+ * Heap held per correlated message: replays the message mix above for
+ * 100k subscribers with the message id, 5-tuple and payload length the
+ * packet path fills in, and divides the correlator's heap growth by the
+ * number of messages. Indexes and session headers are included.
+ */
+void BM_MessageFootprint(benchmark::State& state) {
+    constexpr size_t kCount = 100000;
+    const auto& subs = subscribers();
+    auto order = shuffledOrder(kCount, 4);
+    Logger::getInstance().setLevel(LogLevel::WARN);
+
+    for (auto _ : state) {
+        int64_t heap_before = heapInUse();
+        auto correlator = std::make_unique<EnhancedSessionCorrelator>();
+        size_t messages = 0;
+        for (int phase = 0; phase < 4; ++phase) {
+            for (uint32_t i : order) {
+                const Subscriber& sub = subs[i];
+                SessionMessageRef msg;
+                msg.message_id = utils::generateUuid();
+                msg.packet_id = makePacketId(1, static_cast<uint32_t>(messages + 1));
+                msg.timestamp = Timestamp(std::chrono::milliseconds(messages));
+                msg.src_ip = sub.ue_ip;
+                msg.dst_ip = "172.16.0.1";
+                msg.src_port = 2123;
+                msg.dst_port = 2123;
+                msg.payload_length = 180;
+                switch (phase) {
+                    case 0:
+                        msg.protocol = ProtocolType::GTP_C;
+                        msg.message_type = MessageType::GTP_CREATE_SESSION_REQ;
+                        msg.interface = InterfaceType::S11;
+                        msg.correlation_key.imsi = sub.imsi;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        msg.correlation_key.teid_s1u = sub.teid;
+                        break;
+                    case 1:
+                        msg.protocol = ProtocolType::PFCP;
+                        msg.message_type = MessageType::PFCP_SESSION_ESTABLISHMENT_REQ;
+                        msg.interface = InterfaceType::N4;
+                        msg.correlation_key.seid_n4 = sub.seid;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        break;
+                    case 2:
+                        msg.protocol = ProtocolType::DIAMETER;
+                        msg.message_type = MessageType::DIAMETER_CCR;
+                        msg.interface = InterfaceType::DIAMETER;
+                        msg.correlation_key.imsi = sub.imsi;
+                        msg.correlation_key.icid = sub.icid;
+                        break;
+                    default:
+                        msg.protocol = ProtocolType::SIP;
+                        msg.message_type = MessageType::SIP_INVITE;
+                        msg.interface = InterfaceType::IMS_SIP;
+                        msg.correlation_key.icid = sub.icid;
+                        msg.correlation_key.ue_ipv4 = sub.ue_ip;
+                        break;
+                }
+                correlator->addMessage(msg);
+                ++messages;
+            }
+        }
+        state.counters["bytes_per_message"] =
+            static_cast<double>(heapInUse() - heap_before) / static_cast<double>(messages);
+        state.counters["sessions"] = static_cast<double>(correlator->getSessionCount());
+    }
+    state.counters["record_bytes"] = static_cast<double>(sizeof(StoredMessage));
+}
+BENCHMARK(BM_MessageFootprint)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+}  // namespace
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "pcap_ingest/ip_reassembler.h"
+#include "pcap_ingest/link_layer_parser.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr int kDltEthernet = 1;
+constexpr int kDltLinuxSll = 113;
+constexpr uint32_t kDatagrams = 4096;
+
+std::vector<uint8_t> ipv4Header(uint32_t i, uint16_t id, uint16_t payload_len,
+                                uint16_t frag_field) {
+    std::vector<uint8_t> ip{0x45, 0};
+    bench::putBe(ip, 20 + payload_len, 2);
+    bench::putBe(ip, id, 2);
+    bench::putBe(ip, frag_field, 2);
+    ip.push_back(64);
+    ip.push_back(17);  // UDP
+    bench::putBe(ip, 0, 2);
+    bench::append(ip, std::vector<uint8_t>{192, 0, 2, 1});
+    bench::append(ip, bench::ueAddress(i));
+    return ip;
+}
+
+/**
+ * Frames of the three link types seen in operator captures, each carrying
+ * a 200 byte IPv4 datagram
+ */
+std::vector<uint8_t> linkFrame(int kind, uint32_t i) {
+    std::vector<uint8_t> frame;
+    if (kind == 2) {
+        // Linux cooked capture (SLL): packet type, ARPHRD, address, protocol
+        bench::putBe(frame, 0, 2);
+        bench::putBe(frame, 1, 2);
+        bench::putBe(frame, 6, 2);
+        frame.resize(frame.size() + 8, 0x02);
+        bench::putBe(frame, 0x0800, 2);
+    } else {
+        frame.resize(12, 0x02);
+        if (kind == 1) {
+            bench::putBe(frame, 0x8100, 2);  // 802.1Q tag
+            bench::putBe(frame, 100 + i % 8, 2);
+        }
+        bench::putBe(frame, 0x0800, 2);
+    }
+    bench::append(frame, ipv4Header(i, static_cast<uint16_t>(i), 180, 0));
+    frame.resize(frame.size() + 180, 0);
+    return frame;
+}
+
+/**
+ * Link layer strip: range(0) selects Ethernet, 802.1Q VLAN or Linux SLL
+ */
+void BM_LinkLayerParse(benchmark::State& state) {
+    const int kind = static_cast<int>(state.range(0));
+    const int dlt = kind == 2 ? kDltLinuxSll : kDltEthernet;
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint32_t i = 0; i < 256; ++i) {
+        frames.push_back(linkFrame(kind, i));
+    }
+
+    LinkLayerParser parser;
+    size_t next = 0;
+    int64_t offsets = 0;
+    for (auto _ : state) {
+        const auto& frame = frames[next];
+        next = (next + 1) % frames.size();
+        uint16_t eth_type = 0;
+        offsets += parser.parse(frame.data(), frame.size(), dlt, eth_type);
+        benchmark::DoNotOptimize(eth_type);
+    }
+    benchmark::DoNotOptimize(offsets);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(kind == 0 ? "ethernet" : kind == 1 ? "vlan" : "linux_sll");
+}
+BENCHMARK(BM_LinkLayerParse)->DenseRange(0, 2);
+
+/**
+ * Fragments of kDatagrams 4000 byte UDP datagrams split at a 1500 byte MTU;
+ * with @p reversed the last fragment of every datagram comes first
+ */
+std::vector<std::vector<uint8_t>> fragmentCorpus(bool reversed) {
+    constexpr uint16_t kPayload = 4000;
+    constexpr uint16_t kChunk = 1480;
+    std::vector<std::vector<uint8_t>> packets;
+    for (uint32_t i = 0; i < kDatagrams; ++i) {
+        std::vector<std::vector<uint8_t>> frags;
+        for (uint16_t offset = 0; offset < kPayload; offset += kChunk) {
+            uint16_t len = std::min<uint16_t>(kChunk, kPayload - offset);
+            bool more = offset + len < kPayload;
+            auto pkt = ipv4Header(i, static_cast<uint16_t>(i), len,
+                                  static_cast<uint16_t>((more ? 0x2000 : 0) | (offset / 8)));
+            pkt.resize(pkt.size() + len, static_cast<uint8_t>(i));
+            frags.push_back(std::move(pkt));
+        }
+        if (reversed) {
+            std::swap(frags.front(), frags.back());
+        }
+        for (auto& frag : frags) {
+            packets.push_back(std::move(frag));
+        }
+    }
+    return packets;
+}
+
+/**
+ * IP defragmentation: range(0) = 0 unfragmented pass-through, 1 in-order
+ * fragments, 2 last fragment first. Items are packets.
+ */
+void BM_IpReassemble(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    std::vector<std::vector<uint8_t>> packets;
+    if (mode == 0) {
+        for (uint32_t i = 0; i < kDatagrams; ++i) {
+            auto pkt = ipv4Header(i, static_cast<uint16_t>(i), 1480, 0);
+            pkt.resize(pkt.size() + 1480, 0);
+            packets.push_back(std::move(pkt));
+        }
+    } else {
+        packets = fragmentCorpus(mode == 2);
+    }
+
+    IpReassembler reassembler;
+    Timestamp now{};
+    int64_t bytes = 0;
+    int64_t datagrams = 0;
+    for (auto _ : state) {
+        now += std::chrono::milliseconds(1);
+        for (const auto& pkt : packets) {
+            auto out = reassembler.processPacket(pkt.data(), pkt.size(), now);
+            if (out.has_value()) {
+                datagrams++;
+            }
+            bytes += static_cast<int64_t>(pkt.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(packets.size()));
+    state.SetBytesProcessed(bytes);
+    state.counters["datagrams"] =
+        benchmark::Counter(static_cast<double>(datagrams), benchmark::Counter::kIsRate);
+    state.SetLabel(mode == 0 ? "unfragmented" : mode == 1 ? "in_order" : "last_first");
+}
+BENCHMARK(BM_IpReassemble)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "common/logger.h"
+#include "event_extractor/json_exporter.h"
+#include "protocol_parsers/diameter_parser.h"
+#include "protocol_parsers/gtp_parser.h"
+#include "protocol_parsers/pfcp_parser.h"
+#include "protocol_parsers/sip_parser.h"
+#include "session/session_correlator.h"
+
+using namespace callflow;
+
+namespace {
+
+void overwriteBe(std::vector<uint8_t>& msg, size_t offset, uint64_t value, size_t bytes) {
+    for (size_t b = 0; b < bytes; ++b) {
+        msg[offset + b] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - b)));
+    }
+}
+
+/**
+ * Metadata for one message of subscriber @p i; every subscriber talks from its
+ * own address so sessions do not merge on the 5-tuple
+ */
+PacketMetadata makeMetadata(uint32_t i, uint32_t frame, uint16_t src_port, uint16_t dst_port,
+                            uint8_t protocol) {
+    PacketMetadata metadata;
+    metadata.packet_id = frame;
+    metadata.timestamp = Timestamp(std::chrono::seconds(1700000000)) +
+                         std::chrono::milliseconds(frame);
+    metadata.frame_number = frame;
+    metadata.packet_length = 200;
+    metadata.five_tuple.src_ip = "10." + std::to_string((i >> 16) & 0xFF) + "." +
+                                 std::to_string((i >> 8) & 0xFF) + "." + std::to_string(i & 0xFF);
+    metadata.five_tuple.dst_ip = "192.0.2.20";
+    metadata.five_tuple.src_port = src_port;
+    metadata.five_tuple.dst_port = dst_port;
+    metadata.five_tuple.protocol = protocol;
+    metadata.detected_protocol = ProtocolType::UNKNOWN;
+    return metadata;
+}
+
+/**
+ * Correlator fed like the ingest path: a GTPv2 Create Session, PFCP
+ * Session Establishment, Gx CCR and SIP INVITE per subscriber, parsed by
+ * the real parsers
+ */
+std::unique_ptr<EnhancedSessionCorrelator> buildCorrelator(uint32_t subscribers) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    auto correlator = std::make_unique<EnhancedSessionCorrelator>();
+    GtpParser gtp;
+    PfcpParser pfcp;
+    DiameterParser diameter;
+    SipParser sip;
+    uint32_t frame = 0;
+    for (uint32_t i = 0; i < subscribers; ++i) {
+        // Header TEID/SEID 0 ("not assigned yet") is indexed like any other
+        // key and would merge every subscriber into one session, so address
+        // the requests to the already assigned tunnel/session instead
+        auto csr = bench::gtpv2CreateSession(i);
+        overwriteBe(csr, 4, 0x10000000u + i, 4);
+        if (auto msg = gtp.parse(csr.data(), csr.size())) {
+            correlator->processPacket(makeMetadata(i, ++frame, 2123, 2123, 17),
+                                      ProtocolType::GTP_C, msg->toJson());
+        }
+        auto ser = bench::pfcpSessionEstablishment(i);
+        overwriteBe(ser, 4, 0x0100000000000000ULL | i, 8);
+        if (auto msg = pfcp.parse(ser.data(), ser.size())) {
+            correlator->processPacket(makeMetadata(i, ++frame, 8805, 8805, 17), ProtocolType::PFCP,
+                                      msg->toJson());
+        }
+        auto ccr = bench::diameterCcr(i);
+        if (auto msg = diameter.parse(ccr.data(), ccr.size())) {
+            correlator->processPacket(makeMetadata(i, ++frame, 40000, 3868, 6),
+                                      ProtocolType::DIAMETER, msg->toJson());
+        }
+        std::string invite = bench::sipInvite(i);
+        if (auto msg = sip.parse(reinterpret_cast<const uint8_t*>(invite.data()),
+                                 invite.size())) {
+            correlator->processSipMessage(*msg, makeMetadata(i, ++frame, 5060, 5060, 17));
+        }
+    }
+    correlator->finalizeSessions();
+    return correlator;
+}
+
+/**
+ * Session array with events, as served by the job results endpoint
+ */
+void BM_JsonExportSessions(benchmark::State& state) {
+    auto correlator = buildCorrelator(static_cast<uint32_t>(state.range(0)));
+    auto sessions = correlator->getAllSessions();
+    JsonExporter exporter;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        std::string json = exporter.exportSessions(sessions, true);
+        bytes += static_cast<int64_t>(json.size());
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(sessions.size()));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_JsonExportSessions)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Master and SIP-only sessions streamed one at a time (job export path)
+ */
+void BM_JsonExportStreaming(benchmark::State& state) {
+    auto correlator = buildCorrelator(static_cast<uint32_t>(state.range(0)));
+    JsonExporter exporter;
+    int64_t bytes = 0;
+    int64_t sessions = 0;
+    for (auto _ : state) {
+        sessions += static_cast<int64_t>(exporter.exportAllSessionsWithSipOnly(
+            *correlator, [&](const nlohmann::json& session) {
+                bytes += static_cast<int64_t>(session.dump().size());
+            }));
+    }
+    state.SetItemsProcessed(sessions);
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_JsonExportStreaming)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * NDJSON file export through StreamingJsonWriter
+ */
+void BM_JsonExportToFile(benchmark::State& state) {
+    auto correlator = buildCorrelator(static_cast<uint32_t>(state.range(0)));
+    auto sessions = correlator->getAllSessions();
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "callflow_bench_export.ndjson").string();
+    StreamingJsonWriter::Options options;
+    options.format = StreamingJsonWriter::Format::NDJSON;
+
+    JsonExporter exporter;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        if (!exporter.exportToFile(path, sessions, options)) {
+            state.SkipWithError("export failed");
+            break;
+        }
+        bytes += static_cast<int64_t>(std::filesystem::file_size(path));
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(sessions.size()));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_JsonExportToFile)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+}  // namespace
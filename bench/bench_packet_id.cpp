@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include "common/types.h"
+#include "common/utils.h"
+
+using namespace callflow;
+
+namespace {
+
+/**
+ * Previous behaviour: a random UUID string drawn for every packet
+ */
+void BM_PacketIdUuid(benchmark::State& state) {
+    for (auto _ : state) {
+        std::string id = utils::generateUuid();
+        benchmark::DoNotOptimize(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketIdUuid);
+
+/**
+ * Current per-packet cost: job tag and frame number packed into 64 bits
+ */
+void BM_PacketIdNumeric(benchmark::State& state) {
+    PacketMetadata metadata;
+    uint32_t frame = 0;
+    for (auto _ : state) {
+        metadata.packet_id = makePacketId(1, frame++);
+        benchmark::DoNotOptimize(metadata.packet_id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketIdNumeric);
+
+/**
+ * Cost paid only for packets that end up in an exported event
+ */
+void BM_PacketIdRenderOnExport(benchmark::State& state) {
+    uint32_t frame = 0;
+    for (auto _ : state) {
+        std::string id = packetIdToString(makePacketId(1, frame++));
+        benchmark::DoNotOptimize(id);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PacketIdRenderOnExport);
+
+}  // namespace
@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "common/logger.h"
+#include "pcap_ingest/pcap_reader.h"
+#include "pcap_ingest/sharded_packet_processor.h"
+#include "session/session_correlator.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr uint32_t kSubscribers = 2000;
+constexpr uint32_t kRtpPerCall = 20;
+constexpr uint8_t kProtoTcp = 6;
+constexpr uint8_t kProtoUdp = 17;
+constexpr uint8_t kProtoSctp = 132;
+
+const std::vector<uint8_t> kMme{192, 0, 2, 10};
+const std::vector<uint8_t> kSgw{192, 0, 2, 11};
+const std::vector<uint8_t> kEnb{192, 0, 2, 20};
+const std::vector<uint8_t> kSmf{192, 0, 2, 30};
+const std::vector<uint8_t> kUpf{192, 0, 2, 31};
+const std::vector<uint8_t> kPcef{192, 0, 2, 40};
+const std::vector<uint8_t> kPcrf{192, 0, 2, 41};
+const std::vector<uint8_t> kPcscf{192, 0, 2, 50};
+const std::vector<uint8_t> kMgw{192, 0, 2, 60};
+
+void putLe(std::vector<uint8_t>& out, uint32_t value) {
+    for (int b = 0; b < 4; ++b) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+    }
+}
+
+// SCTP checksum (RFC 4960 Appendix B), bitwise
+uint32_t crc32c(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * Ethernet + IPv4 frame around an already built transport header and payload
+ */
+std::vector<uint8_t> ethernetFrame(const std::vector<uint8_t>& src, const std::vector<uint8_t>& dst,
+                                   uint8_t protocol, const std::vector<uint8_t>& transport) {
+    std::vector<uint8_t> frame(12, 0x02);
+    bench::putBe(frame, 0x0800, 2);
+    frame.push_back(0x45);
+    frame.push_back(0);
+    bench::putBe(frame, 20 + transport.size(), 2);
+    bench::putBe(frame, 0, 2);
+    bench::putBe(frame, 0x4000, 2);  // DF
+    frame.push_back(64);
+    frame.push_back(protocol);
+    bench::putBe(frame, 0, 2);
+    bench::append(frame, src);
+    bench::append(frame, dst);
+    bench::append(frame, transport);
+    return frame;
+}
+
+std::vector<uint8_t> udp(uint16_t sport, uint16_t dport, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out;
+    bench::putBe(out, sport, 2);
+    bench::putBe(out, dport, 2);
+    bench::putBe(out, 8 + payload.size(), 2);
+    bench::putBe(out, 0, 2);
+    bench::append(out, payload);
+    return out;
+}
+
+std::vector<uint8_t> tcp(uint16_t sport, uint16_t dport, uint32_t seq, uint32_t ack, uint8_t flags,
+                         const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out;
+    bench::putBe(out, sport, 2);
+    bench::putBe(out, dport, 2);
+    bench::putBe(out, seq, 4);
+    bench::putBe(out, ack, 4);
+    out.push_back(0x50);
+    out.push_back(flags);
+    bench::putBe(out, 65535, 2);
+    bench::putBe(out, 0, 4);
+    bench::append(out, payload);
+    return out;
+}
+
+/**
+ * Single-chunk SCTP DATA packet with a valid CRC32C
+ */
+std::vector<uint8_t> sctpData(uint16_t sport, uint16_t dport, uint32_t tsn, uint32_t ppid,
+                              const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out;
+    bench::putBe(out, sport, 2);
+    bench::putBe(out, dport, 2);
+    bench::putBe(out, 0x5EED0001, 4);  // Verification tag
+    bench::putBe(out, 0, 4);           // Checksum, filled below
+    out.push_back(0);                  // DATA
+    out.push_back(0x03);               // Unfragmented (B and E)
+    bench::putBe(out, 16 + payload.size(), 2);
+    bench::putBe(out, tsn, 4);
+    bench::putBe(out, 0, 2);  // Stream 0
+    bench::putBe(out, static_cast<uint16_t>(tsn), 2);
+    bench::putBe(out, ppid, 4);
+    bench::append(out, payload);
+    out.resize((out.size() + 3) & ~size_t{3}, 0);
+
+    uint32_t crc = crc32c(out.data(), out.size());
+    for (int b = 0; b < 4; ++b) {
+        out[8 + b] = static_cast<uint8_t>(crc >> (24 - 8 * b));
+    }
+    return out;
+}
+
+std::vector<uint8_t> rtp(uint32_t ssrc, uint16_t seq) {
+    std::vector<uint8_t> out{0x80, 0x60};  // Version 2, dynamic payload type 96 (AMR-WB)
+    bench::putBe(out, seq, 2);
+    bench::putBe(out, static_cast<uint32_t>(seq) * 320, 4);
+    bench::putBe(out, ssrc, 4);
+    out.resize(12 + 160, 0xAA);
+    return out;
+}
+
+/**
+ * A mixed operator capture with one attach and one VoLTE call per
+ * subscriber: S1AP Initial UE (SCTP), GTPv2 Create Session, PFCP Session
+ * Establishment, Gx CCR on a long-lived Diameter TCP connection, SIP INVITE
+ * and a short RTP stream. Written once and shared by all runs.
+ */
+const std::string& capturePath() {
+    static const std::string path =
+        (std::filesystem::temp_directory_path() / "callflow_bench_e2e.pcap").string();
+    static bool written = false;
+    if (written) {
+        return path;
+    }
+
+    std::vector<std::vector<uint8_t>> frames;
+    uint32_t client_seq = 1000;
+    uint32_t server_seq = 5000;
+    frames.push_back(ethernetFrame(kPcef, kPcrf, kProtoTcp,
+                                   tcp(45000, 3868, client_seq++, 0, 0x02, {})));  // SYN
+    frames.push_back(ethernetFrame(kPcrf, kPcef, kProtoTcp,
+                                   tcp(3868, 45000, server_seq++, client_seq, 0x12, {})));
+    frames.push_back(ethernetFrame(kPcef, kPcrf, kProtoTcp,
+                                   tcp(45000, 3868, client_seq, server_seq, 0x10, {})));
+
+    for (uint32_t i = 0; i < kSubscribers; ++i) {
+        frames.push_back(ethernetFrame(
+            kEnb, kMme, kProtoSctp, sctpData(36412, 36412, i + 1, 18, bench::s1apInitialUeMessage(i))));
+        frames.push_back(ethernetFrame(kMme, kSgw, kProtoUdp,
+                                       udp(2123, 2123, bench::gtpv2CreateSession(i))));
+        frames.push_back(ethernetFrame(kSmf, kUpf, kProtoUdp,
+                                       udp(8805, 8805, bench::pfcpSessionEstablishment(i))));
+
+        auto ccr = bench::diameterCcr(i);
+        frames.push_back(ethernetFrame(kPcef, kPcrf, kProtoTcp,
+                                       tcp(45000, 3868, client_seq, server_seq, 0x18, ccr)));
+        client_seq += static_cast<uint32_t>(ccr.size());
+
+        std::string invite = bench::sipInvite(i);
+        frames.push_back(ethernetFrame(bench::ueAddress(i), kPcscf, kProtoUdp,
+                                       udp(5060, 5060, {invite.begin(), invite.end()})));
+
+        const uint16_t rtp_port = static_cast<uint16_t>(30000 + 2 * (i % 10000));
+        for (uint32_t p = 0; p < kRtpPerCall; ++p) {
+            frames.push_back(ethernetFrame(bench::ueAddress(i), kMgw, kProtoUdp,
+                                           udp(rtp_port, rtp_port, rtp(i, static_cast<uint16_t>(p)))));
+        }
+    }
+
+    std::vector<uint8_t> pcap;
+    putLe(pcap, 0xa1b2c3d4);
+    putLe(pcap, 0x00040002);  // Version 2.4
+    putLe(pcap, 0);
+    putLe(pcap, 0);
+    putLe(pcap, 65535);
+    putLe(pcap, 1);  // Ethernet
+    for (size_t f = 0; f < frames.size(); ++f) {
+        putLe(pcap, static_cast<uint32_t>(1700000000 + f / 10000));
+        putLe(pcap, static_cast<uint32_t>((f % 10000) * 100));
+        putLe(pcap, static_cast<uint32_t>(frames[f].size()));
+        putLe(pcap, static_cast<uint32_t>(frames[f].size()));
+        bench::append(pcap, frames[f]);
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    std::fwrite(pcap.data(), 1, pcap.size(), file);
+    std::fclose(file);
+    written = true;
+    return path;
+}
+
+/**
+ * Whole ingest pipeline over the generated capture, as a job runs it:
+ * memory-mapped read, link/IP/transport handling, parsing, correlation and
+ * session finalization. range(0) is the number of worker shards (1 = inline
+ * single-threaded PacketProcessor).
+ */
+void BM_PacketProcessorPcap(benchmark::State& state) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    const std::string& path = capturePath();
+    const size_t shards = static_cast<size_t>(state.range(0));
+    int64_t packets = 0;
+    int64_t bytes = 0;
+    size_t sessions = 0;
+    for (auto _ : state) {
+        EnhancedSessionCorrelator correlator;
+        ShardedPacketProcessor processor(correlator, shards);
+        PcapReader reader;
+        if (!reader.open(path)) {
+            state.SkipWithError("cannot open generated capture");
+            break;
+        }
+        processor.setStableInput(reader.isMemoryMapped());
+        const int dlt = reader.getDatalinkType();
+        uint32_t frame = 0;
+        reader.processPackets([&](const uint8_t* data, const pcap_pkthdr* header, void*) {
+            auto ts = std::chrono::system_clock::from_time_t(header->ts.tv_sec) +
+                      std::chrono::microseconds(header->ts.tv_usec);
+            processor.processPacket(data, header->caplen, ts, frame++, dlt);
+            bytes += header->caplen;
+        });
+        processor.finish();
+        correlator.finalizeSessions();
+        reader.close();
+        packets += frame;
+        sessions = correlator.getSessionCount() + correlator.getSipOnlySessionCount();
+    }
+    state.SetItemsProcessed(packets);
+    state.SetBytesProcessed(bytes);
+    state.counters["sessions"] = static_cast<double>(sessions);
+}
+BENCHMARK(BM_PacketProcessorPcap)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <vector>
+
+#include "bench_corpus.h"
+#include "hpack_reference_decoder.h"
+#include "common/logger.h"
+#include "protocol_parsers/diameter/diameter_gy.h"
+#include "protocol_parsers/diameter_parser.h"
+#include "protocol_parsers/gtp_parser.h"
+#include "protocol_parsers/http2_parser.h"
+#include "protocol_parsers/ngap_parser.h"
+#include "protocol_parsers/pfcp_parser.h"
+#include "protocol_parsers/s1ap/s1ap_parser.h"
+#include "transport/sctp_parser.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr uint32_t kCorpusSize = 1024;
+
+std::vector<std::vector<uint8_t>> makeCorpus(
+    const std::function<std::vector<uint8_t>(uint32_t)>& build) {
+    std::vector<std::vector<uint8_t>> corpus;
+    corpus.reserve(kCorpusSize);
+    for (uint32_t i = 0; i < kCorpusSize; ++i) {
+        corpus.push_back(build(i));
+    }
+    return corpus;
+}
+
+/**
+ * Parses the corpus round-robin with one parser instance, as a shard does
+ */
+template <typename Parser>
+void runCorpus(benchmark::State& state, const std::vector<std::vector<uint8_t>>& corpus) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    Parser parser;
+    size_t next = 0;
+    int64_t bytes = 0;
+    int64_t parsed = 0;
+    for (auto _ : state) {
+        const auto& msg = corpus[next];
+        next = (next + 1) % corpus.size();
+        auto result = parser.parse(msg.data(), msg.size());
+        parsed += result.has_value();
+        benchmark::DoNotOptimize(result);
+        bytes += static_cast<int64_t>(msg.size());
+    }
+    if (parsed != state.iterations()) {
+        state.SkipWithError("corpus message rejected by parser");
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_DiameterParse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::diameterCcr);
+    runCorpus<DiameterParser>(state, corpus);
+}
+BENCHMARK(BM_DiameterParse);
+
+/**
+ * Gy CCR-U with four MSCC groups, decoded down to the service units
+ */
+void BM_DiameterGyParse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::diameterGyCcrUpdate);
+    runCorpus<diameter::DiameterGyParser>(state, corpus);
+}
+BENCHMARK(BM_DiameterGyParse);
+
+void BM_Gtpv2Parse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::gtpv2CreateSession);
+    runCorpus<GtpParser>(state, corpus);
+}
+BENCHMARK(BM_Gtpv2Parse);
+
+void BM_PfcpParse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::pfcpSessionEstablishment);
+    runCorpus<PfcpParser>(state, corpus);
+}
+BENCHMARK(BM_PfcpParse);
+
+void BM_S1apParse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::s1apInitialUeMessage);
+    runCorpus<s1ap::S1APParser>(state, corpus);
+}
+BENCHMARK(BM_S1apParse);
+
+void BM_NgapParse(benchmark::State& state) {
+    static const auto corpus = makeCorpus(bench::ngapInitialUeMessage);
+    runCorpus<NgapParser>(state, corpus);
+}
+BENCHMARK(BM_NgapParse);
+
+/**
+ * 256 NGAP messages on one SCTP association, each in range(0) DATA chunks,
+ * through the parser's association lookup and stream reassembly up to the
+ * message callback. Each iteration replays the association on a fresh parser.
+ */
+void BM_SctpReassembly(benchmark::State& state) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    const auto packets = bench::sctpNgapAssociation(0, 256, static_cast<size_t>(state.range(0)));
+    FiveTuple five_tuple;
+    five_tuple.src_ip = "192.0.2.20";
+    five_tuple.dst_ip = "192.0.2.10";
+    five_tuple.src_port = 38412;
+    five_tuple.dst_port = 38412;
+    five_tuple.protocol = 132;
+
+    int64_t messages = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        SctpParser parser;
+        parser.setMessageCallback([&](const SctpReassembledMessage& message) {
+            ++messages;
+            bytes += static_cast<int64_t>(message.payload().size());
+        });
+        for (const auto& packet : packets) {
+            benchmark::DoNotOptimize(parser.process(packet.data(), packet.size(), five_tuple));
+        }
+    }
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_SctpReassembly)->Arg(1)->Arg(3);
+
+/**
+ * One SBI connection of range(0) requests: frame parsing plus HPACK
+ * decoding with a dynamic table that fills and evicts
+ */
+void BM_Http2Connection(benchmark::State& state) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    const size_t streams = static_cast<size_t>(state.range(0));
+    std::vector<std::vector<uint8_t>> connections;
+    for (uint32_t i = 0; i < 16; ++i) {
+        connections.push_back(bench::http2Connection(i * static_cast<uint32_t>(streams), streams));
+    }
+
+    Http2Parser parser;
+    size_t next = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        const auto& conn = connections[next];
+        next = (next + 1) % connections.size();
+        auto result = parser.parseConnection(conn.data(), conn.size());
+        benchmark::DoNotOptimize(result);
+        bytes += static_cast<int64_t>(conn.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(streams));
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_Http2Connection)->Arg(1)->Arg(32);
+
+/**
+ * HPACK decoding of range(0) synthetic request header blocks, generated in
+ * send order for one SBI connection: Huffman-coded literals, indexed fields
+ * and a dynamic table that fills and evicts. Each iteration decodes the whole
+ * sequence with a fresh table.
+ */
+template <typename Decoder = HpackDecoder, typename Decode>
+void runHpackBlocks(benchmark::State& state, Decode decode) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    const auto blocks = bench::hpackSbiRequestBlocks(0, static_cast<size_t>(state.range(0)));
+    int64_t bytes = 0;
+    for (const auto& block : blocks) {
+        bytes += static_cast<int64_t>(block.size());
+    }
+
+    Decoder decoder;
+    for (auto _ : state) {
+        decoder.reset();
+        for (const auto& block : blocks) {
+            decode(decoder, block);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(blocks.size()));
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// Owned strings per header
+void BM_HpackDecode(benchmark::State& state) {
+    runHpackBlocks(state, [](HpackDecoder& decoder, const std::vector<uint8_t>& block) {
+        auto headers = decoder.decode(block.data(), block.size());
+        benchmark::DoNotOptimize(headers);
+    });
+}
+BENCHMARK(BM_HpackDecode)->Arg(256);
+
+// Views into the block and the decoder's scratch buffer
+void BM_HpackDecodeViews(benchmark::State& state) {
+    std::vector<HpackDecoder::HeaderField> fields;
+    runHpackBlocks(state, [&fields](HpackDecoder& decoder, const std::vector<uint8_t>& block) {
+        bool ok = decoder.decode(block.data(), block.size(), fields);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(fields.data());
+    });
+}
+BENCHMARK(BM_HpackDecodeViews)->Arg(256);
+
+// Baseline: the decoder these replaced (bench/hpack_reference_decoder.h)
+void BM_HpackDecodeReference(benchmark::State& state) {
+    runHpackBlocks<bench::ReferenceHpackDecoder>(
+        state, [](bench::ReferenceHpackDecoder& decoder, const std::vector<uint8_t>& block) {
+            auto headers = decoder.decode(block.data(), block.size());
+            benchmark::DoNotOptimize(headers);
+        });
+}
+BENCHMARK(BM_HpackDecodeReference)->Arg(256);
+
+}  // namespace
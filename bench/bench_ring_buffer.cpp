@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pcap_ingest/packet_queue.h"
+#include "pcap_ingest/ring_buffer.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr size_t kItemsPerIteration = 200000;
+constexpr size_t kQueueDepth = 10000;
+constexpr size_t kBatch = 32;
+
+// Same shape as the descriptor the sharded ingest path moves through its rings
+struct Descriptor {
+    std::vector<uint8_t> datagram;
+    Timestamp timestamp{};
+    uint32_t frame_number = 0;
+    uint32_t wire_length = 0;
+};
+
+/**
+ * Baseline: mutex/condition-variable queue of heap-allocated PacketMetadata
+ */
+void BM_PacketQueue(benchmark::State& state) {
+    const size_t producers = static_cast<size_t>(state.range(0));
+    const size_t per_producer = kItemsPerIteration / producers;
+
+    for (auto _ : state) {
+        PacketQueue queue(kQueueDepth);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, per_producer]() {
+                for (size_t i = 0; i < per_producer; ++i) {
+                    auto packet = std::make_unique<PacketMetadata>();
+                    packet->frame_number = static_cast<uint32_t>(i);
+                    queue.push(std::move(packet));
+                }
+            });
+        }
+
+        size_t received = 0;
+        while (received < per_producer * producers) {
+            auto packet = queue.pop();
+            benchmark::DoNotOptimize(packet);
+            ++received;
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * per_producer * producers);
+}
+BENCHMARK(BM_PacketQueue)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/**
+ * Lock-free MPMC ring with descriptors stored by value, batched hand-off
+ */
+void BM_MpmcRing(benchmark::State& state) {
+    const size_t producers = static_cast<size_t>(state.range(0));
+    const size_t per_producer = kItemsPerIteration / producers;
+
+    for (auto _ : state) {
+        MpmcRing<Descriptor> ring(kQueueDepth);
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&ring, per_producer]() {
+                std::vector<Descriptor> batch(kBatch);
+                size_t fill = 0;
+                for (size_t i = 0; i < per_producer; ++i) {
+                    batch[fill++].frame_number = static_cast<uint32_t>(i);
+                    if (fill == kBatch || i + 1 == per_producer) {
+                        ring.pushBatch(batch.data(), fill);
+                        fill = 0;
+                    }
+                }
+            });
+        }
+
+        std::vector<Descriptor> out(kBatch);
+        size_t received = 0;
+        while (received < per_producer * producers) {
+            size_t n = ring.popBatch(out.data(), out.size());
+            benchmark::DoNotOptimize(out.data());
+            received += n;
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * per_producer * producers);
+}
+BENCHMARK(BM_MpmcRing)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+/**
+ * Lock-free SPSC ring (the reader -> shard hop), batched hand-off
+ */
+void BM_SpscRing(benchmark::State& state) {
+    for (auto _ : state) {
+        SpscRing<Descriptor> ring(kQueueDepth);
+        std::thread producer([&ring]() {
+            std::vector<Descriptor> batch(kBatch);
+            size_t fill = 0;
+            for (size_t i = 0; i < kItemsPerIteration; ++i) {
+                batch[fill++].frame_number = static_cast<uint32_t>(i);
+                if (fill == kBatch || i + 1 == kItemsPerIteration) {
+                    ring.pushBatch(batch.data(), fill);
+                    fill = 0;
+                }
+            }
+        });
+
+        std::vector<Descriptor> out(kBatch);
+        size_t received = 0;
+        while (received < kItemsPerIteration) {
+            size_t n = ring.popBatch(out.data(), out.size());
+            benchmark::DoNotOptimize(out.data());
+            received += n;
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * kItemsPerIteration);
+}
+BENCHMARK(BM_SpscRing)->UseRealTime();
+
+}  // namespace
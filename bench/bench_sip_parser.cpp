@@ -0,0 +1,326 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "common/logger.h"
+#include "protocol_parsers/sip_parser.h"
+#include "protocol_parsers/sip_scanner.h"
+#include "protocol_parsers/sip_tokenizer.h"
+
+using namespace callflow;
+
+namespace {
+
+/**
+ * One IMS registration and one VoLTE call as seen on the Gm interface
+ * (UE <-> P-CSCF), in capture order
+ */
+const std::vector<std::string>& corpus() {
+    static const std::vector<std::string> messages = {
+        // REGISTER (initial, unauthenticated)
+        "REGISTER sip:ims.mnc001.mcc001.3gppnetwork.org SIP/2.0\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:5060;branch=z9hG4bK1reg1;rport\r\n"
+        "Max-Forwards: 70\r\n"
+        "From: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>;tag=reg1\r\n"
+        "To: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "Call-ID: 3c26700857d4-reg@2001:db8:10::1\r\n"
+        "CSeq: 1 REGISTER\r\n"
+        "Contact: <sip:001010123456789@[2001:db8:10::1]:5060>;+sip.instance=\"<urn:gsma:imei:35209900-176148-0>\";"
+        "+g.3gpp.icsi-ref=\"urn%3Aurn-7%3A3gpp-service.ims.icsi.mmtel\";+g.3gpp.smsip\r\n"
+        "Authorization: Digest username=\"001010123456789@ims.mnc001.mcc001.3gppnetwork.org\","
+        "realm=\"ims.mnc001.mcc001.3gppnetwork.org\",uri=\"sip:ims.mnc001.mcc001.3gppnetwork.org\","
+        "nonce=\"\",response=\"\"\r\n"
+        "Security-Client: ipsec-3gpp; alg=hmac-sha-1-96; spi-c=3929102; spi-s=3929103; "
+        "port-c=41062; port-s=41063\r\n"
+        "Require: sec-agree\r\n"
+        "Proxy-Require: sec-agree\r\n"
+        "Supported: path, gruu, sec-agree\r\n"
+        "P-Access-Network-Info: 3GPP-E-UTRAN-FDD; utran-cell-id-3gpp=0010100010019B01\r\n"
+        "Allow: INVITE, ACK, CANCEL, BYE, UPDATE, PRACK, MESSAGE, REFER, NOTIFY, OPTIONS\r\n"
+        "Expires: 600000\r\n"
+        "User-Agent: VoLTE-UE/1.0\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // 401 challenge
+        "SIP/2.0 401 Unauthorized\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:5060;branch=z9hG4bK1reg1;rport=5060\r\n"
+        "From: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>;tag=reg1\r\n"
+        "To: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>;tag=pcscf-401\r\n"
+        "Call-ID: 3c26700857d4-reg@2001:db8:10::1\r\n"
+        "CSeq: 1 REGISTER\r\n"
+        "WWW-Authenticate: Digest realm=\"ims.mnc001.mcc001.3gppnetwork.org\","
+        "nonce=\"3Zk2bV7Q0+eA1qB2c3D4e5F6g7H8i9J0kLmNoPqRsTu=\",algorithm=AKAv1-MD5,qop=\"auth\"\r\n"
+        "Security-Server: ipsec-3gpp; q=0.1; alg=hmac-sha-1-96; spi-c=8812; spi-s=8813; "
+        "port-c=5064; port-s=5066\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // 200 OK to the authenticated REGISTER
+        "SIP/2.0 200 OK\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1reg2;rport=41063\r\n"
+        "From: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>;tag=reg2\r\n"
+        "To: <sip:001010123456789@ims.mnc001.mcc001.3gppnetwork.org>;tag=scscf-200\r\n"
+        "Call-ID: 3c26700857d4-reg@2001:db8:10::1\r\n"
+        "CSeq: 2 REGISTER\r\n"
+        "Contact: <sip:001010123456789@[2001:db8:10::1]:41062>;expires=600000\r\n"
+        "Path: <sip:term@pcscf1.ims.mnc001.mcc001.3gppnetwork.org;lr>\r\n"
+        "Service-Route: <sip:orig@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "P-Associated-URI: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>, <tel:+491510000001>\r\n"
+        "P-Charging-Function-Addresses: ccf=192.0.2.10; ccf=192.0.2.11\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // INVITE with SDP offer (AMR-WB, preconditions)
+        "INVITE tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org SIP/2.0\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1inv1;rport\r\n"
+        "Max-Forwards: 70\r\n"
+        "Route: <sip:[2001:db8:20::1]:5066;lr>, <sip:orig@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Contact: <sip:001010123456789@[2001:db8:10::1]:41062>;+g.3gpp.icsi-ref="
+        "\"urn%3Aurn-7%3A3gpp-service.ims.icsi.mmtel\";+g.3gpp.mid-call;+g.3gpp.srvcc-alerting\r\n"
+        "P-Preferred-Identity: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "P-Preferred-Service: urn:urn-7:3gpp-service.ims.icsi.mmtel\r\n"
+        "P-Access-Network-Info: 3GPP-E-UTRAN-FDD; utran-cell-id-3gpp=0010100010019B01\r\n"
+        "P-Early-Media: supported\r\n"
+        "Accept-Contact: *;+g.3gpp.icsi-ref=\"urn%3Aurn-7%3A3gpp-service.ims.icsi.mmtel\"\r\n"
+        "Security-Verify: ipsec-3gpp; q=0.1; alg=hmac-sha-1-96; spi-c=8812; spi-s=8813; "
+        "port-c=5064; port-s=5066\r\n"
+        "Session-Expires: 1800\r\n"
+        "Min-SE: 90\r\n"
+        "Supported: 100rel, timer, precondition, replaces, histinfo\r\n"
+        "Require: sec-agree\r\n"
+        "Allow: INVITE, ACK, CANCEL, BYE, UPDATE, PRACK, MESSAGE, REFER, NOTIFY, INFO, OPTIONS\r\n"
+        "Content-Type: application/sdp\r\n"
+        "Content-Length: 581\r\n"
+        "\r\n"
+        "v=0\r\n"
+        "o=- 1621343425 1621343425 IN IP6 2001:db8:10::1\r\n"
+        "s=-\r\n"
+        "c=IN IP6 2001:db8:10::1\r\n"
+        "b=AS:49\r\n"
+        "b=RS:0\r\n"
+        "b=RR:2500\r\n"
+        "t=0 0\r\n"
+        "m=audio 31000 RTP/AVP 104 110 102 108 105 100\r\n"
+        "a=rtpmap:104 AMR-WB/16000/1\r\n"
+        "a=fmtp:104 mode-change-capability=2;max-red=220\r\n"
+        "a=rtpmap:110 AMR-WB/16000/1\r\n"
+        "a=fmtp:110 octet-align=1;mode-change-capability=2;max-red=220\r\n"
+        "a=rtpmap:102 AMR/8000/1\r\n"
+        "a=fmtp:102 mode-change-capability=2;max-red=220\r\n"
+        "a=rtpmap:108 AMR/8000/1\r\n"
+        "a=fmtp:108 octet-align=1;mode-change-capability=2;max-red=220\r\n"
+        "a=rtpmap:105 telephone-event/16000\r\n"
+        "a=fmtp:105 0-15\r\n"
+        "a=rtpmap:100 telephone-event/8000\r\n"
+        "a=fmtp:100 0-15\r\n"
+        "a=curr:qos local none\r\n"
+        "a=curr:qos remote none\r\n"
+        "a=des:qos mandatory local sendrecv\r\n"
+        "a=des:qos optional remote sendrecv\r\n"
+        "a=sendrecv\r\n"
+        "a=ptime:20\r\n"
+        "a=maxptime:240\r\n",
+        // 100 Trying
+        "SIP/2.0 100 Trying\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1inv1;rport=41063\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // 180 Ringing
+        "SIP/2.0 180 Ringing\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1inv1;rport=41063\r\n"
+        "Record-Route: <sip:[2001:db8:20::1]:5066;lr>\r\n"
+        "Record-Route: <sip:mt@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>;tag=callee1\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Contact: <sip:001010987654321@[2001:db8:30::1]:41062>\r\n"
+        "P-Asserted-Identity: <sip:+491510000002@ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "P-Asserted-Identity: <tel:+491510000002>\r\n"
+        "Require: 100rel\r\n"
+        "RSeq: 1\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // 200 OK with SDP answer
+        "SIP/2.0 200 OK\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1inv1;rport=41063\r\n"
+        "Record-Route: <sip:[2001:db8:20::1]:5066;lr>\r\n"
+        "Record-Route: <sip:mt@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>;tag=callee1\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Contact: <sip:001010987654321@[2001:db8:30::1]:41062>\r\n"
+        "P-Asserted-Identity: <sip:+491510000002@ims.mnc001.mcc001.3gppnetwork.org>\r\n"
+        "P-Charging-Vector: icid-value=\"pcscf1.ims-60a4f2b1-0001\"; icid-generated-at=192.0.2.1; "
+        "orig-ioi=ims.mnc001.mcc001.3gppnetwork.org; term-ioi=ims.mnc001.mcc001.3gppnetwork.org\r\n"
+        "Session-Expires: 1800; refresher=uac\r\n"
+        "Require: timer\r\n"
+        "Content-Type: application/sdp\r\n"
+        "Content-Length: 298\r\n"
+        "\r\n"
+        "v=0\r\n"
+        "o=- 1621343426 1621343426 IN IP6 2001:db8:30::1\r\n"
+        "s=-\r\n"
+        "c=IN IP6 2001:db8:30::1\r\n"
+        "b=AS:49\r\n"
+        "t=0 0\r\n"
+        "m=audio 32000 RTP/AVP 104 105\r\n"
+        "a=rtpmap:104 AMR-WB/16000/1\r\n"
+        "a=fmtp:104 mode-change-capability=2;max-red=220\r\n"
+        "a=rtpmap:105 telephone-event/16000\r\n"
+        "a=curr:qos local sendrecv\r\n"
+        "a=curr:qos remote sendrecv\r\n"
+        "a=des:qos mandatory local sendrecv\r\n"
+        "a=des:qos mandatory remote sendrecv\r\n"
+        "a=sendrecv\r\n",
+        // ACK
+        "ACK sip:001010987654321@[2001:db8:30::1]:41062 SIP/2.0\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1ack1;rport\r\n"
+        "Route: <sip:[2001:db8:20::1]:5066;lr>, <sip:mt@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>;tag=callee1\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 1 ACK\r\n"
+        "Max-Forwards: 70\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+        // BYE (compact form, as sent by some UEs)
+        "BYE sip:001010987654321@[2001:db8:30::1]:41062 SIP/2.0\r\n"
+        "v: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1bye1;rport\r\n"
+        "Route: <sip:[2001:db8:20::1]:5066;lr>, <sip:mt@scscf1.ims.mnc001.mcc001.3gppnetwork.org:6060;lr>\r\n"
+        "f: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "t: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>;tag=callee1\r\n"
+        "i: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 2 BYE\r\n"
+        "Reason: Q.850;cause=16;text=\"Normal call clearing\"\r\n"
+        "l: 0\r\n"
+        "\r\n",
+        // 200 OK to BYE
+        "SIP/2.0 200 OK\r\n"
+        "Via: SIP/2.0/UDP [2001:db8:10::1]:41063;branch=z9hG4bK1bye1;rport=41063\r\n"
+        "From: <sip:+491510000001@ims.mnc001.mcc001.3gppnetwork.org>;tag=inv1\r\n"
+        "To: <tel:+491510000002;phone-context=ims.mnc001.mcc001.3gppnetwork.org>;tag=callee1\r\n"
+        "Call-ID: 6f1c3e0a-volte-0001@2001:db8:10::1\r\n"
+        "CSeq: 2 BYE\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n",
+    };
+    return messages;
+}
+
+size_t corpusBytes() {
+    size_t bytes = 0;
+    for (const auto& msg : corpus()) {
+        bytes += msg.size();
+    }
+    return bytes;
+}
+
+void setRates(benchmark::State& state) {
+    const auto& messages = corpus();
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messages.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * corpusBytes()));
+    state.counters["msgs/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * messages.size()), benchmark::Counter::kIsRate);
+}
+
+/**
+ * Full SipParser::parse() of every corpus message into a SipMessage
+ */
+void BM_SipParse(benchmark::State& state) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    const auto& messages = corpus();
+    SipParser parser;
+    for (auto _ : state) {
+        for (const auto& text : messages) {
+            auto msg = parser.parse(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+            benchmark::DoNotOptimize(msg);
+        }
+    }
+    setRates(state);
+}
+BENCHMARK(BM_SipParse);
+
+/**
+ * Tokenizer pass alone (start line and every header), without
+ * materializing any field: the floor for a full parse
+ */
+void BM_SipTokenize(benchmark::State& state) {
+    const auto& messages = corpus();
+    for (auto _ : state) {
+        for (const auto& text : messages) {
+            sip::MessageTokenizer tokenizer(text);
+            sip::StartLine start;
+            sip::HeaderField field;
+            size_t headers = 0;
+            if (tokenizer.startLine(start)) {
+                while (tokenizer.nextHeader(field)) {
+                    headers += field.id != sip::HeaderId::UNKNOWN;
+                }
+            }
+            benchmark::DoNotOptimize(headers);
+            benchmark::DoNotOptimize(tokenizer.body());
+        }
+    }
+    setRates(state);
+}
+BENCHMARK(BM_SipTokenize);
+
+/**
+ * Call-ID fast path used for TCP stream routing
+ */
+void BM_SipExtractCallId(benchmark::State& state) {
+    const auto& messages = corpus();
+    for (auto _ : state) {
+        for (const auto& text : messages) {
+            auto call_id =
+                SipParser::extractCallId(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+            benchmark::DoNotOptimize(call_id);
+        }
+    }
+    setRates(state);
+}
+BENCHMARK(BM_SipExtractCallId);
+
+/**
+ * TCP stream framing: header end plus Content-Length over the corpus sent
+ * back to back on one connection; arg selects scalar / SSE2 / AVX2
+ */
+void BM_SipFrameStream(benchmark::State& state) {
+    const auto isa = static_cast<sip::ScanIsa>(state.range(0));
+    if (isa > sip::activeScanIsa()) {
+        state.SkipWithError("instruction set not supported on this CPU");
+        return;
+    }
+    std::string stream;
+    for (const auto& msg : corpus()) {
+        stream += msg;
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(stream.data());
+
+    for (auto _ : state) {
+        size_t pos = 0;
+        size_t frames = 0;
+        while (size_t len = sip::completeMessageLength(data + pos, stream.size() - pos, isa)) {
+            pos += len;
+            ++frames;
+        }
+        benchmark::DoNotOptimize(frames);
+    }
+    setRates(state);
+    state.SetLabel(sip::scanIsaName(isa));
+}
+BENCHMARK(BM_SipFrameStream)
+    ->Arg(static_cast<int>(sip::ScanIsa::SCALAR))
+    ->Arg(static_cast<int>(sip::ScanIsa::SSE2))
+    ->Arg(static_cast<int>(sip::ScanIsa::AVX2));
+
+}  // namespace
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "pcap_ingest/tcp_reassembler.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr size_t kSegmentBytes = 512;
+
+std::vector<FlowKey> makeFlows(size_t count) {
+    std::vector<FlowKey> flows(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t client[4] = {10, static_cast<uint8_t>(i >> 16), static_cast<uint8_t>(i >> 8),
+                                   static_cast<uint8_t>(i)};
+        const uint8_t server[4] = {192, 0, 2, 1};
+        flows[i].src_ip = IpAddress::fromV4(client);
+        flows[i].dst_ip = IpAddress::fromV4(server);
+        flows[i].src_port = static_cast<uint16_t>(32768 + i % 28000);
+        flows[i].dst_port = 3868;
+        flows[i].protocol = 6;
+    }
+    return flows;
+}
+
+/**
+ * Two segments per flow per round over range(0) concurrent connections;
+ * with range(1) set, every 16th flow receives its pair swapped so the
+ * second segment has to be buffered until the first arrives
+ */
+void BM_TcpReassemble(benchmark::State& state) {
+    const size_t flow_count = static_cast<size_t>(state.range(0));
+    const bool reorder = state.range(1) != 0;
+    const auto flows = makeFlows(flow_count);
+    const std::vector<uint8_t> payload(kSegmentBytes, 0x5a);
+    const ByteView segment(payload);
+
+    TcpReassembler reassembler;
+    std::vector<uint32_t> next_seq(flow_count, 1);
+    Timestamp now{};
+    size_t peak_buffered = 0;
+    size_t delivered = 0;
+
+    for (auto _ : state) {
+        now += std::chrono::milliseconds(1);
+        for (size_t i = 0; i < flow_count; ++i) {
+            uint32_t seq = next_seq[i];
+            uint32_t first = seq;
+            uint32_t second = seq + kSegmentBytes;
+            if (reorder && i % 16 == 0) {
+                std::swap(first, second);
+            }
+            delivered += reassembler.processSegment(flows[i], first, segment, false, false, now)
+                             .size();
+            if (reorder && i % 16 == 0) {
+                peak_buffered = std::max(peak_buffered, reassembler.bufferedBytes());
+            }
+            delivered += reassembler.processSegment(flows[i], second, segment, false, false, now)
+                             .size();
+            next_seq[i] = seq + 2 * kSegmentBytes;
+        }
+    }
+    benchmark::DoNotOptimize(delivered);
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * flow_count * 2));
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * flow_count * 2 * kSegmentBytes));
+    state.counters["streams"] = static_cast<double>(reassembler.activeStreams());
+    state.counters["peak_buffered_KB"] = static_cast<double>(peak_buffered) / 1024.0;
+}
+BENCHMARK(BM_TcpReassemble)
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({500000, 0})
+    ->Args({500000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
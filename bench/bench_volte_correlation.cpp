@@ -0,0 +1,215 @@
+#include <benchmark/benchmark.h>
+
+#include <arpa/inet.h>
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "common/logger.h"
+#include "correlation/diameter/diameter_correlator.h"
+#include "correlation/gtpv2/gtpv2_correlator.h"
+#include "correlation/identity/subscriber_context_manager.h"
+#include "correlation/nas/nas_correlator.h"
+#include "correlation/rtp/rtp_correlator.h"
+#include "correlation/sip/sip_correlator.h"
+#include "correlation/volte/volte_correlator.h"
+#include "protocol_parsers/diameter/diameter_base.h"
+#include "protocol_parsers/diameter/diameter_types.h"
+
+using namespace callflow;
+using namespace callflow::correlation;
+
+namespace {
+
+constexpr uint32_t kCalls = 10000;
+constexpr uint32_t kDiameterSessions = 100000;
+constexpr uint32_t kUeAddresses = 40000;  // Two per call plus idle UEs
+constexpr double kCaptureSeconds = 3600.0;
+constexpr double kCallSeconds = 90.0;
+
+std::string ueIp(uint32_t ue) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "10.%u.%u.%u", 100 + (ue >> 16), (ue >> 8) & 0xFF, ue & 0xFF);
+    return buf;
+}
+
+std::string msisdn(uint32_t ue) {
+    return "4915" + std::to_string(100000000 + ue);
+}
+
+std::string sdpFor(const std::string& ip) {
+    return "v=0\n"
+           "o=- 1 1 IN IP4 " + ip + "\n"
+           "s=Call\n"
+           "c=IN IP4 " + ip + "\n"
+           "t=0 0\n"
+           "m=audio 49170 RTP/AVP 0\n"
+           "a=rtpmap:0 PCMU/8000\n";
+}
+
+void addCall(SipCorrelator& sip, uint32_t call, double start, uint32_t& frame) {
+    uint32_t caller = call * 2;
+    uint32_t callee = call * 2 + 1;
+    std::string call_id = "call-" + std::to_string(call) + "@ims.example.com";
+
+    SipMessage invite;
+    invite.setRequest(true);
+    invite.setMethod("INVITE");
+    invite.setCallId(call_id);
+    invite.setFromUri("sip:" + msisdn(caller) + "@ims.mnc001.mcc001.3gppnetwork.org");
+    invite.setFromTag("from-" + std::to_string(call));
+    invite.setToUri("sip:" + msisdn(callee) + "@ims.mnc001.mcc001.3gppnetwork.org");
+    invite.setCSeq(1);
+    invite.setCSeqMethod("INVITE");
+    invite.setTimestamp(start);
+    invite.setFrameNumber(frame++);
+    invite.setSdpBody(sdpFor(ueIp(caller)));
+    sip.addMessage(invite);
+
+    SipMessage ok;
+    ok.setRequest(false);
+    ok.setStatusCode(200);
+    ok.setCallId(call_id);
+    ok.setFromTag("from-" + std::to_string(call));
+    ok.setToTag("to-" + std::to_string(call));
+    ok.setCSeq(1);
+    ok.setCSeqMethod("INVITE");
+    ok.setTimestamp(start + 2.0);
+    ok.setFrameNumber(frame++);
+    ok.setSdpBody(sdpFor(ueIp(callee)));
+    sip.addMessage(ok);
+
+    SipMessage bye;
+    bye.setRequest(true);
+    bye.setMethod("BYE");
+    bye.setCallId(call_id);
+    bye.setFromTag("from-" + std::to_string(call));
+    bye.setToTag("to-" + std::to_string(call));
+    bye.setCSeq(2);
+    bye.setCSeqMethod("BYE");
+    bye.setTimestamp(start + kCallSeconds);
+    bye.setFrameNumber(frame++);
+    sip.addMessage(bye);
+}
+
+// Gx/Rx CCR/AAR carrying Session-Id and Framed-IP-Address
+void addDiameterSession(DiameterCorrelator& diameter, uint32_t id, bool gx, uint32_t ue,
+                        double start, uint32_t& frame) {
+    auto proto = std::make_shared<diameter::DiameterMessage>();
+    proto->header.request = true;
+    proto->header.command_code = static_cast<uint32_t>(
+        gx ? diameter::DiameterCommandCode::CREDIT_CONTROL : diameter::DiameterCommandCode::AA_REQUEST);
+    proto->header.application_id = static_cast<uint32_t>(
+        gx ? diameter::DiameterApplicationID::TGPP_GX : diameter::DiameterApplicationID::TGPP_RX);
+    proto->header.hop_by_hop_id = id;
+    proto->session_id = (gx ? "pgw.example.com;" : "pcscf.example.com;") + std::to_string(id);
+
+    auto framed_ip = std::make_shared<diameter::DiameterAVP>();
+    framed_ip->code = 8;  // Framed-IP-Address
+    uint32_t addr = 0;
+    inet_pton(AF_INET, ueIp(ue).c_str(), &addr);
+    framed_ip->data = {0, 1};  // Address family: IPv4
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&addr);
+    framed_ip->data.insert(framed_ip->data.end(), bytes, bytes + 4);
+    proto->avps.push_back(framed_ip);
+
+    DiameterMessage msg(proto);
+    msg.setTimestamp(start);
+    msg.setFrameNumber(frame++);
+    diameter.addMessage(msg);
+}
+
+void addRtpStream(RtpCorrelator& rtp, uint32_t ssrc, const std::string& src,
+                  const std::string& dst, double start, double end, uint32_t& frame) {
+    RtpPacketInfo packet{};
+    packet.src_ip = src;
+    packet.src_port = 49170;
+    packet.dst_ip = dst;
+    packet.dst_port = 49170;
+    packet.version = 2;
+    packet.ssrc = ssrc;
+    packet.payload_size = 160;
+    for (double ts : {start, end}) {
+        packet.frame_number = frame++;
+        packet.timestamp = ts;
+        packet.rtp_timestamp = static_cast<uint32_t>((ts - start) * 8000);
+        packet.sequence_number++;
+        rtp.addPacket(packet);
+    }
+}
+
+/**
+ * Capture with kCalls SIP calls, two RTP streams per call and
+ * kDiameterSessions Gx/Rx sessions spread over an hour; a tenth of the
+ * Diameter sessions belong to call parties around their call
+ */
+struct Capture {
+    SubscriberContextManager subscribers;
+    SipCorrelator sip{&subscribers};
+    DiameterCorrelator diameter{&subscribers};
+    Gtpv2Correlator gtpv2{&subscribers};
+    NasCorrelator nas{&subscribers};
+    RtpCorrelator rtp;
+
+    Capture() {
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<double> when(0.0, kCaptureSeconds);
+        uint32_t frame = 1;
+
+        for (uint32_t call = 0; call < kCalls; ++call) {
+            double start = when(rng);
+            addCall(sip, call, start, frame);
+            addRtpStream(rtp, call * 2, ueIp(call * 2), ueIp(call * 2 + 1), start + 2.0,
+                         start + kCallSeconds, frame);
+            addRtpStream(rtp, call * 2 + 1, ueIp(call * 2 + 1), ueIp(call * 2), start + 2.0,
+                         start + kCallSeconds, frame);
+        }
+        for (uint32_t id = 0; id < kDiameterSessions; ++id) {
+            addDiameterSession(diameter, id, id % 2 == 0, rng() % kUeAddresses, when(rng), frame);
+        }
+
+        sip.finalize();
+        diameter.finalize();
+        rtp.finalize();
+    }
+};
+
+/**
+ * Full VolteCorrelator::correlate() pass; phase 3 dominates as every call
+ * looks for Gx/Rx sessions and RTP streams inside its time window
+ */
+void BM_VolteCorrelate(benchmark::State& state) {
+    Logger::getInstance().setLevel(LogLevel::WARN);
+    static Capture* capture = new Capture();
+
+    VolteCorrelator correlator;
+    correlator.setSipCorrelator(&capture->sip);
+    correlator.setDiameterCorrelator(&capture->diameter);
+    correlator.setGtpv2Correlator(&capture->gtpv2);
+    correlator.setNasCorrelator(&capture->nas);
+    correlator.setRtpCorrelator(&capture->rtp);
+    correlator.setSubscriberContextManager(&capture->subscribers);
+
+    for (auto _ : state) {
+        correlator.correlate();
+    }
+
+    size_t diameter_linked = 0;
+    size_t rtp_linked = 0;
+    for (const auto* flow : correlator.getCallFlows()) {
+        if (flow->sip_sessions.empty()) {
+            continue;
+        }
+        diameter_linked += flow->diameter_sessions.size();
+        rtp_linked += flow->rtp_ssrcs.size();
+    }
+    state.counters["calls"] = static_cast<double>(capture->sip.getCallSessions().size());
+    state.counters["diameter_linked"] = static_cast<double>(diameter_linked);
+    state.counters["rtp_linked"] = static_cast<double>(rtp_linked);
+    state.SetItemsProcessed(state.iterations() * kCalls);
+}
+BENCHMARK(BM_VolteCorrelate)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+}  // namespace
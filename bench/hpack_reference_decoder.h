@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logger.h"
+
+/**
+ * HPACK decoder as it was before the flat dynamic table (git b87757d^)
+ *
+ * Kept only as the baseline of BM_HpackDecodeReference, so the comparison
+ * with HpackDecoder can be re-run rather than quoted. It does the same work
+ * per field as the original on purpose: the dynamic table is a deque of
+ * string pairs, every field is copied, the per-field log calls stay, and
+ * Huffman strings are returned as raw code bytes. Do not use it outside the
+ * benchmarks.
+ */
+namespace callflow {
+namespace bench {
+
+class ReferenceHpackDecoder {
+public:
+    struct DecodedHeader {
+        std::string name;
+        std::string value;
+    };
+
+    std::vector<DecodedHeader> decode(const uint8_t* data, size_t len) {
+        std::vector<DecodedHeader> headers;
+        const uint8_t* ptr = data;
+        const uint8_t* end = data + len;
+
+        while (ptr < end) {
+            uint8_t first_byte = *ptr;
+
+            // Indexed Header Field (pattern: 1xxxxxxx)
+            if ((first_byte & 0x80) != 0) {
+                uint64_t index = decodeInteger(ptr, end, 7);
+                auto entry = getTableEntry(index);
+                if (entry) {
+                    headers.push_back({entry->first, entry->second});
+                    LOG_TRACE("HPACK: Indexed header [{}]: {}={}", index, entry->first,
+                              entry->second);
+                }
+            }
+            // Literal Header Field with Incremental Indexing (pattern: 01xxxxxx)
+            else if ((first_byte & 0xC0) == 0x40) {
+                uint64_t index = decodeInteger(ptr, end, 6);
+                std::string name = decodeName(ptr, end, index);
+                std::string value = decodeString(ptr, end);
+                headers.push_back({name, value});
+                addToDynamicTable(name, value);
+                LOG_TRACE("HPACK: Literal with indexing: {}={}", name, value);
+            }
+            // Literal Header Field without Indexing / Never Indexed (0000xxxx / 0001xxxx)
+            else if ((first_byte & 0xE0) == 0x00) {
+                uint64_t index = decodeInteger(ptr, end, 4);
+                std::string name = decodeName(ptr, end, index);
+                std::string value = decodeString(ptr, end);
+                headers.push_back({name, value});
+                LOG_TRACE("HPACK: Literal without indexing: {}={}", name, value);
+            }
+            // Dynamic Table Size Update (pattern: 001xxxxx)
+            else if ((first_byte & 0xE0) == 0x20) {
+                uint64_t max_size = decodeInteger(ptr, end, 5);
+                max_dynamic_table_size_ = max_size;
+                evictDynamicTable();
+                LOG_DEBUG("HPACK: Dynamic table size update: {}", max_size);
+            } else {
+                LOG_ERROR("HPACK: Unknown header encoding: 0x{:02x}", first_byte);
+                break;
+            }
+        }
+
+        return headers;
+    }
+
+    void reset() {
+        dynamic_table_.clear();
+        current_dynamic_table_size_ = 0;
+    }
+
+private:
+    std::deque<std::pair<std::string, std::string>> dynamic_table_;
+    size_t max_dynamic_table_size_ = 4096;
+    size_t current_dynamic_table_size_ = 0;
+
+    // RFC 7541 Appendix A, index 0 unused
+    static const std::vector<std::pair<std::string, std::string>>& staticTable() {
+        static const std::vector<std::pair<std::string, std::string>> table = {
+            {"", ""},
+            {":authority", ""},
+            {":method", "GET"},
+            {":method", "POST"},
+            {":path", "/"},
+            {":path", "/index.html"},
+            {":scheme", "http"},
+            {":scheme", "https"},
+            {":status", "200"},
+            {":status", "204"},
+            {":status", "206"},
+            {":status", "304"},
+            {":status", "400"},
+            {":status", "404"},
+            {":status", "500"},
+            {"accept-charset", ""},
+            {"accept-encoding", "gzip, deflate"},
+            {"accept-language", ""},
+            {"accept-ranges", ""},
+            {"accept", ""},
+            {"access-control-allow-origin", ""},
+            {"age", ""},
+            {"allow", ""},
+            {"authorization", ""},
+            {"cache-control", ""},
+            {"content-disposition", ""},
+            {"content-encoding", ""},
+            {"content-language", ""},
+            {"content-length", ""},
+            {"content-location", ""},
+            {"content-range", ""},
+            {"content-type", ""},
+            {"cookie", ""},
+            {"date", ""},
+            {"etag", ""},
+            {"expect", ""},
+            {"expires", ""},
+            {"from", ""},
+            {"host", ""},
+            {"if-match", ""},
+            {"if-modified-since", ""},
+            {"if-none-match", ""},
+            {"if-range", ""},
+            {"if-unmodified-since", ""},
+            {"last-modified", ""},
+            {"link", ""},
+            {"location", ""},
+            {"max-forwards", ""},
+            {"proxy-authenticate", ""},
+            {"proxy-authorization", ""},
+            {"range", ""},
+            {"referer", ""},
+            {"refresh", ""},
+            {"retry-after", ""},
+            {"server", ""},
+            {"set-cookie", ""},
+            {"strict-transport-security", ""},
+            {"transfer-encoding", ""},
+            {"user-agent", ""},
+            {"vary", ""},
+            {"via", ""},
+            {"www-authenticate", ""}};
+        return table;
+    }
+
+    std::optional<std::pair<std::string, std::string>> getTableEntry(size_t index) {
+        if (index == 0) {
+            LOG_ERROR("HPACK: Invalid table index 0");
+            return std::nullopt;
+        }
+        if (index < staticTable().size()) {
+            return staticTable()[index];
+        }
+        size_t dynamic_index = index - staticTable().size();
+        if (dynamic_index < dynamic_table_.size()) {
+            return dynamic_table_[dynamic_index];
+        }
+        LOG_ERROR("HPACK: Table index {} out of range", index);
+        return std::nullopt;
+    }
+
+    std::string decodeName(const uint8_t*& data, const uint8_t* end, uint64_t index) {
+        if (index == 0) {
+            return decodeString(data, end);
+        }
+        auto entry = getTableEntry(index);
+        return entry ? entry->first : std::string();
+    }
+
+    void addToDynamicTable(const std::string& name, const std::string& value) {
+        size_t entry_size = name.length() + value.length() + 32;
+        if (entry_size > max_dynamic_table_size_) {
+            LOG_DEBUG("HPACK: Entry size {} exceeds max table size {}", entry_size,
+                      max_dynamic_table_size_);
+            reset();
+            return;
+        }
+
+        dynamic_table_.push_front({name, value});
+        current_dynamic_table_size_ += entry_size;
+        evictDynamicTable();
+        LOG_TRACE("HPACK: Added to dynamic table: {}={} (size={})", name, value, entry_size);
+    }
+
+    void evictDynamicTable() {
+        while (current_dynamic_table_size_ > max_dynamic_table_size_ && !dynamic_table_.empty()) {
+            const auto& entry = dynamic_table_.back();
+            size_t entry_size = entry.first.length() + entry.second.length() + 32;
+            current_dynamic_table_size_ -= entry_size;
+            dynamic_table_.pop_back();
+            LOG_TRACE("HPACK: Evicted from dynamic table (size={})", entry_size);
+        }
+    }
+
+    uint64_t decodeInteger(const uint8_t*& data, const uint8_t* end, uint8_t prefix_bits) {
+        if (data >= end) {
+            return 0;
+        }
+
+        uint8_t prefix_mask = (1 << prefix_bits) - 1;
+        uint64_t value = (*data) & prefix_mask;
+        data++;
+        if (value < prefix_mask) {
+            return value;
+        }
+
+        uint8_t m = 0;
+        while (data < end) {
+            uint8_t byte = *data++;
+            value += (byte & 0x7F) * (1ULL << m);
+            m += 7;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+            if (m > 63) {
+                LOG_ERROR("HPACK: Integer too large");
+                return 0;
+            }
+        }
+        return value;
+    }
+
+    std::string decodeString(const uint8_t*& data, const uint8_t* end) {
+        if (data >= end) {
+            return "";
+        }
+
+        bool huffman = ((*data) & 0x80) != 0;
+        uint64_t length = decodeInteger(data, end, 7);
+        if (data + length > end) {
+            LOG_ERROR("HPACK: String length {} exceeds available data", length);
+            return "";
+        }
+
+        if (huffman) {
+            // Never implemented: the code bytes come back as they are
+            LOG_DEBUG("HPACK: Huffman decoding not fully implemented, returning raw string");
+        }
+        std::string result(reinterpret_cast<const char*>(data), length);
+        data += length;
+        return result;
+    }
+};
+
+}  // namespace bench
+}  // namespace callflow
@@ -7,6 +7,7 @@
 
 #include "api_server/analytics_service.h"
 #include "api_server/job_manager.h"
+#include "api_server/session_index.h"
 #include "api_server/websocket_handler.h"
 #include "common/types.h"
 
@@ -54,6 +55,7 @@ private:
     std::shared_ptr<JobManager> job_manager_;
     std::shared_ptr<WebSocketHandler> ws_handler_;
     std::shared_ptr<AnalyticsService> analytics_service_;
+    SessionStore session_store_;  // Indexed session lookups + hot-session LRU
 
     void* server_impl_;  // Opaque pointer to httplib::Server
     std::thread server_thread_;
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <unordered_map>
@@ -18,6 +20,8 @@ namespace callflow {
 // Forward declarations
 class SessionCorrelator;
 class DatabaseManager;
+class DatabaseWriter;
+class EnhancedSessionCorrelator;
 
 /**
  * Progress callback function
@@ -31,6 +35,40 @@ using ProgressCallback = std::function<void(const JobId&, int, const std::string
  */
 using EventCallback = std::function<void(const JobId&, const std::string&, const nlohmann::json&)>;
 
+/**
+ * Called after a job and its result files were removed
+ */
+using JobRemovedCallback = std::function<void(const JobId&)>;
+
+/**
+ * Live metrics of a job, refreshed while it runs
+ */
+struct JobMetrics {
+    std::string message;          // Last progress message
+    int progress = 0;             // 0-100
+    uint64_t file_size = 0;       // Capture file size in bytes
+    uint64_t file_offset = 0;     // Capture bytes consumed so far
+    uint64_t packets = 0;
+    uint64_t bytes = 0;           // Captured packet bytes handed to the pipeline
+    double elapsed_sec = 0.0;     // Since ingest started
+    double packets_per_sec = 0.0; // Over the last reporting interval
+    double mbps = 0.0;            // Over the last reporting interval
+    size_t sessions_open = 0;
+    uint64_t memory_rss_bytes = 0;  // Process-wide resident memory
+
+    nlohmann::json toJson() const;
+};
+
+/**
+ * Arena statistics as reported in the job summary
+ */
+nlohmann::json arenaStatsToJson(const ArenaStats& stats);
+
+/**
+ * IP fragment reassembly statistics as reported in the job summary
+ */
+nlohmann::json defragStatsToJson(const DefragStats& stats);
+
 /**
  * Job Manager - manages background PCAP processing jobs
  */
@@ -72,6 +110,12 @@ public:
      */
     std::vector<std::shared_ptr<JobInfo>> getAllJobs();
 
+    /**
+     * Get live metrics of a job
+     * @return Metrics if the job has started in this process, nullopt otherwise
+     */
+    std::optional<JobMetrics> getJobMetrics(const JobId& job_id);
+
     /**
      * Delete a job and its results
      * @param job_id Job ID
@@ -89,6 +133,11 @@ public:
      */
     void setEventCallback(EventCallback callback) { event_callback_ = callback; }
 
+    /**
+     * Set callback for jobs removed by deleteJob() or retention cleanup
+     */
+    void setJobRemovedCallback(JobRemovedCallback callback) { job_removed_callback_ = callback; }
+
     /**
      * Get session IDs for a job
      * @param job_id Job ID
@@ -106,6 +155,7 @@ private:
         JobId job_id;
         std::string input_file;
         std::string output_file;
+        uint32_t job_tag = 0;  // Upper half of the job's PacketIds
     };
 
     /**
@@ -118,6 +168,34 @@ private:
      */
     void processJob(const JobTask& task);
 
+    /**
+     * Rate-limit state for ingest progress reports
+     */
+    struct IngestTracker {
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point last_report;
+        uint64_t last_packets = 0;
+        uint64_t last_bytes = 0;
+    };
+
+    // Minimum time between two ingest progress reports
+    static constexpr std::chrono::milliseconds kProgressInterval{250};
+
+    /**
+     * Publish ingest progress and metrics, at most once per kProgressInterval
+     * unless @p force is set. Progress maps the capture file offset to 10-65%.
+     */
+    void reportIngest(const JobId& job_id, IngestTracker& tracker, uint64_t file_offset,
+                      uint64_t file_size, uint64_t packets, uint64_t bytes,
+                      const EnhancedSessionCorrelator& correlator, bool force = false);
+
+    /**
+     * Publish progress of the final shard merge (65-70%), rate-limited like
+     * reportIngest(); the last call (@p merged == @p total) is always sent.
+     */
+    void reportMerge(const JobId& job_id, IngestTracker& tracker, size_t merged, size_t total,
+                     const EnhancedSessionCorrelator& correlator);
+
     /**
      * Update job progress
      */
@@ -130,10 +208,12 @@ private:
 
     Config config_;
     std::shared_ptr<DatabaseManager> db_;
+    std::unique_ptr<DatabaseWriter> db_writer_;  // Batched session inserts
 
     // Job storage
     std::unordered_map<JobId, std::shared_ptr<JobInfo>> jobs_;
-    std::mutex jobs_mutex_;
+    std::unordered_map<JobId, JobMetrics> metrics_;
+    std::mutex jobs_mutex_;  // Guards jobs_ and metrics_
 
     // Job queue
     std::queue<JobTask> job_queue_;
@@ -143,10 +223,12 @@ private:
     // Worker threads
     std::vector<std::thread> workers_;
     std::atomic<bool> running_;
+    std::atomic<uint32_t> next_job_tag_{1};
 
     // Callbacks
     ProgressCallback progress_callback_;
     EventCallback event_callback_;
+    JobRemovedCallback job_removed_callback_;
 };
 
 }  // namespace callflow
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+
+#include "common/types.h"
+#include "event_extractor/streaming_json_writer.h"
+
+namespace callflow {
+
+class SessionSummaryTable;
+
+/**
+ * Byte-range index over the sessions of a job result file
+ *
+ * Maps every session_id / master_id to the offset and length of its JSON
+ * object inside the result file, so a single session can be read with one
+ * seek instead of parsing the whole document. Stored next to the result file
+ * as "<result>.idx", one "offset length id" line per key.
+ */
+class SessionIndex {
+public:
+    struct Entry {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+    };
+
+    /**
+     * Path of the sidecar index for a result file
+     */
+    static std::string sidecarPath(const std::string& result_file);
+
+    void add(const std::string& id, const Entry& entry);
+
+    /**
+     * @return Byte range of the session, or nullptr if the id is unknown
+     */
+    const Entry* find(const std::string& id) const;
+
+    size_t size() const { return entries_.size(); }
+
+    bool save(const std::string& path) const;
+
+    /**
+     * Load a sidecar index
+     * @return nullptr if the file does not exist or is malformed
+     */
+    static std::shared_ptr<SessionIndex> load(const std::string& path);
+
+    /**
+     * Read and parse the single session object at @p entry
+     * @throws std::exception if the range cannot be read or parsed
+     */
+    static nlohmann::json readSession(const std::string& result_file, const Entry& entry);
+
+private:
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+/**
+ * Writes a job result document and its sidecars
+ *
+ * Produces {"metadata": ..., "sessions": [ ... ]} with one compact session
+ * object per line through a StreamingJsonWriter, recording each object's
+ * byte range in the session index and its summary row in the
+ * SessionSummaryTable as it is written.
+ */
+class SessionResultWriter {
+public:
+    /**
+     * Create @p result_file and write the metadata header
+     */
+    bool open(const std::string& result_file, const nlohmann::json& metadata);
+
+    /**
+     * Append one session object and index it by session_id and master_id
+     */
+    void addSession(const nlohmann::json& session);
+
+    /**
+     * Terminate the document and write the sidecar index and summary
+     * @return false if any write failed
+     */
+    bool close();
+
+    size_t sessionCount() const { return writer_.sessionsWritten(); }
+
+    uint64_t bytesWritten() const { return writer_.bytesWritten(); }
+
+private:
+    std::string result_file_;
+    StreamingJsonWriter writer_;
+    SessionIndex index_;
+    std::shared_ptr<SessionSummaryTable> summary_;
+};
+
+/**
+ * Session lookup across job result files for the REST API
+ *
+ * Keeps LRUs of recently used sidecar indexes, summary tables and served
+ * sessions, each capped by a constructor argument. Jobs written before the
+ * index existed fall back to parsing the whole result file. Thread-safe.
+ */
+class SessionStore {
+public:
+    explicit SessionStore(size_t max_cached_sessions = 256, size_t max_cached_summaries = 16,
+                          size_t max_cached_indexes = 16);
+
+    /**
+     * Find a session (by session_id or master_id) in a completed job
+     * @param allow_full_scan Whether an unindexed result file may be parsed
+     * @return Session JSON, or nullptr if the job does not contain it
+     */
+    std::shared_ptr<const nlohmann::json> find(const JobInfo& job, const std::string& session_id,
+                                               bool allow_full_scan = true);
+
+    /**
+     * Summary table of a completed job, kept while it is among the most
+     * recently used ones
+     * @return nullptr for jobs written before summaries existed
+     */
+    std::shared_ptr<const SessionSummaryTable> summaryFor(const JobInfo& job);
+
+    /**
+     * Drop everything cached for a job (e.g. after it was deleted)
+     */
+    void invalidateJob(const std::string& job_id);
+
+private:
+    using CacheKey = std::string;  // job_id + '\n' + session_id
+    using LruList = std::list<std::pair<CacheKey, std::shared_ptr<const nlohmann::json>>>;
+    using IndexLru = std::list<std::pair<std::string, std::shared_ptr<SessionIndex>>>;
+    using SummaryLru =
+        std::list<std::pair<std::string, std::shared_ptr<const SessionSummaryTable>>>;
+
+    std::shared_ptr<SessionIndex> indexFor(const JobInfo& job);
+    std::shared_ptr<const nlohmann::json> scanResultFile(const JobInfo& job,
+                                                         const std::string& session_id);
+    void remember(const CacheKey& key, std::shared_ptr<const nlohmann::json> session);
+
+    const size_t max_cached_sessions_;
+    const size_t max_cached_summaries_;
+    const size_t max_cached_indexes_;
+    std::mutex mutex_;
+    LruList lru_;
+    std::unordered_map<CacheKey, LruList::iterator> cache_;
+    // nullptr marks a job known to have no sidecar index
+    IndexLru index_lru_;
+    std::unordered_map<std::string, IndexLru::iterator> indexes_;
+    SummaryLru summary_lru_;
+    std::unordered_map<std::string, SummaryLru::iterator> summaries_;
+};
+
+}  // namespace callflow
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "api_server/session_index.h"
+
+namespace callflow {
+
+/**
+ * Columnar summary of the sessions in a job result file
+ *
+ * One row per session with the fields the session list filters and sorts on
+ * (id, type, start/end time, IMSI, MSISDN, event/packet/byte counts) and the
+ * byte range of the full session object. Columns are flat arrays; strings
+ * live in one arena. Stored next to the result file as "<result>.sum" and
+ * loaded once per job.
+ *
+ * Queries use keyset pagination: rows are ordered by (sort key, row) and a
+ * cursor names the last row served, so every page is a binary search into a
+ * precomputed order instead of a scan. IMSI and MSISDN filters go through
+ * sorted permutations as well. Immutable after load apart from the lazily
+ * built sort orders, so concurrent queries are safe.
+ */
+class SessionSummaryTable {
+public:
+    enum class SortKey : uint8_t {
+        START_TIME = 0,
+        END_TIME,
+        DURATION,
+        EVENTS,
+        PACKETS,
+        BYTES,
+    };
+    static constexpr size_t kSortKeyCount = 6;
+
+    struct Query {
+        std::string imsi;
+        std::string msisdn;
+        std::string type;
+        SortKey sort = SortKey::START_TIME;
+        bool descending = false;
+        size_t limit = 50;
+        size_t offset = 0;   // Skipped rows when no cursor is given (page-based clients)
+        std::string cursor;  // next_cursor of the previous page
+    };
+
+    struct Page {
+        std::vector<uint32_t> rows;
+        size_t total = 0;         // Rows matching the filters
+        std::string next_cursor;  // Empty on the last page
+    };
+
+    /**
+     * Path of the summary sidecar for a result file
+     */
+    static std::string sidecarPath(const std::string& result_file);
+
+    /**
+     * Parse a sort key name ("start_time", "end_time", "duration", "events",
+     * "packets", "bytes")
+     * @return false if the name is unknown
+     */
+    static bool parseSortKey(const std::string& name, SortKey& key);
+
+    /**
+     * Append the summary of one exported session stored at @p range
+     */
+    void add(const nlohmann::json& session, const SessionIndex::Entry& range);
+
+    size_t size() const { return start_time_.size(); }
+
+    bool save(const std::string& path) const;
+
+    /**
+     * Load a summary sidecar
+     * @return nullptr if the file does not exist or is malformed
+     */
+    static std::shared_ptr<SessionSummaryTable> load(const std::string& path);
+
+    /**
+     * Filter, sort and page the table
+     * @throws std::invalid_argument on a malformed cursor
+     */
+    Page query(const Query& query) const;
+
+    std::string_view sessionId(uint32_t row) const { return str(id_[row]); }
+    std::string_view type(uint32_t row) const { return types_[type_[row]]; }
+    std::string_view imsi(uint32_t row) const { return str(imsi_[row]); }
+    std::string_view msisdn(uint32_t row) const { return str(msisdn_[row]); }
+    int64_t startTime(uint32_t row) const { return start_time_[row]; }
+    int64_t endTime(uint32_t row) const { return end_time_[row]; }
+
+    /**
+     * Byte range of the full session object in the result file
+     */
+    SessionIndex::Entry range(uint32_t row) const { return {offset_[row], length_[row]}; }
+
+    /**
+     * Summary row as served by the session list (view=summary)
+     */
+    nlohmann::json rowToJson(uint32_t row) const;
+
+private:
+    struct StrRef {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    std::string_view str(StrRef ref) const { return {arena_.data() + ref.offset, ref.length}; }
+    StrRef intern(std::string_view value);
+    uint8_t typeCode(const std::string& type);
+    int64_t sortValue(SortKey key, uint32_t row) const;
+    const std::vector<uint32_t>& sortedBy(SortKey key) const;
+    const std::vector<uint32_t>& sortedByString(const std::vector<StrRef>& column,
+                                                std::vector<uint32_t>& order,
+                                                std::once_flag& once) const;
+    std::vector<uint32_t> rowsWithString(const std::vector<StrRef>& column,
+                                         const std::vector<uint32_t>& order,
+                                         const std::string& value) const;
+
+    // Columns
+    std::vector<StrRef> id_;
+    std::vector<uint8_t> type_;
+    std::vector<int64_t> start_time_;  // Milliseconds since epoch
+    std::vector<int64_t> end_time_;
+    std::vector<StrRef> imsi_;
+    std::vector<StrRef> msisdn_;
+    std::vector<uint32_t> events_;
+    std::vector<uint64_t> packets_;
+    std::vector<uint64_t> bytes_;
+    std::vector<uint64_t> offset_;
+    std::vector<uint64_t> length_;
+
+    std::string arena_;
+    std::vector<std::string> types_;  // Dictionary for type_
+    std::vector<size_t> type_counts_;
+
+    // Row orders, built on first use
+    mutable std::array<std::once_flag, kSortKeyCount> sort_once_;
+    mutable std::array<std::vector<uint32_t>, kSortKeyCount> sorted_;
+    mutable std::once_flag imsi_once_;
+    mutable std::vector<uint32_t> by_imsi_;
+    mutable std::once_flag msisdn_once_;
+    mutable std::vector<uint32_t> by_msisdn_;
+};
+
+}  // namespace callflow
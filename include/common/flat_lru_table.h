@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace callflow {
+
+/**
+ * Bounded-state lookup table with recency order
+ *
+ * Entries live in a dense pool addressed by uint32_t ids. An open-addressing
+ * table with linear probing maps (hash, key) to an id; each slot keeps the
+ * hash so probes rarely touch the pool, and erase() uses backward-shift
+ * deletion so probe chains stay intact without tombstones. The table doubles
+ * once it is half full.
+ *
+ * Entries are threaded on an intrusive list from oldest() to newest();
+ * insert() appends, touch() moves an entry to the newest end. Callers that
+ * never touch() get creation order instead. Either way the oldest entry is
+ * the one to evict or expire first, so expiry only has to look at oldest()
+ * until it finds an entry that is still live.
+ *
+ * Erased ids are recycled by later inserts with their Value left as erase()
+ * found it, so values can keep heap allocations across reuse. References to
+ * values stay valid until the next insert().
+ *
+ * The caller supplies the hash; Key needs operator==, Value a default
+ * constructor and a move constructor. Not thread-safe.
+ */
+template <typename Key, typename Value>
+class FlatLruTable {
+public:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    /**
+     * @param initial_slots Starting table size, a power of two
+     */
+    explicit FlatLruTable(size_t initial_slots = 1024) : slots_(initial_slots) {}
+
+    /**
+     * @return Id of the entry for key, or kNil
+     */
+    uint32_t find(const Key& key, uint32_t hash) const {
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask; slots_[i].entry != 0; i = (i + 1) & mask) {
+            if (slots_[i].hash == hash && entries_[slots_[i].entry - 1].key == key) {
+                return slots_[i].entry - 1;
+            }
+        }
+        return kNil;
+    }
+
+    /**
+     * Add an entry for a key that is not in the table, as the newest one
+     * @return Its id; a recycled id keeps the Value it was erased with
+     */
+    uint32_t insert(const Key& key, uint32_t hash) {
+        uint32_t id;
+        if (!free_ids_.empty()) {
+            id = free_ids_.back();
+            free_ids_.pop_back();
+        } else {
+            id = static_cast<uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+
+        Entry& entry = entries_[id];
+        entry.key = key;
+        entry.hash = hash;
+        pushBack(id);
+
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        insertSlot(hash, id);
+        size_++;
+        return id;
+    }
+
+    /**
+     * Remove an entry; its id goes back to the free pool
+     */
+    void erase(uint32_t id) {
+        eraseSlot(id);
+        unlink(id);
+        free_ids_.push_back(id);
+        size_--;
+    }
+
+    /**
+     * Make an entry the newest one
+     */
+    void touch(uint32_t id) {
+        if (newest_ != id) {
+            unlink(id);
+            pushBack(id);
+        }
+    }
+
+    uint32_t oldest() const { return oldest_; }
+    uint32_t newest() const { return newest_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const Key& key(uint32_t id) const { return entries_[id].key; }
+    Value& operator[](uint32_t id) { return entries_[id].value; }
+    const Value& operator[](uint32_t id) const { return entries_[id].value; }
+
+private:
+    struct Entry {
+        Key key;
+        uint32_t hash = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        Value value;
+    };
+
+    struct Slot {
+        uint32_t hash = 0;
+        uint32_t entry = 0;  // Pool id + 1 (0 = empty)
+    };
+
+    void insertSlot(uint32_t hash, uint32_t id) {
+        size_t mask = slots_.size() - 1;
+        size_t i = hash & mask;
+        while (slots_[i].entry != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = {hash, id + 1};
+    }
+
+    void eraseSlot(uint32_t id) {
+        size_t mask = slots_.size() - 1;
+        size_t i = entries_[id].hash & mask;
+        while (slots_[i].entry != id + 1) {
+            i = (i + 1) & mask;
+        }
+        // Pull back every later entry of the chain that may move into the gap
+        for (size_t j = (i + 1) & mask; slots_[j].entry != 0; j = (j + 1) & mask) {
+            size_t home = slots_[j].hash & mask;
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = Slot();
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(old.size() * 2, Slot());
+        for (const auto& slot : old) {
+            if (slot.entry != 0) {
+                insertSlot(slot.hash, slot.entry - 1);
+            }
+        }
+    }
+
+    void unlink(uint32_t id) {
+        Entry& entry = entries_[id];
+        if (entry.prev != kNil) {
+            entries_[entry.prev].next = entry.next;
+        } else {
+            oldest_ = entry.next;
+        }
+        if (entry.next != kNil) {
+            entries_[entry.next].prev = entry.prev;
+        } else {
+            newest_ = entry.prev;
+        }
+        entry.prev = entry.next = kNil;
+    }
+
+    void pushBack(uint32_t id) {
+        Entry& entry = entries_[id];
+        entry.prev = newest_;
+        entry.next = kNil;
+        if (newest_ != kNil) {
+            entries_[newest_].next = id;
+        } else {
+            oldest_ = id;
+        }
+        newest_ = id;
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_ids_;
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+    uint32_t oldest_ = kNil;
+    uint32_t newest_ = kNil;
+};
+
+}  // namespace callflow
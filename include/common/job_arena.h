@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/types.h"
+
+namespace callflow {
+
+/**
+ * Arena for the state of one processing job
+ *
+ * Small blocks (session nodes, short message vectors and strings) come
+ * from a std::pmr::monotonic_buffer_resource: an allocation is a pointer
+ * bump into the current chunk. A small block handed back, e.g. the buffer
+ * a vector outgrew, goes on a free list for its size and is reused by the
+ * next allocation of that size instead of staying stranded in its chunk.
+ * Blocks larger than kLargestArenaBlock are taken from the heap and given
+ * back to it on deallocate, so regrowing large containers does not leave
+ * their old buffers behind either.
+ *
+ * All memory is returned in one step when the arena is released or
+ * destroyed. Chunks are taken from the global heap, starting at the
+ * initial size and growing geometrically.
+ *
+ * Containers built on the arena must not outlive it. Copies of pmr
+ * containers fall back to the default resource, so data copied out of a
+ * job's correlator (e.g. for export) is unaffected by the release.
+ *
+ * Allocation is serialized by an internal mutex so the arena can back
+ * state shared between ingest threads.
+ */
+class JobArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t kDefaultInitialChunk = 1 << 20;  // 1 MB
+    static constexpr size_t kLargestArenaBlock = 1024;        // Larger blocks use the heap
+
+    explicit JobArena(size_t initial_chunk = kDefaultInitialChunk);
+    ~JobArena() override;
+
+    JobArena(const JobArena&) = delete;
+    JobArena& operator=(const JobArena&) = delete;
+
+    /**
+     * Usage so far; bytes_reserved is what the arena holds from the heap
+     */
+    ArenaStats stats() const;
+
+    /**
+     * Return all chunks to the heap; everything allocated so far is invalid
+     */
+    void release();
+
+private:
+    /**
+     * Heap resource counting the chunks the monotonic buffer requests
+     */
+    class ChunkSource : public std::pmr::memory_resource {
+    public:
+        uint64_t bytes = 0;
+        uint64_t chunks = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    // Small blocks are rounded up to a multiple of the grain; one free list per size
+    static constexpr size_t kGrain = alignof(std::max_align_t);
+
+    struct LargeBlock {
+        size_t bytes;
+        size_t alignment;
+    };
+
+    // Zero-byte requests still get a block that can hold the free-list link
+    static size_t sizeClass(size_t bytes) { return bytes == 0 ? 1 : (bytes + kGrain - 1) / kGrain; }
+
+    void releaseLarge();
+
+    mutable std::mutex mutex_;
+    ChunkSource chunks_;
+    std::pmr::monotonic_buffer_resource buffer_;
+    std::array<void*, kLargestArenaBlock / kGrain + 1> free_lists_{};
+    std::unordered_map<void*, LargeBlock> large_blocks_;
+    uint64_t large_bytes_ = 0;
+    ArenaStats stats_;
+};
+
+}  // namespace callflow
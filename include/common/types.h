@@ -1,9 +1,11 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -12,10 +14,46 @@ namespace callflow {
 // Type aliases for clarity
 using Timestamp = std::chrono::system_clock::time_point;
 using SessionId = std::string;
-using PacketId = std::string;
+using PacketId = uint64_t;  // (job tag << 32) | frame number, see makePacketId()
 using EventId = std::string;
 using JobId = std::string;
 
+/**
+ * Build the packet identity from the job tag and the capture frame number
+ * Ids increase monotonically within a job; all metadata derived from one
+ * captured frame (e.g. GTP-U outer and inner packet) share the same id.
+ */
+inline PacketId makePacketId(uint32_t job_tag, uint32_t frame_number) {
+    return (static_cast<uint64_t>(job_tag) << 32) | frame_number;
+}
+
+/**
+ * Textual (UUID formatted) packet id, rendered only at export time
+ */
+std::string packetIdToString(PacketId id);
+
+/**
+ * Non-owning view of a contiguous byte range (C++17 stand-in for std::span)
+ * Mirrors the read-only std::vector accessors so parsing code can take either.
+ */
+class ByteView {
+public:
+    ByteView() = default;
+    ByteView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    ByteView(const std::vector<uint8_t>& bytes) : data_(bytes.data()), size_(bytes.size()) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
 // Packet direction
 enum class Direction { UNKNOWN = 0, CLIENT_TO_SERVER, SERVER_TO_CLIENT, BIDIRECTIONAL };
 
@@ -209,6 +247,71 @@ enum class MessageType {
 
 std::string messageTypeToString(MessageType type);
 
+// Binary IP address (IPv4 or IPv6), cheap to copy, hash and compare
+struct IpAddress {
+    enum class Family : uint8_t { NONE = 0, V4 = 4, V6 = 6 };
+
+    std::array<uint8_t, 16> bytes{};  // IPv4 uses the first 4 bytes, rest stays zero
+    Family family = Family::NONE;
+
+    static IpAddress fromV4(const uint8_t* addr);
+    static IpAddress fromV6(const uint8_t* addr);
+    // Parse dotted IPv4 or IPv6 text (inet_pton); unset on failure
+    static IpAddress fromString(const std::string& text);
+
+    bool isValid() const { return family != Family::NONE; }
+    size_t length() const { return family == Family::V6 ? 16 : (family == Family::V4 ? 4 : 0); }
+
+    bool operator==(const IpAddress& other) const {
+        return family == other.family && bytes == other.bytes;
+    }
+    bool operator!=(const IpAddress& other) const { return !(*this == other); }
+    bool operator<(const IpAddress& other) const {
+        if (family != other.family)
+            return family < other.family;
+        return bytes < other.bytes;
+    }
+
+    // Textual form (inet_ntop); only for export, JSON and logging
+    std::string toString() const;
+    size_t hash() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const IpAddress& addr);
+
+struct FiveTuple;
+
+// Binary network 5-tuple used as the key of per-flow tables on the ingest path
+struct FlowKey {
+    IpAddress src_ip;
+    IpAddress dst_ip;
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
+    uint8_t protocol = 0;
+
+    bool operator==(const FlowKey& other) const {
+        return src_port == other.src_port && dst_port == other.dst_port &&
+               protocol == other.protocol && src_ip == other.src_ip && dst_ip == other.dst_ip;
+    }
+    bool operator<(const FlowKey& other) const {
+        if (src_ip != other.src_ip)
+            return src_ip < other.src_ip;
+        if (dst_ip != other.dst_ip)
+            return dst_ip < other.dst_ip;
+        if (src_port != other.src_port)
+            return src_port < other.src_port;
+        if (dst_port != other.dst_port)
+            return dst_port < other.dst_port;
+        return protocol < other.protocol;
+    }
+
+    std::string toString() const;
+    size_t hash() const;
+
+    // Render the string-based FiveTuple consumed by correlation and export
+    FiveTuple toFiveTuple() const;
+};
+
 // Network 5-tuple
 struct FiveTuple {
     std::string src_ip;
@@ -245,13 +348,14 @@ struct Participant {
 
 // Packet metadata
 struct PacketMetadata {
-    PacketId packet_id;
+    PacketId packet_id = 0;
     Timestamp timestamp;
     uint32_t frame_number;
     size_t packet_length;
-    FiveTuple five_tuple;
+    FiveTuple five_tuple;  // Addresses are rendered from flow_key only when needed
+    FlowKey flow_key;
     ProtocolType detected_protocol;
-    std::vector<uint8_t> raw_data;
+    std::vector<uint8_t> raw_data;  // Not filled by ingest; payloads are passed as views
 
     // GTP encapsulation context (for inner payloads)
     std::optional<uint32_t> gtp_teid;      // GTP Tunnel Endpoint ID
@@ -275,6 +379,35 @@ enum class JobStatus { QUEUED = 0, RUNNING, COMPLETED, FAILED };
 std::string jobStatusToString(JobStatus status);
 JobStatus stringToJobStatus(const std::string& str);
 
+// Allocation statistics of a per-job arena (see JobArena), for sizing arenas
+struct ArenaStats {
+    uint64_t allocations = 0;      // allocate() calls served
+    uint64_t bytes_allocated = 0;  // Bytes handed out
+    uint64_t bytes_freed = 0;      // Bytes given back early; reused or returned to the heap
+    uint64_t bytes_reserved = 0;   // Chunks and large blocks held from the heap
+    uint64_t chunks = 0;           // Chunks requested from the heap
+};
+
+// IP fragment reassembly counters (see IpReassembler), summed over a job
+struct DefragStats {
+    uint64_t fragments = 0;    // Fragments received
+    uint64_t reassembled = 0;  // Datagrams completed
+    uint64_t timeouts = 0;     // Incomplete datagrams expired
+    uint64_t overlaps = 0;     // Fragments overlapping bytes already received
+    uint64_t evicted = 0;      // Incomplete datagrams dropped at the count / memory limit
+    uint64_t malformed = 0;    // Fragments with inconsistent offsets or lengths
+
+    DefragStats& operator+=(const DefragStats& other) {
+        fragments += other.fragments;
+        reassembled += other.reassembled;
+        timeouts += other.timeouts;
+        overlaps += other.overlaps;
+        evicted += other.evicted;
+        malformed += other.malformed;
+        return *this;
+    }
+};
+
 // Job information structure
 struct JobInfo {
     JobId job_id;
@@ -301,6 +434,12 @@ struct JobInfo {
         uint64_t packets_dropped;
     };
     std::vector<InterfaceStats> interface_stats;
+
+    // Arena backing the job's correlation state
+    ArenaStats arena_stats;
+
+    // IP fragment reassembly
+    DefragStats defrag_stats;
 };
 
 // Database configuration
@@ -310,6 +449,8 @@ struct DatabaseConfig {
     int retention_days = 7;
     bool auto_vacuum = true;
     int busy_timeout_ms = 5000;
+    int batch_size = 10000;            // Rows per transaction for bulk inserts
+    size_t writer_queue_max = 100000;  // Rows queued for the writer thread before enqueue blocks
 };
 
 // UE Key Configuration
@@ -327,6 +468,7 @@ struct Config {
     // Processing
     int worker_threads = 4;
     size_t max_packet_queue_size = 10000;
+    size_t arena_chunk_kb = 1024;  // First chunk of each job's arena (see JobArena)
 
     // Memory limits
     size_t max_memory_mb = 16384;  // 16GB
@@ -373,4 +515,14 @@ template <>
 struct hash<callflow::FiveTuple> {
     size_t operator()(const callflow::FiveTuple& ft) const { return ft.hash(); }
 };
+
+template <>
+struct hash<callflow::IpAddress> {
+    size_t operator()(const callflow::IpAddress& addr) const { return addr.hash(); }
+};
+
+template <>
+struct hash<callflow::FlowKey> {
+    size_t operator()(const callflow::FlowKey& key) const { return key.hash(); }
+};
 }  // namespace std
@@ -90,6 +90,11 @@ std::chrono::system_clock::time_point now();
 int64_t timeDiffMs(const std::chrono::system_clock::time_point& start,
                    const std::chrono::system_clock::time_point& end);
 
+/**
+ * Resident set size of the current process in bytes (0 if unavailable)
+ */
+uint64_t currentRssBytes();
+
 /**
  * Sanitize string for JSON output (escape special characters)
  */
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "correlation/identity/subscriber_identity.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -14,8 +15,9 @@ namespace correlation {
  * @brief Manages subscriber contexts across all protocols
  *
  * Maintains a unified view of subscriber identities, handling:
- * - Multi-key lookup (IMSI, MSISDN, IMEI, IP)
- * - Context merging when new links discovered
+ * - Multi-key lookup (IMSI, MSISDN, IMEI, IP, TMSI, GUTI)
+ * - Context merging when new links discovered (disjoint-set union with
+ *   path compression, so a merge never touches the identifier indexes)
  * - Identity propagation across protocols
  *
  * Thread-safe for concurrent access from multiple protocol parsers.
@@ -147,9 +149,12 @@ public:
      * @brief Run identity propagation algorithm
      *
      * Propagates identifiers across linked contexts based on:
-     * - Shared IP addresses (default bearer + IMS bearer)
+     * - Shared IP addresses (default bearer + IMS bearer), including
+     *   endpoints added to a context directly rather than via a link call
      * - GTP tunnel correlations
-     * - GUTI/TMSI mappings
+     *
+     * GUTI/TMSI mappings and every link* call are merged as they are
+     * observed, so this is a single pass over the contexts' endpoints.
      *
      * This implements the "forward-fill/backward-fill" approach from
      * the production Python correlator.
@@ -181,27 +186,73 @@ public:
     void clear();
 
 private:
+    /**
+     * Dense context number; indexes map identifiers to these and a
+     * disjoint-set forest maps merged contexts to the surviving one
+     */
+    using ContextId = uint32_t;
+    static constexpr ContextId kNoContext = static_cast<ContextId>(-1);
+
     mutable std::shared_mutex mutex_;
 
-    // Primary storage - all contexts
+    // Context storage by id; merged-away ids hold nullptr
     std::vector<ContextPtr> contexts_;
 
-    // Index maps for fast O(1) lookup
-    std::unordered_map<std::string, ContextPtr> imsi_index_;      // IMSI digits -> Context
-    std::unordered_map<std::string, ContextPtr> msisdn_index_;    // Normalized MSISDN -> Context
-    std::unordered_map<std::string, ContextPtr> imei_index_;      // IMEI digits -> Context
-    std::unordered_map<std::string, ContextPtr> ip_index_;        // UE IP -> Context
-    std::unordered_map<uint32_t, ContextPtr> tmsi_index_;         // TMSI -> Context
-    std::unordered_map<std::string, ContextPtr> guti_index_;      // GUTI string -> Context
+    // Disjoint-set forest over context ids (union by size)
+    std::vector<ContextId> parent_;
+    std::vector<uint32_t> set_size_;
+
+    // Identifier -> context id, resolved through the forest, so merging
+    // never rewrites index entries
+    std::unordered_map<std::string, ContextId> imsi_index_;         // IMSI digits
+    std::unordered_map<std::string, ContextId> msisdn_index_;       // Normalized MSISDN
+    std::unordered_map<std::string, ContextId> imei_index_;         // IMEI digits
+    std::unordered_map<std::string, ContextId> ip_index_;           // UE IP
+    std::unordered_map<std::string, ContextId> ipv6_prefix_index_;  // UE IPv6 /64
+    std::unordered_map<uint32_t, ContextId> tmsi_index_;            // TMSI
+    std::unordered_map<std::string, ContextId> guti_index_;         // GUTI string
+    std::unordered_map<uint32_t, ContextId> guti_tmsi_index_;       // GUTI M-TMSI
 
     // Statistics
-    mutable Stats stats_{};
+    size_t live_contexts_ = 0;
+    size_t merge_operations_ = 0;
+
+    // Disjoint-set operations: find() compresses paths and needs the
+    // exclusive lock, root() only walks them
+    ContextId find(ContextId id);
+    ContextId root(ContextId id) const;
+
+    /**
+     * Join the contexts of a and b; a's identifiers win where both are set
+     * and a's context object survives
+     *
+     * @return Id of the merged context
+     */
+    ContextId mergeContexts(ContextId a, ContextId b);
+    void mergeIdentity(SubscriberIdentity& primary, const SubscriberIdentity& secondary);
+
+    template <typename Key>
+    ContextId lookup(const std::unordered_map<Key, ContextId>& index, const Key& key);
+    template <typename Key>
+    ContextPtr findIn(const std::unordered_map<Key, ContextId>& index, const Key& key) const;
+
+    // Join the context holding key (if any) with id, or index key under id
+    template <typename Key>
+    ContextId joinOnKey(std::unordered_map<Key, ContextId>& index, const Key& key, ContextId id);
+
+    // Drop key from index if it still resolves to id's context
+    template <typename Key>
+    void unindex(std::unordered_map<Key, ContextId>& index, const Key& key, ContextId id);
+
+    ContextId createContext();
 
-    // Internal helper methods
-    ContextPtr createContext();
-    void mergeContexts(ContextPtr primary, ContextPtr secondary);
-    void updateIndices(ContextPtr context);
-    void removeFromIndices(ContextPtr context);
+    // Set an identifier on a context and index it
+    void attachImsi(ContextId id, const std::string& imsi, const std::string& normalized);
+    void attachMsisdn(ContextId id, const std::string& msisdn, const std::string& normalized);
+    void attachImei(ContextId id, const std::string& imei, const std::string& normalized);
+    void attachUeIp(ContextId id, const std::string& ip);
+    void attachGuti(ContextId id, const Guti4G& guti, const std::string& guti_str);
+    void attachTmsi(ContextId id, uint32_t tmsi);
 
     std::string normalizeForIndex(const std::string& msisdn) const;
     std::string normalizeImsiForIndex(const std::string& imsi) const;
@@ -209,7 +260,6 @@ private:
 
     // Helper for IP-based correlation
     void correlateByIpAddress();
-    void correlateByGuti();
 };
 
 /**
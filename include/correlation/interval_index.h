@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace callflow {
+namespace correlation {
+
+/**
+ * @brief Static index of time intervals for window queries
+ *
+ * Built once from a batch of [start, end] intervals (a point in time is an
+ * interval with start == end), then queried for every interval overlapping a
+ * window. Entries are kept in one array sorted by start time and viewed as an
+ * implicit balanced binary tree in which every node also records the largest
+ * end time in its subtree, so a query costs O(log n + matches) without any
+ * per-node allocation.
+ *
+ * Intervals are closed on both ends: [s, e] overlaps [from, to] when
+ * s <= to && e >= from. Matches are reported in start-time order.
+ */
+template <typename T>
+class IntervalIndex {
+public:
+    void add(double start, double end, T value) {
+        entries_.push_back(Entry{start, end, end, std::move(value)});
+        built_ = false;
+    }
+
+    /**
+     * @brief Sort entries and compute subtree end times (call after adding)
+     */
+    void build() {
+        std::sort(entries_.begin(), entries_.end(),
+                  [](const Entry& a, const Entry& b) { return a.start < b.start; });
+        root_level_ = indexLevels();
+        built_ = true;
+    }
+
+    bool isBuilt() const { return built_; }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    void clear() {
+        entries_.clear();
+        root_level_ = -1;
+        built_ = false;
+    }
+
+    /**
+     * @brief Visit every value whose interval overlaps [from, to]
+     */
+    template <typename Fn>
+    void forEachOverlap(double from, double to, Fn&& fn) const {
+        if (root_level_ < 0) {
+            return;
+        }
+
+        struct Frame {
+            int level;
+            size_t node;
+            bool left_done;
+        };
+        // The tree has at most 64 levels, and each level adds one frame
+        Frame stack[64];
+        int top = 0;
+        const size_t n = entries_.size();
+        stack[top++] = Frame{root_level_, (size_t{1} << root_level_) - 1, false};
+
+        while (top > 0) {
+            Frame frame = stack[--top];
+            if (frame.level <= kScanLevel) {
+                // Small subtree: scan its slice of the array directly
+                size_t first = frame.node >> frame.level << frame.level;
+                size_t last = std::min(n, first + (size_t{1} << (frame.level + 1)) - 1);
+                for (size_t i = first; i < last && entries_[i].start <= to; ++i) {
+                    if (entries_[i].end >= from) {
+                        fn(entries_[i].value);
+                    }
+                }
+            } else if (!frame.left_done) {
+                // Revisit this node after its left subtree; the left child may
+                // be past the end of the array (an absent subtree of a
+                // non-full tree), in which case it is still descended
+                size_t left = frame.node - (size_t{1} << (frame.level - 1));
+                stack[top++] = Frame{frame.level, frame.node, true};
+                if (left >= n || entries_[left].max_end >= from) {
+                    stack[top++] = Frame{frame.level - 1, left, false};
+                }
+            } else if (frame.node < n && entries_[frame.node].start <= to) {
+                if (entries_[frame.node].end >= from) {
+                    fn(entries_[frame.node].value);
+                }
+                stack[top++] =
+                    Frame{frame.level - 1, frame.node + (size_t{1} << (frame.level - 1)), false};
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        double start;
+        double end;
+        double max_end;  // Largest end in the subtree rooted here
+        T value;
+    };
+
+    // Subtrees at or below this level are scanned linearly
+    static constexpr int kScanLevel = 3;
+
+    /**
+     * Fill max_end bottom-up. Node i sits at level k when its k lowest
+     * bits are 1; leaves are the even indices. Children of node i at level
+     * k are i -/+ 2^(k-1). For a non-full tree, `last` carries the max end
+     * of the rightmost existing subtree so nodes with an absent right child
+     * still see it.
+     *
+     * @return Level of the root, or -1 when empty
+     */
+    int indexLevels() {
+        const size_t n = entries_.size();
+        if (n == 0) {
+            return -1;
+        }
+
+        size_t last_i = 0;
+        double last = 0.0;
+        for (size_t i = 0; i < n; i += 2) {
+            entries_[i].max_end = entries_[i].end;
+            last_i = i;
+            last = entries_[i].end;
+        }
+
+        int level = 1;
+        for (; (size_t{1} << level) <= n; ++level) {
+            size_t half = size_t{1} << (level - 1);
+            for (size_t i = (half << 1) - 1; i < n; i += half << 2) {
+                double left = entries_[i - half].max_end;
+                double right = i + half < n ? entries_[i + half].max_end : last;
+                entries_[i].max_end = std::max({entries_[i].end, left, right});
+            }
+            last_i = (last_i >> level & 1) ? last_i - half : last_i + half;
+            if (last_i < n && entries_[last_i].max_end > last) {
+                last = entries_[last_i].max_end;
+            }
+        }
+        return level - 1;
+    }
+
+    std::vector<Entry> entries_;
+    int root_level_ = -1;
+    bool built_ = false;
+};
+
+/**
+ * @brief Interval index partitioned by an exact-match key (UE IP, IMSI)
+ *
+ * A window query only touches intervals filed under the requested key.
+ */
+template <typename T>
+class KeyedIntervalIndex {
+public:
+    void add(const std::string& key, double start, double end, T value) {
+        by_key_[key].add(start, end, std::move(value));
+    }
+
+    void build() {
+        for (auto& [key, index] : by_key_) {
+            index.build();
+        }
+    }
+
+    void clear() { by_key_.clear(); }
+    size_t keyCount() const { return by_key_.size(); }
+
+    template <typename Fn>
+    void forEachOverlap(const std::string& key, double from, double to, Fn&& fn) const {
+        auto it = by_key_.find(key);
+        if (it != by_key_.end()) {
+            it->second.forEachOverlap(from, to, std::forward<Fn>(fn));
+        }
+    }
+
+private:
+    std::unordered_map<std::string, IntervalIndex<T>> by_key_;
+};
+
+}  // namespace correlation
+}  // namespace callflow
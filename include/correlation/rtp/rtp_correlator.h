@@ -1,5 +1,6 @@
 #pragma once
 
+#include "correlation/interval_index.h"
 #include "correlation/rtp/rtp_stream.h"
 #include <unordered_map>
 #include <memory>
@@ -41,6 +42,14 @@ public:
      */
     void finalize();
 
+    /**
+     * @brief Choose which packets new streams keep for drill-down
+     *
+     * Quality metrics do not depend on retained packets. Streams that
+     * already exist keep their policy.
+     */
+    void setPacketRetention(const RtpPacketRetention& retention);
+
     // ========================================================================
     // Stream Access
     // ========================================================================
@@ -69,7 +78,9 @@ public:
     /**
      * @brief Find streams within time window
      *
-     * Returns streams that overlap with [start, end] interval.
+     * Returns streams that overlap with [start, end] interval, in order of
+     * stream start time. Served from an interval index that is rebuilt on
+     * the first query after new packets arrive.
      */
     std::vector<RtpStream*> findByTimeWindow(double start, double end);
 
@@ -162,7 +173,12 @@ private:
     // Index by UE IP for SIP correlation (UE IP -> SSRCs)
     std::unordered_multimap<std::string, uint32_t> ue_ip_index_;
 
+    // Stream lifetimes for time-window queries; stale once packets arrive
+    IntervalIndex<RtpStream*> time_index_;
+    bool time_index_stale_ = true;
+
     Stats stats_;
+    RtpPacketRetention retention_;
 
     // Internal methods
     void updateIpIndex(RtpStream* stream);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <optional>
@@ -34,10 +35,54 @@ struct RtpPacketInfo {
     size_t payload_size;
 };
 
+/**
+ * @brief Header fields of a retained RTP packet (drill-down sample)
+ *
+ * The stream already records the endpoints, so retained packets do not
+ * carry the IP strings of RtpPacketInfo.
+ */
+struct RtpPacketSample {
+    uint32_t frame_number = 0;
+    double timestamp = 0.0;
+    uint32_t rtp_timestamp = 0;
+    uint16_t sequence_number = 0;
+    uint8_t payload_type = 0;
+    bool marker = false;
+    uint32_t payload_size = 0;
+};
+
+/**
+ * @brief Which packets an RtpStream keeps for drill-down
+ *
+ * Quality metrics are accumulated per packet and do not depend on the
+ * retained packets, so a stream's memory stays bounded unless ALL is chosen.
+ */
+struct RtpPacketRetention {
+    enum class Mode {
+        NONE,     // Keep no packets
+        FIRST_N,  // Keep the first max_packets packets
+        SAMPLED,  // Keep every sample_interval-th packet, up to max_packets
+        ALL       // Keep every packet (unbounded)
+    };
+
+    Mode mode = Mode::FIRST_N;
+    uint32_t max_packets = 50;       // About one second of 20 ms audio
+    uint32_t sample_interval = 250;  // One packet every 5 s of 20 ms audio
+};
+
 /**
  * @brief RTP quality metrics per RFC 3550
  */
 struct RtpQualityMetrics {
+    // Inclusive bucket upper bounds (ms) for per-packet delay variation |D|;
+    // the last bucket is open-ended
+    static constexpr std::array<double, 7> kJitterBucketBoundsMs = {1, 2, 5, 10, 20, 50, 100};
+
+    // Inclusive bucket upper bounds (%) for per-interval loss (RTCP-style
+    // fraction lost over kLossIntervalSeconds); the last bucket is open-ended
+    static constexpr std::array<double, 5> kLossBucketBoundsPercent = {0, 1, 3, 5, 10};
+    static constexpr double kLossIntervalSeconds = 5.0;
+
     // Packet statistics
     uint32_t packets_received = 0;
     uint32_t packets_lost = 0;
@@ -67,6 +112,10 @@ struct RtpQualityMetrics {
     uint16_t first_seq = 0;
     uint16_t last_seq = 0;
     uint32_t seq_cycles = 0;  // Number of sequence number wrap-arounds
+
+    // Distributions
+    std::array<uint32_t, kJitterBucketBoundsMs.size() + 1> jitter_histogram{};
+    std::array<uint32_t, kLossBucketBoundsPercent.size() + 1> loss_histogram{};
 };
 
 /**
@@ -74,10 +123,15 @@ struct RtpQualityMetrics {
  *
  * Represents a unidirectional RTP stream identified by SSRC.
  * Tracks packets, calculates quality metrics, and correlates with SIP sessions.
+ *
+ * Quality is accumulated as packets arrive (RFC 3550 A.1 extended sequence
+ * numbers, A.8 interarrival jitter, A.3 per-interval loss), so memory per
+ * stream is constant; only the packets chosen by RtpPacketRetention are kept.
  */
 class RtpStream {
 public:
-    RtpStream(const RtpPacketInfo& first_packet);
+    explicit RtpStream(const RtpPacketInfo& first_packet,
+                       const RtpPacketRetention& retention = RtpPacketRetention{});
     ~RtpStream() = default;
 
     // Stream identification
@@ -91,7 +145,7 @@ public:
     void addPacket(const RtpPacketInfo& packet);
 
     // Packet count
-    size_t getPacketCount() const { return packets_.size(); }
+    size_t getPacketCount() const { return packets_received_; }
 
     // Time window
     double getStartTime() const { return start_time_; }
@@ -126,8 +180,9 @@ public:
     void setInterCorrelator(const std::string& id) { inter_correlator_ = id; }
     std::string getInterCorrelator() const { return inter_correlator_; }
 
-    // Access packets (for detailed analysis)
-    const std::vector<RtpPacketInfo>& getPackets() const { return packets_; }
+    // Retained packets (for detailed analysis), in arrival order
+    const std::vector<RtpPacketSample>& getPackets() const { return packets_; }
+    const RtpPacketRetention& getRetention() const { return retention_; }
 
 private:
     uint32_t ssrc_;
@@ -136,7 +191,8 @@ private:
     std::string dst_ip_;
     uint16_t dst_port_;
 
-    std::vector<RtpPacketInfo> packets_;
+    RtpPacketRetention retention_;
+    std::vector<RtpPacketSample> packets_;
 
     double start_time_ = 0.0;
     double end_time_ = 0.0;
@@ -152,13 +208,48 @@ private:
 
     std::string inter_correlator_;
 
+    // Sequence state (RFC 3550 Appendix A.1); extended numbers carry the
+    // wrap-around count in the upper 16 bits
+    uint32_t packets_received_ = 0;
+    uint32_t packets_duplicated_ = 0;
+    uint32_t packets_out_of_order_ = 0;
+    uint16_t first_seq_ = 0;
+    uint16_t last_seq_ = 0;
+    uint32_t base_ext_seq_ = 0;
+    uint32_t max_ext_seq_ = 0;
+    uint32_t bad_seq_ = kNoBadSeq;
+    uint32_t seq_cycles_ = 0;
+    uint32_t expected_before_restart_ = 0;  // Expected count before a resync
+    uint64_t seen_window_ = 0;  // Bit i set: max_ext_seq_ - i was received
+
     // Jitter calculation state (RFC 3550 Appendix A.8)
-    mutable double last_arrival_time_ = 0.0;
-    mutable uint32_t last_rtp_timestamp_ = 0;
-    mutable double jitter_estimate_ = 0.0;
-    mutable bool jitter_initialized_ = false;
+    double last_arrival_time_ = 0.0;
+    uint32_t last_rtp_timestamp_ = 0;
+    double jitter_estimate_ = 0.0;
+    double max_delay_variation_ = 0.0;  // Largest |D| in RTP timestamp units
+    bool jitter_initialized_ = false;
+
+    // Per-interval loss (RFC 3550 Appendix A.3)
+    double interval_start_time_ = 0.0;
+    uint32_t interval_expected_prior_ = 0;
+    uint32_t interval_received_prior_ = 0;
+
+    std::array<uint32_t, RtpQualityMetrics::kJitterBucketBoundsMs.size() + 1> jitter_histogram_{};
+    std::array<uint32_t, RtpQualityMetrics::kLossBucketBoundsPercent.size() + 1> loss_histogram_{};
+
+    static constexpr uint32_t kNoBadSeq = 0xFFFFFFFF;
+    static constexpr uint16_t kMaxDropout = 3000;
+    static constexpr uint16_t kMaxMisorder = 100;
 
+    void updateSequence(uint16_t seq);
     void updateJitter(const RtpPacketInfo& packet);
+    void updateLossInterval(double timestamp);
+    void retainPacket(const RtpPacketInfo& packet);
+    uint32_t expectedPackets() const {
+        return expected_before_restart_ + (max_ext_seq_ - base_ext_seq_ + 1);
+    }
+    uint32_t uniquePackets() const { return packets_received_ - packets_duplicated_; }
+    static size_t lossBucket(uint32_t expected, uint32_t received);
     std::string detectCodecName(uint8_t pt) const;
     uint32_t detectClockRate(uint8_t pt) const;
 
@@ -5,6 +5,7 @@
 #include "common/types.h"
 #include "protocol_parsers/sip_parser.h"
 #include "session/session_types.h"
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -35,6 +36,10 @@ public:
     // Export sessions in format compatible with UI
     nlohmann::json exportSessions() const;
 
+    // Export sessions one at a time, in the same format as exportSessions(),
+    // without materializing the whole array
+    void forEachExportedSession(const std::function<void(const nlohmann::json&)>& callback) const;
+
     // Statistics
     struct Stats {
         size_t total_sessions = 0;
@@ -9,6 +9,7 @@
 #include "correlation/diameter/diameter_correlator.h"
 #include "correlation/gtpv2/gtpv2_correlator.h"
 #include "correlation/identity/subscriber_context_manager.h"
+#include "correlation/interval_index.h"
 #include "correlation/nas/nas_correlator.h"
 #include "correlation/rtp/rtp_correlator.h"
 #include "correlation/sip/sip_correlator.h"
@@ -168,6 +169,26 @@ private:
     std::unordered_set<std::string> correlated_nas_sessions_;
     std::unordered_set<uint32_t> correlated_rtp_ssrcs_;
 
+    /**
+     * @brief Session whose MSISDN is matched fuzzily (normalized once)
+     */
+    template <typename Session>
+    struct MsisdnCandidate {
+        Session* session;
+        NormalizedMsisdn msisdn;
+    };
+
+    // Phase 3 time-window indexes, built at the start of the phase and
+    // released at its end. Sessions are filed as points at their start time,
+    // RTP streams as [start, end] under both endpoint IPs.
+    KeyedIntervalIndex<DiameterSession*> gx_window_index_;  // by UE IP key
+    KeyedIntervalIndex<DiameterSession*> rx_window_index_;  // by UE IP key
+    IntervalIndex<MsisdnCandidate<DiameterSession>> cx_window_index_;
+    IntervalIndex<MsisdnCandidate<DiameterSession>> sh_window_index_;
+    IntervalIndex<MsisdnCandidate<Gtpv2Session>> gtp_window_index_;
+    KeyedIntervalIndex<NasSession*> nas_window_index_;  // by IMSI
+    KeyedIntervalIndex<RtpStream*> rtp_window_index_;   // by UE IP key
+
     // ========================================================================
     // Correlation Phases
     // ========================================================================
@@ -196,6 +217,9 @@ private:
      * - GTPv2 IMS bearers (by MSISDN + time window)
      * - NAS ESM sessions (by IMSI + time window)
      * - RTP streams (by UE media IP + time window)
+     *
+     * Candidate sessions are looked up in interval indexes built once per
+     * pass, so each flow only visits sessions inside its time window.
      */
     void phase3_CorrelateWithinCallWindow();
 
@@ -234,6 +258,9 @@ private:
     // Phase 3 Helpers
     // ========================================================================
 
+    void buildWindowIndexes();
+    void clearWindowIndexes();
+
     void correlateDiameterGx(VolteCallFlow& flow);
     void correlateDiameterRx(VolteCallFlow& flow);
     void correlateDiameterCxSh(VolteCallFlow& flow);
@@ -246,19 +273,16 @@ private:
     // ========================================================================
 
     /**
-     * @brief Check if two MSISDNs match (with normalization)
+     * @brief Check if two normalized MSISDNs match (both from non-empty input)
      */
-    bool matchesMsisdn(const std::string& m1, const std::string& m2);
+    bool matchesMsisdn(const NormalizedMsisdn& m1, const NormalizedMsisdn& m2);
 
     /**
-     * @brief Check if UE IP addresses match (IPv4 exact, IPv6 prefix)
-     */
-    bool matchesUeIp(const std::string& ip1, const std::string& ip2);
-
-    /**
-     * @brief Check if timestamp is within time window (with tolerance)
+     * @brief Key under which UE IP addresses match (IPv4 exact, IPv6 prefix)
+     *
+     * Two addresses match when their keys are equal; empty for empty input.
      */
-    bool isWithinTimeWindow(double ts, double start, double end, double tolerance_ms = 1000.0);
+    static std::string ueIpKey(const std::string& ip);
 
     // ========================================================================
     // Indexing Helpers
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
 
 #include "common/types.h"
+#include "event_extractor/streaming_json_writer.h"
 #include "session/session_correlator.h"
 #include "session/session_types.h"
 
@@ -15,6 +17,8 @@ namespace callflow {
  */
 class JsonExporter {
 public:
+    using SessionCallback = std::function<void(const nlohmann::json&)>;
+
     JsonExporter() = default;
     ~JsonExporter() = default;
 
@@ -36,11 +40,21 @@ public:
 
     /**
      * Export all sessions to a file
+     *
+     * Sessions are streamed to disk one at a time. A ".ndjson"/".jsonl" name
+     * selects NDJSON and a ".gz" suffix selects gzip compression.
      */
     bool exportToFile(const std::string& filename,
                       const std::vector<std::shared_ptr<Session>>& sessions,
                       bool pretty_print = true);
 
+    /**
+     * Export all sessions to a file with explicit writer options
+     */
+    bool exportToFile(const std::string& filename,
+                      const std::vector<std::shared_ptr<Session>>& sessions,
+                      const StreamingJsonWriter::Options& options);
+
     /**
      * Export job result with metadata
      */
@@ -60,7 +74,21 @@ public:
      */
     std::string exportAllSessionsWithSipOnly(const EnhancedSessionCorrelator& correlator);
 
+    /**
+     * Streaming variant of exportAllSessionsWithSipOnly()
+     *
+     * Builds each session object on demand and hands it to @p callback, so
+     * the full session array is never held in memory.
+     *
+     * @return Number of sessions passed to the callback
+     */
+    size_t exportAllSessionsWithSipOnly(const EnhancedSessionCorrelator& correlator,
+                                        const SessionCallback& callback);
+
 private:
+    nlohmann::json masterSessionToJson(const EnhancedSessionCorrelator& correlator,
+                                       const VolteMasterSession& master);
+    nlohmann::json sipOnlySessionToJson(const nlohmann::json& sip_session);
     std::string formatJson(const nlohmann::json& j, bool pretty_print = true);
 };
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <nlohmann/json.hpp>
+#include <string>
+
+namespace callflow {
+
+/**
+ * Streaming session writer
+ *
+ * Serializes sessions one at a time into a buffered file instead of building
+ * the whole document in memory, so peak memory is bounded by the largest
+ * single session. Two layouts are supported:
+ *   - JSON:   {"metadata": ..., "sessions": [ <one session per line> ]}
+ *   - NDJSON: an optional {"metadata": ...} line, then one session per line
+ * Output can optionally be gzip-compressed when built with zlib.
+ */
+class StreamingJsonWriter {
+public:
+    enum class Format { JSON, NDJSON };
+
+    struct Options {
+        Format format = Format::JSON;
+        bool gzip = false;
+        size_t buffer_size = 1 << 20;
+        int indent = -1;  // nlohmann::json::dump() indent; -1 writes compact sessions
+    };
+
+    /**
+     * Byte range of a written session in the uncompressed output
+     */
+    struct Range {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+    };
+
+    StreamingJsonWriter();
+    explicit StreamingJsonWriter(Options options);
+    ~StreamingJsonWriter();
+
+    StreamingJsonWriter(const StreamingJsonWriter&) = delete;
+    StreamingJsonWriter& operator=(const StreamingJsonWriter&) = delete;
+
+    /**
+     * Whether gzip output is available in this build
+     */
+    static bool gzipSupported();
+
+    /**
+     * Options implied by a file name: ".ndjson"/".jsonl" selects NDJSON and a
+     * trailing ".gz" selects gzip, e.g. "sessions.ndjson.gz"
+     */
+    static Options optionsForPath(const std::string& path);
+
+    /**
+     * Create @p path and write the document header
+     * @param metadata Written before the sessions unless null
+     * @return false if the file cannot be created or gzip is unavailable
+     */
+    bool open(const std::string& path, const nlohmann::json& metadata = nullptr);
+
+    /**
+     * Serialize and append one session
+     * @return Byte range of the serialized session
+     */
+    Range writeSession(const nlohmann::json& session);
+
+    /**
+     * Terminate the document and flush everything to disk
+     * @return false if any write failed
+     */
+    bool close();
+
+    bool isOpen() const { return file_ != nullptr || gz_file_ != nullptr; }
+
+    /**
+     * Uncompressed bytes produced so far, including buffered output
+     */
+    uint64_t bytesWritten() const { return bytes_written_; }
+
+    size_t sessionsWritten() const { return sessions_written_; }
+
+private:
+    void append(const std::string& text);
+    bool flush();
+
+    Options options_;
+    std::FILE* file_ = nullptr;
+    void* gz_file_ = nullptr;  // gzFile, kept opaque so zlib stays out of the header
+    std::string buffer_;
+    uint64_t bytes_written_ = 0;
+    size_t sessions_written_ = 0;
+    bool failed_ = false;
+};
+
+}  // namespace callflow
@@ -1,9 +1,10 @@
 #pragma once
 
+#include "common/flat_lru_table.h"
 #include "common/types.h"
-#include <map>
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <vector>
 #include <chrono>
 
 // Forward declarations for nDPI structures
@@ -31,14 +32,25 @@ struct NdpiCachedFlow {
     NdpiCachedFlow& operator=(NdpiCachedFlow&&) = default;
     NdpiCachedFlow(const NdpiCachedFlow&) = delete;
     NdpiCachedFlow& operator=(const NdpiCachedFlow&) = delete;
+
+    /**
+     * Release the data nDPI attached to the flow and return the entry to its
+     * freshly allocated state, keeping the structures themselves
+     */
+    void reset();
 };
 
 /**
  * Flow cache for nDPI with LRU eviction
  *
- * Maintains a cache of nDPI flow structures keyed by 5-tuple to avoid
- * recreating them for every packet. Implements timeout-based eviction
- * and optional LRU-based size limits.
+ * Maintains a cache of nDPI flow structures keyed by the binary 5-tuple to
+ * avoid recreating them for every packet. Flows live in a FlatLruTable kept in
+ * access order, which gives the least recently used flow in O(1). Packets arrive in capture order, so that
+ * flow is also the first one to time out.
+ *
+ * Not thread-safe: each ingest worker owns its own cache (through its own
+ * NdpiWrapper), so lookups take no lock. Stats of several caches add up with
+ * operator+=.
  */
 class NdpiFlowCache {
 public:
@@ -52,10 +64,11 @@ public:
 
     /**
      * Get or create a cached flow for the given 5-tuple
-     * @param ft Five-tuple identifying the flow
-     * @return Pointer to cached flow (never null)
+     * @param key Five-tuple identifying the flow
+     * @param now Packet timestamp, recorded as the flow's last activity
+     * @return Pointer to cached flow (never null), valid until the next call
      */
-    NdpiCachedFlow* getOrCreateFlow(const FiveTuple& ft);
+    NdpiCachedFlow* getOrCreateFlow(const FlowKey& key, Timestamp now);
 
     /**
      * Clean up expired flows based on timeout
@@ -67,7 +80,7 @@ public:
     /**
      * Get current number of cached flows
      */
-    size_t size() const;
+    size_t size() const { return flows_.size(); }
 
     /**
      * Clear all cached flows
@@ -78,35 +91,34 @@ public:
      * Get cache statistics
      */
     struct Stats {
-        size_t total_flows;
-        size_t cache_hits;
-        size_t cache_misses;
-        size_t evictions_timeout;
-        size_t evictions_lru;
+        size_t total_flows = 0;
+        size_t cache_hits = 0;
+        size_t cache_misses = 0;
+        size_t evictions_timeout = 0;
+        size_t evictions_lru = 0;
+
+        Stats& operator+=(const Stats& other) {
+            total_flows += other.total_flows;
+            cache_hits += other.cache_hits;
+            cache_misses += other.cache_misses;
+            evictions_timeout += other.evictions_timeout;
+            evictions_lru += other.evictions_lru;
+            return *this;
+        }
     };
 
     Stats getStats() const;
 
 private:
-    mutable std::mutex mutex_;
     int timeout_sec_;
     size_t max_flows_;
 
-    // Flow cache: key is 5-tuple hash string
-    std::map<std::string, NdpiCachedFlow> flows_;
+    FlatLruTable<FlowKey, NdpiCachedFlow> flows_;  // Oldest first: least recently used
 
     // Statistics
-    mutable Stats stats_;
+    Stats stats_;
 
-    /**
-     * Evict oldest flows if cache is over limit
-     */
-    void evictOldestFlows();
-
-    /**
-     * Create flow key from 5-tuple
-     */
-    static std::string makeFlowKey(const FiveTuple& ft);
+    void removeFlow(uint32_t index);
 };
 
 }  // namespace callflow
@@ -8,6 +8,8 @@ namespace callflow {
 
 /**
  * nDPI wrapper with flow caching (M2 implementation enhanced in M3)
+ *
+ * One wrapper per ingest worker: the flow cache it owns is not locked.
  */
 class NdpiWrapper {
 public:
@@ -21,13 +23,15 @@ public:
 
     /**
      * Classify a packet using cached flow state
+     * @param ts Packet timestamp, drives flow expiry
      */
-    ProtocolType classifyPacket(const uint8_t* data, size_t len, const FiveTuple& ft);
+    ProtocolType classifyPacket(const uint8_t* data, size_t len, const FlowKey& flow,
+                                Timestamp ts);
 
     /**
-     * Clean up expired flows from cache
+     * Clean up flows idle since before now - timeout
      */
-    size_t cleanupExpiredFlows();
+    size_t cleanupExpiredFlows(Timestamp now);
 
     /**
      * Get flow cache statistics
@@ -48,7 +52,7 @@ private:
     /**
      * Fallback classification using port-based heuristics
      */
-    ProtocolType fallbackClassification(const FiveTuple& ft);
+    ProtocolType fallbackClassification(const FlowKey& ft);
 
     [[maybe_unused]] void* ndpi_struct_;  // Opaque pointer to nDPI structure
     bool initialized_;
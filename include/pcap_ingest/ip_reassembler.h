@@ -1,80 +1,128 @@
 #pragma once
 
 #include <chrono>
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
-#include <string>
 #include <vector>
 
+#include "common/flat_lru_table.h"
 #include "common/types.h"
 
 namespace callflow {
 
 /**
- * Key to identify an IP fragment series
+ * IPv4 / IPv6 fragment reassembly with bounded memory
+ *
+ * Datagrams in progress are found through an open-addressing table keyed on
+ * binary addresses, identification and protocol. Each one owns a single
+ * buffer that fragments are copied into at their final position, and an
+ * RFC 815 hole list that says which bytes are still missing; bytes already
+ * filled win over overlapping retransmissions, and the overlap is counted.
+ *
+ * The reassembly timer starts with the first fragment (RFC 791) and every
+ * datagram shares the same timeout, so creation order is expiry order: a
+ * FIFO of pending datagrams is the expiry queue and each fragment only
+ * checks its head. The same FIFO gives the oldest datagram to drop when the
+ * datagram count or the memory budget would be exceeded.
  */
-struct IpFragmentKey {
-    std::string src_ip;
-    std::string dst_ip;
-    uint32_t id;       // Identification field
-    uint8_t protocol;  // Protocol or Next Header
-    bool is_ipv6;
-
-    bool operator<(const IpFragmentKey& other) const {
-        if (src_ip != other.src_ip)
-            return src_ip < other.src_ip;
-        if (dst_ip != other.dst_ip)
-            return dst_ip < other.dst_ip;
-        if (id != other.id)
-            return id < other.id;
-        if (protocol != other.protocol)
-            return protocol < other.protocol;
-        return is_ipv6 < other.is_ipv6;
-    }
-};
-
-/**
- * Stores fragments for a specific packet
- */
-struct FragmentList {
-    std::map<uint32_t, std::vector<uint8_t>> fragments;  // Offset -> Data
-    uint32_t total_length = 0;
-    bool seen_last_fragment = false;
-    std::chrono::steady_clock::time_point last_update;
-
-    // For IPv6, we need to preserve the unfragmentable part (first packet's header info)
-    // We will just reconstruct based on the first fragment (offset 0) header + reassembled payload.
-};
-
 class IpReassembler {
 public:
-    IpReassembler(uint32_t timeout_sec = 30);
+    struct Limits {
+        size_t max_datagrams = 16384;
+        size_t memory_budget_bytes = 32 * 1024 * 1024;
+        std::chrono::seconds timeout{30};
+    };
+
+    IpReassembler() : IpReassembler(Limits()) {}
+    explicit IpReassembler(const Limits& limits);
 
     /**
      * Process an IP packet and attempt reassembly.
-     * @param timestamp Packet timestamp
      * @param ip_data Pointer to start of IP header
      * @param len Total length of IP packet (header + payload)
-     * @return Optional containing the FULL reassembled IP packet (including header).
-     *         If not fragmented, returns a copy of input.
+     * @param now Capture time of the packet, drives fragment expiry
+     * @return View of the FULL IP packet (including header).
+     *         If not fragmented, the view refers to @p ip_data itself (no copy).
+     *         If this fragment completed a packet, the view refers to an internal
+     *         buffer that stays valid until the next call.
      *         If fragment but incomplete, returns std::nullopt.
      */
-    std::optional<std::vector<uint8_t>> processPacket(const uint8_t* ip_data, size_t len);
+    std::optional<ByteView> processPacket(const uint8_t* ip_data, size_t len, Timestamp now);
 
     /**
-     * Clean up timed out fragment lists
+     * Drop datagrams whose first fragment arrived before now - timeout
+     * @return Number of datagrams expired
      */
-    void cleanup();
+    size_t expire(Timestamp now);
+
+    size_t pendingDatagrams() const { return datagrams_.size(); }
+    size_t bufferedBytes() const { return buffered_bytes_; }
+    const DefragStats& getStats() const { return stats_; }
 
 private:
-    std::map<IpFragmentKey, FragmentList> active_reassemblies_;
-    uint32_t timeout_sec_;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Key {
+        IpAddress src;
+        IpAddress dst;
+        uint32_t id = 0;
+        uint8_t protocol = 0;
+
+        bool operator==(const Key& other) const {
+            return id == other.id && protocol == other.protocol && src == other.src &&
+                   dst == other.dst;
+        }
+    };
+
+    /**
+     * Missing payload bytes [first, last] (RFC 815 hole descriptor)
+     */
+    struct Hole {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    struct Datagram {
+        Timestamp created;
+
+        // Rebuilt header followed by the payload, written in place
+        std::vector<uint8_t> buffer;
+        uint32_t header_len = 0;
+        uint32_t total_length = 0;  // Payload length, known once the last fragment arrived
+        std::vector<Hole> holes;
+    };
+
+    /**
+     * One fragment, normalized across IPv4 and IPv6
+     */
+    struct Fragment {
+        Key key;
+        const uint8_t* header;  // Fixed header to copy into the reassembled packet
+        uint32_t header_len;
+        const uint8_t* payload;
+        uint32_t payload_len;
+        uint32_t offset;
+        bool more;
+    };
+
+    std::optional<ByteView> handleIpv4(const uint8_t* ip_data, size_t len, Timestamp now);
+    std::optional<ByteView> handleIpv6(const uint8_t* ip_data, size_t len, Timestamp now);
+    std::optional<ByteView> addFragment(const Fragment& frag, Timestamp now);
+    void finishHeader(Datagram& datagram, uint8_t protocol) const;
+
+    uint32_t createDatagram(const Key& key, uint32_t hash, Timestamp now);
+    void removeDatagram(uint32_t index);
+    bool reserve(uint32_t index, size_t size);
+
+    Limits limits_;
+    FlatLruTable<Key, Datagram> datagrams_;  // Oldest first: by first fragment
+    size_t buffered_bytes_ = 0;
 
-    // Helper for IPv4
-    std::optional<std::vector<uint8_t>> handleIpv4(const uint8_t* ip_data, size_t len);
+    // Output of the most recent successful reassembly
+    std::vector<uint8_t> reassembled_;
 
-    // Helper for IPv6
-    std::optional<std::vector<uint8_t>> handleIpv6(const uint8_t* ip_data, size_t len);
+    DefragStats stats_;
 };
 
 }  // namespace callflow
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace callflow {
+
+/**
+ * Read-only memory mapping of a capture file
+ *
+ * The whole file is mapped once and advised for sequential access, so the
+ * capture readers can walk records in place instead of copying each one.
+ * Pointers into the mapping stay valid until close() or destruction.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Map @p filename read-only
+     * @return false if the file cannot be opened or mapped (e.g. empty, pipe)
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * Unmap the file
+     */
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace callflow
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -183,6 +184,21 @@ private:
     static constexpr std::chrono::seconds PORT_TTL{300};
 };
 
+/**
+ * Correlator input recorded by a PacketProcessor shard instead of being applied
+ * immediately. ShardedPacketProcessor replays these in (frame_number, sequence)
+ * order during its merge step so that the correlator sees the same message
+ * order as a single-threaded run.
+ */
+struct DeferredCorrelatorInput {
+    uint32_t frame_number = 0;
+    uint32_t sequence = 0;  // Emission order within the frame
+    PacketMetadata metadata;
+    ProtocolType protocol = ProtocolType::UNKNOWN;
+    nlohmann::json parsed_data;
+    std::optional<SipMessage> sip_message;  // Set for processSipMessage() inputs
+};
+
 /**
  * Orchestrates packet processing:
  * 1. Link Layer Stripping
@@ -195,6 +211,15 @@ class PacketProcessor {
 public:
     PacketProcessor(EnhancedSessionCorrelator& correlator);
 
+    /**
+     * Construct a processor that shares port learning state with other processors
+     * (used by ShardedPacketProcessor so SIP/RTP ports learned on one shard are
+     * visible to all shards)
+     */
+    PacketProcessor(EnhancedSessionCorrelator& correlator,
+                    std::shared_ptr<SipPortTracker> sip_port_tracker,
+                    std::shared_ptr<DynamicPortTracker> dynamic_port_tracker);
+
     /**
      * Process a raw packet from PCAP/PCAPNG
      * @param data Raw packet data (including Link Header)
@@ -206,6 +231,30 @@ public:
     void processPacket(const uint8_t* data, size_t len, Timestamp ts, uint32_t frame_number,
                        int dlt);
 
+    /**
+     * Process an already defragmented IP datagram (link layer stripped)
+     * Used by ShardedPacketProcessor workers; the reader thread owns link
+     * parsing and IP reassembly.
+     */
+    void processIpDatagram(ByteView ip_packet, Timestamp ts,
+                           uint32_t frame_number);
+
+    /**
+     * Record correlator input into @p sink instead of forwarding it to the
+     * correlator. Pass nullptr to restore direct forwarding.
+     */
+    void setDeferredOutput(std::vector<DeferredCorrelatorInput>* sink) { deferred_output_ = sink; }
+
+    /**
+     * Set the job tag used in the upper half of every PacketId (see makePacketId())
+     */
+    void setJobTag(uint32_t job_tag) { job_tag_ = job_tag; }
+
+    /**
+     * IP fragment reassembly counters
+     */
+    const DefragStats& getDefragStats() const { return ip_reassembler_.getStats(); }
+
 private:
     EnhancedSessionCorrelator& correlator_;
     LinkLayerParser link_parser_;
@@ -214,11 +263,8 @@ private:
     SctpParser sctp_parser_;
 
     // Stateful parsers
-    // Map: FiveTuple -> Http2Connection
-    // Note: We use FiveTuple hash as key for simpler map, or specialized hash map
-    // Map: FiveTuple -> Http2Connection
-    // Note: We use FiveTuple hash as key for simpler map, or specialized hash map
-    std::unordered_map<FiveTuple, Http2Connection> http2_sessions_;
+    // Map: FlowKey -> Http2Connection
+    std::unordered_map<FlowKey, Http2Connection> http2_sessions_;
 
     struct TcpStreamBuffer {
         std::vector<uint8_t> buffer;
@@ -237,11 +283,19 @@ private:
          */
         void appendData(const uint8_t* data, size_t len);
 
+        /**
+         * A complete SIP message inside the buffer
+         */
+        struct MessageView {
+            const uint8_t* data;
+            size_t size;
+        };
+
         /**
          * Extract all complete SIP messages from buffer
-         * @return Vector of complete SIP messages
+         * @return Views into the buffer, valid until the next appendData() or reset()
          */
-        std::vector<std::vector<uint8_t>> extractCompleteMessages();
+        std::vector<MessageView> extractCompleteMessages();
 
         /**
          * Reset buffer (overflow protection)
@@ -251,7 +305,7 @@ private:
         /**
          * Get current buffer size
          */
-        size_t getBufferSize() const { return buffer_.size(); }
+        size_t getBufferSize() const { return buffer_.size() - read_pos_; }
 
         // Public constants for buffer size limits
         static constexpr size_t MAX_SIP_MESSAGE_SIZE = 64 * 1024;  // 64KB
@@ -259,48 +313,69 @@ private:
 
     private:
         std::vector<uint8_t> buffer_;
-
-        /**
-         * Detect complete SIP message boundaries
-         * @param start_pos Starting position in buffer
-         * @return Length of complete message if found, nullopt otherwise
-         */
-        std::optional<size_t> findMessageBoundary(size_t start_pos) const;
+        size_t read_pos_ = 0;  // Bytes already extracted; dropped on the next append
     };
 
     // TCP Buffers for SIP and Diameter
-    std::unordered_map<FiveTuple, SipTcpStreamBuffer> sip_tcp_buffers_;
-    std::unordered_map<FiveTuple, TcpStreamBuffer> diameter_sessions_;
+    std::unordered_map<FlowKey, SipTcpStreamBuffer> sip_tcp_buffers_;
+    std::unordered_map<FlowKey, TcpStreamBuffer> diameter_sessions_;
 
     // Parsers
     FiveGSbaParser sba_parser_;
     Http2Parser http2_parser_;
 
     // Dynamic port tracker for RTP
-    DynamicPortTracker dynamic_port_tracker_;
+    std::shared_ptr<DynamicPortTracker> dynamic_port_tracker_;
 
     // SIP port tracker for non-standard ports
-    SipPortTracker sip_port_tracker_;
+    std::shared_ptr<SipPortTracker> sip_port_tracker_;
 
     // Packet deduplicator for multi-interface captures
     PacketDeduplicator packet_deduplicator_;
 
-    void processIpPacket(const std::vector<uint8_t>& ip_packet, Timestamp ts, uint32_t frame_number,
+    // Deferred correlator output (sharded mode), nullptr for direct forwarding
+    std::vector<DeferredCorrelatorInput>* deferred_output_ = nullptr;
+
+    // Frame currently being processed (SCTP callback and deferred ordering)
+    uint32_t current_frame_ = 0;
+    uint32_t frame_sequence_ = 0;
+    Timestamp current_ts_{};
+    uint32_t job_tag_ = 0;
+
+    void processIpPacket(ByteView ip_packet, Timestamp ts, uint32_t frame_number,
                          int recursion_depth = 0);
-    void processTransportAndPayload(const PacketMetadata& metadata,
-                                    const std::vector<uint8_t>& payload, int recursion_depth);
+    void processTransportAndPayload(PacketMetadata& metadata, ByteView payload,
+                                    int recursion_depth);
 
     /**
      * Process reassembled SCTP messages and route by PPID
      */
-    void processSctpMessage(const SctpReassembledMessage& message, const PacketMetadata& metadata);
+    void processSctpMessage(const SctpReassembledMessage& message, PacketMetadata& metadata);
+
+    /**
+     * Forward parsed output to the correlator (or the deferred sink)
+     * Renders the textual five_tuple addresses from flow_key on first use.
+     */
+    void submitPacket(PacketMetadata& metadata, ProtocolType protocol,
+                      const nlohmann::json& parsed_data);
+    void submitSipMessage(const SipMessage& msg, PacketMetadata& metadata);
+
+    /**
+     * Fill five_tuple.src_ip/dst_ip from the binary flow key if not done yet
+     */
+    static void renderAddresses(PacketMetadata& metadata);
+
+    /**
+     * Mark the start of a new captured frame
+     */
+    void beginFrame(uint32_t frame_number, Timestamp ts);
 
 public:
     /**
      * Get the dynamic port tracker instance
      * Used by SIP parser to register RTP ports from SDP
      */
-    DynamicPortTracker& getDynamicPortTracker() { return dynamic_port_tracker_; }
+    DynamicPortTracker& getDynamicPortTracker() { return *dynamic_port_tracker_; }
 
 private:
     /**
@@ -2,6 +2,7 @@
 
 #include "common/types.h"
 #include "common/logger.h"
+#include "pcap_ingest/mapped_file.h"
 #include <pcap/pcap.h>
 #include <string>
 #include <functional>
@@ -16,8 +17,12 @@ namespace callflow {
 using PacketCallback = std::function<void(const uint8_t*, const struct pcap_pkthdr*, void*)>;
 
 /**
- * PCAP file reader using libpcap
- * Supports streaming processing of PCAP files
+ * PCAP file reader
+ * Classic pcap files are memory-mapped and their records walked in place, so
+ * packet pointers refer directly into the mapping and stay valid until close().
+ * Anything the mapped path cannot handle (pipes, unknown magic) falls back to
+ * streaming through libpcap, where a packet pointer is only valid until the
+ * next read.
  */
 class PcapReader {
 public:
@@ -36,11 +41,34 @@ public:
      */
     void close();
 
+    /**
+     * Enable or disable the memory-mapped read path (default: enabled)
+     * Takes effect on the next open().
+     */
+    void setUseMmap(bool use_mmap) { use_mmap_ = use_mmap; }
+
+    /**
+     * True if the open file is read through a memory mapping
+     * Packet buffers then remain valid until close().
+     */
+    bool isMemoryMapped() const { return mapped_.isOpen(); }
+
     /**
      * Check if a file is currently open
      */
     bool isOpen() const;
 
+    /**
+     * Read position in the capture file, for progress reporting
+     * Exact for the mapped path, derived from record sizes for libpcap.
+     */
+    uint64_t getFileOffset() const;
+
+    /**
+     * Size of the open capture file in bytes (0 if unknown)
+     */
+    uint64_t getFileSize() const { return file_size_; }
+
     /**
      * Get datalink type (e.g., DLT_EN10MB for Ethernet)
      */
@@ -85,12 +113,24 @@ public:
     void resetStats();
 
 private:
+    bool openMapped(const std::string& filename);
+    bool readNextMapped(struct pcap_pkthdr& header, const uint8_t*& data);
+    void recordPacket(const struct pcap_pkthdr& header);
+
     pcap_t* pcap_handle_;
     std::string filename_;
     int datalink_type_;
     int snaplen_;
     Stats stats_;
     bool is_open_;
+    uint64_t file_size_ = 0;
+
+    // Memory-mapped read path
+    bool use_mmap_ = true;
+    MappedFile mapped_;
+    size_t map_offset_ = 0;
+    bool swapped_ = false;      // File byte order differs from host
+    bool nanosecond_ = false;   // Record timestamps carry nanoseconds
 
     // Disable copy
     PcapReader(const PcapReader&) = delete;
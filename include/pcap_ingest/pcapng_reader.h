@@ -10,6 +10,7 @@
 
 #include "common/logger.h"
 #include "common/types.h"
+#include "pcap_ingest/mapped_file.h"
 
 namespace callflow {
 
@@ -290,6 +291,12 @@ struct SectionHeaderBlock {
 
 /**
  * PCAPNG Reader - Advanced reader for PCAPNG files with full block support
+ *
+ * Files are memory-mapped by default and blocks are parsed in place, so the
+ * packet pointers handed to processPackets() callbacks refer directly into the
+ * mapping and stay valid until close(). If the file cannot be mapped the
+ * reader falls back to buffered stdio, where a packet pointer is only valid
+ * for the duration of the callback.
  */
 class PcapngReader {
 public:
@@ -313,6 +320,27 @@ public:
      */
     bool isOpen() const { return is_open_; }
 
+    /**
+     * Enable or disable the memory-mapped read path (default: enabled)
+     * Takes effect on the next open().
+     */
+    void setUseMmap(bool use_mmap) { use_mmap_ = use_mmap; }
+
+    /**
+     * True if the open file is read through a memory mapping
+     */
+    bool isMemoryMapped() const { return mapped_.isOpen(); }
+
+    /**
+     * Read position in the file (end of the last block read), for progress reporting
+     */
+    uint64_t getFileOffset() const { return stats_.bytes_read; }
+
+    /**
+     * Size of the open file in bytes (0 if unknown)
+     */
+    uint64_t getFileSize() const { return file_size_; }
+
     /**
      * Read next block from file
      * @return true if block was read, false on EOF or error
@@ -416,10 +444,18 @@ private:
     std::string filename_;
     bool is_open_;
     bool is_little_endian_;  // Byte order from Section Header
+    uint64_t file_size_ = 0;
+
+    // Memory-mapped read path
+    bool use_mmap_ = true;
+    MappedFile mapped_;
+    size_t map_offset_ = 0;
 
     // Current state
     PcapngBlockType current_block_type_;
-    std::vector<uint8_t> current_block_data_;
+    std::vector<uint8_t> current_block_data_;  // Block body buffer (stdio path only)
+    const uint8_t* block_data_ = nullptr;      // Current block body (mapping or buffer)
+    size_t block_size_ = 0;
 
     // File structure
     SectionHeaderBlock section_header_;
@@ -433,6 +469,10 @@ private:
     // Block parsing helpers
     bool readBlockHeader(uint32_t& block_type, uint32_t& block_length);
     bool readBlockData(uint32_t block_length);
+    bool readMappedBlock(uint32_t& block_type, uint32_t& block_length);
+    bool parseEnhancedPacketView(uint32_t& interface_id, uint64_t& timestamp,
+                                 const uint8_t*& packet_data, uint32_t& captured_length,
+                                 uint32_t& original_length, PcapngPacketMetadata& metadata);
     bool parseSectionHeader();
     bool parseInterfaceDescription();
     bool parseEnhancedPacket();
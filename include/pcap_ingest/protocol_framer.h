@@ -63,17 +63,10 @@ private:
     std::vector<uint8_t> buffer_;
 
     /**
-     * Find Content-Length header value
-     * @param headers Headers section (up to \r\n\r\n)
-     * @return Content-Length value or 0 if not found
-     */
-    int findContentLength(const std::string& headers);
-
-    /**
-     * Check if buffer contains a complete SIP message
+     * Check if buffer contains a complete SIP message at offset
      * @return Size of complete message, or 0 if incomplete
      */
-    size_t findCompleteMessage();
+    size_t findCompleteMessage(size_t offset);
 };
 
 /**
@@ -0,0 +1,405 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace callflow {
+
+namespace ring_detail {
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+inline size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * Spin, then yield, then sleep while waiting on a full/empty ring
+ */
+class Backoff {
+public:
+    void pause() {
+        if (spins_ < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else if (spins_ < 256) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        ++spins_;
+    }
+
+    void reset() { spins_ = 0; }
+
+private:
+    uint32_t spins_ = 0;
+};
+
+}  // namespace ring_detail
+
+/**
+ * Bounded lock-free single-producer/single-consumer ring
+ *
+ * Items are stored by value in a power-of-two slot array. Producer and
+ * consumer indices live on separate cache lines, and each side caches the
+ * other side's index so the shared line is only touched when the ring looks
+ * full (producer) or empty (consumer). Batched operations publish a whole
+ * batch with a single release store.
+ *
+ * Blocking push()/pop() follow the PacketQueue contract: push() waits while
+ * the ring is full and fails once closed; pop() waits while the ring is empty
+ * and fails only when it is closed and drained.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(ring_detail::roundUpPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          slots_(new T[capacity_]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Producer: enqueue one item without blocking
+     * @return false if the ring is full or closed (item is left untouched)
+     */
+    bool tryPush(T&& item) { return tryPushBatch(&item, 1) == 1; }
+
+    /**
+     * Producer: enqueue up to @p count items from @p items without blocking
+     * @return Number of leading items moved into the ring
+     */
+    size_t tryPushBatch(T* items, size_t count) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free_slots = capacity_ - (tail - cached_head_);
+        if (free_slots < count) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free_slots = capacity_ - (tail - cached_head_);
+        }
+        size_t n = count < free_slots ? count : free_slots;
+        for (size_t i = 0; i < n; ++i) {
+            slots_[(tail + i) & mask_] = std::move(items[i]);
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * Producer: enqueue one item, waiting while the ring is full
+     * @return false if the ring was closed
+     */
+    bool push(T&& item) { return pushBatch(&item, 1) == 1; }
+
+    /**
+     * Producer: enqueue all @p count items, waiting while the ring is full
+     * @return Number of items enqueued (less than @p count only if closed)
+     */
+    size_t pushBatch(T* items, size_t count) {
+        size_t done = 0;
+        ring_detail::Backoff backoff;
+        while (done < count) {
+            if (closed_.load(std::memory_order_acquire)) {
+                break;
+            }
+            size_t n = tryPushBatch(items + done, count - done);
+            if (n == 0) {
+                backoff.pause();
+            } else {
+                done += n;
+                backoff.reset();
+            }
+        }
+        return done;
+    }
+
+    /**
+     * Consumer: dequeue one item without blocking
+     */
+    bool tryPop(T& out) { return tryPopBatch(&out, 1) == 1; }
+
+    /**
+     * Consumer: dequeue up to @p max_count items into @p out without blocking
+     */
+    size_t tryPopBatch(T* out, size_t max_count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t available = cached_tail_ - head;
+        if (available < max_count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            available = cached_tail_ - head;
+        }
+        size_t n = max_count < available ? max_count : available;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = std::move(slots_[(head + i) & mask_]);
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /**
+     * Consumer: dequeue one item, waiting while the ring is empty
+     * @return false once the ring is closed and drained
+     */
+    bool pop(T& out) { return popBatch(&out, 1) == 1; }
+
+    /**
+     * Consumer: dequeue between 1 and @p max_count items, waiting while empty
+     * @return 0 once the ring is closed and drained
+     */
+    size_t popBatch(T* out, size_t max_count) {
+        ring_detail::Backoff backoff;
+        while (true) {
+            size_t n = tryPopBatch(out, max_count);
+            if (n > 0) {
+                return n;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                // Items published before close() must still be delivered
+                return tryPopBatch(out, max_count);
+            }
+            backoff.pause();
+        }
+    }
+
+    /**
+     * Close the ring (no more pushes; consumers drain what is left)
+     */
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() >= capacity_; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Consumer side
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // Producer side
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<bool> closed_{false};
+};
+
+/**
+ * Bounded lock-free multi-producer/multi-consumer ring
+ *
+ * Classic sequence-numbered slot array: each slot carries a sequence counter
+ * that tells producers when it is free and consumers when it is published,
+ * so the only contended operations are the CAS on the enqueue/dequeue
+ * positions. Same close()/back-pressure contract as SpscRing.
+ */
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity)
+        : capacity_(ring_detail::roundUpPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    /**
+     * Enqueue one item without blocking
+     * @return false if the ring is full or closed (item is left untouched)
+     */
+    bool tryPush(T&& item) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Enqueue up to @p count items from @p items without blocking
+     * @return Number of leading items moved into the ring
+     */
+    size_t tryPushBatch(T* items, size_t count) {
+        size_t n = 0;
+        while (n < count && tryPush(std::move(items[n]))) {
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * Enqueue one item, waiting while the ring is full
+     * @return false if the ring was closed
+     */
+    bool push(T&& item) { return pushBatch(&item, 1) == 1; }
+
+    /**
+     * Enqueue all @p count items, waiting while the ring is full
+     * @return Number of items enqueued (less than @p count only if closed)
+     */
+    size_t pushBatch(T* items, size_t count) {
+        size_t done = 0;
+        ring_detail::Backoff backoff;
+        while (done < count) {
+            if (closed_.load(std::memory_order_acquire)) {
+                break;
+            }
+            size_t n = tryPushBatch(items + done, count - done);
+            if (n == 0) {
+                backoff.pause();
+            } else {
+                done += n;
+                backoff.reset();
+            }
+        }
+        return done;
+    }
+
+    /**
+     * Dequeue one item without blocking
+     */
+    bool tryPop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeue up to @p max_count items into @p out without blocking
+     */
+    size_t tryPopBatch(T* out, size_t max_count) {
+        size_t n = 0;
+        while (n < max_count && tryPop(out[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * Dequeue one item, waiting while the ring is empty
+     * @return false once the ring is closed and drained
+     */
+    bool pop(T& out) { return popBatch(&out, 1) == 1; }
+
+    /**
+     * Dequeue between 1 and @p max_count items, waiting while empty
+     * @return 0 once the ring is closed and drained
+     */
+    size_t popBatch(T* out, size_t max_count) {
+        ring_detail::Backoff backoff;
+        while (true) {
+            size_t n = tryPopBatch(out, max_count);
+            if (n > 0) {
+                return n;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                return tryPopBatch(out, max_count);
+            }
+            backoff.pause();
+        }
+    }
+
+    /**
+     * Close the ring (no more pushes; consumers drain what is left)
+     * Producers must have returned from push() before the last pop().
+     */
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t size() const {
+        size_t enq = enqueue_pos_.load(std::memory_order_acquire);
+        size_t deq = dequeue_pos_.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    bool full() const { return size() >= capacity_; }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T data{};
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+    alignas(ring_detail::CACHE_LINE_SIZE) std::atomic<bool> closed_{false};
+};
+
+}  // namespace callflow
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/types.h"
+#include "pcap_ingest/ip_reassembler.h"
+#include "pcap_ingest/link_layer_parser.h"
+#include "pcap_ingest/packet_processor.h"
+#include "pcap_ingest/ring_buffer.h"
+#include "session/session_correlator.h"
+
+namespace callflow {
+
+/**
+ * Multi-worker ingest front end for PacketProcessor
+ *
+ * The calling (reader) thread performs link layer stripping and IP
+ * defragmentation, then dispatches each datagram to one of N worker shards by a
+ * symmetric flow hash, in batches over a per-shard lock-free SPSC ring. GTP-U
+ * packets are hashed on their inner 5-tuple (falling back to the TEID) so that
+ * tunnelled TCP/SIP flows stay on one shard in both directions. Every shard
+ * owns a PacketProcessor with its own TCP, SCTP and HTTP/2 reassembly state and
+ * records its correlator input instead of applying it. The reader thread
+ * periodically replays the recorded input into the correlator in capture
+ * order, up to a watermark frame below which no shard can produce more input,
+ * so recorded input does not accumulate over the capture. finish() joins the
+ * workers and replays the rest.
+ *
+ * With a single shard no worker thread is started and packets are processed
+ * inline, exactly like a plain PacketProcessor.
+ */
+class ShardedPacketProcessor {
+public:
+    /**
+     * Per-shard throughput counters for the processing summary
+     */
+    struct ShardStats {
+        size_t shard_id = 0;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        uint64_t correlator_inputs = 0;
+        double busy_seconds = 0.0;  // Time spent inside the shard's PacketProcessor
+
+        double packetsPerSecond() const {
+            return busy_seconds > 0.0 ? static_cast<double>(packets) / busy_seconds : 0.0;
+        }
+    };
+
+    /**
+     * @param correlator Correlator receiving the merged output
+     * @param num_shards Number of worker shards (Config::worker_threads)
+     * @param queue_depth Per-shard queue depth (Config::max_packet_queue_size)
+     */
+    ShardedPacketProcessor(EnhancedSessionCorrelator& correlator, size_t num_shards,
+                           size_t queue_depth = 10000);
+    ~ShardedPacketProcessor();
+
+    /**
+     * Called during the final merge with the number of correlator inputs
+     * replayed so far and the number to replay
+     */
+    using MergeProgress = std::function<void(size_t merged, size_t total)>;
+
+    ShardedPacketProcessor(const ShardedPacketProcessor&) = delete;
+    ShardedPacketProcessor& operator=(const ShardedPacketProcessor&) = delete;
+
+    /**
+     * Process a raw packet from PCAP/PCAPNG (reader thread only)
+     * Same contract as PacketProcessor::processPacket().
+     */
+    void processPacket(const uint8_t* data, size_t len, Timestamp ts, uint32_t frame_number,
+                       int dlt);
+
+    /**
+     * Drain all shards and merge their output into the correlator
+     * Must be called before the correlator is finalized and, with stable
+     * input, before the input buffers are released. Idempotent.
+     * @throws The first exception a shard worker raised while processing;
+     *         that shard received no further packets after it
+     */
+    void finish(const MergeProgress& progress = nullptr);
+
+    /**
+     * Stop and join the workers without merging, discarding queued datagrams
+     * Used when ingest is abandoned (e.g. on an exception) so that no worker
+     * reads stable input after it is released. No-op after finish().
+     */
+    void abort();
+
+    /**
+     * Set the job tag used for PacketIds on all shards
+     */
+    void setJobTag(uint32_t job_tag);
+
+    /**
+     * Declare that packet buffers passed to processPacket() stay valid and
+     * unmodified until finish() returns (e.g. a memory-mapped capture file)
+     * Shards then read datagrams in place instead of receiving a copy.
+     */
+    void setStableInput(bool stable) { stable_input_ = stable; }
+
+    /**
+     * Number of shards packets are distributed over
+     */
+    size_t getShardCount() const { return shards_.size(); }
+
+    /**
+     * Per-shard statistics (complete after finish())
+     */
+    std::vector<ShardStats> getShardStats() const;
+
+    /**
+     * IP fragment reassembly counters of the reader and every shard
+     */
+    DefragStats getDefragStats() const;
+
+    /**
+     * Symmetric flow hash of an IP datagram
+     * Both directions of a flow produce the same value. GTP-U G-PDUs hash on
+     * the inner packet; unparsable datagrams hash to 0.
+     */
+    static uint64_t flowHash(const uint8_t* ip_data, size_t len, int depth = 0);
+
+private:
+    // Datagrams are handed to shards in batches of this size
+    static constexpr size_t DISPATCH_BATCH = 32;
+
+    // Dispatched datagrams between two merges into the correlator
+    static constexpr size_t MERGE_INTERVAL = 4096;
+
+    /**
+     * Defragmented datagram handed from the reader to a shard
+     * Refers to the caller's buffer when the input is stable, otherwise (and
+     * for reassembled datagrams) carries its own copy in @c owned.
+     */
+    struct PacketDescriptor {
+        ByteView view;
+        std::vector<uint8_t> owned;
+        Timestamp timestamp{};
+        uint32_t frame_number = 0;
+        uint32_t wire_length = 0;
+
+        ByteView datagram() const { return owned.empty() ? view : ByteView(owned); }
+    };
+
+    struct Shard {
+        size_t id = 0;
+        std::unique_ptr<PacketProcessor> processor;
+        std::unique_ptr<SpscRing<PacketDescriptor>> queue;  // Reader -> worker
+        std::vector<PacketDescriptor> pending;              // Reader-side batch
+        std::vector<DeferredCorrelatorInput> output;        // Worker-side, per batch
+        std::thread worker;
+
+        // Output handed from the worker after each batch
+        std::mutex ready_mutex;
+        std::vector<DeferredCorrelatorInput> ready;
+        std::atomic<uint32_t> processed_frame{0};  // Frame of the last processed datagram
+
+        // Reader-side: datagrams pushed to the ring, output not yet merged
+        uint64_t dispatched = 0;
+        std::deque<DeferredCorrelatorInput> staged;
+
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<int64_t> busy_ns{0};
+        uint64_t correlator_inputs = 0;
+
+        // Set by the worker when processing throws; read after join()
+        std::exception_ptr error;
+        std::atomic<bool> failed{false};
+    };
+
+    void workerLoop(Shard& shard);
+    void flushPending(Shard& shard);
+
+    /**
+     * Replay all output that is final: flush pending batches, then merge up
+     * to the lowest frame a shard still has queued
+     */
+    void mergeAvailable();
+
+    /**
+     * Move the shard's ready output to the reader side
+     */
+    void collectReady(Shard& shard);
+
+    /**
+     * Replay staged input with frame numbers up to @p watermark in capture order
+     */
+    void mergeIntoCorrelator(uint32_t watermark, const MergeProgress& progress = nullptr,
+                             size_t total = 0);
+
+    EnhancedSessionCorrelator& correlator_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    bool finished_ = false;
+    bool stable_input_ = false;
+    std::atomic<bool> aborted_{false};  // Workers drain their rings without processing
+    uint32_t last_frame_ = 0;  // Frame of the latest processPacket() call
+    size_t since_merge_ = 0;
+
+    // Reader-side state (link layer + defragmentation happen before dispatch)
+    LinkLayerParser link_parser_;
+    IpReassembler ip_reassembler_;
+};
+
+/**
+ * Aborts a ShardedPacketProcessor when the scope holding the capture reader
+ * is left
+ *
+ * Declare it right after the reader: on an exception the workers are then
+ * joined before the reader unmaps the buffers their queued datagrams point
+ * into. After a normal finish() the abort() is a no-op.
+ */
+class ShardAbortGuard {
+public:
+    explicit ShardAbortGuard(ShardedPacketProcessor& processor) : processor_(processor) {}
+    ~ShardAbortGuard() { processor_.abort(); }
+
+    ShardAbortGuard(const ShardAbortGuard&) = delete;
+    ShardAbortGuard& operator=(const ShardAbortGuard&) = delete;
+
+private:
+    ShardedPacketProcessor& processor_;
+};
+
+}  // namespace callflow
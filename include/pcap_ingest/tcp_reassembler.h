@@ -1,48 +1,129 @@
 #pragma once
 
-#include <map>
-#include <optional>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "common/flat_lru_table.h"
 #include "common/types.h"
 
 namespace callflow {
 
 /**
- * Tracks a TCP stream state
+ * Per-direction TCP stream reassembly with bounded memory
+ *
+ * Streams live in a dense pool indexed by an open-addressing table keyed on
+ * the binary FlowKey, and are threaded on an LRU list by last activity. The
+ * cold end of that list doubles as the expiry queue: streams idle for longer
+ * than the timeout are dropped from there as packets arrive, so no call ever
+ * walks the whole table. At max_streams the least recently active stream
+ * makes room for the new one.
+ *
+ * In-order data is handed back without copying. Only segments that arrive
+ * ahead of a gap are buffered, in a per-stream ring that is allocated on the
+ * first gap and released once it closes. When the rings would exceed the
+ * memory budget, the least recently active streams holding buffered data
+ * are evicted (a later segment resynchronizes them mid-stream).
  */
-struct TcpStreamState {
-    uint32_t next_seq = 0;
-    bool syn_seen = false;
-    std::map<uint32_t, std::vector<uint8_t>> out_of_order_segments;
-    std::chrono::steady_clock::time_point last_update;
-};
-
 class TcpReassembler {
 public:
-    TcpReassembler();
+    struct Limits {
+        size_t max_streams = 1 << 20;
+        size_t max_window_bytes = 256 * 1024;           // Out-of-order data per stream
+        size_t memory_budget_bytes = 64 * 1024 * 1024;  // All out-of-order rings
+        std::chrono::seconds idle_timeout{120};
+    };
+
+    struct Stats {
+        uint64_t streams_created = 0;
+        uint64_t streams_expired = 0;
+        uint64_t streams_evicted = 0;  // Stream count or memory budget reached
+        uint64_t segments_buffered = 0;
+        uint64_t segments_dropped = 0;  // Beyond the window or over budget
+        uint64_t bytes_delivered = 0;
+    };
+
+    TcpReassembler() : TcpReassembler(Limits()) {}
+    explicit TcpReassembler(const Limits& limits);
 
     /**
      * Process a TCP segment.
-     * @param flow_id The 5-tuple identifying the flow
+     * @param flow_id The binary 5-tuple identifying the flow
      * @param seq The sequence number of the segment
-     * @param payload TCP payload data
+     * @param payload TCP payload data (only copied if it has to be buffered)
      * @param is_syn True if SYN flag is set
      * @param is_fin True if FIN flag is set
-     * @return Contiguous payload data if available, otherwise empty.
+     * @param now Capture time of the segment, drives idle expiry
+     * @return Contiguous in-order data now available, otherwise empty. The
+     *         view refers to @p payload itself when nothing was buffered, or to
+     *         an internal buffer that stays valid until the next call.
      */
-    std::vector<uint8_t> processSegment(const FiveTuple& flow_id, uint32_t seq,
-                                        const std::vector<uint8_t>& payload, bool is_syn,
-                                        bool is_fin);
+    ByteView processSegment(const FlowKey& flow_id, uint32_t seq, ByteView payload, bool is_syn,
+                            bool is_fin, Timestamp now);
 
     /**
-     * Clean up old streams
+     * Drop streams idle since before now - idle_timeout
+     * @return Number of streams expired
      */
-    void cleanup();
+    size_t expire(Timestamp now);
+
+    size_t activeStreams() const { return streams_.size(); }
+    size_t bufferedBytes() const { return buffered_bytes_; }
+    const Stats& getStats() const { return stats_; }
 
 private:
-    std::map<FiveTuple, TcpStreamState> streams_;
-    uint32_t timeout_sec_ = 120;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    /**
+     * Bytes held ahead of a gap, as [begin, end) offsets from next_seq
+     */
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /**
+     * Intrusive doubly-linked list over stream ids
+     */
+    struct Link {
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+    };
+    struct List {
+        uint32_t head = kNil;  // Least recently active
+        uint32_t tail = kNil;
+    };
+
+    struct Stream {
+        uint32_t next_seq = 0;
+        Timestamp last_seen;
+        Link buffered;  // Streams holding out-of-order data
+
+        // Window ring; offset 0 (next_seq) lives at ring[head]
+        std::vector<uint8_t> ring;
+        uint32_t head = 0;
+        std::vector<Range> pending;  // Sorted, disjoint, non-adjacent
+    };
+
+    uint32_t createStream(const FlowKey& key, uint32_t hash, Timestamp now);
+    void touchStream(uint32_t id, Timestamp now);
+    void removeStream(uint32_t id);
+
+    void unlinkBuffered(uint32_t id);
+    void pushBuffered(uint32_t id);
+
+    bool bufferSegment(uint32_t id, uint32_t offset, ByteView data);
+    bool reserveWindow(uint32_t id, size_t needed);
+    void releaseWindow(uint32_t id);
+    ByteView deliver(uint32_t id, ByteView in_order);
+
+    Limits limits_;
+    FlatLruTable<FlowKey, Stream> streams_;  // Oldest first: by last activity
+    List buffered_;
+    size_t buffered_bytes_ = 0;
+    std::vector<uint8_t> output_;
+    Stats stats_;
 };
 
 }  // namespace callflow
@@ -217,6 +217,36 @@ public:
      */
     int getEventCount(const std::string& session_id);
 
+    // ========================================================================
+    // Bulk Operations
+    // ========================================================================
+
+    /**
+     * Insert sessions and events in transactions of config.batch_size rows
+     *
+     * Uses cached prepared statements and takes the database lock once per
+     * transaction rather than once per row. A failed transaction is rolled
+     * back and the remaining rows are still attempted.
+     *
+     * @param sessions Sessions to insert (inserted before the events)
+     * @param events Events to insert, event_id set on insert
+     * @return Number of rows inserted
+     */
+    size_t insertBatch(const std::vector<SessionRecord>& sessions,
+                       std::vector<EventRecord>& events);
+
+    /**
+     * Insert sessions in batched transactions
+     * @return true if every session was inserted
+     */
+    bool insertSessions(const std::vector<SessionRecord>& sessions);
+
+    /**
+     * Insert events in batched transactions
+     * @return true if every event was inserted
+     */
+    bool insertEvents(std::vector<EventRecord>& events);
+
     // ========================================================================
     // Utility Operations
     // ========================================================================
@@ -256,6 +286,25 @@ private:
     sqlite3* db_;
     std::mutex db_mutex_;
 
+    // Prepared once and reused for every insert; finalized in close()
+    sqlite3_stmt* insert_session_stmt_ = nullptr;
+    sqlite3_stmt* insert_event_stmt_ = nullptr;
+
+    /**
+     * Bind and step the cached session insert (db_mutex_ must be held)
+     */
+    bool stepInsertSession(const SessionRecord& session);
+
+    /**
+     * Bind and step the cached event insert (db_mutex_ must be held)
+     */
+    bool stepInsertEvent(EventRecord& event);
+
+    /**
+     * Return the statement in @p slot, preparing it on first use
+     */
+    sqlite3_stmt* cachedStatement(sqlite3_stmt*& slot, const char* sql);
+
     /**
      * Prepare SQL statement
      * @param sql SQL query
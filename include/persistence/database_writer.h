@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "persistence/database.h"
+
+namespace callflow {
+
+/**
+ * Background writer for bulk session/event ingest
+ *
+ * Producers enqueue records and return immediately; a dedicated thread
+ * drains the queue into DatabaseManager::insertBatch(), committing up to
+ * config.batch_size rows per transaction. The database lock is only taken
+ * per transaction, so HTTP handlers reading the database are not starved
+ * while a large job is persisted. Enqueueing blocks once
+ * config.writer_queue_max rows are pending (backpressure).
+ */
+class DatabaseWriter {
+public:
+    struct Stats {
+        uint64_t rows_queued = 0;
+        uint64_t rows_written = 0;
+        uint64_t rows_failed = 0;
+        uint64_t batches = 0;
+    };
+
+    /**
+     * @param db Database to write to (must outlive the writer's thread)
+     * @param config Batch size and queue limit
+     */
+    DatabaseWriter(std::shared_ptr<DatabaseManager> db, const DatabaseConfig& config);
+
+    /**
+     * Destructor - drains the queue and stops the thread
+     */
+    ~DatabaseWriter();
+
+    DatabaseWriter(const DatabaseWriter&) = delete;
+    DatabaseWriter& operator=(const DatabaseWriter&) = delete;
+
+    void start();
+
+    /**
+     * Write everything still queued, then stop the thread
+     */
+    void stop();
+
+    /**
+     * Queue a session insert
+     * @return false if the writer is not running
+     */
+    bool enqueue(SessionRecord session);
+
+    /**
+     * Queue an event insert
+     * @return false if the writer is not running
+     */
+    bool enqueue(EventRecord event);
+
+    /**
+     * Block until every record queued before the call has been written
+     */
+    void flush();
+
+    Stats getStats() const;
+
+private:
+    void writerThread();
+    bool waitForSpace(std::unique_lock<std::mutex>& lock);
+
+    std::shared_ptr<DatabaseManager> db_;
+    const size_t batch_size_;
+    const size_t max_queued_;
+
+    std::vector<SessionRecord> pending_sessions_;
+    std::vector<EventRecord> pending_events_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;   // Signals the writer thread
+    std::condition_variable space_cv_;  // Signals producers and flush()
+    uint64_t flush_target_ = 0;         // rows_queued value a flush() is waiting for
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    Stats stats_;
+};
+
+}  // namespace callflow
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "diameter_base.h"
+
+namespace callflow {
+namespace diameter {
+
+// ============================================================================
+// Flat Diameter AVP Tree
+// ============================================================================
+
+/**
+ * All AVPs of one Diameter message, grouped AVPs included, in a single node
+ * array
+ *
+ * Nodes refer to each other by index (first child, next sibling) and their
+ * payloads are views into the buffer the tree was parsed from, so building a
+ * tree allocates nothing per AVP and reusing one tree across messages
+ * allocates nothing at all once its arrays have grown. A small open-addressed
+ * table maps (parent, code) to the first matching node; further occurrences
+ * are chained through next_same, so repeated AVPs such as
+ * Multiple-Services-Credit-Control are found without scanning.
+ *
+ * The wire format does not say which AVPs are grouped. parse() descends into
+ * an AVP when the supplied predicate says its code is grouped; flatten()
+ * follows the children already decoded into DiameterAVP objects.
+ *
+ * The tree does not own payload bytes: the parsed buffer (or the flattened
+ * AVPs) must outlive it.
+ */
+class DiameterAvpTree {
+public:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint32_t kRoot = UINT32_MAX - 1;  // Parent of top-level AVPs
+
+    /**
+     * Grouped AVP predicate: (code, vendor_id) -> payload is a list of AVPs
+     */
+    using GroupedPredicate = bool (*)(uint32_t code, uint32_t vendor_id);
+
+    struct Node {
+        uint32_t code = 0;
+        uint32_t vendor_id = 0;  // 0 when the V bit is clear
+        uint8_t flags = 0;       // Raw AVP flags (V, M, P)
+        bool grouped = false;
+        uint32_t length = 0;  // Payload length, header and padding excluded
+        const uint8_t* data = nullptr;
+        uint32_t parent = kRoot;
+        uint32_t first_child = kNil;
+        uint32_t next_sibling = kNil;
+        uint32_t next_same = kNil;  // Next sibling with the same code
+    };
+
+    /**
+     * Default predicate: the base protocol grouped AVPs known to
+     * DiameterAVPParser::getAVPDataType()
+     */
+    static bool isBaseGrouped(uint32_t code, uint32_t vendor_id);
+
+    /**
+     * Parse a complete Diameter message: header into @p header, AVPs into
+     * this tree
+     * @return false if the header is invalid or the message is truncated
+     */
+    bool parseMessage(const uint8_t* data, size_t length, DiameterHeader& header,
+                      GroupedPredicate grouped = &isBaseGrouped);
+
+    /**
+     * Parse a sequence of AVPs (a message body or a grouped AVP payload)
+     * @return false if an AVP is malformed; the AVPs before it are kept
+     */
+    bool parse(const uint8_t* data, size_t length, GroupedPredicate grouped = &isBaseGrouped);
+
+    /**
+     * Build the tree from already decoded AVPs (e.g. DiameterMessage::avps).
+     * Payload views point into the AVPs' data vectors.
+     */
+    void flatten(const std::vector<std::shared_ptr<DiameterAVP>>& avps);
+
+    void clear();
+
+    size_t size() const { return nodes_.size(); }
+    bool empty() const { return nodes_.empty(); }
+    const Node& node(uint32_t index) const { return nodes_[index]; }
+
+    /**
+     * First child of @p parent (kRoot for the top level), kNil if none
+     */
+    uint32_t firstChild(uint32_t parent = kRoot) const {
+        return parent == kRoot ? (nodes_.empty() ? kNil : 0) : nodes_[parent].first_child;
+    }
+    uint32_t nextSibling(uint32_t index) const { return nodes_[index].next_sibling; }
+
+    /**
+     * First child of @p parent with @p code, kNil if none. Later occurrences
+     * follow through nextSame().
+     */
+    uint32_t find(uint32_t code, uint32_t parent = kRoot) const;
+
+    /**
+     * First child of @p parent with @p code and @p vendor_id, kNil if none
+     */
+    uint32_t find(uint32_t code, uint32_t vendor_id, uint32_t parent) const;
+
+    uint32_t nextSame(uint32_t index) const { return nodes_[index].next_same; }
+
+    // Payload accessors, same conversions as the DiameterAVP getDataAs* methods
+
+    std::optional<uint32_t> getUint32(uint32_t index) const;
+    std::optional<uint64_t> getUint64(uint32_t index) const;
+    std::optional<int32_t> getInt32(uint32_t index) const;
+
+    /**
+     * Payload as text, empty if it contains control characters
+     */
+    std::string getString(uint32_t index) const;
+
+    std::string_view getView(uint32_t index) const {
+        return {reinterpret_cast<const char*>(nodes_[index].data), nodes_[index].length};
+    }
+
+    std::vector<uint8_t> getBytes(uint32_t index) const {
+        return {nodes_[index].data, nodes_[index].data + nodes_[index].length};
+    }
+
+private:
+    static constexpr uint32_t kMaxDepth = 16;
+
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t first = kNil;  // kNil marks an empty slot
+        uint32_t last = kNil;
+    };
+
+    bool parseLevel(const uint8_t* data, size_t length, uint32_t parent, uint32_t depth,
+                    GroupedPredicate grouped);
+    void flattenLevel(const std::vector<std::shared_ptr<DiameterAVP>>& avps, uint32_t parent,
+                      uint32_t depth);
+    uint32_t append(const Node& node, uint32_t& previous);
+    void buildIndex();
+
+    static uint64_t key(uint32_t parent, uint32_t code) {
+        return (static_cast<uint64_t>(parent) << 32) | code;
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<Slot> index_;
+    uint32_t index_mask_ = 0;
+};
+
+}  // namespace diameter
+}  // namespace callflow
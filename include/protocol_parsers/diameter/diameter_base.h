@@ -8,8 +8,9 @@
 namespace callflow {
 namespace diameter {
 
-// Forward declaration
+// Forward declarations
 struct DiameterAVP;
+class DiameterAvpTree;
 
 // ============================================================================
 // Diameter Header Structure (20 bytes, RFC 6733 Section 3)
@@ -125,6 +126,11 @@ struct DiameterAVP {
      */
     std::optional<std::vector<std::shared_ptr<DiameterAVP>>> getGroupedAVPs() const;
 
+    /**
+     * Grouped AVPs without copying the list, nullptr if this is not a grouped AVP
+     */
+    const std::vector<std::shared_ptr<DiameterAVP>>* groupedAVPs() const;
+
     /**
      * Get AVP name
      */
@@ -240,6 +246,11 @@ struct DiameterMessage {
      * Extract common fields from AVPs
      */
     void extractCommonFields();
+
+    /**
+     * Extract common fields from the top level of a parsed AVP tree
+     */
+    void extractCommonFields(const DiameterAvpTree& tree);
 };
 
 }  // namespace diameter
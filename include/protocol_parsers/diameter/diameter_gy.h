@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "common/types.h"
+#include "protocol_parsers/diameter/diameter_avp_tree.h"
 #include "protocol_parsers/diameter/diameter_base.h"
 #include "protocol_parsers/diameter/diameter_policy_types.h"
 
@@ -334,15 +335,37 @@ public:
      */
     std::optional<DiameterGyMessage> parse(const DiameterMessage& msg);
 
+    /**
+     * Parse Gy message directly from wire bytes
+     *
+     * AVPs are decoded into the parser's flat AVP tree, which is reused
+     * across calls, instead of DiameterAVP objects; base.avps of the result
+     * stays empty while the common base fields are filled in.
+     *
+     * Not on the pcap ingest path, which decodes Diameter through
+     * callflow::DiameterParser and never reaches this class.
+     * @return Parsed Gy message or nullopt if malformed or not Gy
+     */
+    std::optional<DiameterGyMessage> parse(const uint8_t* data, size_t length);
+
     /**
      * Check if message is Gy
      */
     static bool isGyMessage(const DiameterMessage& msg);
 
+    /**
+     * Grouped AVP predicate for DiameterAvpTree: Gy grouped AVPs plus the
+     * base protocol ones
+     */
+    static bool isGroupedAVP(uint32_t code, uint32_t vendor_id);
+
 private:
+    std::optional<DiameterGyMessage> parseTree(const DiameterMessage& msg,
+                                               const DiameterAvpTree& tree);
+
     // Message-specific parsers
-    GyCreditControlRequest parseCCR(const DiameterMessage& msg);
-    GyCreditControlAnswer parseCCA(const DiameterMessage& msg);
+    GyCreditControlRequest parseCCR(const DiameterAvpTree& tree);
+    GyCreditControlAnswer parseCCA(const DiameterMessage& msg, const DiameterAvpTree& tree);
 
     // AVP parsers
 public:
@@ -351,14 +374,26 @@ public:
     std::optional<ServiceUnit> parseServiceUnit(std::shared_ptr<DiameterAVP> avp);
 
 private:
-    std::optional<UsedServiceUnit> parseUsedServiceUnit(std::shared_ptr<DiameterAVP> avp);
-    std::optional<FinalUnitIndication> parseFinalUnitIndication(std::shared_ptr<DiameterAVP> avp);
-    std::optional<RedirectServer> parseRedirectServer(std::shared_ptr<DiameterAVP> avp);
-    std::optional<UserEquipmentInfo> parseUserEquipmentInfo(std::shared_ptr<DiameterAVP> avp);
-    std::optional<ServiceInformation> parseServiceInformation(std::shared_ptr<DiameterAVP> avp);
-    std::optional<PSInformation> parsePSInformation(std::shared_ptr<DiameterAVP> avp);
-    std::optional<IMSInformation> parseIMSInformation(std::shared_ptr<DiameterAVP> avp);
-    std::optional<CostInformation> parseCostInformation(std::shared_ptr<DiameterAVP> avp);
+    // Grouped AVP parsers over the flat tree, @p node is the grouped AVP's index
+    std::optional<MultipleServicesCreditControl> parseMSCC(const DiameterAvpTree& tree,
+                                                           uint32_t node);
+    std::optional<SubscriptionId> parseSubscriptionId(const DiameterAvpTree& tree, uint32_t node);
+    std::optional<ServiceUnit> parseServiceUnit(const DiameterAvpTree& tree, uint32_t node);
+    std::optional<UsedServiceUnit> parseUsedServiceUnit(const DiameterAvpTree& tree,
+                                                        uint32_t node);
+    std::optional<FinalUnitIndication> parseFinalUnitIndication(const DiameterAvpTree& tree,
+                                                                uint32_t node);
+    std::optional<RedirectServer> parseRedirectServer(const DiameterAvpTree& tree, uint32_t node);
+    std::optional<UserEquipmentInfo> parseUserEquipmentInfo(const DiameterAvpTree& tree,
+                                                            uint32_t node);
+    std::optional<ServiceInformation> parseServiceInformation(const DiameterAvpTree& tree,
+                                                              uint32_t node);
+    std::optional<PSInformation> parsePSInformation(const DiameterAvpTree& tree, uint32_t node);
+    std::optional<IMSInformation> parseIMSInformation(const DiameterAvpTree& tree, uint32_t node);
+    std::optional<CostInformation> parseCostInformation(const DiameterAvpTree& tree,
+                                                        uint32_t node);
+
+    DiameterAvpTree tree_;  // Reused for every message parsed by this instance
 };
 
 }  // namespace diameter
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace callflow {
+
+/**
+ * HPACK static Huffman code (RFC 7541 Appendix B)
+ *
+ * Decoding is table driven: the code tree's 256 internal nodes are the states
+ * of a finite automaton that consumes four bits per step, so a byte of input
+ * costs two table lookups instead of eight branchy tree steps. A four-bit step
+ * emits at most one symbol because the shortest code is five bits long.
+ */
+class HpackHuffman {
+public:
+    /**
+     * Append the decoding of @p len bytes at @p data to @p out
+     * @return false if the input contains EOS, or its padding is longer than
+     *         seven bits or not all ones (RFC 7541 Section 5.2); @p out then
+     *         holds the symbols decoded before the error
+     */
+    static bool decode(const uint8_t* data, size_t len, std::string& out);
+
+    /**
+     * Append the Huffman encoding of @p text to @p out, padded with ones
+     */
+    static void encode(std::string_view text, std::vector<uint8_t>& out);
+
+    /**
+     * Size of the Huffman encoding of @p text in bytes
+     */
+    static size_t encodedLength(std::string_view text);
+};
+
+}  // namespace callflow
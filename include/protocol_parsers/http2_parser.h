@@ -1,10 +1,11 @@
 #pragma once
 
-#include <deque>
 #include <map>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "common/types.h"
@@ -112,6 +113,18 @@ struct Http2Connection {
 
 /**
  * HPACK decoder (RFC 7541)
+ *
+ * The dynamic table keeps each entry's name and value back to back in one
+ * byte buffer, oldest entry first, with a ring of (offset, lengths)
+ * descriptors on top. Inserting appends at the buffer end and evicting only
+ * moves the start, so neither allocates once the buffer has grown to about
+ * twice the table size; when the end is reached the live bytes are moved
+ * back to the front.
+ *
+ * decode() into HeaderField views allocates nothing per header: literal
+ * strings are views into the header block, Huffman strings and dynamic table
+ * entries are copied into a scratch buffer the decoder reuses (a later
+ * insertion in the same block may evict or move the table entry).
  */
 class HpackDecoder {
 public:
@@ -120,6 +133,16 @@ public:
         std::string value;
     };
 
+    /**
+     * Decoded header field. The views point into the header block, the
+     * static table or the decoder; they stay valid while the block is and
+     * until the next decode() or reset().
+     */
+    struct HeaderField {
+        std::string_view name;
+        std::string_view value;
+    };
+
     HpackDecoder();
     ~HpackDecoder() = default;
 
@@ -127,10 +150,18 @@ public:
      * Decode HPACK-encoded header block
      * @param data Header block data
      * @param len Data length
-     * @return Decoded headers
+     * @return Decoded headers, up to the first malformed field
      */
     std::vector<DecodedHeader> decode(const uint8_t* data, size_t len);
 
+    /**
+     * Decode HPACK-encoded header block into views
+     * @param fields Replaced with the decoded fields
+     * @return false if the block is malformed (a decoding error is an HTTP/2
+     *         connection error); @p fields then holds the fields before it
+     */
+    bool decode(const uint8_t* data, size_t len, std::vector<HeaderField>& fields);
+
     /**
      * Set maximum dynamic table size
      */
@@ -141,69 +172,94 @@ public:
      */
     size_t getDynamicTableSize() const { return current_dynamic_table_size_; }
 
+    /**
+     * Get number of dynamic table entries
+     */
+    size_t getDynamicTableEntries() const { return entry_count_; }
+
     /**
      * Reset decoder state
      */
     void reset();
 
 private:
-    // Static table (RFC 7541 Appendix A)
-    static const std::vector<std::pair<std::string, std::string>> static_table_;
+    /**
+     * Dynamic table entry: name at offset, value right after it
+     */
+    struct DynamicEntry {
+        uint64_t offset = 0;  // Position in the stream of all inserted bytes
+        uint32_t name_len = 0;
+        uint32_t value_len = 0;
+    };
 
-    // Dynamic table
-    std::deque<std::pair<std::string, std::string>> dynamic_table_;
+    /**
+     * String decoded from the block: external bytes (block or static table)
+     * or, with data == nullptr, a range of scratch_
+     */
+    struct StringRef {
+        const char* data = nullptr;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Dynamic table: entries_[(entry_head_ + i) & mask] is index i, newest first
+    std::vector<DynamicEntry> entries_;
+    size_t entry_head_ = 0;
+    size_t entry_count_ = 0;
+    std::vector<char> bytes_;
+    uint64_t bytes_base_ = 0;  // Stream position of bytes_[0]
+    uint64_t bytes_end_ = 0;   // Stream position after the newest entry
     size_t max_dynamic_table_size_ = 4096;
     size_t current_dynamic_table_size_ = 0;
 
+    // Per-block scratch, reused across decode() calls
+    std::string scratch_;
+    std::vector<std::pair<StringRef, StringRef>> pending_;
+    std::vector<HeaderField> owned_fields_;
+
+    std::string_view view(const StringRef& ref) const {
+        return ref.data ? std::string_view(ref.data, ref.size)
+                        : std::string_view(scratch_.data() + ref.offset, ref.size);
+    }
+
     /**
-     * Get entry from static or dynamic table
+     * Look up a static or dynamic table entry
      * @param index Table index (1-based)
-     * @return Header name and value
+     * @param value Receives the value unless nullptr
+     * @return false if the index is out of range
      */
-    std::optional<std::pair<std::string, std::string>> getTableEntry(size_t index);
+    bool getTableEntry(uint64_t index, StringRef& name, StringRef* value);
 
     /**
-     * Add entry to dynamic table
+     * Copy a dynamic table string into scratch_
      */
-    void addToDynamicTable(const std::string& name, const std::string& value);
+    StringRef copyToScratch(uint64_t offset, size_t size);
 
     /**
-     * Evict entries from dynamic table to maintain size limit
+     * Add entry to dynamic table, evicting as needed (RFC 7541 Section 4.4)
      */
-    void evictDynamicTable();
+    void addToDynamicTable(std::string_view name, std::string_view value);
 
     /**
-     * Calculate entry size (RFC 7541 Section 4.1)
+     * Evict oldest entries until the table fits its maximum size
      */
-    size_t calculateEntrySize(const std::string& name, const std::string& value) const;
+    void evictDynamicTable(size_t incoming);
 
     /**
      * Decode integer from HPACK encoding (RFC 7541 Section 5.1)
      * @param data Data pointer (will be advanced)
      * @param prefix_bits Number of prefix bits
-     * @return Decoded integer
+     * @return false if truncated or too large for 64 bits
      */
-    uint64_t decodeInteger(const uint8_t*& data, const uint8_t* end, uint8_t prefix_bits);
+    static bool decodeInteger(const uint8_t*& data, const uint8_t* end, uint8_t prefix_bits,
+                              uint64_t& value);
 
     /**
      * Decode string from HPACK encoding (RFC 7541 Section 5.2)
      * @param data Data pointer (will be advanced)
-     * @return Decoded string
-     */
-    std::string decodeString(const uint8_t*& data, const uint8_t* end);
-
-    /**
-     * Decode Huffman-encoded string (RFC 7541 Appendix B)
-     * @param data Huffman-encoded data
-     * @param len Data length
-     * @return Decoded string
-     */
-    std::string decodeHuffman(const uint8_t* data, size_t len);
-
-    /**
-     * Initialize static table
+     * @return false if truncated or the Huffman code is invalid
      */
-    static std::vector<std::pair<std::string, std::string>> initStaticTable();
+    bool decodeString(const uint8_t*& data, const uint8_t* end, StringRef& out);
 };
 
 /**
@@ -260,6 +316,7 @@ public:
 
 private:
     HpackDecoder hpack_decoder_;
+    std::vector<HpackDecoder::HeaderField> header_fields_;
 
     /**
      * Parse frame header (9 bytes)
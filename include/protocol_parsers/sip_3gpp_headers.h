@@ -3,6 +3,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
@@ -21,7 +22,7 @@ struct SipPAssertedIdentity {
      * Parse P-Asserted-Identity header value
      * Can contain multiple identities separated by commas
      */
-    static std::optional<std::vector<SipPAssertedIdentity>> parse(const std::string& value);
+    static std::optional<std::vector<SipPAssertedIdentity>> parse(std::string_view value);
 };
 
 /**
@@ -50,7 +51,7 @@ struct SipPAccessNetworkInfo {
      * Example: "3GPP-E-UTRAN-FDD; utran-cell-id-3gpp=234150999999999"
      * Example: "3GPP-NR; nrcgi=001010000000001"
      */
-    static std::optional<SipPAccessNetworkInfo> parse(const std::string& value);
+    static std::optional<SipPAccessNetworkInfo> parse(std::string_view value);
 
     /**
      * Convert AccessType enum to string
@@ -73,7 +74,7 @@ struct SipPChargingVector {
      * Parse P-Charging-Vector header value
      * Format: "icid-value=AyretyU0dm+6O2IrT5tAFrbHLso=; icid-generated-at=192.0.2.1; orig-ioi=home1.net"
      */
-    static std::optional<SipPChargingVector> parse(const std::string& value);
+    static std::optional<SipPChargingVector> parse(std::string_view value);
 };
 
 /**
@@ -88,7 +89,7 @@ struct SipPChargingFunctionAddresses {
      * Parse P-Charging-Function-Addresses header value
      * Format: "ccf=192.0.2.10; ccf=192.0.2.11; ecf=192.0.2.20"
      */
-    static std::optional<SipPChargingFunctionAddresses> parse(const std::string& value);
+    static std::optional<SipPChargingFunctionAddresses> parse(std::string_view value);
 };
 
 /**
@@ -104,7 +105,7 @@ struct SipPServedUser {
      * Parse P-Served-User header value
      * Format: "<sip:user@example.com>; sescase=orig; regstate=reg"
      */
-    static std::optional<SipPServedUser> parse(const std::string& value);
+    static std::optional<SipPServedUser> parse(std::string_view value);
 };
 
 /**
@@ -124,7 +125,7 @@ struct SipSecurityInfo {
      * Parse Security-Client/Server/Verify header value
      * Format: "ipsec-3gpp; alg=hmac-sha-1-96; spi-c=1234; spi-s=5678; port-c=5062; port-s=5064"
      */
-    static std::optional<SipSecurityInfo> parse(const std::string& value);
+    static std::optional<SipSecurityInfo> parse(std::string_view value);
 };
 
 /**
@@ -139,7 +140,7 @@ struct SipSessionExpires {
      * Parse Session-Expires header value
      * Format: "1800; refresher=uac"
      */
-    static std::optional<SipSessionExpires> parse(const std::string& value);
+    static std::optional<SipSessionExpires> parse(std::string_view value);
 };
 
 /**
@@ -177,13 +178,13 @@ struct SipSdpQosPrecondition {
      * Parse current QoS precondition
      * Format: "a=curr:qos local sendrecv"
      */
-    static std::optional<SipSdpQosPrecondition> parseCurrent(const std::string& value);
+    static std::optional<SipSdpQosPrecondition> parseCurrent(std::string_view value);
 
     /**
      * Parse desired QoS precondition
      * Format: "a=des:qos mandatory local sendrecv"
      */
-    static std::optional<SipSdpQosPrecondition> parseDesired(const std::string& value);
+    static std::optional<SipSdpQosPrecondition> parseDesired(std::string_view value);
 
     /**
      * Convert enums to strings
@@ -206,7 +207,7 @@ struct SipSdpBandwidth {
      * Parse bandwidth line
      * Format: "b=AS:64" or "b=TIAS:64000"
      */
-    static void parseLine(const std::string& line, SipSdpBandwidth& bandwidth);
+    static void parseLine(std::string_view line, SipSdpBandwidth& bandwidth);
 };
 
 /**
@@ -223,13 +224,13 @@ struct SipSdpCodec {
      * Parse rtpmap attribute
      * Format: "a=rtpmap:97 AMR/8000/1"
      */
-    static std::optional<SipSdpCodec> parseRtpmap(const std::string& value);
+    static std::optional<SipSdpCodec> parseRtpmap(std::string_view value);
 
     /**
      * Parse fmtp attribute into existing codec
      * Format: "a=fmtp:97 mode-set=0,2,4,7; mode-change-period=2"
      */
-    void parseFmtp(const std::string& value);
+    void parseFmtp(std::string_view value);
 };
 
 /**
@@ -247,7 +248,7 @@ struct SipPrivacy {
      * Parse Privacy header value
      * Format: "Privacy: id; header; user"
      */
-    static SipPrivacy parse(const std::string& value);
+    static SipPrivacy parse(std::string_view value);
 };
 
 /**
@@ -270,7 +271,7 @@ struct SipSubscriptionState {
      * Parse Subscription-State header value
      * Format: "active;expires=3600" or "terminated;reason=timeout"
      */
-    static std::optional<SipSubscriptionState> parse(const std::string& value);
+    static std::optional<SipSubscriptionState> parse(std::string_view value);
 
     static std::string stateToString(State s);
 };
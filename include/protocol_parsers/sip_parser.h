@@ -4,10 +4,12 @@
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "common/types.h"
 #include "protocol_parsers/sip_3gpp_headers.h"
+#include "protocol_parsers/sip_tokenizer.h"
 
 namespace callflow {
 
@@ -16,14 +18,14 @@ namespace callflow {
  */
 struct SipMessage {
     // Request or response
-    bool is_request;
+    bool is_request = false;
 
     // Request line
     std::string method;  // INVITE, ACK, BYE, etc.
     std::string request_uri;
 
     // Status line
-    int status_code;
+    int status_code = 0;
     std::string reason_phrase;
 
     // Timestamp
@@ -149,6 +151,9 @@ struct SipMessage {
 
 /**
  * SIP protocol parser
+ *
+ * Tokenizes the payload in place (see sip::MessageTokenizer) and copies out
+ * only the fields stored in SipMessage.
  */
 class SipParser {
 public:
@@ -182,27 +187,9 @@ public:
     static void registerFields();
 
 private:
-    bool parseRequestLine(const std::string& line, SipMessage& msg);
-    bool parseStatusLine(const std::string& line, SipMessage& msg);
-    void parseHeaders(const std::vector<std::string>& lines, SipMessage& msg);
-    void parseSdp(const std::string& body, SipMessage& msg);
-
-    // NEW: 3GPP P-header parsing
-    void parsePHeaders(SipMessage& msg);
-    void parseImsHeaders(SipMessage& msg);
-    void parseSecurityHeaders(SipMessage& msg);
-    void parseRoutingHeaders(SipMessage& msg);
-
-    // NEW: Enhanced SDP parsing for IMS
-    void parseSdpQosPreconditions(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines);
-    void parseSdpBandwidth(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines);
-    void parseSdpCodecs(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines);
-    void parseSdpMediaDirection(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines);
-
-    std::vector<std::string> splitLines(const std::string& text);
-    std::pair<std::string, std::string> parseHeader(const std::string& line);
-    static std::string trim(const std::string& str);
-    static std::vector<std::string> splitCommaList(const std::string& str);
+    void parseHeader(const sip::HeaderField& field, SipMessage& msg);
+    void parseSdp(std::string_view body, SipMessage& msg);
+    void parseSdpAttribute(std::string_view attribute, SipMessage::SdpInfo& sdp);
 };
 
 }  // namespace callflow
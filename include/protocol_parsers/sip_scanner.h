@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace callflow {
+namespace sip {
+
+/**
+ * Instruction set used by the stream scanners
+ *
+ * The best one the CPU supports is picked at startup (AVX2 > SSE2 >
+ * scalar); SSE2 is always available on x86-64, other architectures use
+ * the scalar code. The explicit-ISA overloads exist for tests and
+ * benchmarks; they fall back to the best supported ISA when asked for
+ * one the CPU lacks.
+ */
+enum class ScanIsa : uint8_t { SCALAR, SSE2, AVX2 };
+
+ScanIsa activeScanIsa();
+const char* scanIsaName(ScanIsa isa);
+
+constexpr size_t kNoMatch = static_cast<size_t>(-1);
+
+/**
+ * Length of the header block, i.e. the offset just past the first
+ * "\r\n\r\n", or 0 if the headers are incomplete
+ */
+size_t findHeaderEnd(const uint8_t* data, size_t len);
+size_t findHeaderEnd(const uint8_t* data, size_t len, ScanIsa isa);
+
+/**
+ * Offset of the value (just past the colon) of the first header line named
+ * name (case-insensitive) or, if compact is non-zero, its compact form;
+ * kNoMatch if there is none. Only line starts are considered, so "tel:"
+ * inside a URI never matches the compact "l".
+ */
+size_t findHeaderValue(const uint8_t* headers, size_t len, std::string_view name, char compact);
+size_t findHeaderValue(const uint8_t* headers, size_t len, std::string_view name, char compact,
+                       ScanIsa isa);
+
+/**
+ * Content-Length (or "l") of a header block; 0 if absent or malformed
+ */
+size_t findContentLength(const uint8_t* headers, size_t len);
+size_t findContentLength(const uint8_t* headers, size_t len, ScanIsa isa);
+
+/**
+ * Length of the complete SIP message at the start of data (headers plus
+ * Content-Length body), or 0 if more bytes are needed
+ */
+size_t completeMessageLength(const uint8_t* data, size_t len);
+size_t completeMessageLength(const uint8_t* data, size_t len, ScanIsa isa);
+
+}  // namespace sip
+}  // namespace callflow
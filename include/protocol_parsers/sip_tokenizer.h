@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace callflow {
+namespace sip {
+
+/**
+ * Headers the SIP parser handles explicitly
+ *
+ * Lookup is case-insensitive and maps compact forms (RFC 3261 section 7.3.3
+ * and extensions: i, f, t, v, m, c, l, k, o, r, b, x) onto the same id.
+ */
+enum class HeaderId : uint8_t {
+    UNKNOWN,
+    CALL_ID,
+    FROM,
+    TO,
+    VIA,
+    CONTACT,
+    CSEQ,
+    CONTENT_TYPE,
+    CONTENT_LENGTH,
+    AUTHORIZATION,
+    REASON,
+    DIVERSION,
+    HISTORY_INFO,
+    RSEQ,
+    RACK,
+    P_ASSERTED_IDENTITY,
+    P_ACCESS_NETWORK_INFO,
+    P_VISITED_NETWORK_ID,
+    P_CHARGING_VECTOR,
+    P_CHARGING_FUNCTION_ADDRESSES,
+    P_SERVED_USER,
+    P_PREFERRED_IDENTITY,
+    P_EARLY_MEDIA,
+    P_ASSOCIATED_URI,
+    SESSION_EXPIRES,
+    MIN_SE,
+    REQUIRE,
+    SUPPORTED,
+    ALLOW,
+    PRIVACY,
+    GEOLOCATION,
+    GEOLOCATION_ROUTING,
+    GEOLOCATION_ERROR,
+    REFER_TO,
+    REFERRED_BY,
+    REPLACES,
+    EVENT,
+    SUBSCRIPTION_STATE,
+    SECURITY_CLIENT,
+    SECURITY_SERVER,
+    SECURITY_VERIFY,
+    PATH,
+    SERVICE_ROUTE,
+    RECORD_ROUTE,
+    ROUTE
+};
+
+/**
+ * Map a header name (full or compact, any case) to its id
+ */
+HeaderId lookupHeader(std::string_view name);
+
+/**
+ * Request or status line, as views into the message
+ */
+struct StartLine {
+    bool is_request = false;
+    std::string_view method;       // Requests only
+    std::string_view request_uri;  // Requests only
+    int status_code = 0;           // Responses only
+    std::string_view reason;       // Responses only
+};
+
+/**
+ * One header field; value is trimmed and, when folded, still spans the
+ * continuation lines (see unfold())
+ */
+struct HeaderField {
+    HeaderId id = HeaderId::UNKNOWN;
+    std::string_view name;
+    std::string_view value;
+    bool folded = false;
+};
+
+/**
+ * Iterates the lines of a text, stripping LF / CRLF terminators
+ */
+class LineTokenizer {
+public:
+    explicit LineTokenizer(std::string_view text) : text_(text) {}
+
+    /**
+     * Next line without its terminator; false at end of text
+     */
+    bool next(std::string_view& line);
+
+    /**
+     * Unconsumed remainder of the text
+     */
+    std::string_view rest() const { return text_.substr(pos_); }
+
+    /**
+     * True if the next line starts with a space or tab (header continuation)
+     */
+    bool atContinuation() const {
+        return pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t');
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+/**
+ * Single-pass tokenizer over a SIP message held in caller-owned memory
+ *
+ * Nothing is copied: the start line, header fields and body are views into
+ * the original buffer, which must outlive them. Call startLine() once, then
+ * nextHeader() until it returns false; body() is available after that.
+ */
+class MessageTokenizer {
+public:
+    explicit MessageTokenizer(std::string_view message) : lines_(message) {}
+
+    /**
+     * Parse the request or status line; false if it is not SIP/2.0
+     */
+    bool startLine(StartLine& line);
+
+    /**
+     * Next header field; false at the blank line ending the headers or at
+     * end of message. Lines without a colon are skipped.
+     */
+    bool nextHeader(HeaderField& field);
+
+    /**
+     * True if a blank line was seen and content follows it
+     */
+    bool hasBody() const { return in_body_ && !lines_.rest().empty(); }
+
+    /**
+     * Everything after the blank line (empty if there is none)
+     */
+    std::string_view body() const { return in_body_ ? lines_.rest() : std::string_view(); }
+
+private:
+    LineTokenizer lines_;
+    bool in_body_ = false;
+};
+
+// ----------------------------------------------------------------------------
+// string_view helpers shared by the SIP/SDP parsers
+// ----------------------------------------------------------------------------
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline std::string_view trim(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/**
+ * Split off everything up to the next separator (not trimmed) and advance
+ * rest past it; rest becomes empty after the last item
+ */
+inline std::string_view splitNext(std::string_view& rest, char separator) {
+    size_t pos = rest.find(separator);
+    std::string_view item = rest.substr(0, pos);
+    rest = pos == std::string_view::npos ? std::string_view() : rest.substr(pos + 1);
+    return item;
+}
+
+/**
+ * Next space/tab separated word, or empty when none is left
+ */
+inline std::string_view nextWord(std::string_view& rest) {
+    size_t start = rest.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        rest = std::string_view();
+        return rest;
+    }
+    size_t end = rest.find_first_of(" \t", start);
+    std::string_view word = rest.substr(start, end - start);
+    rest = end == std::string_view::npos ? std::string_view() : rest.substr(end);
+    return word;
+}
+
+bool iequals(std::string_view a, std::string_view b);
+
+/**
+ * Case-insensitive substring test
+ */
+bool containsNoCase(std::string_view text, std::string_view needle);
+
+/**
+ * Leading decimal digits of text (after whitespace) as an unsigned value;
+ * false if there are none or they overflow
+ */
+bool parseUint(std::string_view text, uint32_t& value);
+
+/**
+ * Value of the "name=" parameter in a header value, up to the next ';',
+ * space or line end; name must start the value or follow ';' / whitespace
+ */
+std::string_view headerParameter(std::string_view value, std::string_view name);
+
+/**
+ * User part of the first "sip:user@host" in text, or empty
+ */
+std::string_view uriUser(std::string_view text);
+
+/**
+ * Host part of the first "sip:user@host" in text (without port or
+ * parameters), or empty
+ */
+std::string_view uriHost(std::string_view text);
+
+/**
+ * Copy of a folded header value with each line break and the whitespace
+ * around it collapsed to a single space
+ */
+std::string unfold(std::string_view value);
+
+/**
+ * Copy of text with CRLF / LF line ends normalized to LF and a final LF
+ * appended if missing
+ */
+std::string normalizeLineEndings(std::string_view text);
+
+}  // namespace sip
+}  // namespace callflow
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace callflow {
+
+/**
+ * Dense session number assigned by EnhancedSessionCorrelator
+ *
+ * Handles index the correlator's session table and are never reused, so an
+ * index entry that outlives its session can be recognised as stale.
+ */
+using SessionHandle = uint32_t;
+
+/**
+ * Small set of session handles stored under one index key
+ *
+ * Nearly every key maps to a single session, so the first kInline handles
+ * are stored in place and only larger sets spill to the heap.
+ */
+class SessionHandleList {
+public:
+    static constexpr uint32_t kInline = 2;
+
+    SessionHandleList() = default;
+    ~SessionHandleList() { release(); }
+
+    SessionHandleList(SessionHandleList&& other) noexcept { take(other); }
+    SessionHandleList& operator=(SessionHandleList&& other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+    SessionHandleList(const SessionHandleList&) = delete;
+    SessionHandleList& operator=(const SessionHandleList&) = delete;
+
+    const SessionHandle* begin() const { return data(); }
+    const SessionHandle* end() const { return data() + size_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    bool contains(SessionHandle handle) const {
+        return std::find(begin(), end(), handle) != end();
+    }
+
+    /**
+     * Add a handle unless it is already present
+     */
+    void add(SessionHandle handle) {
+        if (contains(handle)) {
+            return;
+        }
+        if (size_ == capacity_) {
+            grow();
+        }
+        data()[size_++] = handle;
+    }
+
+    /**
+     * Remove every handle matching the predicate, keeping the others in order
+     */
+    template <typename Pred>
+    void removeIf(Pred pred) {
+        SessionHandle* first = data();
+        size_ = static_cast<uint32_t>(std::remove_if(first, first + size_, pred) - first);
+    }
+
+    void remove(SessionHandle handle) {
+        removeIf([handle](SessionHandle h) { return h == handle; });
+    }
+
+    /**
+     * Heap bytes owned by the list (zero while the handles fit inline)
+     */
+    size_t heapBytes() const { return onHeap() ? capacity_ * sizeof(SessionHandle) : 0; }
+
+private:
+    bool onHeap() const { return capacity_ > kInline; }
+    SessionHandle* data() { return onHeap() ? heap_ : inline_; }
+    const SessionHandle* data() const { return onHeap() ? heap_ : inline_; }
+
+    void grow() {
+        uint32_t new_capacity = capacity_ * 2;
+        auto* bigger = new SessionHandle[new_capacity];
+        std::copy(begin(), end(), bigger);
+        release();
+        heap_ = bigger;
+        capacity_ = new_capacity;
+    }
+
+    void release() {
+        if (onHeap()) {
+            delete[] heap_;
+            capacity_ = kInline;
+        }
+    }
+
+    void take(SessionHandleList& other) {
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        if (other.onHeap()) {
+            heap_ = other.heap_;
+        } else {
+            std::copy(other.inline_, other.inline_ + kInline, inline_);
+        }
+        other.size_ = 0;
+        other.capacity_ = kInline;
+    }
+
+    // 16 bytes: the handles live in place until a third one arrives
+    uint32_t size_ = 0;
+    uint32_t capacity_ = kInline;
+    union {
+        SessionHandle inline_[kInline] = {};
+        SessionHandle* heap_;
+    };
+};
+
+namespace flat_index_detail {
+
+// Finalizer from splitmix64; spreads sequential TEIDs/SEIDs across the table
+inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+template <typename Key>
+struct Hash {
+    uint64_t operator()(const Key& key) const { return mix(static_cast<uint64_t>(key)); }
+};
+
+template <>
+struct Hash<std::string> {
+    uint64_t operator()(std::string_view key) const {
+        return mix(std::hash<std::string_view>{}(key));
+    }
+};
+
+}  // namespace flat_index_detail
+
+/**
+ * Open-addressing index from a correlation key to session handles
+ *
+ * Linear probing over a power-of-two table. A parallel array of 32-bit hash
+ * tags is scanned first, so a probe touches one dense cache line per 16
+ * slots and only compares keys when the tags match; a zero tag marks an
+ * empty slot. Deletion uses backward shifting, so no tombstones build up
+ * as sessions merge. The table grows at 75% load.
+ */
+template <typename Key, typename Hash = flat_index_detail::Hash<Key>>
+class FlatSessionIndex {
+public:
+    FlatSessionIndex() = default;
+    FlatSessionIndex(const FlatSessionIndex&) = delete;
+    FlatSessionIndex& operator=(const FlatSessionIndex&) = delete;
+
+    /**
+     * @return Handles stored under the key, or nullptr if the key is absent
+     */
+    const SessionHandleList* find(const Key& key) const {
+        size_t slot = findSlot(key, tagOf(Hash{}(key)));
+        return slot == npos ? nullptr : &slots_[slot].handles;
+    }
+
+    SessionHandleList* find(const Key& key) {
+        size_t slot = findSlot(key, tagOf(Hash{}(key)));
+        return slot == npos ? nullptr : &slots_[slot].handles;
+    }
+
+    /**
+     * Add a handle under the key (no-op if it is already there)
+     */
+    void insert(const Key& key, SessionHandle handle) {
+        uint32_t tag = tagOf(Hash{}(key));
+        size_t slot = findSlot(key, tag);
+        if (slot == npos) {
+            if ((size_ + 1) * 4 > tags_.size() * 3) {
+                rehash(tags_.empty() ? kMinCapacity : tags_.size() * 2);
+            }
+            slot = emptySlotFor(tag);
+            tags_[slot] = tag;
+            slots_[slot].key = key;
+            ++size_;
+        }
+        slots_[slot].handles.add(handle);
+    }
+
+    /**
+     * Remove one handle from the key, dropping the key once it has none left
+     */
+    void remove(const Key& key, SessionHandle handle) {
+        size_t slot = findSlot(key, tagOf(Hash{}(key)));
+        if (slot == npos) {
+            return;
+        }
+        slots_[slot].handles.remove(handle);
+        if (slots_[slot].handles.empty()) {
+            eraseSlot(slot);
+        }
+    }
+
+    void erase(const Key& key) {
+        size_t slot = findSlot(key, tagOf(Hash{}(key)));
+        if (slot != npos) {
+            eraseSlot(slot);
+        }
+    }
+
+    /**
+     * Size the table for the given number of keys up front
+     */
+    void reserve(size_t keys) {
+        size_t capacity = kMinCapacity;
+        while (capacity * 3 < keys * 4) {
+            capacity *= 2;
+        }
+        if (capacity > tags_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void clear() {
+        tags_.clear();
+        slots_.clear();
+        tags_.shrink_to_fit();
+        slots_.shrink_to_fit();
+        mask_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return tags_.size(); }
+
+private:
+    struct Slot {
+        Key key{};
+        SessionHandleList handles;
+    };
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t kMinCapacity = 16;
+
+    // Low hash bits pick the home slot; the top bit keeps a live tag non-zero
+    static uint32_t tagOf(uint64_t hash) { return static_cast<uint32_t>(hash) | 0x80000000u; }
+
+    size_t findSlot(const Key& key, uint32_t tag) const {
+        if (size_ == 0) {
+            return npos;
+        }
+        for (size_t i = tag & mask_;; i = (i + 1) & mask_) {
+            uint32_t current = tags_[i];
+            if (current == 0) {
+                return npos;
+            }
+            if (current == tag && slots_[i].key == key) {
+                return i;
+            }
+        }
+    }
+
+    size_t emptySlotFor(uint32_t tag) const {
+        size_t i = tag & mask_;
+        while (tags_[i] != 0) {
+            i = (i + 1) & mask_;
+        }
+        return i;
+    }
+
+    void rehash(size_t new_capacity) {
+        std::vector<uint32_t> old_tags = std::move(tags_);
+        std::vector<Slot> old_slots = std::move(slots_);
+        tags_.assign(new_capacity, 0);
+        slots_ = std::vector<Slot>(new_capacity);
+        mask_ = new_capacity - 1;
+
+        for (size_t i = 0; i < old_tags.size(); ++i) {
+            if (old_tags[i] != 0) {
+                size_t slot = emptySlotFor(old_tags[i]);
+                tags_[slot] = old_tags[i];
+                slots_[slot] = std::move(old_slots[i]);
+            }
+        }
+    }
+
+    // Backward-shift deletion: pull later members of the probe run into the
+    // hole until an empty slot or an entry already at its home slot is reached
+    void eraseSlot(size_t hole) {
+        for (size_t next = (hole + 1) & mask_; tags_[next] != 0; next = (next + 1) & mask_) {
+            size_t home = tags_[next] & mask_;
+            if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                tags_[hole] = tags_[next];
+                slots_[hole] = std::move(slots_[next]);
+                hole = next;
+            }
+        }
+        tags_[hole] = 0;
+        slots_[hole] = Slot{};
+        --size_;
+    }
+
+    std::vector<uint32_t> tags_;
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+};
+
+}  // namespace callflow
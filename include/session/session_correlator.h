@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
@@ -11,6 +13,7 @@
 #include "correlation/sip_session_manager.h"
 #include "correlation/sip/sip_message.h"
 #include "protocol_parsers/sip_parser.h"
+#include "session/flat_session_index.h"
 #include "session/session_types.h"
 
 namespace callflow {
@@ -31,6 +34,13 @@ namespace callflow {
 class EnhancedSessionCorrelator {
 public:
     EnhancedSessionCorrelator();
+
+    /**
+     * Correlator whose session storage (sessions, legs, message records)
+     * is allocated from the given resource, typically a per-job JobArena
+     * that must outlive the correlator
+     */
+    explicit EnhancedSessionCorrelator(std::pmr::memory_resource* resource);
     ~EnhancedSessionCorrelator() = default;
 
     /**
@@ -198,6 +208,12 @@ public:
      */
     nlohmann::json exportAllSessions() const;
 
+    /**
+     * Visit the SIP-only sessions one at a time, in the format of
+     * exportAllSessions()["sip_only"], without building the whole array
+     */
+    void forEachSipOnlySession(const std::function<void(const nlohmann::json&)>& callback) const;
+
     /**
      * Process a packet and correlate it to a session
      */
@@ -222,18 +238,23 @@ public:
 
 private:
     // Session storage
-    std::unordered_map<std::string, Session> sessions_;  // session_id -> Session
-
-    // Correlation    // indices for O(1) lookups
-    std::unordered_map<std::string, std::vector<std::string>> imsi_index_;
-    std::unordered_map<std::string, std::vector<std::string>> supi_index_;
-    std::unordered_map<uint32_t, std::vector<std::string>> teid_index_;
-    std::unordered_map<uint64_t, std::vector<std::string>> seid_index_;
-    std::unordered_map<std::string, std::vector<std::string>> ue_ip_index_;
-    std::unordered_map<uint32_t, std::vector<std::string>> mme_ue_id_index_;
-    std::unordered_map<uint64_t, std::vector<std::string>> amf_ue_id_index_;
-    std::unordered_map<std::string, std::vector<std::string>> msisdn_index_;
-    std::unordered_map<std::string, std::vector<std::string>> icid_index_;
+    std::pmr::memory_resource* resource_;
+    std::pmr::unordered_map<std::string, Session> sessions_;  // session_id -> Session
+
+    // Dense session handles used by the indexes: handle -> session in sessions_,
+    // or nullptr once that session has been merged into another one
+    std::vector<Session*> session_handles_;
+
+    // Correlation indexes: key -> handles of the sessions carrying that key
+    FlatSessionIndex<std::string> imsi_index_;
+    FlatSessionIndex<std::string> supi_index_;
+    FlatSessionIndex<uint32_t> teid_index_;
+    FlatSessionIndex<uint64_t> seid_index_;
+    FlatSessionIndex<std::string> ue_ip_index_;
+    FlatSessionIndex<uint32_t> mme_ue_id_index_;
+    FlatSessionIndex<uint64_t> amf_ue_id_index_;
+    FlatSessionIndex<std::string> msisdn_index_;
+    FlatSessionIndex<std::string> icid_index_;
 
     // Community Correlation Maps
     std::unordered_map<std::string, std::string>
@@ -252,21 +273,24 @@ private:
     mutable std::recursive_mutex mutex_;
 
     // Helper to update indices when adding a message
-    void updateIndices(const std::string& session_id, const SessionCorrelationKey& key);
+    void updateIndices(SessionHandle handle, const SessionCorrelationKey& key);
+
+    // Copy out the live sessions behind an index entry
+    std::vector<Session> collectSessions(const SessionHandleList* handles) const;
 
     // Helper to update Master Session (Community Correlation)
     void updateMasterSession(const std::string& session_id, const SessionMessageRef& msg);
 
     // Private helpers
     std::optional<std::string> findMatchingSession(const SessionCorrelationKey& key) const;
-    std::string createNewSession(const SessionMessageRef& msg);
+    SessionHandle createNewSession(const SessionMessageRef& msg);
     /**
      * Add message to an existing session
      *
-     * @param session_id Session to add message to
+     * @param handle Session to add message to
      * @param msg Message to add
      */
-    void addMessageToSession(const std::string& session_id, const SessionMessageRef& msg);
+    void addMessageToSession(SessionHandle handle, const SessionMessageRef& msg);
 
     /**
      * Detect session type based on message sequence
@@ -303,10 +327,10 @@ private:
      * Merge two sessions if they are determined to be the same
      * This can happen when correlation keys are discovered later
      *
-     * @param session_id1 First session ID
-     * @param session_id2 Second session ID
+     * @param handle1 Session that absorbs the other one
+     * @param handle2 Session merged into handle1 and removed
      */
-    void mergeSessions(const std::string& session_id1, const std::string& session_id2);
+    void mergeSessions(SessionHandle handle1, SessionHandle handle2);
 
     /**
      * Extract correlation key from various protocol message types
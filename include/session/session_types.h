@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
@@ -168,39 +169,93 @@ struct SessionCorrelationKey {
 /**
  * Session Message Reference
  * Links a protocol message to a session
+ *
+ * This is the expanded form handed to correlators, state machines and
+ * exporters. Sessions store messages as StoredMessage records and rebuild
+ * a SessionMessageRef on demand (see SessionLeg::expand()).
  */
 struct SessionMessageRef {
-    std::string message_id;                 // Unique message ID (from database)
-    PacketId packet_id;                     // Packet ID
-    Timestamp timestamp;                    // Message timestamp
-    InterfaceType interface;                // Interface where message was captured
-    ProtocolType protocol;                  // Protocol type
-    MessageType message_type;               // Specific message type
-    SessionCorrelationKey correlation_key;  // Extracted correlation keys
-    uint32_t sequence_in_session;           // Sequence number within session
-    uint32_t payload_length;                // Length of payload (for byte counts)
-    nlohmann::json parsed_data;             // Parsed protocol data for state machines
+    std::string message_id;                            // Unique message ID (from database)
+    PacketId packet_id = 0;                            // Packet ID (see packetIdToString())
+    Timestamp timestamp;                               // Message timestamp
+    InterfaceType interface = InterfaceType::UNKNOWN;  // Interface where message was captured
+    ProtocolType protocol = ProtocolType::UNKNOWN;     // Protocol type
+    MessageType message_type = MessageType::UNKNOWN;   // Specific message type
+    SessionCorrelationKey correlation_key;             // Extracted correlation keys
+    uint32_t sequence_in_session = 0;                  // Sequence number within session
+    uint32_t payload_length = 0;                       // Length of payload (for byte counts)
+    nlohmann::json parsed_data;                        // Parsed protocol data for state machines
 
     // 5-tuple info for UI display
     std::string src_ip;
     std::string dst_ip;
-    uint16_t src_port;
-    uint16_t dst_port;
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
 
     nlohmann::json toJson() const;
 };
 
+/**
+ * Compact record of a message stored in a SessionLeg
+ *
+ * Fixed-size fields are kept typed (binary IPs, enums, counters); the
+ * variable-length parts (message id, non-empty correlation key fields and
+ * parsed data as MessagePack) are appended to the owning leg's blob arena
+ * and referenced by offset. JSON is only built again when the message is
+ * expanded for export or a state machine.
+ */
+struct StoredMessage {
+    PacketId packet_id = 0;
+    Timestamp timestamp;
+    IpAddress src_ip;  // Unset when the address text does not round-trip (kept in the blob)
+    IpAddress dst_ip;
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
+    InterfaceType interface = InterfaceType::UNKNOWN;
+    ProtocolType protocol = ProtocolType::UNKNOWN;
+    MessageType message_type = MessageType::UNKNOWN;
+    uint32_t sequence_in_session = 0;
+    uint32_t payload_length = 0;
+    uint32_t blob_offset = 0;  // Variable-length fields in SessionLeg::blobs
+    uint32_t blob_length = 0;
+};
+
 /**
  * Session Leg
  * Represents a sequence of messages on a single interface
  */
 struct SessionLeg {
     InterfaceType interface;
-    std::vector<SessionMessageRef> messages;
+    std::pmr::vector<StoredMessage> messages;  // Compact records, see StoredMessage
+    std::pmr::string blobs;                    // Arena for the records' variable-length fields
     Timestamp start_time;
     Timestamp end_time;
     uint64_t total_bytes;
 
+    SessionLeg() = default;
+
+    /**
+     * Leg whose message storage is allocated from the given resource
+     * (e.g. a JobArena); copies use the default resource
+     */
+    explicit SessionLeg(std::pmr::memory_resource* resource)
+        : messages(resource), blobs(resource) {}
+
+    /**
+     * Store a message as a compact record
+     */
+    void append(const SessionMessageRef& msg);
+
+    /**
+     * Rebuild the full message from one of this leg's records
+     */
+    SessionMessageRef expand(const StoredMessage& record) const;
+
+    /**
+     * Expand all messages in stored order
+     */
+    std::vector<SessionMessageRef> expandAll() const;
+
     nlohmann::json toJson() const;
 
     /**
@@ -219,7 +274,7 @@ struct Session {
     SessionCorrelationKey correlation_key;                  // Primary correlation key
     Timestamp start_time;                                   // Session start time
     Timestamp end_time;                                     // Session end time
-    std::vector<SessionLeg> legs;                           // Messages grouped by interface
+    std::pmr::vector<SessionLeg> legs;                      // Messages grouped by interface
     std::vector<InterfaceType> interfaces_involved;         // All interfaces involved
     std::unordered_map<std::string, std::string> metadata;  // Additional metadata
 
@@ -229,6 +284,14 @@ struct Session {
     std::optional<uint32_t> setup_time_ms;  // Time to establish session
     bool is_complete;                       // Whether session has proper start/end
 
+    Session() = default;
+
+    /**
+     * Session whose legs and message storage are allocated from the given
+     * resource (e.g. a JobArena); copies use the default resource
+     */
+    explicit Session(std::pmr::memory_resource* resource) : legs(resource) {}
+
     nlohmann::json toJson() const;
 
     /**
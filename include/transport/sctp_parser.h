@@ -4,8 +4,7 @@
 #include "common/types.h"
 #include <optional>
 #include <vector>
-#include <map>
-#include <functional>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 namespace callflow {
@@ -248,11 +247,6 @@ struct SctpPacket {
     nlohmann::json toJson() const;
 };
 
-/**
- * Callback for complete reassembled messages
- */
-using SctpMessageCallback = std::function<void(const SctpReassembledMessage&)>;
-
 /**
  * SCTP protocol parser (RFC 4960)
  *
@@ -274,6 +268,14 @@ public:
     std::optional<SctpPacket> parse(const uint8_t* data, size_t len,
                                     const FiveTuple& five_tuple);
 
+    /**
+     * Track an SCTP packet and reassemble its DATA chunks without building
+     * an SctpPacket. Complete messages reach the message callback as views
+     * that are valid only during the callback.
+     * @return false if the packet is not valid SCTP
+     */
+    bool process(const uint8_t* data, size_t len, const FiveTuple& five_tuple);
+
     /**
      * Check if data appears to be an SCTP packet
      */
@@ -343,27 +345,29 @@ private:
     std::optional<SctpInitChunk> parseInitChunk(const uint8_t* data, size_t len);
 
     /**
-     * Get or create association
+     * Association state and the reassembler for its streams
      */
-    SctpAssociation& getOrCreateAssociation(const FiveTuple& five_tuple,
-                                            uint32_t verification_tag);
+    struct AssociationContext {
+        SctpAssociation association;
+        SctpStreamReassembler reassembler;
+    };
 
     /**
-     * Update association state based on chunk type
+     * Get or create association
      */
-    void updateAssociationState(SctpAssociation& assoc, SctpChunkType chunk_type);
+    AssociationContext& getOrCreateAssociation(const FiveTuple& five_tuple,
+                                               uint32_t verification_tag);
 
     /**
-     * Process data chunks and handle reassembly
+     * Update association state based on chunk type
      */
-    void processDataChunks(SctpAssociation& assoc,
-                          const std::vector<SctpDataChunk>& data_chunks);
+    void updateAssociationState(SctpAssociation& assoc, SctpChunkType chunk_type);
 
     /**
-     * Process SACK chunks and handle gaps
+     * Update the association from the packet's chunks and pass DATA chunks
+     * to its reassembler, in chunk order
      */
-    void processSackChunks(SctpAssociation& assoc,
-                          const std::vector<SctpSackChunk>& sack_chunks);
+    void processChunks(const uint8_t* data, size_t len, const FiveTuple& five_tuple);
 
     /**
      * Calculate association ID from 5-tuple
@@ -375,11 +379,8 @@ private:
      */
     static bool verifyChecksum(const uint8_t* data, size_t len);
 
-    // Association tracking
-    std::map<uint32_t, SctpAssociation> associations_;
-
-    // Per-association stream reassemblers
-    std::map<uint32_t, SctpStreamReassembler> reassemblers_;
+    // Association tracking, with each association's stream reassembler
+    std::unordered_map<uint32_t, AssociationContext> associations_;
 
     // Message callback
     SctpMessageCallback message_callback_;
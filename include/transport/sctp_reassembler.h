@@ -1,12 +1,15 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
+#include <functional>
 #include <optional>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
 
+#include "common/types.h"
+
 namespace callflow {
 
 /**
@@ -34,6 +37,20 @@ struct SctpDataFragment {
     nlohmann::json toJson() const;
 };
 
+/**
+ * DATA chunk whose payload is a view into the packet it arrived in
+ */
+struct SctpDataChunkView {
+    uint16_t stream_id = 0;
+    uint32_t tsn = 0;
+    uint16_t stream_sequence = 0;
+    uint32_t payload_protocol = 0;
+    bool unordered = false;
+    bool beginning = false;
+    bool ending = false;
+    ByteView data;
+};
+
 /**
  * Reassembled SCTP message
  */
@@ -41,42 +58,79 @@ struct SctpReassembledMessage {
     uint16_t stream_id;
     uint16_t stream_sequence;
     uint32_t payload_protocol;
-    std::vector<uint8_t> data;  // Complete reassembled message
+    std::vector<uint8_t> data;  // Owned message bytes; empty when the message is a view
+    ByteView view;              // Message bytes owned elsewhere, see payload()
     uint32_t start_tsn;         // TSN of first fragment
     uint32_t end_tsn;           // TSN of last fragment
     size_t fragment_count;      // Number of fragments
 
+    /**
+     * Complete message. Messages passed to a message callback are views into
+     * the packet or the reassembler and stay valid only during the callback;
+     * messages returned by addFragment() own their bytes.
+     */
+    ByteView payload() const { return data.empty() ? view : ByteView(data); }
+
     nlohmann::json toJson() const;
 };
 
+/**
+ * Callback for complete reassembled messages
+ */
+using SctpMessageCallback = std::function<void(const SctpReassembledMessage&)>;
+
+/**
+ * Buffered DATA chunk of a message that is not complete yet
+ */
+struct SctpFragmentSlot {
+    bool used = false;
+    bool unordered = false;
+    bool beginning = false;
+    bool ending = false;
+    uint32_t tsn = 0;
+    uint16_t stream_sequence = 0;
+    uint32_t payload_protocol = 0;
+    std::vector<uint8_t> data;  // Keeps its capacity when the slot is freed
+};
+
 /**
  * Stream reassembly context
  */
 struct SctpStreamContext {
     uint16_t stream_id;
     uint32_t next_expected_ssn;  // Next expected Stream Sequence Number
+    bool ssn_synced;             // next_expected_ssn taken from the first ordered message
     SctpStreamState state;
 
-    // Fragmented message reassembly
-    std::map<uint16_t, std::vector<SctpDataFragment>> pending_fragments;  // SSN -> fragments
+    // Fragments of incomplete messages, slot TSN & (size - 1). Fragments of
+    // one message have consecutive TSNs (RFC 9260 Section 6.9), so a message
+    // is found by walking neighbouring slots.
+    std::vector<SctpFragmentSlot> fragments;
+    size_t buffered_fragments;
+    size_t buffered_bytes;
 
-    // Out-of-order delivery for unordered streams
-    std::map<uint32_t, SctpDataFragment> unordered_buffer;  // TSN -> fragment
+    // Complete ordered messages waiting for an earlier SSN, in SSN order
+    std::vector<SctpReassembledMessage> held_messages;
 
     // Statistics
     uint64_t messages_received;
     uint64_t bytes_received;
     uint64_t fragments_received;
     uint64_t out_of_order_count;
+    uint64_t skipped_ssns;  // SSNs given up on to release held messages
 
     SctpStreamContext(uint16_t id)
         : stream_id(id),
           next_expected_ssn(0),
+          ssn_synced(false),
           state(SctpStreamState::ACTIVE),
+          buffered_fragments(0),
+          buffered_bytes(0),
           messages_received(0),
           bytes_received(0),
           fragments_received(0),
-          out_of_order_count(0) {}
+          out_of_order_count(0),
+          skipped_ssns(0) {}
 
     nlohmann::json toJson() const;
 };
@@ -86,19 +140,44 @@ struct SctpStreamContext {
  *
  * Handles per-stream sequence tracking, fragment reassembly,
  * and out-of-order delivery for SCTP multi-streaming.
+ *
+ * addChunk() is the zero-copy path: an unfragmented message that can be
+ * delivered at once is passed on as a view into the packet, and a fragmented
+ * one is copied into the stream's fragment ring and, when complete, assembled
+ * into a buffer the reassembler reuses. Only ordered messages that must wait
+ * for an earlier SSN are copied into owned storage.
+ *
+ * Buffering is bounded: a stream holds at most kMaxHeldMessages complete
+ * messages behind a missing SSN before skipping it, its fragment ring grows
+ * to at most kMaxRingSlots, and when buffered bytes exceed the memory budget
+ * held messages are released and incomplete fragments dropped. Each of these
+ * is counted, as are gaps in the association's TSN sequence.
  */
 class SctpStreamReassembler {
 public:
+    static constexpr size_t kMaxHeldMessages = 32;
+    static constexpr size_t kMaxRingSlots = 1024;
+    static constexpr size_t kDefaultMemoryBudget = 4 * 1024 * 1024;
+
     SctpStreamReassembler() = default;
     ~SctpStreamReassembler() = default;
 
     /**
      * Add a data chunk fragment to the reassembler
      * @param fragment Data fragment to add
-     * @return Reassembled message if complete, nullopt otherwise
+     * @return Reassembled message if complete, nullopt otherwise. Further
+     *         messages the fragment completed are queued for
+     *         getCompleteMessage().
      */
     std::optional<SctpReassembledMessage> addFragment(const SctpDataFragment& fragment);
 
+    /**
+     * Add a DATA chunk and pass every message it completes to @p deliver
+     * @param chunk Chunk whose payload stays valid for the duration of the call
+     * @return Number of messages delivered
+     */
+    size_t addChunk(const SctpDataChunkView& chunk, const SctpMessageCallback& deliver);
+
     /**
      * Check if there are complete messages available
      * @return True if messages are ready to be retrieved
@@ -112,7 +191,7 @@ public:
     std::optional<SctpReassembledMessage> getCompleteMessage();
 
     /**
-     * Handle a gap in the sequence (e.g., packet loss detected)
+     * Discard buffered fragments in a TSN range (e.g., packet loss detected)
      * @param stream_id Stream ID
      * @param gap_start Start TSN of the gap
      * @param gap_end End TSN of the gap
@@ -125,6 +204,11 @@ public:
      */
     void resetStream(uint16_t stream_id);
 
+    /**
+     * Limit the bytes buffered for fragments and held messages
+     */
+    void setMemoryBudget(size_t bytes) { memory_budget_ = bytes; }
+
     /**
      * Get stream context
      * @param stream_id Stream ID
@@ -134,10 +218,17 @@ public:
 
     /**
      * Get all stream IDs
-     * @return Vector of active stream IDs
+     * @return Vector of active stream IDs, ascending
      */
     std::vector<uint16_t> getStreamIds() const;
 
+    // Association-wide counters
+    uint64_t getTsnGaps() const { return tsn_gaps_; }
+    uint64_t getMissingTsns() const { return missing_tsns_; }
+    uint64_t getBudgetEvictions() const { return budget_evictions_; }
+    uint64_t getDroppedFragments() const { return dropped_fragments_; }
+    size_t getBufferedBytes() const { return buffered_bytes_; }
+
     /**
      * Get reassembler statistics as JSON
      */
@@ -155,56 +246,79 @@ private:
     SctpStreamContext& getOrCreateStream(uint16_t stream_id);
 
     /**
-     * Try to reassemble fragments for a given stream and SSN
-     * @param stream Stream context
-     * @param ssn Stream Sequence Number
-     * @return Reassembled message if complete, nullopt otherwise
+     * Count a TSN gap when @p tsn skips ahead of the highest TSN seen
      */
-    std::optional<SctpReassembledMessage> tryReassemble(SctpStreamContext& stream, uint16_t ssn);
+    void trackTsn(uint32_t tsn);
 
     /**
-     * Check if all fragments for a message are available
-     * @param fragments Vector of fragments
-     * @return True if message is complete
+     * Deliver a complete message, or hold it if it is ordered and an
+     * earlier SSN is still missing
      */
-    bool isMessageComplete(const std::vector<SctpDataFragment>& fragments) const;
+    size_t deliverOrHold(SctpStreamContext& stream, const SctpReassembledMessage& msg,
+                         bool unordered, const SctpMessageCallback& deliver);
 
     /**
-     * Assemble fragments into a complete message
-     * @param fragments Vector of fragments (must be complete)
-     * @return Reassembled message
+     * Count a complete message and pass it to @p deliver
      */
-    SctpReassembledMessage assembleFragments(const std::vector<SctpDataFragment>& fragments);
+    void emit(SctpStreamContext& stream, const SctpReassembledMessage& msg,
+              const SctpMessageCallback& deliver);
 
     /**
-     * Handle unordered fragment
-     * @param stream Stream context
-     * @param fragment Data fragment
-     * @return Reassembled message if complete, nullopt otherwise
+     * Deliver held messages that have become next in order
      */
-    std::optional<SctpReassembledMessage> handleUnorderedFragment(
-        SctpStreamContext& stream, const SctpDataFragment& fragment);
+    size_t releaseHeld(SctpStreamContext& stream, const SctpMessageCallback& deliver);
 
     /**
-     * Handle ordered fragment
-     * @param stream Stream context
-     * @param fragment Data fragment
-     * @return Reassembled message if complete, nullopt otherwise
+     * Store a fragment in the stream's ring
+     * @return Slot index, or SIZE_MAX if the fragment was dropped
      */
-    std::optional<SctpReassembledMessage> handleOrderedFragment(
-        SctpStreamContext& stream, const SctpDataFragment& fragment);
+    size_t storeFragment(SctpStreamContext& stream, const SctpDataChunkView& chunk);
+
+    /**
+     * Double the stream's ring, dropping the older of two fragments that
+     * land in one slot
+     */
+    void growRing(SctpStreamContext& stream);
+
+    /**
+     * Assemble the message around @p slot if all its fragments are present,
+     * freeing their slots
+     */
+    bool tryAssemble(SctpStreamContext& stream, size_t slot, SctpReassembledMessage& msg,
+                     bool& unordered);
+
+    void freeSlot(SctpStreamContext& stream, SctpFragmentSlot& slot);
+
+    /**
+     * Release held messages and drop incomplete fragments of every stream
+     */
+    size_t enforceBudget(const SctpMessageCallback& deliver);
 
     // Stream contexts indexed by stream ID
-    std::map<uint16_t, SctpStreamContext> streams_;
+    std::unordered_map<uint16_t, SctpStreamContext> streams_;
 
     // Queue of complete messages ready for retrieval
     std::queue<SctpReassembledMessage> complete_messages_;
 
+    // Reused buffer for assembling fragmented messages
+    std::vector<uint8_t> assembly_;
+
+    size_t memory_budget_ = kDefaultMemoryBudget;
+    size_t buffered_bytes_ = 0;  // All streams: fragment payloads and held messages
+
+    // TSN tracking across the association
+    bool tsn_seen_ = false;
+    uint32_t highest_tsn_ = 0;
+
     // Global statistics
-    uint64_t total_fragments_;
-    uint64_t total_messages_;
-    uint64_t total_bytes_;
-    uint64_t total_gaps_;
+    uint64_t total_fragments_ = 0;
+    uint64_t total_messages_ = 0;
+    uint64_t total_bytes_ = 0;
+    uint64_t total_gaps_ = 0;
+    uint64_t tsn_gaps_ = 0;
+    uint64_t missing_tsns_ = 0;
+    uint64_t budget_evictions_ = 0;
+    uint64_t dropped_fragments_ = 0;
 };
 
 }  // namespace callflow
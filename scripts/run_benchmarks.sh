@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Run every benchmark binary and store Google Benchmark JSON results
+#
+# Usage: scripts/run_benchmarks.sh [build_dir] [baseline_dir]
+#
+# Results go to bench-results/<git describe>/<bench>.json. When a baseline
+# results directory from an earlier release is given, each result is compared
+# against it with Google Benchmark's compare.py (set COMPARE_PY if it is not
+# on PATH). Extra benchmark flags can be passed in BENCH_ARGS, e.g.
+# BENCH_ARGS="--benchmark_filter=Parse --benchmark_repetitions=5".
+
+set -e
+
+ROOT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD_DIR="${1:-$ROOT_DIR/build}"
+BASELINE_DIR="$2"
+VERSION="$(git -C "$ROOT_DIR" describe --tags --always --dirty 2>/dev/null || echo unknown)"
+OUT_DIR="${RESULTS_DIR:-$ROOT_DIR/bench-results}/$VERSION"
+COMPARE_PY="${COMPARE_PY:-$(command -v compare.py || true)}"
+
+if [ ! -d "$BUILD_DIR/bench" ]; then
+    echo "No benchmarks in $BUILD_DIR (configure with -DBUILD_BENCHMARKS=ON)"
+    exit 1
+fi
+
+mkdir -p "$OUT_DIR"
+echo "Writing results for $VERSION to $OUT_DIR"
+
+for bench in "$BUILD_DIR"/bench/bench_*; do
+    [ -x "$bench" ] || continue
+    name="$(basename "$bench")"
+    echo "Running $name..."
+    "$bench" --benchmark_out="$OUT_DIR/$name.json" --benchmark_out_format=json $BENCH_ARGS
+
+    if [ -n "$BASELINE_DIR" ] && [ -f "$BASELINE_DIR/$name.json" ]; then
+        if [ -n "$COMPARE_PY" ]; then
+            python3 "$COMPARE_PY" benchmarks "$BASELINE_DIR/$name.json" "$OUT_DIR/$name.json"
+        else
+            echo "compare.py not found, skipping comparison for $name"
+        fi
+    fi
+done
+
+echo "Benchmark results written to $OUT_DIR"
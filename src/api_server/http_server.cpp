@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "api_server/session_summary.h"
 #include "common/logger.h"
 #include "common/utils.h"  // Needed for timestampToIso8601
 #include "config/config_manager.h"
@@ -38,10 +39,15 @@ HttpServer::HttpServer(const Config& config, std::shared_ptr<JobManager> job_man
     } else {
         LOG_WARN("DatabaseManager is null, AnalyticsService will be disabled");
     }
+
+    // Deleted and expired jobs must not be served from the session cache
+    job_manager_->setJobRemovedCallback(
+        [this](const JobId& job_id) { session_store_.invalidateJob(job_id); });
 }
 
 HttpServer::~HttpServer() {
     stop();
+    job_manager_->setJobRemovedCallback(nullptr);
 }
 
 bool HttpServer::start() {
@@ -193,10 +199,6 @@ void HttpServer::setupRoutes() {
             std::string job_id = req.has_param("job_id") ? req.get_param_value("job_id") : "";
             std::string format = req.has_param("format") ? req.get_param_value("format") : "ladder";
 
-            // Note: Currently we reload session from file.
-            // Ideally we should cache or have SessionManager.
-            // For now, scan jobs like getSession detail does (inefficient but safe).
-
             std::vector<std::shared_ptr<JobInfo>> jobs_to_search;
             if (!job_id.empty()) {
                 auto job = job_manager_->getJobInfo(job_id);
@@ -210,172 +212,95 @@ void HttpServer::setupRoutes() {
                 if (job->status != JobStatus::COMPLETED)
                     continue;
 
-                if (!std::filesystem::exists(job->output_filename))
-                    continue;
-                std::ifstream infile(job->output_filename);
-                if (!infile)
+                auto session_ptr = session_store_.find(*job, session_id);
+                if (!session_ptr)
                     continue;
-
-                nlohmann::json full_results;
-                infile >> full_results;
-
-                if (full_results.contains("sessions") && full_results["sessions"].is_array()) {
-                    for (const auto& session_json : full_results["sessions"]) {
-                        // TODO: We need to reconstruct Session object from JSON to use
-                        // DiagramFormatter Or modify DiagramFormatter to accept JSON. The prompt
-                        // asked for "toLadderDiagram(const Session& session)". But we don't have
-                        // the Session object here, only JSON. And implementing JSON deserialization
-                        // for Session is huge. However, we are in C++, we should have the methods.
-
-                        // Check if ID matches
-                        std::string current_id =
-                            session_json.value("session_id", session_json.value("master_id", ""));
-                        if (current_id == session_id) {
-                            // WORKAROUND: We parse JSON back to Session struct MANUALLY or
-                            // we rely on the fact that we might have JSON->Session logic?
-                            // Actually, let's implement a JSON deserializer helper here locally or
-                            // cheat and adapt DiagramFormatter to take JSON if possible?
-                            // No, prompt required `const Session&`.
-
-                            // Let's rely on a minimal reconstruction for diagram purposes.
-                            // We need to populate `legs` -> `messages`.
-
-                            Session session;
-                            session.session_id = current_id;
-                            session.session_type = stringToEnhancedSessionType(
-                                session_json.value("session_type", "UNKNOWN"));
-                            // Timestamps
-                            // session.start_time = ...
-                            // Populate messages
-                            if (session_json.contains("messages") &&
-                                session_json["messages"].is_array()) {
-                                for (const auto& msg_json : session_json["messages"]) {
-                                    SessionMessageRef msg;
-                                    msg.src_ip = msg_json.value("src_ip", "");
-                                    msg.dst_ip = msg_json.value("dst_ip", "");
-                                    msg.src_port = msg_json.value("src_port", 0);
-                                    msg.dst_port = msg_json.value("dst_port", 0);
-                                    msg.protocol =
-                                        stringToProtocolType(msg_json.value("protocol", "UNKNOWN"));
-                                    msg.message_type = (MessageType)0;  // Enum parsing hard without
-                                                                        // stringToMessageType
-                                    // msg.message_type = stringToMessageType(...) // We need this
-                                    // Assume label or type string is enough? Diagram formatter
-                                    // needs message_type enum? Diagram formatter maps message_type
-                                    // ENUM to string. But here we have string. Let's assume we can
-                                    // modify DiagramFormatter to take string directly? Or populate
-                                    // a dummy enum and put string in parsed_data?
-
-                                    msg.timestamp = std::chrono::system_clock::from_time_t(
-                                        0);  // TODO parse ISO8601
-
-                                    // Interface
-                                    msg.interface = stringToInterfaceType(
-                                        msg_json.value("interface", "UNKNOWN"));
-
-                                    session.addMessage(msg);
-                                }
+                const nlohmann::json& session_json = *session_ptr;
+
+                nlohmann::json diagram;
+                if (format == "timeline") {
+                    // Manual construction from JSON since we can't easily dehydrate
+                    // Session
+                    nlohmann::json items = nlohmann::json::array();
+                    int i = 0;
+                    for (const auto& m : session_json.value("messages", nlohmann::json::array())) {
+                        items.push_back(
+                            {{"id", i++},
+                             {"content", m.value("type", m.value("protocol", "?"))},
+                             {"start", m.value("timestamp", "")},
+                             {"group", m.value("interface", "UNKNOWN")}});
+                    }
+                    diagram = {{"items", items}};
+                } else {
+                    // Ladder diagram - extract participants and messages from events
+                    std::map<std::string, nlohmann::json> participant_map;
+                    nlohmann::json participants = nlohmann::json::array();
+                    nlohmann::json messages = nlohmann::json::array();
+                    int participant_id = 0;
+
+                    // Get events from session
+                    auto events = session_json.contains("events")
+                        ? session_json["events"]
+                        : session_json.value("messages", nlohmann::json::array());
+
+                    if (events.is_array()) {
+                        for (const auto& event : events) {
+                            // Extract source and destination
+                            std::string src_ip = event.value("src_ip", event.value("source_ip", "unknown"));
+                            std::string dst_ip = event.value("dst_ip", event.value("dest_ip", "unknown"));
+                            uint16_t src_port = event.value("src_port", event.value("source_port", 0));
+                            uint16_t dst_port = event.value("dst_port", event.value("dest_port", 0));
+
+                            std::string src_key = src_ip + ":" + std::to_string(src_port);
+                            std::string dst_key = dst_ip + ":" + std::to_string(dst_port);
+
+                            // Add source participant if not exists
+                            if (participant_map.find(src_key) == participant_map.end()) {
+                                std::string pid = "p" + std::to_string(participant_id++);
+                                nlohmann::json p;
+                                p["id"] = pid;
+                                p["ip"] = src_ip;
+                                p["port"] = src_port;
+                                p["type"] = (src_port == 5060 || src_port == 5061) ? "SERVER" :
+                                            (src_port > 10000 ? "UE" : "SERVER");
+                                p["label"] = src_ip;
+                                participants.push_back(p);
+                                participant_map[src_key] = p;
                             }
 
-                            // FAILBACK: Since deserialization is hard and likely incomplete,
-                            // we might return 501 Not Implemented or try our best.
-                            // Given constraints, I will return the plain JSON from file for now
-                            // but wrapped in "ladder" structure if I can using the same JSON.
-
-                            // Actually, the previous implementation of getSession returns raw JSON.
-                            // The user wants a diagram-ready format.
-                            // DiagramFormatter expects Session object.
-
-                            // Let's instantiate a minimal session and use what we have.
-                            // We really need `from_json` for Session.
-
-                            nlohmann::json diagram;
-                            if (format == "timeline") {
-                                // Manual construction from JSON since we can't easily dehydrate
-                                // Session
-                                nlohmann::json items = nlohmann::json::array();
-                                int i = 0;
-                                for (const auto& m : session_json["messages"]) {
-                                    items.push_back(
-                                        {{"id", i++},
-                                         {"content", m.value("type", m.value("protocol", "?"))},
-                                         {"start", m.value("timestamp", "")},
-                                         {"group", m.value("interface", "UNKNOWN")}});
-                                }
-                                diagram = {{"items", items}};
-                            } else {
-                                // Ladder diagram - extract participants and messages from events
-                                std::map<std::string, nlohmann::json> participant_map;
-                                nlohmann::json participants = nlohmann::json::array();
-                                nlohmann::json messages = nlohmann::json::array();
-                                int participant_id = 0;
-
-                                // Get events from session
-                                auto events = session_json.contains("events")
-                                    ? session_json["events"]
-                                    : session_json.value("messages", nlohmann::json::array());
-
-                                if (events.is_array()) {
-                                    for (const auto& event : events) {
-                                        // Extract source and destination
-                                        std::string src_ip = event.value("src_ip", event.value("source_ip", "unknown"));
-                                        std::string dst_ip = event.value("dst_ip", event.value("dest_ip", "unknown"));
-                                        uint16_t src_port = event.value("src_port", event.value("source_port", 0));
-                                        uint16_t dst_port = event.value("dst_port", event.value("dest_port", 0));
-
-                                        std::string src_key = src_ip + ":" + std::to_string(src_port);
-                                        std::string dst_key = dst_ip + ":" + std::to_string(dst_port);
-
-                                        // Add source participant if not exists
-                                        if (participant_map.find(src_key) == participant_map.end()) {
-                                            std::string pid = "p" + std::to_string(participant_id++);
-                                            nlohmann::json p;
-                                            p["id"] = pid;
-                                            p["ip"] = src_ip;
-                                            p["port"] = src_port;
-                                            p["type"] = (src_port == 5060 || src_port == 5061) ? "SERVER" :
-                                                        (src_port > 10000 ? "UE" : "SERVER");
-                                            p["label"] = src_ip;
-                                            participants.push_back(p);
-                                            participant_map[src_key] = p;
-                                        }
-
-                                        // Add destination participant if not exists
-                                        if (participant_map.find(dst_key) == participant_map.end()) {
-                                            std::string pid = "p" + std::to_string(participant_id++);
-                                            nlohmann::json p;
-                                            p["id"] = pid;
-                                            p["ip"] = dst_ip;
-                                            p["port"] = dst_port;
-                                            p["type"] = (dst_port == 5060 || dst_port == 5061) ? "SERVER" :
-                                                        (dst_port > 10000 ? "UE" : "SERVER");
-                                            p["label"] = dst_ip;
-                                            participants.push_back(p);
-                                            participant_map[dst_key] = p;
-                                        }
-
-                                        // Create message entry
-                                        nlohmann::json msg;
-                                        msg["from"] = participant_map[src_key]["id"];
-                                        msg["to"] = participant_map[dst_key]["id"];
-                                        msg["protocol"] = event.value("protocol", event.value("proto", "UNKNOWN"));
-                                        msg["label"] = event.value("message_type", event.value("short", ""));
-                                        msg["timestamp"] = event.value("timestamp", 0);
-                                        msg["details"] = event.value("details", nlohmann::json::object());
-                                        messages.push_back(msg);
-                                    }
-                                }
-
-                                diagram["participants"] = participants;
-                                diagram["messages"] = messages;
-                                diagram["title"] = session_json.value("call_id", session_id);
+                            // Add destination participant if not exists
+                            if (participant_map.find(dst_key) == participant_map.end()) {
+                                std::string pid = "p" + std::to_string(participant_id++);
+                                nlohmann::json p;
+                                p["id"] = pid;
+                                p["ip"] = dst_ip;
+                                p["port"] = dst_port;
+                                p["type"] = (dst_port == 5060 || dst_port == 5061) ? "SERVER" :
+                                            (dst_port > 10000 ? "UE" : "SERVER");
+                                p["label"] = dst_ip;
+                                participants.push_back(p);
+                                participant_map[dst_key] = p;
                             }
 
-                            res.set_content(diagram.dump(), "application/json");
-                            return;
+                            // Create message entry
+                            nlohmann::json msg;
+                            msg["from"] = participant_map[src_key]["id"];
+                            msg["to"] = participant_map[dst_key]["id"];
+                            msg["protocol"] = event.value("protocol", event.value("proto", "UNKNOWN"));
+                            msg["label"] = event.value("message_type", event.value("short", ""));
+                            msg["timestamp"] = event.value("timestamp", 0);
+                            msg["details"] = event.value("details", nlohmann::json::object());
+                            messages.push_back(msg);
                         }
                     }
+
+                    diagram["participants"] = participants;
+                    diagram["messages"] = messages;
+                    diagram["title"] = session_json.value("call_id", session_id);
                 }
+
+                res.set_content(diagram.dump(), "application/json");
+                return;
             }
 
             nlohmann::json error = {{"error", "Session not found"}, {"code", "SESSION_NOT_FOUND"}};
@@ -484,6 +409,8 @@ void HttpServer::setupRoutes() {
                 response["total_packets"] = job_info->total_packets;
                 response["total_bytes"] = job_info->total_bytes;
                 response["session_count"] = job_info->session_ids.size();
+                response["arena"] = arenaStatsToJson(job_info->arena_stats);
+                response["ip_defrag"] = defragStatsToJson(job_info->defrag_stats);
             }
 
             res.set_content(response.dump(), "application/json");
@@ -591,6 +518,8 @@ void HttpServer::setupRoutes() {
                 response["total_packets"] = job_info->total_packets;
                 response["total_bytes"] = job_info->total_bytes;
                 response["session_count"] = job_info->session_ids.size();
+                response["arena"] = arenaStatsToJson(job_info->arena_stats);
+                response["ip_defrag"] = defragStatsToJson(job_info->defrag_stats);
             }
 
             res.set_content(response.dump(), "application/json");
@@ -603,6 +532,40 @@ void HttpServer::setupRoutes() {
         }
     });
 
+    // GET /api/v1/jobs/{job_id}/metrics - Get live job metrics
+    server->Get("/api/v1/jobs/:job_id/metrics", [this](const httplib::Request& req,
+                                                       httplib::Response& res) {
+        try {
+            std::string job_id = req.path_params.at("job_id");
+            auto job_info = job_manager_->getJobInfo(job_id);
+
+            if (!job_info) {
+                nlohmann::json error = {{"error", "Job not found"}, {"code", "JOB_NOT_FOUND"}};
+                res.status = 404;
+                res.set_content(error.dump(), "application/json");
+                return;
+            }
+
+            // Jobs that never ran in this process (e.g. loaded from the database) only
+            // have their stored progress
+            auto metrics = job_manager_->getJobMetrics(job_id);
+            nlohmann::json response = metrics ? metrics->toJson() : nlohmann::json::object();
+            response["job_id"] = job_id;
+            response["status"] = jobStatusToString(job_info->status);
+            if (!metrics) {
+                response["progress"] = job_info->progress;
+            }
+
+            res.set_content(response.dump(), "application/json");
+
+        } catch (const std::exception& e) {
+            LOG_ERROR("Get metrics failed: " << e.what());
+            nlohmann::json error = {{"error", e.what()}, {"code", "INTERNAL_ERROR"}};
+            res.status = 500;
+            res.set_content(error.dump(), "application/json");
+        }
+    });
+
     // GET /api/v1/jobs/{job_id}/sessions - Get job sessions (paginated)
     server->Get("/api/v1/jobs/:job_id/sessions", [this](const httplib::Request& req,
                                                         httplib::Response& res) {
@@ -636,7 +599,61 @@ void HttpServer::setupRoutes() {
                 limit = std::stoi(req.get_param_value("limit"));
             }
 
-            // Load sessions from output file
+            // Jobs with a summary table are filtered, sorted and paged from it;
+            // only the sessions on the page are read from the result file
+            if (auto summary = session_store_.summaryFor(*job_info)) {
+                SessionSummaryTable::Query query;
+                query.imsi = req.has_param("imsi") ? req.get_param_value("imsi") : "";
+                query.msisdn = req.has_param("msisdn") ? req.get_param_value("msisdn") : "";
+                query.type = req.has_param("type") ? req.get_param_value("type") : "";
+                query.cursor = req.has_param("cursor") ? req.get_param_value("cursor") : "";
+                query.descending = req.has_param("order") && req.get_param_value("order") == "desc";
+                query.limit = static_cast<size_t>(std::clamp(limit, 1, 1000));
+                query.offset = static_cast<size_t>(std::max(page - 1, 0)) * query.limit;
+                if (req.has_param("sort") &&
+                    !SessionSummaryTable::parseSortKey(req.get_param_value("sort"), query.sort)) {
+                    nlohmann::json error = {{"error", "Unknown sort key"},
+                                            {"code", "INVALID_PARAMETER"}};
+                    res.status = 400;
+                    res.set_content(error.dump(), "application/json");
+                    return;
+                }
+
+                SessionSummaryTable::Page result;
+                try {
+                    result = summary->query(query);
+                } catch (const std::invalid_argument& e) {
+                    nlohmann::json error = {{"error", e.what()}, {"code", "INVALID_PARAMETER"}};
+                    res.status = 400;
+                    res.set_content(error.dump(), "application/json");
+                    return;
+                }
+
+                bool summary_view =
+                    req.has_param("view") && req.get_param_value("view") == "summary";
+                nlohmann::json page_sessions = nlohmann::json::array();
+                for (uint32_t row : result.rows) {
+                    if (summary_view) {
+                        page_sessions.push_back(summary->rowToJson(row));
+                    } else {
+                        page_sessions.push_back(SessionIndex::readSession(
+                            job_info->output_filename, summary->range(row)));
+                    }
+                }
+
+                nlohmann::json response = {{"job_id", job_id},
+                                           {"page", page},
+                                           {"limit", query.limit},
+                                           {"total", result.total},
+                                           {"sessions", page_sessions}};
+                response["next_cursor"] = result.next_cursor.empty()
+                                              ? nlohmann::json(nullptr)
+                                              : nlohmann::json(result.next_cursor);
+                res.set_content(response.dump(), "application/json");
+                return;
+            }
+
+            // Load sessions from output file (jobs written before summaries existed)
             std::ifstream infile(job_info->output_filename);
             if (!infile) {
                 throw std::runtime_error("Failed to read results file");
@@ -729,69 +746,18 @@ void HttpServer::setupRoutes() {
                     continue;
                 }
 
-                // If searching globally (no job_id), use index optimization
-                if (filter_job_id.empty()) {
-                    auto it =
-                        std::find(job->session_ids.begin(), job->session_ids.end(), session_id);
-                    if (it == job->session_ids.end()) {
-                        continue;
-                    }
-                }
-
-                LOG_DEBUG("Looking up session: Job=" << job->job_id
-                                                     << " File=" << job->output_filename
-                                                     << " TargetSession=" << session_id);
-
-                // Load sessions from output file
-                if (!std::filesystem::exists(job->output_filename)) {
-                    LOG_ERROR("Output file does not exist: " << job->output_filename);
-                    continue;
-                }
-
-                std::ifstream infile(job->output_filename);
-                if (!infile) {
-                    LOG_ERROR("Failed to open output file: " << job->output_filename);
-                    continue;
-                }
-
-                nlohmann::json full_results;
-                try {
-                    infile >> full_results;
-                } catch (const std::exception& e) {
-                    LOG_ERROR("Failed to parse JSON file: " << e.what());
-                    continue;
-                }
-
-                // Find the session
-                if (full_results.contains("sessions") && full_results["sessions"].is_array()) {
-                    int count = 0;
-                    for (const auto& session : full_results["sessions"]) {
-                        // Check for master_id (VoLTE) or fallback to session_id
-                        std::string current_master_id = session.value("master_id", "");
-                        std::string current_session_id = session.value("session_id", "");
-
-                        // Try matching either Key
-                        if (current_master_id == session_id || current_session_id == session_id) {
-                            LOG_INFO("Found session " << session_id);
-                            res.set_content(session.dump(), "application/json");
-                            return;
-                        }
-                        count++;
-                    }
-
-                    // Debug: Dump available IDs
-                    int dump_limit = 0;
-                    for (const auto& session : full_results["sessions"]) {
-                        if (dump_limit++ >= 10)
-                            break;
-                        LOG_ERROR("Available ID: " << session.value(
-                                      "session_id", session.value("master_id", "MISSING")));
-                    }
-
-                    LOG_ERROR("Scanned " << count << " sessions in job " << job->job_id
-                                         << ", no match found.");
-                } else {
-                    LOG_ERROR("JSON file for job " << job->job_id << " has no sessions array.");
+                // Jobs without a sidecar index are only parsed in full when the
+                // caller named them or their master session list matches
+                bool allow_full_scan =
+                    !filter_job_id.empty() ||
+                    std::find(job->session_ids.begin(), job->session_ids.end(), session_id) !=
+                        job->session_ids.end();
+
+                auto session = session_store_.find(*job, session_id, allow_full_scan);
+                if (session) {
+                    LOG_DEBUG("Found session " << session_id << " in job " << job->job_id);
+                    res.set_content(session->dump(), "application/json");
+                    return;
                 }
             }
 
@@ -4,15 +4,21 @@
 #include <netinet/in.h>
 #include <netinet/udp.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <set>
 
+#include "api_server/session_index.h"
+#include "api_server/session_summary.h"
+#include "common/job_arena.h"
 #include "common/utils.h"
 #include "event_extractor/json_exporter.h"
 #include "pcap_ingest/packet_processor.h"
 #include "pcap_ingest/pcap_reader.h"
 #include "pcap_ingest/pcapng_reader.h"
+#include "pcap_ingest/sharded_packet_processor.h"
 #include "persistence/database.h"
+#include "persistence/database_writer.h"
 #include "protocol_parsers/diameter_parser.h"
 #include "protocol_parsers/gtp_parser.h"
 #include "protocol_parsers/pfcp_parser.h"
@@ -24,6 +30,37 @@
 
 namespace callflow {
 
+nlohmann::json JobMetrics::toJson() const {
+    return {{"message", message},
+            {"progress", progress},
+            {"file_size", file_size},
+            {"file_offset", file_offset},
+            {"packets", packets},
+            {"bytes", bytes},
+            {"elapsed_sec", elapsed_sec},
+            {"packets_per_sec", packets_per_sec},
+            {"mbps", mbps},
+            {"sessions_open", sessions_open},
+            {"memory_rss_bytes", memory_rss_bytes}};
+}
+
+nlohmann::json arenaStatsToJson(const ArenaStats& stats) {
+    return {{"allocations", stats.allocations},
+            {"bytes_allocated", stats.bytes_allocated},
+            {"bytes_freed", stats.bytes_freed},
+            {"bytes_reserved", stats.bytes_reserved},
+            {"chunks", stats.chunks}};
+}
+
+nlohmann::json defragStatsToJson(const DefragStats& stats) {
+    return {{"fragments", stats.fragments},
+            {"reassembled", stats.reassembled},
+            {"timeouts", stats.timeouts},
+            {"overlaps", stats.overlaps},
+            {"evicted", stats.evicted},
+            {"malformed", stats.malformed}};
+}
+
 JobManager::JobManager(const Config& config, std::shared_ptr<DatabaseManager> db)
     : config_(config), db_(db), running_(false) {}
 
@@ -50,6 +87,12 @@ bool JobManager::start() {
 
     running_.store(true);
 
+    // Bulk inserts go through a single writer thread
+    if (db_) {
+        db_writer_ = std::make_unique<DatabaseWriter>(db_, config_.database);
+        db_writer_->start();
+    }
+
     // Start worker threads
     for (int i = 0; i < config_.api_worker_threads; ++i) {
         workers_.emplace_back(&JobManager::workerThread, this);
@@ -78,6 +121,12 @@ void JobManager::stop() {
     }
 
     workers_.clear();
+
+    // Commit whatever the workers queued before returning
+    if (db_writer_) {
+        db_writer_->stop();
+        db_writer_.reset();
+    }
     LOG_INFO("JobManager stopped");
 }
 
@@ -116,7 +165,7 @@ JobId JobManager::submitJob(const std::string& input_file, const std::string& or
     // Queue job task
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        job_queue_.push({job_id, input_file, job_info->output_filename});
+        job_queue_.push({job_id, input_file, job_info->output_filename, next_job_tag_++});
     }
 
     queue_cv_.notify_one();
@@ -134,6 +183,15 @@ std::shared_ptr<JobInfo> JobManager::getJobInfo(const JobId& job_id) {
     return nullptr;
 }
 
+std::optional<JobMetrics> JobManager::getJobMetrics(const JobId& job_id) {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    auto it = metrics_.find(job_id);
+    if (it != metrics_.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
 std::vector<std::shared_ptr<JobInfo>> JobManager::getAllJobs() {
     std::lock_guard<std::mutex> lock(jobs_mutex_);
 
@@ -157,7 +215,7 @@ std::vector<std::shared_ptr<JobInfo>> JobManager::getAllJobs() {
 }
 
 bool JobManager::deleteJob(const JobId& job_id) {
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
     auto it = jobs_.find(job_id);
     if (it == jobs_.end()) {
         return false;
@@ -174,16 +232,24 @@ bool JobManager::deleteJob(const JobId& job_id) {
         if (std::filesystem::exists(it->second->output_filename)) {
             std::filesystem::remove(it->second->output_filename);
         }
+        std::filesystem::remove(SessionIndex::sidecarPath(it->second->output_filename));
+        std::filesystem::remove(SessionSummaryTable::sidecarPath(it->second->output_filename));
     } catch (const std::exception& e) {
         LOG_WARN("Failed to delete output file: " << e.what());
     }
 
     jobs_.erase(it);
+    metrics_.erase(job_id);
 
     // Delete from database
     if (db_) {
         db_->deleteJob(job_id);
     }
+    lock.unlock();
+
+    if (job_removed_callback_) {
+        job_removed_callback_(job_id);
+    }
 
     LOG_INFO("Job " << job_id << " deleted");
     return true;
@@ -203,7 +269,8 @@ void JobManager::cleanupOldJobs() {
     auto retention_duration = std::chrono::hours(config_.retention_hours);
     auto hung_job_timeout = std::chrono::hours(1);  // Mark jobs as failed after 1 hour of running
 
-    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    std::vector<JobId> removed;
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
     for (auto it = jobs_.begin(); it != jobs_.end();) {
         const auto& job = it->second;
 
@@ -242,15 +309,26 @@ void JobManager::cleanupOldJobs() {
                 if (std::filesystem::exists(job->output_filename)) {
                     std::filesystem::remove(job->output_filename);
                 }
+                std::filesystem::remove(SessionIndex::sidecarPath(job->output_filename));
+                std::filesystem::remove(SessionSummaryTable::sidecarPath(job->output_filename));
             } catch (const std::exception& e) {
                 LOG_WARN("Failed to delete output file: " << e.what());
             }
 
+            metrics_.erase(job->job_id);
+            removed.push_back(job->job_id);
             it = jobs_.erase(it);
         } else {
             ++it;
         }
     }
+    lock.unlock();
+
+    if (job_removed_callback_) {
+        for (const auto& job_id : removed) {
+            job_removed_callback_(job_id);
+        }
+    }
 }
 
 void JobManager::workerThread() {
@@ -346,16 +424,24 @@ void JobManager::processJob(const JobTask& task) {
     updateProgress(task.job_id, 0, "Starting PCAP processing");
     sendEvent(task.job_id, "status", {{"status", "running"}});
 
-    EnhancedSessionCorrelator correlator;  // Default constructor? Or config?
-    // Check constructor of EnhancedSessionCorrelator. It is default.
-    // EnhancedSessionCorrelator correlator; // No config?
-    // Old SessionCorrelator took config.
-    // Let's assume default is fine based on header file view.
-    PacketProcessor processor(correlator);
+    // Session storage lives in a per-job arena, freed in one step when the
+    // job ends; declared first so it outlives the correlator
+    JobArena arena(config_.arena_chunk_kb * 1024);
+    EnhancedSessionCorrelator correlator(&arena);
+    ShardedPacketProcessor processor(correlator, static_cast<size_t>(config_.worker_threads),
+                                     config_.max_packet_queue_size);
+    processor.setJobTag(task.job_tag);
 
     size_t packet_count = 0;
     size_t total_bytes = 0;
 
+    IngestTracker tracker;
+    tracker.start = std::chrono::steady_clock::now();
+    tracker.last_report = tracker.start;
+    auto merge_progress = [&](size_t merged, size_t total) {
+        reportMerge(task.job_id, tracker, merged, total, correlator);
+    };
+
     // Detect format
     bool is_pcapng = PcapngReader::validate(task.input_file);
 
@@ -365,6 +451,8 @@ void JobManager::processJob(const JobTask& task) {
         if (!reader.open(task.input_file)) {
             throw std::runtime_error("Failed to open PCAPNG file: " + task.input_file);
         }
+        processor.setStableInput(reader.isMemoryMapped());
+        ShardAbortGuard shard_guard(processor);
 
         updateProgress(task.job_id, 10, "PCAPNG file opened");
 
@@ -393,14 +481,19 @@ void JobManager::processJob(const JobTask& task) {
             packet_count++;
             total_bytes += cap_len;
 
-            if (packet_count % 1000 == 0) {
-                int progress = 10 + (packet_count % 10000) * 60 / 10000;
-                updateProgress(task.job_id, progress,
-                               "Processed " + std::to_string(packet_count) + " packets");
+            // Only look at the clock every 256 packets; reportIngest() rate-limits further
+            if ((packet_count & 0xFF) == 0) {
+                reportIngest(task.job_id, tracker, reader.getFileOffset(), reader.getFileSize(),
+                             packet_count, total_bytes, correlator);
             }
         };
 
         reader.processPackets(callback);
+        reportIngest(task.job_id, tracker, reader.getFileOffset(), reader.getFileSize(),
+                     packet_count, total_bytes, correlator, true);
+
+        // Drain ingest shards while the reader's buffers are still mapped
+        processor.finish(merge_progress);
 
         // Post-processing: Extract stats
         {
@@ -435,6 +528,8 @@ void JobManager::processJob(const JobTask& task) {
         if (!reader.open(task.input_file)) {
             throw std::runtime_error("Failed to open PCAP file: " + task.input_file);
         }
+        processor.setStableInput(reader.isMemoryMapped());
+        ShardAbortGuard shard_guard(processor);
 
         updateProgress(task.job_id, 10, "PCAP file opened");
 
@@ -449,17 +544,25 @@ void JobManager::processJob(const JobTask& task) {
             packet_count++;
             total_bytes += header->caplen;
 
-            if (packet_count % 1000 == 0) {
-                int progress = 10 + (packet_count % 10000) * 60 / 10000;
-                updateProgress(task.job_id, progress,
-                               "Processed " + std::to_string(packet_count) + " packets");
+            if ((packet_count & 0xFF) == 0) {
+                reportIngest(task.job_id, tracker, reader.getFileOffset(), reader.getFileSize(),
+                             packet_count, total_bytes, correlator);
             }
         };
 
         reader.processPackets(callback);
+        reportIngest(task.job_id, tracker, reader.getFileOffset(), reader.getFileSize(),
+                     packet_count, total_bytes, correlator, true);
+        processor.finish(merge_progress);
         reader.close();
     }
 
+    for (const auto& shard : processor.getShardStats()) {
+        LOG_INFO("Job " << task.job_id << ": shard " << shard.shard_id << " processed "
+                        << shard.packets << " packets ("
+                        << static_cast<uint64_t>(shard.packetsPerSecond()) << " pps)");
+    }
+
     LOG_INFO("Job " << task.job_id << ": Starting post-processing after " << packet_count << " packets");
     updateProgress(task.job_id, 70, "Finalizing sessions");
 
@@ -498,60 +601,62 @@ void JobManager::processJob(const JobTask& task) {
     updateProgress(task.job_id, 80, "Exporting results");
 
     // Export all sessions including SIP-only (standalone SIP sessions without GTP correlation)
-    // This ensures SIP traffic is visible even when there's no GTP anchor for correlation
-    LOG_INFO("Job " << task.job_id << ": Calling exportAllSessionsWithSipOnly()");
-    JsonExporter exporter;
-    std::string all_sessions_json_str;
-    try {
-        all_sessions_json_str = exporter.exportAllSessionsWithSipOnly(correlator);
-        LOG_INFO("Job " << task.job_id << ": exportAllSessionsWithSipOnly() returned " << all_sessions_json_str.size() << " bytes");
-    } catch (const std::exception& e) {
-        LOG_ERROR("Job " << task.job_id << ": exportAllSessionsWithSipOnly() failed: " << e.what());
-        throw;
-    }
-
-    // Wrap in object structure
-    LOG_INFO("Job " << task.job_id << ": Parsing JSON output");
-    nlohmann::json final_output;
+    // This ensures SIP traffic is visible even when there's no GTP anchor for correlation.
+    // Sessions are built and written one at a time, with a sidecar index so single sessions
+    // can be served without parsing the whole document.
+    LOG_INFO("Job " << task.job_id << ": Streaming sessions to " << task.output_file);
     try {
-        final_output["sessions"] = nlohmann::json::parse(all_sessions_json_str);
-        final_output["metadata"] = {{"job_id", task.job_id},
-                                    {"timestamp", utils::timestampToIso8601(utils::now())},
-                                    {"exporter", "VolteMasterSessionWithSipOnly"}};
-        LOG_INFO("Job " << task.job_id << ": JSON parsing completed successfully");
-    } catch (const std::exception& e) {
-        LOG_ERROR("Job " << task.job_id << ": JSON parsing failed: " << e.what());
-        throw;
-    }
+        nlohmann::json metadata_json = {{"job_id", task.job_id},
+                                        {"timestamp", utils::timestampToIso8601(utils::now())},
+                                        {"exporter", "VolteMasterSessionWithSipOnly"}};
 
-    // Write to file
-    LOG_INFO("Job " << task.job_id << ": Writing output to " << task.output_file);
-    try {
-        std::ofstream out(task.output_file);
-        if (!out) {
+        SessionResultWriter writer;
+        if (!writer.open(task.output_file, metadata_json)) {
             throw std::runtime_error("Failed to open output file: " + task.output_file);
         }
-        out << final_output.dump(4);  // Pretty print
-        out.close();
-        LOG_INFO("Job " << task.job_id << ": Output file written successfully");
+
+        size_t expected_sessions =
+            std::max<size_t>(1, master_sessions.size() + correlator.getSipOnlySessionCount());
+        int last_progress = 80;
+        JsonExporter exporter;
+        exporter.exportAllSessionsWithSipOnly(correlator, [&](const nlohmann::json& session) {
+            writer.addSession(session);
+
+            int progress = 80 + static_cast<int>(
+                                    std::min<size_t>(writer.sessionCount(), expected_sessions) *
+                                    19 / expected_sessions);
+            if (progress > last_progress) {
+                last_progress = progress;
+                updateProgress(task.job_id, progress,
+                               "Exporting results (" + std::to_string(writer.sessionCount()) +
+                                   " sessions, " +
+                                   std::to_string(writer.bytesWritten() / (1024 * 1024)) +
+                                   " MB written)");
+            }
+        });
+
+        if (!writer.close()) {
+            throw std::runtime_error("Failed to write output file: " + task.output_file);
+        }
+        LOG_INFO("Job " << task.job_id << ": Output file written successfully ("
+                        << writer.sessionCount() << " sessions, " << writer.bytesWritten()
+                        << " bytes)");
     } catch (const std::exception& e) {
-        LOG_ERROR("Job " << task.job_id << ": File write failed: " << e.what());
+        LOG_ERROR("Job " << task.job_id << ": Export failed: " << e.what());
         throw;
     }
 
-    updateProgress(task.job_id, 100, "Completed");
-
     // Update job info with error handling
     LOG_INFO("Job " << task.job_id << ": Updating job status and database");
+    std::vector<SessionRecord> db_records;
     try {
         std::lock_guard<std::mutex> lock(jobs_mutex_);
         auto it = jobs_.find(task.job_id);
         if (it != jobs_.end()) {
-            it->second->status = JobStatus::COMPLETED;
-            it->second->progress = 100;
-            it->second->completed_at = utils::now();
             it->second->total_packets = packet_count;
             it->second->total_bytes = total_bytes;
+            it->second->arena_stats = arena.stats();
+            it->second->defrag_stats = processor.getDefragStats();
             // Include both master sessions and SIP-only sessions in the count
             size_t sip_only_count = correlator.getSipOnlySessionCount();
             it->second->session_count = master_sessions.size() + sip_only_count;
@@ -564,15 +669,10 @@ void JobManager::processJob(const JobTask& task) {
 
             LOG_INFO("Job " << task.job_id << ": Job info updated, session_count=" << it->second->session_count);
 
-            // Update database
             if (db_) {
-                LOG_INFO("Job " << task.job_id << ": Updating database");
-                db_->updateJob(task.job_id, *it->second);
-
                 // Insert Master Sessions into DB
                 // Mapping VolteMasterSession to SessionRecord (best effort)
                 std::set<std::string> inserted_ids;
-                size_t db_insert_count = 0;
                 for (const auto& [imsi, ms] : master_sessions) {
                     if (inserted_ids.count(ms.master_uuid)) {
                         continue;
@@ -611,10 +711,8 @@ void JobManager::processJob(const JobTask& task) {
                     record.participant_ips = "[]";
                     record.metadata = "{}";
 
-                    db_->insertSession(record);
-                    db_insert_count++;
+                    db_records.push_back(std::move(record));
                 }
-                LOG_INFO("Job " << task.job_id << ": Inserted " << db_insert_count << " sessions into database");
             }
         }
     } catch (const std::exception& e) {
@@ -622,14 +720,124 @@ void JobManager::processJob(const JobTask& task) {
         throw;
     }
 
+    // Session rows are committed in batches by the writer thread, outside jobs_mutex_
+    if (db_writer_ && !db_records.empty()) {
+        size_t queued = 0;
+        for (auto& record : db_records) {
+            if (db_writer_->enqueue(std::move(record))) {
+                queued++;
+            }
+        }
+        LOG_INFO("Job " << task.job_id << ": Queued " << queued << " sessions for database insert");
+
+        // Clients react to completion by reading the sessions back
+        db_writer_->flush();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        auto it = jobs_.find(task.job_id);
+        if (it != jobs_.end()) {
+            it->second->status = JobStatus::COMPLETED;
+            it->second->completed_at = utils::now();
+            if (db_) {
+                LOG_INFO("Job " << task.job_id << ": Updating database");
+                db_->updateJob(task.job_id, *it->second);
+            }
+        }
+    }
+    updateProgress(task.job_id, 100, "Completed");
+
     sendEvent(task.job_id, "status",
               {{"status", "completed"},
                {"sessions", sessions.size()},
                {"packets", packet_count},
-               {"bytes", total_bytes}});
+               {"bytes", total_bytes},
+               {"arena", arenaStatsToJson(arena.stats())},
+               {"ip_defrag", defragStatsToJson(processor.getDefragStats())}});
 
+    ArenaStats arena_stats = arena.stats();
     LOG_INFO("Job " << task.job_id << " completed: " << packet_count << " packets, "
-                    << sessions.size() << " sessions");
+                    << sessions.size() << " sessions; arena " << arena_stats.allocations
+                    << " allocations, " << arena_stats.bytes_allocated << " bytes allocated, "
+                    << arena_stats.bytes_reserved << " bytes in " << arena_stats.chunks
+                    << " chunks");
+
+    DefragStats defrag_stats = processor.getDefragStats();
+    if (defrag_stats.fragments > 0) {
+        LOG_INFO("Job " << task.job_id << ": " << defrag_stats.fragments << " IP fragments, "
+                        << defrag_stats.reassembled << " datagrams reassembled, "
+                        << defrag_stats.timeouts << " timed out, " << defrag_stats.overlaps
+                        << " overlaps, " << defrag_stats.evicted << " evicted");
+    }
+}
+
+void JobManager::reportIngest(const JobId& job_id, IngestTracker& tracker, uint64_t file_offset,
+                              uint64_t file_size, uint64_t packets, uint64_t bytes,
+                              const EnhancedSessionCorrelator& correlator, bool force) {
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - tracker.last_report < kProgressInterval) {
+        return;
+    }
+
+    double interval_sec = std::chrono::duration<double>(now - tracker.last_report).count();
+    JobMetrics metrics;
+    metrics.file_size = file_size;
+    metrics.file_offset = std::min(file_offset, file_size > 0 ? file_size : file_offset);
+    metrics.packets = packets;
+    metrics.bytes = bytes;
+    metrics.elapsed_sec = std::chrono::duration<double>(now - tracker.start).count();
+    if (interval_sec > 0.0) {
+        metrics.packets_per_sec = (packets - tracker.last_packets) / interval_sec;
+        metrics.mbps = (bytes - tracker.last_bytes) * 8.0 / 1e6 / interval_sec;
+    }
+    metrics.sessions_open = correlator.getSessionCount() + correlator.getSipOnlySessionCount();
+    metrics.memory_rss_bytes = utils::currentRssBytes();
+    metrics.progress =
+        file_size > 0 ? 10 + static_cast<int>(metrics.file_offset * 55 / file_size) : 10;
+    metrics.message = "Processed " + std::to_string(packets) + " packets";
+
+    tracker.last_report = now;
+    tracker.last_packets = packets;
+    tracker.last_bytes = bytes;
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        metrics_[job_id] = metrics;
+    }
+    updateProgress(job_id, metrics.progress, metrics.message);
+    sendEvent(job_id, "metrics", metrics.toJson());
+}
+
+void JobManager::reportMerge(const JobId& job_id, IngestTracker& tracker, size_t merged,
+                             size_t total, const EnhancedSessionCorrelator& correlator) {
+    auto now = std::chrono::steady_clock::now();
+    if (merged < total && now - tracker.last_report < kProgressInterval) {
+        return;
+    }
+    tracker.last_report = now;
+
+    // Packet and byte counters are final by now; only the merge moves
+    JobMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        metrics = metrics_[job_id];
+    }
+    metrics.elapsed_sec = std::chrono::duration<double>(now - tracker.start).count();
+    metrics.packets_per_sec = 0.0;
+    metrics.mbps = 0.0;
+    metrics.sessions_open = correlator.getSessionCount() + correlator.getSipOnlySessionCount();
+    metrics.memory_rss_bytes = utils::currentRssBytes();
+    metrics.progress = total > 0 ? 65 + static_cast<int>(merged * 5 / total) : 70;
+    metrics.message =
+        "Merging shard output (" + std::to_string(merged) + "/" + std::to_string(total) + ")";
+
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        metrics_[job_id] = metrics;
+    }
+    updateProgress(job_id, metrics.progress, metrics.message);
+    sendEvent(job_id, "metrics", metrics.toJson());
 }
 
 void JobManager::updateProgress(const JobId& job_id, int progress, const std::string& message) {
@@ -637,12 +845,18 @@ void JobManager::updateProgress(const JobId& job_id, int progress, const std::st
         std::lock_guard<std::mutex> lock(jobs_mutex_);
         auto it = jobs_.find(job_id);
         if (it != jobs_.end()) {
+            int previous = it->second->progress;
             it->second->progress = progress;
 
-            if (db_ && (progress % 10 == 0 || progress == 100)) {  // Don't update DB too often
+            // Don't update DB too often: only when crossing a 10% step
+            if (db_ && (progress / 10 != previous / 10 || progress == 100)) {
                 db_->updateJob(job_id, *it->second);
             }
         }
+
+        auto& metrics = metrics_[job_id];
+        metrics.progress = progress;
+        metrics.message = message;
     }
 
     if (progress_callback_) {
@@ -0,0 +1,304 @@
+#include "api_server/session_index.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "api_server/session_summary.h"
+#include "common/logger.h"
+
+namespace callflow {
+
+// ============================================================================
+// SessionIndex
+// ============================================================================
+
+std::string SessionIndex::sidecarPath(const std::string& result_file) {
+    return result_file + ".idx";
+}
+
+void SessionIndex::add(const std::string& id, const Entry& entry) {
+    if (!id.empty()) {
+        entries_[id] = entry;
+    }
+}
+
+const SessionIndex::Entry* SessionIndex::find(const std::string& id) const {
+    auto it = entries_.find(id);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+bool SessionIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    for (const auto& [id, entry] : entries_) {
+        out << entry.offset << ' ' << entry.length << ' ' << id << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<SessionIndex> SessionIndex::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return nullptr;
+    }
+
+    auto index = std::make_shared<SessionIndex>();
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Entry entry;
+        std::string id;
+        if (!(fields >> entry.offset >> entry.length) || !std::getline(fields >> std::ws, id)) {
+            LOG_WARN("Malformed session index " << path << ", ignoring it");
+            return nullptr;
+        }
+        index->entries_[id] = entry;
+    }
+    return index;
+}
+
+nlohmann::json SessionIndex::readSession(const std::string& result_file, const Entry& entry) {
+    std::ifstream in(result_file, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open result file: " + result_file);
+    }
+    std::string buffer(entry.length, '\0');
+    in.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!in.read(buffer.data(), static_cast<std::streamsize>(entry.length))) {
+        throw std::runtime_error("Session range beyond end of " + result_file);
+    }
+    return nlohmann::json::parse(buffer);
+}
+
+// ============================================================================
+// SessionResultWriter
+// ============================================================================
+
+bool SessionResultWriter::open(const std::string& result_file, const nlohmann::json& metadata) {
+    result_file_ = result_file;
+    index_ = SessionIndex();
+    summary_ = std::make_shared<SessionSummaryTable>();
+    return writer_.open(result_file, metadata);
+}
+
+void SessionResultWriter::addSession(const nlohmann::json& session) {
+    auto range = writer_.writeSession(session);
+
+    SessionIndex::Entry entry{range.offset, range.length};
+    if (summary_) {
+        summary_->add(session, entry);
+    }
+    if (session.is_object()) {
+        auto session_id = session.find("session_id");
+        if (session_id != session.end() && session_id->is_string()) {
+            index_.add(session_id->get<std::string>(), entry);
+        }
+        auto master_id = session.find("master_id");
+        if (master_id != session.end() && master_id->is_string()) {
+            index_.add(master_id->get<std::string>(), entry);
+        }
+    }
+}
+
+bool SessionResultWriter::close() {
+    if (!writer_.close()) {
+        return false;
+    }
+    if (!index_.save(SessionIndex::sidecarPath(result_file_))) {
+        LOG_WARN("Failed to write session index for " << result_file_);
+        return false;
+    }
+    if (summary_ && !summary_->save(SessionSummaryTable::sidecarPath(result_file_))) {
+        LOG_WARN("Failed to write session summary for " << result_file_);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SessionStore
+// ============================================================================
+
+SessionStore::SessionStore(size_t max_cached_sessions, size_t max_cached_summaries,
+                           size_t max_cached_indexes)
+    : max_cached_sessions_(max_cached_sessions > 0 ? max_cached_sessions : 1),
+      max_cached_summaries_(max_cached_summaries > 0 ? max_cached_summaries : 1),
+      max_cached_indexes_(max_cached_indexes > 0 ? max_cached_indexes : 1) {}
+
+std::shared_ptr<const nlohmann::json> SessionStore::find(const JobInfo& job,
+                                                         const std::string& session_id,
+                                                         bool allow_full_scan) {
+    CacheKey key = job.job_id + '\n' + session_id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    std::shared_ptr<const nlohmann::json> session;
+    if (auto index = indexFor(job)) {
+        const SessionIndex::Entry* entry = index->find(session_id);
+        if (!entry) {
+            return nullptr;
+        }
+        session = std::make_shared<const nlohmann::json>(
+            SessionIndex::readSession(job.output_filename, *entry));
+    } else if (allow_full_scan) {
+        session = scanResultFile(job, session_id);
+    }
+
+    if (session) {
+        remember(key, session);
+    }
+    return session;
+}
+
+void SessionStore::invalidateJob(const std::string& job_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto index = indexes_.find(job_id);
+    if (index != indexes_.end()) {
+        index_lru_.erase(index->second);
+        indexes_.erase(index);
+    }
+    auto summary = summaries_.find(job_id);
+    if (summary != summaries_.end()) {
+        summary_lru_.erase(summary->second);
+        summaries_.erase(summary);
+    }
+    std::string prefix = job_id + '\n';
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) {
+            cache_.erase(it->first);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::shared_ptr<SessionIndex> SessionStore::indexFor(const JobInfo& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = indexes_.find(job.job_id);
+        if (it != indexes_.end()) {
+            index_lru_.splice(index_lru_.begin(), index_lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Loaded outside the lock; a concurrent load of the same index is harmless
+    auto index = SessionIndex::load(SessionIndex::sidecarPath(job.output_filename));
+    if (index) {
+        LOG_DEBUG("Loaded session index for job " << job.job_id << " (" << index->size()
+                                                  << " keys)");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = indexes_.find(job.job_id);
+    if (it != indexes_.end()) {
+        // Loaded concurrently; keep the first copy
+        index_lru_.splice(index_lru_.begin(), index_lru_, it->second);
+        return it->second->second;
+    }
+    index_lru_.emplace_front(job.job_id, index);
+    indexes_[job.job_id] = index_lru_.begin();
+    while (index_lru_.size() > max_cached_indexes_) {
+        indexes_.erase(index_lru_.back().first);
+        index_lru_.pop_back();
+    }
+    return index;
+}
+
+std::shared_ptr<const SessionSummaryTable> SessionStore::summaryFor(const JobInfo& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = summaries_.find(job.job_id);
+        if (it != summaries_.end()) {
+            summary_lru_.splice(summary_lru_.begin(), summary_lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Loaded outside the lock, like the index. A missing summary is not
+    // remembered: the sidecar may still appear, and the lookup is one failed open
+    std::shared_ptr<const SessionSummaryTable> summary =
+        SessionSummaryTable::load(SessionSummaryTable::sidecarPath(job.output_filename));
+    if (!summary) {
+        return nullptr;
+    }
+    LOG_DEBUG("Loaded session summary for job " << job.job_id << " (" << summary->size()
+                                                << " sessions)");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = summaries_.find(job.job_id);
+    if (it != summaries_.end()) {
+        // Loaded concurrently; keep the first copy
+        summary_lru_.splice(summary_lru_.begin(), summary_lru_, it->second);
+        return it->second->second;
+    }
+    summary_lru_.emplace_front(job.job_id, summary);
+    summaries_[job.job_id] = summary_lru_.begin();
+    while (summary_lru_.size() > max_cached_summaries_) {
+        summaries_.erase(summary_lru_.back().first);
+        summary_lru_.pop_back();
+    }
+    return summary;
+}
+
+std::shared_ptr<const nlohmann::json> SessionStore::scanResultFile(const JobInfo& job,
+                                                                   const std::string& session_id) {
+    if (!std::filesystem::exists(job.output_filename)) {
+        LOG_ERROR("Output file does not exist: " << job.output_filename);
+        return nullptr;
+    }
+
+    std::ifstream infile(job.output_filename);
+    if (!infile) {
+        LOG_ERROR("Failed to open output file: " << job.output_filename);
+        return nullptr;
+    }
+
+    nlohmann::json full_results;
+    try {
+        infile >> full_results;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to parse JSON file: " << e.what());
+        return nullptr;
+    }
+
+    if (!full_results.contains("sessions") || !full_results["sessions"].is_array()) {
+        LOG_ERROR("JSON file for job " << job.job_id << " has no sessions array.");
+        return nullptr;
+    }
+
+    for (auto& session : full_results["sessions"]) {
+        if (session.value("master_id", "") == session_id ||
+            session.value("session_id", "") == session_id) {
+            return std::make_shared<const nlohmann::json>(std::move(session));
+        }
+    }
+    return nullptr;
+}
+
+void SessionStore::remember(const CacheKey& key, std::shared_ptr<const nlohmann::json> session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.emplace_front(key, std::move(session));
+    cache_[key] = lru_.begin();
+    while (lru_.size() > max_cached_sessions_) {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace callflow
@@ -0,0 +1,437 @@
+#include "api_server/session_summary.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+
+#include "common/logger.h"
+
+namespace callflow {
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'F', 'S', 'U', 'M', 0, 0, 1};
+
+template <typename T>
+void writeColumn(std::ofstream& out, const std::vector<T>& column) {
+    out.write(reinterpret_cast<const char*>(column.data()),
+              static_cast<std::streamsize>(column.size() * sizeof(T)));
+}
+
+template <typename T>
+void writeValue(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Bounds-checked reader over a loaded sidecar
+ */
+class Reader {
+public:
+    explicit Reader(const std::string& data) : data_(data) {}
+
+    template <typename T>
+    bool value(T& out) {
+        if (data_.size() - pos_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&out, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool column(std::vector<T>& out, size_t rows) {
+        if (rows > (data_.size() - pos_) / sizeof(T)) {
+            return false;
+        }
+        out.resize(rows);
+        std::memcpy(out.data(), data_.data() + pos_, rows * sizeof(T));
+        pos_ += rows * sizeof(T);
+        return true;
+    }
+
+    bool bytes(std::string& out, size_t len) {
+        if (data_.size() - pos_ < len) {
+            return false;
+        }
+        out.assign(data_, pos_, len);
+        pos_ += len;
+        return true;
+    }
+
+    bool atEnd() const { return pos_ == data_.size(); }
+
+private:
+    const std::string& data_;
+    size_t pos_ = 0;
+};
+
+std::string stringField(const nlohmann::json& session, const char* name) {
+    auto it = session.find(name);
+    return it != session.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+template <typename T>
+T numberField(const nlohmann::json& object, const char* name) {
+    auto it = object.find(name);
+    return it != object.end() && it->is_number() ? it->get<T>() : T{};
+}
+
+}  // namespace
+
+std::string SessionSummaryTable::sidecarPath(const std::string& result_file) {
+    return result_file + ".sum";
+}
+
+bool SessionSummaryTable::parseSortKey(const std::string& name, SortKey& key) {
+    static const std::pair<const char*, SortKey> kNames[] = {
+        {"start_time", SortKey::START_TIME}, {"end_time", SortKey::END_TIME},
+        {"duration", SortKey::DURATION},     {"events", SortKey::EVENTS},
+        {"packets", SortKey::PACKETS},       {"bytes", SortKey::BYTES},
+    };
+    for (const auto& [key_name, value] : kNames) {
+        if (name == key_name) {
+            key = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+SessionSummaryTable::StrRef SessionSummaryTable::intern(std::string_view value) {
+    StrRef ref{static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(value.size())};
+    arena_.append(value);
+    return ref;
+}
+
+uint8_t SessionSummaryTable::typeCode(const std::string& type) {
+    auto it = std::find(types_.begin(), types_.end(), type);
+    if (it != types_.end()) {
+        return static_cast<uint8_t>(it - types_.begin());
+    }
+    if (types_.size() == 256) {
+        return 0;  // Dictionary full; never expected with the exporter's session types
+    }
+    types_.push_back(type);
+    type_counts_.push_back(0);
+    return static_cast<uint8_t>(types_.size() - 1);
+}
+
+void SessionSummaryTable::add(const nlohmann::json& session, const SessionIndex::Entry& range) {
+    if (!session.is_object()) {
+        return;
+    }
+
+    std::string id = stringField(session, "session_id");
+    if (id.empty()) {
+        id = stringField(session, "master_id");
+    }
+    std::string type = stringField(session, "session_type");
+    if (type.empty()) {
+        type = "MASTER";  // Correlated sessions carry no explicit type
+    }
+
+    uint8_t code = typeCode(type);
+    type_counts_[code]++;
+
+    id_.push_back(intern(id));
+    type_.push_back(code);
+    start_time_.push_back(numberField<int64_t>(session, "start_time"));
+    end_time_.push_back(numberField<int64_t>(session, "end_time"));
+    imsi_.push_back(intern(stringField(session, "imsi")));
+    msisdn_.push_back(intern(stringField(session, "msisdn")));
+
+    auto events = session.find("events");
+    events_.push_back(events != session.end() && events->is_array()
+                          ? static_cast<uint32_t>(events->size())
+                          : 0);
+    auto metrics = session.find("metrics");
+    bool has_metrics = metrics != session.end() && metrics->is_object();
+    packets_.push_back(has_metrics ? numberField<uint64_t>(*metrics, "packets") : 0);
+    bytes_.push_back(has_metrics ? numberField<uint64_t>(*metrics, "bytes") : 0);
+
+    offset_.push_back(range.offset);
+    length_.push_back(range.length);
+}
+
+bool SessionSummaryTable::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    out.write(kMagic, sizeof(kMagic));
+    writeValue<uint64_t>(out, size());
+    writeValue<uint64_t>(out, arena_.size());
+    writeValue<uint32_t>(out, static_cast<uint32_t>(types_.size()));
+    for (const auto& type : types_) {
+        writeValue<uint32_t>(out, static_cast<uint32_t>(type.size()));
+        out.write(type.data(), static_cast<std::streamsize>(type.size()));
+    }
+
+    writeColumn(out, id_);
+    writeColumn(out, type_);
+    writeColumn(out, start_time_);
+    writeColumn(out, end_time_);
+    writeColumn(out, imsi_);
+    writeColumn(out, msisdn_);
+    writeColumn(out, events_);
+    writeColumn(out, packets_);
+    writeColumn(out, bytes_);
+    writeColumn(out, offset_);
+    writeColumn(out, length_);
+    out.write(arena_.data(), static_cast<std::streamsize>(arena_.size()));
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<SessionSummaryTable> SessionSummaryTable::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    auto table = std::make_shared<SessionSummaryTable>();
+    Reader reader(data);
+    char magic[sizeof(kMagic)];
+    uint64_t rows = 0;
+    uint64_t arena_size = 0;
+    uint32_t type_count = 0;
+    bool ok = reader.value(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+              reader.value(rows) && reader.value(arena_size) && reader.value(type_count) &&
+              type_count <= 256 && rows <= UINT32_MAX;
+    for (uint32_t t = 0; ok && t < type_count; ++t) {
+        uint32_t len = 0;
+        std::string type;
+        ok = reader.value(len) && reader.bytes(type, len);
+        table->types_.push_back(std::move(type));
+    }
+    ok = ok && reader.column(table->id_, rows) && reader.column(table->type_, rows) &&
+         reader.column(table->start_time_, rows) && reader.column(table->end_time_, rows) &&
+         reader.column(table->imsi_, rows) && reader.column(table->msisdn_, rows) &&
+         reader.column(table->events_, rows) && reader.column(table->packets_, rows) &&
+         reader.column(table->bytes_, rows) && reader.column(table->offset_, rows) &&
+         reader.column(table->length_, rows) && reader.bytes(table->arena_, arena_size) &&
+         reader.atEnd();
+
+    if (ok) {
+        auto inArena = [&](StrRef ref) {
+            return static_cast<uint64_t>(ref.offset) + ref.length <= arena_size;
+        };
+        table->type_counts_.assign(type_count, 0);
+        for (size_t row = 0; ok && row < rows; ++row) {
+            ok = table->type_[row] < type_count && inArena(table->id_[row]) &&
+                 inArena(table->imsi_[row]) && inArena(table->msisdn_[row]);
+            if (ok) {
+                table->type_counts_[table->type_[row]]++;
+            }
+        }
+    }
+
+    if (!ok) {
+        LOG_WARN("Malformed session summary " << path << ", ignoring it");
+        return nullptr;
+    }
+    return table;
+}
+
+int64_t SessionSummaryTable::sortValue(SortKey key, uint32_t row) const {
+    switch (key) {
+        case SortKey::START_TIME:
+            return start_time_[row];
+        case SortKey::END_TIME:
+            return end_time_[row];
+        case SortKey::DURATION:
+            return std::max<int64_t>(0, end_time_[row] - start_time_[row]);
+        case SortKey::EVENTS:
+            return events_[row];
+        case SortKey::PACKETS:
+            return static_cast<int64_t>(packets_[row]);
+        case SortKey::BYTES:
+            return static_cast<int64_t>(bytes_[row]);
+    }
+    return 0;
+}
+
+const std::vector<uint32_t>& SessionSummaryTable::sortedBy(SortKey key) const {
+    size_t k = static_cast<size_t>(key);
+    std::call_once(sort_once_[k], [&] {
+        auto& order = sorted_[k];
+        order.resize(size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            int64_t va = sortValue(key, a);
+            int64_t vb = sortValue(key, b);
+            return va < vb || (va == vb && a < b);
+        });
+    });
+    return sorted_[k];
+}
+
+const std::vector<uint32_t>& SessionSummaryTable::sortedByString(
+    const std::vector<StrRef>& column, std::vector<uint32_t>& order, std::once_flag& once) const {
+    std::call_once(once, [&] {
+        order.resize(size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return str(column[a]) < str(column[b]);
+        });
+    });
+    return order;
+}
+
+std::vector<uint32_t> SessionSummaryTable::rowsWithString(const std::vector<StrRef>& column,
+                                                          const std::vector<uint32_t>& order,
+                                                          const std::string& value) const {
+    std::string_view needle(value);
+    auto first = std::lower_bound(order.begin(), order.end(), needle,
+                                  [&](uint32_t row, std::string_view v) {
+                                      return str(column[row]) < v;
+                                  });
+    auto last = std::upper_bound(first, order.end(), needle,
+                                 [&](std::string_view v, uint32_t row) {
+                                     return v < str(column[row]);
+                                 });
+    // stable_sort kept equal strings in row order
+    return std::vector<uint32_t>(first, last);
+}
+
+SessionSummaryTable::Page SessionSummaryTable::query(const Query& query) const {
+    Page page;
+
+    int type_filter = -1;
+    if (!query.type.empty()) {
+        auto it = std::find(types_.begin(), types_.end(), query.type);
+        if (it == types_.end()) {
+            return page;
+        }
+        type_filter = static_cast<int>(it - types_.begin());
+    }
+
+    bool have_cursor = !query.cursor.empty();
+    int64_t cursor_value = 0;
+    uint32_t cursor_row = 0;
+    if (have_cursor) {
+        size_t sep = query.cursor.find(':');
+        try {
+            if (sep == std::string::npos) {
+                throw std::invalid_argument("missing separator");
+            }
+            cursor_value = std::stoll(query.cursor.substr(0, sep));
+            cursor_row = static_cast<uint32_t>(std::stoul(query.cursor.substr(sep + 1)));
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Malformed cursor: " + query.cursor);
+        }
+    }
+
+    const SortKey key = query.sort;
+    auto less = [&](uint32_t a, uint32_t b) {
+        int64_t va = sortValue(key, a);
+        int64_t vb = sortValue(key, b);
+        return va < vb || (va == vb && a < b);
+    };
+
+    // Candidate rows in ascending (key, row) order; type filtering is left to
+    // the page scan only for the full-table order
+    std::vector<uint32_t> candidates;
+    const std::vector<uint32_t>* order = nullptr;
+    bool scan_filters_type = false;
+    if (!query.imsi.empty() || !query.msisdn.empty()) {
+        if (!query.imsi.empty()) {
+            candidates = rowsWithString(imsi_, sortedByString(imsi_, by_imsi_, imsi_once_),
+                                        query.imsi);
+        }
+        if (!query.msisdn.empty()) {
+            auto rows = rowsWithString(msisdn_, sortedByString(msisdn_, by_msisdn_, msisdn_once_),
+                                       query.msisdn);
+            if (query.imsi.empty()) {
+                candidates = std::move(rows);
+            } else {
+                std::vector<uint32_t> both;
+                std::set_intersection(candidates.begin(), candidates.end(), rows.begin(),
+                                      rows.end(), std::back_inserter(both));
+                candidates = std::move(both);
+            }
+        }
+        if (type_filter >= 0) {
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [&](uint32_t row) {
+                                                return type_[row] != type_filter;
+                                            }),
+                             candidates.end());
+        }
+        std::sort(candidates.begin(), candidates.end(), less);
+        order = &candidates;
+        page.total = candidates.size();
+    } else {
+        order = &sortedBy(key);
+        scan_filters_type = type_filter >= 0;
+        page.total = scan_filters_type ? type_counts_[type_filter] : size();
+    }
+
+    const size_t n = order->size();
+    auto at = [&](size_t i) { return query.descending ? (*order)[n - 1 - i] : (*order)[i]; };
+    auto matches = [&](uint32_t row) { return !scan_filters_type || type_[row] == type_filter; };
+
+    size_t i = 0;
+    if (have_cursor) {
+        auto beforeCursor = [&](uint32_t row) {
+            int64_t v = sortValue(key, row);
+            return v < cursor_value || (v == cursor_value && row < cursor_row);
+        };
+        auto notAfterCursor = [&](uint32_t row) {
+            int64_t v = sortValue(key, row);
+            return v < cursor_value || (v == cursor_value && row <= cursor_row);
+        };
+        if (query.descending) {
+            // Rows strictly before the cursor in ascending order come next
+            i = n - static_cast<size_t>(std::partition_point(order->begin(), order->end(),
+                                                             beforeCursor) -
+                                        order->begin());
+        } else {
+            i = static_cast<size_t>(
+                std::partition_point(order->begin(), order->end(), notAfterCursor) -
+                order->begin());
+        }
+    } else if (!scan_filters_type) {
+        i = std::min(query.offset, n);
+    } else {
+        for (size_t skipped = 0; i < n && skipped < query.offset; ++i) {
+            skipped += matches(at(i));
+        }
+    }
+
+    for (; i < n && page.rows.size() < query.limit; ++i) {
+        uint32_t row = at(i);
+        if (matches(row)) {
+            page.rows.push_back(row);
+        }
+    }
+
+    // With a type filter on the full order the remaining rows may all be of
+    // other types; the client then gets one final empty page
+    if (i < n && !page.rows.empty()) {
+        uint32_t last = page.rows.back();
+        page.next_cursor = std::to_string(sortValue(key, last)) + ":" + std::to_string(last);
+    }
+    return page;
+}
+
+nlohmann::json SessionSummaryTable::rowToJson(uint32_t row) const {
+    return {{"session_id", std::string(sessionId(row))},
+            {"session_type", std::string(type(row))},
+            {"imsi", std::string(imsi(row))},
+            {"msisdn", std::string(msisdn(row))},
+            {"start_time", start_time_[row]},
+            {"end_time", end_time_[row]},
+            {"duration_ms", sortValue(SortKey::DURATION, row)},
+            {"event_count", events_[row]},
+            {"packets", packets_[row]},
+            {"bytes", bytes_[row]}};
+}
+
+}  // namespace callflow
@@ -6,6 +6,7 @@
 #include "event_extractor/json_exporter.h"
 #include "pcap_ingest/packet_processor.h"
 #include "pcap_ingest/pcap_reader.h"
+#include "pcap_ingest/sharded_packet_processor.h"
 #include "pcap_ingest/pcapng_reader.h"
 #include "persistence/database.h"  // Moved out of ifdef as it's used in main now
 #include "protocol_parsers/diameter_parser.h"
@@ -44,7 +45,8 @@ void processPcap(const std::string& input_file, const std::string& output_file,
     LOG_INFO("Processing " << (is_pcapng ? "PCAPNG" : "PCAP") << " file: " << input_file);
 
     EnhancedSessionCorrelator correlator;  // New correlator
-    PacketProcessor processor(correlator);
+    ShardedPacketProcessor processor(correlator, static_cast<size_t>(config.worker_threads),
+                                     config.max_packet_queue_size);
 
     size_t packet_count = 0;
     size_t total_bytes = 0;
@@ -60,6 +62,8 @@ void processPcap(const std::string& input_file, const std::string& output_file,
             LOG_ERROR("Failed to open PCAPNG file: " << input_file);
             return;
         }
+        processor.setStableInput(reader.isMemoryMapped());
+        ShardAbortGuard shard_guard(processor);
 
         auto callback = [&](uint32_t interface_id, uint64_t timestamp_ns, const uint8_t* data,
                             uint32_t cap_len, uint32_t orig_len, const PcapngPacketMetadata& meta) {
@@ -84,6 +88,7 @@ void processPcap(const std::string& input_file, const std::string& output_file,
         };
 
         reader.processPackets(callback);
+        processor.finish();  // Shards may still read from the mapping
 
     } else {
         PcapReader reader;
@@ -91,6 +96,8 @@ void processPcap(const std::string& input_file, const std::string& output_file,
             LOG_ERROR("Failed to open PCAP file: " << input_file);
             return;
         }
+        processor.setStableInput(reader.isMemoryMapped());
+        ShardAbortGuard shard_guard(processor);
 
         int dlt = reader.getDatalinkType();
 
@@ -112,6 +119,7 @@ void processPcap(const std::string& input_file, const std::string& output_file,
         };
 
         reader.processPackets(callback);
+        processor.finish();
         reader.close();
     }
 
@@ -140,6 +148,14 @@ void processPcap(const std::string& input_file, const std::string& output_file,
     std::cout << "Throughput: " << (packet_count * 1000.0 / duration_ms) << " pps\n";
     std::cout << "Output file: " << output_file << "\n";
 
+    // Per-shard ingest throughput
+    auto shard_stats = processor.getShardStats();
+    std::cout << "\nIngest shards: " << shard_stats.size() << "\n";
+    for (const auto& shard : shard_stats) {
+        std::cout << "  shard " << shard.shard_id << ": " << shard.packets << " packets, "
+                  << static_cast<uint64_t>(shard.packetsPerSecond()) << " pps\n";
+    }
+
     // Session breakdown
     std::map<EnhancedSessionType, size_t> session_types;
     for (const auto& session : sessions) {
@@ -312,6 +328,7 @@ int main(int argc, char** argv) {
             }
             // Load config similarly to API mode so we have settings
             Config config;
+            config.worker_threads = args.worker_threads;
             if (!args.config_file.empty()) {
                 ConfigLoader loader;
                 if (!loader.loadFromFile(args.config_file, config)) {
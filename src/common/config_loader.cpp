@@ -134,6 +134,9 @@ void ConfigLoader::parseConfig(const nlohmann::json& j, Config& config) {
         if (processing.contains("packet_queue_size")) {
             config.max_packet_queue_size = processing["packet_queue_size"];
         }
+        if (processing.contains("arena_chunk_kb")) {
+            config.arena_chunk_kb = processing["arena_chunk_kb"];
+        }
         if (processing.contains("flow_timeout_sec")) {
             config.flow_timeout_sec = processing["flow_timeout_sec"];
         }
@@ -190,6 +193,12 @@ void ConfigLoader::parseConfig(const nlohmann::json& j, Config& config) {
         if (db.contains("retention_days")) {
             config.database.retention_days = db["retention_days"];
         }
+        if (db.contains("batch_size")) {
+            config.database.batch_size = db["batch_size"];
+        }
+        if (db.contains("writer_queue_max")) {
+            config.database.writer_queue_max = db["writer_queue_max"];
+        }
     }
 
     // UE Keys for NAS Decryption
@@ -232,6 +241,7 @@ nlohmann::json ConfigLoader::configToJson(const Config& config) {
     // Processing settings
     j["processing"] = {{"worker_threads", config.worker_threads},
                        {"packet_queue_size", config.max_packet_queue_size},
+                       {"arena_chunk_kb", config.arena_chunk_kb},
                        {"flow_timeout_sec", config.flow_timeout_sec}};
 
     // Storage settings
@@ -249,7 +259,9 @@ nlohmann::json ConfigLoader::configToJson(const Config& config) {
     // Database settings
     j["database"] = {{"enabled", config.database.enabled},
                      {"path", config.database.path},
-                     {"retention_days", config.database.retention_days}};
+                     {"retention_days", config.database.retention_days},
+                     {"batch_size", config.database.batch_size},
+                     {"writer_queue_max", config.database.writer_queue_max}};
 
     // UE Keys
     j["ue_keys"] = nlohmann::json::array();
@@ -0,0 +1,91 @@
+#include "common/job_arena.h"
+
+namespace callflow {
+
+void* JobArena::ChunkSource::do_allocate(size_t bytes, size_t alignment) {
+    void* chunk = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    this->bytes += bytes;
+    chunks++;
+    return chunk;
+}
+
+void JobArena::ChunkSource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    this->bytes -= bytes;
+}
+
+bool JobArena::ChunkSource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+JobArena::JobArena(size_t initial_chunk) : buffer_(initial_chunk, &chunks_) {}
+
+JobArena::~JobArena() {
+    releaseLarge();
+}
+
+ArenaStats JobArena::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ArenaStats result = stats_;
+    result.bytes_reserved = chunks_.bytes + large_bytes_;
+    result.chunks = chunks_.chunks;
+    return result;
+}
+
+void JobArena::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    releaseLarge();
+    free_lists_.fill(nullptr);
+    buffer_.release();
+}
+
+void JobArena::releaseLarge() {
+    for (const auto& [p, block] : large_blocks_) {
+        std::pmr::new_delete_resource()->deallocate(p, block.bytes, block.alignment);
+    }
+    large_blocks_.clear();
+    large_bytes_ = 0;
+}
+
+void* JobArena::do_allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.allocations++;
+    stats_.bytes_allocated += bytes;
+
+    if (bytes > kLargestArenaBlock || alignment > kGrain) {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        large_blocks_.emplace(p, LargeBlock{bytes, alignment});
+        large_bytes_ += bytes;
+        return p;
+    }
+
+    size_t size_class = sizeClass(bytes);
+    if (void* p = free_lists_[size_class]) {
+        free_lists_[size_class] = *static_cast<void**>(p);
+        return p;
+    }
+    return buffer_.allocate(size_class * kGrain, kGrain);
+}
+
+void JobArena::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.bytes_freed += bytes;
+
+    if (bytes > kLargestArenaBlock || alignment > kGrain) {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        large_blocks_.erase(p);
+        large_bytes_ -= bytes;
+        return;
+    }
+
+    // The block's first word links it into the free list for its size
+    size_t size_class = sizeClass(bytes);
+    *static_cast<void**>(p) = free_lists_[size_class];
+    free_lists_[size_class] = p;
+}
+
+bool JobArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+}  // namespace callflow
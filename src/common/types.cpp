@@ -1,10 +1,23 @@
 #include "common/types.h"
 
+#include <arpa/inet.h>
+
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
 namespace callflow {
 
+std::string packetIdToString(PacketId id) {
+    // xxxxxxxx-0000-0000-0000-xxxxxxxxxxxx: job tag, then frame number
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%08x-0000-0000-0000-%012llx",
+                  static_cast<unsigned>(id >> 32),
+                  static_cast<unsigned long long>(id & 0xFFFFFFFFULL));
+    return buf;
+}
+
 // Direction conversions
 std::string directionToString(Direction dir) {
     switch (dir) {
@@ -309,6 +322,92 @@ std::string messageTypeToString(MessageType type) {
     }
 }
 
+// IpAddress methods
+namespace {
+
+inline size_t mixHash(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+}
+
+}  // namespace
+
+IpAddress IpAddress::fromV4(const uint8_t* addr) {
+    IpAddress ip;
+    std::memcpy(ip.bytes.data(), addr, 4);
+    ip.family = Family::V4;
+    return ip;
+}
+
+IpAddress IpAddress::fromV6(const uint8_t* addr) {
+    IpAddress ip;
+    std::memcpy(ip.bytes.data(), addr, 16);
+    ip.family = Family::V6;
+    return ip;
+}
+
+IpAddress IpAddress::fromString(const std::string& text) {
+    IpAddress ip;
+    if (inet_pton(AF_INET, text.c_str(), ip.bytes.data()) == 1) {
+        ip.family = Family::V4;
+    } else if (inet_pton(AF_INET6, text.c_str(), ip.bytes.data()) == 1) {
+        ip.family = Family::V6;
+    } else {
+        ip.bytes.fill(0);
+    }
+    return ip;
+}
+
+std::string IpAddress::toString() const {
+    char buf[INET6_ADDRSTRLEN];
+    switch (family) {
+        case Family::V4:
+            return inet_ntop(AF_INET, bytes.data(), buf, sizeof(buf)) ? buf : "";
+        case Family::V6:
+            return inet_ntop(AF_INET6, bytes.data(), buf, sizeof(buf)) ? buf : "";
+        default:
+            return "";
+    }
+}
+
+size_t IpAddress::hash() const {
+    uint64_t hi;
+    uint64_t lo;
+    std::memcpy(&hi, bytes.data(), 8);
+    std::memcpy(&lo, bytes.data() + 8, 8);
+    return mixHash(hi ^ mixHash(lo ^ static_cast<uint64_t>(family)));
+}
+
+std::ostream& operator<<(std::ostream& os, const IpAddress& addr) {
+    return os << addr.toString();
+}
+
+// FlowKey methods
+std::string FlowKey::toString() const {
+    return toFiveTuple().toString();
+}
+
+size_t FlowKey::hash() const {
+    uint64_t ports = (static_cast<uint64_t>(src_port) << 24) |
+                     (static_cast<uint64_t>(dst_port) << 8) | protocol;
+    return mixHash(src_ip.hash() ^ (dst_ip.hash() * 31) ^ ports);
+}
+
+FiveTuple FlowKey::toFiveTuple() const {
+    FiveTuple ft;
+    ft.src_ip = src_ip.toString();
+    ft.dst_ip = dst_ip.toString();
+    ft.src_port = src_port;
+    ft.dst_port = dst_port;
+    ft.protocol = protocol;
+    return ft;
+}
+
 // FiveTuple methods
 bool FiveTuple::operator==(const FiveTuple& other) const {
     return src_ip == other.src_ip && dst_ip == other.dst_ip && src_port == other.src_port &&
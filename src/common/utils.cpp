@@ -1,8 +1,10 @@
 #include "common/utils.h"
 
 #include <arpa/inet.h>
+#include <unistd.h>
 
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <random>
 #include <sstream>
@@ -138,6 +140,17 @@ int64_t timeDiffMs(const std::chrono::system_clock::time_point& start,
     return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 }
 
+uint64_t currentRssBytes() {
+    // Second field of /proc/self/statm is the resident page count
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size_pages = 0;
+    uint64_t resident_pages = 0;
+    if (!(statm >> size_pages >> resident_pages)) {
+        return 0;
+    }
+    return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
 std::string sanitizeString(const std::string& str) {
     std::ostringstream oss;
     for (char c : str) {
@@ -400,7 +400,7 @@ std::optional<std::string> DiameterMessage::extractFromSubscriptionId(Subscripti
         if (!sub_id_avp) continue;
 
         // Get grouped AVPs
-        auto grouped = sub_id_avp->getGroupedAVPs();
+        const auto* grouped = sub_id_avp->groupedAVPs();
         if (!grouped) continue;
 
         // Find Subscription-Id-Type and Subscription-Id-Data
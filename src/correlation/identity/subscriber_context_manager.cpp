@@ -15,13 +15,69 @@ namespace correlation {
 // SubscriberContextManager - Core Methods
 // ============================================================================
 
-SubscriberContextManager::ContextPtr SubscriberContextManager::createContext() {
+SubscriberContextManager::ContextId SubscriberContextManager::createContext() {
     auto context = std::make_shared<SubscriberIdentity>();
     context->first_seen = std::chrono::steady_clock::now();
     context->last_seen = context->first_seen;
-    contexts_.push_back(context);
-    stats_.total_contexts++;
-    return context;
+
+    auto id = static_cast<ContextId>(contexts_.size());
+    contexts_.push_back(std::move(context));
+    parent_.push_back(id);
+    set_size_.push_back(1);
+    live_contexts_++;
+    return id;
+}
+
+SubscriberContextManager::ContextId SubscriberContextManager::find(ContextId id) {
+    // Path halving: point every other node on the path at its grandparent
+    while (parent_[id] != id) {
+        parent_[id] = parent_[parent_[id]];
+        id = parent_[id];
+    }
+    return id;
+}
+
+SubscriberContextManager::ContextId SubscriberContextManager::root(ContextId id) const {
+    // Union by size keeps trees O(log n) deep without compression
+    while (parent_[id] != id) {
+        id = parent_[id];
+    }
+    return id;
+}
+
+template <typename Key>
+SubscriberContextManager::ContextId SubscriberContextManager::lookup(
+    const std::unordered_map<Key, ContextId>& index, const Key& key) {
+    auto it = index.find(key);
+    return (it != index.end()) ? find(it->second) : kNoContext;
+}
+
+template <typename Key>
+SubscriberContextManager::ContextPtr SubscriberContextManager::findIn(
+    const std::unordered_map<Key, ContextId>& index, const Key& key) const {
+    auto it = index.find(key);
+    return (it != index.end()) ? contexts_[root(it->second)] : nullptr;
+}
+
+template <typename Key>
+SubscriberContextManager::ContextId SubscriberContextManager::joinOnKey(
+    std::unordered_map<Key, ContextId>& index, const Key& key, ContextId id) {
+    auto [it, inserted] = index.try_emplace(key, id);
+    if (inserted) {
+        return find(id);
+    }
+    // The context that holds the key first stays primary
+    return mergeContexts(it->second, id);
+}
+
+template <typename Key>
+void SubscriberContextManager::unindex(std::unordered_map<Key, ContextId>& index, const Key& key,
+                                       ContextId id) {
+    // A key another subscriber has taken over since is left alone
+    auto it = index.find(key);
+    if (it != index.end() && find(it->second) == find(id)) {
+        index.erase(it);
+    }
 }
 
 std::string SubscriberContextManager::normalizeForIndex(const std::string& msisdn) const {
@@ -59,60 +115,87 @@ std::string SubscriberContextManager::normalizeImeiForIndex(const std::string& i
     return digits;
 }
 
-void SubscriberContextManager::updateIndices(ContextPtr context) {
-    if (context->imsi) {
-        imsi_index_[context->imsi->digits] = context;
-        stats_.contexts_with_imsi++;
+// ============================================================================
+// SubscriberContextManager - Identifier Attachment
+// ============================================================================
+
+void SubscriberContextManager::attachImsi(ContextId id, const std::string& imsi,
+                                          const std::string& normalized) {
+    // A replaced IMSI must no longer resolve to this subscriber
+    const auto& previous = contexts_[id]->imsi;
+    if (previous && previous->digits != normalized) {
+        unindex(imsi_index_, previous->digits, id);
     }
-    if (context->msisdn) {
-        msisdn_index_[context->msisdn->national] = context;
-        stats_.contexts_with_msisdn++;
+    auto normalized_imsi = ImsiNormalizer::normalize(imsi);
+    if (normalized_imsi) {
+        contexts_[id]->imsi = *normalized_imsi;
+    } else {
+        // Create minimal IMSI structure
+        contexts_[id]->imsi = NormalizedImsi{imsi, normalized, "", "", ""};
     }
-    if (context->imei) {
-        imei_index_[context->imei->imei] = context;
-        stats_.contexts_with_imei++;
+    imsi_index_[normalized] = id;
+}
+
+void SubscriberContextManager::attachMsisdn(ContextId id, const std::string& msisdn,
+                                            const std::string& normalized) {
+    const auto& previous = contexts_[id]->msisdn;
+    if (previous && previous->national != normalized) {
+        unindex(msisdn_index_, previous->national, id);
     }
-    if (context->tmsi) {
-        tmsi_index_[*context->tmsi] = context;
+    contexts_[id]->msisdn = MsisdnNormalizer::normalize(msisdn);
+    msisdn_index_[normalized] = id;
+}
+
+void SubscriberContextManager::attachImei(ContextId id, const std::string& imei,
+                                          const std::string& normalized) {
+    auto normalized_imei = ImeiNormalizer::normalize(imei);
+    if (normalized_imei) {
+        contexts_[id]->imei = *normalized_imei;
+    } else {
+        // Create minimal IMEI structure
+        contexts_[id]->imei = NormalizedImei{imei, normalized, std::nullopt, "", ""};
     }
-    if (context->guti) {
-        guti_index_[context->guti->toString()] = context;
+    imei_index_[normalized] = id;
+}
+
+void SubscriberContextManager::attachUeIp(ContextId id, const std::string& ip) {
+    NetworkEndpoint endpoint;
+    if (ip.find(':') != std::string::npos) {
+        endpoint.ipv6 = ip;
+    } else {
+        endpoint.ipv4 = ip;
     }
-    for (const auto& ep : context->endpoints) {
-        if (!ep.ipv4.empty()) {
-            ip_index_[ep.ipv4] = context;
-            stats_.contexts_with_ue_ip++;
-        }
-        if (!ep.ipv6.empty()) {
-            ip_index_[ep.ipv6] = context;
-            stats_.contexts_with_ue_ip++;
+    contexts_[id]->endpoints.push_back(endpoint);
+    ip_index_[ip] = id;
+}
+
+void SubscriberContextManager::attachGuti(ContextId id, const Guti4G& guti,
+                                          const std::string& guti_str) {
+    contexts_[id]->guti = guti;
+    guti_index_[guti_str] = id;
+
+    // GUTI M-TMSI equal to a known TMSI: same subscriber
+    if (guti.m_tmsi) {
+        guti_tmsi_index_[guti.m_tmsi] = id;
+        auto tmsi_it = tmsi_index_.find(guti.m_tmsi);
+        if (tmsi_it != tmsi_index_.end()) {
+            mergeContexts(id, tmsi_it->second);
         }
     }
 }
 
-void SubscriberContextManager::removeFromIndices(ContextPtr context) {
-    if (context->imsi) {
-        imsi_index_.erase(context->imsi->digits);
+void SubscriberContextManager::attachTmsi(ContextId id, uint32_t tmsi) {
+    // TMSI reallocation: the old value may be handed to another UE
+    const auto& previous = contexts_[id]->tmsi;
+    if (previous && *previous != tmsi) {
+        unindex(tmsi_index_, *previous, id);
     }
-    if (context->msisdn) {
-        msisdn_index_.erase(context->msisdn->national);
-    }
-    if (context->imei) {
-        imei_index_.erase(context->imei->imei);
-    }
-    if (context->tmsi) {
-        tmsi_index_.erase(*context->tmsi);
-    }
-    if (context->guti) {
-        guti_index_.erase(context->guti->toString());
-    }
-    for (const auto& ep : context->endpoints) {
-        if (!ep.ipv4.empty()) {
-            ip_index_.erase(ep.ipv4);
-        }
-        if (!ep.ipv6.empty()) {
-            ip_index_.erase(ep.ipv6);
-        }
+    contexts_[id]->tmsi = tmsi;
+    tmsi_index_[tmsi] = id;
+
+    auto guti_it = guti_tmsi_index_.find(tmsi);
+    if (guti_it != guti_tmsi_index_.end()) {
+        mergeContexts(guti_it->second, id);
     }
 }
 
@@ -125,22 +208,12 @@ SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByImsi
     std::unique_lock lock(mutex_);
 
     std::string normalized = normalizeImsiForIndex(imsi);
-    auto it = imsi_index_.find(normalized);
-    if (it != imsi_index_.end()) {
-        return it->second;
+    ContextId id = lookup(imsi_index_, normalized);
+    if (id == kNoContext) {
+        id = createContext();
+        attachImsi(id, imsi, normalized);
     }
-
-    auto context = createContext();
-    auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-    if (normalized_imsi) {
-        context->imsi = *normalized_imsi;
-    } else {
-        // Create minimal IMSI structure
-        context->imsi = NormalizedImsi{imsi, normalized, "", "", ""};
-    }
-    imsi_index_[normalized] = context;
-    stats_.contexts_with_imsi++;
-    return context;
+    return contexts_[id];
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByMsisdn(
@@ -148,16 +221,12 @@ SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByMsis
     std::unique_lock lock(mutex_);
 
     std::string normalized = normalizeForIndex(msisdn);
-    auto it = msisdn_index_.find(normalized);
-    if (it != msisdn_index_.end()) {
-        return it->second;
+    ContextId id = lookup(msisdn_index_, normalized);
+    if (id == kNoContext) {
+        id = createContext();
+        attachMsisdn(id, msisdn, normalized);
     }
-
-    auto context = createContext();
-    context->msisdn = MsisdnNormalizer::normalize(msisdn);
-    msisdn_index_[normalized] = context;
-    stats_.contexts_with_msisdn++;
-    return context;
+    return contexts_[id];
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByImei(
@@ -165,44 +234,24 @@ SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByImei
     std::unique_lock lock(mutex_);
 
     std::string normalized = normalizeImeiForIndex(imei);
-    auto it = imei_index_.find(normalized);
-    if (it != imei_index_.end()) {
-        return it->second;
-    }
-
-    auto context = createContext();
-    auto normalized_imei = ImeiNormalizer::normalize(imei);
-    if (normalized_imei) {
-        context->imei = *normalized_imei;
-    } else {
-        // Create minimal IMEI structure
-        context->imei = NormalizedImei{imei, normalized, std::nullopt, "", ""};
+    ContextId id = lookup(imei_index_, normalized);
+    if (id == kNoContext) {
+        id = createContext();
+        attachImei(id, imei, normalized);
     }
-    imei_index_[normalized] = context;
-    stats_.contexts_with_imei++;
-    return context;
+    return contexts_[id];
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByUeIp(
     const std::string& ip) {
     std::unique_lock lock(mutex_);
 
-    auto it = ip_index_.find(ip);
-    if (it != ip_index_.end()) {
-        return it->second;
+    ContextId id = lookup(ip_index_, ip);
+    if (id == kNoContext) {
+        id = createContext();
+        attachUeIp(id, ip);
     }
-
-    auto context = createContext();
-    NetworkEndpoint endpoint;
-    if (ip.find(':') != std::string::npos) {
-        endpoint.ipv6 = ip;
-    } else {
-        endpoint.ipv4 = ip;
-    }
-    context->endpoints.push_back(endpoint);
-    ip_index_[ip] = context;
-    stats_.contexts_with_ue_ip++;
-    return context;
+    return contexts_[id];
 }
 
 // ============================================================================
@@ -212,99 +261,110 @@ SubscriberContextManager::ContextPtr SubscriberContextManager::getOrCreateByUeIp
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByImsi(
     const std::string& imsi) const {
     std::shared_lock lock(mutex_);
-
-    std::string normalized = normalizeImsiForIndex(imsi);
-    auto it = imsi_index_.find(normalized);
-    return (it != imsi_index_.end()) ? it->second : nullptr;
+    return findIn(imsi_index_, normalizeImsiForIndex(imsi));
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByMsisdn(
     const std::string& msisdn) const {
     std::shared_lock lock(mutex_);
-
-    std::string normalized = normalizeForIndex(msisdn);
-    auto it = msisdn_index_.find(normalized);
-    return (it != msisdn_index_.end()) ? it->second : nullptr;
+    return findIn(msisdn_index_, normalizeForIndex(msisdn));
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByImei(
     const std::string& imei) const {
     std::shared_lock lock(mutex_);
-
-    std::string normalized = normalizeImeiForIndex(imei);
-    auto it = imei_index_.find(normalized);
-    return (it != imei_index_.end()) ? it->second : nullptr;
+    return findIn(imei_index_, normalizeImeiForIndex(imei));
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByUeIp(
     const std::string& ip) const {
     std::shared_lock lock(mutex_);
-
-    auto it = ip_index_.find(ip);
-    return (it != ip_index_.end()) ? it->second : nullptr;
+    return findIn(ip_index_, ip);
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByGuti(
     const Guti4G& guti) const {
     std::shared_lock lock(mutex_);
-
-    auto it = guti_index_.find(guti.toString());
-    return (it != guti_index_.end()) ? it->second : nullptr;
+    return findIn(guti_index_, guti.toString());
 }
 
 SubscriberContextManager::ContextPtr SubscriberContextManager::findByTmsi(uint32_t tmsi) const {
     std::shared_lock lock(mutex_);
-
-    auto it = tmsi_index_.find(tmsi);
-    return (it != tmsi_index_.end()) ? it->second : nullptr;
+    return findIn(tmsi_index_, tmsi);
 }
 
 // ============================================================================
 // SubscriberContextManager - Linking Methods
 // ============================================================================
 
-void SubscriberContextManager::mergeContexts(ContextPtr primary, ContextPtr secondary) {
-    // Remove secondary from indices first to avoid conflicts
-    removeFromIndices(secondary);
+SubscriberContextManager::ContextId SubscriberContextManager::mergeContexts(ContextId a,
+                                                                            ContextId b) {
+    ContextId root_a = find(a);
+    ContextId root_b = find(b);
+    if (root_a == root_b) {
+        return root_a;
+    }
 
+    ContextPtr primary = contexts_[root_a];
+    mergeIdentity(*primary, *contexts_[root_b]);
+
+    // Union by size decides which id stays the root; the primary context
+    // object is moved to it so existing holders of that pointer stay current
+    ContextId new_root = root_a;
+    ContextId child = root_b;
+    if (set_size_[root_a] < set_size_[root_b]) {
+        std::swap(new_root, child);
+    }
+    parent_[child] = new_root;
+    set_size_[new_root] += set_size_[child];
+    contexts_[child] = nullptr;
+    contexts_[new_root] = std::move(primary);
+
+    live_contexts_--;
+    merge_operations_++;
+    return new_root;
+}
+
+void SubscriberContextManager::mergeIdentity(SubscriberIdentity& primary,
+                                             const SubscriberIdentity& secondary) {
     // Merge identifiers from secondary into primary
-    if (!primary->imsi && secondary->imsi) {
-        primary->imsi = secondary->imsi;
+    if (!primary.imsi && secondary.imsi) {
+        primary.imsi = secondary.imsi;
     }
-    if (!primary->msisdn && secondary->msisdn) {
-        primary->msisdn = secondary->msisdn;
+    if (!primary.msisdn && secondary.msisdn) {
+        primary.msisdn = secondary.msisdn;
     }
-    if (!primary->imei && secondary->imei) {
-        primary->imei = secondary->imei;
+    if (!primary.imei && secondary.imei) {
+        primary.imei = secondary.imei;
     }
-    if (!primary->guti && secondary->guti) {
-        primary->guti = secondary->guti;
+    if (!primary.guti && secondary.guti) {
+        primary.guti = secondary.guti;
     }
-    if (!primary->tmsi && secondary->tmsi) {
-        primary->tmsi = secondary->tmsi;
+    if (!primary.tmsi && secondary.tmsi) {
+        primary.tmsi = secondary.tmsi;
     }
-    if (!primary->p_tmsi && secondary->p_tmsi) {
-        primary->p_tmsi = secondary->p_tmsi;
+    if (!primary.p_tmsi && secondary.p_tmsi) {
+        primary.p_tmsi = secondary.p_tmsi;
     }
-    if (!primary->guti_5g && secondary->guti_5g) {
-        primary->guti_5g = secondary->guti_5g;
+    if (!primary.guti_5g && secondary.guti_5g) {
+        primary.guti_5g = secondary.guti_5g;
     }
-    if (!primary->tmsi_5g && secondary->tmsi_5g) {
-        primary->tmsi_5g = secondary->tmsi_5g;
+    if (!primary.tmsi_5g && secondary.tmsi_5g) {
+        primary.tmsi_5g = secondary.tmsi_5g;
     }
 
     // Merge APN information
-    if (primary->apn.empty() && !secondary->apn.empty()) {
-        primary->apn = secondary->apn;
+    if (primary.apn.empty() && !secondary.apn.empty()) {
+        primary.apn = secondary.apn;
     }
-    if (primary->pdn_type.empty() && !secondary->pdn_type.empty()) {
-        primary->pdn_type = secondary->pdn_type;
+    if (primary.pdn_type.empty() && !secondary.pdn_type.empty()) {
+        primary.pdn_type = secondary.pdn_type;
     }
 
     // Merge endpoints (avoid duplicates)
-    for (const auto& ep : secondary->endpoints) {
+    for (const auto& ep : secondary.endpoints) {
         bool duplicate = false;
-        for (const auto& existing_ep : primary->endpoints) {
+        for (const auto& existing_ep : primary.endpoints) {
             if ((ep.ipv4 == existing_ep.ipv4 && !ep.ipv4.empty()) ||
                 (ep.ipv6 == existing_ep.ipv6 && !ep.ipv6.empty())) {
                 duplicate = true;
@@ -312,33 +372,25 @@ void SubscriberContextManager::mergeContexts(ContextPtr primary, ContextPtr seco
             }
         }
         if (!duplicate) {
-            primary->endpoints.push_back(ep);
+            primary.endpoints.push_back(ep);
         }
     }
 
     // Merge confidence scores (keep highest)
-    for (const auto& [key, score] : secondary->confidence) {
-        if (primary->confidence.find(key) == primary->confidence.end() ||
-            primary->confidence[key] < score) {
-            primary->confidence[key] = score;
+    for (const auto& [key, score] : secondary.confidence) {
+        if (primary.confidence.find(key) == primary.confidence.end() ||
+            primary.confidence[key] < score) {
+            primary.confidence[key] = score;
         }
     }
 
     // Update timestamps
-    if (secondary->first_seen < primary->first_seen) {
-        primary->first_seen = secondary->first_seen;
+    if (secondary.first_seen < primary.first_seen) {
+        primary.first_seen = secondary.first_seen;
     }
-    if (secondary->last_seen > primary->last_seen) {
-        primary->last_seen = secondary->last_seen;
+    if (secondary.last_seen > primary.last_seen) {
+        primary.last_seen = secondary.last_seen;
     }
-
-    // Update all indices to point to primary
-    updateIndices(primary);
-
-    // Remove secondary from contexts list
-    contexts_.erase(std::remove(contexts_.begin(), contexts_.end(), secondary), contexts_.end());
-
-    stats_.merge_operations++;
 }
 
 void SubscriberContextManager::linkImsiMsisdn(const std::string& imsi, const std::string& msisdn) {
@@ -347,44 +399,21 @@ void SubscriberContextManager::linkImsiMsisdn(const std::string& imsi, const std
     std::string norm_imsi = normalizeImsiForIndex(imsi);
     std::string norm_msisdn = normalizeForIndex(msisdn);
 
-    auto imsi_it = imsi_index_.find(norm_imsi);
-    auto msisdn_it = msisdn_index_.find(norm_msisdn);
-
-    ContextPtr imsi_ctx = (imsi_it != imsi_index_.end()) ? imsi_it->second : nullptr;
-    ContextPtr msisdn_ctx = (msisdn_it != msisdn_index_.end()) ? msisdn_it->second : nullptr;
+    ContextId imsi_ctx = lookup(imsi_index_, norm_imsi);
+    ContextId msisdn_ctx = lookup(msisdn_index_, norm_msisdn);
 
-    if (imsi_ctx && msisdn_ctx) {
-        if (imsi_ctx != msisdn_ctx) {
-            // Different contexts - merge them
-            mergeContexts(imsi_ctx, msisdn_ctx);
-        }
-        // Same context - nothing to do
-    } else if (imsi_ctx && !msisdn_ctx) {
-        // Add MSISDN to existing IMSI context
-        removeFromIndices(imsi_ctx);  // Temporarily remove to update
-        imsi_ctx->msisdn = MsisdnNormalizer::normalize(msisdn);
-        updateIndices(imsi_ctx);
-    } else if (!imsi_ctx && msisdn_ctx) {
-        // Add IMSI to existing MSISDN context
-        removeFromIndices(msisdn_ctx);
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            msisdn_ctx->imsi = *normalized_imsi;
-        } else {
-            msisdn_ctx->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        updateIndices(msisdn_ctx);
+    if (imsi_ctx != kNoContext && msisdn_ctx != kNoContext) {
+        // Different contexts are merged; the same context is left as is
+        mergeContexts(imsi_ctx, msisdn_ctx);
+    } else if (imsi_ctx != kNoContext) {
+        attachMsisdn(imsi_ctx, msisdn, norm_msisdn);
+    } else if (msisdn_ctx != kNoContext) {
+        attachImsi(msisdn_ctx, imsi, norm_imsi);
     } else {
         // Create new context with both identifiers
-        auto context = createContext();
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            context->imsi = *normalized_imsi;
-        } else {
-            context->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        context->msisdn = MsisdnNormalizer::normalize(msisdn);
-        updateIndices(context);
+        ContextId id = createContext();
+        attachImsi(id, imsi, norm_imsi);
+        attachMsisdn(id, msisdn, norm_msisdn);
     }
 }
 
@@ -394,49 +423,19 @@ void SubscriberContextManager::linkImsiImei(const std::string& imsi, const std::
     std::string norm_imsi = normalizeImsiForIndex(imsi);
     std::string norm_imei = normalizeImeiForIndex(imei);
 
-    auto imsi_it = imsi_index_.find(norm_imsi);
-    auto imei_it = imei_index_.find(norm_imei);
-
-    ContextPtr imsi_ctx = (imsi_it != imsi_index_.end()) ? imsi_it->second : nullptr;
-    ContextPtr imei_ctx = (imei_it != imei_index_.end()) ? imei_it->second : nullptr;
+    ContextId imsi_ctx = lookup(imsi_index_, norm_imsi);
+    ContextId imei_ctx = lookup(imei_index_, norm_imei);
 
-    if (imsi_ctx && imei_ctx) {
-        if (imsi_ctx != imei_ctx) {
-            mergeContexts(imsi_ctx, imei_ctx);
-        }
-    } else if (imsi_ctx && !imei_ctx) {
-        removeFromIndices(imsi_ctx);
-        auto normalized_imei = ImeiNormalizer::normalize(imei);
-        if (normalized_imei) {
-            imsi_ctx->imei = *normalized_imei;
-        } else {
-            imsi_ctx->imei = NormalizedImei{imei, norm_imei, std::nullopt, "", ""};
-        }
-        updateIndices(imsi_ctx);
-    } else if (!imsi_ctx && imei_ctx) {
-        removeFromIndices(imei_ctx);
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            imei_ctx->imsi = *normalized_imsi;
-        } else {
-            imei_ctx->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        updateIndices(imei_ctx);
+    if (imsi_ctx != kNoContext && imei_ctx != kNoContext) {
+        mergeContexts(imsi_ctx, imei_ctx);
+    } else if (imsi_ctx != kNoContext) {
+        attachImei(imsi_ctx, imei, norm_imei);
+    } else if (imei_ctx != kNoContext) {
+        attachImsi(imei_ctx, imsi, norm_imsi);
     } else {
-        auto context = createContext();
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        auto normalized_imei = ImeiNormalizer::normalize(imei);
-        if (normalized_imsi) {
-            context->imsi = *normalized_imsi;
-        } else {
-            context->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        if (normalized_imei) {
-            context->imei = *normalized_imei;
-        } else {
-            context->imei = NormalizedImei{imei, norm_imei, std::nullopt, "", ""};
-        }
-        updateIndices(context);
+        ContextId id = createContext();
+        attachImsi(id, imsi, norm_imsi);
+        attachImei(id, imei, norm_imei);
     }
 }
 
@@ -445,40 +444,19 @@ void SubscriberContextManager::linkMsisdnUeIp(const std::string& msisdn, const s
 
     std::string norm_msisdn = normalizeForIndex(msisdn);
 
-    auto msisdn_it = msisdn_index_.find(norm_msisdn);
-    auto ip_it = ip_index_.find(ip);
-
-    ContextPtr msisdn_ctx = (msisdn_it != msisdn_index_.end()) ? msisdn_it->second : nullptr;
-    ContextPtr ip_ctx = (ip_it != ip_index_.end()) ? ip_it->second : nullptr;
+    ContextId msisdn_ctx = lookup(msisdn_index_, norm_msisdn);
+    ContextId ip_ctx = lookup(ip_index_, ip);
 
-    if (msisdn_ctx && ip_ctx) {
-        if (msisdn_ctx != ip_ctx) {
-            mergeContexts(msisdn_ctx, ip_ctx);
-        }
-    } else if (msisdn_ctx && !ip_ctx) {
-        NetworkEndpoint endpoint;
-        if (ip.find(':') != std::string::npos) {
-            endpoint.ipv6 = ip;
-        } else {
-            endpoint.ipv4 = ip;
-        }
-        msisdn_ctx->endpoints.push_back(endpoint);
-        ip_index_[ip] = msisdn_ctx;
-    } else if (!msisdn_ctx && ip_ctx) {
-        removeFromIndices(ip_ctx);
-        ip_ctx->msisdn = MsisdnNormalizer::normalize(msisdn);
-        updateIndices(ip_ctx);
+    if (msisdn_ctx != kNoContext && ip_ctx != kNoContext) {
+        mergeContexts(msisdn_ctx, ip_ctx);
+    } else if (msisdn_ctx != kNoContext) {
+        attachUeIp(msisdn_ctx, ip);
+    } else if (ip_ctx != kNoContext) {
+        attachMsisdn(ip_ctx, msisdn, norm_msisdn);
     } else {
-        auto context = createContext();
-        context->msisdn = MsisdnNormalizer::normalize(msisdn);
-        NetworkEndpoint endpoint;
-        if (ip.find(':') != std::string::npos) {
-            endpoint.ipv6 = ip;
-        } else {
-            endpoint.ipv4 = ip;
-        }
-        context->endpoints.push_back(endpoint);
-        updateIndices(context);
+        ContextId id = createContext();
+        attachMsisdn(id, msisdn, norm_msisdn);
+        attachUeIp(id, ip);
     }
 }
 
@@ -487,50 +465,19 @@ void SubscriberContextManager::linkImsiUeIp(const std::string& imsi, const std::
 
     std::string norm_imsi = normalizeImsiForIndex(imsi);
 
-    auto imsi_it = imsi_index_.find(norm_imsi);
-    auto ip_it = ip_index_.find(ip);
-
-    ContextPtr imsi_ctx = (imsi_it != imsi_index_.end()) ? imsi_it->second : nullptr;
-    ContextPtr ip_ctx = (ip_it != ip_index_.end()) ? ip_it->second : nullptr;
+    ContextId imsi_ctx = lookup(imsi_index_, norm_imsi);
+    ContextId ip_ctx = lookup(ip_index_, ip);
 
-    if (imsi_ctx && ip_ctx) {
-        if (imsi_ctx != ip_ctx) {
-            mergeContexts(imsi_ctx, ip_ctx);
-        }
-    } else if (imsi_ctx && !ip_ctx) {
-        NetworkEndpoint endpoint;
-        if (ip.find(':') != std::string::npos) {
-            endpoint.ipv6 = ip;
-        } else {
-            endpoint.ipv4 = ip;
-        }
-        imsi_ctx->endpoints.push_back(endpoint);
-        ip_index_[ip] = imsi_ctx;
-    } else if (!imsi_ctx && ip_ctx) {
-        removeFromIndices(ip_ctx);
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            ip_ctx->imsi = *normalized_imsi;
-        } else {
-            ip_ctx->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        updateIndices(ip_ctx);
+    if (imsi_ctx != kNoContext && ip_ctx != kNoContext) {
+        mergeContexts(imsi_ctx, ip_ctx);
+    } else if (imsi_ctx != kNoContext) {
+        attachUeIp(imsi_ctx, ip);
+    } else if (ip_ctx != kNoContext) {
+        attachImsi(ip_ctx, imsi, norm_imsi);
     } else {
-        auto context = createContext();
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            context->imsi = *normalized_imsi;
-        } else {
-            context->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        NetworkEndpoint endpoint;
-        if (ip.find(':') != std::string::npos) {
-            endpoint.ipv6 = ip;
-        } else {
-            endpoint.ipv4 = ip;
-        }
-        context->endpoints.push_back(endpoint);
-        updateIndices(context);
+        ContextId id = createContext();
+        attachImsi(id, imsi, norm_imsi);
+        attachUeIp(id, ip);
     }
 }
 
@@ -540,38 +487,19 @@ void SubscriberContextManager::linkImsiGuti(const std::string& imsi, const Guti4
     std::string norm_imsi = normalizeImsiForIndex(imsi);
     std::string guti_str = guti.toString();
 
-    auto imsi_it = imsi_index_.find(norm_imsi);
-    auto guti_it = guti_index_.find(guti_str);
+    ContextId imsi_ctx = lookup(imsi_index_, norm_imsi);
+    ContextId guti_ctx = lookup(guti_index_, guti_str);
 
-    ContextPtr imsi_ctx = (imsi_it != imsi_index_.end()) ? imsi_it->second : nullptr;
-    ContextPtr guti_ctx = (guti_it != guti_index_.end()) ? guti_it->second : nullptr;
-
-    if (imsi_ctx && guti_ctx) {
-        if (imsi_ctx != guti_ctx) {
-            mergeContexts(imsi_ctx, guti_ctx);
-        }
-    } else if (imsi_ctx && !guti_ctx) {
-        imsi_ctx->guti = guti;
-        guti_index_[guti_str] = imsi_ctx;
-    } else if (!imsi_ctx && guti_ctx) {
-        removeFromIndices(guti_ctx);
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            guti_ctx->imsi = *normalized_imsi;
-        } else {
-            guti_ctx->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        updateIndices(guti_ctx);
+    if (imsi_ctx != kNoContext && guti_ctx != kNoContext) {
+        mergeContexts(imsi_ctx, guti_ctx);
+    } else if (imsi_ctx != kNoContext) {
+        attachGuti(imsi_ctx, guti, guti_str);
+    } else if (guti_ctx != kNoContext) {
+        attachImsi(guti_ctx, imsi, norm_imsi);
     } else {
-        auto context = createContext();
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            context->imsi = *normalized_imsi;
-        } else {
-            context->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        context->guti = guti;
-        updateIndices(context);
+        ContextId id = createContext();
+        attachImsi(id, imsi, norm_imsi);
+        attachGuti(id, guti, guti_str);
     }
 }
 
@@ -580,38 +508,19 @@ void SubscriberContextManager::linkImsiTmsi(const std::string& imsi, uint32_t tm
 
     std::string norm_imsi = normalizeImsiForIndex(imsi);
 
-    auto imsi_it = imsi_index_.find(norm_imsi);
-    auto tmsi_it = tmsi_index_.find(tmsi);
-
-    ContextPtr imsi_ctx = (imsi_it != imsi_index_.end()) ? imsi_it->second : nullptr;
-    ContextPtr tmsi_ctx = (tmsi_it != tmsi_index_.end()) ? tmsi_it->second : nullptr;
+    ContextId imsi_ctx = lookup(imsi_index_, norm_imsi);
+    ContextId tmsi_ctx = lookup(tmsi_index_, tmsi);
 
-    if (imsi_ctx && tmsi_ctx) {
-        if (imsi_ctx != tmsi_ctx) {
-            mergeContexts(imsi_ctx, tmsi_ctx);
-        }
-    } else if (imsi_ctx && !tmsi_ctx) {
-        imsi_ctx->tmsi = tmsi;
-        tmsi_index_[tmsi] = imsi_ctx;
-    } else if (!imsi_ctx && tmsi_ctx) {
-        removeFromIndices(tmsi_ctx);
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            tmsi_ctx->imsi = *normalized_imsi;
-        } else {
-            tmsi_ctx->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        updateIndices(tmsi_ctx);
+    if (imsi_ctx != kNoContext && tmsi_ctx != kNoContext) {
+        mergeContexts(imsi_ctx, tmsi_ctx);
+    } else if (imsi_ctx != kNoContext) {
+        attachTmsi(imsi_ctx, tmsi);
+    } else if (tmsi_ctx != kNoContext) {
+        attachImsi(tmsi_ctx, imsi, norm_imsi);
     } else {
-        auto context = createContext();
-        auto normalized_imsi = ImsiNormalizer::normalize(imsi);
-        if (normalized_imsi) {
-            context->imsi = *normalized_imsi;
-        } else {
-            context->imsi = NormalizedImsi{imsi, norm_imsi, "", "", ""};
-        }
-        context->tmsi = tmsi;
-        updateIndices(context);
+        ContextId id = createContext();
+        attachImsi(id, imsi, norm_imsi);
+        attachTmsi(id, tmsi);
     }
 }
 
@@ -619,41 +528,33 @@ void SubscriberContextManager::addGtpuTunnel(const std::string& imsi_or_msisdn,
                                              const std::string& peer_ip, uint32_t teid) {
     std::unique_lock lock(mutex_);
 
-    // Try to find context by IMSI first
-    std::string norm_imsi = normalizeImsiForIndex(imsi_or_msisdn);
-    auto imsi_it = imsi_index_.find(norm_imsi);
-
-    ContextPtr context = nullptr;
-    if (imsi_it != imsi_index_.end()) {
-        context = imsi_it->second;
-    } else {
-        // Try MSISDN
-        std::string norm_msisdn = normalizeForIndex(imsi_or_msisdn);
-        auto msisdn_it = msisdn_index_.find(norm_msisdn);
-        if (msisdn_it != msisdn_index_.end()) {
-            context = msisdn_it->second;
-        }
+    // Try to find context by IMSI first, then MSISDN
+    ContextId id = lookup(imsi_index_, normalizeImsiForIndex(imsi_or_msisdn));
+    if (id == kNoContext) {
+        id = lookup(msisdn_index_, normalizeForIndex(imsi_or_msisdn));
+    }
+    if (id == kNoContext) {
+        return;
     }
 
-    if (context) {
-        // Add GTP-U tunnel info to endpoints
-        bool found = false;
-        for (auto& ep : context->endpoints) {
-            if (!ep.gtpu_peer_ip || !ep.gtpu_teid) {
-                ep.gtpu_peer_ip = peer_ip;
-                ep.gtpu_teid = teid;
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            // Create new endpoint with tunnel info
-            NetworkEndpoint ep;
+    // Add GTP-U tunnel info to endpoints
+    auto& context = contexts_[id];
+    bool found = false;
+    for (auto& ep : context->endpoints) {
+        if (!ep.gtpu_peer_ip || !ep.gtpu_teid) {
             ep.gtpu_peer_ip = peer_ip;
             ep.gtpu_teid = teid;
-            context->endpoints.push_back(ep);
+            found = true;
+            break;
         }
     }
+    if (!found) {
+        // Create new endpoint with tunnel info
+        NetworkEndpoint ep;
+        ep.gtpu_peer_ip = peer_ip;
+        ep.gtpu_teid = teid;
+        context->endpoints.push_back(ep);
+    }
 }
 
 // ============================================================================
@@ -661,64 +562,50 @@ void SubscriberContextManager::addGtpuTunnel(const std::string& imsi_or_msisdn,
 // ============================================================================
 
 void SubscriberContextManager::correlateByIpAddress() {
-    // Build IP to contexts mapping
-    std::unordered_map<std::string, std::vector<ContextPtr>> ip_to_contexts;
-
-    for (const auto& ctx : contexts_) {
-        for (const auto& ep : ctx->endpoints) {
-            if (!ep.ipv4.empty()) {
-                ip_to_contexts[ep.ipv4].push_back(ctx);
+    // Endpoints may have been added to a context directly rather than via a
+    // link call, so index every endpoint address and join contexts sharing
+    // one (IPv6 also by /64 prefix). Already-indexed addresses resolve to
+    // the same set and cost one lookup.
+    for (ContextId id = 0; id < contexts_.size(); ++id) {
+        ContextPtr context = contexts_[id];
+        if (!context) {
+            continue;
+        }
+        // Merging appends the other context's endpoints to this one, so
+        // iterate by index (those are already indexed)
+        for (size_t i = 0; i < context->endpoints.size(); ++i) {
+            std::string ipv4 = context->endpoints[i].ipv4;
+            std::string ipv6 = context->endpoints[i].ipv6;
+            if (!ipv4.empty()) {
+                joinOnKey(ip_index_, ipv4, id);
             }
-            if (!ep.ipv6.empty()) {
-                ip_to_contexts[ep.ipv6].push_back(ctx);
-                // Also index by /64 prefix for IPv6
-                std::string prefix = ep.getIpv6Prefix(64);
+            if (!ipv6.empty()) {
+                joinOnKey(ip_index_, ipv6, id);
+                std::string prefix = context->endpoints[i].getIpv6Prefix(64);
                 if (!prefix.empty()) {
-                    ip_to_contexts[prefix].push_back(ctx);
-                }
-            }
-        }
-    }
-
-    // Merge contexts that share IP addresses
-    for (const auto& [ip, ctxs] : ip_to_contexts) {
-        if (ctxs.size() > 1) {
-            auto primary = ctxs[0];
-            for (size_t i = 1; i < ctxs.size(); i++) {
-                if (primary != ctxs[i]) {
-                    mergeContexts(primary, ctxs[i]);
+                    joinOnKey(ipv6_prefix_index_, prefix, id);
                 }
             }
         }
     }
 }
 
-void SubscriberContextManager::correlateByGuti() {
-    // GUTI-based correlation: if GUTI m-TMSI matches TMSI, link them
-    for (const auto& ctx : contexts_) {
-        if (ctx->guti && ctx->guti->m_tmsi) {
-            auto tmsi_it = tmsi_index_.find(ctx->guti->m_tmsi);
-            if (tmsi_it != tmsi_index_.end() && tmsi_it->second != ctx) {
-                mergeContexts(ctx, tmsi_it->second);
-            }
-        }
-    }
-}
-
 void SubscriberContextManager::propagateIdentities() {
     std::unique_lock lock(mutex_);
 
     // Phase 1: IP-based correlation
     correlateByIpAddress();
 
-    // Phase 2: GUTI/TMSI correlation
-    correlateByGuti();
-
-    // Phase 3: Propagate missing identifiers within contexts
+    // Phase 2: Propagate missing identifiers within contexts
     // This handles cases where we have IMSI but not MSISDN, etc.
+    auto now = std::chrono::steady_clock::now();
     for (auto& ctx : contexts_) {
+        if (!ctx) {
+            continue;
+        }
+
         // Update last_seen timestamp
-        ctx->last_seen = std::chrono::steady_clock::now();
+        ctx->last_seen = now;
 
         // Calculate confidence scores based on completeness
         float completeness = 0.0f;
@@ -741,26 +628,54 @@ void SubscriberContextManager::propagateIdentities() {
 
 std::vector<SubscriberContextManager::ContextPtr> SubscriberContextManager::getAllContexts() const {
     std::shared_lock lock(mutex_);
-    return contexts_;
+
+    std::vector<ContextPtr> result;
+    result.reserve(live_contexts_);
+    for (const auto& ctx : contexts_) {
+        if (ctx) {
+            result.push_back(ctx);
+        }
+    }
+    return result;
 }
 
 SubscriberContextManager::Stats SubscriberContextManager::getStats() const {
     std::shared_lock lock(mutex_);
-    return stats_;
+
+    Stats stats;
+    stats.total_contexts = live_contexts_;
+    stats.merge_operations = merge_operations_;
+    for (const auto& ctx : contexts_) {
+        if (!ctx) {
+            continue;
+        }
+        stats.contexts_with_imsi += ctx->imsi.has_value();
+        stats.contexts_with_msisdn += ctx->msisdn.has_value();
+        stats.contexts_with_imei += ctx->imei.has_value();
+        stats.contexts_with_ue_ip += std::any_of(
+            ctx->endpoints.begin(), ctx->endpoints.end(),
+            [](const NetworkEndpoint& ep) { return !ep.ipv4.empty() || !ep.ipv6.empty(); });
+    }
+    return stats;
 }
 
 void SubscriberContextManager::clear() {
     std::unique_lock lock(mutex_);
 
     contexts_.clear();
+    parent_.clear();
+    set_size_.clear();
     imsi_index_.clear();
     msisdn_index_.clear();
     imei_index_.clear();
     ip_index_.clear();
+    ipv6_prefix_index_.clear();
     tmsi_index_.clear();
     guti_index_.clear();
+    guti_tmsi_index_.clear();
 
-    stats_ = Stats{};
+    live_contexts_ = 0;
+    merge_operations_ = 0;
 }
 
 // ============================================================================
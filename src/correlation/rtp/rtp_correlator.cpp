@@ -8,11 +8,12 @@ void RtpCorrelator::addPacket(const RtpPacketInfo& packet) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     stats_.total_packets++;
+    time_index_stale_ = true;
 
     auto it = streams_.find(packet.ssrc);
     if (it == streams_.end()) {
         // Create new stream
-        auto stream = std::make_unique<RtpStream>(packet);
+        auto stream = std::make_unique<RtpStream>(packet, retention_);
         updateIpIndex(stream.get());
         streams_[packet.ssrc] = std::move(stream);
         stats_.total_streams++;
@@ -27,6 +28,11 @@ void RtpCorrelator::finalize() {
     updateStats();
 }
 
+void RtpCorrelator::setPacketRetention(const RtpPacketRetention& retention) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retention_ = retention;
+}
+
 std::vector<RtpStream*> RtpCorrelator::getStreams() {
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -70,18 +76,19 @@ std::vector<RtpStream*> RtpCorrelator::findByIp(const std::string& ip) {
 std::vector<RtpStream*> RtpCorrelator::findByTimeWindow(double start, double end) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    std::vector<RtpStream*> result;
-
-    for (auto& pair : streams_) {
-        RtpStream* stream = pair.second.get();
-
-        // Check if stream overlaps with time window
-        // Stream overlaps if: stream_start <= window_end AND stream_end >= window_start
-        if (stream->getStartTime() <= end && stream->getEndTime() >= start) {
-            result.push_back(stream);
+    if (time_index_stale_) {
+        time_index_.clear();
+        for (auto& pair : streams_) {
+            RtpStream* stream = pair.second.get();
+            time_index_.add(stream->getStartTime(), stream->getEndTime(), stream);
         }
+        time_index_.build();
+        time_index_stale_ = false;
     }
 
+    // Stream overlaps if: stream_start <= window_end AND stream_end >= window_start
+    std::vector<RtpStream*> result;
+    time_index_.forEachOverlap(start, end, [&](RtpStream* stream) { result.push_back(stream); });
     return result;
 }
 
@@ -226,6 +233,8 @@ void RtpCorrelator::clear() {
     streams_.clear();
     ip_index_.clear();
     ue_ip_index_.clear();
+    time_index_.clear();
+    time_index_stale_ = true;
     stats_ = Stats();
 }
 
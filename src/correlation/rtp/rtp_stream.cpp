@@ -1,32 +1,40 @@
 #include "correlation/rtp/rtp_stream.h"
 #include <algorithm>
 #include <cmath>
-#include <set>
 
 namespace callflow {
 namespace correlation {
 
-RtpStream::RtpStream(const RtpPacketInfo& first_packet)
+RtpStream::RtpStream(const RtpPacketInfo& first_packet, const RtpPacketRetention& retention)
     : ssrc_(first_packet.ssrc),
       src_ip_(first_packet.src_ip),
       src_port_(first_packet.src_port),
       dst_ip_(first_packet.dst_ip),
       dst_port_(first_packet.dst_port),
+      retention_(retention),
       start_time_(first_packet.timestamp),
       end_time_(first_packet.timestamp),
       start_frame_(first_packet.frame_number),
       end_frame_(first_packet.frame_number),
-      payload_type_(first_packet.payload_type) {
+      payload_type_(first_packet.payload_type),
+      first_seq_(first_packet.sequence_number),
+      last_seq_(first_packet.sequence_number),
+      base_ext_seq_(first_packet.sequence_number),
+      max_ext_seq_(first_packet.sequence_number),
+      seen_window_(1),
+      interval_start_time_(first_packet.timestamp) {
 
     codec_name_ = detectCodecName(payload_type_);
     clock_rate_ = detectClockRate(payload_type_);
 
-    packets_.reserve(1000);  // Pre-allocate for typical call
-    addPacket(first_packet);
+    // The first packet seeds the sequence state above
+    retainPacket(first_packet);
+    packets_received_ = 1;
+    updateJitter(first_packet);
 }
 
 void RtpStream::addPacket(const RtpPacketInfo& packet) {
-    packets_.push_back(packet);
+    retainPacket(packet);
 
     // Update time window
     if (packet.timestamp < start_time_) {
@@ -38,10 +46,96 @@ void RtpStream::addPacket(const RtpPacketInfo& packet) {
         end_frame_ = packet.frame_number;
     }
 
+    // Close the loss interval before counting the packet into the next one
+    updateLossInterval(packet.timestamp);
+
+    packets_received_++;
+    last_seq_ = packet.sequence_number;
+    updateSequence(packet.sequence_number);
+
     // Update jitter calculation
     updateJitter(packet);
 }
 
+void RtpStream::retainPacket(const RtpPacketInfo& packet) {
+    switch (retention_.mode) {
+        case RtpPacketRetention::Mode::NONE:
+            return;
+        case RtpPacketRetention::Mode::FIRST_N:
+            if (packets_.size() >= retention_.max_packets) {
+                return;
+            }
+            break;
+        case RtpPacketRetention::Mode::SAMPLED:
+            if (packets_.size() >= retention_.max_packets || retention_.sample_interval == 0 ||
+                packets_received_ % retention_.sample_interval != 0) {
+                return;
+            }
+            break;
+        case RtpPacketRetention::Mode::ALL:
+            break;
+    }
+
+    RtpPacketSample sample;
+    sample.frame_number = packet.frame_number;
+    sample.timestamp = packet.timestamp;
+    sample.rtp_timestamp = packet.rtp_timestamp;
+    sample.sequence_number = packet.sequence_number;
+    sample.payload_type = packet.payload_type;
+    sample.marker = packet.marker;
+    sample.payload_size = static_cast<uint32_t>(packet.payload_size);
+    packets_.push_back(sample);
+}
+
+void RtpStream::updateSequence(uint16_t seq) {
+    // RFC 3550 Appendix A.1 (without source probation: the stream already
+    // exists, so its first packet is taken as valid)
+    uint16_t max_seq = static_cast<uint16_t>(max_ext_seq_);
+    uint16_t udelta = static_cast<uint16_t>(seq - max_seq);
+
+    if (udelta == 0) {
+        packets_duplicated_++;
+    } else if (udelta < kMaxDropout) {
+        // In order, with permissible gap
+        uint32_t ext_seq = max_ext_seq_ + udelta;
+        if ((ext_seq >> 16) != (max_ext_seq_ >> 16)) {
+            seq_cycles_++;
+        }
+        max_ext_seq_ = ext_seq;
+        seen_window_ = udelta >= 64 ? 1 : (seen_window_ << udelta) | 1;
+        bad_seq_ = kNoBadSeq;
+    } else if (udelta <= 65535 - kMaxMisorder) {
+        // The sequence number made a very large jump. Two sequential packets
+        // mean the sender restarted: keep what was expected so far and
+        // resync on the new numbering; otherwise ignore the jump.
+        if (seq == bad_seq_) {
+            expected_before_restart_ = expectedPackets();
+            base_ext_seq_ = seq;
+            max_ext_seq_ = seq;
+            seen_window_ = 1;
+            bad_seq_ = kNoBadSeq;
+        } else {
+            bad_seq_ = static_cast<uint16_t>(seq + 1);
+        }
+    } else {
+        // Duplicate or reordered packet behind the highest sequence number
+        uint16_t back = static_cast<uint16_t>(max_seq - seq);
+        if (back < 64 && (seen_window_ & (uint64_t{1} << back))) {
+            packets_duplicated_++;
+            return;
+        }
+        if (back < 64) {
+            seen_window_ |= uint64_t{1} << back;
+        }
+        packets_out_of_order_++;
+
+        // A late packet from before the first one extends the expected range
+        if (back <= max_ext_seq_ && max_ext_seq_ - back < base_ext_seq_) {
+            base_ext_seq_ = max_ext_seq_ - back;
+        }
+    }
+}
+
 void RtpStream::updateJitter(const RtpPacketInfo& packet) {
     if (!jitter_initialized_) {
         last_arrival_time_ = packet.timestamp;
@@ -73,10 +167,43 @@ void RtpStream::updateJitter(const RtpPacketInfo& packet) {
     // Update jitter estimate using exponential moving average
     jitter_estimate_ += (d - jitter_estimate_) / 16.0;
 
+    // Track the worst single delay variation and its distribution
+    max_delay_variation_ = std::max(max_delay_variation_, d);
+    double d_ms = d / clock_rate_ * 1000.0;
+    const auto& bounds = RtpQualityMetrics::kJitterBucketBoundsMs;
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), d_ms) - bounds.begin();
+    jitter_histogram_[bucket]++;
+
     last_arrival_time_ = current_arrival;
     last_rtp_timestamp_ = current_rtp_ts;
 }
 
+void RtpStream::updateLossInterval(double timestamp) {
+    if (timestamp - interval_start_time_ < RtpQualityMetrics::kLossIntervalSeconds) {
+        return;
+    }
+
+    // RFC 3550 Appendix A.3: loss over the interval from the change in the
+    // expected and received counts
+    uint32_t expected = expectedPackets();
+    uint32_t received = uniquePackets();
+    loss_histogram_[lossBucket(expected - interval_expected_prior_,
+                               received - interval_received_prior_)]++;
+
+    interval_expected_prior_ = expected;
+    interval_received_prior_ = received;
+    interval_start_time_ = timestamp;
+}
+
+size_t RtpStream::lossBucket(uint32_t expected, uint32_t received) {
+    double loss_percent = 0.0;
+    if (expected > received) {
+        loss_percent = 100.0 * (expected - received) / expected;
+    }
+    const auto& bounds = RtpQualityMetrics::kLossBucketBoundsPercent;
+    return std::lower_bound(bounds.begin(), bounds.end(), loss_percent) - bounds.begin();
+}
+
 bool RtpStream::isUeEndpoint(const std::string& ip) const {
     if (!ue_ip_.has_value()) {
         return false;
@@ -87,62 +214,28 @@ bool RtpStream::isUeEndpoint(const std::string& ip) const {
 RtpQualityMetrics RtpStream::calculateMetrics() const {
     RtpQualityMetrics metrics;
 
-    if (packets_.empty()) {
+    if (packets_received_ == 0) {
         return metrics;
     }
 
-    metrics.packets_received = packets_.size();
+    metrics.packets_received = packets_received_;
     metrics.payload_type = payload_type_;
     metrics.codec_name = codec_name_;
     metrics.clock_rate = clock_rate_;
 
-    // Sequence number analysis
-    std::set<uint16_t> seen_sequences;
-    std::vector<uint16_t> sequences;
-    sequences.reserve(packets_.size());
-
-    for (const auto& pkt : packets_) {
-        sequences.push_back(pkt.sequence_number);
-
-        if (seen_sequences.count(pkt.sequence_number)) {
-            metrics.packets_duplicated++;
-        } else {
-            seen_sequences.insert(pkt.sequence_number);
-        }
-    }
-
-    if (sequences.empty()) {
-        return metrics;
-    }
-
-    metrics.first_seq = sequences.front();
-    metrics.last_seq = sequences.back();
-
-    // Calculate expected packet count with sequence number wraparound handling
-    uint32_t expected_packets = 0;
-    uint16_t prev_seq = sequences[0];
-
-    for (size_t i = 1; i < sequences.size(); ++i) {
-        uint16_t curr_seq = sequences[i];
-
-        // Check for wraparound
-        if (curr_seq < prev_seq) {
-            // Sequence number wrapped around
-            metrics.seq_cycles++;
-            expected_packets += (65536 - prev_seq) + curr_seq;
-        } else {
-            expected_packets += (curr_seq - prev_seq);
-        }
-
-        prev_seq = curr_seq;
-    }
-
-    // Calculate packet loss
-    if (expected_packets > 0) {
-        int32_t lost = expected_packets - static_cast<uint32_t>(seen_sequences.size());
-        if (lost > 0) {
-            metrics.packets_lost = static_cast<uint32_t>(lost);
-        }
+    // Sequence number analysis (accumulated per packet)
+    metrics.packets_duplicated = packets_duplicated_;
+    metrics.packets_out_of_order = packets_out_of_order_;
+    metrics.first_seq = first_seq_;
+    metrics.last_seq = last_seq_;
+    metrics.seq_cycles = seq_cycles_;
+
+    // Calculate packet loss: expected from the extended sequence range
+    // minus distinct packets received
+    uint32_t expected_packets = expectedPackets();
+    uint32_t unique_packets = uniquePackets();
+    if (expected_packets > unique_packets) {
+        metrics.packets_lost = expected_packets - unique_packets;
     }
 
     // Calculate loss rate
@@ -152,41 +245,20 @@ RtpQualityMetrics RtpStream::calculateMetrics() const {
                                    static_cast<float>(total_expected);
     }
 
-    // Out of order detection
-    for (size_t i = 1; i < sequences.size(); ++i) {
-        uint16_t prev = sequences[i - 1];
-        uint16_t curr = sequences[i];
-
-        // Check if current is not exactly prev + 1 (accounting for wraparound)
-        uint16_t expected = prev + 1;
-        if (curr != expected && !(prev == 65535 && curr == 0)) {
-            if (curr < prev && !(prev > 60000 && curr < 5000)) {
-                // Out of order (not a wraparound)
-                metrics.packets_out_of_order++;
-            }
-        }
-    }
-
     // Jitter calculation (convert from RTP timestamp units to milliseconds)
     if (clock_rate_ > 0) {
         metrics.jitter_ms = (jitter_estimate_ / clock_rate_) * 1000.0;
+        metrics.max_jitter_ms = (max_delay_variation_ / clock_rate_) * 1000.0;
     }
 
-    // Calculate max jitter by checking all consecutive packet pairs
-    double max_jitter = 0.0;
-    for (size_t i = 1; i < packets_.size(); ++i) {
-        const auto& prev = packets_[i - 1];
-        const auto& curr = packets_[i];
-
-        double arrival_diff = curr.timestamp - prev.timestamp;
-        double rtp_diff = static_cast<double>(curr.rtp_timestamp - prev.rtp_timestamp) / clock_rate_;
-        double jitter = std::abs(arrival_diff - rtp_diff) * 1000.0;  // Convert to ms
-
-        if (jitter > max_jitter) {
-            max_jitter = jitter;
-        }
+    // Histograms, including the loss interval still in progress
+    metrics.jitter_histogram = jitter_histogram_;
+    metrics.loss_histogram = loss_histogram_;
+    uint32_t interval_expected = expected_packets - interval_expected_prior_;
+    if (interval_expected > 0) {
+        metrics.loss_histogram[lossBucket(interval_expected,
+                                          unique_packets - interval_received_prior_)]++;
     }
-    metrics.max_jitter_ms = max_jitter;
 
     // Calculate MOS estimate
     metrics.estimated_mos = calculateMos(metrics.packet_loss_rate, metrics.jitter_ms);
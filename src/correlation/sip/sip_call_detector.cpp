@@ -1,14 +1,44 @@
 #include "correlation/sip/sip_call_detector.h"
 
 #include <algorithm>
+#include <cctype>
 #include <optional>
-#include <regex>
-#include <sstream>
+#include <string_view>
 #include <vector>
 
+#include "protocol_parsers/sip_tokenizer.h"
+
 namespace callflow {
 namespace correlation {
 
+namespace {
+
+// View form of SipCallDetector::stripUriDelimiters()
+std::string_view stripDelimiters(std::string_view uri) {
+    std::string_view result = sip::trim(uri);
+
+    // Remove angle brackets: <sip:...> -> sip:...
+    if (!result.empty() && result.front() == '<') {
+        result.remove_prefix(1);
+    }
+    if (!result.empty() && result.back() == '>') {
+        result.remove_suffix(1);
+    }
+
+    // Remove display name: "Name" <sip:...> -> sip:...
+    size_t bracket_pos = result.find('<');
+    if (bracket_pos != std::string_view::npos) {
+        result.remove_prefix(bracket_pos + 1);
+        if (!result.empty() && result.back() == '>') {
+            result.remove_suffix(1);
+        }
+    }
+
+    return result;
+}
+
+}  // namespace
+
 SipSessionType SipCallDetector::detectSessionType(const std::vector<SipMessage>& messages) {
     if (messages.empty()) {
         return SipSessionType::UNKNOWN;
@@ -251,17 +281,8 @@ std::string SipCallDetector::extractUser(const std::string& uri) {
     }
 
     // Strip delimiters like <> and quotes
-    std::string clean_uri = stripUriDelimiters(uri);
-
     // Pattern: sip:user@host or sip:user@host:port
-    std::regex uri_regex(R"(sip:([^@]+)@)");
-    std::smatch match;
-
-    if (std::regex_search(clean_uri, match, uri_regex)) {
-        return match[1].str();
-    }
-
-    return "";
+    return std::string(sip::uriUser(stripDelimiters(uri)));
 }
 
 std::string SipCallDetector::extractHost(const std::string& uri) {
@@ -269,17 +290,8 @@ std::string SipCallDetector::extractHost(const std::string& uri) {
         return "";
     }
 
-    std::string clean_uri = stripUriDelimiters(uri);
-
     // Pattern: sip:user@host or sip:user@host:port
-    std::regex uri_regex(R"(sip:[^@]+@([^:;>]+))");
-    std::smatch match;
-
-    if (std::regex_search(clean_uri, match, uri_regex)) {
-        return match[1].str();
-    }
-
-    return "";
+    return std::string(sip::uriHost(stripDelimiters(uri)));
 }
 
 bool SipCallDetector::isEmergencyUrn(const std::string& uri) {
@@ -296,20 +308,15 @@ std::vector<SipMediaInfo> SipCallDetector::parseSdp(const std::string& sdp) {
     // a=rtpmap:0 PCMU/8000
     // a=rtpmap:8 PCMA/8000
 
-    std::istringstream iss(sdp);
-    std::string line;
+    sip::LineTokenizer lines(sdp);
+    std::string_view line;
     SipMediaInfo current_media;
     std::string connection_ip;
 
-    while (std::getline(iss, line)) {
-        if (line.empty())
+    while (lines.next(line)) {
+        if (line.size() < 2)
             continue;
 
-        // Remove trailing \r
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
-        }
-
         if (line[0] == 'm' && line[1] == '=') {
             // Save previous media if any
             if (!current_media.media_type.empty()) {
@@ -318,22 +325,27 @@ std::vector<SipMediaInfo> SipCallDetector::parseSdp(const std::string& sdp) {
 
             // Parse media line: m=<media> <port> <proto> <fmt> ...
             current_media = SipMediaInfo();
-            std::istringstream mline(line.substr(2));
-            mline >> current_media.media_type >> current_media.port;
+            std::string_view rest = line.substr(2);
+            current_media.media_type = sip::nextWord(rest);
+            uint32_t port = 0;
+            if (sip::parseUint(sip::nextWord(rest), port) && port <= 0xFFFF) {
+                current_media.port = static_cast<uint16_t>(port);
+            }
             current_media.connection_ip = connection_ip;
 
         } else if (line[0] == 'c' && line[1] == '=') {
             // Connection line: c=IN IP4 <address>
-            std::istringstream cline(line.substr(2));
-            std::string net_type, addr_type;
-            cline >> net_type >> addr_type >> connection_ip;
+            std::string_view rest = line.substr(2);
+            sip::nextWord(rest);  // Network type
+            sip::nextWord(rest);  // Address type
+            connection_ip = sip::nextWord(rest);
             if (!current_media.media_type.empty()) {
                 current_media.connection_ip = connection_ip;
             }
 
         } else if (line[0] == 'a' && line[1] == '=') {
             // Attribute line
-            std::string attr = line.substr(2);
+            std::string_view attr = line.substr(2);
 
             // Check for direction attributes
             if (attr == "sendrecv" || attr == "sendonly" || attr == "recvonly" ||
@@ -342,12 +354,11 @@ std::vector<SipMediaInfo> SipCallDetector::parseSdp(const std::string& sdp) {
             }
 
             // Parse rtpmap for codec information
-            if (attr.find("rtpmap:") == 0) {
+            if (attr.substr(0, 7) == "rtpmap:") {
                 // rtpmap:<payload> <encoding>/<clock>
                 size_t space_pos = attr.find(' ');
-                if (space_pos != std::string::npos) {
-                    std::string codec = attr.substr(space_pos + 1);
-                    current_media.codecs.push_back(codec);
+                if (space_pos != std::string_view::npos) {
+                    current_media.codecs.emplace_back(attr.substr(space_pos + 1));
                 }
             }
         }
@@ -405,20 +416,21 @@ std::optional<std::string> SipCallDetector::extractIpFromContact(const SipMessag
 
 std::optional<std::string> SipCallDetector::extractIpFromSdp(const std::string& sdp) {
     // Extract IP from c= line in SDP
-    std::istringstream iss(sdp);
-    std::string line;
+    sip::LineTokenizer lines(sdp);
+    std::string_view line;
 
-    while (std::getline(iss, line)) {
-        if (line.empty())
+    while (lines.next(line)) {
+        if (line.size() < 2)
             continue;
 
         if (line[0] == 'c' && line[1] == '=') {
             // c=IN IP4 <address>
-            std::istringstream cline(line.substr(2));
-            std::string net_type, addr_type, address;
-            cline >> net_type >> addr_type >> address;
+            std::string_view rest = line.substr(2);
+            sip::nextWord(rest);  // Network type
+            sip::nextWord(rest);  // Address type
+            std::string_view address = sip::nextWord(rest);
             if (!address.empty()) {
-                return address;
+                return std::string(address);
             }
         }
     }
@@ -427,37 +439,7 @@ std::optional<std::string> SipCallDetector::extractIpFromSdp(const std::string&
 }
 
 std::string SipCallDetector::stripUriDelimiters(const std::string& uri) {
-    std::string result = uri;
-
-    // Remove leading/trailing whitespace
-    size_t start = result.find_first_not_of(" \t\r\n");
-    if (start != std::string::npos) {
-        result = result.substr(start);
-    }
-
-    size_t end = result.find_last_not_of(" \t\r\n");
-    if (end != std::string::npos) {
-        result = result.substr(0, end + 1);
-    }
-
-    // Remove angle brackets: <sip:...> -> sip:...
-    if (!result.empty() && result.front() == '<') {
-        result = result.substr(1);
-    }
-    if (!result.empty() && result.back() == '>') {
-        result = result.substr(0, result.length() - 1);
-    }
-
-    // Remove display name: "Name" <sip:...> -> sip:...
-    size_t bracket_pos = result.find('<');
-    if (bracket_pos != std::string::npos) {
-        result = result.substr(bracket_pos + 1);
-        if (!result.empty() && result.back() == '>') {
-            result = result.substr(0, result.length() - 1);
-        }
-    }
-
-    return result;
+    return std::string(stripDelimiters(uri));
 }
 
 std::string SipCallDetector::normalizePhoneNumber(const std::string& number) {
@@ -1,5 +1,6 @@
 #include "correlation/sip_session_manager.h"
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -104,9 +105,15 @@ std::shared_ptr<SipSession> SipSessionManager::getSessionByCallId(
 }
 
 nlohmann::json SipSessionManager::exportSessions() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-
     nlohmann::json result = nlohmann::json::array();
+    forEachExportedSession(
+        [&result](const nlohmann::json& session_json) { result.push_back(session_json); });
+    return result;
+}
+
+void SipSessionManager::forEachExportedSession(
+    const std::function<void(const nlohmann::json&)>& callback) const {
+    std::lock_guard<std::mutex> lock(mutex_);
 
     for (const auto& [call_id, sip_session] : sessions_) {
         // Finalize session to extract call parties and session type
@@ -175,7 +182,7 @@ nlohmann::json SipSessionManager::exportSessions() const {
         // Add events (for timeline visualization)
         nlohmann::json events_json = nlohmann::json::array();
         if (!generic_session.legs.empty()) {
-            for (const auto& msg_ref : generic_session.legs[0].messages) {
+            for (const auto& msg_ref : generic_session.legs[0].expandAll()) {
                 nlohmann::json event;
                 if (msg_ref.timestamp.time_since_epoch().count() > 0) {
                     event["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -249,10 +256,8 @@ nlohmann::json SipSessionManager::exportSessions() const {
         }
         session_json["events"] = events_json;
 
-        result.push_back(session_json);
+        callback(session_json);
     }
-
-    return result;
 }
 
 Session SipSessionManager::toGenericSession(const SipSession& sip_session) const {
@@ -324,7 +329,7 @@ Session SipSessionManager::toGenericSession(const SipSession& sip_session) const
         // Store parsed data as JSON
         msg_ref.parsed_data = sip_msg.toJson();
 
-        leg.messages.push_back(msg_ref);
+        leg.append(msg_ref);
     }
 
     session.legs.push_back(leg);
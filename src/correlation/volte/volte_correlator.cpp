@@ -204,7 +204,20 @@ void VolteCorrelator::phase2_DetectSipCalls() {
 // Phase 3: Correlate Within Call Window
 // ============================================================================
 
+namespace {
+
+// Time-window tolerances (seconds) around the call's [start, end]
+constexpr double kGxTolerance = 5.0;   // Gx session setup precedes the call
+constexpr double kRxTolerance = 2.0;
+constexpr double kCxShTolerance = 30.0;  // IMS registration well before the call
+constexpr double kGtpTolerance = 3.0;
+constexpr double kNasTolerance = 3.0;
+
+}  // namespace
+
 void VolteCorrelator::phase3_CorrelateWithinCallWindow() {
+    buildWindowIndexes();
+
     for (auto& flow : call_flows_) {
         correlateDiameterGx(*flow);
         correlateDiameterRx(*flow);
@@ -213,40 +226,118 @@ void VolteCorrelator::phase3_CorrelateWithinCallWindow() {
         correlateNasEsm(*flow);
         correlateRtp(*flow);
     }
+
+    clearWindowIndexes();
+}
+
+void VolteCorrelator::buildWindowIndexes() {
+    clearWindowIndexes();
+
+    if (diameter_correlator_) {
+        auto add_by_ip = [](KeyedIntervalIndex<DiameterSession*>& index,
+                            const std::vector<DiameterSession*>& sessions) {
+            for (auto* session : sessions) {
+                auto framed_ip = session->getFramedIpAddress();
+                if (!framed_ip || framed_ip->empty())
+                    continue;
+                double start = session->getStartTime();
+                index.add(ueIpKey(*framed_ip), start, start, session);
+            }
+            index.build();
+        };
+        add_by_ip(gx_window_index_, diameter_correlator_->getGxSessions());
+        add_by_ip(rx_window_index_, diameter_correlator_->getRxSessions());
+
+        auto add_by_msisdn = [](IntervalIndex<MsisdnCandidate<DiameterSession>>& index,
+                                const std::vector<DiameterSession*>& sessions) {
+            for (auto* session : sessions) {
+                auto msisdn = session->getMsisdn();
+                if (!msisdn || msisdn->empty())
+                    continue;
+                double start = session->getStartTime();
+                index.add(start, start, {session, MsisdnNormalizer::normalize(*msisdn)});
+            }
+            index.build();
+        };
+        add_by_msisdn(cx_window_index_, diameter_correlator_->getCxSessions());
+        add_by_msisdn(sh_window_index_, diameter_correlator_->getShSessions());
+    }
+
+    if (gtpv2_correlator_) {
+        for (auto* gtp : gtpv2_correlator_->getSessionsWithDedicatedBearers()) {
+            auto msisdn = gtp->getMsisdn();
+            if (!msisdn || msisdn->empty())
+                continue;
+            double start = gtp->getStartTime();
+            gtp_window_index_.add(start, start, {gtp, MsisdnNormalizer::normalize(*msisdn)});
+        }
+        gtp_window_index_.build();
+    }
+
+    if (nas_correlator_) {
+        for (auto* nas : nas_correlator_->getImsEsmSessions()) {
+            auto imsi = nas->getImsi();
+            if (!imsi)
+                continue;
+            double start = nas->getStartTime();
+            nas_window_index_.add(*imsi, start, start, nas);
+        }
+        nas_window_index_.build();
+    }
+
+    if (rtp_correlator_) {
+        for (auto* stream : rtp_correlator_->getStreams()) {
+            std::string src_key = ueIpKey(stream->getSrcIp());
+            std::string dst_key = ueIpKey(stream->getDstIp());
+            double start = stream->getStartTime();
+            double end = stream->getEndTime();
+            if (!src_key.empty()) {
+                rtp_window_index_.add(src_key, start, end, stream);
+            }
+            if (!dst_key.empty() && dst_key != src_key) {
+                rtp_window_index_.add(dst_key, start, end, stream);
+            }
+        }
+        rtp_window_index_.build();
+    }
+}
+
+void VolteCorrelator::clearWindowIndexes() {
+    gx_window_index_.clear();
+    rx_window_index_.clear();
+    cx_window_index_.clear();
+    sh_window_index_.clear();
+    gtp_window_index_.clear();
+    nas_window_index_.clear();
+    rtp_window_index_.clear();
 }
 
 void VolteCorrelator::correlateDiameterGx(VolteCallFlow& flow) {
     if (!diameter_correlator_)
         return;
 
-    auto gx_sessions = diameter_correlator_->getGxSessions();
-
-    for (auto* gx : gx_sessions) {
+    auto link = [&](DiameterSession* gx) {
         // Check if already correlated
         if (correlated_diameter_sessions_.count(gx->getSessionId())) {
-            continue;
+            return;
         }
 
-        // Check time window (with tolerance for session setup before call)
-        if (!isWithinTimeWindow(gx->getStartTime(), flow.start_time, flow.end_time, 5000.0)) {
-            continue;
-        }
+        flow.diameter_sessions.push_back(gx->getSessionId());
+        flow.stats.diameter_messages += gx->getMessageCount();
+        correlated_diameter_sessions_.insert(gx->getSessionId());
 
-        // Match by UE IP address
-        auto framed_ip = gx->getFramedIpAddress();
-        if (!framed_ip)
-            continue;
-
-        if (matchesUeIp(*framed_ip, flow.caller.ip_v4) ||
-            matchesUeIp(*framed_ip, flow.callee.ip_v4)) {
-            flow.diameter_sessions.push_back(gx->getSessionId());
-            flow.stats.diameter_messages += gx->getMessageCount();
-            correlated_diameter_sessions_.insert(gx->getSessionId());
+        // Collect frame numbers
+        for (const auto& msg : gx->getMessages()) {
+            flow.frame_numbers.push_back(msg.getFrameNumber());
+        }
+    };
 
-            // Collect frame numbers
-            for (const auto& msg : gx->getMessages()) {
-                flow.frame_numbers.push_back(msg.getFrameNumber());
-            }
+    // Match by UE IP address, with tolerance for session setup before call
+    double from = flow.start_time - kGxTolerance;
+    double to = flow.end_time + kGxTolerance;
+    for (const auto* ip : {&flow.caller.ip_v4, &flow.callee.ip_v4}) {
+        if (!ip->empty()) {
+            gx_window_index_.forEachOverlap(ueIpKey(*ip), from, to, link);
         }
     }
 }
@@ -255,34 +346,28 @@ void VolteCorrelator::correlateDiameterRx(VolteCallFlow& flow) {
     if (!diameter_correlator_)
         return;
 
-    auto rx_sessions = diameter_correlator_->getRxSessions();
-
-    for (auto* rx : rx_sessions) {
+    auto link = [&](DiameterSession* rx) {
         // Check if already correlated
         if (correlated_diameter_sessions_.count(rx->getSessionId())) {
-            continue;
+            return;
         }
 
-        // Check time window
-        if (!isWithinTimeWindow(rx->getStartTime(), flow.start_time, flow.end_time, 2000.0)) {
-            continue;
-        }
-
-        // Match by UE IP address
-        auto framed_ip = rx->getFramedIpAddress();
-        if (!framed_ip)
-            continue;
+        flow.diameter_sessions.push_back(rx->getSessionId());
+        flow.stats.diameter_messages += rx->getMessageCount();
+        correlated_diameter_sessions_.insert(rx->getSessionId());
 
-        if (matchesUeIp(*framed_ip, flow.caller.ip_v4) ||
-            matchesUeIp(*framed_ip, flow.callee.ip_v4)) {
-            flow.diameter_sessions.push_back(rx->getSessionId());
-            flow.stats.diameter_messages += rx->getMessageCount();
-            correlated_diameter_sessions_.insert(rx->getSessionId());
+        // Collect frame numbers
+        for (const auto& msg : rx->getMessages()) {
+            flow.frame_numbers.push_back(msg.getFrameNumber());
+        }
+    };
 
-            // Collect frame numbers
-            for (const auto& msg : rx->getMessages()) {
-                flow.frame_numbers.push_back(msg.getFrameNumber());
-            }
+    // Match by UE IP address within the time window
+    double from = flow.start_time - kRxTolerance;
+    double to = flow.end_time + kRxTolerance;
+    for (const auto* ip : {&flow.caller.ip_v4, &flow.callee.ip_v4}) {
+        if (!ip->empty()) {
+            rx_window_index_.forEachOverlap(ueIpKey(*ip), from, to, link);
         }
     }
 }
@@ -291,144 +376,113 @@ void VolteCorrelator::correlateDiameterCxSh(VolteCallFlow& flow) {
     if (!diameter_correlator_)
         return;
 
-    // Correlate Cx sessions (IMS registration)
-    auto cx_sessions = diameter_correlator_->getCxSessions();
-    for (auto* cx : cx_sessions) {
-        if (correlated_diameter_sessions_.count(cx->getSessionId())) {
-            continue;
-        }
+    auto caller = MsisdnNormalizer::normalize(flow.caller.msisdn);
+    auto callee = MsisdnNormalizer::normalize(flow.callee.msisdn);
 
-        // Cx sessions happen before the call (IMS registration)
-        // Look for sessions within extended time window
-        if (!isWithinTimeWindow(cx->getStartTime(), flow.start_time, flow.end_time, 30000.0)) {
-            continue;
+    // Match by MSISDN or public identity
+    auto link = [&](const MsisdnCandidate<DiameterSession>& candidate) {
+        DiameterSession* session = candidate.session;
+        if (correlated_diameter_sessions_.count(session->getSessionId())) {
+            return;
         }
-
-        // Match by MSISDN or public identity
-        auto msisdn = cx->getMsisdn();
-        if (msisdn && (matchesMsisdn(*msisdn, flow.caller.msisdn) ||
-                       matchesMsisdn(*msisdn, flow.callee.msisdn))) {
-            flow.diameter_sessions.push_back(cx->getSessionId());
-            flow.stats.diameter_messages += cx->getMessageCount();
-            correlated_diameter_sessions_.insert(cx->getSessionId());
-
-            for (const auto& msg : cx->getMessages()) {
-                flow.frame_numbers.push_back(msg.getFrameNumber());
-            }
+        if (!matchesMsisdn(candidate.msisdn, caller) && !matchesMsisdn(candidate.msisdn, callee)) {
+            return;
         }
-    }
 
-    // Correlate Sh sessions (IMS user data)
-    auto sh_sessions = diameter_correlator_->getShSessions();
-    for (auto* sh : sh_sessions) {
-        if (correlated_diameter_sessions_.count(sh->getSessionId())) {
-            continue;
-        }
+        flow.diameter_sessions.push_back(session->getSessionId());
+        flow.stats.diameter_messages += session->getMessageCount();
+        correlated_diameter_sessions_.insert(session->getSessionId());
 
-        if (!isWithinTimeWindow(sh->getStartTime(), flow.start_time, flow.end_time, 30000.0)) {
-            continue;
+        for (const auto& msg : session->getMessages()) {
+            flow.frame_numbers.push_back(msg.getFrameNumber());
         }
+    };
 
-        auto msisdn = sh->getMsisdn();
-        if (msisdn && (matchesMsisdn(*msisdn, flow.caller.msisdn) ||
-                       matchesMsisdn(*msisdn, flow.callee.msisdn))) {
-            flow.diameter_sessions.push_back(sh->getSessionId());
-            flow.stats.diameter_messages += sh->getMessageCount();
-            correlated_diameter_sessions_.insert(sh->getSessionId());
-
-            for (const auto& msg : sh->getMessages()) {
-                flow.frame_numbers.push_back(msg.getFrameNumber());
-            }
-        }
-    }
+    // Cx sessions happen before the call (IMS registration), Sh sessions
+    // carry IMS user data; both use the extended time window
+    double from = flow.start_time - kCxShTolerance;
+    double to = flow.end_time + kCxShTolerance;
+    cx_window_index_.forEachOverlap(from, to, link);
+    sh_window_index_.forEachOverlap(from, to, link);
 }
 
 void VolteCorrelator::correlateGtpv2ImsBearer(VolteCallFlow& flow) {
     if (!gtpv2_correlator_)
         return;
 
-    auto ims_sessions = gtpv2_correlator_->getSessionsWithDedicatedBearers();
+    auto caller = MsisdnNormalizer::normalize(flow.caller.msisdn);
+    auto callee = MsisdnNormalizer::normalize(flow.callee.msisdn);
+
+    // GTP session setup happens around call time; match by MSISDN
+    auto link = [&](const MsisdnCandidate<Gtpv2Session>& candidate) {
+        Gtpv2Session* gtp = candidate.session;
 
-    for (auto* gtp : ims_sessions) {
         // Check if already correlated
         auto intra_id = gtp->getIntraCorrelator();
         if (correlated_gtp_sessions_.count(intra_id)) {
-            continue;
+            return;
         }
 
-        // Check time window (GTP session setup happens around call time)
-        if (!isWithinTimeWindow(gtp->getStartTime(), flow.start_time, flow.end_time, 3000.0)) {
-            continue;
+        bool matches_caller = matchesMsisdn(candidate.msisdn, caller);
+        bool matches_callee = matchesMsisdn(candidate.msisdn, callee);
+        if (!matches_caller && !matches_callee) {
+            return;
         }
 
-        // Match by MSISDN
-        auto msisdn = gtp->getMsisdn();
-        if (msisdn && (matchesMsisdn(*msisdn, flow.caller.msisdn) ||
-                       matchesMsisdn(*msisdn, flow.callee.msisdn))) {
-            flow.gtpv2_sessions.push_back(intra_id);
-            flow.stats.gtp_messages += gtp->getMessageCount();
-            correlated_gtp_sessions_.insert(intra_id);
+        flow.gtpv2_sessions.push_back(intra_id);
+        flow.stats.gtp_messages += gtp->getMessageCount();
+        correlated_gtp_sessions_.insert(intra_id);
 
-            // Collect frame numbers
-            for (const auto& msg : gtp->getMessages()) {
-                flow.frame_numbers.push_back(msg.getFrameNumber());
-            }
+        // Collect frame numbers
+        for (const auto& msg : gtp->getMessages()) {
+            flow.frame_numbers.push_back(msg.getFrameNumber());
+        }
 
-            // Copy IMSI if not already set
-            auto gtp_imsi = gtp->getImsi();
-            if (gtp_imsi) {
-                if (!flow.caller.imsi && matchesMsisdn(*msisdn, flow.caller.msisdn)) {
-                    flow.caller.imsi = *gtp_imsi;
-                }
-                if (!flow.callee.imsi && matchesMsisdn(*msisdn, flow.callee.msisdn)) {
-                    flow.callee.imsi = *gtp_imsi;
-                }
+        // Copy IMSI if not already set
+        auto gtp_imsi = gtp->getImsi();
+        if (gtp_imsi) {
+            if (!flow.caller.imsi && matches_caller) {
+                flow.caller.imsi = *gtp_imsi;
+            }
+            if (!flow.callee.imsi && matches_callee) {
+                flow.callee.imsi = *gtp_imsi;
             }
         }
-    }
+    };
+
+    gtp_window_index_.forEachOverlap(flow.start_time - kGtpTolerance,
+                                     flow.end_time + kGtpTolerance, link);
 }
 
 void VolteCorrelator::correlateNasEsm(VolteCallFlow& flow) {
     if (!nas_correlator_)
         return;
 
-    auto esm_sessions = nas_correlator_->getImsEsmSessions();
-
-    for (auto* nas : esm_sessions) {
+    auto link = [&](NasSession* nas) {
         // Check if already correlated
         auto intra_id = nas->getIntraCorrelator();
         if (correlated_nas_sessions_.count(intra_id)) {
-            continue;
+            return;
         }
 
-        // Check time window (NAS ESM for IMS bearer setup)
-        if (!isWithinTimeWindow(nas->getStartTime(), flow.start_time, flow.end_time, 3000.0)) {
-            continue;
-        }
-
-        // Match by IMSI
-        auto imsi = nas->getImsi();
-        if (imsi) {
-            bool matched = false;
-
-            if (flow.caller.imsi && *imsi == *flow.caller.imsi) {
-                matched = true;
-            }
-            if (flow.callee.imsi && *imsi == *flow.callee.imsi) {
-                matched = true;
-            }
-
-            if (matched) {
-                flow.nas_sessions.push_back(intra_id);
-                flow.stats.nas_messages += nas->getMessageCount();
-                correlated_nas_sessions_.insert(intra_id);
+        flow.nas_sessions.push_back(intra_id);
+        flow.stats.nas_messages += nas->getMessageCount();
+        correlated_nas_sessions_.insert(intra_id);
 
-                // Collect frame numbers
-                for (const auto& msg : nas->getMessages()) {
-                    flow.frame_numbers.push_back(msg.getFrameNum());
-                }
-            }
+        // Collect frame numbers
+        for (const auto& msg : nas->getMessages()) {
+            flow.frame_numbers.push_back(msg.getFrameNum());
         }
+    };
+
+    // Match by IMSI (NAS ESM for IMS bearer setup)
+    double from = flow.start_time - kNasTolerance;
+    double to = flow.end_time + kNasTolerance;
+    if (flow.caller.imsi) {
+        nas_window_index_.forEachOverlap(*flow.caller.imsi, from, to, link);
+    }
+    if (flow.callee.imsi) {
+        nas_window_index_.forEachOverlap(*flow.callee.imsi, from, to, link);
     }
 }
 
@@ -436,65 +490,57 @@ void VolteCorrelator::correlateRtp(VolteCallFlow& flow) {
     if (!rtp_correlator_)
         return;
 
-    // Get RTP streams within time window
-    auto streams = rtp_correlator_->findByTimeWindow(flow.start_time, flow.end_time);
+    // RTP streams overlapping the call, matched by UE IP address
+    std::vector<RtpStream*> streams;
+    for (const auto* ip : {&flow.caller.ip_v4, &flow.callee.ip_v4}) {
+        if (!ip->empty()) {
+            rtp_window_index_.forEachOverlap(ueIpKey(*ip), flow.start_time, flow.end_time,
+                                             [&](RtpStream* stream) { streams.push_back(stream); });
+        }
+    }
 
     for (auto* stream : streams) {
-        // Check if already correlated
+        // Check if already correlated (a stream between caller and callee
+        // is found under both addresses)
         if (correlated_rtp_ssrcs_.count(stream->getSsrc())) {
             continue;
         }
 
-        // Match by UE IP address
-        bool matched = false;
+        flow.rtp_ssrcs.push_back(stream->getSsrc());
+        flow.stats.rtp_packets += stream->getPacketCount();
+        correlated_rtp_ssrcs_.insert(stream->getSsrc());
 
-        if (!flow.caller.ip_v4.empty() && (matchesUeIp(stream->getSrcIp(), flow.caller.ip_v4) ||
-                                           matchesUeIp(stream->getDstIp(), flow.caller.ip_v4))) {
-            matched = true;
-        }
-
-        if (!flow.callee.ip_v4.empty() && (matchesUeIp(stream->getSrcIp(), flow.callee.ip_v4) ||
-                                           matchesUeIp(stream->getDstIp(), flow.callee.ip_v4))) {
-            matched = true;
-        }
+        // Calculate and aggregate RTP quality metrics
+        auto metrics = stream->calculateMetrics();
 
-        if (matched) {
-            flow.rtp_ssrcs.push_back(stream->getSsrc());
-            flow.stats.rtp_packets += stream->getPacketCount();
-            correlated_rtp_ssrcs_.insert(stream->getSsrc());
-
-            // Calculate and aggregate RTP quality metrics
-            auto metrics = stream->calculateMetrics();
-
-            if (metrics.jitter_ms > 0.0) {
-                if (!flow.stats.rtp_jitter_ms) {
-                    flow.stats.rtp_jitter_ms = metrics.jitter_ms;
-                } else {
-                    // Average jitter across streams
-                    *flow.stats.rtp_jitter_ms =
-                        (*flow.stats.rtp_jitter_ms + metrics.jitter_ms) / 2.0;
-                }
+        if (metrics.jitter_ms > 0.0) {
+            if (!flow.stats.rtp_jitter_ms) {
+                flow.stats.rtp_jitter_ms = metrics.jitter_ms;
+            } else {
+                // Average jitter across streams
+                *flow.stats.rtp_jitter_ms =
+                    (*flow.stats.rtp_jitter_ms + metrics.jitter_ms) / 2.0;
             }
+        }
 
-            if (metrics.packet_loss_rate > 0.0) {
-                double loss_percent = metrics.packet_loss_rate * 100.0;
-                if (!flow.stats.rtp_packet_loss) {
-                    flow.stats.rtp_packet_loss = loss_percent;
-                } else {
-                    // Max packet loss across streams
-                    *flow.stats.rtp_packet_loss =
-                        std::max(*flow.stats.rtp_packet_loss, loss_percent);
-                }
+        if (metrics.packet_loss_rate > 0.0) {
+            double loss_percent = metrics.packet_loss_rate * 100.0;
+            if (!flow.stats.rtp_packet_loss) {
+                flow.stats.rtp_packet_loss = loss_percent;
+            } else {
+                // Max packet loss across streams
+                *flow.stats.rtp_packet_loss =
+                    std::max(*flow.stats.rtp_packet_loss, loss_percent);
             }
+        }
 
-            if (metrics.estimated_mos && *metrics.estimated_mos > 0.0) {
-                if (!flow.stats.estimated_mos) {
-                    flow.stats.estimated_mos = *metrics.estimated_mos;
-                } else {
-                    // Min MOS across streams (worst quality)
-                    *flow.stats.estimated_mos =
-                        std::min(*flow.stats.estimated_mos, *metrics.estimated_mos);
-                }
+        if (metrics.estimated_mos && *metrics.estimated_mos > 0.0) {
+            if (!flow.stats.estimated_mos) {
+                flow.stats.estimated_mos = *metrics.estimated_mos;
+            } else {
+                // Min MOS across streams (worst quality)
+                *flow.stats.estimated_mos =
+                    std::min(*flow.stats.estimated_mos, *metrics.estimated_mos);
             }
         }
     }
@@ -785,38 +831,19 @@ void VolteCorrelator::clear() {
 // Matching Helpers
 // ============================================================================
 
-bool VolteCorrelator::matchesMsisdn(const std::string& m1, const std::string& m2) {
-    if (m1.empty() || m2.empty())
-        return false;
-
-    auto n1 = MsisdnNormalizer::normalize(m1);
-    auto n2 = MsisdnNormalizer::normalize(m2);
-
-    return MsisdnNormalizer::matches(n1, n2);
-}
-
-bool VolteCorrelator::matchesUeIp(const std::string& ip1, const std::string& ip2) {
-    if (ip1.empty() || ip2.empty())
+bool VolteCorrelator::matchesMsisdn(const NormalizedMsisdn& m1, const NormalizedMsisdn& m2) {
+    if (m1.raw.empty() || m2.raw.empty())
         return false;
 
-    // Exact match for IPv4
-    if (ip1 == ip2)
-        return true;
-
-    // IPv6 prefix match (first 64 bits)
-    if (ip1.find(':') != std::string::npos && ip2.find(':') != std::string::npos) {
-        // Simplified: compare first 4 groups (64 bits)
-        auto prefix1 = ip1.substr(0, ip1.find(':', ip1.find(':') + 1));
-        auto prefix2 = ip2.substr(0, ip2.find(':', ip2.find(':') + 1));
-        return prefix1 == prefix2;
-    }
-
-    return false;
+    return MsisdnNormalizer::matches(m1, m2);
 }
 
-bool VolteCorrelator::isWithinTimeWindow(double ts, double start, double end, double tolerance_ms) {
-    double tolerance_sec = tolerance_ms / 1000.0;
-    return ts >= (start - tolerance_sec) && ts <= (end + tolerance_sec);
+std::string VolteCorrelator::ueIpKey(const std::string& ip) {
+    // IPv6: compare the leading groups only (prefix match)
+    auto first_colon = ip.find(':');
+    if (first_colon == std::string::npos)
+        return ip;
+    return ip.substr(0, ip.find(':', first_colon + 1));
 }
 
 // ============================================================================
@@ -39,33 +39,34 @@ std::string JsonExporter::exportSessionSummary(const Session& session) {
 bool JsonExporter::exportToFile(const std::string& filename,
                                 const std::vector<std::shared_ptr<Session>>& sessions,
                                 bool pretty_print) {
+    auto options = StreamingJsonWriter::optionsForPath(filename);
+    options.indent = pretty_print ? 2 : -1;
+    return exportToFile(filename, sessions, options);
+}
+
+bool JsonExporter::exportToFile(const std::string& filename,
+                                const std::vector<std::shared_ptr<Session>>& sessions,
+                                const StreamingJsonWriter::Options& options) {
     try {
-        nlohmann::json j = nlohmann::json::array();
+        // Sessions are serialized one by one so memory stays bounded by the largest session
+        StreamingJsonWriter writer(options);
+        if (!writer.open(filename)) {
+            return false;
+        }
 
         for (const auto& session : sessions) {
             if (session) {
-                j.push_back(session->toJson());
+                writer.writeSession(session->toJson());
             }
         }
 
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            LOG_ERROR("Failed to open file for writing: " << filename);
+        if (!writer.close()) {
+            LOG_ERROR("Failed to write sessions to " << filename);
             return false;
         }
 
-        nlohmann::json root;
-        root["sessions"] = j;
-
-        if (pretty_print) {
-            file << root.dump(2);
-        } else {
-            file << root.dump();
-        }
-
-        file.close();
-
-        LOG_INFO("Exported " << sessions.size() << " sessions to " << filename);
+        LOG_INFO("Exported " << writer.sessionsWritten() << " sessions to " << filename << " ("
+                             << writer.bytesWritten() << " bytes)");
         return true;
 
     } catch (const std::exception& e) {
@@ -261,296 +262,308 @@ std::string JsonExporter::exportMasterSessions(const EnhancedSessionCorrelator&
 
 std::string JsonExporter::exportAllSessionsWithSipOnly(
     const EnhancedSessionCorrelator& correlator) {
-    LOG_INFO("exportAllSessionsWithSipOnly: START");
     nlohmann::json root = nlohmann::json::array();
+    exportAllSessionsWithSipOnly(
+        correlator, [&root](const nlohmann::json& session) { root.push_back(session); });
+    return formatJson(root, true);
+}
+
+size_t JsonExporter::exportAllSessionsWithSipOnly(const EnhancedSessionCorrelator& correlator,
+                                                  const SessionCallback& callback) {
+    LOG_INFO("exportAllSessionsWithSipOnly: START");
+    size_t exported = 0;
 
     // First, export all master sessions (correlated VoLTE calls)
-    LOG_INFO("exportAllSessionsWithSipOnly: Calling getAllMasterSessions()");
     auto master_sessions = correlator.getAllMasterSessions();
     LOG_INFO("exportAllSessionsWithSipOnly: Got " << master_sessions.size() << " master sessions");
     for (const auto& [imsi, master] : master_sessions) {
-        nlohmann::json j_master;
-        j_master["master_id"] = master.master_uuid;
-        j_master["session_id"] = master.master_uuid;
-        j_master["imsi"] = master.imsi;
-        j_master["msisdn"] = master.msisdn;
-        j_master["start_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                     master.start_time.time_since_epoch())
-                                     .count();
+        callback(masterSessionToJson(correlator, master));
+        exported++;
+    }
 
-        // Collect Protocols
-        std::vector<std::string> protocols;
-        if (master.gtp_session_id.has_value())
-            protocols.push_back("GTPV2");
-        if (!master.sip_session_ids.empty())
-            protocols.push_back("SIP");
-        if (!master.diameter_session_ids.empty())
-            protocols.push_back("DIAMETER");
-        j_master["protocols"] = protocols;
+    // Now export SIP-only sessions (standalone SIP without GTP correlation), one at a time
+    correlator.forEachSipOnlySession([&](const nlohmann::json& sip_session) {
+        callback(sipOnlySessionToJson(sip_session));
+        exported++;
+    });
 
-        // Collect and Aggregate Events
-        std::vector<SessionMessageRef> all_messages;
-        std::set<std::string> processed_sessions;
+    LOG_INFO("exportAllSessionsWithSipOnly: Exported " << exported << " sessions");
+    return exported;
+}
 
-        auto collect_msgs = [&](const std::string& sid) {
-            if (processed_sessions.count(sid))
-                return;
-            processed_sessions.insert(sid);
+nlohmann::json JsonExporter::masterSessionToJson(const EnhancedSessionCorrelator& correlator,
+                                                const VolteMasterSession& master) {
+    nlohmann::json j_master;
+    j_master["master_id"] = master.master_uuid;
+    j_master["session_id"] = master.master_uuid;
+    j_master["imsi"] = master.imsi;
+    j_master["msisdn"] = master.msisdn;
+    j_master["start_time"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 master.start_time.time_since_epoch())
+                                 .count();
+
+    // Collect Protocols
+    std::vector<std::string> protocols;
+    if (master.gtp_session_id.has_value())
+        protocols.push_back("GTPV2");
+    if (!master.sip_session_ids.empty())
+        protocols.push_back("SIP");
+    if (!master.diameter_session_ids.empty())
+        protocols.push_back("DIAMETER");
+    j_master["protocols"] = protocols;
+
+    // Collect and Aggregate Events
+    std::vector<SessionMessageRef> all_messages;
+    std::set<std::string> processed_sessions;
+
+    auto collect_msgs = [&](const std::string& sid) {
+        if (processed_sessions.count(sid))
+            return;
+        processed_sessions.insert(sid);
+
+        LOG_DEBUG("exportAllSessionsWithSipOnly: collect_msgs calling getSession(" << sid
+                                                                                   << ")");
+        auto session_opt = correlator.getSession(sid);
+        if (session_opt) {
+            auto msgs = session_opt->getAllMessages();
+            all_messages.insert(all_messages.end(), msgs.begin(), msgs.end());
+            LOG_DEBUG("exportAllSessionsWithSipOnly: Got " << msgs.size()
+                                                           << " messages from session " << sid);
+        }
+    };
+
+    LOG_DEBUG("exportAllSessionsWithSipOnly: Processing master session for IMSI " << master.imsi);
+    if (master.gtp_session_id.has_value())
+        collect_msgs(master.gtp_session_id.value());
+    for (const auto& sid : master.sip_session_ids)
+        collect_msgs(sid);
+    for (const auto& sid : master.diameter_session_ids)
+        collect_msgs(sid);
+    LOG_DEBUG("exportAllSessionsWithSipOnly: Finished collecting messages for IMSI " << master.imsi);
+
+    // Sort by timestamp
+    std::sort(all_messages.begin(), all_messages.end(),
+              [](const SessionMessageRef& a, const SessionMessageRef& b) {
+                  return a.timestamp < b.timestamp;
+              });
+
+    // Calculate metrics
+    uint64_t total_packets = all_messages.size();
+    uint64_t total_bytes = 0;
+    std::set<std::string> participants;
+
+    nlohmann::json j_events = nlohmann::json::array();
+    for (const auto& msg : all_messages) {
+        total_bytes += msg.payload_length;
+        participants.insert(msg.src_ip + ":" + std::to_string(msg.src_port));
+        participants.insert(msg.dst_ip + ":" + std::to_string(msg.dst_port));
+
+        nlohmann::json j_event;
+        j_event["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   msg.timestamp.time_since_epoch())
+                                   .count();
+        j_event["src_ip"] = msg.src_ip;
+        j_event["dst_ip"] = msg.dst_ip;
+        j_event["src_port"] = msg.src_port;
+        j_event["dst_port"] = msg.dst_port;
+
+        std::string protocol_str;
+        switch (msg.protocol) {
+            case ProtocolType::GTP_C:
+                protocol_str = "GTPv2-C";
+                break;
+            case ProtocolType::GTP_U:
+                protocol_str = "GTPv2-U";
+                break;
+            case ProtocolType::SIP:
+                protocol_str = "SIP";
+                break;
+            case ProtocolType::DIAMETER:
+                protocol_str = "DIAMETER";
+                break;
+            default:
+                protocol_str = "UNKNOWN";
+        }
+        j_event["proto"] = protocol_str;
+        j_event["protocol"] = protocol_str;
+        j_event["type_id"] = static_cast<int>(msg.message_type);
+        j_event["message_type"] = messageTypeToString(msg.message_type);
+        j_event["short"] = messageTypeToString(msg.message_type);
+        j_event["details"] = {{"src_ip", msg.src_ip},
+                              {"dst_ip", msg.dst_ip},
+                              {"src_port", msg.src_port},
+                              {"dst_port", msg.dst_port},
+                              {"payload_len", msg.payload_length}};
+        j_events.push_back(j_event);
+    }
 
-            LOG_DEBUG("exportAllSessionsWithSipOnly: collect_msgs calling getSession(" << sid
-                                                                                       << ")");
-            auto session_opt = correlator.getSession(sid);
-            if (session_opt) {
-                auto msgs = session_opt->getAllMessages();
-                all_messages.insert(all_messages.end(), msgs.begin(), msgs.end());
-                LOG_DEBUG("exportAllSessionsWithSipOnly: Got " << msgs.size()
-                                                               << " messages from session " << sid);
-            }
-        };
+    j_master["events"] = j_events;
 
-        LOG_DEBUG("exportAllSessionsWithSipOnly: Processing master session for IMSI " << imsi);
-        if (master.gtp_session_id.has_value())
-            collect_msgs(master.gtp_session_id.value());
-        for (const auto& sid : master.sip_session_ids)
-            collect_msgs(sid);
-        for (const auto& sid : master.diameter_session_ids)
-            collect_msgs(sid);
-        LOG_DEBUG("exportAllSessionsWithSipOnly: Finished collecting messages for IMSI " << imsi);
+    uint64_t start_time = j_master["start_time"].get<uint64_t>();
+    uint64_t end_time = start_time;
+    if (!all_messages.empty()) {
+        end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       all_messages.back().timestamp.time_since_epoch())
+                       .count();
+    }
 
-        // Sort by timestamp
-        std::sort(all_messages.begin(), all_messages.end(),
-                  [](const SessionMessageRef& a, const SessionMessageRef& b) {
-                      return a.timestamp < b.timestamp;
-                  });
+    j_master["end_time"] = end_time;
+    j_master["duration_ms"] = end_time - start_time;
+    j_master["metrics"] = {{"packets", total_packets},
+                           {"bytes", total_bytes},
+                           {"duration_ms", end_time - start_time}};
 
-        // Calculate metrics
-        uint64_t total_packets = all_messages.size();
-        uint64_t total_bytes = 0;
-        std::set<std::string> participants;
+    j_master["participants"] = nlohmann::json::array();
+    for (const auto& p : participants) {
+        j_master["participants"].push_back(p);
+    }
 
-        nlohmann::json j_events = nlohmann::json::array();
-        for (const auto& msg : all_messages) {
-            total_bytes += msg.payload_length;
-            participants.insert(msg.src_ip + ":" + std::to_string(msg.src_port));
-            participants.insert(msg.dst_ip + ":" + std::to_string(msg.dst_port));
+    return j_master;
+}
 
-            nlohmann::json j_event;
-            j_event["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       msg.timestamp.time_since_epoch())
-                                       .count();
-            j_event["src_ip"] = msg.src_ip;
-            j_event["dst_ip"] = msg.dst_ip;
-            j_event["src_port"] = msg.src_port;
-            j_event["dst_port"] = msg.dst_port;
+nlohmann::json JsonExporter::sipOnlySessionToJson(const nlohmann::json& sip_session) {
+    nlohmann::json j_sip;
+
+    // Use call_id as session identifier
+    std::string call_id = sip_session.value("call_id", "");
+    std::string session_id = sip_session.value("session_id", call_id);
+
+    j_sip["session_id"] = session_id;
+    j_sip["master_id"] = session_id;  // For compatibility
+    j_sip["imsi"] = "";               // SIP-only sessions don't have IMSI
+    j_sip["msisdn"] = sip_session.value("caller_msisdn", "");
+    j_sip["call_id"] = call_id;
+    j_sip["session_type"] = "SIP_ONLY";
+
+    // Protocols - SIP only
+    j_sip["protocols"] = nlohmann::json::array({"SIP"});
+
+    // Timestamps
+    // FIX: Use 0LL (long long) to ensure int64_t is inferred, preventing 32-bit truncation
+    j_sip["start_time"] = sip_session.value("start_time", 0LL);
+    j_sip["end_time"] = sip_session.value("end_time", 0LL);
+
+    uint64_t start_ms = j_sip["start_time"].get<uint64_t>();
+    uint64_t end_ms = j_sip["end_time"].get<uint64_t>();
+    j_sip["duration_ms"] = (end_ms > start_ms) ? (end_ms - start_ms) : 0;
+
+    // Copy events if available
+    if (sip_session.contains("events")) {
+        j_sip["events"] = sip_session["events"];
+    } else if (sip_session.contains("messages")) {
+        // Convert messages to events format
+        nlohmann::json events = nlohmann::json::array();
+        std::set<std::string> participants_set;
+        uint64_t total_bytes = 0;
 
-            std::string protocol_str;
-            switch (msg.protocol) {
-                case ProtocolType::GTP_C:
-                    protocol_str = "GTPv2-C";
-                    break;
-                case ProtocolType::GTP_U:
-                    protocol_str = "GTPv2-U";
-                    break;
-                case ProtocolType::SIP:
-                    protocol_str = "SIP";
-                    break;
-                case ProtocolType::DIAMETER:
-                    protocol_str = "DIAMETER";
-                    break;
-                default:
-                    protocol_str = "UNKNOWN";
+        for (const auto& msg : sip_session["messages"]) {
+            // Extract network information first to validate
+            std::string src_ip = msg.value("source_ip", "");
+            std::string dst_ip = msg.value("dest_ip", "");
+            uint16_t src_port = msg.value("source_port", 0);
+            uint16_t dst_port = msg.value("dest_port", 0);
+
+            // Skip messages with invalid/missing IP addresses
+            if (src_ip.empty() || dst_ip.empty() || src_ip == "0.0.0.0" ||
+                dst_ip == "0.0.0.0") {
+                continue;
             }
-            j_event["proto"] = protocol_str;
-            j_event["protocol"] = protocol_str;
-            j_event["type_id"] = static_cast<int>(msg.message_type);
-            j_event["message_type"] = messageTypeToString(msg.message_type);
-            j_event["short"] = messageTypeToString(msg.message_type);
-            j_event["details"] = {{"src_ip", msg.src_ip},
-                                  {"dst_ip", msg.dst_ip},
-                                  {"src_port", msg.src_port},
-                                  {"dst_port", msg.dst_port},
-                                  {"payload_len", msg.payload_length}};
-            j_events.push_back(j_event);
-        }
 
-        j_master["events"] = j_events;
+            nlohmann::json event;
+            // Convert timestamp from seconds to milliseconds if needed
+            double timestamp = msg.value("timestamp", 0.0);
+            // Validate timestamp - if it's 0 or unreasonably small, skip or log warning
+            if (timestamp < 946684800.0) {  // Before year 2000 (likely invalid)
+                // Try to use session start time as fallback
+                int64_t session_start = sip_session.value("start_time", 0LL);
+                if (session_start > 0) {
+                    event["timestamp"] = session_start;
+                } else {
+                    event["timestamp"] = static_cast<uint64_t>(timestamp * 1000);
+                }
+            } else {
+                event["timestamp"] = static_cast<uint64_t>(timestamp * 1000);
+            }
+            event["proto"] = "SIP";
+            event["protocol"] = "SIP";
 
-        uint64_t start_time = j_master["start_time"].get<uint64_t>();
-        uint64_t end_time = start_time;
-        if (!all_messages.empty()) {
-            end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           all_messages.back().timestamp.time_since_epoch())
-                           .count();
-        }
+            event["src_ip"] = src_ip;
+            event["dst_ip"] = dst_ip;
+            event["src_port"] = src_port;
+            event["dst_port"] = dst_port;
 
-        j_master["end_time"] = end_time;
-        j_master["duration_ms"] = end_time - start_time;
-        j_master["metrics"] = {{"packets", total_packets},
-                               {"bytes", total_bytes},
-                               {"duration_ms", end_time - start_time}};
+            // Add to participants
+            if (!src_ip.empty()) {
+                participants_set.insert(src_ip + ":" + std::to_string(src_port));
+            }
+            if (!dst_ip.empty()) {
+                participants_set.insert(dst_ip + ":" + std::to_string(dst_port));
+            }
 
-        j_master["participants"] = nlohmann::json::array();
-        for (const auto& p : participants) {
-            j_master["participants"].push_back(p);
-        }
+            // Estimate payload size: SIP messages are typically 500-2000 bytes
+            // For better accuracy, check if body field exists
+            uint32_t payload_len = 600;  // Default estimate for SIP message
+            if (msg.contains("body") && msg["body"].is_string()) {
+                payload_len =
+                    msg["body"].get<std::string>().size() + 400;  // Body + headers
+            }
+            total_bytes += payload_len;
 
-        root.push_back(j_master);
-    }
+            // Determine message type
+            if (msg.value("is_request", true)) {
+                event["message_type"] = "SIP_" + msg.value("method", "UNKNOWN");
+                event["short"] = msg.value("method", "UNKNOWN");
+            } else {
+                int status = msg.value("status_code", 0);
+                event["message_type"] = "SIP_" + std::to_string(status);
+                event["short"] =
+                    std::to_string(status) + " " + msg.value("reason_phrase", "");
+            }
 
-    LOG_INFO("exportAllSessionsWithSipOnly: Finished processing " << master_sessions.size()
-                                                                  << " master sessions");
-    // Now export SIP-only sessions (standalone SIP without GTP correlation)
-    LOG_INFO("exportAllSessionsWithSipOnly: Calling exportAllSessions() - THIS MAY DEADLOCK!");
-    auto all_sessions_json = correlator.exportAllSessions();
-    LOG_INFO("exportAllSessionsWithSipOnly: exportAllSessions() completed successfully");
-    if (all_sessions_json.contains("sip_only") && all_sessions_json["sip_only"].is_array()) {
-        for (const auto& sip_session : all_sessions_json["sip_only"]) {
-            nlohmann::json j_sip;
-
-            // Use call_id as session identifier
-            std::string call_id = sip_session.value("call_id", "");
-            std::string session_id = sip_session.value("session_id", call_id);
-
-            j_sip["session_id"] = session_id;
-            j_sip["master_id"] = session_id;  // For compatibility
-            j_sip["imsi"] = "";               // SIP-only sessions don't have IMSI
-            j_sip["msisdn"] = sip_session.value("caller_msisdn", "");
-            j_sip["call_id"] = call_id;
-            j_sip["session_type"] = "SIP_ONLY";
-
-            // Protocols - SIP only
-            j_sip["protocols"] = nlohmann::json::array({"SIP"});
-
-            // Timestamps
-            // FIX: Use 0LL (long long) to ensure int64_t is inferred, preventing 32-bit truncation
-            j_sip["start_time"] = sip_session.value("start_time", 0LL);
-            j_sip["end_time"] = sip_session.value("end_time", 0LL);
-
-            uint64_t start_ms = j_sip["start_time"].get<uint64_t>();
-            uint64_t end_ms = j_sip["end_time"].get<uint64_t>();
-            j_sip["duration_ms"] = (end_ms > start_ms) ? (end_ms - start_ms) : 0;
-
-            // Copy events if available
-            if (sip_session.contains("events")) {
-                j_sip["events"] = sip_session["events"];
-            } else if (sip_session.contains("messages")) {
-                // Convert messages to events format
-                nlohmann::json events = nlohmann::json::array();
-                std::set<std::string> participants_set;
-                uint64_t total_bytes = 0;
-
-                for (const auto& msg : sip_session["messages"]) {
-                    // Extract network information first to validate
-                    std::string src_ip = msg.value("source_ip", "");
-                    std::string dst_ip = msg.value("dest_ip", "");
-                    uint16_t src_port = msg.value("source_port", 0);
-                    uint16_t dst_port = msg.value("dest_port", 0);
-
-                    // Skip messages with invalid/missing IP addresses
-                    if (src_ip.empty() || dst_ip.empty() || src_ip == "0.0.0.0" ||
-                        dst_ip == "0.0.0.0") {
-                        continue;
-                    }
-
-                    nlohmann::json event;
-                    // Convert timestamp from seconds to milliseconds if needed
-                    double timestamp = msg.value("timestamp", 0.0);
-                    // Validate timestamp - if it's 0 or unreasonably small, skip or log warning
-                    if (timestamp < 946684800.0) {  // Before year 2000 (likely invalid)
-                        // Try to use session start time as fallback
-                        int64_t session_start = sip_session.value("start_time", 0LL);
-                        if (session_start > 0) {
-                            event["timestamp"] = session_start;
-                        } else {
-                            event["timestamp"] = static_cast<uint64_t>(timestamp * 1000);
-                        }
-                    } else {
-                        event["timestamp"] = static_cast<uint64_t>(timestamp * 1000);
-                    }
-                    event["proto"] = "SIP";
-                    event["protocol"] = "SIP";
-
-                    event["src_ip"] = src_ip;
-                    event["dst_ip"] = dst_ip;
-                    event["src_port"] = src_port;
-                    event["dst_port"] = dst_port;
-
-                    // Add to participants
-                    if (!src_ip.empty()) {
-                        participants_set.insert(src_ip + ":" + std::to_string(src_port));
-                    }
-                    if (!dst_ip.empty()) {
-                        participants_set.insert(dst_ip + ":" + std::to_string(dst_port));
-                    }
-
-                    // Estimate payload size: SIP messages are typically 500-2000 bytes
-                    // For better accuracy, check if body field exists
-                    uint32_t payload_len = 600;  // Default estimate for SIP message
-                    if (msg.contains("body") && msg["body"].is_string()) {
-                        payload_len =
-                            msg["body"].get<std::string>().size() + 400;  // Body + headers
-                    }
-                    total_bytes += payload_len;
-
-                    // Determine message type
-                    if (msg.value("is_request", true)) {
-                        event["message_type"] = "SIP_" + msg.value("method", "UNKNOWN");
-                        event["short"] = msg.value("method", "UNKNOWN");
-                    } else {
-                        int status = msg.value("status_code", 0);
-                        event["message_type"] = "SIP_" + std::to_string(status);
-                        event["short"] =
-                            std::to_string(status) + " " + msg.value("reason_phrase", "");
-                    }
-
-                    // Add details object
-                    event["details"] = {{"src_ip", src_ip},
-                                        {"dst_ip", dst_ip},
-                                        {"src_port", src_port},
-                                        {"dst_port", dst_port},
-                                        {"payload_len", payload_len}};
-
-                    events.push_back(event);
-                }
-                j_sip["events"] = events;
+            // Add details object
+            event["details"] = {{"src_ip", src_ip},
+                                {"dst_ip", dst_ip},
+                                {"src_port", src_port},
+                                {"dst_port", dst_port},
+                                {"payload_len", payload_len}};
 
-                // Update participants from actual message data
-                j_sip["participants"] = nlohmann::json::array();
-                for (const auto& p : participants_set) {
-                    j_sip["participants"].push_back(p);
-                }
+            events.push_back(event);
+        }
+        j_sip["events"] = events;
 
-                // Store total bytes for metrics
-                j_sip["byte_count"] = total_bytes;
-            } else {
-                j_sip["events"] = nlohmann::json::array();
-            }
+        // Update participants from actual message data
+        j_sip["participants"] = nlohmann::json::array();
+        for (const auto& p : participants_set) {
+            j_sip["participants"].push_back(p);
+        }
 
-            // Metrics - use calculated byte count
-            size_t event_count = j_sip["events"].size();
-            uint64_t byte_count = j_sip.value("byte_count", 0);
-            j_sip["metrics"] = {{"packets", event_count},
-                                {"bytes", byte_count},
-                                {"duration_ms", j_sip["duration_ms"]}};
-
-            // Participants - if not already set from messages, try caller/callee
-            if (!j_sip.contains("participants") || j_sip["participants"].empty()) {
-                j_sip["participants"] = nlohmann::json::array();
-                if (sip_session.contains("caller_ip") &&
-                    !sip_session["caller_ip"].get<std::string>().empty()) {
-                    j_sip["participants"].push_back(sip_session["caller_ip"].get<std::string>());
-                }
-                if (sip_session.contains("callee_ip") &&
-                    !sip_session["callee_ip"].get<std::string>().empty()) {
-                    j_sip["participants"].push_back(sip_session["callee_ip"].get<std::string>());
-                }
-            }
+        // Store total bytes for metrics
+        j_sip["byte_count"] = total_bytes;
+    } else {
+        j_sip["events"] = nlohmann::json::array();
+    }
 
-            root.push_back(j_sip);
+    // Metrics - use calculated byte count
+    size_t event_count = j_sip["events"].size();
+    uint64_t byte_count = j_sip.value("byte_count", 0);
+    j_sip["metrics"] = {{"packets", event_count},
+                        {"bytes", byte_count},
+                        {"duration_ms", j_sip["duration_ms"]}};
+
+    // Participants - if not already set from messages, try caller/callee
+    if (!j_sip.contains("participants") || j_sip["participants"].empty()) {
+        j_sip["participants"] = nlohmann::json::array();
+        if (sip_session.contains("caller_ip") &&
+            !sip_session["caller_ip"].get<std::string>().empty()) {
+            j_sip["participants"].push_back(sip_session["caller_ip"].get<std::string>());
+        }
+        if (sip_session.contains("callee_ip") &&
+            !sip_session["callee_ip"].get<std::string>().empty()) {
+            j_sip["participants"].push_back(sip_session["callee_ip"].get<std::string>());
         }
     }
 
-    return formatJson(root, true);
+    return j_sip;
 }
 
 }  // namespace callflow
@@ -0,0 +1,166 @@
+#include "event_extractor/streaming_json_writer.h"
+
+#ifdef ENABLE_GZIP_EXPORT
+#include <zlib.h>
+#endif
+
+#include "common/logger.h"
+
+namespace callflow {
+
+StreamingJsonWriter::StreamingJsonWriter() : StreamingJsonWriter(Options{}) {}
+
+StreamingJsonWriter::StreamingJsonWriter(Options options) : options_(options) {}
+
+StreamingJsonWriter::~StreamingJsonWriter() {
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool StreamingJsonWriter::gzipSupported() {
+#ifdef ENABLE_GZIP_EXPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+StreamingJsonWriter::Options StreamingJsonWriter::optionsForPath(const std::string& path) {
+    auto ends_with = [](const std::string& str, const std::string& suffix) {
+        return str.size() >= suffix.size() &&
+               str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+
+    Options options;
+    std::string name = path;
+    if (ends_with(name, ".gz")) {
+        options.gzip = true;
+        name.resize(name.size() - 3);
+    }
+    if (ends_with(name, ".ndjson") || ends_with(name, ".jsonl")) {
+        options.format = Format::NDJSON;
+    }
+    return options;
+}
+
+bool StreamingJsonWriter::open(const std::string& path, const nlohmann::json& metadata) {
+    if (isOpen()) {
+        close();
+    }
+
+    if (options_.gzip) {
+#ifdef ENABLE_GZIP_EXPORT
+        gz_file_ = gzopen(path.c_str(), "wb6");
+        if (gz_file_) {
+            gzbuffer(static_cast<gzFile>(gz_file_), 128 * 1024);
+        }
+#else
+        LOG_ERROR("gzip output requested for " << path << " but zlib support is not built in");
+        return false;
+#endif
+    } else {
+        file_ = std::fopen(path.c_str(), "wb");
+    }
+    if (!isOpen()) {
+        LOG_ERROR("Failed to open file for writing: " << path);
+        return false;
+    }
+
+    buffer_.clear();
+    buffer_.reserve(options_.buffer_size);
+    bytes_written_ = 0;
+    sessions_written_ = 0;
+    failed_ = false;
+
+    if (options_.format == Format::JSON) {
+        if (metadata.is_null()) {
+            append("{\"sessions\":[\n");
+        } else {
+            append("{\"metadata\":" + metadata.dump() + ",\"sessions\":[\n");
+        }
+    } else if (!metadata.is_null()) {
+        append("{\"metadata\":" + metadata.dump() + "}\n");
+    }
+    return !failed_;
+}
+
+StreamingJsonWriter::Range StreamingJsonWriter::writeSession(const nlohmann::json& session) {
+    if (options_.format == Format::JSON && sessions_written_ > 0) {
+        append(",\n");
+    }
+
+    std::string text = session.dump(options_.indent);
+    Range range{bytes_written_, text.size()};
+    append(text);
+    if (options_.format == Format::NDJSON) {
+        append("\n");
+    }
+
+    sessions_written_++;
+    return range;
+}
+
+bool StreamingJsonWriter::close() {
+    if (!isOpen()) {
+        return !failed_;
+    }
+
+    if (options_.format == Format::JSON) {
+        append(sessions_written_ > 0 ? "\n]}\n" : "]}\n");
+    }
+    flush();
+
+    if (file_) {
+        if (std::fclose(file_) != 0) {
+            failed_ = true;
+        }
+        file_ = nullptr;
+    }
+#ifdef ENABLE_GZIP_EXPORT
+    if (gz_file_) {
+        if (gzclose(static_cast<gzFile>(gz_file_)) != Z_OK) {
+            failed_ = true;
+        }
+        gz_file_ = nullptr;
+    }
+#endif
+    return !failed_;
+}
+
+void StreamingJsonWriter::append(const std::string& text) {
+    buffer_.append(text);
+    bytes_written_ += text.size();
+    if (buffer_.size() >= options_.buffer_size) {
+        flush();
+    }
+}
+
+bool StreamingJsonWriter::flush() {
+    if (buffer_.empty() || failed_) {
+        buffer_.clear();
+        return !failed_;
+    }
+
+    if (file_) {
+        if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            failed_ = true;
+        }
+    }
+#ifdef ENABLE_GZIP_EXPORT
+    if (gz_file_) {
+        int written = gzwrite(static_cast<gzFile>(gz_file_), buffer_.data(),
+                              static_cast<unsigned>(buffer_.size()));
+        if (written <= 0 || static_cast<size_t>(written) != buffer_.size()) {
+            failed_ = true;
+        }
+    }
+#endif
+    if (failed_) {
+        LOG_ERROR("Write failed after " << bytes_written_ << " bytes of session output");
+    }
+    buffer_.clear();
+    return !failed_;
+}
+
+}  // namespace callflow
@@ -58,7 +58,7 @@ nlohmann::json FlowSession::toJson(bool include_events) const {
             event_json["message_type"] = messageTypeToString(event.message_type);
             event_json["short"] = event.short_description;
             event_json["details"] = event.details;
-            event_json["packet_ref"] = event.packet_ref;
+            event_json["packet_ref"] = packetIdToString(event.packet_ref);
             event_json["src_ip"] = event.src_ip;
             event_json["dst_ip"] = event.dst_ip;
             event_json["src_port"] = event.src_port;
@@ -52,7 +52,8 @@ bool NdpiWrapper::initialize() {
 #endif
 }
 
-ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const FiveTuple& ft) {
+ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const FlowKey& flow,
+                                         Timestamp ts) {
     if (!initialized_) {
         return ProtocolType::UNKNOWN;
     }
@@ -61,6 +62,7 @@ ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const
     // Suppress unused parameter warnings when nDPI is not available
     (void)data;
     (void)len;
+    (void)ts;
 #endif
 
 #ifdef NDPI_INCLUDE_DIR
@@ -68,10 +70,10 @@ ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const
         auto* ndpi_struct = static_cast<struct ndpi_detection_module_struct*>(ndpi_struct_);
 
         // Get or create cached flow for this 5-tuple
-        NdpiCachedFlow* cached_flow = flow_cache_->getOrCreateFlow(ft);
+        NdpiCachedFlow* cached_flow = flow_cache_->getOrCreateFlow(flow, ts);
         if (!cached_flow || !cached_flow->flow || !cached_flow->src_id || !cached_flow->dst_id) {
             LOG_ERROR("Failed to get cached flow");
-            return fallbackClassification(ft);
+            return fallbackClassification(flow);
         }
 
         // Classify packet using cached flow state
@@ -79,7 +81,7 @@ ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const
             ndpi_struct,
             cached_flow->flow.get(),
             data, len,
-            0,  // timestamp
+            std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count(),
             cached_flow->src_id.get(),
             cached_flow->dst_id.get()
         );
@@ -110,7 +112,7 @@ ProtocolType NdpiWrapper::classifyPacket(const uint8_t* data, size_t len, const
 #endif
 
     // Fallback to port-based heuristics
-    return fallbackClassification(ft);
+    return fallbackClassification(flow);
 }
 
 void NdpiWrapper::shutdown() {
@@ -145,7 +147,7 @@ ProtocolType NdpiWrapper::mapNdpiProtocol(const std::string& ndpi_proto_name) {
     return ProtocolType::UNKNOWN;
 }
 
-ProtocolType NdpiWrapper::fallbackClassification(const FiveTuple& ft) {
+ProtocolType NdpiWrapper::fallbackClassification(const FlowKey& ft) {
     // Port-based heuristics as fallback
     if (ft.src_port == 5060 || ft.dst_port == 5060) {
         return ProtocolType::SIP;
@@ -191,9 +193,8 @@ ProtocolType NdpiWrapper::fallbackClassification(const FiveTuple& ft) {
     return ProtocolType::UNKNOWN;
 }
 
-size_t NdpiWrapper::cleanupExpiredFlows() {
+size_t NdpiWrapper::cleanupExpiredFlows(Timestamp now) {
     if (flow_cache_) {
-        auto now = std::chrono::system_clock::now();
         return flow_cache_->cleanupExpiredFlows(now);
     }
     return 0;
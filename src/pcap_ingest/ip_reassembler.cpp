@@ -4,134 +4,108 @@
 #include <netinet/ip.h>
 #include <netinet/ip6.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/logger.h"
-#include "common/utils.h"
 
 namespace callflow {
 
-IpReassembler::IpReassembler(uint32_t timeout_sec) : timeout_sec_(timeout_sec) {}
+namespace {
 
-void IpReassembler::cleanup() {
-    auto now = std::chrono::steady_clock::now();
-    for (auto it = active_reassemblies_.begin(); it != active_reassemblies_.end();) {
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - it->second.last_update).count() >
-            timeout_sec_) {
-            // Timed out
-            it = active_reassemblies_.erase(it);
-        } else {
-            ++it;
-        }
+constexpr size_t kInitialSlots = 256;
+constexpr uint32_t kOpenEnd = UINT32_MAX;  // Hole extending to the not yet seen last fragment
+constexpr uint32_t kMaxPayload = 65535;
+
+uint32_t hashKey(const IpAddress& src, const IpAddress& dst, uint32_t id, uint8_t protocol) {
+    uint64_t h = src.hash() ^ (dst.hash() * 31) ^
+                 (((static_cast<uint64_t>(id) << 8) | protocol) * 0x9e3779b97f4a7c15ULL);
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+uint16_t ipv4Checksum(const uint8_t* header, size_t len) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        sum += (static_cast<uint32_t>(header[i]) << 8) | header[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
     }
+    return static_cast<uint16_t>(~sum);
 }
 
-std::optional<std::vector<uint8_t>> IpReassembler::processPacket(const uint8_t* ip_data,
-                                                                 size_t len) {
+}  // namespace
+
+IpReassembler::IpReassembler(const Limits& limits) : limits_(limits), datagrams_(kInitialSlots) {
+    limits_.max_datagrams = std::max<size_t>(limits_.max_datagrams, 1);
+}
+
+std::optional<ByteView> IpReassembler::processPacket(const uint8_t* ip_data, size_t len,
+                                                     Timestamp now) {
     if (len < 1)
         return std::nullopt;
 
     uint8_t version = (ip_data[0] >> 4) & 0x0F;
     if (version == 4) {
-        return handleIpv4(ip_data, len);
+        return handleIpv4(ip_data, len, now);
     } else if (version == 6) {
-        return handleIpv6(ip_data, len);
+        return handleIpv6(ip_data, len, now);
     }
 
     // Unknown version or not handled
-    return std::vector<uint8_t>(ip_data, ip_data + len);
+    return ByteView(ip_data, len);
+}
+
+size_t IpReassembler::expire(Timestamp now) {
+    size_t expired = 0;
+    while (!datagrams_.empty() && now - datagrams_[datagrams_.oldest()].created > limits_.timeout) {
+        removeDatagram(datagrams_.oldest());
+        ++expired;
+    }
+    stats_.timeouts += expired;
+    return expired;
 }
 
-std::optional<std::vector<uint8_t>> IpReassembler::handleIpv4(const uint8_t* ip_data, size_t len) {
+std::optional<ByteView> IpReassembler::handleIpv4(const uint8_t* ip_data, size_t len,
+                                                  Timestamp now) {
     if (len < sizeof(struct ip))
         return std::nullopt;
 
     const struct ip* ip_hdr = reinterpret_cast<const struct ip*>(ip_data);
     uint16_t off_field = ntohs(ip_hdr->ip_off);
     bool mf = (off_field & IP_MF);
-    uint16_t offset = (off_field & IP_OFFMASK) * 8;
+    uint32_t offset = (off_field & IP_OFFMASK) * 8;
 
     if (!mf && offset == 0) {
-        // Not fragmented
-        return std::vector<uint8_t>(ip_data, ip_data + len);
-    }
-
-    // Is fragmented
-    IpFragmentKey key;
-    char src_str[INET_ADDRSTRLEN];
-    char dst_str[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET, &(ip_hdr->ip_src), src_str, INET_ADDRSTRLEN);
-    inet_ntop(AF_INET, &(ip_hdr->ip_dst), dst_str, INET_ADDRSTRLEN);
-
-    key.src_ip = src_str;
-    key.dst_ip = dst_str;
-    key.id = ntohs(ip_hdr->ip_id);
-    key.protocol = ip_hdr->ip_p;
-    key.is_ipv6 = false;
-
-    // Get payload
-    uint8_t hlen = ip_hdr->ip_hl * 4;
-    if (len < hlen)
-        return std::nullopt;
-
-    size_t payload_len = len - hlen;
-
-    auto& list = active_reassemblies_[key];
-    list.last_update = std::chrono::steady_clock::now();
-
-    std::vector<uint8_t> payload(ip_data + hlen, ip_data + len);
-    list.fragments[offset] = std::move(payload);
-
-    if (!mf) {
-        list.seen_last_fragment = true;
-        list.total_length = offset + payload_len;
+        // Not fragmented: hand the caller's buffer straight back
+        return ByteView(ip_data, len);
     }
 
-    if (list.seen_last_fragment) {
-        uint32_t current_len = 0;
-        bool complete = true;
-
-        for (const auto& frag : list.fragments) {
-            if (frag.first != current_len) {
-                complete = false;
-                break;
-            }
-            current_len += frag.second.size();
-        }
-
-        if (complete && current_len == list.total_length) {
-            // Reconstruct
-            std::vector<uint8_t> reassembled;
-            reassembled.reserve(hlen + list.total_length);
-
-            struct ip new_hdr;
-            std::memset(&new_hdr, 0, sizeof(new_hdr));
-            new_hdr.ip_v = 4;
-            new_hdr.ip_hl = 5;
-            new_hdr.ip_len = htons(sizeof(struct ip) + list.total_length);
-            new_hdr.ip_id = htons(key.id);
-            new_hdr.ip_off = 0;
-            new_hdr.ip_ttl = 64;
-            new_hdr.ip_p = key.protocol;
-            inet_pton(AF_INET, key.src_ip.c_str(), &(new_hdr.ip_src));
-            inet_pton(AF_INET, key.dst_ip.c_str(), &(new_hdr.ip_dst));
-
-            const uint8_t* hptr = reinterpret_cast<const uint8_t*>(&new_hdr);
-            reassembled.insert(reassembled.end(), hptr, hptr + sizeof(struct ip));
-
-            for (const auto& frag : list.fragments) {
-                reassembled.insert(reassembled.end(), frag.second.begin(), frag.second.end());
-            }
-
-            active_reassemblies_.erase(key);
-            return reassembled;
-        }
+    // Header length and total length bound the payload; trailing link-layer
+    // padding on short fragments must not become datagram bytes
+    size_t hlen = ip_hdr->ip_hl * 4;
+    size_t ip_len = std::min<size_t>(ntohs(ip_hdr->ip_len), len);
+    if (hlen < sizeof(struct ip) || ip_len < hlen) {
+        stats_.malformed++;
+        return std::nullopt;
     }
 
-    return std::nullopt;
+    Fragment frag;
+    frag.key.src = IpAddress::fromV4(reinterpret_cast<const uint8_t*>(&ip_hdr->ip_src));
+    frag.key.dst = IpAddress::fromV4(reinterpret_cast<const uint8_t*>(&ip_hdr->ip_dst));
+    frag.key.id = ntohs(ip_hdr->ip_id);
+    frag.key.protocol = ip_hdr->ip_p;
+    frag.header = ip_data;
+    frag.header_len = sizeof(struct ip);  // Options are not carried over
+    frag.payload = ip_data + hlen;
+    frag.payload_len = static_cast<uint32_t>(ip_len - hlen);
+    frag.offset = offset;
+    frag.more = mf;
+    return addFragment(frag, now);
 }
 
-std::optional<std::vector<uint8_t>> IpReassembler::handleIpv6(const uint8_t* ip_data, size_t len) {
+std::optional<ByteView> IpReassembler::handleIpv6(const uint8_t* ip_data, size_t len,
+                                                  Timestamp now) {
     if (len < 40)
         return std::nullopt;
 
@@ -168,76 +142,198 @@ std::optional<std::vector<uint8_t>> IpReassembler::handleIpv6(const uint8_t* ip_
     }
 
     if (!frag_hdr) {
-        return std::vector<uint8_t>(ip_data, ip_data + len);
+        return ByteView(ip_data, len);
     }
 
+    // ip6f_offlg holds the offset in 8-byte units in its top 13 bits, M in bit 0
     uint16_t frag_off_flag = ntohs(frag_hdr->ip6f_offlg);
-    uint16_t offset = (frag_off_flag & IP6F_OFF_MASK);
-    bool mf = (frag_off_flag & IP6F_MORE_FRAG);
-    uint32_t id = ntohl(frag_hdr->ip6f_ident);
+    uint32_t offset = frag_off_flag & 0xfff8;
+    bool mf = (frag_off_flag & 0x0001);
 
-    size_t header_len_total = (const uint8_t*)(frag_hdr + 1) - ip_data;
-    if (len < header_len_total)
+    size_t header_len_total = reinterpret_cast<const uint8_t*>(frag_hdr + 1) - ip_data;
+    size_t ip_len = std::min<size_t>(40 + ntohs(ip6->ip6_plen), len);
+    if (ip_len < header_len_total) {
+        stats_.malformed++;
         return std::nullopt;
+    }
 
-    size_t payload_len = len - header_len_total;
-
-    IpFragmentKey key;
-    char src_str[INET6_ADDRSTRLEN];
-    char dst_str[INET6_ADDRSTRLEN];
-    inet_ntop(AF_INET6, &(ip6->ip6_src), src_str, INET6_ADDRSTRLEN);
-    inet_ntop(AF_INET6, &(ip6->ip6_dst), dst_str, INET6_ADDRSTRLEN);
+    Fragment frag;
+    frag.key.src = IpAddress::fromV6(reinterpret_cast<const uint8_t*>(&ip6->ip6_src));
+    frag.key.dst = IpAddress::fromV6(reinterpret_cast<const uint8_t*>(&ip6->ip6_dst));
+    frag.key.id = ntohl(frag_hdr->ip6f_ident);
+    frag.key.protocol = frag_hdr->ip6f_nxt;
+    frag.header = ip_data;
+    frag.header_len = 40;  // Extension headers before the fragment header are dropped
+    frag.payload = ip_data + header_len_total;
+    frag.payload_len = static_cast<uint32_t>(ip_len - header_len_total);
+    frag.offset = offset;
+    frag.more = mf;
+    return addFragment(frag, now);
+}
 
-    key.src_ip = src_str;
-    key.dst_ip = dst_str;
-    key.id = id;
-    key.protocol = frag_hdr->ip6f_nxt;
-    key.is_ipv6 = true;
+std::optional<ByteView> IpReassembler::addFragment(const Fragment& frag, Timestamp now) {
+    expire(now);
+    stats_.fragments++;
 
-    auto& list = active_reassemblies_[key];
-    list.last_update = std::chrono::steady_clock::now();
+    uint64_t end = static_cast<uint64_t>(frag.offset) + frag.payload_len;
+    bool bad_size = frag.more && (frag.payload_len == 0 || frag.payload_len % 8 != 0);
+    if (end > kMaxPayload || bad_size) {
+        stats_.malformed++;
+        return std::nullopt;
+    }
 
-    std::vector<uint8_t> payload((const uint8_t*)(frag_hdr + 1), ip_data + len);
-    list.fragments[offset] = std::move(payload);
+    uint32_t hash = hashKey(frag.key.src, frag.key.dst, frag.key.id, frag.key.protocol);
+    uint32_t index = datagrams_.find(frag.key, hash);
+    if (index == kNil) {
+        index = createDatagram(frag.key, hash, now);
+        Datagram& created = datagrams_[index];
+        created.header_len = frag.header_len;
+        if (!reserve(index, frag.header_len)) {
+            removeDatagram(index);
+            return std::nullopt;
+        }
+        std::memcpy(created.buffer.data(), frag.header, frag.header_len);
+    }
 
-    if (!mf) {
-        list.seen_last_fragment = true;
-        list.total_length = offset + payload_len;
+    Datagram& dgram = datagrams_[index];
+    if (dgram.total_length != kOpenEnd &&
+        (end > dgram.total_length || (!frag.more && end != dgram.total_length))) {
+        // Data past the end, or two different last fragments
+        stats_.malformed++;
+        removeDatagram(index);
+        return std::nullopt;
+    }
+    if (!frag.more) {
+        // Bytes already received past the end make the datagram inconsistent
+        size_t received_end = dgram.buffer.size() - dgram.header_len;
+        if (received_end > end) {
+            stats_.malformed++;
+            removeDatagram(index);
+            return std::nullopt;
+        }
+        dgram.total_length = static_cast<uint32_t>(end);
+    }
+    if (!reserve(index, dgram.header_len + end)) {
+        removeDatagram(index);
+        return std::nullopt;
+    }
+    if (frag.offset == 0) {
+        std::memcpy(dgram.buffer.data(), frag.header, frag.header_len);
     }
 
-    if (list.seen_last_fragment) {
-        uint32_t current_len = 0;
-        bool complete = true;
-        for (const auto& frag : list.fragments) {
-            if (frag.first != current_len) {
-                complete = false;
-                break;
+    // RFC 815: fill the part of each hole the fragment covers, then replace
+    // the hole by what is left of it on either side
+    uint8_t* payload = dgram.buffer.data() + dgram.header_len;
+    uint32_t first = frag.offset;
+    uint32_t last = static_cast<uint32_t>(end) - 1;
+    size_t filled = 0;
+    for (size_t i = 0; i < dgram.holes.size();) {
+        Hole hole = dgram.holes[i];
+        if (first > hole.last || last < hole.first) {
+            if (!frag.more && hole.first >= end) {
+                dgram.holes.erase(dgram.holes.begin() + i);  // Beyond the final length
+                continue;
             }
-            current_len += frag.second.size();
+            ++i;
+            continue;
         }
 
-        if (complete && current_len == list.total_length) {
-            std::vector<uint8_t> reassembled;
-            reassembled.reserve(40 + list.total_length);
+        uint32_t copy_first = std::max(first, hole.first);
+        uint32_t copy_last = std::min(last, hole.last);
+        std::memcpy(payload + copy_first, frag.payload + (copy_first - first),
+                    copy_last - copy_first + 1);
+        filled += copy_last - copy_first + 1;
+
+        dgram.holes.erase(dgram.holes.begin() + i);
+        if (hole.first < first) {
+            dgram.holes.insert(dgram.holes.begin() + i, Hole{hole.first, first - 1});
+            ++i;
+        }
+        if (hole.last > last && frag.more) {
+            dgram.holes.insert(dgram.holes.begin() + i, Hole{last + 1, hole.last});
+            ++i;
+        }
+    }
+    if (filled < frag.payload_len) {
+        stats_.overlaps++;
+    }
+
+    if (!dgram.holes.empty()) {
+        return std::nullopt;
+    }
 
-            struct ip6_hdr new_hdr;
-            std::memcpy(&new_hdr, ip6, 40);
-            new_hdr.ip6_plen = htons(list.total_length);
-            new_hdr.ip6_nxt = frag_hdr->ip6f_nxt;
+    // Complete: the buffer becomes the output, header patched for the new length
+    finishHeader(dgram, frag.key.protocol);
+    size_t bytes = dgram.buffer.size();
+    reassembled_.swap(dgram.buffer);
+    dgram.buffer.clear();
+    buffered_bytes_ -= bytes;
+    removeDatagram(index);
+    stats_.reassembled++;
+    return ByteView(reassembled_);
+}
 
-            const uint8_t* hptr = reinterpret_cast<const uint8_t*>(&new_hdr);
-            reassembled.insert(reassembled.end(), hptr, hptr + 40);
+void IpReassembler::finishHeader(Datagram& datagram, uint8_t protocol) const {
+    uint8_t* header = datagram.buffer.data();
+    if (datagram.header_len == sizeof(struct ip)) {
+        auto* ip_hdr = reinterpret_cast<struct ip*>(header);
+        ip_hdr->ip_hl = 5;
+        ip_hdr->ip_len = htons(static_cast<uint16_t>(sizeof(struct ip) + datagram.total_length));
+        ip_hdr->ip_off = 0;
+        ip_hdr->ip_sum = 0;
+        ip_hdr->ip_sum = htons(ipv4Checksum(header, sizeof(struct ip)));
+    } else {
+        auto* ip6 = reinterpret_cast<struct ip6_hdr*>(header);
+        ip6->ip6_plen = htons(static_cast<uint16_t>(datagram.total_length));
+        ip6->ip6_nxt = protocol;
+    }
+}
 
-            for (const auto& frag : list.fragments) {
-                reassembled.insert(reassembled.end(), frag.second.begin(), frag.second.end());
-            }
+// ============================================================================
+// Datagram table
+// ============================================================================
 
-            active_reassemblies_.erase(key);
-            return reassembled;
-        }
+uint32_t IpReassembler::createDatagram(const Key& key, uint32_t hash, Timestamp now) {
+    if (datagrams_.size() >= limits_.max_datagrams) {
+        removeDatagram(datagrams_.oldest());
+        stats_.evicted++;
     }
 
-    return std::nullopt;
+    uint32_t index = datagrams_.insert(key, hash);
+    Datagram& dgram = datagrams_[index];
+    dgram.created = now;
+    dgram.header_len = 0;
+    dgram.total_length = kOpenEnd;
+    dgram.holes.assign(1, Hole{0, kOpenEnd});
+    return index;
+}
+
+void IpReassembler::removeDatagram(uint32_t index) {
+    Datagram& dgram = datagrams_[index];
+    buffered_bytes_ -= dgram.buffer.size();
+    std::vector<uint8_t>().swap(dgram.buffer);
+    dgram.holes.clear();
+    datagrams_.erase(index);
+}
+
+bool IpReassembler::reserve(uint32_t index, size_t size) {
+    size_t current = datagrams_[index].buffer.size();
+    if (size <= current) {
+        return true;
+    }
+    size_t extra = size - current;
+    while (buffered_bytes_ + extra > limits_.memory_budget_bytes) {
+        uint32_t oldest = datagrams_.oldest();
+        if (oldest == index) {
+            stats_.evicted++;
+            return false;
+        }
+        removeDatagram(oldest);
+        stats_.evicted++;
+    }
+    datagrams_[index].buffer.resize(size);
+    buffered_bytes_ += extra;
+    return true;
 }
 
 }  // namespace callflow
@@ -7,7 +7,6 @@
 #include <netinet/udp.h>
 
 #include "common/logger.h"
-#include "common/utils.h"
 #include "ndpi_engine/protocol_detector.h"
 #include "protocol_parsers/diameter_parser.h"
 #include "protocol_parsers/gtp_parser.h"
@@ -19,17 +18,28 @@
 #include "protocol_parsers/rtp_parser.h"
 #include "protocol_parsers/s1ap/s1ap_parser.h"
 #include "protocol_parsers/sip_parser.h"
+#include "protocol_parsers/sip_scanner.h"
 
 namespace callflow {
 
-PacketProcessor::PacketProcessor(EnhancedSessionCorrelator& correlator) : correlator_(correlator) {
+PacketProcessor::PacketProcessor(EnhancedSessionCorrelator& correlator)
+    : PacketProcessor(correlator, std::make_shared<SipPortTracker>(),
+                      std::make_shared<DynamicPortTracker>()) {}
+
+PacketProcessor::PacketProcessor(EnhancedSessionCorrelator& correlator,
+                                 std::shared_ptr<SipPortTracker> sip_port_tracker,
+                                 std::shared_ptr<DynamicPortTracker> dynamic_port_tracker)
+    : correlator_(correlator),
+      dynamic_port_tracker_(std::move(dynamic_port_tracker)),
+      sip_port_tracker_(std::move(sip_port_tracker)) {
     // Set up SCTP message callback for reassembled messages
     sctp_parser_.setMessageCallback([this](const SctpReassembledMessage& message) {
-        // Create temporary metadata for SCTP message
-        // Note: We need to pass proper metadata through the callback in production
+        // Reassembled messages are delivered synchronously while the chunk that
+        // completed them is parsed, so the current frame is the right context
         PacketMetadata metadata;
-        metadata.packet_id = utils::generateUuid();
-        metadata.timestamp = std::chrono::system_clock::now();
+        metadata.packet_id = makePacketId(job_tag_, current_frame_);
+        metadata.timestamp = current_ts_;
+        metadata.frame_number = current_frame_;
         metadata.detected_protocol = ProtocolType::SCTP;
 
         // Process the reassembled message
@@ -39,6 +49,8 @@ PacketProcessor::PacketProcessor(EnhancedSessionCorrelator& correlator) : correl
 
 void PacketProcessor::processPacket(const uint8_t* data, size_t len, Timestamp ts,
                                     uint32_t frame_number, int dlt) {
+    beginFrame(frame_number, ts);
+
     uint16_t eth_type = 0;
     int offset = link_parser_.parse(data, len, dlt, eth_type);
 
@@ -59,15 +71,67 @@ void PacketProcessor::processPacket(const uint8_t* data, size_t len, Timestamp t
 
     // Pass to IP Reassembler
     // Note: LinkLayerParser returns offset to IP header.
-    auto reassembled_opt = ip_reassembler_.processPacket(data + offset, len - offset);
+    auto reassembled_opt = ip_reassembler_.processPacket(data + offset, len - offset, ts);
 
     if (reassembled_opt.has_value()) {
         processIpPacket(reassembled_opt.value(), ts, frame_number);
     }
 }
 
-void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Timestamp ts,
-                                      uint32_t frame_number, int recursion_depth) {
+void PacketProcessor::processIpDatagram(ByteView ip_packet, Timestamp ts,
+                                        uint32_t frame_number) {
+    beginFrame(frame_number, ts);
+    processIpPacket(ip_packet, ts, frame_number);
+}
+
+void PacketProcessor::beginFrame(uint32_t frame_number, Timestamp ts) {
+    current_frame_ = frame_number;
+    current_ts_ = ts;
+    frame_sequence_ = 0;
+}
+
+void PacketProcessor::renderAddresses(PacketMetadata& metadata) {
+    if (metadata.five_tuple.src_ip.empty() && metadata.flow_key.src_ip.isValid()) {
+        metadata.five_tuple.src_ip = metadata.flow_key.src_ip.toString();
+        metadata.five_tuple.dst_ip = metadata.flow_key.dst_ip.toString();
+    }
+}
+
+void PacketProcessor::submitPacket(PacketMetadata& metadata, ProtocolType protocol,
+                                   const nlohmann::json& parsed_data) {
+    renderAddresses(metadata);
+    if (!deferred_output_) {
+        correlator_.processPacket(metadata, protocol, parsed_data);
+        return;
+    }
+
+    DeferredCorrelatorInput input;
+    input.frame_number = current_frame_;
+    input.sequence = frame_sequence_++;
+    input.metadata = metadata;
+    input.protocol = protocol;
+    input.parsed_data = parsed_data;
+    deferred_output_->push_back(std::move(input));
+}
+
+void PacketProcessor::submitSipMessage(const SipMessage& msg, PacketMetadata& metadata) {
+    renderAddresses(metadata);
+    if (!deferred_output_) {
+        correlator_.processSipMessage(msg, metadata);
+        return;
+    }
+
+    DeferredCorrelatorInput input;
+    input.frame_number = current_frame_;
+    input.sequence = frame_sequence_++;
+    input.metadata = metadata;
+    input.protocol = ProtocolType::SIP;
+    input.sip_message = msg;
+    deferred_output_->push_back(std::move(input));
+}
+
+void PacketProcessor::processIpPacket(ByteView ip_packet, Timestamp ts, uint32_t frame_number,
+                                      int recursion_depth) {
     // Prevent infinite recursion (tunnel loops)
     if (recursion_depth > 5) {
         LOG_WARN("Max recursion depth reached for packet " << frame_number);
@@ -77,7 +141,7 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
         return;
 
     PacketMetadata metadata;
-    metadata.packet_id = utils::generateUuid();
+    metadata.packet_id = makePacketId(job_tag_, frame_number);
     metadata.timestamp = ts;
     metadata.frame_number = frame_number;
     metadata.packet_length = ip_packet.size();  // Approximate "captured length"
@@ -99,14 +163,8 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
         if (len < hlen)
             return;
 
-        char src_str[INET_ADDRSTRLEN];
-        char dst_str[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &(header->ip_src), src_str, INET_ADDRSTRLEN);
-        inet_ntop(AF_INET, &(header->ip_dst), dst_str, INET_ADDRSTRLEN);
-
-        metadata.five_tuple.src_ip = src_str;
-        metadata.five_tuple.dst_ip = dst_str;
-        metadata.five_tuple.protocol = header->ip_p;
+        metadata.flow_key.src_ip = IpAddress::fromV4(ip_data + 12);
+        metadata.flow_key.dst_ip = IpAddress::fromV4(ip_data + 16);
         protocol = header->ip_p;
 
         trans_data = ip_data + hlen;
@@ -117,15 +175,8 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
             return;
         const struct ip6_hdr* header = reinterpret_cast<const struct ip6_hdr*>(ip_data);
 
-        char src_str[INET6_ADDRSTRLEN];
-        char dst_str[INET6_ADDRSTRLEN];
-        inet_ntop(AF_INET6, &(header->ip6_src), src_str, INET6_ADDRSTRLEN);
-        inet_ntop(AF_INET6, &(header->ip6_dst), dst_str, INET6_ADDRSTRLEN);
-
-        metadata.five_tuple.src_ip = src_str;
-        metadata.five_tuple.dst_ip = dst_str;
-        metadata.five_tuple.protocol =
-            header->ip6_nxt;         // Limitation: doesn't skip ext headers here
+        metadata.flow_key.src_ip = IpAddress::fromV6(ip_data + 8);
+        metadata.flow_key.dst_ip = IpAddress::fromV6(ip_data + 24);
         protocol = header->ip6_nxt;  // TODO: skip extension headers logic again?
         // IpReassembler already handled fragments, but could be other headers.
         // Assuming standard NextHeader for now.
@@ -139,6 +190,9 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
     if (!trans_data)
         return;
 
+    metadata.five_tuple.protocol = protocol;
+    metadata.flow_key.protocol = protocol;
+
     // Parse Transport
     if (protocol == IPPROTO_UDP) {
         if (trans_len < 8)
@@ -146,14 +200,13 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
         const struct udphdr* udp = reinterpret_cast<const struct udphdr*>(trans_data);
         metadata.five_tuple.src_port = ntohs(udp->uh_sport);
         metadata.five_tuple.dst_port = ntohs(udp->uh_dport);
+        metadata.flow_key.src_port = metadata.five_tuple.src_port;
+        metadata.flow_key.dst_port = metadata.five_tuple.dst_port;
 
-        // Payload
+        // Payload is dispatched in place; nothing downstream keeps the view
         if (trans_len > 8) {
-            std::vector<uint8_t> payload(trans_data + 8, trans_data + trans_len);
-            metadata.raw_data = payload;
-
-            // UDP Payload dispatch
-            processTransportAndPayload(metadata, payload, recursion_depth);
+            processTransportAndPayload(metadata, ByteView(trans_data + 8, trans_len - 8),
+                                       recursion_depth);
         }
 
     } else if (protocol == IPPROTO_TCP) {
@@ -162,26 +215,24 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
         const struct tcphdr* tcp = reinterpret_cast<const struct tcphdr*>(trans_data);
         metadata.five_tuple.src_port = ntohs(tcp->th_sport);
         metadata.five_tuple.dst_port = ntohs(tcp->th_dport);
+        metadata.flow_key.src_port = metadata.five_tuple.src_port;
+        metadata.flow_key.dst_port = metadata.five_tuple.dst_port;
 
         size_t tcp_hlen = tcp->th_off * 4;
         if (trans_len < tcp_hlen)
             return;
 
-        std::vector<uint8_t> payload;
-        if (trans_len > tcp_hlen) {
-            payload.assign(trans_data + tcp_hlen, trans_data + trans_len);
-        }
+        ByteView payload(trans_data + tcp_hlen, trans_len - tcp_hlen);
 
         // Reassemble TCP
         uint32_t seq = ntohl(tcp->th_seq);
         bool is_syn = (tcp->th_flags & TH_SYN);
         bool is_fin = (tcp->th_flags & TH_FIN);
 
-        auto reassembled =
-            tcp_reassembler_.processSegment(metadata.five_tuple, seq, payload, is_syn, is_fin);
+        ByteView reassembled = tcp_reassembler_.processSegment(metadata.flow_key, seq, payload,
+                                                               is_syn, is_fin, metadata.timestamp);
 
         if (!reassembled.empty()) {
-            metadata.raw_data = reassembled;
             processTransportAndPayload(metadata, reassembled, recursion_depth);
         }
     } else if (protocol == 132) {  // SCTP
@@ -193,36 +244,21 @@ void PacketProcessor::processIpPacket(const std::vector<uint8_t>& ip_packet, Tim
         // Extract ports from SCTP common header
         metadata.five_tuple.src_port = ntohs(*reinterpret_cast<const uint16_t*>(trans_data));
         metadata.five_tuple.dst_port = ntohs(*reinterpret_cast<const uint16_t*>(trans_data + 2));
+        metadata.flow_key.src_port = metadata.five_tuple.src_port;
+        metadata.flow_key.dst_port = metadata.five_tuple.dst_port;
 
-        // Parse SCTP packet with full reassembly support
-        auto sctp_packet_opt = sctp_parser_.parse(trans_data, trans_len, metadata.five_tuple);
+        // Association ids are derived from the textual tuple
+        renderAddresses(metadata);
 
-        if (sctp_packet_opt.has_value()) {
-            // Update metadata with SCTP protocol
+        // Track the association and reassemble DATA chunks; complete messages
+        // are delivered via the callback set in the constructor
+        if (sctp_parser_.process(trans_data, trans_len, metadata.five_tuple)) {
             metadata.detected_protocol = ProtocolType::SCTP;
-            metadata.raw_data.assign(trans_data, trans_data + trans_len);
-
-            // Log association state changes
-            auto assoc_ids = sctp_parser_.getAssociationIds();
-            for (auto assoc_id : assoc_ids) {
-                auto assoc_opt = sctp_parser_.getAssociation(assoc_id);
-                if (assoc_opt.has_value()) {
-                    const auto& assoc = assoc_opt.value();
-                    LOG_DEBUG("SCTP association "
-                              << assoc_id << " state: " << static_cast<int>(assoc.state)
-                              << " streams: " << assoc.num_outbound_streams << "/"
-                              << assoc.num_inbound_streams);
-                }
-            }
-
-            // Note: Reassembled messages are delivered via callback set in constructor
-            // See PacketProcessor constructor for callback setup
         }
     }
 }
 
-void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
-                                                 const std::vector<uint8_t>& payload,
+void PacketProcessor::processTransportAndPayload(PacketMetadata& metadata, ByteView payload,
                                                  int recursion_depth) {
     // Protocol Detection Strategy:
     // 1. PRIORITY: Content-based SIP detection for ALL TCP/UDP (catches non-standard ports)
@@ -246,20 +282,20 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                                                            << metadata.five_tuple.dst_port);
 
             // Register non-standard SIP ports for future fast-path detection
-            sip_port_tracker_.registerSipPort(metadata.five_tuple.src_port);
-            sip_port_tracker_.registerSipPort(metadata.five_tuple.dst_port);
+            sip_port_tracker_->registerSipPort(metadata.five_tuple.src_port);
+            sip_port_tracker_->registerSipPort(metadata.five_tuple.dst_port);
 
             if (metadata.five_tuple.protocol == IPPROTO_TCP) {
                 // TCP SIP - use existing TCP session handling with message boundary detection
-                auto& buffer = sip_tcp_buffers_[metadata.five_tuple];
+                auto& buffer = sip_tcp_buffers_[metadata.flow_key];
                 buffer.appendData(payload.data(), payload.size());
 
                 auto messages = buffer.extractCompleteMessages();
                 for (const auto& msg_data : messages) {
                     SipParser parser;
-                    auto sip_msg = parser.parse(msg_data.data(), msg_data.size());
+                    auto sip_msg = parser.parse(msg_data.data, msg_data.size);
                     if (sip_msg.has_value()) {
-                        correlator_.processSipMessage(sip_msg.value(), metadata);
+                        submitSipMessage(sip_msg.value(), metadata);
                     }
                 }
 
@@ -273,7 +309,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                 SipParser parser;
                 auto msg = parser.parse(payload.data(), payload.size());
                 if (msg.has_value()) {
-                    correlator_.processSipMessage(msg.value(), metadata);
+                    submitSipMessage(msg.value(), metadata);
                 }
             }
             return;
@@ -287,7 +323,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
         PfcpParser parser;
         auto msg = parser.parse(payload.data(), payload.size());
         if (msg.has_value()) {
-            correlator_.processPacket(metadata, ProtocolType::PFCP, msg->toJson());
+            submitPacket(metadata, ProtocolType::PFCP, msg->toJson());
             return;
         }
     }
@@ -298,7 +334,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
         GtpParser parser;
         auto msg = parser.parse(payload.data(), payload.size());
         if (msg.has_value()) {
-            correlator_.processPacket(metadata, ProtocolType::GTP_C, msg->toJson());
+            submitPacket(metadata, ProtocolType::GTP_C, msg->toJson());
             return;
         }
     }
@@ -311,89 +347,14 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
         auto msg = parser.parse(payload.data(), payload.size());
         if (msg.has_value()) {
             // Process the GTP-U packet itself
-            correlator_.processPacket(metadata, ProtocolType::GTP_U, msg->toJson());
+            submitPacket(metadata, ProtocolType::GTP_U, msg->toJson());
 
-            // Process inner payload with proper 5-tuple extraction
+            // Process inner payload; the recursive pass builds the inner flow key
             if (!msg->user_data.empty() && msg->user_data.size() >= 20) {
-                const uint8_t* inner_ip = msg->user_data.data();
-                size_t inner_len = msg->user_data.size();
-                uint8_t ip_version = (inner_ip[0] >> 4) & 0x0F;
-
-                // Create NEW metadata for inner packet with GTP context
-                PacketMetadata inner_metadata;
-                inner_metadata.packet_id = utils::generateUuid();
-                inner_metadata.timestamp = metadata.timestamp;
-                inner_metadata.frame_number = metadata.frame_number;
-                inner_metadata.interface_id = metadata.interface_id;
-                inner_metadata.gtp_teid = msg->header.teid;
-                inner_metadata.is_gtp_encapsulated = true;
-                inner_metadata.packet_length = inner_len;
-
-                bool valid_inner = false;
-
-                if (ip_version == 4 && inner_len >= 20) {
-                    // IPv4 inner packet
-                    const struct ip* iph = reinterpret_cast<const struct ip*>(inner_ip);
-                    char src_str[INET_ADDRSTRLEN];
-                    char dst_str[INET_ADDRSTRLEN];
-                    inet_ntop(AF_INET, &(iph->ip_src), src_str, INET_ADDRSTRLEN);
-                    inet_ntop(AF_INET, &(iph->ip_dst), dst_str, INET_ADDRSTRLEN);
-
-                    inner_metadata.five_tuple.src_ip = src_str;
-                    inner_metadata.five_tuple.dst_ip = dst_str;
-                    inner_metadata.five_tuple.protocol = iph->ip_p;
-
-                    size_t ip_hdr_len = iph->ip_hl * 4;
-                    if (inner_len > ip_hdr_len + 4) {
-                        const uint8_t* trans = inner_ip + ip_hdr_len;
-                        if (iph->ip_p == IPPROTO_TCP || iph->ip_p == IPPROTO_UDP) {
-                            inner_metadata.five_tuple.src_port =
-                                ntohs(*reinterpret_cast<const uint16_t*>(trans));
-                            inner_metadata.five_tuple.dst_port =
-                                ntohs(*reinterpret_cast<const uint16_t*>(trans + 2));
-                        }
-                        valid_inner = true;
-                    }
-                } else if (ip_version == 6 && inner_len >= 40) {
-                    // IPv6 inner packet
-                    const struct ip6_hdr* ip6h = reinterpret_cast<const struct ip6_hdr*>(inner_ip);
-                    char src_str[INET6_ADDRSTRLEN];
-                    char dst_str[INET6_ADDRSTRLEN];
-                    inet_ntop(AF_INET6, &(ip6h->ip6_src), src_str, INET6_ADDRSTRLEN);
-                    inet_ntop(AF_INET6, &(ip6h->ip6_dst), dst_str, INET6_ADDRSTRLEN);
-
-                    inner_metadata.five_tuple.src_ip = src_str;
-                    inner_metadata.five_tuple.dst_ip = dst_str;
-                    inner_metadata.five_tuple.protocol = ip6h->ip6_nxt;
-
-                    if (inner_len > 40 + 4) {
-                        const uint8_t* trans = inner_ip + 40;
-                        if (ip6h->ip6_nxt == IPPROTO_TCP || ip6h->ip6_nxt == IPPROTO_UDP) {
-                            inner_metadata.five_tuple.src_port =
-                                ntohs(*reinterpret_cast<const uint16_t*>(trans));
-                            inner_metadata.five_tuple.dst_port =
-                                ntohs(*reinterpret_cast<const uint16_t*>(trans + 2));
-                        }
-                        valid_inner = true;
-                    }
-                }
-
-                if (valid_inner) {
-                    LOG_DEBUG("GTP-U inner packet: TEID=" << msg->header.teid << " inner 5-tuple: "
-                                                          << inner_metadata.five_tuple.src_ip << ":"
-                                                          << inner_metadata.five_tuple.src_port
-                                                          << " -> "
-                                                          << inner_metadata.five_tuple.dst_ip << ":"
-                                                          << inner_metadata.five_tuple.dst_port);
-
-                    // Process inner IP packet with correct metadata
-                    processIpPacket(msg->user_data, metadata.timestamp, metadata.frame_number,
-                                    recursion_depth + 1);
-                } else {
-                    // Fallback to basic processing if parsing fails
-                    processIpPacket(msg->user_data, metadata.timestamp, metadata.frame_number,
-                                    recursion_depth + 1);
-                }
+                LOG_DEBUG("GTP-U inner packet: TEID=" << msg->header.teid
+                                                      << " len=" << msg->user_data.size());
+                processIpPacket(msg->user_data, metadata.timestamp, metadata.frame_number,
+                                recursion_depth + 1);
             }
             return;
         }
@@ -402,7 +363,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
     // Diameter (TCP/UDP 3868)
     if (metadata.five_tuple.src_port == 3868 || metadata.five_tuple.dst_port == 3868) {
         if (metadata.five_tuple.protocol == IPPROTO_TCP) {
-            auto& session = diameter_sessions_[metadata.five_tuple];
+            auto& session = diameter_sessions_[metadata.flow_key];
             session.buffer.insert(session.buffer.end(), payload.begin(), payload.end());
 
             while (session.buffer.size() >= 4) {
@@ -414,7 +375,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     DiameterParser parser;
                     auto msg = parser.parse(session.buffer.data(), msg_length);
                     if (msg.has_value()) {
-                        correlator_.processPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
+                        submitPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
                     }
                     session.buffer.erase(session.buffer.begin(),
                                          session.buffer.begin() + msg_length);
@@ -427,25 +388,25 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
             DiameterParser parser;
             auto msg = parser.parse(payload.data(), payload.size());
             if (msg.has_value()) {
-                correlator_.processPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
+                submitPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
             }
         }
         return;
     }
 
     // SIP (UDP/TCP) - Enhanced with dynamic port tracking and message boundary detection
-    if (sip_port_tracker_.isSipPort(metadata.five_tuple.src_port) ||
-        sip_port_tracker_.isSipPort(metadata.five_tuple.dst_port)) {
+    if (sip_port_tracker_->isSipPort(metadata.five_tuple.src_port) ||
+        sip_port_tracker_->isSipPort(metadata.five_tuple.dst_port)) {
         if (metadata.five_tuple.protocol == IPPROTO_TCP) {
             // Enhanced TCP reassembly with SipTcpStreamBuffer
-            auto& buffer = sip_tcp_buffers_[metadata.five_tuple];
+            auto& buffer = sip_tcp_buffers_[metadata.flow_key];
             buffer.appendData(payload.data(), payload.size());
 
             // Extract all complete messages
             auto messages = buffer.extractCompleteMessages();
             for (const auto& msg_data : messages) {
                 SipParser parser;
-                auto sip_msg = parser.parse(msg_data.data(), msg_data.size());
+                auto sip_msg = parser.parse(msg_data.data, msg_data.size);
                 if (sip_msg.has_value()) {
                     // Fix timestamp discrepancy: Propagate timestamp from metadata
                     auto& m = sip_msg.value();
@@ -456,16 +417,14 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                              << std::fixed << ts_sec << " Frame: " << metadata.frame_number);
                     m.timestamp = ts_sec;
 
-                    correlator_.processSipMessage(m, metadata);
+                    submitSipMessage(m, metadata);
                 }
             }
 
             // Cleanup if buffer too large (overflow protection)
             if (buffer.getBufferSize() > SipTcpStreamBuffer::MAX_BUFFER_SIZE) {
                 LOG_WARN("SIP TCP buffer overflow, resetting for "
-                         << metadata.five_tuple.src_ip << ":" << metadata.five_tuple.src_port
-                         << " -> " << metadata.five_tuple.dst_ip << ":"
-                         << metadata.five_tuple.dst_port);
+                         << metadata.flow_key.toString());
                 buffer.reset();
             }
         } else {
@@ -493,7 +452,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                 m.timestamp = ts_sec;
 
                 // Pass to correlator
-                correlator_.processSipMessage(m, metadata);
+                submitSipMessage(m, metadata);
             }
         }
         return;
@@ -511,8 +470,8 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
 
         // Check dynamic port tracker (ports learned from SDP)
         if (!is_rtp_candidate &&
-            (dynamic_port_tracker_.isKnownRtpPort(metadata.five_tuple.src_port) ||
-             dynamic_port_tracker_.isKnownRtpPort(metadata.five_tuple.dst_port))) {
+            (dynamic_port_tracker_->isKnownRtpPort(metadata.five_tuple.src_port) ||
+             dynamic_port_tracker_->isKnownRtpPort(metadata.five_tuple.dst_port))) {
             is_rtp_candidate = true;
             LOG_DEBUG("RTP port matched via dynamic port tracker: src="
                       << metadata.five_tuple.src_port << " dst=" << metadata.five_tuple.dst_port);
@@ -522,7 +481,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
             RtpParser parser;
             auto header = parser.parseRtp(payload.data(), payload.size());
             if (header.has_value()) {
-                correlator_.processPacket(metadata, ProtocolType::RTP, header->toJson());
+                submitPacket(metadata, ProtocolType::RTP, header->toJson());
                 return;
             }
         }
@@ -552,8 +511,8 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     if (payload.size() >= 10 &&
                         SipParser::isSipMessage(payload.data(), payload.size())) {
                         // Register non-standard SIP ports for future fast-path detection
-                        sip_port_tracker_.registerSipPort(metadata.five_tuple.src_port);
-                        sip_port_tracker_.registerSipPort(metadata.five_tuple.dst_port);
+                        sip_port_tracker_->registerSipPort(metadata.five_tuple.src_port);
+                        sip_port_tracker_->registerSipPort(metadata.five_tuple.dst_port);
 
                         SipParser parser;
                         auto msg = parser.parse(payload.data(), payload.size());
@@ -563,7 +522,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                             m.timestamp = std::chrono::duration_cast<std::chrono::duration<double>>(
                                               metadata.timestamp.time_since_epoch())
                                               .count();
-                            correlator_.processSipMessage(m, metadata);
+                            submitSipMessage(m, metadata);
                             return;
                         }
                     } else {
@@ -576,7 +535,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     DiameterParser parser;
                     auto msg = parser.parse(payload.data(), payload.size());
                     if (msg.has_value()) {
-                        correlator_.processPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
+                        submitPacket(metadata, ProtocolType::DIAMETER, msg->toJson());
                         return;
                     }
                     break;
@@ -586,7 +545,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     GtpParser parser;
                     auto msg = parser.parse(payload.data(), payload.size());
                     if (msg.has_value()) {
-                        correlator_.processPacket(metadata, ProtocolType::GTP_C, msg->toJson());
+                        submitPacket(metadata, ProtocolType::GTP_C, msg->toJson());
                         return;
                     }
                     break;
@@ -596,7 +555,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     GtpV1Parser parser;
                     auto msg = parser.parse(payload.data(), payload.size());
                     if (msg.has_value()) {
-                        correlator_.processPacket(metadata, ProtocolType::GTP_U, msg->toJson());
+                        submitPacket(metadata, ProtocolType::GTP_U, msg->toJson());
 
                         // Recursive processing for inner payload
                         if (!msg->user_data.empty()) {
@@ -612,7 +571,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     RtpParser parser;
                     auto header = parser.parseRtp(payload.data(), payload.size());
                     if (header.has_value()) {
-                        correlator_.processPacket(metadata, ProtocolType::RTP, header->toJson());
+                        submitPacket(metadata, ProtocolType::RTP, header->toJson());
                         return;
                     }
                     break;
@@ -645,7 +604,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
 
     if (possibly_http2) {
         // Get session state
-        auto& connection = http2_sessions_[metadata.five_tuple];
+        auto& connection = http2_sessions_[metadata.flow_key];
 
         // Append new data to connection buffer
         connection.buffer.insert(connection.buffer.end(), payload.begin(), payload.end());
@@ -710,7 +669,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                 // Check for 5G SBA (using correct parser instance)
                 auto sba_event = sba_parser_.parse(stream);
                 if (sba_event) {
-                    correlator_.processPacket(metadata, ProtocolType::HTTP2, sba_event->toJson());
+                    submitPacket(metadata, ProtocolType::HTTP2, sba_event->toJson());
 
                     // Cleanup stream
                     it = connection.streams.erase(it);
@@ -745,7 +704,7 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
                     }
                 }
 
-                correlator_.processPacket(metadata, ProtocolType::NGAP, json);
+                submitPacket(metadata, ProtocolType::NGAP, json);
                 return;
             }
         }
@@ -753,12 +712,15 @@ void PacketProcessor::processTransportAndPayload(const PacketMetadata& metadata,
 }
 
 void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
-                                         const PacketMetadata& metadata) {
+                                         PacketMetadata& metadata) {
+    // A view into the packet or the reassembler, valid for this call
+    const ByteView payload = message.payload();
+
     LOG_DEBUG("Processing SCTP message: stream_id="
               << message.stream_id << " ssn=" << message.stream_sequence
               << " ppid=" << message.payload_protocol << " ("
               << getSctpPpidName(message.payload_protocol) << ")"
-              << " length=" << message.data.size());
+              << " length=" << payload.size());
 
     // Route based on PPID (Payload Protocol Identifier)
     switch (message.payload_protocol) {
@@ -766,10 +728,9 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
             LOG_DEBUG("SCTP PPID 0 (unstructured) - attempting SIP detection");
 
             // Try SIP detection
-            if (message.data.size() >= 10 &&
-                SipParser::isSipMessage(message.data.data(), message.data.size())) {
+            if (payload.size() >= 10 && SipParser::isSipMessage(payload.data(), payload.size())) {
                 SipParser parser;
-                auto sip_msg = parser.parse(message.data.data(), message.data.size());
+                auto sip_msg = parser.parse(payload.data(), payload.size());
                 if (sip_msg.has_value()) {
                     LOG_INFO("SIP message detected over SCTP (PPID 0)");
                     // Fix timestamp discrepancy: Propagate timestamp from metadata
@@ -777,20 +738,20 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
                     msg.timestamp = std::chrono::duration_cast<std::chrono::duration<double>>(
                                         metadata.timestamp.time_since_epoch())
                                         .count();
-                    correlator_.processSipMessage(msg, metadata);
+                    submitSipMessage(msg, metadata);
                     return;
                 }
             }
 
             // If not SIP, log and continue
-            LOG_DEBUG("SCTP PPID 0 data is not SIP, length=" << message.data.size());
+            LOG_DEBUG("SCTP PPID 0 data is not SIP, length=" << payload.size());
             break;
         }
 
         case 18: {  // S1AP
             LOG_DEBUG("Routing SCTP payload to S1AP parser");
             s1ap::S1APParser s1ap_parser;
-            auto s1ap_msg = s1ap_parser.parse(message.data.data(), message.data.size());
+            auto s1ap_msg = s1ap_parser.parse(payload.data(), payload.size());
             if (s1ap_msg.has_value()) {
                 auto& msg = s1ap_msg.value();
                 auto json = msg.toJson();
@@ -806,7 +767,7 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
                     }
                 }
 
-                correlator_.processPacket(metadata, ProtocolType::S1AP, json);
+                submitPacket(metadata, ProtocolType::S1AP, json);
             }
             break;
         }
@@ -820,9 +781,9 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
         case 46: {  // Diameter over SCTP
             LOG_DEBUG("Routing SCTP payload to Diameter parser");
             DiameterParser diameter_parser;
-            auto diameter_msg = diameter_parser.parse(message.data.data(), message.data.size());
+            auto diameter_msg = diameter_parser.parse(payload.data(), payload.size());
             if (diameter_msg.has_value()) {
-                correlator_.processPacket(metadata, ProtocolType::DIAMETER, diameter_msg->toJson());
+                submitPacket(metadata, ProtocolType::DIAMETER, diameter_msg->toJson());
             }
             break;
         }
@@ -830,7 +791,7 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
         case 60: {  // NGAP (5G)
             LOG_DEBUG("Routing SCTP payload to NGAP parser");
             NgapParser ngap_parser;
-            auto ngap_msg = ngap_parser.parse(message.data.data(), message.data.size());
+            auto ngap_msg = ngap_parser.parse(payload.data(), payload.size());
             if (ngap_msg.has_value()) {
                 auto& msg = ngap_msg.value();
                 auto json = msg.toJson();
@@ -846,7 +807,7 @@ void PacketProcessor::processSctpMessage(const SctpReassembledMessage& message,
                     }
                 }
 
-                correlator_.processPacket(metadata, ProtocolType::NGAP, json);
+                submitPacket(metadata, ProtocolType::NGAP, json);
             }
             break;
         }
@@ -960,34 +921,35 @@ std::set<uint16_t> SipPortTracker::getAllSipPorts() const {
 // ============================================================================
 
 void PacketProcessor::SipTcpStreamBuffer::appendData(const uint8_t* data, size_t len) {
+    // Views from the last extraction are no longer in use; compact once here
+    // instead of erasing after every message
+    if (read_pos_ > 0) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + read_pos_);
+        read_pos_ = 0;
+    }
     buffer_.insert(buffer_.end(), data, data + len);
 }
 
-std::vector<std::vector<uint8_t>> PacketProcessor::SipTcpStreamBuffer::extractCompleteMessages() {
-    std::vector<std::vector<uint8_t>> messages;
+std::vector<PacketProcessor::SipTcpStreamBuffer::MessageView>
+PacketProcessor::SipTcpStreamBuffer::extractCompleteMessages() {
+    std::vector<MessageView> messages;
 
-    while (true) {
-        auto boundary_opt = findMessageBoundary(0);
-        if (!boundary_opt.has_value()) {
+    while (read_pos_ < buffer_.size()) {
+        const uint8_t* start = buffer_.data() + read_pos_;
+        size_t msg_len = sip::completeMessageLength(start, buffer_.size() - read_pos_);
+        if (msg_len == 0) {
             break;  // No complete message found
         }
-
-        size_t msg_len = boundary_opt.value();
+        read_pos_ += msg_len;
 
         // Sanity check
         if (msg_len > MAX_SIP_MESSAGE_SIZE) {
             LOG_WARN("SIP message exceeds maximum size (" << msg_len << " > "
                                                           << MAX_SIP_MESSAGE_SIZE << "), skipping");
-            buffer_.erase(buffer_.begin(), buffer_.begin() + msg_len);
             continue;
         }
 
-        // Extract message
-        std::vector<uint8_t> message(buffer_.begin(), buffer_.begin() + msg_len);
-        messages.push_back(std::move(message));
-
-        // Remove from buffer
-        buffer_.erase(buffer_.begin(), buffer_.begin() + msg_len);
+        messages.push_back({start, msg_len});
     }
 
     return messages;
@@ -995,57 +957,7 @@ std::vector<std::vector<uint8_t>> PacketProcessor::SipTcpStreamBuffer::extractCo
 
 void PacketProcessor::SipTcpStreamBuffer::reset() {
     buffer_.clear();
-}
-
-std::optional<size_t> PacketProcessor::SipTcpStreamBuffer::findMessageBoundary(
-    size_t start_pos) const {
-    if (start_pos >= buffer_.size()) {
-        return std::nullopt;
-    }
-
-    // Look for "\r\n\r\n" (end of SIP headers)
-    const std::string crlf2 = "\r\n\r\n";
-    auto it = std::search(buffer_.begin() + start_pos, buffer_.end(), crlf2.begin(), crlf2.end());
-
-    if (it == buffer_.end()) {
-        return std::nullopt;  // Headers incomplete
-    }
-
-    // Calculate header length including double CRLF
-    size_t headers_len = std::distance(buffer_.begin(), it) + 4;
-
-    // Parse headers to find Content-Length
-    std::string headers(buffer_.begin() + start_pos, buffer_.begin() + start_pos + headers_len);
-    int content_len = 0;
-
-    // Search for Content-Length header (case-insensitive)
-    auto pos = headers.find("Content-Length:");
-    if (pos == std::string::npos) {
-        pos = headers.find("content-length:");  // lowercase
-    }
-    if (pos == std::string::npos) {
-        pos = headers.find("l:");  // Compact form
-    }
-    if (pos == std::string::npos) {
-        pos = headers.find("L:");  // Compact form uppercase
-    }
-
-    if (pos != std::string::npos) {
-        // Extract number
-        size_t val_start = headers.find_first_of("0123456789", pos);
-        if (val_start != std::string::npos) {
-            content_len = std::atoi(headers.c_str() + val_start);
-        }
-    }
-
-    size_t total_len = headers_len + content_len;
-
-    // Check if we have the complete message
-    if (buffer_.size() >= start_pos + total_len) {
-        return total_len;
-    }
-
-    return std::nullopt;  // Body incomplete
+    read_pos_ = 0;
 }
 
 // ============================================================================
@@ -1061,7 +973,7 @@ bool PacketProcessor::isSipPort(uint16_t port) {
 
 PacketMetadata PacketProcessor::createMetadataFromTcp(const FiveTuple& ft, Timestamp ts) const {
     PacketMetadata metadata;
-    metadata.packet_id = utils::generateUuid();
+    metadata.packet_id = makePacketId(job_tag_, current_frame_);
     metadata.timestamp = ts;
     metadata.five_tuple = ft;
     metadata.detected_protocol = ProtocolType::SIP;
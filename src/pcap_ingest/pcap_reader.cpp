@@ -1,8 +1,26 @@
 #include "pcap_ingest/pcap_reader.h"
 #include "common/utils.h"
 
+#include <cstring>
+#include <filesystem>
+
 namespace callflow {
 
+namespace {
+
+constexpr uint32_t PCAP_MAGIC_USEC = 0xa1b2c3d4;
+constexpr uint32_t PCAP_MAGIC_NSEC = 0xa1b23c4d;
+constexpr size_t PCAP_GLOBAL_HEADER_LEN = 24;
+constexpr size_t PCAP_RECORD_HEADER_LEN = 16;
+
+uint32_t readU32(const uint8_t* p, bool swapped) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return swapped ? __builtin_bswap32(value) : value;
+}
+
+}  // namespace
+
 PcapReader::PcapReader()
     : pcap_handle_(nullptr),
       datalink_type_(-1),
@@ -21,6 +39,21 @@ bool PcapReader::open(const std::string& filename) {
         close();
     }
 
+    std::error_code ec;
+    file_size_ = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        file_size_ = 0;
+    }
+
+    if (use_mmap_ && openMapped(filename)) {
+        filename_ = filename;
+        is_open_ = true;
+        LOG_INFO("Opened PCAP file: " << filename << " (datalink=" << datalink_type_
+                                      << ", snaplen=" << snaplen_ << ", mmap)");
+        resetStats();
+        return true;
+    }
+
     char errbuf[PCAP_ERRBUF_SIZE];
     pcap_handle_ = pcap_open_offline(filename.c_str(), errbuf);
 
@@ -42,11 +75,43 @@ bool PcapReader::open(const std::string& filename) {
     return true;
 }
 
+bool PcapReader::openMapped(const std::string& filename) {
+    if (!mapped_.open(filename)) {
+        return false;
+    }
+    if (mapped_.size() < PCAP_GLOBAL_HEADER_LEN) {
+        mapped_.close();
+        return false;
+    }
+
+    const uint8_t* hdr = mapped_.data();
+    uint32_t magic = readU32(hdr, false);
+    if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+        swapped_ = false;
+    } else if (magic == __builtin_bswap32(PCAP_MAGIC_USEC) ||
+               magic == __builtin_bswap32(PCAP_MAGIC_NSEC)) {
+        swapped_ = true;
+        magic = __builtin_bswap32(magic);
+    } else {
+        // Not a classic pcap file (e.g. pcapng); let libpcap deal with it
+        mapped_.close();
+        return false;
+    }
+
+    nanosecond_ = (magic == PCAP_MAGIC_NSEC);
+    snaplen_ = static_cast<int>(readU32(hdr + 16, swapped_));
+    datalink_type_ = static_cast<int>(readU32(hdr + 20, swapped_) & 0xFFFF);
+    map_offset_ = PCAP_GLOBAL_HEADER_LEN;
+    return true;
+}
+
 void PcapReader::close() {
     if (pcap_handle_) {
         pcap_close(pcap_handle_);
         pcap_handle_ = nullptr;
     }
+    mapped_.close();
+    map_offset_ = 0;
     is_open_ = false;
 
     if (!filename_.empty()) {
@@ -61,6 +126,17 @@ bool PcapReader::isOpen() const {
     return is_open_;
 }
 
+uint64_t PcapReader::getFileOffset() const {
+    if (mapped_.isOpen()) {
+        return map_offset_;
+    }
+    if (!is_open_) {
+        return 0;
+    }
+    return PCAP_GLOBAL_HEADER_LEN + stats_.packets_processed * PCAP_RECORD_HEADER_LEN +
+           stats_.bytes_processed;
+}
+
 int PcapReader::getDatalinkType() const {
     return datalink_type_;
 }
@@ -70,6 +146,9 @@ int PcapReader::getSnaplen() const {
 }
 
 bool PcapReader::readNextPacket(struct pcap_pkthdr& header, const uint8_t*& data) {
+    if (is_open_ && mapped_.isOpen()) {
+        return readNextMapped(header, data);
+    }
     if (!is_open_ || !pcap_handle_) {
         LOG_ERROR("Attempting to read from closed PCAP file");
         return false;
@@ -81,17 +160,7 @@ bool PcapReader::readNextPacket(struct pcap_pkthdr& header, const uint8_t*& data
     if (result == 1) {
         // Packet read successfully
         header = *header_ptr;  // Copy the header data
-        stats_.packets_processed++;
-        stats_.bytes_processed += header.caplen;
-
-        // Update time range
-        auto ts = std::chrono::system_clock::from_time_t(header.ts.tv_sec) +
-                  std::chrono::microseconds(header.ts.tv_usec);
-        if (stats_.packets_processed == 1) {
-            stats_.start_time = ts;
-        }
-        stats_.end_time = ts;
-
+        recordPacket(header);
         return true;
     } else if (result == -2) {
         // End of file
@@ -104,8 +173,55 @@ bool PcapReader::readNextPacket(struct pcap_pkthdr& header, const uint8_t*& data
     }
 }
 
+bool PcapReader::readNextMapped(struct pcap_pkthdr& header, const uint8_t*& data) {
+    const uint8_t* base = mapped_.data();
+    size_t size = mapped_.size();
+
+    if (size - map_offset_ < PCAP_RECORD_HEADER_LEN) {
+        if (map_offset_ != size) {
+            LOG_WARN("Truncated record header at end of PCAP file: " << filename_);
+        }
+        LOG_DEBUG("Reached end of PCAP file: " << filename_);
+        return false;
+    }
+
+    const uint8_t* rec = base + map_offset_;
+    uint32_t ts_sec = readU32(rec, swapped_);
+    uint32_t ts_frac = readU32(rec + 4, swapped_);
+    uint32_t caplen = readU32(rec + 8, swapped_);
+    uint32_t wirelen = readU32(rec + 12, swapped_);
+
+    if (caplen > size - map_offset_ - PCAP_RECORD_HEADER_LEN) {
+        LOG_ERROR("Truncated packet record in PCAP file: " << filename_);
+        return false;
+    }
+
+    header.ts.tv_sec = ts_sec;
+    header.ts.tv_usec = nanosecond_ ? ts_frac / 1000 : ts_frac;
+    header.caplen = caplen;
+    header.len = wirelen;
+    data = rec + PCAP_RECORD_HEADER_LEN;
+    map_offset_ += PCAP_RECORD_HEADER_LEN + caplen;
+
+    recordPacket(header);
+    return true;
+}
+
+void PcapReader::recordPacket(const struct pcap_pkthdr& header) {
+    stats_.packets_processed++;
+    stats_.bytes_processed += header.caplen;
+
+    // Update time range
+    auto ts = std::chrono::system_clock::from_time_t(header.ts.tv_sec) +
+              std::chrono::microseconds(header.ts.tv_usec);
+    if (stats_.packets_processed == 1) {
+        stats_.start_time = ts;
+    }
+    stats_.end_time = ts;
+}
+
 size_t PcapReader::processPackets(PacketCallback callback, void* user_context) {
-    if (!is_open_ || !pcap_handle_) {
+    if (!is_open_) {
         LOG_ERROR("Cannot process packets: PCAP file not open");
         return 0;
     }
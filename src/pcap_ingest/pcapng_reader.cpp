@@ -3,6 +3,7 @@
 #include <arpa/inet.h>
 
 #include <cstring>
+#include <filesystem>
 
 #include "common/utils.h"
 
@@ -73,10 +74,19 @@ bool PcapngReader::open(const std::string& filename) {
         close();
     }
 
-    file_ = fopen(filename.c_str(), "rb");
-    if (!file_) {
-        LOG_ERROR("Failed to open PCAPNG file: " << filename);
-        return false;
+    std::error_code ec;
+    file_size_ = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        file_size_ = 0;
+    }
+
+    map_offset_ = 0;
+    if (!use_mmap_ || !mapped_.open(filename)) {
+        file_ = fopen(filename.c_str(), "rb");
+        if (!file_) {
+            LOG_ERROR("Failed to open PCAPNG file: " << filename);
+            return false;
+        }
     }
 
     filename_ = filename;
@@ -102,7 +112,7 @@ bool PcapngReader::open(const std::string& filename) {
         return false;
     }
 
-    LOG_INFO("Opened PCAPNG file: " << filename);
+    LOG_INFO("Opened PCAPNG file: " << filename << (mapped_.isOpen() ? " (mmap)" : ""));
     return true;
 }
 
@@ -111,6 +121,8 @@ void PcapngReader::close() {
         fclose(file_);
         file_ = nullptr;
     }
+    mapped_.close();
+    map_offset_ = 0;
 
     is_open_ = false;
 
@@ -125,23 +137,34 @@ void PcapngReader::close() {
     name_resolution_records_.clear();
     interface_statistics_.clear();
     current_block_data_.clear();
+    block_data_ = nullptr;
+    block_size_ = 0;
 }
 
 bool PcapngReader::readNextBlock() {
-    if (!is_open_ || !file_) {
+    if (!is_open_ || (!file_ && !mapped_.isOpen())) {
         LOG_ERROR("Attempting to read from closed PCAPNG file");
         return false;
     }
 
     uint32_t block_type, block_length;
-    if (!readBlockHeader(block_type, block_length)) {
-        return false;
-    }
+    if (mapped_.isOpen()) {
+        if (!readMappedBlock(block_type, block_length)) {
+            return false;
+        }
+        current_block_type_ = static_cast<PcapngBlockType>(block_type);
+    } else {
+        if (!readBlockHeader(block_type, block_length)) {
+            return false;
+        }
 
-    current_block_type_ = static_cast<PcapngBlockType>(block_type);
+        current_block_type_ = static_cast<PcapngBlockType>(block_type);
 
-    if (!readBlockData(block_length)) {
-        return false;
+        if (!readBlockData(block_length)) {
+            return false;
+        }
+        block_data_ = current_block_data_.data();
+        block_size_ = current_block_data_.size();
     }
 
     stats_.total_blocks++;
@@ -237,13 +260,65 @@ bool PcapngReader::readBlockData(uint32_t block_length) {
     return true;
 }
 
+bool PcapngReader::readMappedBlock(uint32_t& block_type, uint32_t& block_length) {
+    size_t remaining = mapped_.size() - map_offset_;
+    if (remaining == 0) {
+        return false;  // End of file
+    }
+    if (remaining < 12) {
+        LOG_ERROR("Truncated block header at offset " << map_offset_);
+        return false;
+    }
+
+    const uint8_t* block = mapped_.data() + map_offset_;
+    std::memcpy(&block_type, block, sizeof(block_type));
+    std::memcpy(&block_length, block + 4, sizeof(block_length));
+
+    if (block_type == PCAPNG_MAGIC) {
+        // Section Header Block: byte order magic follows the length
+        uint32_t byte_order_magic;
+        std::memcpy(&byte_order_magic, block + 8, sizeof(byte_order_magic));
+        if (byte_order_magic == BYTE_ORDER_MAGIC) {
+            is_little_endian_ = true;
+        } else if (byte_order_magic == BYTE_ORDER_MAGIC_SWAPPED) {
+            is_little_endian_ = false;
+            block_length = ntohl(block_length);
+        } else {
+            LOG_ERROR("Invalid byte order magic: 0x" << std::hex << byte_order_magic);
+            return false;
+        }
+    } else {
+        block_type = toHost32(block_type);
+        block_length = toHost32(block_length);
+    }
+
+    if (block_length < 12 || block_length > remaining) {
+        LOG_ERROR("Invalid block length: " << block_length);
+        return false;
+    }
+
+    uint32_t trailing_length;
+    std::memcpy(&trailing_length, block + block_length - 4, sizeof(trailing_length));
+    trailing_length = toHost32(trailing_length);
+    if (trailing_length != block_length) {
+        LOG_ERROR("Block length mismatch: " << block_length << " vs " << trailing_length);
+        return false;
+    }
+
+    // Body is everything between the length field and the trailing length
+    block_data_ = block + 8;
+    block_size_ = block_length - 12;
+    map_offset_ += block_length;
+    return true;
+}
+
 bool PcapngReader::parseSectionHeader() {
-    if (current_block_data_.size() < 12) {
+    if (block_size_ < 12) {
         LOG_ERROR("Section Header Block too small");
         return false;
     }
 
-    const uint8_t* data = current_block_data_.data();
+    const uint8_t* data = block_data_;
 
     // Byte order magic already read
     section_header_.byte_order_magic = toHost32(*reinterpret_cast<const uint32_t*>(data));
@@ -261,8 +336,8 @@ bool PcapngReader::parseSectionHeader() {
     data += 8;
 
     // Parse options
-    size_t options_offset = data - current_block_data_.data();
-    size_t options_length = current_block_data_.size() - options_offset;
+    size_t options_offset = data - block_data_;
+    size_t options_length = block_size_ - options_offset;
 
     parseOptions(data, options_length,
                  [this](uint16_t code, const uint8_t* value, uint16_t length) {
@@ -287,7 +362,7 @@ bool PcapngReader::parseSectionHeader() {
 }
 
 bool PcapngReader::parseInterfaceDescription() {
-    if (current_block_data_.size() < 8) {
+    if (block_size_ < 8) {
         LOG_ERROR("Interface Description Block too small");
         return false;
     }
@@ -295,7 +370,7 @@ bool PcapngReader::parseInterfaceDescription() {
     PcapngInterface interface;
     interface.interface_id = static_cast<uint32_t>(interfaces_.size());
 
-    const uint8_t* data = current_block_data_.data();
+    const uint8_t* data = block_data_;
 
     // LinkType
     interface.link_type = toHost16(*reinterpret_cast<const uint16_t*>(data));
@@ -309,8 +384,8 @@ bool PcapngReader::parseInterfaceDescription() {
     data += 4;
 
     // Parse options
-    size_t options_offset = data - current_block_data_.data();
-    size_t options_length = current_block_data_.size() - options_offset;
+    size_t options_offset = data - block_data_;
+    size_t options_length = block_size_ - options_offset;
 
     parseOptions(
         data, options_length,
@@ -370,17 +445,31 @@ bool PcapngReader::parseEnhancedPacket() {
 bool PcapngReader::readEnhancedPacket(uint32_t& interface_id, uint64_t& timestamp,
                                       std::vector<uint8_t>& packet_data, uint32_t& original_length,
                                       PcapngPacketMetadata& metadata) {
+    const uint8_t* packet = nullptr;
+    uint32_t captured_length = 0;
+    if (!parseEnhancedPacketView(interface_id, timestamp, packet, captured_length,
+                                 original_length, metadata)) {
+        return false;
+    }
+    packet_data.assign(packet, packet + captured_length);
+    return true;
+}
+
+bool PcapngReader::parseEnhancedPacketView(uint32_t& interface_id, uint64_t& timestamp,
+                                           const uint8_t*& packet_data, uint32_t& captured_length,
+                                           uint32_t& original_length,
+                                           PcapngPacketMetadata& metadata) {
     if (current_block_type_ != PcapngBlockType::ENHANCED_PACKET) {
         LOG_ERROR("Current block is not an Enhanced Packet Block");
         return false;
     }
 
-    if (current_block_data_.size() < 20) {
+    if (block_size_ < 20) {
         LOG_ERROR("Enhanced Packet Block too small");
         return false;
     }
 
-    const uint8_t* data = current_block_data_.data();
+    const uint8_t* data = block_data_;
 
     // Interface ID
     interface_id = toHost32(*reinterpret_cast<const uint32_t*>(data));
@@ -402,7 +491,7 @@ bool PcapngReader::readEnhancedPacket(uint32_t& interface_id, uint64_t& timestam
     }
 
     // Captured Packet Length
-    uint32_t captured_length = toHost32(*reinterpret_cast<const uint32_t*>(data));
+    captured_length = toHost32(*reinterpret_cast<const uint32_t*>(data));
     data += 4;
 
     // Original Packet Length
@@ -411,17 +500,17 @@ bool PcapngReader::readEnhancedPacket(uint32_t& interface_id, uint64_t& timestam
 
     // Packet data (padded to 32-bit boundary)
     uint32_t padded_length = (captured_length + 3) & ~3;
-    if (current_block_data_.size() < 20 + padded_length) {
+    if (block_size_ < 20 + padded_length) {
         LOG_ERROR("Enhanced Packet Block data truncated");
         return false;
     }
 
-    packet_data.assign(data, data + captured_length);
+    packet_data = data;
     data += padded_length;
 
     // Parse options
-    size_t options_offset = data - current_block_data_.data();
-    size_t options_length = current_block_data_.size() - options_offset;
+    size_t options_offset = data - block_data_;
+    size_t options_length = block_size_ - options_offset;
 
     parseOptions(
         data, options_length,
@@ -463,10 +552,10 @@ bool PcapngReader::readEnhancedPacket(uint32_t& interface_id, uint64_t& timestam
 
 bool PcapngReader::parseNameResolution() {
     // Name Resolution Block contains records
-    const uint8_t* data = current_block_data_.data();
+    const uint8_t* data = block_data_;
     size_t offset = 0;
 
-    while (offset + 4 <= current_block_data_.size()) {
+    while (offset + 4 <= block_size_) {
         uint16_t record_type = toHost16(*reinterpret_cast<const uint16_t*>(data + offset));
         offset += 2;
 
@@ -477,7 +566,7 @@ bool PcapngReader::parseNameResolution() {
             break;  // End of records
         }
 
-        if (offset + record_length > current_block_data_.size()) {
+        if (offset + record_length > block_size_) {
             LOG_ERROR("Name Resolution record extends beyond block");
             break;
         }
@@ -539,14 +628,14 @@ bool PcapngReader::parseNameResolution() {
 }
 
 bool PcapngReader::parseInterfaceStatistics() {
-    if (current_block_data_.size() < 12) {
+    if (block_size_ < 12) {
         LOG_ERROR("Interface Statistics Block too small");
         return false;
     }
 
     InterfaceStatistics stats;
 
-    const uint8_t* data = current_block_data_.data();
+    const uint8_t* data = block_data_;
 
     // Interface ID
     stats.interface_id = toHost32(*reinterpret_cast<const uint32_t*>(data));
@@ -561,8 +650,8 @@ bool PcapngReader::parseInterfaceStatistics() {
     stats.timestamp = (static_cast<uint64_t>(ts_high) << 32) | ts_low;
 
     // Parse options
-    size_t options_offset = data - current_block_data_.data();
-    size_t options_length = current_block_data_.size() - options_offset;
+    size_t options_offset = data - block_data_;
+    size_t options_length = block_size_ - options_offset;
 
     parseOptions(
         data, options_length, [&stats, this](uint16_t code, const uint8_t* value, uint16_t length) {
@@ -639,7 +728,7 @@ bool PcapngReader::parseOptions(const uint8_t* data, size_t length,
 }
 
 size_t PcapngReader::processPackets(PacketCallback callback) {
-    if (!is_open_ || !file_) {
+    if (!is_open_ || (!file_ && !mapped_.isOpen())) {
         LOG_ERROR("Cannot process packets: PCAPNG file not open");
         return 0;
     }
@@ -657,14 +746,16 @@ size_t PcapngReader::processPackets(PacketCallback callback) {
         } else if (current_block_type_ == PcapngBlockType::ENHANCED_PACKET) {
             uint32_t interface_id;
             uint64_t timestamp;
-            std::vector<uint8_t> packet_data;
+            const uint8_t* packet_data;
+            uint32_t captured_length;
             uint32_t original_length;
             PcapngPacketMetadata metadata;
 
-            if (readEnhancedPacket(interface_id, timestamp, packet_data, original_length,
-                                   metadata)) {
-                callback(interface_id, timestamp, packet_data.data(),
-                         static_cast<uint32_t>(packet_data.size()), original_length, metadata);
+            // Packet bytes are passed in place (mapping or block buffer), not copied
+            if (parseEnhancedPacketView(interface_id, timestamp, packet_data, captured_length,
+                                        original_length, metadata)) {
+                callback(interface_id, timestamp, packet_data, captured_length, original_length,
+                         metadata);
                 packet_count++;
                 stats_.enhanced_packets++;  // Track enhanced packet count for close() logging
 
@@ -0,0 +1,455 @@
+#include "pcap_ingest/sharded_packet_processor.h"
+
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <queue>
+
+#include "common/logger.h"
+
+namespace callflow {
+
+namespace {
+
+constexpr uint16_t GTPU_PORT = 2152;
+constexpr uint8_t GTPU_GPDU = 0xFF;
+
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t hashEndpoint(const uint8_t* addr, size_t addr_len, uint16_t port) {
+    uint64_t h = 1469598103934665603ULL;  // FNV-1a offset basis
+    for (size_t i = 0; i < addr_len; ++i) {
+        h ^= addr[i];
+        h *= 1099511628211ULL;
+    }
+    return mix64(h ^ port);
+}
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+/**
+ * Locate the inner IP packet of a GTPv1-U G-PDU
+ * @return Offset of the inner packet, or 0 if this is not a G-PDU
+ */
+size_t gtpuInnerOffset(const uint8_t* gtp, size_t len, uint32_t& teid) {
+    if (len < 8 || ((gtp[0] >> 5) & 0x07) != 1 || gtp[1] != GTPU_GPDU) {
+        return 0;
+    }
+    teid = (static_cast<uint32_t>(gtp[4]) << 24) | (static_cast<uint32_t>(gtp[5]) << 16) |
+           (static_cast<uint32_t>(gtp[6]) << 8) | gtp[7];
+
+    size_t offset = 8;
+    if (gtp[0] & 0x07) {
+        // Sequence number, N-PDU number and next extension header type
+        if (len < 12)
+            return 0;
+        uint8_t next_ext = gtp[11];
+        offset = 12;
+        while ((gtp[0] & 0x04) && next_ext != 0) {
+            if (offset >= len)
+                return 0;
+            size_t ext_len = static_cast<size_t>(gtp[offset]) * 4;
+            if (ext_len == 0 || offset + ext_len > len)
+                return 0;
+            next_ext = gtp[offset + ext_len - 1];
+            offset += ext_len;
+        }
+    }
+    return offset < len ? offset : 0;
+}
+
+}  // namespace
+
+ShardedPacketProcessor::ShardedPacketProcessor(EnhancedSessionCorrelator& correlator,
+                                               size_t num_shards, size_t queue_depth)
+    : correlator_(correlator) {
+    num_shards = std::max<size_t>(1, num_shards);
+
+    // Port learning is shared so a SIP port discovered on one shard is honoured on all
+    auto sip_ports = std::make_shared<SipPortTracker>();
+    auto rtp_ports = std::make_shared<DynamicPortTracker>();
+
+    for (size_t i = 0; i < num_shards; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->id = i;
+        shard->processor = std::make_unique<PacketProcessor>(correlator_, sip_ports, rtp_ports);
+        shards_.push_back(std::move(shard));
+    }
+
+    if (num_shards == 1) {
+        LOG_INFO("ShardedPacketProcessor: single shard, processing inline");
+        return;
+    }
+
+    for (auto& shard : shards_) {
+        shard->queue = std::make_unique<SpscRing<PacketDescriptor>>(queue_depth);
+        shard->pending.reserve(DISPATCH_BATCH);
+        shard->processor->setDeferredOutput(&shard->output);
+        shard->worker = std::thread(&ShardedPacketProcessor::workerLoop, this, std::ref(*shard));
+    }
+    LOG_INFO("ShardedPacketProcessor: started " << num_shards << " ingest shards");
+}
+
+ShardedPacketProcessor::~ShardedPacketProcessor() {
+    // Never leave worker threads running; merging is the caller's job via finish()
+    abort();
+}
+
+void ShardedPacketProcessor::abort() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    aborted_.store(true, std::memory_order_release);
+
+    for (auto& shard : shards_) {
+        if (shard->queue) {
+            shard->queue->close();
+        }
+    }
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+        shard->pending.clear();
+        shard->staged.clear();
+    }
+}
+
+void ShardedPacketProcessor::setJobTag(uint32_t job_tag) {
+    for (auto& shard : shards_) {
+        shard->processor->setJobTag(job_tag);
+    }
+}
+
+void ShardedPacketProcessor::processPacket(const uint8_t* data, size_t len, Timestamp ts,
+                                           uint32_t frame_number, int dlt) {
+    if (shards_.size() == 1) {
+        auto& shard = *shards_.front();
+        auto start = std::chrono::steady_clock::now();
+        shard.processor->processPacket(data, len, ts, frame_number, dlt);
+        shard.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        shard.packets++;
+        shard.bytes += len;
+        return;
+    }
+
+    last_frame_ = frame_number;
+
+    uint16_t eth_type = 0;
+    int offset = link_parser_.parse(data, len, dlt, eth_type);
+    if (offset < 0 || static_cast<size_t>(offset) >= len) {
+        return;
+    }
+    if (eth_type != 0x0800 && eth_type != 0x86DD) {
+        return;
+    }
+
+    auto reassembled = ip_reassembler_.processPacket(data + offset, len - offset, ts);
+    if (!reassembled.has_value() || reassembled->empty()) {
+        return;
+    }
+
+    uint64_t hash = flowHash(reassembled->data(), reassembled->size());
+    auto& shard = *shards_[hash % shards_.size()];
+    if (shard.failed.load(std::memory_order_relaxed)) {
+        // The error is rethrown by finish()
+        return;
+    }
+
+    PacketDescriptor packet;
+    ByteView datagram = reassembled.value();
+    bool in_place = datagram.data() >= data && datagram.data() + datagram.size() <= data + len;
+    if (stable_input_ && in_place) {
+        packet.view = datagram;
+    } else {
+        // The reassembler's buffer and unstable input are reused by the next call
+        packet.owned.assign(datagram.begin(), datagram.end());
+    }
+    packet.timestamp = ts;
+    packet.frame_number = frame_number;
+    packet.wire_length = static_cast<uint32_t>(len);
+    shard.pending.push_back(std::move(packet));
+
+    if (shard.pending.size() >= DISPATCH_BATCH) {
+        flushPending(shard);
+    }
+    if (++since_merge_ >= MERGE_INTERVAL) {
+        since_merge_ = 0;
+        mergeAvailable();
+    }
+}
+
+void ShardedPacketProcessor::flushPending(Shard& shard) {
+    if (shard.pending.empty()) {
+        return;
+    }
+    // Blocks while the shard is saturated (back-pressure towards the reader)
+    shard.dispatched += shard.queue->pushBatch(shard.pending.data(), shard.pending.size());
+    shard.pending.clear();
+}
+
+void ShardedPacketProcessor::workerLoop(Shard& shard) {
+    std::vector<PacketDescriptor> batch(DISPATCH_BATCH);
+    while (size_t count = shard.queue->popBatch(batch.data(), batch.size())) {
+        if (aborted_.load(std::memory_order_acquire)) {
+            // Queued descriptors may point into input that is about to be released
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint64_t bytes = 0;
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                auto& packet = batch[i];
+                shard.processor->processIpDatagram(packet.datagram(), packet.timestamp,
+                                                   packet.frame_number);
+                bytes += packet.wire_length;
+            }
+        } catch (...) {
+            // An exception must not escape the thread (std::terminate); hand it
+            // to finish() and close the ring so the reader never blocks on it
+            shard.error = std::current_exception();
+            shard.failed.store(true, std::memory_order_release);
+            shard.queue->close();
+            LOG_ERROR("ShardedPacketProcessor: shard " << shard.id
+                                                       << " failed, no longer dispatching to it");
+            return;
+        }
+        if (!shard.output.empty()) {
+            std::lock_guard<std::mutex> lock(shard.ready_mutex);
+            shard.ready.insert(shard.ready.end(), std::make_move_iterator(shard.output.begin()),
+                               std::make_move_iterator(shard.output.end()));
+            shard.output.clear();
+        }
+        // Published after the output: a reader that sees this frame or this
+        // packet count also sees the output for it
+        shard.processed_frame.store(batch[count - 1].frame_number, std::memory_order_release);
+        shard.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        shard.bytes += bytes;
+        shard.packets.fetch_add(count, std::memory_order_release);
+    }
+}
+
+void ShardedPacketProcessor::finish(const MergeProgress& progress) {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    if (shards_.size() == 1) {
+        return;
+    }
+
+    for (auto& shard : shards_) {
+        flushPending(*shard);
+        shard->queue->close();
+    }
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+    for (auto& shard : shards_) {
+        if (shard->error) {
+            std::rethrow_exception(shard->error);
+        }
+    }
+
+    size_t total = 0;
+    for (auto& shard : shards_) {
+        collectReady(*shard);
+        total += shard->staged.size();
+    }
+    LOG_INFO("ShardedPacketProcessor: merging " << total << " remaining correlator inputs from "
+                                                << shards_.size() << " shards");
+    mergeIntoCorrelator(std::numeric_limits<uint32_t>::max(), progress, total);
+}
+
+void ShardedPacketProcessor::mergeAvailable() {
+    // Anything a shard emits from now on comes from a datagram it has not
+    // processed yet, so its frame is above the shard's last processed frame,
+    // or above the reader's current frame once the shard has caught up
+    uint32_t watermark = last_frame_;
+    for (auto& shard : shards_) {
+        flushPending(*shard);
+        if (shard->packets.load(std::memory_order_acquire) != shard->dispatched) {
+            watermark =
+                std::min(watermark, shard->processed_frame.load(std::memory_order_acquire));
+        }
+        collectReady(*shard);
+    }
+    mergeIntoCorrelator(watermark);
+}
+
+void ShardedPacketProcessor::collectReady(Shard& shard) {
+    std::vector<DeferredCorrelatorInput> ready;
+    {
+        std::lock_guard<std::mutex> lock(shard.ready_mutex);
+        ready.swap(shard.ready);
+    }
+    shard.staged.insert(shard.staged.end(), std::make_move_iterator(ready.begin()),
+                        std::make_move_iterator(ready.end()));
+}
+
+void ShardedPacketProcessor::mergeIntoCorrelator(uint32_t watermark,
+                                                 const MergeProgress& progress, size_t total) {
+    // Each shard's output is already ordered by (frame, sequence) because the
+    // reader dispatches in capture order, so a k-way merge restores global order.
+    struct Cursor {
+        uint32_t frame_number;
+        uint32_t sequence;
+        size_t shard_index;
+
+        bool operator>(const Cursor& other) const {
+            if (frame_number != other.frame_number)
+                return frame_number > other.frame_number;
+            return sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+    auto pushFront = [&](size_t index) {
+        const auto& staged = shards_[index]->staged;
+        if (!staged.empty() && staged.front().frame_number <= watermark) {
+            heap.push({staged.front().frame_number, staged.front().sequence, index});
+        }
+    };
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        pushFront(i);
+    }
+
+    size_t merged = 0;
+    while (!heap.empty()) {
+        Cursor cursor = heap.top();
+        heap.pop();
+
+        auto& shard = *shards_[cursor.shard_index];
+        auto& input = shard.staged.front();
+        if (input.sip_message.has_value()) {
+            correlator_.processSipMessage(input.sip_message.value(), input.metadata);
+        } else {
+            correlator_.processPacket(input.metadata, input.protocol, input.parsed_data);
+        }
+        // Release parsed payloads as soon as they have been replayed
+        shard.staged.pop_front();
+        shard.correlator_inputs++;
+
+        if (progress && (++merged % MERGE_INTERVAL) == 0) {
+            progress(merged, total);
+        }
+        pushFront(cursor.shard_index);
+    }
+    if (progress) {
+        progress(merged, total);
+    }
+}
+
+std::vector<ShardedPacketProcessor::ShardStats> ShardedPacketProcessor::getShardStats() const {
+    std::vector<ShardStats> stats;
+    stats.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        ShardStats s;
+        s.shard_id = shard->id;
+        s.packets = shard->packets.load();
+        s.bytes = shard->bytes.load();
+        s.correlator_inputs = shard->correlator_inputs;
+        s.busy_seconds = static_cast<double>(shard->busy_ns.load()) / 1e9;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+DefragStats ShardedPacketProcessor::getDefragStats() const {
+    DefragStats stats = ip_reassembler_.getStats();
+    for (const auto& shard : shards_) {
+        stats += shard->processor->getDefragStats();
+    }
+    return stats;
+}
+
+uint64_t ShardedPacketProcessor::flowHash(const uint8_t* ip_data, size_t len, int depth) {
+    if (!ip_data || len < 1 || depth > 2) {
+        return 0;
+    }
+
+    uint8_t version = (ip_data[0] >> 4) & 0x0F;
+    const uint8_t* src = nullptr;
+    const uint8_t* dst = nullptr;
+    size_t addr_len = 0;
+    uint8_t protocol = 0;
+    size_t hlen = 0;
+
+    if (version == 4) {
+        if (len < 20)
+            return 0;
+        hlen = static_cast<size_t>(ip_data[0] & 0x0F) * 4;
+        if (hlen < 20 || len < hlen)
+            return 0;
+        protocol = ip_data[9];
+        src = ip_data + 12;
+        dst = ip_data + 16;
+        addr_len = 4;
+    } else if (version == 6) {
+        if (len < 40)
+            return 0;
+        protocol = ip_data[6];
+        src = ip_data + 8;
+        dst = ip_data + 24;
+        addr_len = 16;
+        hlen = 40;
+        // Skip hop-by-hop, routing and destination option headers
+        while ((protocol == 0 || protocol == 43 || protocol == 60) && hlen + 8 <= len) {
+            protocol = ip_data[hlen];
+            hlen += (static_cast<size_t>(ip_data[hlen + 1]) + 1) * 8;
+        }
+        if (hlen > len)
+            return 0;
+    } else {
+        return 0;
+    }
+
+    uint16_t src_port = 0;
+    uint16_t dst_port = 0;
+    const uint8_t* trans = ip_data + hlen;
+    size_t trans_len = len - hlen;
+    if ((protocol == IPPROTO_TCP || protocol == IPPROTO_UDP || protocol == 132) &&
+        trans_len >= 4) {
+        src_port = readU16(trans);
+        dst_port = readU16(trans + 2);
+    }
+
+    // GTP-U: shard by the tunnelled flow so both directions meet on one shard
+    if (protocol == IPPROTO_UDP && trans_len > 8 &&
+        (src_port == GTPU_PORT || dst_port == GTPU_PORT)) {
+        uint32_t teid = 0;
+        size_t inner = gtpuInnerOffset(trans + 8, trans_len - 8, teid);
+        if (inner > 0) {
+            uint64_t inner_hash = flowHash(trans + 8 + inner, trans_len - 8 - inner, depth + 1);
+            return inner_hash != 0 ? inner_hash : mix64(teid);
+        }
+    }
+
+    uint64_t a = hashEndpoint(src, addr_len, src_port);
+    uint64_t b = hashEndpoint(dst, addr_len, dst_port);
+    uint64_t lo = std::min(a, b);
+    uint64_t hi = std::max(a, b);
+    return mix64(lo ^ mix64(hi + protocol));
+}
+
+}  // namespace callflow
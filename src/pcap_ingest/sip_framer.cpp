@@ -1,8 +1,5 @@
-#include <algorithm>
-#include <cstdlib>
-#include <cstring>
-
 #include "pcap_ingest/protocol_framer.h"
+#include "protocol_parsers/sip_scanner.h"
 
 namespace callflow {
 
@@ -20,23 +17,22 @@ size_t SipFramer::processData(const uint8_t* data, size_t len) {
 
     size_t total_consumed = 0;
 
-    // Process all complete messages in buffer
+    // Deliver all complete messages in place, then drop them with one erase
     while (true) {
-        size_t msg_size = findCompleteMessage();
+        size_t msg_size = findCompleteMessage(total_consumed);
         if (msg_size == 0) {
             break;  // No complete message
         }
 
-        // Deliver complete message
         if (message_callback_) {
-            message_callback_(buffer_.data(), msg_size);
+            message_callback_(buffer_.data() + total_consumed, msg_size);
         }
-
-        // Remove processed message from buffer
-        buffer_.erase(buffer_.begin(), buffer_.begin() + msg_size);
         total_consumed += msg_size;
     }
 
+    if (total_consumed > 0) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + total_consumed);
+    }
     return total_consumed;
 }
 
@@ -58,55 +54,26 @@ void SipFramer::reset() {
     buffer_.clear();
 }
 
-int SipFramer::findContentLength(const std::string& headers) {
-    // Find Content-Length header (case-insensitive)
-    const char* patterns[] = {"Content-Length:", "content-length:", "CONTENT-LENGTH:", "l:"};
-
-    for (const char* pattern : patterns) {
-        size_t pos = headers.find(pattern);
-        if (pos != std::string::npos) {
-            // Find first digit after the colon
-            size_t val_start = headers.find_first_of("0123456789", pos + strlen(pattern));
-            if (val_start != std::string::npos) {
-                return std::atoi(headers.c_str() + val_start);
-            }
-        }
-    }
+size_t SipFramer::findCompleteMessage(size_t offset) {
+    const uint8_t* start = buffer_.data() + offset;
+    size_t available = buffer_.size() - offset;
 
-    return 0;
-}
-
-size_t SipFramer::findCompleteMessage() {
-    if (buffer_.size() < 4) {
-        return 0;  // Need at least \r\n\r\n
-    }
-
-    // Find double CRLF (end of headers)
-    const char* crlf2 = "\r\n\r\n";
-    auto it = std::search(buffer_.begin(), buffer_.end(), crlf2, crlf2 + 4);
-
-    if (it == buffer_.end()) {
+    size_t headers_len = sip::findHeaderEnd(start, available);
+    if (headers_len == 0) {
         // Headers not complete yet
         // Check if buffer is getting too large without finding headers
-        if (buffer_.size() > 65536) {
-            // Likely not SIP, or malformed - reset
-            buffer_.clear();
+        if (available > 65536) {
+            // Likely not SIP, or malformed - drop the unframed tail
+            buffer_.resize(offset);
         }
         return 0;
     }
 
-    // Calculate header length (including \r\n\r\n)
-    size_t headers_len = std::distance(buffer_.begin(), it) + 4;
-
-    // Extract headers as string to parse Content-Length
-    std::string headers(buffer_.begin(), buffer_.begin() + headers_len);
-    int content_len = findContentLength(headers);
-
     // Total message size
-    size_t total_len = headers_len + content_len;
+    size_t total_len = headers_len + sip::findContentLength(start, headers_len);
 
     // Check if we have the complete message
-    if (buffer_.size() >= total_len) {
+    if (available >= total_len) {
         return total_len;
     }
 
@@ -1,125 +1,286 @@
 #include "pcap_ingest/tcp_reassembler.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "common/logger.h"
 
 namespace callflow {
 
-TcpReassembler::TcpReassembler() {}
+namespace {
 
-void TcpReassembler::cleanup() {
-    auto now = std::chrono::steady_clock::now();
-    for (auto it = streams_.begin(); it != streams_.end();) {
-        if (std::chrono::duration_cast<std::chrono::seconds>(now - it->second.last_update).count() >
-            timeout_sec_) {
-            it = streams_.erase(it);
-        } else {
-            ++it;
-        }
+constexpr size_t kMinRingBytes = 4096;
+// A single in-order segment is never larger than an IP datagram
+constexpr size_t kMinWindowBytes = 64 * 1024;
+
+size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
     }
+    return result;
 }
 
-std::vector<uint8_t> TcpReassembler::processSegment(const FiveTuple& flow_id, uint32_t seq,
-                                                    const std::vector<uint8_t>& payload,
-                                                    bool is_syn, bool is_fin) {
-    auto& state = streams_[flow_id];
-    state.last_update = std::chrono::steady_clock::now();
-
-    // Handle SYN
-    if (is_syn) {
-        state.syn_seen = true;
-        state.next_seq = seq + 1;
-
-        // If there is payload in SYN, process it? (Allowed but rare, TFO)
-        if (!payload.empty()) {
-            // Treat payload as starting at seq+1
-            // But usually SYN consumes 1 seq, payload starts at seq+1? No.
-            // SYN consumes 1. Data starts at (seq of SYN) + 1.
-            // So if payload is attached to SYN packet, it starts at seq+1.
-            // We adjust `seq` to `seq + 1` for payload processing?
-            // Logic below:
-            // If payload non-empty, handle it.
+}  // namespace
+
+TcpReassembler::TcpReassembler(const Limits& limits) : limits_(limits) {
+    limits_.max_streams = std::max<size_t>(limits_.max_streams, 1);
+    limits_.max_window_bytes = roundUpPow2(std::max(limits_.max_window_bytes, kMinWindowBytes));
+}
+
+ByteView TcpReassembler::processSegment(const FlowKey& flow_id, uint32_t seq, ByteView payload,
+                                        bool is_syn, bool is_fin, Timestamp now) {
+    expire(now);
+
+    uint32_t hash = static_cast<uint32_t>(flow_id.hash());
+    uint32_t id = streams_.find(flow_id, hash);
+    if (id == kNil) {
+        if (payload.empty() && !is_syn) {
+            return {};  // ACK / FIN of a flow we hold no state for
         }
-    } else if (!state.syn_seen) {
-        // Mid-stream pickup?
-        // We can either drop until we see SYN, or assume we start here if it looks reasonable.
-        // For DPI, we often want to parse what we can.
-        // Strategy: If first packet we see for this flow, assume it's next.
-        if (state.next_seq == 0) {
-            state.next_seq = seq;
-            state.syn_seen = true;  // Pretend we are synced
+        id = createStream(flow_id, hash, now);
+        // Without a SYN, assume mid-stream pickup and take this segment as next
+        streams_[id].next_seq = is_syn ? seq + 1 : seq;
+    } else {
+        touchStream(id, now);
+        if (is_syn) {
+            // New connection on the same tuple (or a SYN retransmission)
+            releaseWindow(id);
+            streams_[id].next_seq = seq + 1;
         }
     }
 
-    std::vector<uint8_t> reassembled;
+    Stream& stream = streams_[id];
 
-    // effective_seq is where the data starts
-    uint32_t effective_seq = seq;
-    if (is_syn) {
-        effective_seq++;
-    }
+    // SYN consumes one sequence number; data starts after it
+    uint32_t data_seq = is_syn ? seq + 1 : seq;
+    uint32_t fin_seq = data_seq + static_cast<uint32_t>(payload.size());
 
     if (payload.empty()) {
-        // Just an ACK or control packet.
-        // FIN handling
-        if (is_fin) {
-            // FIN consumes 1 seq
-            // If we were waiting for this seq, advance.
-            if (effective_seq == state.next_seq) {
-                state.next_seq++;
-            }
+        if (is_fin && data_seq == stream.next_seq) {
+            stream.next_seq++;
+        }
+        return {};
+    }
+
+    // Wrapping difference: negative means (partly) already delivered
+    int32_t diff = static_cast<int32_t>(data_seq - stream.next_seq);
+    if (diff < 0) {
+        size_t seen = stream.next_seq - data_seq;
+        if (seen >= payload.size()) {
+            return {};  // Retransmission
         }
-        return reassembled;
+        payload = ByteView(payload.data() + seen, payload.size() - seen);
+        diff = 0;
+    }
+
+    if (diff > 0) {
+        if (bufferSegment(id, static_cast<uint32_t>(diff), payload)) {
+            stats_.segments_buffered++;
+        } else {
+            stats_.segments_dropped++;
+        }
+        return {};
+    }
+
+    ByteView in_order = deliver(id, payload);
+    if (is_fin && stream.next_seq == fin_seq) {
+        stream.next_seq++;
+    }
+    stats_.bytes_delivered += in_order.size();
+    return in_order;
+}
+
+size_t TcpReassembler::expire(Timestamp now) {
+    size_t expired = 0;
+    while (!streams_.empty() &&
+           now - streams_[streams_.oldest()].last_seen > limits_.idle_timeout) {
+        removeStream(streams_.oldest());
+        ++expired;
+    }
+    stats_.streams_expired += expired;
+    return expired;
+}
+
+// ============================================================================
+// Stream table
+// ============================================================================
+
+uint32_t TcpReassembler::createStream(const FlowKey& key, uint32_t hash, Timestamp now) {
+    if (streams_.size() >= limits_.max_streams) {
+        removeStream(streams_.oldest());
+        stats_.streams_evicted++;
+    }
+
+    uint32_t id = streams_.insert(key, hash);
+    streams_[id].last_seen = now;
+    stats_.streams_created++;
+    return id;
+}
+
+void TcpReassembler::touchStream(uint32_t id, Timestamp now) {
+    streams_[id].last_seen = now;
+    streams_.touch(id);
+    if (!streams_[id].ring.empty() && buffered_.tail != id) {
+        unlinkBuffered(id);
+        pushBuffered(id);
+    }
+}
+
+void TcpReassembler::removeStream(uint32_t id) {
+    releaseWindow(id);
+    streams_.erase(id);
+}
+
+void TcpReassembler::unlinkBuffered(uint32_t id) {
+    Link& node = streams_[id].buffered;
+    if (node.prev != kNil) {
+        streams_[node.prev].buffered.next = node.next;
+    } else {
+        buffered_.head = node.next;
     }
+    if (node.next != kNil) {
+        streams_[node.next].buffered.prev = node.prev;
+    } else {
+        buffered_.tail = node.prev;
+    }
+    node = Link();
+}
 
-    // Check if this is the expected sequence
-    // Using wrapping arithmetic logic: overflow safe difference
-    int32_t diff = static_cast<int32_t>(effective_seq - state.next_seq);
+void TcpReassembler::pushBuffered(uint32_t id) {
+    Link& node = streams_[id].buffered;
+    node.prev = buffered_.tail;
+    node.next = kNil;
+    if (buffered_.tail != kNil) {
+        streams_[buffered_.tail].buffered.next = id;
+    } else {
+        buffered_.head = id;
+    }
+    buffered_.tail = id;
+}
+
+// ============================================================================
+// Out-of-order window
+// ============================================================================
+
+bool TcpReassembler::bufferSegment(uint32_t id, uint32_t offset, ByteView data) {
+    size_t end = static_cast<size_t>(offset) + data.size();
+    if (end > limits_.max_window_bytes || !reserveWindow(id, end)) {
+        return false;
+    }
 
-    if (diff == 0) {
-        // Expected segment
-        reassembled.insert(reassembled.end(), payload.begin(), payload.end());
-        state.next_seq += payload.size();
+    Stream& stream = streams_[id];
+    size_t mask = stream.ring.size() - 1;
+    size_t pos = (stream.head + offset) & mask;
+    size_t first = std::min(data.size(), stream.ring.size() - pos);
+    std::memcpy(stream.ring.data() + pos, data.data(), first);
+    std::memcpy(stream.ring.data(), data.data() + first, data.size() - first);
 
-        // Check for FIN processing (FIN is usually at end of payload)
-        if (is_fin) {
-            state.next_seq++;
+    // Merge [offset, end) into the pending ranges
+    Range merged{offset, static_cast<uint32_t>(end)};
+    auto it = std::lower_bound(stream.pending.begin(), stream.pending.end(), merged.begin,
+                               [](const Range& r, uint32_t begin) { return r.end < begin; });
+    auto last = it;
+    while (last != stream.pending.end() && last->begin <= merged.end) {
+        merged.begin = std::min(merged.begin, last->begin);
+        merged.end = std::max(merged.end, last->end);
+        ++last;
+    }
+    it = stream.pending.erase(it, last);
+    stream.pending.insert(it, merged);
+    return true;
+}
+
+bool TcpReassembler::reserveWindow(uint32_t id, size_t needed) {
+    size_t capacity = streams_[id].ring.size();
+    if (needed <= capacity) {
+        return true;
+    }
+    size_t new_capacity = roundUpPow2(std::max(needed, kMinRingBytes));
+    size_t extra = new_capacity - capacity;
+
+    while (buffered_bytes_ + extra > limits_.memory_budget_bytes) {
+        uint32_t victim = buffered_.head;
+        if (victim == kNil || victim == id) {
+            return false;
         }
+        removeStream(victim);
+        stats_.streams_evicted++;
+    }
+
+    // Re-linearize so offset 0 sits at the start of the new ring
+    Stream& stream = streams_[id];
+    std::vector<uint8_t> ring(new_capacity);
+    if (capacity > 0) {
+        std::memcpy(ring.data(), stream.ring.data() + stream.head, capacity - stream.head);
+        std::memcpy(ring.data() + capacity - stream.head, stream.ring.data(), stream.head);
+    } else {
+        pushBuffered(id);
+    }
+    stream.ring.swap(ring);
+    stream.head = 0;
+    buffered_bytes_ += extra;
+    return true;
+}
+
+void TcpReassembler::releaseWindow(uint32_t id) {
+    Stream& stream = streams_[id];
+    if (stream.ring.empty()) {
+        return;
+    }
+    unlinkBuffered(id);
+    buffered_bytes_ -= stream.ring.size();
+    std::vector<uint8_t>().swap(stream.ring);
+    std::vector<Range>().swap(stream.pending);
+    stream.head = 0;
+}
+
+ByteView TcpReassembler::deliver(uint32_t id, ByteView in_order) {
+    Stream& stream = streams_[id];
+    size_t delivered = in_order.size();
 
-        // Check buffer for subsequent segments
-        while (!state.out_of_order_segments.empty()) {
-            auto it = state.out_of_order_segments.begin();
-            uint32_t buffered_seq = it->first;
-
-            if (buffered_seq == state.next_seq) {
-                // Next contiguous block
-                reassembled.insert(reassembled.end(), it->second.begin(), it->second.end());
-                state.next_seq += it->second.size();
-                state.out_of_order_segments.erase(it);
-            } else {
-                // Check if buffered packet is now overlap/old (should have been handled)
-                // or just still ahead.
-                int32_t buf_diff = static_cast<int32_t>(buffered_seq - state.next_seq);
-                if (buf_diff < 0) {
-                    // Old data, remove
-                    state.out_of_order_segments.erase(it);
-                } else {
-                    // Gap, stop
-                    break;
-                }
+    if (stream.pending.empty() || stream.pending.front().begin > delivered) {
+        // Nothing buffered joins this segment: hand it out in place
+        stream.next_seq += static_cast<uint32_t>(delivered);
+        if (!stream.pending.empty()) {
+            stream.head = static_cast<uint32_t>((stream.head + delivered) & (stream.ring.size() - 1));
+            for (auto& range : stream.pending) {
+                range.begin -= static_cast<uint32_t>(delivered);
+                range.end -= static_cast<uint32_t>(delivered);
             }
         }
-    } else if (diff > 0) {
-        // Gap, buffer it
-        // Only buffer if reasonable size to avoid DoS
-        if (state.out_of_order_segments.size() < 100) {
-            state.out_of_order_segments[effective_seq] = payload;
+        return in_order;
+    }
+
+    // The segment closes a gap: append every buffered range it now reaches
+    output_.assign(in_order.begin(), in_order.end());
+    size_t mask = stream.ring.size() - 1;
+    size_t consumed = 0;
+    while (consumed < stream.pending.size() && stream.pending[consumed].begin <= delivered) {
+        for (size_t offset = delivered; offset < stream.pending[consumed].end;) {
+            size_t pos = (stream.head + offset) & mask;
+            size_t chunk = std::min<size_t>(stream.pending[consumed].end - offset,
+                                            stream.ring.size() - pos);
+            output_.insert(output_.end(), stream.ring.begin() + pos,
+                           stream.ring.begin() + pos + chunk);
+            offset += chunk;
         }
-    } else {
-        // Duplicate or retransmission (diff < 0)
-        // Ignore
+        delivered = std::max<size_t>(delivered, stream.pending[consumed].end);
+        ++consumed;
     }
 
-    return reassembled;
+    stream.next_seq += static_cast<uint32_t>(delivered);
+    stream.pending.erase(stream.pending.begin(), stream.pending.begin() + consumed);
+    if (stream.pending.empty()) {
+        releaseWindow(id);
+    } else {
+        stream.head = static_cast<uint32_t>((stream.head + delivered) & mask);
+        for (auto& range : stream.pending) {
+            range.begin -= static_cast<uint32_t>(delivered);
+            range.end -= static_cast<uint32_t>(delivered);
+        }
+    }
+    return ByteView(output_);
 }
 
 }  // namespace callflow
@@ -1,5 +1,6 @@
 #include "persistence/database.h"
 
+#include <algorithm>
 #include <chrono>
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -123,6 +124,21 @@ CREATE TABLE IF NOT EXISTS password_reset_tokens (
 CREATE INDEX IF NOT EXISTS idx_password_reset_tokens_hash ON password_reset_tokens(token_hash);
 )";
 
+static const char* INSERT_SESSION_SQL = R"(
+    INSERT INTO sessions (
+        session_id, job_id, session_type, session_key,
+        start_time, end_time, duration_ms,
+        packet_count, byte_count, participant_ips, metadata
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+static const char* INSERT_EVENT_SQL = R"(
+    INSERT INTO events (
+        session_id, timestamp, event_type, protocol,
+        src_ip, dst_ip, src_port, dst_port, message_type, payload
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
@@ -184,6 +200,11 @@ bool DatabaseManager::initialize() {
 void DatabaseManager::close() {
     std::lock_guard<std::mutex> lock(db_mutex_);
 
+    finalizeStatement(insert_session_stmt_);
+    finalizeStatement(insert_event_stmt_);
+    insert_session_stmt_ = nullptr;
+    insert_event_stmt_ = nullptr;
+
     if (db_) {
         sqlite3_close(db_);
         db_ = nullptr;
@@ -447,36 +468,7 @@ bool DatabaseManager::insertSession(const SessionRecord& session) {
     if (!db_)
         return false;
 
-    const char* sql = R"(
-        INSERT INTO sessions (
-            session_id, job_id, session_type, session_key,
-            start_time, end_time, duration_ms,
-            packet_count, byte_count, participant_ips, metadata
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
-
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(sql, &stmt)) {
-        return false;
-    }
-
-    sqlite3_bind_text(stmt, 1, session.session_id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, session.job_id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, session.session_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, session.session_key.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 5, session.start_time);
-    sqlite3_bind_int64(stmt, 6, session.end_time);
-    sqlite3_bind_int64(stmt, 7, session.duration_ms);
-    sqlite3_bind_int64(stmt, 8, session.packet_count);
-    sqlite3_bind_int64(stmt, 9, session.byte_count);
-    sqlite3_bind_text(stmt, 10, session.participant_ips.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 11, session.metadata.c_str(), -1, SQLITE_TRANSIENT);
-
-    int rc = sqlite3_step(stmt);
-    finalizeStatement(stmt);
-
-    if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to insert session: {}", sqlite3_errmsg(db_));
+    if (!stepInsertSession(session)) {
         return false;
     }
 
@@ -679,42 +671,59 @@ bool DatabaseManager::insertEvent(EventRecord& event) {
     if (!db_)
         return false;
 
-    const char* sql = R"(
-        INSERT INTO events (
-            session_id, timestamp, event_type, protocol,
-            src_ip, dst_ip, src_port, dst_port, message_type, payload
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
+    return stepInsertEvent(event);
+}
 
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(sql, &stmt)) {
-        return false;
-    }
+// ============================================================================
+// Bulk Operations
+// ============================================================================
 
-    sqlite3_bind_text(stmt, 1, event.session_id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, event.timestamp);
-    sqlite3_bind_text(stmt, 3, event.event_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, event.protocol.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 5, event.src_ip.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 6, event.dst_ip.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 7, event.src_port);
-    sqlite3_bind_int(stmt, 8, event.dst_port);
-    sqlite3_bind_text(stmt, 9, event.message_type.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 10, event.payload.c_str(), -1, SQLITE_TRANSIENT);
+size_t DatabaseManager::insertBatch(const std::vector<SessionRecord>& sessions,
+                                    std::vector<EventRecord>& events) {
+    const size_t batch_size = config_.batch_size > 0 ? static_cast<size_t>(config_.batch_size) : 1;
+    const size_t total = sessions.size() + events.size();
+    size_t inserted = 0;
 
-    int rc = sqlite3_step(stmt);
-    if (rc == SQLITE_DONE) {
-        event.event_id = sqlite3_last_insert_rowid(db_);
-    }
+    // Rows [0, sessions.size()) are sessions, the rest are events
+    for (size_t begin = 0; begin < total; begin += batch_size) {
+        size_t end = std::min(total, begin + batch_size);
 
-    finalizeStatement(stmt);
+        std::lock_guard<std::mutex> lock(db_mutex_);
+        if (!db_)
+            return inserted;
 
-    if (rc != SQLITE_DONE) {
-        LOG_ERROR("Failed to insert event: {}", sqlite3_errmsg(db_));
-        return false;
+        if (!execute("BEGIN IMMEDIATE")) {
+            continue;
+        }
+
+        size_t batch_inserted = 0;
+        for (size_t row = begin; row < end; ++row) {
+            bool ok = row < sessions.size() ? stepInsertSession(sessions[row])
+                                            : stepInsertEvent(events[row - sessions.size()]);
+            if (ok) {
+                batch_inserted++;
+            }
+        }
+
+        if (execute("COMMIT")) {
+            inserted += batch_inserted;
+        } else {
+            execute("ROLLBACK");
+            LOG_ERROR("Rolled back batch of {} rows", end - begin);
+        }
     }
 
-    return true;
+    LOG_DEBUG("Bulk insert: {} of {} rows", inserted, total);
+    return inserted;
+}
+
+bool DatabaseManager::insertSessions(const std::vector<SessionRecord>& sessions) {
+    std::vector<EventRecord> no_events;
+    return insertBatch(sessions, no_events) == sessions.size();
+}
+
+bool DatabaseManager::insertEvents(std::vector<EventRecord>& events) {
+    return insertBatch({}, events) == events.size();
 }
 
 std::vector<EventRecord> DatabaseManager::getEventsBySession(const std::string& session_id) {
@@ -874,6 +883,70 @@ void DatabaseManager::finalizeStatement(sqlite3_stmt* stmt) {
     }
 }
 
+sqlite3_stmt* DatabaseManager::cachedStatement(sqlite3_stmt*& slot, const char* sql) {
+    if (!slot && !prepareStatement(sql, &slot)) {
+        slot = nullptr;
+        return nullptr;
+    }
+    sqlite3_reset(slot);
+    sqlite3_clear_bindings(slot);
+    return slot;
+}
+
+bool DatabaseManager::stepInsertSession(const SessionRecord& session) {
+    sqlite3_stmt* stmt = cachedStatement(insert_session_stmt_, INSERT_SESSION_SQL);
+    if (!stmt) {
+        return false;
+    }
+
+    // Records outlive the step, so the text can be bound without copying
+    sqlite3_bind_text(stmt, 1, session.session_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, session.job_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, session.session_type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, session.session_key.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 5, session.start_time);
+    sqlite3_bind_int64(stmt, 6, session.end_time);
+    sqlite3_bind_int64(stmt, 7, session.duration_ms);
+    sqlite3_bind_int64(stmt, 8, session.packet_count);
+    sqlite3_bind_int64(stmt, 9, session.byte_count);
+    sqlite3_bind_text(stmt, 10, session.participant_ips.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 11, session.metadata.c_str(), -1, SQLITE_STATIC);
+
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to insert session: {}", sqlite3_errmsg(db_));
+    }
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE;
+}
+
+bool DatabaseManager::stepInsertEvent(EventRecord& event) {
+    sqlite3_stmt* stmt = cachedStatement(insert_event_stmt_, INSERT_EVENT_SQL);
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, event.session_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, event.timestamp);
+    sqlite3_bind_text(stmt, 3, event.event_type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, event.protocol.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, event.src_ip.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, event.dst_ip.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 7, event.src_port);
+    sqlite3_bind_int(stmt, 8, event.dst_port);
+    sqlite3_bind_text(stmt, 9, event.message_type.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 10, event.payload.c_str(), -1, SQLITE_STATIC);
+
+    int rc = sqlite3_step(stmt);
+    if (rc == SQLITE_DONE) {
+        event.event_id = sqlite3_last_insert_rowid(db_);
+    } else {
+        LOG_ERROR("Failed to insert event: {}", sqlite3_errmsg(db_));
+    }
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE;
+}
+
 int64_t DatabaseManager::timestampToUnix(const Timestamp& ts) {
     auto duration = ts.time_since_epoch();
     return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
@@ -0,0 +1,143 @@
+#include "persistence/database_writer.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/logger.h"
+
+namespace callflow {
+
+namespace {
+// How long a partial batch may wait for more rows before it is written anyway
+constexpr auto kBatchLinger = std::chrono::milliseconds(50);
+}  // namespace
+
+DatabaseWriter::DatabaseWriter(std::shared_ptr<DatabaseManager> db, const DatabaseConfig& config)
+    : db_(std::move(db)),
+      batch_size_(config.batch_size > 0 ? static_cast<size_t>(config.batch_size) : 1),
+      max_queued_(std::max(config.writer_queue_max, batch_size_)) {}
+
+DatabaseWriter::~DatabaseWriter() {
+    stop();
+}
+
+void DatabaseWriter::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&DatabaseWriter::writerThread, this);
+    LOG_INFO("Database writer started (batch size " << batch_size_ << ", queue limit "
+                                                    << max_queued_ << ")");
+}
+
+void DatabaseWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    work_cv_.notify_all();
+    space_cv_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    LOG_INFO("Database writer stopped (" << stats_.rows_written << " rows written, "
+                                         << stats_.rows_failed << " failed)");
+}
+
+bool DatabaseWriter::enqueue(SessionRecord session) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!waitForSpace(lock)) {
+        return false;
+    }
+    pending_sessions_.push_back(std::move(session));
+    stats_.rows_queued++;
+
+    size_t pending = pending_sessions_.size() + pending_events_.size();
+    lock.unlock();
+    if (pending == 1 || pending >= batch_size_) {
+        work_cv_.notify_one();
+    }
+    return true;
+}
+
+bool DatabaseWriter::enqueue(EventRecord event) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!waitForSpace(lock)) {
+        return false;
+    }
+    pending_events_.push_back(std::move(event));
+    stats_.rows_queued++;
+
+    size_t pending = pending_sessions_.size() + pending_events_.size();
+    lock.unlock();
+    if (pending == 1 || pending >= batch_size_) {
+        work_cv_.notify_one();
+    }
+    return true;
+}
+
+void DatabaseWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target = stats_.rows_queued;
+    flush_target_ = std::max(flush_target_, target);
+    work_cv_.notify_one();
+    space_cv_.wait(lock, [&] { return stats_.rows_written + stats_.rows_failed >= target; });
+}
+
+DatabaseWriter::Stats DatabaseWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool DatabaseWriter::waitForSpace(std::unique_lock<std::mutex>& lock) {
+    space_cv_.wait(lock, [&] {
+        return !running_.load() ||
+               pending_sessions_.size() + pending_events_.size() < max_queued_;
+    });
+    return running_.load();
+}
+
+void DatabaseWriter::writerThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        auto pending = [&] { return pending_sessions_.size() + pending_events_.size(); };
+        auto flushing = [&] { return flush_target_ > stats_.rows_written + stats_.rows_failed; };
+
+        work_cv_.wait(lock, [&] { return !running_.load() || pending() > 0; });
+        if (pending() == 0) {
+            break;  // Stopped and drained
+        }
+
+        // Give a partial batch a moment to fill up so rows are not committed one by one
+        if (running_.load() && pending() < batch_size_ && !flushing()) {
+            work_cv_.wait_for(lock, kBatchLinger, [&] {
+                return !running_.load() || pending() >= batch_size_ || flushing();
+            });
+        }
+
+        std::vector<SessionRecord> sessions;
+        std::vector<EventRecord> events;
+        sessions.swap(pending_sessions_);
+        events.swap(pending_events_);
+        lock.unlock();
+        space_cv_.notify_all();
+
+        size_t rows = sessions.size() + events.size();
+        size_t written = db_ ? db_->insertBatch(sessions, events) : 0;
+
+        lock.lock();
+        stats_.rows_written += written;
+        stats_.rows_failed += rows - written;
+        stats_.batches += (rows + batch_size_ - 1) / batch_size_;
+        if (written < rows) {
+            LOG_WARN("Database writer: " << (rows - written) << " of " << rows
+                                         << " rows failed to insert");
+        }
+        space_cv_.notify_all();
+    }
+}
+
+}  // namespace callflow
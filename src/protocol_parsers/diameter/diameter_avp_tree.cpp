@@ -0,0 +1,280 @@
+#include "protocol_parsers/diameter/diameter_avp_tree.h"
+
+#include <arpa/inet.h>
+
+#include <cstring>
+
+#include "common/logger.h"
+#include "protocol_parsers/diameter/diameter_avp_parser.h"
+
+#ifdef __APPLE__
+#include <libkern/OSByteOrder.h>
+#define be64toh(x) OSSwapBigToHostInt64(x)
+#else
+#include <endian.h>
+#endif
+
+namespace callflow {
+namespace diameter {
+
+namespace {
+
+uint32_t readUint24(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) |
+           static_cast<uint32_t>(data[2]);
+}
+
+uint32_t readUint32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return ntohl(value);
+}
+
+}  // namespace
+
+bool DiameterAvpTree::isBaseGrouped(uint32_t code, uint32_t vendor_id) {
+    return DiameterAVPParser::getAVPDataType(code, vendor_id) == DiameterAVPDataType::GROUPED;
+}
+
+// ============================================================================
+// Building
+// ============================================================================
+
+void DiameterAvpTree::clear() {
+    nodes_.clear();
+    index_mask_ = 0;
+}
+
+bool DiameterAvpTree::parseMessage(const uint8_t* data, size_t length, DiameterHeader& header,
+                                   GroupedPredicate grouped) {
+    clear();
+    if (!data || length < DIAMETER_HEADER_SIZE || data[0] != DIAMETER_VERSION) {
+        return false;
+    }
+
+    const uint32_t message_length = readUint24(data + 1);
+    if (message_length < DIAMETER_HEADER_SIZE || message_length > length) {
+        LOG_DEBUG("Incomplete Diameter message: have " << length << " bytes, need "
+                                                       << message_length);
+        return false;
+    }
+
+    const uint8_t flags = data[4];
+    header.version = data[0];
+    header.message_length = message_length;
+    header.request = (flags & 0x80) != 0;
+    header.proxyable = (flags & 0x40) != 0;
+    header.error = (flags & 0x20) != 0;
+    header.potentially_retransmitted = (flags & 0x10) != 0;
+    header.command_code = readUint24(data + 5);
+    header.application_id = readUint32(data + 8);
+    header.hop_by_hop_id = readUint32(data + 12);
+    header.end_to_end_id = readUint32(data + 16);
+
+    return parse(data + DIAMETER_HEADER_SIZE, message_length - DIAMETER_HEADER_SIZE, grouped);
+}
+
+bool DiameterAvpTree::parse(const uint8_t* data, size_t length, GroupedPredicate grouped) {
+    clear();
+    bool complete = parseLevel(data, length, kRoot, 0, grouped);
+    buildIndex();
+    return complete;
+}
+
+bool DiameterAvpTree::parseLevel(const uint8_t* data, size_t length, uint32_t parent,
+                                 uint32_t depth, GroupedPredicate grouped) {
+    uint32_t previous = kNil;
+    size_t offset = 0;
+    while (offset < length) {
+        if (offset + DIAMETER_AVP_HEADER_MIN_SIZE > length) {
+            LOG_DEBUG("Not enough data for AVP header at offset " << offset);
+            return false;
+        }
+
+        Node node;
+        node.code = readUint32(data + offset);
+        node.flags = data[offset + 4];
+        node.parent = parent;
+        const uint32_t avp_length = readUint24(data + offset + 5);
+
+        size_t header_len = DIAMETER_AVP_HEADER_MIN_SIZE;
+        if (node.flags & 0x80) {
+            header_len = DIAMETER_AVP_HEADER_VENDOR_SIZE;
+            if (offset + header_len > length) {
+                LOG_DEBUG("Not enough data for vendor ID at offset " << offset);
+                return false;
+            }
+            node.vendor_id = readUint32(data + offset + 8);
+        }
+        if (avp_length < header_len || offset + avp_length > length) {
+            LOG_DEBUG("Invalid AVP length " << avp_length << " at offset " << offset);
+            return false;
+        }
+
+        node.data = data + offset + header_len;
+        node.length = avp_length - static_cast<uint32_t>(header_len);
+        node.grouped = grouped && depth < kMaxDepth && grouped(node.code, node.vendor_id);
+
+        uint32_t current = append(node, previous);
+        if (parent != kRoot && nodes_[parent].first_child == kNil) {
+            nodes_[parent].first_child = current;
+        }
+        if (node.grouped) {
+            // A malformed group keeps the children parsed so far, like parseGrouped()
+            parseLevel(node.data, node.length, current, depth + 1, grouped);
+        }
+
+        offset += avp_length + DiameterAVPParser::calculatePadding(avp_length);
+    }
+    return true;
+}
+
+void DiameterAvpTree::flatten(const std::vector<std::shared_ptr<DiameterAVP>>& avps) {
+    clear();
+    flattenLevel(avps, kRoot, 0);
+    buildIndex();
+}
+
+void DiameterAvpTree::flattenLevel(const std::vector<std::shared_ptr<DiameterAVP>>& avps,
+                                   uint32_t parent, uint32_t depth) {
+    uint32_t previous = kNil;
+    for (const auto& avp : avps) {
+        if (!avp) {
+            continue;
+        }
+
+        Node node;
+        node.code = avp->code;
+        node.vendor_id = avp->vendor_id.value_or(0);
+        node.flags = static_cast<uint8_t>((avp->vendor_specific ? 0x80 : 0) |
+                                          (avp->mandatory ? 0x40 : 0) |
+                                          (avp->protected_ ? 0x20 : 0));
+        node.data = avp->data.data();
+        node.length = static_cast<uint32_t>(avp->data.size());
+        node.parent = parent;
+
+        const auto* children = avp->groupedAVPs();
+        node.grouped = children != nullptr && depth < kMaxDepth;
+
+        uint32_t current = append(node, previous);
+        if (parent != kRoot && nodes_[parent].first_child == kNil) {
+            nodes_[parent].first_child = current;
+        }
+        if (node.grouped) {
+            flattenLevel(*children, current, depth + 1);
+        }
+    }
+}
+
+uint32_t DiameterAvpTree::append(const Node& node, uint32_t& previous) {
+    const auto index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(node);
+    if (previous != kNil) {
+        nodes_[previous].next_sibling = index;
+    }
+    previous = index;
+    return index;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+void DiameterAvpTree::buildIndex() {
+    // Load factor at most one half
+    size_t capacity = 8;
+    while (capacity < nodes_.size() * 2) {
+        capacity <<= 1;
+    }
+    index_.assign(capacity, Slot{});
+    index_mask_ = static_cast<uint32_t>(capacity - 1);
+
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        const uint64_t k = key(nodes_[i].parent, nodes_[i].code);
+        uint32_t pos = static_cast<uint32_t>((k * 0x9E3779B97F4A7C15ull) >> 32) & index_mask_;
+        while (index_[pos].first != kNil && index_[pos].key != k) {
+            pos = (pos + 1) & index_mask_;
+        }
+        Slot& slot = index_[pos];
+        if (slot.first == kNil) {
+            slot.key = k;
+            slot.first = i;
+        } else {
+            nodes_[slot.last].next_same = i;
+        }
+        slot.last = i;
+    }
+}
+
+uint32_t DiameterAvpTree::find(uint32_t code, uint32_t parent) const {
+    if (nodes_.empty()) {
+        return kNil;
+    }
+    const uint64_t k = key(parent, code);
+    uint32_t pos = static_cast<uint32_t>((k * 0x9E3779B97F4A7C15ull) >> 32) & index_mask_;
+    while (index_[pos].first != kNil) {
+        if (index_[pos].key == k) {
+            return index_[pos].first;
+        }
+        pos = (pos + 1) & index_mask_;
+    }
+    return kNil;
+}
+
+uint32_t DiameterAvpTree::find(uint32_t code, uint32_t vendor_id, uint32_t parent) const {
+    uint32_t index = find(code, parent);
+    while (index != kNil && nodes_[index].vendor_id != vendor_id) {
+        index = nodes_[index].next_same;
+    }
+    return index;
+}
+
+// ============================================================================
+// Payload Accessors
+// ============================================================================
+
+std::optional<uint32_t> DiameterAvpTree::getUint32(uint32_t index) const {
+    const Node& n = nodes_[index];
+    if (n.length != 4) {
+        return std::nullopt;
+    }
+    return readUint32(n.data);
+}
+
+std::optional<uint64_t> DiameterAvpTree::getUint64(uint32_t index) const {
+    const Node& n = nodes_[index];
+    if (n.length != 8) {
+        return std::nullopt;
+    }
+    uint64_t value;
+    std::memcpy(&value, n.data, 8);
+    return be64toh(value);
+}
+
+std::optional<int32_t> DiameterAvpTree::getInt32(uint32_t index) const {
+    auto value = getUint32(index);
+    if (!value.has_value()) {
+        return std::nullopt;
+    }
+    return static_cast<int32_t>(value.value());
+}
+
+std::string DiameterAvpTree::getString(uint32_t index) const {
+    const Node& n = nodes_[index];
+    for (uint32_t i = 0; i < n.length; ++i) {
+        const uint8_t byte = n.data[i];
+        if (byte == 0) {
+            break;  // Null terminator
+        }
+        if (byte < 0x20 && byte != 0x09 && byte != 0x0A && byte != 0x0D) {
+            return "";  // Non-printable character
+        }
+        if (byte == 0x7F) {
+            return "";  // DEL
+        }
+    }
+    return std::string(getView(index));
+}
+
+}  // namespace diameter
+}  // namespace callflow
@@ -4,6 +4,7 @@
 
 #include <cstring>
 
+#include "protocol_parsers/diameter/diameter_avp_tree.h"
 #include "protocol_parsers/diameter/diameter_types.h"
 
 #ifdef __APPLE__
@@ -176,6 +177,10 @@ std::optional<std::vector<std::shared_ptr<DiameterAVP>>> DiameterAVP::getGrouped
     return std::nullopt;
 }
 
+const std::vector<std::shared_ptr<DiameterAVP>>* DiameterAVP::groupedAVPs() const {
+    return std::get_if<std::vector<std::shared_ptr<DiameterAVP>>>(&decoded_value);
+}
+
 std::string DiameterAVP::getAVPName() const {
     // Map common AVP codes to names
     switch (static_cast<DiameterAVPCode>(code)) {
@@ -369,5 +374,38 @@ void DiameterMessage::extractCommonFields() {
     }
 }
 
+void DiameterMessage::extractCommonFields(const DiameterAvpTree& tree) {
+    for (uint32_t i = tree.firstChild(); i != DiameterAvpTree::kNil; i = tree.nextSibling(i)) {
+        switch (static_cast<DiameterAVPCode>(tree.node(i).code)) {
+            case DiameterAVPCode::SESSION_ID:
+                session_id = tree.getString(i);
+                break;
+            case DiameterAVPCode::ORIGIN_HOST:
+                origin_host = tree.getString(i);
+                break;
+            case DiameterAVPCode::ORIGIN_REALM:
+                origin_realm = tree.getString(i);
+                break;
+            case DiameterAVPCode::DESTINATION_HOST:
+                destination_host = tree.getString(i);
+                break;
+            case DiameterAVPCode::DESTINATION_REALM:
+                destination_realm = tree.getString(i);
+                break;
+            case DiameterAVPCode::RESULT_CODE:
+                result_code = tree.getUint32(i);
+                break;
+            case DiameterAVPCode::AUTH_APPLICATION_ID:
+                auth_application_id = tree.getUint32(i);
+                break;
+            case DiameterAVPCode::ACCT_APPLICATION_ID:
+                acct_application_id = tree.getUint32(i);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
 }  // namespace diameter
 }  // namespace callflow
@@ -532,9 +532,9 @@ UserAuthorizationAnswer DiameterCxParser::parseUAA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     uaa.experimental_result_code = sub_avp->getDataAsUint32();
@@ -653,9 +653,9 @@ ServerAssignmentAnswer DiameterCxParser::parseSAA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     saa.experimental_result_code = sub_avp->getDataAsUint32();
@@ -682,9 +682,9 @@ ServerAssignmentAnswer DiameterCxParser::parseSAA(const DiameterMessage& msg) {
     auto assoc_id_avp = msg.findAVP(static_cast<uint32_t>(CxDxAVPCode::ASSOCIATED_IDENTITIES),
                                     DIAMETER_VENDOR_3GPP);
     if (assoc_id_avp) {
-        auto grouped_avps = assoc_id_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = assoc_id_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code == static_cast<uint32_t>(DiameterAVPCode::USER_NAME)) {
                     saa.associated_identities.push_back(sub_avp->getDataAsString());
                 }
@@ -754,9 +754,9 @@ LocationInfoAnswer DiameterCxParser::parseLIA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     lia.experimental_result_code = sub_avp->getDataAsUint32();
@@ -841,9 +841,9 @@ MultimediaAuthAnswer DiameterCxParser::parseMAA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     maa.experimental_result_code = sub_avp->getDataAsUint32();
@@ -912,9 +912,9 @@ RegistrationTerminationRequest DiameterCxParser::parseRTR(const DiameterMessage&
     auto assoc_id_avp = msg.findAVP(static_cast<uint32_t>(CxDxAVPCode::ASSOCIATED_IDENTITIES),
                                     DIAMETER_VENDOR_3GPP);
     if (assoc_id_avp) {
-        auto grouped_avps = assoc_id_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = assoc_id_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code == static_cast<uint32_t>(DiameterAVPCode::USER_NAME)) {
                     rtr.associated_identities.push_back(sub_avp->getDataAsString());
                 }
@@ -941,9 +941,9 @@ RegistrationTerminationAnswer DiameterCxParser::parseRTA(const DiameterMessage&
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     rta.experimental_result_code = sub_avp->getDataAsUint32();
@@ -956,9 +956,9 @@ RegistrationTerminationAnswer DiameterCxParser::parseRTA(const DiameterMessage&
     auto assoc_id_avp = msg.findAVP(static_cast<uint32_t>(CxDxAVPCode::ASSOCIATED_IDENTITIES),
                                     DIAMETER_VENDOR_3GPP);
     if (assoc_id_avp) {
-        auto grouped_avps = assoc_id_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = assoc_id_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code == static_cast<uint32_t>(DiameterAVPCode::USER_NAME)) {
                     rta.associated_identities.push_back(sub_avp->getDataAsString());
                 }
@@ -1021,9 +1021,9 @@ PushProfileAnswer DiameterCxParser::parsePPA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     ppa.experimental_result_code = sub_avp->getDataAsUint32();
@@ -1051,14 +1051,14 @@ PushProfileAnswer DiameterCxParser::parsePPA(const DiameterMessage& msg) {
 
 std::optional<ServerCapabilities> DiameterCxParser::parseServerCapabilities(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ServerCapabilities capabilities;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(CxDxAVPCode::MANDATORY_CAPABILITY): {
                 auto val = sub_avp->getDataAsUint32();
@@ -1086,14 +1086,14 @@ std::optional<ServerCapabilities> DiameterCxParser::parseServerCapabilities(
 
 std::optional<SIPNumberAuthItems> DiameterCxParser::parseSIPNumberAuthItems(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     SIPNumberAuthItems auth_items;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         if (sub_avp->code == static_cast<uint32_t>(CxDxAVPCode::SIP_AUTH_DATA_ITEM)) {
             auto auth_item = parseSIPAuthDataItem(sub_avp);
             if (auth_item.has_value()) {
@@ -1107,15 +1107,15 @@ std::optional<SIPNumberAuthItems> DiameterCxParser::parseSIPNumberAuthItems(
 
 std::optional<SIPAuthDataItem> DiameterCxParser::parseSIPAuthDataItem(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     SIPAuthDataItem item;
     item.sip_item_number = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(CxDxAVPCode::SIP_ITEM_NUMBER): {
                 auto val = sub_avp->getDataAsUint32();
@@ -1157,14 +1157,14 @@ std::optional<SIPAuthDataItem> DiameterCxParser::parseSIPAuthDataItem(
 
 std::optional<ChargingInformation> DiameterCxParser::parseChargingInformation(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ChargingInformation charging_info;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(CxDxAVPCode::PRIMARY_EVENT_CHARGING_FUNCTION_NAME):
                 charging_info.primary_event_charging_function_name = sub_avp->getDataAsString();
@@ -1188,15 +1188,15 @@ std::optional<ChargingInformation> DiameterCxParser::parseChargingInformation(
 
 std::optional<DeregistrationReason> DiameterCxParser::parseDeregistrationReason(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     DeregistrationReason reason;
     reason.reason_code = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(CxDxAVPCode::REASON_CODE): {
                 auto val = sub_avp->getDataAsUint32();
@@ -1216,8 +1216,8 @@ std::optional<DeregistrationReason> DiameterCxParser::parseDeregistrationReason(
 
 std::optional<SupportedFeatures> DiameterCxParser::parseSupportedFeatures(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
@@ -1226,7 +1226,7 @@ std::optional<SupportedFeatures> DiameterCxParser::parseSupportedFeatures(
     features.feature_list_id = 0;
     features.feature_list = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(DiameterAVPCode::VENDOR_ID): {
                 auto val = sub_avp->getDataAsUint32();
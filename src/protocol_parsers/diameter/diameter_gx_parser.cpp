@@ -660,14 +660,14 @@ GxReAuthAnswer DiameterGxParser::parseRAA(const DiameterMessage& msg) {
 
 std::optional<ChargingRuleInstall> DiameterGxParser::parseChargingRuleInstall(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ChargingRuleInstall cri;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::CHARGING_RULE_DEFINITION): {
                 auto rule_def = parseChargingRuleDefinition(sub_avp);
@@ -700,14 +700,14 @@ std::optional<ChargingRuleInstall> DiameterGxParser::parseChargingRuleInstall(
 
 std::optional<ChargingRuleRemove> DiameterGxParser::parseChargingRuleRemove(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ChargingRuleRemove crr;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::CHARGING_RULE_NAME):
                 crr.charging_rule_name.push_back(sub_avp->getDataAsString());
@@ -723,14 +723,14 @@ std::optional<ChargingRuleRemove> DiameterGxParser::parseChargingRuleRemove(
 
 std::optional<ChargingRuleDefinition> DiameterGxParser::parseChargingRuleDefinition(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ChargingRuleDefinition crd;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::CHARGING_RULE_NAME):
                 crd.charging_rule_name = sub_avp->getDataAsString();
@@ -789,14 +789,14 @@ std::optional<ChargingRuleDefinition> DiameterGxParser::parseChargingRuleDefinit
 
 std::optional<QoSInformation> DiameterGxParser::parseQoSInformation(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     QoSInformation qos;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::QOS_CLASS_IDENTIFIER):
                 qos.qos_class_identifier = sub_avp->getDataAsUint32();
@@ -827,15 +827,15 @@ std::optional<QoSInformation> DiameterGxParser::parseQoSInformation(
 
 std::optional<DefaultEPSBearerQoS> DiameterGxParser::parseDefaultEPSBearerQoS(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     DefaultEPSBearerQoS qos;
     std::optional<AllocationRetentionPriority> arp;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::QOS_CLASS_IDENTIFIER): {
                 auto qci_val = sub_avp->getDataAsUint32();
@@ -860,8 +860,8 @@ std::optional<DefaultEPSBearerQoS> DiameterGxParser::parseDefaultEPSBearerQoS(
 
 std::optional<AllocationRetentionPriority> DiameterGxParser::parseAllocationRetentionPriority(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
@@ -870,7 +870,7 @@ std::optional<AllocationRetentionPriority> DiameterGxParser::parseAllocationRete
     arp.pre_emption_capability = PreemptionCapability::PRE_EMPTION_CAPABILITY_DISABLED;
     arp.pre_emption_vulnerability = PreemptionVulnerability::PRE_EMPTION_VULNERABILITY_ENABLED;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::PRIORITY_LEVEL): {
                 auto priority_val = sub_avp->getDataAsUint32();
@@ -902,15 +902,15 @@ std::optional<AllocationRetentionPriority> DiameterGxParser::parseAllocationRete
 
 std::optional<FlowInformation> DiameterGxParser::parseFlowInformation(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     FlowInformation flow;
     flow.flow_direction = FlowDirection::UNSPECIFIED;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::FLOW_DESCRIPTION):
                 flow.flow_description = sub_avp->getDataAsString();
@@ -926,14 +926,14 @@ std::optional<FlowInformation> DiameterGxParser::parseFlowInformation(
 
 std::optional<UsageMonitoringInformation> DiameterGxParser::parseUsageMonitoringInformation(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     UsageMonitoringInformation umi;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::MONITORING_KEY):
                 umi.monitoring_key = sub_avp->data;
@@ -951,14 +951,14 @@ std::optional<UsageMonitoringInformation> DiameterGxParser::parseUsageMonitoring
 }
 
 std::optional<ServiceUnit> DiameterGxParser::parseServiceUnit(std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     ServiceUnit su;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case 420:  // CC-Time
                 su.cc_time = sub_avp->getDataAsUint32();
@@ -983,14 +983,14 @@ std::optional<ServiceUnit> DiameterGxParser::parseServiceUnit(std::shared_ptr<Di
 
 std::optional<UsedServiceUnit> DiameterGxParser::parseUsedServiceUnit(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     UsedServiceUnit usu;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case 420:  // CC-Time
                 usu.cc_time = sub_avp->getDataAsUint32();
@@ -1015,15 +1015,15 @@ std::optional<UsedServiceUnit> DiameterGxParser::parseUsedServiceUnit(
 
 std::optional<PCCRuleStatusReport> DiameterGxParser::parsePCCRuleStatusReport(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     PCCRuleStatusReport report;
     report.pcc_rule_status = PCCRuleStatus::ACTIVE;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(GxAVPCode::CHARGING_RULE_NAME):
                 report.rule_names.push_back(sub_avp->getDataAsString());
@@ -218,6 +218,25 @@ nlohmann::json DiameterGyMessage::toJson() const {
 // DiameterGyParser Implementation
 // ============================================================================
 
+namespace {
+
+constexpr uint32_t gy(GyAVPCode code) {
+    return static_cast<uint32_t>(code);
+}
+
+/**
+ * Iterate the children of a grouped AVP node
+ */
+template <typename Fn>
+void forEachChild(const DiameterAvpTree& tree, uint32_t node, Fn&& fn) {
+    for (uint32_t child = tree.firstChild(node); child != DiameterAvpTree::kNil;
+         child = tree.nextSibling(child)) {
+        fn(child, tree.node(child).code);
+    }
+}
+
+}  // namespace
+
 bool DiameterGyParser::isGyMessage(const DiameterMessage& msg) {
     // Gy uses DCCA (application ID 4) with credit control command
     return (msg.header.application_id == DIAMETER_GY_APPLICATION_ID ||
@@ -226,28 +245,69 @@ bool DiameterGyParser::isGyMessage(const DiameterMessage& msg) {
            msg.header.command_code == static_cast<uint32_t>(DiameterCommandCode::CREDIT_CONTROL);
 }
 
+bool DiameterGyParser::isGroupedAVP(uint32_t code, uint32_t vendor_id) {
+    switch (code) {
+        case gy(GyAVPCode::SUBSCRIPTION_ID):
+        case gy(GyAVPCode::MULTIPLE_SERVICES_CREDIT_CONTROL):
+        case gy(GyAVPCode::REQUESTED_SERVICE_UNIT):
+        case gy(GyAVPCode::GRANTED_SERVICE_UNIT):
+        case gy(GyAVPCode::USED_SERVICE_UNIT):
+        case gy(GyAVPCode::FINAL_UNIT_INDICATION):
+        case gy(GyAVPCode::REDIRECT_SERVER):
+        case gy(GyAVPCode::COST_INFORMATION):
+        case gy(GyAVPCode::USER_EQUIPMENT_INFO):
+            return true;
+        case gy(GyAVPCode::SERVICE_INFORMATION):
+        case gy(GyAVPCode::PS_INFORMATION):
+        case gy(GyAVPCode::IMS_INFORMATION):
+            return vendor_id == DIAMETER_VENDOR_3GPP;
+        default:
+            return DiameterAvpTree::isBaseGrouped(code, vendor_id);
+    }
+}
+
 std::optional<DiameterGyMessage> DiameterGyParser::parse(const DiameterMessage& msg) {
     if (!isGyMessage(msg)) {
         return std::nullopt;
     }
 
+    tree_.flatten(msg.avps);
+    return parseTree(msg, tree_);
+}
+
+std::optional<DiameterGyMessage> DiameterGyParser::parse(const uint8_t* data, size_t length) {
+    DiameterMessage base;
+    if (!tree_.parseMessage(data, length, base.header, &isGroupedAVP)) {
+        LOG_DEBUG("Failed to parse Gy message AVPs");
+        return std::nullopt;
+    }
+    base.extractCommonFields(tree_);
+    if (!isGyMessage(base)) {
+        return std::nullopt;
+    }
+
+    return parseTree(base, tree_);
+}
+
+std::optional<DiameterGyMessage> DiameterGyParser::parseTree(const DiameterMessage& msg,
+                                                             const DiameterAvpTree& tree) {
     DiameterGyMessage gy_msg;
     gy_msg.base = msg;
 
     // Extract common fields
-    auto called_station_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CALLED_STATION_ID));
-    if (called_station_avp) {
-        gy_msg.called_station_id = called_station_avp->getDataAsString();
+    uint32_t called_station = tree.find(gy(GyAVPCode::CALLED_STATION_ID));
+    if (called_station != DiameterAvpTree::kNil) {
+        gy_msg.called_station_id = tree.getString(called_station);
     }
 
     // Parse based on message direction
     if (msg.isRequest()) {
-        gy_msg.ccr = parseCCR(msg);
+        gy_msg.ccr = parseCCR(tree);
         if (gy_msg.ccr.has_value()) {
             gy_msg.cc_request_type = gy_msg.ccr->cc_request_type;
         }
     } else {
-        gy_msg.cca = parseCCA(msg);
+        gy_msg.cca = parseCCA(msg, tree);
         if (gy_msg.cca.has_value()) {
             gy_msg.cc_request_type = gy_msg.cca->cc_request_type;
         }
@@ -256,74 +316,76 @@ std::optional<DiameterGyMessage> DiameterGyParser::parse(const DiameterMessage&
     return gy_msg;
 }
 
-GyCreditControlRequest DiameterGyParser::parseCCR(const DiameterMessage& msg) {
+GyCreditControlRequest DiameterGyParser::parseCCR(const DiameterAvpTree& tree) {
+    constexpr uint32_t kNil = DiameterAvpTree::kNil;
     GyCreditControlRequest ccr;
 
     // CC-Request-Type and CC-Request-Number
-    auto cc_type_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CC_REQUEST_TYPE));
-    if (cc_type_avp) {
-        auto type_val = cc_type_avp->getDataAsUint32();
+    uint32_t cc_type = tree.find(gy(GyAVPCode::CC_REQUEST_TYPE));
+    if (cc_type != kNil) {
+        auto type_val = tree.getUint32(cc_type);
         if (type_val.has_value()) {
             ccr.cc_request_type = static_cast<CCRequestType>(type_val.value());
         }
     }
 
-    auto cc_num_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CC_REQUEST_NUMBER));
-    if (cc_num_avp) {
-        auto num_val = cc_num_avp->getDataAsUint32();
+    uint32_t cc_num = tree.find(gy(GyAVPCode::CC_REQUEST_NUMBER));
+    if (cc_num != kNil) {
+        auto num_val = tree.getUint32(cc_num);
         if (num_val.has_value()) {
             ccr.cc_request_number = num_val.value();
         }
     }
 
     // Service context
-    auto service_ctx_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::SERVICE_CONTEXT_ID));
-    if (service_ctx_avp) {
-        ccr.service_context_id = service_ctx_avp->getDataAsString();
+    uint32_t service_ctx = tree.find(gy(GyAVPCode::SERVICE_CONTEXT_ID));
+    if (service_ctx != kNil) {
+        ccr.service_context_id = tree.getString(service_ctx);
     }
 
     // Subscription IDs
-    auto sub_id_avps = msg.findAllAVPs(static_cast<uint32_t>(GyAVPCode::SUBSCRIPTION_ID));
-    for (const auto& avp : sub_id_avps) {
-        auto sub_id = parseSubscriptionId(avp);
+    for (uint32_t node = tree.find(gy(GyAVPCode::SUBSCRIPTION_ID)); node != kNil;
+         node = tree.nextSame(node)) {
+        auto sub_id = parseSubscriptionId(tree, node);
         if (sub_id.has_value()) {
-            ccr.subscription_ids.push_back(sub_id.value());
+            ccr.subscription_ids.push_back(std::move(sub_id.value()));
         }
     }
 
     // Multiple Services Credit Control
-    auto mscc_avps =
-        msg.findAllAVPs(static_cast<uint32_t>(GyAVPCode::MULTIPLE_SERVICES_CREDIT_CONTROL));
-    for (const auto& avp : mscc_avps) {
-        auto mscc = parseMSCC(avp);
+    for (uint32_t node = tree.find(gy(GyAVPCode::MULTIPLE_SERVICES_CREDIT_CONTROL)); node != kNil;
+         node = tree.nextSame(node)) {
+        auto mscc = parseMSCC(tree, node);
         if (mscc.has_value()) {
-            ccr.mscc.push_back(mscc.value());
+            ccr.mscc.push_back(std::move(mscc.value()));
         }
     }
 
     // User equipment info
-    auto ue_info_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::USER_EQUIPMENT_INFO));
-    if (ue_info_avp) {
-        ccr.user_equipment_info = parseUserEquipmentInfo(ue_info_avp);
+    uint32_t ue_info = tree.find(gy(GyAVPCode::USER_EQUIPMENT_INFO));
+    if (ue_info != kNil) {
+        ccr.user_equipment_info = parseUserEquipmentInfo(tree, ue_info);
     }
 
     // Service information
-    auto service_info_avp =
-        msg.findAVP(static_cast<uint32_t>(GyAVPCode::SERVICE_INFORMATION), DIAMETER_VENDOR_3GPP);
-    if (service_info_avp) {
-        ccr.service_information = parseServiceInformation(service_info_avp);
+    uint32_t service_info = tree.find(gy(GyAVPCode::SERVICE_INFORMATION), DIAMETER_VENDOR_3GPP,
+                                      DiameterAvpTree::kRoot);
+    if (service_info != kNil) {
+        ccr.service_information = parseServiceInformation(tree, service_info);
     }
 
     // Event timestamp
-    auto timestamp_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::EVENT_TIMESTAMP));
-    if (timestamp_avp) {
-        ccr.event_timestamp = DiameterAVPParser::parseTime(timestamp_avp->data);
+    uint32_t timestamp = tree.find(gy(GyAVPCode::EVENT_TIMESTAMP));
+    if (timestamp != kNil) {
+        ccr.event_timestamp = DiameterAVPParser::parseTime(tree.getBytes(timestamp));
     }
 
     return ccr;
 }
 
-GyCreditControlAnswer DiameterGyParser::parseCCA(const DiameterMessage& msg) {
+GyCreditControlAnswer DiameterGyParser::parseCCA(const DiameterMessage& msg,
+                                                 const DiameterAvpTree& tree) {
+    constexpr uint32_t kNil = DiameterAvpTree::kNil;
     GyCreditControlAnswer cca;
 
     // Result code
@@ -332,42 +394,41 @@ GyCreditControlAnswer DiameterGyParser::parseCCA(const DiameterMessage& msg) {
     }
 
     // CC-Request-Type and CC-Request-Number
-    auto cc_type_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CC_REQUEST_TYPE));
-    if (cc_type_avp) {
-        auto type_val = cc_type_avp->getDataAsUint32();
+    uint32_t cc_type = tree.find(gy(GyAVPCode::CC_REQUEST_TYPE));
+    if (cc_type != kNil) {
+        auto type_val = tree.getUint32(cc_type);
         if (type_val.has_value()) {
             cca.cc_request_type = static_cast<CCRequestType>(type_val.value());
         }
     }
 
-    auto cc_num_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CC_REQUEST_NUMBER));
-    if (cc_num_avp) {
-        auto num_val = cc_num_avp->getDataAsUint32();
+    uint32_t cc_num = tree.find(gy(GyAVPCode::CC_REQUEST_NUMBER));
+    if (cc_num != kNil) {
+        auto num_val = tree.getUint32(cc_num);
         if (num_val.has_value()) {
             cca.cc_request_number = num_val.value();
         }
     }
 
     // Multiple Services Credit Control
-    auto mscc_avps =
-        msg.findAllAVPs(static_cast<uint32_t>(GyAVPCode::MULTIPLE_SERVICES_CREDIT_CONTROL));
-    for (const auto& avp : mscc_avps) {
-        auto mscc = parseMSCC(avp);
+    for (uint32_t node = tree.find(gy(GyAVPCode::MULTIPLE_SERVICES_CREDIT_CONTROL)); node != kNil;
+         node = tree.nextSame(node)) {
+        auto mscc = parseMSCC(tree, node);
         if (mscc.has_value()) {
-            cca.mscc.push_back(mscc.value());
+            cca.mscc.push_back(std::move(mscc.value()));
         }
     }
 
     // Cost information
-    auto cost_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::COST_INFORMATION));
-    if (cost_avp) {
-        cca.cost_information = parseCostInformation(cost_avp);
+    uint32_t cost = tree.find(gy(GyAVPCode::COST_INFORMATION));
+    if (cost != kNil) {
+        cca.cost_information = parseCostInformation(tree, cost);
     }
 
     // CC session failover
-    auto failover_avp = msg.findAVP(static_cast<uint32_t>(GyAVPCode::CC_SESSION_FAILOVER));
-    if (failover_avp) {
-        cca.cc_session_failover = failover_avp->getDataAsUint32();
+    uint32_t failover = tree.find(gy(GyAVPCode::CC_SESSION_FAILOVER));
+    if (failover != kNil) {
+        cca.cc_session_failover = tree.getUint32(failover);
     }
 
     return cca;
@@ -379,344 +440,350 @@ GyCreditControlAnswer DiameterGyParser::parseCCA(const DiameterMessage& msg) {
 
 std::optional<MultipleServicesCreditControl> DiameterGyParser::parseMSCC(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    DiameterAvpTree tree;
+    tree.flatten({avp});
+    return tree.empty() ? std::nullopt : parseMSCC(tree, 0);
+}
+
+std::optional<SubscriptionId> DiameterGyParser::parseSubscriptionId(
+    std::shared_ptr<DiameterAVP> avp) {
+    DiameterAvpTree tree;
+    tree.flatten({avp});
+    return tree.empty() ? std::nullopt : parseSubscriptionId(tree, 0);
+}
+
+std::optional<ServiceUnit> DiameterGyParser::parseServiceUnit(std::shared_ptr<DiameterAVP> avp) {
+    DiameterAvpTree tree;
+    tree.flatten({avp});
+    return tree.empty() ? std::nullopt : parseServiceUnit(tree, 0);
+}
+
+std::optional<MultipleServicesCreditControl> DiameterGyParser::parseMSCC(
+    const DiameterAvpTree& tree, uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     MultipleServicesCreditControl mscc;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::GRANTED_SERVICE_UNIT):
-                mscc.granted_service_unit = parseServiceUnit(sub_avp);
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::GRANTED_SERVICE_UNIT):
+                mscc.granted_service_unit = parseServiceUnit(tree, sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::REQUESTED_SERVICE_UNIT):
-                mscc.requested_service_unit = parseServiceUnit(sub_avp);
+            case gy(GyAVPCode::REQUESTED_SERVICE_UNIT):
+                mscc.requested_service_unit = parseServiceUnit(tree, sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::USED_SERVICE_UNIT):
-                mscc.used_service_unit = parseUsedServiceUnit(sub_avp);
+            case gy(GyAVPCode::USED_SERVICE_UNIT):
+                mscc.used_service_unit = parseUsedServiceUnit(tree, sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::RATING_GROUP):
-                mscc.rating_group = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::RATING_GROUP):
+                mscc.rating_group = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::SERVICE_IDENTIFIER):
-                mscc.service_identifier = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::SERVICE_IDENTIFIER):
+                mscc.service_identifier = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::VALIDITY_TIME):
-                mscc.validity_time = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::VALIDITY_TIME):
+                mscc.validity_time = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::RESULT_CODE):
-                mscc.result_code = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::RESULT_CODE):
+                mscc.result_code = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::FINAL_UNIT_INDICATION):
-                mscc.final_unit_indication = parseFinalUnitIndication(sub_avp);
+            case gy(GyAVPCode::FINAL_UNIT_INDICATION):
+                mscc.final_unit_indication = parseFinalUnitIndication(tree, sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::REPORTING_REASON): {
-                auto reason_val = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::REPORTING_REASON): {
+                auto reason_val = tree.getUint32(sub);
                 if (reason_val.has_value()) {
                     mscc.reporting_reason = static_cast<ReportingReason>(reason_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::TRIGGER_TYPE): {
-                auto trigger_val = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::TRIGGER_TYPE): {
+                auto trigger_val = tree.getUint32(sub);
                 if (trigger_val.has_value()) {
                     mscc.triggers.push_back(static_cast<TriggerType>(trigger_val.value()));
                 }
                 break;
             }
         }
-    }
+    });
 
     return mscc;
 }
 
-std::optional<SubscriptionId> DiameterGyParser::parseSubscriptionId(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<SubscriptionId> DiameterGyParser::parseSubscriptionId(const DiameterAvpTree& tree,
+                                                                    uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     SubscriptionId sub_id;
     sub_id.subscription_id_type = SubscriptionIdType::END_USER_E164;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::SUBSCRIPTION_ID_TYPE): {
-                auto type_val = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::SUBSCRIPTION_ID_TYPE): {
+                auto type_val = tree.getUint32(sub);
                 if (type_val.has_value()) {
                     sub_id.subscription_id_type = static_cast<SubscriptionIdType>(type_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::SUBSCRIPTION_ID_DATA):
-                sub_id.subscription_id_data = sub_avp->getDataAsString();
+            case gy(GyAVPCode::SUBSCRIPTION_ID_DATA):
+                sub_id.subscription_id_data = tree.getString(sub);
                 break;
         }
-    }
+    });
 
     return sub_id;
 }
 
-std::optional<ServiceUnit> DiameterGyParser::parseServiceUnit(std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<ServiceUnit> DiameterGyParser::parseServiceUnit(const DiameterAvpTree& tree,
+                                                              uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     ServiceUnit su;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::CC_TIME):
-                su.cc_time = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::CC_TIME):
+                su.cc_time = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_TOTAL_OCTETS):
-                su.cc_total_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_TOTAL_OCTETS):
+                su.cc_total_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_INPUT_OCTETS):
-                su.cc_input_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_INPUT_OCTETS):
+                su.cc_input_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_OUTPUT_OCTETS):
-                su.cc_output_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_OUTPUT_OCTETS):
+                su.cc_output_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_SERVICE_SPECIFIC_UNITS):
-                su.cc_service_specific_units = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::CC_SERVICE_SPECIFIC_UNITS):
+                su.cc_service_specific_units = tree.getUint32(sub);
                 break;
         }
-    }
+    });
 
     return su;
 }
 
-std::optional<UsedServiceUnit> DiameterGyParser::parseUsedServiceUnit(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<UsedServiceUnit> DiameterGyParser::parseUsedServiceUnit(const DiameterAvpTree& tree,
+                                                                      uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     UsedServiceUnit usu;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::CC_TIME):
-                usu.cc_time = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::CC_TIME):
+                usu.cc_time = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_TOTAL_OCTETS):
-                usu.cc_total_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_TOTAL_OCTETS):
+                usu.cc_total_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_INPUT_OCTETS):
-                usu.cc_input_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_INPUT_OCTETS):
+                usu.cc_input_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_OUTPUT_OCTETS):
-                usu.cc_output_octets = sub_avp->getDataAsUint64();
+            case gy(GyAVPCode::CC_OUTPUT_OCTETS):
+                usu.cc_output_octets = tree.getUint64(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CC_SERVICE_SPECIFIC_UNITS):
-                usu.cc_service_specific_units = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::CC_SERVICE_SPECIFIC_UNITS):
+                usu.cc_service_specific_units = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TARIFF_CHANGE_USAGE): {
-                auto tariff_val = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::TARIFF_CHANGE_USAGE): {
+                auto tariff_val = tree.getUint32(sub);
                 if (tariff_val.has_value()) {
                     usu.tariff_change_usage = static_cast<TariffChangeUsage>(tariff_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::REPORTING_REASON):
-                usu.reporting_reason = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::REPORTING_REASON):
+                usu.reporting_reason = tree.getUint32(sub);
                 break;
         }
-    }
+    });
 
     return usu;
 }
 
 std::optional<FinalUnitIndication> DiameterGyParser::parseFinalUnitIndication(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const DiameterAvpTree& tree, uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     FinalUnitIndication fui;
     fui.final_unit_action = FinalUnitAction::TERMINATE;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::FINAL_UNIT_ACTION): {
-                auto action_val = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::FINAL_UNIT_ACTION): {
+                auto action_val = tree.getUint32(sub);
                 if (action_val.has_value()) {
                     fui.final_unit_action = static_cast<FinalUnitAction>(action_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::RESTRICTION_FILTER_RULE):
-                fui.restriction_filter_rule.push_back(sub_avp->getDataAsString());
+            case gy(GyAVPCode::RESTRICTION_FILTER_RULE):
+                fui.restriction_filter_rule.push_back(tree.getString(sub));
                 break;
-            case static_cast<uint32_t>(GyAVPCode::FILTER_ID):
-                fui.filter_id.push_back(sub_avp->getDataAsString());
+            case gy(GyAVPCode::FILTER_ID):
+                fui.filter_id.push_back(tree.getString(sub));
                 break;
-            case static_cast<uint32_t>(GyAVPCode::REDIRECT_SERVER):
-                fui.redirect_server = parseRedirectServer(sub_avp);
+            case gy(GyAVPCode::REDIRECT_SERVER):
+                fui.redirect_server = parseRedirectServer(tree, sub);
                 break;
         }
-    }
+    });
 
     return fui;
 }
 
-std::optional<RedirectServer> DiameterGyParser::parseRedirectServer(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<RedirectServer> DiameterGyParser::parseRedirectServer(const DiameterAvpTree& tree,
+                                                                    uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     RedirectServer rs;
     rs.redirect_address_type = RedirectAddressType::IPv4_ADDRESS;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::REDIRECT_ADDRESS_TYPE): {
-                auto type_val = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::REDIRECT_ADDRESS_TYPE): {
+                auto type_val = tree.getUint32(sub);
                 if (type_val.has_value()) {
                     rs.redirect_address_type = static_cast<RedirectAddressType>(type_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::REDIRECT_SERVER_ADDRESS):
-                rs.redirect_server_address = sub_avp->getDataAsString();
+            case gy(GyAVPCode::REDIRECT_SERVER_ADDRESS):
+                rs.redirect_server_address = tree.getString(sub);
                 break;
         }
-    }
+    });
 
     return rs;
 }
 
 std::optional<UserEquipmentInfo> DiameterGyParser::parseUserEquipmentInfo(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const DiameterAvpTree& tree, uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     UserEquipmentInfo uei;
     uei.user_equipment_info_type = UserEquipmentInfoType::IMEISV;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::USER_EQUIPMENT_INFO_TYPE): {
-                auto type_val = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::USER_EQUIPMENT_INFO_TYPE): {
+                auto type_val = tree.getUint32(sub);
                 if (type_val.has_value()) {
                     uei.user_equipment_info_type =
                         static_cast<UserEquipmentInfoType>(type_val.value());
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::USER_EQUIPMENT_INFO_VALUE):
-                uei.user_equipment_info_value = sub_avp->getDataAsString();
+            case gy(GyAVPCode::USER_EQUIPMENT_INFO_VALUE):
+                uei.user_equipment_info_value = tree.getString(sub);
                 break;
         }
-    }
+    });
 
     return uei;
 }
 
 std::optional<ServiceInformation> DiameterGyParser::parseServiceInformation(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const DiameterAvpTree& tree, uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     ServiceInformation si;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::PS_INFORMATION):
-                si.ps_information = parsePSInformation(sub_avp);
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::PS_INFORMATION):
+                si.ps_information = parsePSInformation(tree, sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::IMS_INFORMATION):
-                si.ims_information = parseIMSInformation(sub_avp);
+            case gy(GyAVPCode::IMS_INFORMATION):
+                si.ims_information = parseIMSInformation(tree, sub);
                 break;
         }
-    }
+    });
 
     return si;
 }
 
-std::optional<PSInformation> DiameterGyParser::parsePSInformation(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<PSInformation> DiameterGyParser::parsePSInformation(const DiameterAvpTree& tree,
+                                                                  uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     PSInformation psi;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::TGPP_CHARGING_ID):
-                psi.tgpp_charging_id = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::TGPP_CHARGING_ID):
+                psi.tgpp_charging_id = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_PDP_TYPE):
-                psi.tgpp_pdp_type = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::TGPP_PDP_TYPE):
+                psi.tgpp_pdp_type = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_SGSN_ADDRESS):
-                psi.tgpp_sgsn_address = sub_avp->getDataAsString();
+            case gy(GyAVPCode::TGPP_SGSN_ADDRESS):
+                psi.tgpp_sgsn_address = tree.getString(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_GGSN_ADDRESS):
-                psi.tgpp_ggsn_address = sub_avp->getDataAsString();
+            case gy(GyAVPCode::TGPP_GGSN_ADDRESS):
+                psi.tgpp_ggsn_address = tree.getString(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::CALLED_STATION_ID):
-                psi.called_station_id = sub_avp->getDataAsString();
+            case gy(GyAVPCode::CALLED_STATION_ID):
+                psi.called_station_id = tree.getString(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_NSAPI):
-                psi.tgpp_nsapi = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::TGPP_NSAPI):
+                psi.tgpp_nsapi = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_SELECTION_MODE):
-                psi.tgpp_selection_mode = sub_avp->getDataAsString();
+            case gy(GyAVPCode::TGPP_SELECTION_MODE):
+                psi.tgpp_selection_mode = tree.getString(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_CHARGING_CHARACTERISTICS):
-                psi.tgpp_charging_characteristics = sub_avp->getDataAsString();
+            case gy(GyAVPCode::TGPP_CHARGING_CHARACTERISTICS):
+                psi.tgpp_charging_characteristics = tree.getString(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_RAT_TYPE):
-                psi.tgpp_rat_type = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::TGPP_RAT_TYPE):
+                psi.tgpp_rat_type = tree.getUint32(sub);
                 break;
-            case static_cast<uint32_t>(GyAVPCode::TGPP_USER_LOCATION_INFO):
-                psi.tgpp_user_location_info = sub_avp->data;
+            case gy(GyAVPCode::TGPP_USER_LOCATION_INFO):
+                psi.tgpp_user_location_info = tree.getBytes(sub);
                 break;
         }
-    }
+    });
 
     return psi;
 }
 
-std::optional<IMSInformation> DiameterGyParser::parseIMSInformation(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<IMSInformation> DiameterGyParser::parseIMSInformation(const DiameterAvpTree& tree,
+                                                                    uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
     IMSInformation imsi;
 
-    // Simplified parsing - would need vendor-specific AVP codes for full implementation
-    for (const auto& sub_avp : grouped_avps.value()) {
-        (void)sub_avp;
-        // Parse vendor-specific AVPs here
-        // This is a placeholder for IMS-specific information
-    }
+    // Simplified parsing - would need vendor-specific AVP codes for full implementation.
+    // This is a placeholder for IMS-specific information.
 
     return imsi;
 }
 
-std::optional<CostInformation> DiameterGyParser::parseCostInformation(
-    std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+std::optional<CostInformation> DiameterGyParser::parseCostInformation(const DiameterAvpTree& tree,
+                                                                      uint32_t node) {
+    if (!tree.node(node).grouped) {
         return std::nullopt;
     }
 
@@ -724,27 +791,27 @@ std::optional<CostInformation> DiameterGyParser::parseCostInformation(
     ci.unit_value = 0;
     ci.currency_code = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
-        switch (sub_avp->code) {
-            case static_cast<uint32_t>(GyAVPCode::UNIT_VALUE): {
-                auto val = sub_avp->getDataAsUint32();
+    forEachChild(tree, node, [&](uint32_t sub, uint32_t code) {
+        switch (code) {
+            case gy(GyAVPCode::UNIT_VALUE): {
+                auto val = tree.getUint32(sub);
                 if (val.has_value()) {
                     ci.unit_value = val.value();
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::CURRENCY_CODE): {
-                auto val = sub_avp->getDataAsUint32();
+            case gy(GyAVPCode::CURRENCY_CODE): {
+                auto val = tree.getUint32(sub);
                 if (val.has_value()) {
                     ci.currency_code = val.value();
                 }
                 break;
             }
-            case static_cast<uint32_t>(GyAVPCode::COST_UNIT):
-                ci.cost_unit = sub_avp->getDataAsString();
+            case gy(GyAVPCode::COST_UNIT):
+                ci.cost_unit = tree.getString(sub);
                 break;
         }
-    }
+    });
 
     return ci;
 }
@@ -559,15 +559,15 @@ RxAbortSessionAnswer DiameterRxParser::parseASA(const DiameterMessage& msg) {
 
 std::optional<MediaComponentDescription> DiameterRxParser::parseMediaComponentDescription(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     MediaComponentDescription mcd;
     mcd.media_component_number = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(RxAVPCode::MEDIA_COMPONENT_NUMBER): {
                 auto num_val = sub_avp->getDataAsUint32();
@@ -635,8 +635,8 @@ std::optional<MediaComponentDescription> DiameterRxParser::parseMediaComponentDe
 
 std::optional<MediaSubComponent> DiameterRxParser::parseMediaSubComponent(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
@@ -644,7 +644,7 @@ std::optional<MediaSubComponent> DiameterRxParser::parseMediaSubComponent(
     msc.flow_number = 0;
     msc.flow_usage = FlowUsage::NO_INFORMATION;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(RxAVPCode::FLOW_NUMBER): {
                 auto num_val = sub_avp->getDataAsUint32();
@@ -678,14 +678,14 @@ std::optional<MediaSubComponent> DiameterRxParser::parseMediaSubComponent(
 
 std::optional<AccessNetworkChargingIdentifier>
 DiameterRxParser::parseAccessNetworkChargingIdentifier(std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     AccessNetworkChargingIdentifier anci;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(RxAVPCode::ACCESS_NETWORK_CHARGING_IDENTIFIER_VALUE):
                 anci.access_network_charging_identifier_value = sub_avp->data;
@@ -701,14 +701,14 @@ DiameterRxParser::parseAccessNetworkChargingIdentifier(std::shared_ptr<DiameterA
 
 std::optional<SponsoredConnectivityData> DiameterRxParser::parseSponsoredConnectivityData(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     SponsoredConnectivityData scd;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(RxAVPCode::SPONSOR_IDENTITY):
                 scd.sponsor_identity = sub_avp->getDataAsString();
@@ -466,9 +466,9 @@ UserDataAnswer DiameterShParser::parseUDA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     uda.experimental_result_code = sub_avp->getDataAsUint32();
@@ -574,9 +574,9 @@ ProfileUpdateAnswer DiameterShParser::parsePUA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     pua.experimental_result_code = sub_avp->getDataAsUint32();
@@ -713,9 +713,9 @@ SubscribeNotificationsAnswer DiameterShParser::parseSNA(const DiameterMessage& m
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     sna.experimental_result_code = sub_avp->getDataAsUint32();
@@ -804,9 +804,9 @@ PushNotificationAnswer DiameterShParser::parsePNA(const DiameterMessage& msg) {
     // Experimental-Result-Code
     auto exp_result_avp = msg.findAVP(static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT));
     if (exp_result_avp) {
-        auto grouped_avps = exp_result_avp->getGroupedAVPs();
-        if (grouped_avps.has_value()) {
-            for (const auto& sub_avp : grouped_avps.value()) {
+        const auto* grouped_avps = exp_result_avp->groupedAVPs();
+        if (grouped_avps) {
+            for (const auto& sub_avp : *grouped_avps) {
                 if (sub_avp->code ==
                     static_cast<uint32_t>(DiameterAVPCode::EXPERIMENTAL_RESULT_CODE)) {
                     pna.experimental_result_code = sub_avp->getDataAsUint32();
@@ -833,14 +833,14 @@ PushNotificationAnswer DiameterShParser::parsePNA(const DiameterMessage& msg) {
 // ============================================================================
 
 std::optional<UserIdentity> DiameterShParser::parseUserIdentity(std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     UserIdentity identity;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(ShAVPCode::PUBLIC_IDENTITY):
                 identity.public_identity = sub_avp->getDataAsString();
@@ -859,15 +859,15 @@ std::optional<UserIdentity> DiameterShParser::parseUserIdentity(std::shared_ptr<
 
 std::optional<RepositoryDataID> DiameterShParser::parseRepositoryDataID(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
     RepositoryDataID repo_id;
     repo_id.sequence_number = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(ShAVPCode::SERVICE_INDICATION):
                 repo_id.service_indication = sub_avp->getDataAsString();
@@ -887,8 +887,8 @@ std::optional<RepositoryDataID> DiameterShParser::parseRepositoryDataID(
 
 std::optional<SupportedFeatures> DiameterShParser::parseSupportedFeatures(
     std::shared_ptr<DiameterAVP> avp) {
-    auto grouped_avps = avp->getGroupedAVPs();
-    if (!grouped_avps.has_value()) {
+    const auto* grouped_avps = avp->groupedAVPs();
+    if (!grouped_avps) {
         return std::nullopt;
     }
 
@@ -897,7 +897,7 @@ std::optional<SupportedFeatures> DiameterShParser::parseSupportedFeatures(
     features.feature_list_id = 0;
     features.feature_list = 0;
 
-    for (const auto& sub_avp : grouped_avps.value()) {
+    for (const auto& sub_avp : *grouped_avps) {
         switch (sub_avp->code) {
             case static_cast<uint32_t>(DiameterAVPCode::VENDOR_ID): {
                 auto val = sub_avp->getDataAsUint32();
@@ -0,0 +1,177 @@
+#include "protocol_parsers/hpack_huffman.h"
+
+namespace callflow {
+
+namespace {
+
+constexpr int kEos = 256;
+
+// Code length of every symbol, EOS last. The code is canonical (codes of one
+// length are consecutive, in symbol order), so the lengths determine it.
+constexpr uint8_t kCodeLength[257] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,  // 0x00
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,  // 0x10
+    6,  10, 10, 12, 13, 6,  8,  11, 10, 10, 8,  11, 8,  6,  6,  6,   // 0x20
+    5,  5,  5,  6,  6,  6,  6,  6,  6,  6,  7,  8,  15, 6,  12, 10,  // 0x30
+    13, 6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,   // 0x40
+    7,  7,  7,  7,  7,  7,  7,  7,  8,  7,  8,  13, 19, 13, 14, 6,   // 0x50
+    15, 5,  6,  5,  6,  5,  6,  6,  6,  5,  7,  7,  6,  6,  6,  5,   // 0x60
+    6,  7,  6,  5,  5,  6,  7,  7,  7,  7,  7,  15, 11, 14, 13, 28,  // 0x70
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,  // 0x80
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,  // 0x90
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,  // 0xa0
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,  // 0xb0
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,  // 0xc0
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,  // 0xd0
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,  // 0xe0
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,  // 0xf0
+    30};                                                             // EOS
+
+constexpr uint8_t kEmit = 0x01;    // The step completed a symbol
+constexpr uint8_t kAccept = 0x02;  // Input may end here: at most seven one bits since the symbol
+constexpr uint8_t kFail = 0x04;    // The step decoded EOS
+
+struct Code {
+    uint32_t bits = 0;
+    uint8_t length = 0;
+};
+
+struct Transition {
+    uint8_t next = 0;  // State (internal tree node) after the four bits
+    uint8_t flags = 0;
+    uint8_t symbol = 0;  // Valid with kEmit
+};
+
+struct HuffmanTables {
+    Code codes[257];
+    Transition transitions[256][16];
+
+    HuffmanTables();
+};
+
+HuffmanTables::HuffmanTables() {
+    // Canonical assignment: shorter codes first, one length in symbol order
+    uint32_t next_code = 0;
+    for (uint8_t length = 1; length <= 30; ++length) {
+        for (int symbol = 0; symbol <= kEos; ++symbol) {
+            if (kCodeLength[symbol] == length) {
+                codes[symbol] = {next_code++, length};
+            }
+        }
+        next_code <<= 1;
+    }
+
+    // Code tree: children >= 0 are internal nodes (0 is the root, so it also
+    // marks an unset child while building), < 0 are leaves holding ~symbol
+    int16_t child[256][2] = {};
+    int nodes = 1;
+    for (int symbol = 0; symbol <= kEos; ++symbol) {
+        int node = 0;
+        for (int bit = codes[symbol].length - 1; bit >= 0; --bit) {
+            int16_t& slot = child[node][(codes[symbol].bits >> bit) & 1];
+            if (bit == 0) {
+                slot = static_cast<int16_t>(~symbol);
+            } else {
+                if (slot == 0) {
+                    slot = static_cast<int16_t>(nodes++);
+                }
+                node = slot;
+            }
+        }
+    }
+
+    // Valid padding is a prefix of EOS (all ones) shorter than a byte
+    bool accepting[256] = {};
+    for (int node = 0, depth = 0; node >= 0 && depth < 8; node = child[node][1], ++depth) {
+        accepting[node] = true;
+    }
+
+    for (int state = 0; state < 256; ++state) {
+        for (int nibble = 0; nibble < 16; ++nibble) {
+            Transition& t = transitions[state][nibble];
+            int node = state;
+            for (int bit = 3; bit >= 0; --bit) {
+                int next = child[node][(nibble >> bit) & 1];
+                if (next >= 0) {
+                    node = next;
+                    continue;
+                }
+                if (~next == kEos) {
+                    t.flags = kFail;
+                    break;
+                }
+                t.flags |= kEmit;
+                t.symbol = static_cast<uint8_t>(~next);
+                node = 0;
+            }
+            if (!(t.flags & kFail) && accepting[node]) {
+                t.flags |= kAccept;
+            }
+            t.next = static_cast<uint8_t>(node);
+        }
+    }
+}
+
+const HuffmanTables& tables() {
+    static const HuffmanTables instance;
+    return instance;
+}
+
+}  // namespace
+
+bool HpackHuffman::decode(const uint8_t* data, size_t len, std::string& out) {
+    const Transition(&transitions)[256][16] = tables().transitions;
+    const size_t start = out.size();
+    // The shortest code is five bits, so a byte yields at most 8/5 symbols
+    out.resize(start + len * 8 / 5 + 1);
+    char* dst = out.data() + start;
+
+    uint8_t state = 0;
+    uint8_t flags = kAccept;
+    for (size_t i = 0; i < len; ++i) {
+        for (uint8_t nibble : {static_cast<uint8_t>(data[i] >> 4),
+                               static_cast<uint8_t>(data[i] & 0x0F)}) {
+            const Transition& t = transitions[state][nibble];
+            if (t.flags & kFail) {
+                out.resize(static_cast<size_t>(dst - out.data()));
+                return false;
+            }
+            if (t.flags & kEmit) {
+                *dst++ = static_cast<char>(t.symbol);
+            }
+            state = t.next;
+            flags = t.flags;
+        }
+    }
+
+    out.resize(static_cast<size_t>(dst - out.data()));
+    return (flags & kAccept) != 0;
+}
+
+void HpackHuffman::encode(std::string_view text, std::vector<uint8_t>& out) {
+    const Code* codes = tables().codes;
+    uint64_t bits = 0;  // Only the low `pending` bits are still to be written
+    unsigned pending = 0;
+    for (unsigned char c : text) {
+        bits = (bits << codes[c].length) | codes[c].bits;
+        pending += codes[c].length;
+        while (pending >= 8) {
+            pending -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> pending));
+        }
+    }
+    if (pending > 0) {
+        out.push_back(static_cast<uint8_t>((bits << (8 - pending)) | (0xFF >> pending)));
+    }
+}
+
+size_t HpackHuffman::encodedLength(std::string_view text) {
+    const Code* codes = tables().codes;
+    size_t bits = 0;
+    for (unsigned char c : text) {
+        bits += codes[c].length;
+    }
+    return (bits + 7) / 8;
+}
+
+}  // namespace callflow
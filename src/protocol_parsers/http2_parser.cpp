@@ -1,11 +1,13 @@
 #include "protocol_parsers/http2_parser.h"
 
 #include <algorithm>
+#include <charconv>
 #include <chrono>
 #include <cstring>
 #include <sstream>
 
 #include "common/logger.h"
+#include "protocol_parsers/hpack_huffman.h"
 
 namespace callflow {
 
@@ -132,74 +134,78 @@ nlohmann::json Http2Connection::toJson() const {
 // HPACK Decoder Implementation
 // ============================================================================
 
-// HPACK static table (RFC 7541 Appendix A)
-const std::vector<std::pair<std::string, std::string>> HpackDecoder::static_table_ =
-    HpackDecoder::initStaticTable();
-
-std::vector<std::pair<std::string, std::string>> HpackDecoder::initStaticTable() {
-    return {{"", ""},
-            {":authority", ""},
-            {":method", "GET"},
-            {":method", "POST"},
-            {":path", "/"},
-            {":path", "/index.html"},
-            {":scheme", "http"},
-            {":scheme", "https"},
-            {":status", "200"},
-            {":status", "204"},
-            {":status", "206"},
-            {":status", "304"},
-            {":status", "400"},
-            {":status", "404"},
-            {":status", "500"},
-            {"accept-charset", ""},
-            {"accept-encoding", "gzip, deflate"},
-            {"accept-language", ""},
-            {"accept-ranges", ""},
-            {"accept", ""},
-            {"access-control-allow-origin", ""},
-            {"age", ""},
-            {"allow", ""},
-            {"authorization", ""},
-            {"cache-control", ""},
-            {"content-disposition", ""},
-            {"content-encoding", ""},
-            {"content-language", ""},
-            {"content-length", ""},
-            {"content-location", ""},
-            {"content-range", ""},
-            {"content-type", ""},
-            {"cookie", ""},
-            {"date", ""},
-            {"etag", ""},
-            {"expect", ""},
-            {"expires", ""},
-            {"from", ""},
-            {"host", ""},
-            {"if-match", ""},
-            {"if-modified-since", ""},
-            {"if-none-match", ""},
-            {"if-range", ""},
-            {"if-unmodified-since", ""},
-            {"last-modified", ""},
-            {"link", ""},
-            {"location", ""},
-            {"max-forwards", ""},
-            {"proxy-authenticate", ""},
-            {"proxy-authorization", ""},
-            {"range", ""},
-            {"referer", ""},
-            {"refresh", ""},
-            {"retry-after", ""},
-            {"server", ""},
-            {"set-cookie", ""},
-            {"strict-transport-security", ""},
-            {"transfer-encoding", ""},
-            {"user-agent", ""},
-            {"vary", ""},
-            {"via", ""},
-            {"www-authenticate", ""}};
-}
+namespace {
+
+// HPACK static table (RFC 7541 Appendix A); index 0 is unused
+constexpr std::string_view kStaticTable[][2] = {{"", ""},
+                                                {":authority", ""},
+                                                {":method", "GET"},
+                                                {":method", "POST"},
+                                                {":path", "/"},
+                                                {":path", "/index.html"},
+                                                {":scheme", "http"},
+                                                {":scheme", "https"},
+                                                {":status", "200"},
+                                                {":status", "204"},
+                                                {":status", "206"},
+                                                {":status", "304"},
+                                                {":status", "400"},
+                                                {":status", "404"},
+                                                {":status", "500"},
+                                                {"accept-charset", ""},
+                                                {"accept-encoding", "gzip, deflate"},
+                                                {"accept-language", ""},
+                                                {"accept-ranges", ""},
+                                                {"accept", ""},
+                                                {"access-control-allow-origin", ""},
+                                                {"age", ""},
+                                                {"allow", ""},
+                                                {"authorization", ""},
+                                                {"cache-control", ""},
+                                                {"content-disposition", ""},
+                                                {"content-encoding", ""},
+                                                {"content-language", ""},
+                                                {"content-length", ""},
+                                                {"content-location", ""},
+                                                {"content-range", ""},
+                                                {"content-type", ""},
+                                                {"cookie", ""},
+                                                {"date", ""},
+                                                {"etag", ""},
+                                                {"expect", ""},
+                                                {"expires", ""},
+                                                {"from", ""},
+                                                {"host", ""},
+                                                {"if-match", ""},
+                                                {"if-modified-since", ""},
+                                                {"if-none-match", ""},
+                                                {"if-range", ""},
+                                                {"if-unmodified-since", ""},
+                                                {"last-modified", ""},
+                                                {"link", ""},
+                                                {"location", ""},
+                                                {"max-forwards", ""},
+                                                {"proxy-authenticate", ""},
+                                                {"proxy-authorization", ""},
+                                                {"range", ""},
+                                                {"referer", ""},
+                                                {"refresh", ""},
+                                                {"retry-after", ""},
+                                                {"server", ""},
+                                                {"set-cookie", ""},
+                                                {"strict-transport-security", ""},
+                                                {"transfer-encoding", ""},
+                                                {"user-agent", ""},
+                                                {"vary", ""},
+                                                {"via", ""},
+                                                {"www-authenticate", ""}};
+
+constexpr size_t kStaticTableSize = sizeof(kStaticTable) / sizeof(kStaticTable[0]);
+
+// RFC 7541 Section 4.1: entry size = name_len + value_len + 32
+constexpr size_t kEntryOverhead = 32;
+
+}  // namespace
 
 HpackDecoder::HpackDecoder() {
     // Initialize with default max size
@@ -207,223 +213,243 @@ HpackDecoder::HpackDecoder() {
 
 void HpackDecoder::setMaxDynamicTableSize(size_t size) {
     max_dynamic_table_size_ = size;
-    evictDynamicTable();
+    evictDynamicTable(0);
 }
 
 void HpackDecoder::reset() {
-    dynamic_table_.clear();
+    entry_head_ = 0;
+    entry_count_ = 0;
+    bytes_base_ = 0;
+    bytes_end_ = 0;
     current_dynamic_table_size_ = 0;
 }
 
-std::optional<std::pair<std::string, std::string>> HpackDecoder::getTableEntry(size_t index) {
+bool HpackDecoder::getTableEntry(uint64_t index, StringRef& name, StringRef* value) {
     if (index == 0) {
         LOG_ERROR("HPACK: Invalid table index 0");
-        return std::nullopt;
+        return false;
     }
 
-    // Static table (1 to static_table_.size()-1)
-    if (index < static_table_.size()) {
-        return static_table_[index];
+    // Static table (1 to kStaticTableSize-1)
+    if (index < kStaticTableSize) {
+        name = {kStaticTable[index][0].data(), 0, kStaticTable[index][0].size()};
+        if (value) {
+            *value = {kStaticTable[index][1].data(), 0, kStaticTable[index][1].size()};
+        }
+        return true;
     }
 
     // Dynamic table
-    size_t dynamic_index = index - static_table_.size();
-    if (dynamic_index < dynamic_table_.size()) {
-        return dynamic_table_[dynamic_index];
+    uint64_t dynamic_index = index - kStaticTableSize;
+    if (dynamic_index < entry_count_) {
+        const DynamicEntry& entry =
+            entries_[(entry_head_ + dynamic_index) & (entries_.size() - 1)];
+        name = copyToScratch(entry.offset, entry.name_len);
+        if (value) {
+            *value = copyToScratch(entry.offset + entry.name_len, entry.value_len);
+        }
+        return true;
     }
 
     LOG_ERROR("HPACK: Table index {} out of range", index);
-    return std::nullopt;
+    return false;
 }
 
-void HpackDecoder::addToDynamicTable(const std::string& name, const std::string& value) {
-    size_t entry_size = calculateEntrySize(name, value);
+HpackDecoder::StringRef HpackDecoder::copyToScratch(uint64_t offset, size_t size) {
+    StringRef ref{nullptr, scratch_.size(), size};
+    scratch_.append(bytes_.data() + (offset - bytes_base_), size);
+    return ref;
+}
 
-    // Check if entry is larger than max table size
+void HpackDecoder::addToDynamicTable(std::string_view name, std::string_view value) {
+    size_t entry_size = name.size() + value.size() + kEntryOverhead;
+
+    // An entry larger than the table empties it and is not added
     if (entry_size > max_dynamic_table_size_) {
         LOG_DEBUG("HPACK: Entry size {} exceeds max table size {}", entry_size,
                   max_dynamic_table_size_);
-        dynamic_table_.clear();
-        current_dynamic_table_size_ = 0;
+        evictDynamicTable(SIZE_MAX);
         return;
     }
+    evictDynamicTable(entry_size);
+
+    // Live bytes run from the oldest entry to bytes_end_. If the new entry
+    // does not fit behind them, move them to the front, growing the buffer
+    // when they would fill more than half of it.
+    const size_t needed = name.size() + value.size();
+    if (bytes_end_ - bytes_base_ + needed > bytes_.size()) {
+        const uint64_t live_begin =
+            entry_count_ ? entries_[(entry_head_ + entry_count_ - 1) & (entries_.size() - 1)].offset
+                         : bytes_end_;
+        const size_t live = static_cast<size_t>(bytes_end_ - live_begin);
+        const char* src = bytes_.data() + (live_begin - bytes_base_);
+        if ((live + needed) * 2 > bytes_.size()) {
+            std::vector<char> grown(std::max<size_t>(256, (live + needed) * 2));
+            std::copy(src, src + live, grown.data());
+            bytes_.swap(grown);
+        } else {
+            std::copy(src, src + live, bytes_.data());  // Forward copy to the front
+        }
+        bytes_base_ = live_begin;
+    }
+    char* dst = bytes_.data() + (bytes_end_ - bytes_base_);
+    std::memcpy(dst, name.data(), name.size());
+    std::memcpy(dst + name.size(), value.data(), value.size());
 
-    // Add to front of dynamic table
-    dynamic_table_.push_front({name, value});
+    if (entry_count_ == entries_.size()) {
+        // Grow the descriptor ring, unrolling it newest first
+        std::vector<DynamicEntry> grown(std::max<size_t>(16, entries_.size() * 2));
+        for (size_t i = 0; i < entry_count_; ++i) {
+            grown[i] = entries_[(entry_head_ + i) & (entries_.size() - 1)];
+        }
+        entries_.swap(grown);
+        entry_head_ = 0;
+    }
+    entry_head_ = (entry_head_ + entries_.size() - 1) & (entries_.size() - 1);
+    entries_[entry_head_] = {bytes_end_, static_cast<uint32_t>(name.size()),
+                             static_cast<uint32_t>(value.size())};
+    ++entry_count_;
+    bytes_end_ += needed;
     current_dynamic_table_size_ += entry_size;
-
-    // Evict old entries if needed
-    evictDynamicTable();
-
-    LOG_TRACE("HPACK: Added to dynamic table: {}={} (size={})", name, value, entry_size);
 }
 
-void HpackDecoder::evictDynamicTable() {
-    while (current_dynamic_table_size_ > max_dynamic_table_size_ && !dynamic_table_.empty()) {
-        const auto& entry = dynamic_table_.back();
-        size_t entry_size = calculateEntrySize(entry.first, entry.second);
+void HpackDecoder::evictDynamicTable(size_t incoming) {
+    while (entry_count_ > 0 && (incoming > max_dynamic_table_size_ ||
+                                current_dynamic_table_size_ + incoming > max_dynamic_table_size_)) {
+        const DynamicEntry& oldest =
+            entries_[(entry_head_ + entry_count_ - 1) & (entries_.size() - 1)];
+        size_t entry_size = oldest.name_len + oldest.value_len + kEntryOverhead;
         current_dynamic_table_size_ -= entry_size;
-        dynamic_table_.pop_back();
-        LOG_TRACE("HPACK: Evicted from dynamic table (size={})", entry_size);
+        --entry_count_;
     }
 }
 
-size_t HpackDecoder::calculateEntrySize(const std::string& name, const std::string& value) const {
-    // RFC 7541 Section 4.1: entry size = name_len + value_len + 32
-    return name.length() + value.length() + 32;
-}
-
-uint64_t HpackDecoder::decodeInteger(const uint8_t*& data, const uint8_t* end,
-                                     uint8_t prefix_bits) {
+bool HpackDecoder::decodeInteger(const uint8_t*& data, const uint8_t* end, uint8_t prefix_bits,
+                                 uint64_t& value) {
     if (data >= end) {
-        return 0;
+        return false;
     }
 
-    uint8_t prefix_mask = (1 << prefix_bits) - 1;
-    uint64_t value = (*data) & prefix_mask;
+    uint8_t prefix_mask = static_cast<uint8_t>((1 << prefix_bits) - 1);
+    value = (*data) & prefix_mask;
     data++;
 
     if (value < prefix_mask) {
-        return value;
+        return true;
     }
 
     // Multi-byte integer
-    uint8_t m = 0;
-    while (data < end) {
+    for (uint8_t m = 0; data < end; m += 7) {
+        if (m > 56) {
+            LOG_ERROR("HPACK: Integer too large");
+            return false;
+        }
         uint8_t byte = *data++;
-        value += (byte & 0x7F) * (1ULL << m);
-        m += 7;
-
+        value += static_cast<uint64_t>(byte & 0x7F) << m;
         if ((byte & 0x80) == 0) {
-            break;
-        }
-
-        if (m > 63) {
-            LOG_ERROR("HPACK: Integer too large");
-            return 0;
+            return true;
         }
     }
 
-    return value;
+    LOG_ERROR("HPACK: Truncated integer");
+    return false;
 }
 
-std::string HpackDecoder::decodeString(const uint8_t*& data, const uint8_t* end) {
+bool HpackDecoder::decodeString(const uint8_t*& data, const uint8_t* end, StringRef& out) {
     if (data >= end) {
-        return "";
+        LOG_ERROR("HPACK: Missing string");
+        return false;
     }
 
     bool huffman = ((*data) & 0x80) != 0;
-    uint64_t length = decodeInteger(data, end, 7);
+    uint64_t length = 0;
+    if (!decodeInteger(data, end, 7, length)) {
+        return false;
+    }
 
-    if (data + length > end) {
+    if (length > static_cast<uint64_t>(end - data)) {
         LOG_ERROR("HPACK: String length {} exceeds available data", length);
-        return "";
+        return false;
     }
 
-    std::string result;
     if (huffman) {
-        result = decodeHuffman(data, length);
+        out = {nullptr, scratch_.size(), 0};
+        if (!HpackHuffman::decode(data, length, scratch_)) {
+            LOG_ERROR("HPACK: Invalid Huffman-encoded string");
+            return false;
+        }
+        out.size = scratch_.size() - out.offset;
     } else {
-        result = std::string(reinterpret_cast<const char*>(data), length);
+        out = {reinterpret_cast<const char*>(data), 0, length};
     }
 
     data += length;
-    return result;
-}
-
-std::string HpackDecoder::decodeHuffman(const uint8_t* data, size_t len) {
-    // Simplified Huffman decoder - in production, use full Huffman table
-    // For now, return raw string (assumes non-Huffman encoding)
-    LOG_DEBUG("HPACK: Huffman decoding not fully implemented, returning raw string");
-    return std::string(reinterpret_cast<const char*>(data), len);
+    return true;
 }
 
 std::vector<HpackDecoder::DecodedHeader> HpackDecoder::decode(const uint8_t* data, size_t len) {
+    decode(data, len, owned_fields_);
     std::vector<DecodedHeader> headers;
+    headers.reserve(owned_fields_.size());
+    for (const auto& field : owned_fields_) {
+        headers.push_back({std::string(field.name), std::string(field.value)});
+    }
+    return headers;
+}
+
+bool HpackDecoder::decode(const uint8_t* data, size_t len, std::vector<HeaderField>& fields) {
+    scratch_.clear();
+    pending_.clear();
     const uint8_t* ptr = data;
     const uint8_t* end = data + len;
+    bool ok = true;
 
-    while (ptr < end) {
+    while (ptr < end && ok) {
         uint8_t first_byte = *ptr;
+        uint64_t index = 0;
+        StringRef name;
+        StringRef value;
 
         // Indexed Header Field (pattern: 1xxxxxxx)
         if ((first_byte & 0x80) != 0) {
-            uint64_t index = decodeInteger(ptr, end, 7);
-            auto entry = getTableEntry(index);
-            if (entry) {
-                headers.push_back({entry->first, entry->second});
-                LOG_TRACE("HPACK: Indexed header [{}]: {}={}", index, entry->first, entry->second);
+            ok = decodeInteger(ptr, end, 7, index) && getTableEntry(index, name, &value);
+            if (ok) {
+                pending_.emplace_back(name, value);
             }
         }
-        // Literal Header Field with Incremental Indexing (pattern: 01xxxxxx)
-        else if ((first_byte & 0xC0) == 0x40) {
-            uint64_t index = decodeInteger(ptr, end, 6);
-            std::string name;
-
-            if (index == 0) {
-                // New name
-                name = decodeString(ptr, end);
-            } else {
-                // Name from table
-                auto entry = getTableEntry(index);
-                if (entry) {
-                    name = entry->first;
-                }
-            }
-
-            std::string value = decodeString(ptr, end);
-            headers.push_back({name, value});
-            addToDynamicTable(name, value);
-            LOG_TRACE("HPACK: Literal with indexing: {}={}", name, value);
-        }
-        // Literal Header Field without Indexing (pattern: 0000xxxx)
-        else if ((first_byte & 0xF0) == 0x00) {
-            uint64_t index = decodeInteger(ptr, end, 4);
-            std::string name;
-
-            if (index == 0) {
-                name = decodeString(ptr, end);
-            } else {
-                auto entry = getTableEntry(index);
-                if (entry) {
-                    name = entry->first;
-                }
+        // Dynamic Table Size Update (pattern: 001xxxxx)
+        else if ((first_byte & 0xE0) == 0x20) {
+            uint64_t max_size = 0;
+            ok = decodeInteger(ptr, end, 5, max_size);
+            if (ok) {
+                setMaxDynamicTableSize(max_size);
+                LOG_DEBUG("HPACK: Dynamic table size update: {}", max_size);
             }
-
-            std::string value = decodeString(ptr, end);
-            headers.push_back({name, value});
-            LOG_TRACE("HPACK: Literal without indexing: {}={}", name, value);
         }
-        // Literal Header Field Never Indexed (pattern: 0001xxxx)
-        else if ((first_byte & 0xF0) == 0x10) {
-            uint64_t index = decodeInteger(ptr, end, 4);
-            std::string name;
-
-            if (index == 0) {
-                name = decodeString(ptr, end);
-            } else {
-                auto entry = getTableEntry(index);
-                if (entry) {
-                    name = entry->first;
+        // Literal Header Field with Incremental Indexing (pattern: 01xxxxxx),
+        // without Indexing (pattern: 0000xxxx) or Never Indexed (pattern: 0001xxxx)
+        else {
+            const bool indexing = (first_byte & 0xC0) == 0x40;
+            ok = decodeInteger(ptr, end, indexing ? 6 : 4, index) &&
+                 (index == 0 ? decodeString(ptr, end, name)
+                             : getTableEntry(index, name, nullptr)) &&
+                 decodeString(ptr, end, value);
+            if (ok) {
+                pending_.emplace_back(name, value);
+                if (indexing) {
+                    addToDynamicTable(view(name), view(value));
                 }
             }
-
-            std::string value = decodeString(ptr, end);
-            headers.push_back({name, value});
-            LOG_TRACE("HPACK: Literal never indexed: {}={}", name, value);
-        }
-        // Dynamic Table Size Update (pattern: 001xxxxx)
-        else if ((first_byte & 0xE0) == 0x20) {
-            uint64_t max_size = decodeInteger(ptr, end, 5);
-            setMaxDynamicTableSize(max_size);
-            LOG_DEBUG("HPACK: Dynamic table size update: {}", max_size);
-        } else {
-            LOG_ERROR("HPACK: Unknown header encoding: 0x{:02x}", first_byte);
-            break;
         }
     }
 
-    return headers;
+    // scratch_ no longer grows: resolve the references into views
+    fields.clear();
+    fields.reserve(pending_.size());
+    for (const auto& [name, value] : pending_) {
+        fields.push_back({view(name), view(value)});
+    }
+    return ok;
 }
 
 // ============================================================================
@@ -596,14 +622,16 @@ bool Http2Parser::processHeadersFrame(const Http2Frame& frame, Http2Connection&
     // Decode header block
     if (header_block_offset < frame.payload.size()) {
         size_t header_block_len = frame.payload.size() - header_block_offset - padding_length;
-        auto headers =
-            hpack_decoder_.decode(frame.payload.data() + header_block_offset, header_block_len);
+        if (!hpack_decoder_.decode(frame.payload.data() + header_block_offset, header_block_len,
+                                   header_fields_)) {
+            LOG_WARN("HTTP/2: Malformed header block on stream {}", stream.stream_id);
+        }
 
         // Determine interaction phase based on headers
         bool is_request = false;
         bool is_response = false;
 
-        for (const auto& header : headers) {
+        for (const auto& header : header_fields_) {
             if (header.name == ":method")
                 is_request = true;
             if (header.name == ":status")
@@ -617,7 +645,7 @@ bool Http2Parser::processHeadersFrame(const Http2Frame& frame, Http2Connection&
         }
 
         // Process decoded headers
-        for (const auto& header : headers) {
+        for (const auto& header : header_fields_) {
             // Update semantic fields
             if (header.name == ":method") {
                 stream.method = header.value;
@@ -628,18 +656,17 @@ bool Http2Parser::processHeadersFrame(const Http2Frame& frame, Http2Connection&
             } else if (header.name == ":scheme") {
                 stream.scheme = header.value;
             } else if (header.name == ":status") {
-                stream.status_code = std::stoi(header.value);
+                std::from_chars(header.value.data(), header.value.data() + header.value.size(),
+                                stream.status_code);
             }
 
             // Store in appropriate map
             // Note: If we received a request earlier, and now getting response headers, status_code
             // logic handles it. But here we rely on the specific flags found in *this* header
             // block.
-            if (is_response || stream.status_code > 0) {
-                stream.response_headers[header.name] = header.value;
-            } else {
-                stream.request_headers[header.name] = header.value;
-            }
+            auto& headers = (is_response || stream.status_code > 0) ? stream.response_headers
+                                                                    : stream.request_headers;
+            headers[std::string(header.name)] = header.value;
         }
     }
 
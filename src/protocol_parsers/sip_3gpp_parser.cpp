@@ -1,16 +1,30 @@
 #include "protocol_parsers/sip_3gpp_headers.h"
+#include "protocol_parsers/sip_tokenizer.h"
 #include "common/logger.h"
-#include <algorithm>
 #include <cctype>
-#include <sstream>
 
 namespace callflow {
 
+namespace {
+
+// Split a "key=value" parameter into its trimmed parts; false without '='
+bool splitParameter(std::string_view param, std::string_view& key, std::string_view& val) {
+    size_t eq = param.find('=');
+    if (eq == std::string_view::npos) {
+        return false;
+    }
+    key = sip::trim(param.substr(0, eq));
+    val = sip::trim(param.substr(eq + 1));
+    return true;
+}
+
+}  // namespace
+
 // ============================================================================
 // P-Asserted-Identity parsing
 // ============================================================================
 
-std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(const std::string& value) {
+std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(std::string_view value) {
     std::vector<SipPAssertedIdentity> identities;
 
     // P-Asserted-Identity can have multiple identities separated by commas
@@ -31,7 +45,7 @@ std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(con
         if (value[pos] == '"') {
             pos++;
             size_t end_quote = value.find('"', pos);
-            if (end_quote != std::string::npos) {
+            if (end_quote != std::string_view::npos) {
                 identity.display_name = value.substr(pos, end_quote - pos);
                 pos = end_quote + 1;
             }
@@ -39,10 +53,10 @@ std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(con
 
         // Find URI in angle brackets
         size_t uri_start = value.find('<', pos);
-        if (uri_start == std::string::npos) break;
+        if (uri_start == std::string_view::npos) break;
 
         size_t uri_end = value.find('>', uri_start);
-        if (uri_end == std::string::npos) break;
+        if (uri_end == std::string_view::npos) break;
 
         identity.uri = value.substr(uri_start + 1, uri_end - uri_start - 1);
         identities.push_back(identity);
@@ -51,7 +65,7 @@ std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(con
 
         // Skip comma if present
         size_t comma = value.find(',', pos);
-        if (comma != std::string::npos) {
+        if (comma != std::string_view::npos) {
             pos = comma + 1;
         } else {
             break;
@@ -65,19 +79,14 @@ std::optional<std::vector<SipPAssertedIdentity>> SipPAssertedIdentity::parse(con
 // P-Access-Network-Info parsing
 // ============================================================================
 
-std::optional<SipPAccessNetworkInfo> SipPAccessNetworkInfo::parse(const std::string& value) {
+std::optional<SipPAccessNetworkInfo> SipPAccessNetworkInfo::parse(std::string_view value) {
     SipPAccessNetworkInfo info;
 
     // Format: 3GPP-E-UTRAN-FDD; utran-cell-id-3gpp=234150999999999
     // Format: 3GPP-NR; nrcgi=001010000000001
 
-    std::istringstream iss(value);
-    std::string access_str;
-    std::getline(iss, access_str, ';');
-
-    // Trim
-    access_str.erase(0, access_str.find_first_not_of(" \t"));
-    access_str.erase(access_str.find_last_not_of(" \t") + 1);
+    std::string_view rest = value;
+    std::string_view access_str = sip::trim(sip::splitNext(rest, ';'));
 
     // Parse access type
     if (access_str == "3GPP-E-UTRAN-FDD") {
@@ -99,25 +108,15 @@ std::optional<SipPAccessNetworkInfo> SipPAccessNetworkInfo::parse(const std::str
     }
 
     // Parse parameters
-    std::string param;
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
-
+    std::string_view key, val;
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
             // Store cell ID
             if (key == "utran-cell-id-3gpp" || key == "nrcgi" || key == "cgi-3gpp") {
-                info.cell_id = val;
+                info.cell_id = std::string(val);
             }
 
-            info.parameters[key] = val;
+            info.parameters.insert_or_assign(std::string(key), std::string(val));
         }
     }
 
@@ -141,34 +140,24 @@ std::string SipPAccessNetworkInfo::accessTypeToString(AccessType type) {
 // P-Charging-Vector parsing
 // ============================================================================
 
-std::optional<SipPChargingVector> SipPChargingVector::parse(const std::string& value) {
+std::optional<SipPChargingVector> SipPChargingVector::parse(std::string_view value) {
     SipPChargingVector charging;
 
     // Format: icid-value=1234567890; icid-generated-at=192.0.2.1; orig-ioi=home1.net; term-ioi=home2.net
 
-    std::istringstream iss(value);
-    std::string param;
-
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
+    std::string_view rest = value;
+    std::string_view key, val;
 
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
             if (key == "icid-value") {
                 charging.icid_value = val;
             } else if (key == "icid-generated-at") {
-                charging.icid_generated_at = val;
+                charging.icid_generated_at = std::string(val);
             } else if (key == "orig-ioi") {
-                charging.orig_ioi = val;
+                charging.orig_ioi = std::string(val);
             } else if (key == "term-ioi") {
-                charging.term_ioi = val;
+                charging.term_ioi = std::string(val);
             }
         }
     }
@@ -186,30 +175,20 @@ std::optional<SipPChargingVector> SipPChargingVector::parse(const std::string& v
 // ============================================================================
 
 std::optional<SipPChargingFunctionAddresses> SipPChargingFunctionAddresses::parse(
-    const std::string& value) {
+    std::string_view value) {
     SipPChargingFunctionAddresses addresses;
 
     // Format: ccf=192.0.2.10; ccf=192.0.2.11; ecf=192.0.2.20
 
-    std::istringstream iss(value);
-    std::string param;
-
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
+    std::string_view rest = value;
+    std::string_view key, val;
 
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
             if (key == "ccf") {
-                addresses.ccf_addresses.push_back(val);
+                addresses.ccf_addresses.emplace_back(val);
             } else if (key == "ecf") {
-                addresses.ecf_addresses.push_back(val);
+                addresses.ecf_addresses.emplace_back(val);
             }
         }
     }
@@ -225,7 +204,7 @@ std::optional<SipPChargingFunctionAddresses> SipPChargingFunctionAddresses::pars
 // P-Served-User parsing
 // ============================================================================
 
-std::optional<SipPServedUser> SipPServedUser::parse(const std::string& value) {
+std::optional<SipPServedUser> SipPServedUser::parse(std::string_view value) {
     SipPServedUser served_user;
 
     // Format: <sip:user@example.com>; sescase=orig; regstate=reg
@@ -233,40 +212,22 @@ std::optional<SipPServedUser> SipPServedUser::parse(const std::string& value) {
     // Extract URI
     size_t uri_start = value.find('<');
     size_t uri_end = value.find('>');
-    if (uri_start != std::string::npos && uri_end != std::string::npos) {
+    if (uri_start != std::string_view::npos && uri_end != std::string_view::npos) {
         served_user.user_uri = value.substr(uri_start + 1, uri_end - uri_start - 1);
     } else {
         // No angle brackets, take up to first semicolon
-        size_t semi = value.find(';');
-        if (semi != std::string::npos) {
-            served_user.user_uri = value.substr(0, semi);
-        } else {
-            served_user.user_uri = value;
-        }
-        // Trim
-        served_user.user_uri.erase(0, served_user.user_uri.find_first_not_of(" \t"));
-        served_user.user_uri.erase(served_user.user_uri.find_last_not_of(" \t") + 1);
+        served_user.user_uri = sip::trim(value.substr(0, value.find(';')));
     }
 
     // Parse parameters
-    std::istringstream iss(value);
-    std::string param;
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
-
+    std::string_view rest = value;
+    std::string_view key, val;
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
             if (key == "sescase") {
-                served_user.sescase = val;
+                served_user.sescase = std::string(val);
             } else if (key == "regstate") {
-                served_user.regstate = val;
+                served_user.regstate = std::string(val);
             }
         }
     }
@@ -278,59 +239,42 @@ std::optional<SipPServedUser> SipPServedUser::parse(const std::string& value) {
 // Security-Client/Server/Verify parsing
 // ============================================================================
 
-std::optional<SipSecurityInfo> SipSecurityInfo::parse(const std::string& value) {
+std::optional<SipSecurityInfo> SipSecurityInfo::parse(std::string_view value) {
     SipSecurityInfo security;
 
     // Format: ipsec-3gpp; alg=hmac-sha-1-96; spi-c=1234; spi-s=5678; port-c=5062; port-s=5064
 
-    std::istringstream iss(value);
-    std::string token;
+    std::string_view rest = value;
 
     // First token is the mechanism
-    std::getline(iss, token, ';');
-    token.erase(0, token.find_first_not_of(" \t"));
-    token.erase(token.find_last_not_of(" \t") + 1);
-    security.mechanism = token;
+    security.mechanism = sip::trim(sip::splitNext(rest, ';'));
 
     // Parse remaining parameters
-    std::string param;
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
-
+    std::string_view key, val;
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
+            uint32_t number = 0;
             if (key == "alg" || key == "algorithm") {
-                security.algorithm = val;
+                security.algorithm = std::string(val);
             } else if (key == "spi-c") {
-                try {
-                    security.spi_c = std::stoul(val);
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    security.spi_c = number;
                 }
             } else if (key == "spi-s") {
-                try {
-                    security.spi_s = std::stoul(val);
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    security.spi_s = number;
                 }
             } else if (key == "port-c") {
-                try {
-                    security.port_c = static_cast<uint16_t>(std::stoul(val));
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    security.port_c = static_cast<uint16_t>(number);
                 }
             } else if (key == "port-s") {
-                try {
-                    security.port_s = static_cast<uint16_t>(std::stoul(val));
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    security.port_s = static_cast<uint16_t>(number);
                 }
             }
 
-            security.parameters[key] = val;
+            security.parameters.insert_or_assign(std::string(key), std::string(val));
         }
     }
 
@@ -341,20 +285,19 @@ std::optional<SipSecurityInfo> SipSecurityInfo::parse(const std::string& value)
 // Session-Expires parsing
 // ============================================================================
 
-std::optional<SipSessionExpires> SipSessionExpires::parse(const std::string& value) {
+std::optional<SipSessionExpires> SipSessionExpires::parse(std::string_view value) {
     SipSessionExpires session_expires;
 
     // Format: 1800; refresher=uac
 
-    std::istringstream iss(value);
-    if (!(iss >> session_expires.expires)) {
+    if (!sip::parseUint(value, session_expires.expires)) {
         return std::nullopt;
     }
 
     // Check for refresher parameter
     size_t refresher_pos = value.find("refresher=");
-    if (refresher_pos != std::string::npos) {
-        session_expires.refresher = value.substr(refresher_pos + 10, 3);
+    if (refresher_pos != std::string_view::npos) {
+        session_expires.refresher = std::string(value.substr(refresher_pos + 10, 3));
     }
 
     return session_expires;
@@ -364,15 +307,17 @@ std::optional<SipSessionExpires> SipSessionExpires::parse(const std::string& val
 // SDP QoS Precondition parsing
 // ============================================================================
 
-std::optional<SipSdpQosPrecondition> SipSdpQosPrecondition::parseCurrent(const std::string& value) {
+std::optional<SipSdpQosPrecondition> SipSdpQosPrecondition::parseCurrent(std::string_view value) {
     // Format: a=curr:qos local sendrecv
     SipSdpQosPrecondition precondition;
     precondition.strength = Strength::NONE;
 
-    std::istringstream iss(value);
-    std::string qos_str, direction_str, status_str;
+    std::string_view rest = value;
+    std::string_view qos_str = sip::nextWord(rest);
+    std::string_view direction_str = sip::nextWord(rest);
+    std::string_view status_str = sip::nextWord(rest);
 
-    if (!(iss >> qos_str >> direction_str >> status_str)) {
+    if (qos_str.empty() || direction_str.empty() || status_str.empty()) {
         return std::nullopt;
     }
 
@@ -401,14 +346,17 @@ std::optional<SipSdpQosPrecondition> SipSdpQosPrecondition::parseCurrent(const s
     return precondition;
 }
 
-std::optional<SipSdpQosPrecondition> SipSdpQosPrecondition::parseDesired(const std::string& value) {
+std::optional<SipSdpQosPrecondition> SipSdpQosPrecondition::parseDesired(std::string_view value) {
     // Format: a=des:qos mandatory local sendrecv
     SipSdpQosPrecondition precondition;
 
-    std::istringstream iss(value);
-    std::string qos_str, strength_str, direction_str, status_str;
+    std::string_view rest = value;
+    std::string_view qos_str = sip::nextWord(rest);
+    std::string_view strength_str = sip::nextWord(rest);
+    std::string_view direction_str = sip::nextWord(rest);
+    std::string_view status_str = sip::nextWord(rest);
 
-    if (!(iss >> qos_str >> strength_str >> direction_str >> status_str)) {
+    if (qos_str.empty() || strength_str.empty() || direction_str.empty() || status_str.empty()) {
         return std::nullopt;
     }
 
@@ -482,33 +430,32 @@ std::string SipSdpQosPrecondition::statusToString(Status s) {
 // SDP Bandwidth parsing
 // ============================================================================
 
-void SipSdpBandwidth::parseLine(const std::string& line, SipSdpBandwidth& bandwidth) {
+void SipSdpBandwidth::parseLine(std::string_view line, SipSdpBandwidth& bandwidth) {
     // Format: b=AS:64 or b=TIAS:64000
     if (line.length() < 4 || line[0] != 'b' || line[1] != '=') {
         return;
     }
 
-    std::string value = line.substr(2);
+    std::string_view value = line.substr(2);
     size_t colon = value.find(':');
-    if (colon == std::string::npos) {
+    if (colon == std::string_view::npos) {
         return;
     }
 
-    std::string type = value.substr(0, colon);
-    std::string bw_str = value.substr(colon + 1);
+    std::string_view type = value.substr(0, colon);
+    uint32_t bw = 0;
+    if (!sip::parseUint(value.substr(colon + 1), bw)) {
+        return;
+    }
 
-    try {
-        uint32_t bw = std::stoul(bw_str);
-        if (type == "AS") {
-            bandwidth.as = bw;
-        } else if (type == "TIAS") {
-            bandwidth.tias = bw;
-        } else if (type == "RS") {
-            bandwidth.rs = bw;
-        } else if (type == "RR") {
-            bandwidth.rr = bw;
-        }
-    } catch (...) {
+    if (type == "AS") {
+        bandwidth.as = bw;
+    } else if (type == "TIAS") {
+        bandwidth.tias = bw;
+    } else if (type == "RS") {
+        bandwidth.rs = bw;
+    } else if (type == "RR") {
+        bandwidth.rr = bw;
     }
 }
 
@@ -516,79 +463,54 @@ void SipSdpBandwidth::parseLine(const std::string& line, SipSdpBandwidth& bandwi
 // SDP Codec parsing
 // ============================================================================
 
-std::optional<SipSdpCodec> SipSdpCodec::parseRtpmap(const std::string& value) {
+std::optional<SipSdpCodec> SipSdpCodec::parseRtpmap(std::string_view value) {
     // Format: a=rtpmap:97 AMR/8000/1
     SipSdpCodec codec;
+    codec.clock_rate = 0;
 
-    std::istringstream iss(value);
-    std::string pt_str;
-    std::getline(iss, pt_str, ' ');
-
-    try {
-        codec.payload_type = static_cast<uint8_t>(std::stoul(pt_str));
-    } catch (...) {
+    std::string_view encoding_info = value;
+    uint32_t pt = 0;
+    if (!sip::parseUint(sip::splitNext(encoding_info, ' '), pt)) {
         return std::nullopt;
     }
-
-    std::string encoding_info;
-    std::getline(iss, encoding_info);
+    codec.payload_type = static_cast<uint8_t>(pt);
 
     // Parse encoding_name/clock_rate/channels
-    std::istringstream encoding_iss(encoding_info);
-    std::string part;
+    uint32_t number = 0;
 
     // Encoding name
-    if (std::getline(encoding_iss, part, '/')) {
-        codec.encoding_name = part;
+    if (!encoding_info.empty()) {
+        codec.encoding_name = sip::splitNext(encoding_info, '/');
     }
 
     // Clock rate
-    if (std::getline(encoding_iss, part, '/')) {
-        try {
-            codec.clock_rate = std::stoul(part);
-        } catch (...) {
-            codec.clock_rate = 0;
-        }
+    if (!encoding_info.empty() && sip::parseUint(sip::splitNext(encoding_info, '/'), number)) {
+        codec.clock_rate = number;
     }
 
     // Channels (optional)
-    if (std::getline(encoding_iss, part, '/')) {
-        try {
-            codec.channels = std::stoul(part);
-        } catch (...) {
-        }
+    if (!encoding_info.empty() && sip::parseUint(sip::splitNext(encoding_info, '/'), number)) {
+        codec.channels = number;
     }
 
     return codec;
 }
 
-void SipSdpCodec::parseFmtp(const std::string& value) {
+void SipSdpCodec::parseFmtp(std::string_view value) {
     // Format: a=fmtp:97 mode-set=0,2,4,7; mode-change-period=2
 
     // Skip payload type
     size_t space = value.find(' ');
-    if (space == std::string::npos) {
+    if (space == std::string_view::npos) {
         return;
     }
 
-    std::string params = value.substr(space + 1);
-
     // Parse semicolon-separated parameters
-    std::istringstream iss(params);
-    std::string param;
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
-
-            format_parameters[key] = val;
+    std::string_view rest = value.substr(space + 1);
+    std::string_view key, val;
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
+            format_parameters.insert_or_assign(std::string(key), std::string(val));
         }
     }
 }
@@ -597,21 +519,16 @@ void SipSdpCodec::parseFmtp(const std::string& value) {
 // Privacy parsing
 // ============================================================================
 
-SipPrivacy SipPrivacy::parse(const std::string& value) {
+SipPrivacy SipPrivacy::parse(std::string_view value) {
     SipPrivacy privacy{};
 
-    // Convert to lowercase for comparison
-    std::string lower_value = value;
-    std::transform(lower_value.begin(), lower_value.end(), lower_value.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-
-    // Check for each privacy type
-    privacy.id = lower_value.find("id") != std::string::npos;
-    privacy.header = lower_value.find("header") != std::string::npos;
-    privacy.session = lower_value.find("session") != std::string::npos;
-    privacy.user = lower_value.find("user") != std::string::npos;
-    privacy.none = lower_value.find("none") != std::string::npos;
-    privacy.critical = lower_value.find("critical") != std::string::npos;
+    // Check for each privacy type (case-insensitive)
+    privacy.id = sip::containsNoCase(value, "id");
+    privacy.header = sip::containsNoCase(value, "header");
+    privacy.session = sip::containsNoCase(value, "session");
+    privacy.user = sip::containsNoCase(value, "user");
+    privacy.none = sip::containsNoCase(value, "none");
+    privacy.critical = sip::containsNoCase(value, "critical");
 
     return privacy;
 }
@@ -620,18 +537,13 @@ SipPrivacy SipPrivacy::parse(const std::string& value) {
 // Subscription-State parsing
 // ============================================================================
 
-std::optional<SipSubscriptionState> SipSubscriptionState::parse(const std::string& value) {
+std::optional<SipSubscriptionState> SipSubscriptionState::parse(std::string_view value) {
     SipSubscriptionState sub_state;
 
     // Format: active;expires=3600 or terminated;reason=timeout
 
-    std::istringstream iss(value);
-    std::string state_str;
-    std::getline(iss, state_str, ';');
-
-    // Trim
-    state_str.erase(0, state_str.find_first_not_of(" \t"));
-    state_str.erase(state_str.find_last_not_of(" \t") + 1);
+    std::string_view rest = value;
+    std::string_view state_str = sip::trim(sip::splitNext(rest, ';'));
 
     // Parse state
     if (state_str == "active") {
@@ -645,30 +557,19 @@ std::optional<SipSubscriptionState> SipSubscriptionState::parse(const std::strin
     }
 
     // Parse parameters
-    std::string param;
-    while (std::getline(iss, param, ';')) {
-        size_t eq = param.find('=');
-        if (eq != std::string::npos) {
-            std::string key = param.substr(0, eq);
-            std::string val = param.substr(eq + 1);
-
-            // Trim
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            val.erase(0, val.find_first_not_of(" \t"));
-            val.erase(val.find_last_not_of(" \t") + 1);
-
+    std::string_view key, val;
+    while (!rest.empty()) {
+        if (splitParameter(sip::splitNext(rest, ';'), key, val)) {
+            uint32_t number = 0;
             if (key == "expires") {
-                try {
-                    sub_state.expires = std::stoul(val);
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    sub_state.expires = number;
                 }
             } else if (key == "reason") {
-                sub_state.reason = val;
+                sub_state.reason = std::string(val);
             } else if (key == "retry-after") {
-                try {
-                    sub_state.retry_after = std::stoul(val);
-                } catch (...) {
+                if (sip::parseUint(val, number)) {
+                    sub_state.retry_after = number;
                 }
             }
         }
@@ -3,8 +3,6 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
-#include <map>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -15,20 +13,6 @@
 
 namespace callflow {
 
-// Helper to extract parameters from headers
-static std::string extractParameter(const std::string& header, const std::string& param) {
-    size_t pos = header.find(param + "=");
-    if (pos == std::string::npos)
-        return "";
-
-    pos += param.length() + 1;
-    size_t end = header.find_first_of("; \r\n", pos);
-    if (end == std::string::npos)
-        end = header.length();
-
-    return header.substr(pos, end - pos);
-}
-
 std::string SipMessage::getDialogId() const {
     if (call_id.empty() || from_tag.empty())
         return "";
@@ -443,57 +427,39 @@ std::optional<SipMessage> SipParser::parse(const uint8_t* data, size_t len) {
         return std::nullopt;
     }
 
-    // Convert to string
-    std::string text(reinterpret_cast<const char*>(data), len);
+    sip::MessageTokenizer tokenizer(std::string_view(reinterpret_cast<const char*>(data), len));
 
-    // Split into lines
-    auto lines = splitLines(text);
-    if (lines.empty()) {
+    // Parse first line (request or status)
+    sip::StartLine start;
+    if (!tokenizer.startLine(start)) {
+        LOG_DEBUG("Not a valid SIP message");
         return std::nullopt;
     }
 
     SipMessage msg;
-
-    // Parse first line (request or status)
-    const std::string& first_line = lines[0];
-    if (first_line.find("SIP/2.0") == 0) {
-        // Status line (response)
-        if (!parseStatusLine(first_line, msg)) {
-            return std::nullopt;
-        }
-        msg.is_request = false;
-    } else if (first_line.find("SIP/2.0") != std::string::npos) {
-        // Request line
-        if (!parseRequestLine(first_line, msg)) {
-            return std::nullopt;
-        }
-        msg.is_request = true;
+    msg.is_request = start.is_request;
+    if (start.is_request) {
+        msg.method = start.method;
+        msg.request_uri = start.request_uri;
     } else {
-        LOG_DEBUG("Not a valid SIP message: " << first_line);
-        return std::nullopt;
+        msg.status_code = start.status_code;
+        msg.reason_phrase = start.reason;
     }
 
-    // Find empty line separating headers from body
-    size_t body_start = 0;
-    for (size_t i = 1; i < lines.size(); ++i) {
-        if (lines[i].empty() || lines[i] == "\r") {
-            body_start = i + 1;
-            break;
-        }
+    // Parse headers up to the empty line separating them from the body
+    sip::HeaderField field;
+    while (tokenizer.nextHeader(field)) {
+        parseHeader(field, msg);
     }
 
-    // Parse headers
-    std::vector<std::string> header_lines(
-        lines.begin() + 1, body_start > 0 ? lines.begin() + body_start : lines.end());
-    parseHeaders(header_lines, msg);
+    // Tags and branch
+    msg.from_tag = sip::headerParameter(msg.from, "tag");
+    msg.to_tag = sip::headerParameter(msg.to, "tag");
+    msg.via_branch = sip::headerParameter(msg.via, "branch");
 
     // Parse body if present
-    if (body_start > 0 && body_start < lines.size()) {
-        std::ostringstream body_stream;
-        for (size_t i = body_start; i < lines.size(); ++i) {
-            body_stream << lines[i] << "\n";
-        }
-        msg.body = body_stream.str();
+    if (tokenizer.hasBody()) {
+        msg.body = sip::normalizeLineEndings(tokenizer.body());
 
         // Parse SDP if Content-Type is application/sdp
         if (msg.content_type.find("application/sdp") != std::string::npos) {
@@ -501,18 +467,6 @@ std::optional<SipMessage> SipParser::parse(const uint8_t* data, size_t len) {
         }
     }
 
-    // NEW: Parse 3GPP P-headers
-    parsePHeaders(msg);
-
-    // NEW: Parse IMS-specific headers
-    parseImsHeaders(msg);
-
-    // NEW: Parse security headers
-    parseSecurityHeaders(msg);
-
-    // NEW: Parse routing headers
-    parseRoutingHeaders(msg);
-
     return msg;
 }
 
@@ -562,34 +516,20 @@ std::optional<std::string> SipParser::extractCallId(const uint8_t* data, size_t
         return std::nullopt;
     }
 
-    std::string text(reinterpret_cast<const char*>(data), len);
-
-    // Look for Call-ID header
-    size_t pos = text.find("Call-ID:");
-    if (pos == std::string::npos) {
-        pos = text.find("i:");  // Compact form
-    }
-
-    if (pos == std::string::npos) {
+    sip::MessageTokenizer tokenizer(std::string_view(reinterpret_cast<const char*>(data), len));
+    sip::StartLine start;
+    if (!tokenizer.startLine(start)) {
         return std::nullopt;
     }
 
-    // Find end of line
-    size_t eol = text.find('\n', pos);
-    if (eol == std::string::npos) {
-        eol = text.length();
-    }
-
-    std::string line = text.substr(pos, eol - pos);
-
-    // Extract value after colon
-    size_t colon = line.find(':');
-    if (colon == std::string::npos) {
-        return std::nullopt;
+    // Call-ID or its compact form "i"
+    sip::HeaderField field;
+    while (tokenizer.nextHeader(field)) {
+        if (field.id == sip::HeaderId::CALL_ID) {
+            return std::string(field.value);
+        }
     }
-
-    std::string call_id = line.substr(colon + 1);
-    return trim(call_id);
+    return std::nullopt;
 }
 
 MessageType SipParser::getMessageType(const SipMessage& msg) {
@@ -634,484 +574,301 @@ MessageType SipParser::getMessageType(const SipMessage& msg) {
     return MessageType::UNKNOWN;
 }
 
-bool SipParser::parseRequestLine(const std::string& line, SipMessage& msg) {
-    // Format: METHOD request-URI SIP/2.0
-    std::istringstream iss(line);
-    std::string sip_version;
+namespace {
 
-    if (!(iss >> msg.method >> msg.request_uri >> sip_version)) {
-        return false;
+void appendCommaList(std::string_view value, std::vector<std::string>& out) {
+    while (!value.empty()) {
+        std::string_view item = sip::trim(sip::splitNext(value, ','));
+        if (!item.empty()) {
+            out.emplace_back(item);
+        }
     }
-
-    return sip_version == "SIP/2.0";
 }
 
-bool SipParser::parseStatusLine(const std::string& line, SipMessage& msg) {
-    // Format: SIP/2.0 status-code reason-phrase
-    std::istringstream iss(line);
-    std::string sip_version;
+}  // namespace
 
-    if (!(iss >> sip_version >> msg.status_code)) {
-        return false;
+void SipParser::parseHeader(const sip::HeaderField& field, SipMessage& msg) {
+    // Folded values are the only ones that need a copy before parsing
+    std::string unfolded;
+    std::string_view value = field.value;
+    if (field.folded) {
+        unfolded = sip::unfold(field.value);
+        value = unfolded;
     }
 
-    // Read rest of line as reason phrase
-    std::getline(iss, msg.reason_phrase);
-    msg.reason_phrase = trim(msg.reason_phrase);
-
-    return sip_version == "SIP/2.0";
-}
-
-void SipParser::parseHeaders(const std::vector<std::string>& lines, SipMessage& msg) {
-    for (const auto& line : lines) {
-        if (line.empty())
-            continue;
-
-        auto [name, value] = parseHeader(line);
-
-        // Store common headers
-        if (name == "Call-ID" || name == "i") {
+    switch (field.id) {
+        case sip::HeaderId::CALL_ID:
             msg.call_id = value;
-        } else if (name == "From" || name == "f") {
+            break;
+        case sip::HeaderId::FROM:
             msg.from = value;
-        } else if (name == "To" || name == "t") {
+            break;
+        case sip::HeaderId::TO:
             msg.to = value;
-        } else if (name == "Via" || name == "v") {
-            msg.via = value;
-        } else if (name == "Contact" || name == "m") {
+            break;
+        case sip::HeaderId::VIA:
+            // Top Via identifies the transaction
+            if (msg.via_list.empty()) {
+                msg.via = value;
+            }
+            msg.via_list.emplace_back(value);
+            break;
+        case sip::HeaderId::CONTACT:
             msg.contact = value;
-        } else if (name == "CSeq") {
+            break;
+        case sip::HeaderId::CSEQ:
             msg.cseq = value;
-        } else if (name == "Content-Type" || name == "c") {
+            break;
+        case sip::HeaderId::CONTENT_TYPE:
             msg.content_type = value;
-        } else if (name == "Authorization") {
-            msg.authorization = value;
-        } else if (name == "Reason") {
-            msg.reason = value;
-        } else if (name == "Diversion") {
-            msg.diversion.push_back(value);
-        } else if (name == "History-Info") {
-            msg.history_info.push_back(value);
-        } else if (name == "History-Info") {
-            msg.history_info.push_back(value);
-        } else if (name == "RSeq") {
-            try {
-                msg.rseq = std::stoul(value);
-            } catch (...) {
+            break;
+        case sip::HeaderId::AUTHORIZATION:
+            msg.authorization = std::string(value);
+            break;
+        case sip::HeaderId::REASON:
+            msg.reason = std::string(value);
+            break;
+        case sip::HeaderId::DIVERSION:
+            msg.diversion.emplace_back(value);
+            break;
+        case sip::HeaderId::HISTORY_INFO:
+            msg.history_info.emplace_back(value);
+            break;
+        case sip::HeaderId::RSEQ: {
+            uint32_t rseq = 0;
+            if (sip::parseUint(value, rseq)) {
+                msg.rseq = rseq;
             }
-        } else if (name == "RAck") {
-            msg.rack = value;
+            break;
         }
+        case sip::HeaderId::RACK:
+            msg.rack = std::string(value);
+            break;
 
-        // Store all headers
-        msg.headers[name] = value;
-    }
+        // 3GPP P-headers
+        case sip::HeaderId::P_ASSERTED_IDENTITY:
+            // Typically repeated: one sip: and one tel: identity
+            if (auto identities = SipPAssertedIdentity::parse(value)) {
+                if (msg.p_asserted_identity.has_value()) {
+                    msg.p_asserted_identity->insert(msg.p_asserted_identity->end(),
+                                                    identities->begin(), identities->end());
+                } else {
+                    msg.p_asserted_identity = std::move(identities);
+                }
+            }
+            break;
+        case sip::HeaderId::P_ACCESS_NETWORK_INFO:
+            msg.p_access_network_info = SipPAccessNetworkInfo::parse(value);
+            break;
+        case sip::HeaderId::P_VISITED_NETWORK_ID:
+            msg.p_visited_network_id = std::string(value);
+            break;
+        case sip::HeaderId::P_CHARGING_VECTOR:
+            msg.p_charging_vector = SipPChargingVector::parse(value);
+            break;
+        case sip::HeaderId::P_CHARGING_FUNCTION_ADDRESSES:
+            msg.p_charging_function_addresses = SipPChargingFunctionAddresses::parse(value);
+            break;
+        case sip::HeaderId::P_SERVED_USER:
+            msg.p_served_user = SipPServedUser::parse(value);
+            break;
+        case sip::HeaderId::P_PREFERRED_IDENTITY:
+            msg.p_preferred_identity = std::string(value);
+            break;
+        case sip::HeaderId::P_EARLY_MEDIA:
+            msg.p_early_media = std::string(value);
+            break;
+        case sip::HeaderId::P_ASSOCIATED_URI:
+            appendCommaList(value, msg.p_associated_uri);
+            break;
 
-    // Post-processing for tags and branch
-    if (!msg.from.empty()) {
-        msg.from_tag = extractParameter(msg.from, "tag");
-    }
-    if (!msg.to.empty()) {
-        msg.to_tag = extractParameter(msg.to, "tag");
-    }
-    if (!msg.via.empty()) {
-        msg.via_branch = extractParameter(msg.via, "branch");
+        // IMS session timers and feature negotiation
+        case sip::HeaderId::SESSION_EXPIRES:
+            msg.session_expires = SipSessionExpires::parse(value);
+            break;
+        case sip::HeaderId::MIN_SE: {
+            uint32_t min_se = 0;
+            if (sip::parseUint(value, min_se)) {
+                msg.min_se = min_se;
+            }
+            break;
+        }
+        case sip::HeaderId::REQUIRE:
+            appendCommaList(value, msg.require);
+            break;
+        case sip::HeaderId::SUPPORTED:
+            appendCommaList(value, msg.supported);
+            break;
+        case sip::HeaderId::ALLOW:
+            appendCommaList(value, msg.allow);
+            break;
+        case sip::HeaderId::PRIVACY:
+            msg.privacy = SipPrivacy::parse(value);
+            break;
+        case sip::HeaderId::GEOLOCATION:
+            msg.geolocation = std::string(value);
+            break;
+        case sip::HeaderId::GEOLOCATION_ROUTING:
+            msg.geolocation_routing = std::string(value);
+            break;
+        case sip::HeaderId::GEOLOCATION_ERROR:
+            msg.geolocation_error = std::string(value);
+            break;
+        case sip::HeaderId::REFER_TO:
+            msg.refer_to = std::string(value);
+            break;
+        case sip::HeaderId::REFERRED_BY:
+            msg.referred_by = std::string(value);
+            break;
+        case sip::HeaderId::REPLACES:
+            msg.replaces = std::string(value);
+            break;
+        case sip::HeaderId::EVENT:
+            msg.event = std::string(value);
+            break;
+        case sip::HeaderId::SUBSCRIPTION_STATE:
+            msg.subscription_state = SipSubscriptionState::parse(value);
+            break;
+
+        // Security headers
+        case sip::HeaderId::SECURITY_CLIENT:
+            msg.security_client = SipSecurityInfo::parse(value);
+            break;
+        case sip::HeaderId::SECURITY_SERVER:
+            msg.security_server = SipSecurityInfo::parse(value);
+            break;
+        case sip::HeaderId::SECURITY_VERIFY:
+            msg.security_verify = SipSecurityInfo::parse(value);
+            break;
+
+        // Routing headers
+        case sip::HeaderId::PATH:
+            appendCommaList(value, msg.path);
+            break;
+        case sip::HeaderId::SERVICE_ROUTE:
+            appendCommaList(value, msg.service_route);
+            break;
+        case sip::HeaderId::RECORD_ROUTE:
+            appendCommaList(value, msg.record_route);
+            break;
+        case sip::HeaderId::ROUTE:
+            msg.route = std::string(value);
+            break;
+
+        case sip::HeaderId::CONTENT_LENGTH:
+        case sip::HeaderId::UNKNOWN:
+            break;
     }
+
+    // Store all headers (shown as-is in the packet inspector)
+    msg.headers.insert_or_assign(std::string(field.name), std::string(value));
 }
 
-void SipParser::parseSdp(const std::string& body, SipMessage& msg) {
+void SipParser::parseSdp(std::string_view body, SipMessage& msg) {
     SipMessage::SdpInfo sdp;
 
-    auto lines = splitLines(body);
-    for (const auto& line : lines) {
+    // fmtp lines may precede their rtpmap, so they are applied at the end
+    std::vector<std::string_view> fmtp_values;
+
+    sip::LineTokenizer lines(body);
+    std::string_view line;
+    while (lines.next(line)) {
         if (line.length() < 2 || line[1] != '=')
             continue;
 
-        char type = line[0];
-        std::string value = line.substr(2);
+        std::string_view value = line.substr(2);
 
-        switch (type) {
+        switch (line[0]) {
             case 's':  // Session name
                 sdp.session_name = value;
                 break;
             case 'c':  // Connection information
                 // Format: c=IN IP4 192.168.1.1
-                if (value.find("IP4") != std::string::npos) {
+                if (value.find("IP4") != std::string_view::npos) {
                     size_t pos = value.rfind(' ');
-                    if (pos != std::string::npos) {
+                    if (pos != std::string_view::npos) {
                         sdp.connection_address = value.substr(pos + 1);
                     }
                 }
                 break;
             case 'm':  // Media description
-                sdp.media_descriptions.push_back(value);
+                sdp.media_descriptions.emplace_back(value);
                 // Extract RTP port: m=audio 49170 RTP/AVP 0
                 {
-                    std::istringstream iss(value);
-                    std::string media_type;
-                    uint16_t port;
-                    if (iss >> media_type >> port) {
-                        if (media_type == "audio" || media_type == "video") {
-                            sdp.rtp_port = port;
-                            sdp.rtcp_port = port + 1;  // RTCP typically uses next port
-                        }
+                    std::string_view rest = value;
+                    std::string_view media_type = sip::nextWord(rest);
+                    uint32_t port = 0;
+                    if ((media_type == "audio" || media_type == "video") &&
+                        sip::parseUint(sip::nextWord(rest), port) && port <= 0xFFFF) {
+                        sdp.rtp_port = static_cast<uint16_t>(port);
+                        sdp.rtcp_port = static_cast<uint16_t>(port + 1);  // RTCP typically uses next port
                     }
                 }
                 break;
+            case 'b':  // Bandwidth
+                SipSdpBandwidth::parseLine(line, sdp.bandwidth);
+                break;
             case 'a':  // Attribute
-            {
-                size_t colon = value.find(':');
-                if (colon != std::string::npos) {
-                    sdp.attributes[value.substr(0, colon)] = value.substr(colon + 1);
-                } else {
-                    sdp.attributes[value] = "";
+                if (value.substr(0, 5) == "fmtp:") {
+                    fmtp_values.push_back(value.substr(5));
                 }
-            } break;
-        }
-    }
-
-    // NEW: Parse IMS-specific SDP features
-    parseSdpQosPreconditions(sdp, lines);
-    parseSdpBandwidth(sdp, lines);
-    parseSdpCodecs(sdp, lines);
-    parseSdpMediaDirection(sdp, lines);
-
-    msg.sdp = sdp;
-}
-
-std::vector<std::string> SipParser::splitLines(const std::string& text) {
-    std::vector<std::string> lines;
-    std::istringstream stream(text);
-    std::string line;
-
-    while (std::getline(stream, line)) {
-        // Remove \r if present
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
+                parseSdpAttribute(value, sdp);
+                break;
         }
-        lines.push_back(line);
-    }
-
-    return lines;
-}
-
-std::pair<std::string, std::string> SipParser::parseHeader(const std::string& line) {
-    size_t colon = line.find(':');
-    if (colon == std::string::npos) {
-        return {"", ""};
-    }
-
-    std::string name = trim(line.substr(0, colon));
-    std::string value = trim(line.substr(colon + 1));
-
-    return {name, value};
-}
-
-std::string SipParser::trim(const std::string& str) {
-    size_t start = 0;
-    size_t end = str.length();
-
-    while (start < end && std::isspace(static_cast<unsigned char>(str[start]))) {
-        ++start;
-    }
-
-    while (end > start && std::isspace(static_cast<unsigned char>(str[end - 1]))) {
-        --end;
     }
 
-    return str.substr(start, end - start);
-}
-
-std::vector<std::string> SipParser::splitCommaList(const std::string& str) {
-    std::vector<std::string> result;
-    std::istringstream iss(str);
-    std::string item;
-
-    while (std::getline(iss, item, ',')) {
-        item = trim(item);
-        if (!item.empty()) {
-            result.push_back(item);
+    // Apply fmtp parameters to their codecs
+    for (std::string_view fmtp : fmtp_values) {
+        uint32_t pt = 0;
+        if (fmtp.find(' ') == std::string_view::npos || !sip::parseUint(fmtp, pt)) {
+            continue;
         }
-    }
-
-    return result;
-}
-
-// ============================================================================
-// 3GPP P-header parsing
-// ============================================================================
-
-void SipParser::parsePHeaders(SipMessage& msg) {
-    // P-Asserted-Identity
-    auto it = msg.headers.find("P-Asserted-Identity");
-    if (it != msg.headers.end()) {
-        msg.p_asserted_identity = SipPAssertedIdentity::parse(it->second);
-    }
-
-    // P-Access-Network-Info
-    it = msg.headers.find("P-Access-Network-Info");
-    if (it != msg.headers.end()) {
-        msg.p_access_network_info = SipPAccessNetworkInfo::parse(it->second);
-    }
-
-    // P-Visited-Network-ID
-    it = msg.headers.find("P-Visited-Network-ID");
-    if (it != msg.headers.end()) {
-        msg.p_visited_network_id = it->second;
-    }
-
-    // P-Charging-Vector (CRITICAL for billing)
-    it = msg.headers.find("P-Charging-Vector");
-    if (it != msg.headers.end()) {
-        msg.p_charging_vector = SipPChargingVector::parse(it->second);
-    }
-
-    // P-Charging-Function-Addresses
-    it = msg.headers.find("P-Charging-Function-Addresses");
-    if (it != msg.headers.end()) {
-        msg.p_charging_function_addresses = SipPChargingFunctionAddresses::parse(it->second);
-    }
-
-    // P-Served-User
-    it = msg.headers.find("P-Served-User");
-    if (it != msg.headers.end()) {
-        msg.p_served_user = SipPServedUser::parse(it->second);
-    }
-
-    // P-Preferred-Identity
-    it = msg.headers.find("P-Preferred-Identity");
-    if (it != msg.headers.end()) {
-        msg.p_preferred_identity = it->second;
-    }
-
-    // P-Early-Media
-    it = msg.headers.find("P-Early-Media");
-    if (it != msg.headers.end()) {
-        msg.p_early_media = it->second;
-    }
-
-    // P-Associated-URI
-    it = msg.headers.find("P-Associated-URI");
-    if (it != msg.headers.end()) {
-        msg.p_associated_uri = splitCommaList(it->second);
-    }
-}
-
-void SipParser::parseImsHeaders(SipMessage& msg) {
-    // Session-Expires
-    auto it = msg.headers.find("Session-Expires");
-    if (it != msg.headers.end()) {
-        msg.session_expires = SipSessionExpires::parse(it->second);
-    }
-
-    // Min-SE
-    it = msg.headers.find("Min-SE");
-    if (it != msg.headers.end()) {
-        try {
-            msg.min_se = std::stoul(it->second);
-        } catch (...) {
+        for (auto& codec : sdp.codecs) {
+            if (codec.payload_type == static_cast<uint8_t>(pt)) {
+                codec.parseFmtp(fmtp);
+                break;
+            }
         }
     }
 
-    // Require
-    it = msg.headers.find("Require");
-    if (it != msg.headers.end()) {
-        msg.require = splitCommaList(it->second);
-    }
-
-    // Supported
-    it = msg.headers.find("Supported");
-    if (it != msg.headers.end()) {
-        msg.supported = splitCommaList(it->second);
-    }
-
-    // Allow
-    it = msg.headers.find("Allow");
-    if (it != msg.headers.end()) {
-        msg.allow = splitCommaList(it->second);
-    }
-
-    // Privacy
-    it = msg.headers.find("Privacy");
-    if (it != msg.headers.end()) {
-        msg.privacy = SipPrivacy::parse(it->second);
-    }
-
-    // Geolocation
-    it = msg.headers.find("Geolocation");
-    if (it != msg.headers.end()) {
-        msg.geolocation = it->second;
-    }
-
-    // Geolocation-Routing
-    it = msg.headers.find("Geolocation-Routing");
-    if (it != msg.headers.end()) {
-        msg.geolocation_routing = it->second;
-    }
-
-    // Geolocation-Error
-    it = msg.headers.find("Geolocation-Error");
-    if (it != msg.headers.end()) {
-        msg.geolocation_error = it->second;
-    }
-
-    // Refer-To
-    it = msg.headers.find("Refer-To");
-    if (it != msg.headers.end()) {
-        msg.refer_to = it->second;
-    }
-
-    // Referred-By
-    it = msg.headers.find("Referred-By");
-    if (it != msg.headers.end()) {
-        msg.referred_by = it->second;
-    }
-
-    // Replaces
-    it = msg.headers.find("Replaces");
-    if (it != msg.headers.end()) {
-        msg.replaces = it->second;
-    }
-
-    // Event
-    it = msg.headers.find("Event");
-    if (it != msg.headers.end()) {
-        msg.event = it->second;
-    }
-
-    // Subscription-State
-    it = msg.headers.find("Subscription-State");
-    if (it != msg.headers.end()) {
-        msg.subscription_state = SipSubscriptionState::parse(it->second);
-    }
-}
-
-void SipParser::parseSecurityHeaders(SipMessage& msg) {
-    // Security-Client
-    auto it = msg.headers.find("Security-Client");
-    if (it != msg.headers.end()) {
-        msg.security_client = SipSecurityInfo::parse(it->second);
-    }
-
-    // Security-Server
-    it = msg.headers.find("Security-Server");
-    if (it != msg.headers.end()) {
-        msg.security_server = SipSecurityInfo::parse(it->second);
-    }
-
-    // Security-Verify
-    it = msg.headers.find("Security-Verify");
-    if (it != msg.headers.end()) {
-        msg.security_verify = SipSecurityInfo::parse(it->second);
-    }
-}
-
-void SipParser::parseRoutingHeaders(SipMessage& msg) {
-    // Path
-    auto it = msg.headers.find("Path");
-    if (it != msg.headers.end()) {
-        msg.path = splitCommaList(it->second);
-    }
-
-    // Service-Route
-    it = msg.headers.find("Service-Route");
-    if (it != msg.headers.end()) {
-        msg.service_route = splitCommaList(it->second);
-    }
-
-    // Record-Route
-    it = msg.headers.find("Record-Route");
-    if (it != msg.headers.end()) {
-        msg.record_route = splitCommaList(it->second);
-    }
-
-    // Route
-    it = msg.headers.find("Route");
-    if (it != msg.headers.end()) {
-        msg.route = it->second;
-    }
+    msg.sdp = std::move(sdp);
 }
 
 // ============================================================================
 // Enhanced SDP parsing for IMS
 // ============================================================================
 
-void SipParser::parseSdpQosPreconditions(SipMessage::SdpInfo& sdp,
-                                         const std::vector<std::string>& lines) {
-    for (const auto& line : lines) {
-        if (line.find("a=curr:qos") == 0) {
-            std::string value = line.substr(2);  // Remove 'a='
-            if (value.find("local") != std::string::npos) {
-                sdp.qos_current_local = SipSdpQosPrecondition::parseCurrent(value);
-            } else if (value.find("remote") != std::string::npos) {
-                sdp.qos_current_remote = SipSdpQosPrecondition::parseCurrent(value);
-            }
-        } else if (line.find("a=des:qos") == 0) {
-            std::string value = line.substr(2);  // Remove 'a='
-            if (value.find("local") != std::string::npos) {
-                sdp.qos_desired_local = SipSdpQosPrecondition::parseDesired(value);
-            } else if (value.find("remote") != std::string::npos) {
-                sdp.qos_desired_remote = SipSdpQosPrecondition::parseDesired(value);
-            }
-        }
-    }
-}
-
-void SipParser::parseSdpBandwidth(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines) {
-    for (const auto& line : lines) {
-        if (line.length() >= 2 && line[0] == 'b' && line[1] == '=') {
-            SipSdpBandwidth::parseLine(line, sdp.bandwidth);
-        }
-    }
-}
-
-void SipParser::parseSdpCodecs(SipMessage::SdpInfo& sdp, const std::vector<std::string>& lines) {
-    std::map<uint8_t, size_t> payload_to_index;
-
-    for (const auto& line : lines) {
-        if (line.find("a=rtpmap:") == 0) {
-            std::string value = line.substr(9);  // Remove 'a=rtpmap:'
-            auto codec = SipSdpCodec::parseRtpmap(value);
-            if (codec.has_value()) {
-                payload_to_index[codec->payload_type] = sdp.codecs.size();
-                sdp.codecs.push_back(codec.value());
-            }
-        }
-    }
-
-    // Parse fmtp attributes
-    for (const auto& line : lines) {
-        if (line.find("a=fmtp:") == 0) {
-            std::string value = line.substr(7);  // Remove 'a=fmtp:'
-
-            // Extract payload type
-            size_t space = value.find(' ');
-            if (space != std::string::npos) {
-                try {
-                    uint8_t pt = static_cast<uint8_t>(std::stoul(value.substr(0, space)));
-                    auto it = payload_to_index.find(pt);
-                    if (it != payload_to_index.end()) {
-                        sdp.codecs[it->second].parseFmtp(value);
-                    }
-                } catch (...) {
-                }
-            }
-        }
-    }
-}
-
-void SipParser::parseSdpMediaDirection(SipMessage::SdpInfo& sdp,
-                                       const std::vector<std::string>& lines) {
-    for (const auto& line : lines) {
-        if (line == "a=sendrecv") {
-            sdp.media_direction = "sendrecv";
-        } else if (line == "a=sendonly") {
-            sdp.media_direction = "sendonly";
-        } else if (line == "a=recvonly") {
-            sdp.media_direction = "recvonly";
-        } else if (line == "a=inactive") {
-            sdp.media_direction = "inactive";
-        }
+void SipParser::parseSdpAttribute(std::string_view attribute, SipMessage::SdpInfo& sdp) {
+    size_t colon = attribute.find(':');
+    if (colon != std::string_view::npos) {
+        sdp.attributes.insert_or_assign(std::string(attribute.substr(0, colon)),
+                                        std::string(attribute.substr(colon + 1)));
+    } else {
+        sdp.attributes.insert_or_assign(std::string(attribute), std::string());
+    }
+
+    // QoS preconditions (RFC 3312)
+    if (attribute.substr(0, 8) == "curr:qos") {
+        if (attribute.find("local") != std::string_view::npos) {
+            sdp.qos_current_local = SipSdpQosPrecondition::parseCurrent(attribute);
+        } else if (attribute.find("remote") != std::string_view::npos) {
+            sdp.qos_current_remote = SipSdpQosPrecondition::parseCurrent(attribute);
+        }
+    } else if (attribute.substr(0, 7) == "des:qos") {
+        if (attribute.find("local") != std::string_view::npos) {
+            sdp.qos_desired_local = SipSdpQosPrecondition::parseDesired(attribute);
+        } else if (attribute.find("remote") != std::string_view::npos) {
+            sdp.qos_desired_remote = SipSdpQosPrecondition::parseDesired(attribute);
+        }
+    } else if (attribute.substr(0, 7) == "rtpmap:") {
+        // Codecs; a repeated payload type keeps its first position
+        auto codec = SipSdpCodec::parseRtpmap(attribute.substr(7));
+        if (codec.has_value()) {
+            sdp.codecs.push_back(std::move(*codec));
+        }
+    } else if (attribute == "sendrecv" || attribute == "sendonly" || attribute == "recvonly" ||
+               attribute == "inactive") {
+        sdp.media_direction = std::string(attribute);
     }
 }
 
@@ -0,0 +1,308 @@
+#include "protocol_parsers/sip_scanner.h"
+
+#include <cstring>
+
+#include "protocol_parsers/sip_tokenizer.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CALLFLOW_SIP_SCAN_SSE2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 kernels are compiled per function and only called after a CPU check,
+// so the rest of the build keeps the x86-64 baseline
+#define CALLFLOW_SIP_SCAN_AVX2 1
+#endif
+#endif
+
+namespace callflow {
+namespace sip {
+
+namespace {
+
+inline uint8_t lowerAscii(uint8_t c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c | 0x20) : c;
+}
+
+ScanIsa detectScanIsa() {
+#if defined(CALLFLOW_SIP_SCAN_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ScanIsa::AVX2;
+    }
+#endif
+#if defined(CALLFLOW_SIP_SCAN_SSE2)
+    return ScanIsa::SSE2;
+#else
+    return ScanIsa::SCALAR;
+#endif
+}
+
+ScanIsa clampIsa(ScanIsa requested) {
+    ScanIsa best = activeScanIsa();
+    return requested < best ? requested : best;
+}
+
+/**
+ * Value offset if a header line named name / compact starts at pos
+ */
+size_t matchHeaderAt(const uint8_t* headers, size_t len, size_t pos, std::string_view name,
+                     char compact) {
+    size_t end;
+    if (len - pos > name.size() &&
+        iequals(std::string_view(reinterpret_cast<const char*>(headers + pos), name.size()),
+                name)) {
+        end = pos + name.size();
+    } else if (compact != 0 && lowerAscii(headers[pos]) == lowerAscii(compact)) {
+        end = pos + 1;
+    } else {
+        return kNoMatch;
+    }
+    while (end < len && (headers[end] == ' ' || headers[end] == '\t')) {
+        ++end;
+    }
+    return (end < len && headers[end] == ':') ? end + 1 : kNoMatch;
+}
+
+// ----------------------------------------------------------------------------
+// Scalar kernels; also finish the tails of the vector loops
+// ----------------------------------------------------------------------------
+
+size_t headerEndScalar(const uint8_t* data, size_t len, size_t pos) {
+    while (pos + 4 <= len) {
+        const void* cr = std::memchr(data + pos, '\r', len - 3 - pos);
+        if (cr == nullptr) {
+            return 0;
+        }
+        pos = static_cast<size_t>(static_cast<const uint8_t*>(cr) - data);
+        if (data[pos + 1] == '\n' && data[pos + 2] == '\r' && data[pos + 3] == '\n') {
+            return pos + 4;
+        }
+        ++pos;
+    }
+    return 0;
+}
+
+size_t headerValueScalar(const uint8_t* headers, size_t len, std::string_view name, char compact,
+                         size_t pos) {
+    // pos is a candidate line start; the start line (pos 0) is never a header
+    if (pos == 0) {
+        pos = 1;
+    }
+    while (pos < len) {
+        if (headers[pos - 1] == '\n') {
+            size_t value = matchHeaderAt(headers, len, pos, name, compact);
+            if (value != kNoMatch) {
+                return value;
+            }
+        }
+        const void* lf = std::memchr(headers + pos, '\n', len - pos);
+        if (lf == nullptr) {
+            break;
+        }
+        pos = static_cast<size_t>(static_cast<const uint8_t*>(lf) - headers) + 1;
+    }
+    return kNoMatch;
+}
+
+// ----------------------------------------------------------------------------
+// SSE2 kernels: 16 candidate positions per iteration
+// ----------------------------------------------------------------------------
+
+#if defined(CALLFLOW_SIP_SCAN_SSE2)
+
+inline __m128i load16(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+size_t headerEndSse2(const uint8_t* data, size_t len) {
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    size_t pos = 0;
+    // Four overlapping loads: bit i is set when data[pos + i .. pos + i + 3] == CRLFCRLF
+    for (; pos + 16 + 3 <= len; pos += 16) {
+        __m128i m = _mm_and_si128(_mm_cmpeq_epi8(load16(data + pos), cr),
+                                  _mm_cmpeq_epi8(load16(data + pos + 1), lf));
+        m = _mm_and_si128(m, _mm_cmpeq_epi8(load16(data + pos + 2), cr));
+        m = _mm_and_si128(m, _mm_cmpeq_epi8(load16(data + pos + 3), lf));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(mask)) + 4;
+        }
+    }
+    return headerEndScalar(data, len, pos);
+}
+
+size_t headerValueSse2(const uint8_t* headers, size_t len, std::string_view name, char compact) {
+    // Candidates: line starts whose lower-cased first byte matches either form
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i first =
+        _mm_set1_epi8(static_cast<char>(lowerAscii(name.empty() ? 0 : name[0])));
+    const __m128i second =
+        _mm_set1_epi8(static_cast<char>(lowerAscii(compact != 0 ? compact : name[0])));
+    size_t pos = 1;
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_or_si128(load16(headers + pos), case_bit);
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, first), _mm_cmpeq_epi8(v, second));
+        m = _mm_and_si128(m, _mm_cmpeq_epi8(load16(headers + pos - 1), lf));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+        while (mask != 0) {
+            size_t at = pos + static_cast<size_t>(__builtin_ctz(mask));
+            size_t value = matchHeaderAt(headers, len, at, name, compact);
+            if (value != kNoMatch) {
+                return value;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return headerValueScalar(headers, len, name, compact, pos);
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+// AVX2 kernels: same algorithm, 32 positions per iteration
+// ----------------------------------------------------------------------------
+
+#if defined(CALLFLOW_SIP_SCAN_AVX2)
+
+__attribute__((target("avx2"))) inline __m256i load32(const uint8_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2"))) size_t headerEndAvx2(const uint8_t* data, size_t len) {
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    size_t pos = 0;
+    for (; pos + 32 + 3 <= len; pos += 32) {
+        __m256i m = _mm256_and_si256(_mm256_cmpeq_epi8(load32(data + pos), cr),
+                                     _mm256_cmpeq_epi8(load32(data + pos + 1), lf));
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi8(load32(data + pos + 2), cr));
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi8(load32(data + pos + 3), lf));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(mask)) + 4;
+        }
+    }
+    return headerEndScalar(data, len, pos);
+}
+
+__attribute__((target("avx2"))) size_t headerValueAvx2(const uint8_t* headers, size_t len,
+                                                       std::string_view name, char compact) {
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i first =
+        _mm256_set1_epi8(static_cast<char>(lowerAscii(name.empty() ? 0 : name[0])));
+    const __m256i second =
+        _mm256_set1_epi8(static_cast<char>(lowerAscii(compact != 0 ? compact : name[0])));
+    size_t pos = 1;
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i v = _mm256_or_si256(load32(headers + pos), case_bit);
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, first), _mm256_cmpeq_epi8(v, second));
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi8(load32(headers + pos - 1), lf));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        while (mask != 0) {
+            size_t at = pos + static_cast<size_t>(__builtin_ctz(mask));
+            size_t value = matchHeaderAt(headers, len, at, name, compact);
+            if (value != kNoMatch) {
+                return value;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return headerValueScalar(headers, len, name, compact, pos);
+}
+
+#endif
+
+}  // namespace
+
+ScanIsa activeScanIsa() {
+    static const ScanIsa isa = detectScanIsa();
+    return isa;
+}
+
+const char* scanIsaName(ScanIsa isa) {
+    switch (isa) {
+        case ScanIsa::SCALAR: return "scalar";
+        case ScanIsa::SSE2: return "sse2";
+        case ScanIsa::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+size_t findHeaderEnd(const uint8_t* data, size_t len) {
+    return findHeaderEnd(data, len, activeScanIsa());
+}
+
+size_t findHeaderEnd(const uint8_t* data, size_t len, ScanIsa isa) {
+    switch (clampIsa(isa)) {
+#if defined(CALLFLOW_SIP_SCAN_AVX2)
+        case ScanIsa::AVX2: return headerEndAvx2(data, len);
+#endif
+#if defined(CALLFLOW_SIP_SCAN_SSE2)
+        case ScanIsa::SSE2: return headerEndSse2(data, len);
+#endif
+        default: return headerEndScalar(data, len, 0);
+    }
+}
+
+size_t findHeaderValue(const uint8_t* headers, size_t len, std::string_view name, char compact) {
+    return findHeaderValue(headers, len, name, compact, activeScanIsa());
+}
+
+size_t findHeaderValue(const uint8_t* headers, size_t len, std::string_view name, char compact,
+                       ScanIsa isa) {
+    if (name.empty() && compact == 0) {
+        return kNoMatch;
+    }
+    switch (clampIsa(isa)) {
+#if defined(CALLFLOW_SIP_SCAN_AVX2)
+        case ScanIsa::AVX2: return headerValueAvx2(headers, len, name, compact);
+#endif
+#if defined(CALLFLOW_SIP_SCAN_SSE2)
+        case ScanIsa::SSE2: return headerValueSse2(headers, len, name, compact);
+#endif
+        default: return headerValueScalar(headers, len, name, compact, 0);
+    }
+}
+
+size_t findContentLength(const uint8_t* headers, size_t len) {
+    return findContentLength(headers, len, activeScanIsa());
+}
+
+size_t findContentLength(const uint8_t* headers, size_t len, ScanIsa isa) {
+    size_t pos = findHeaderValue(headers, len, "Content-Length", 'l', isa);
+    if (pos == kNoMatch) {
+        return 0;
+    }
+    while (pos < len && (headers[pos] == ' ' || headers[pos] == '\t')) {
+        ++pos;
+    }
+    // Saturate rather than wrap; callers reject oversized messages anyway
+    constexpr size_t kMaxContentLength = size_t(1) << 31;
+    size_t value = 0;
+    for (; pos < len && headers[pos] >= '0' && headers[pos] <= '9'; ++pos) {
+        value = value * 10 + static_cast<size_t>(headers[pos] - '0');
+        if (value > kMaxContentLength) {
+            return kMaxContentLength;
+        }
+    }
+    return value;
+}
+
+size_t completeMessageLength(const uint8_t* data, size_t len) {
+    return completeMessageLength(data, len, activeScanIsa());
+}
+
+size_t completeMessageLength(const uint8_t* data, size_t len, ScanIsa isa) {
+    size_t header_len = findHeaderEnd(data, len, isa);
+    if (header_len == 0) {
+        return 0;
+    }
+    size_t total = header_len + findContentLength(data, header_len, isa);
+    return total <= len ? total : 0;
+}
+
+}  // namespace sip
+}  // namespace callflow
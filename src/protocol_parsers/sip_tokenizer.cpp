@@ -0,0 +1,331 @@
+#include "protocol_parsers/sip_tokenizer.h"
+
+#include <array>
+#include <charconv>
+
+namespace callflow {
+namespace sip {
+
+namespace {
+
+constexpr std::string_view kSipVersion = "SIP/2.0";
+
+struct HeaderName {
+    std::string_view name;
+    HeaderId id;
+};
+
+constexpr std::array<HeaderName, 44> kHeaderNames = {{
+    {"Call-ID", HeaderId::CALL_ID},
+    {"From", HeaderId::FROM},
+    {"To", HeaderId::TO},
+    {"Via", HeaderId::VIA},
+    {"Contact", HeaderId::CONTACT},
+    {"CSeq", HeaderId::CSEQ},
+    {"Content-Type", HeaderId::CONTENT_TYPE},
+    {"Content-Length", HeaderId::CONTENT_LENGTH},
+    {"Authorization", HeaderId::AUTHORIZATION},
+    {"Reason", HeaderId::REASON},
+    {"Diversion", HeaderId::DIVERSION},
+    {"History-Info", HeaderId::HISTORY_INFO},
+    {"RSeq", HeaderId::RSEQ},
+    {"RAck", HeaderId::RACK},
+    {"P-Asserted-Identity", HeaderId::P_ASSERTED_IDENTITY},
+    {"P-Access-Network-Info", HeaderId::P_ACCESS_NETWORK_INFO},
+    {"P-Visited-Network-ID", HeaderId::P_VISITED_NETWORK_ID},
+    {"P-Charging-Vector", HeaderId::P_CHARGING_VECTOR},
+    {"P-Charging-Function-Addresses", HeaderId::P_CHARGING_FUNCTION_ADDRESSES},
+    {"P-Served-User", HeaderId::P_SERVED_USER},
+    {"P-Preferred-Identity", HeaderId::P_PREFERRED_IDENTITY},
+    {"P-Early-Media", HeaderId::P_EARLY_MEDIA},
+    {"P-Associated-URI", HeaderId::P_ASSOCIATED_URI},
+    {"Session-Expires", HeaderId::SESSION_EXPIRES},
+    {"Min-SE", HeaderId::MIN_SE},
+    {"Require", HeaderId::REQUIRE},
+    {"Supported", HeaderId::SUPPORTED},
+    {"Allow", HeaderId::ALLOW},
+    {"Privacy", HeaderId::PRIVACY},
+    {"Geolocation", HeaderId::GEOLOCATION},
+    {"Geolocation-Routing", HeaderId::GEOLOCATION_ROUTING},
+    {"Geolocation-Error", HeaderId::GEOLOCATION_ERROR},
+    {"Refer-To", HeaderId::REFER_TO},
+    {"Referred-By", HeaderId::REFERRED_BY},
+    {"Replaces", HeaderId::REPLACES},
+    {"Event", HeaderId::EVENT},
+    {"Subscription-State", HeaderId::SUBSCRIPTION_STATE},
+    {"Security-Client", HeaderId::SECURITY_CLIENT},
+    {"Security-Server", HeaderId::SECURITY_SERVER},
+    {"Security-Verify", HeaderId::SECURITY_VERIFY},
+    {"Path", HeaderId::PATH},
+    {"Service-Route", HeaderId::SERVICE_ROUTE},
+    {"Record-Route", HeaderId::RECORD_ROUTE},
+    {"Route", HeaderId::ROUTE},
+}};
+
+inline char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+HeaderId lookupCompact(char c) {
+    switch (toLower(c)) {
+        case 'i': return HeaderId::CALL_ID;
+        case 'f': return HeaderId::FROM;
+        case 't': return HeaderId::TO;
+        case 'v': return HeaderId::VIA;
+        case 'm': return HeaderId::CONTACT;
+        case 'c': return HeaderId::CONTENT_TYPE;
+        case 'l': return HeaderId::CONTENT_LENGTH;
+        case 'k': return HeaderId::SUPPORTED;
+        case 'o': return HeaderId::EVENT;
+        case 'r': return HeaderId::REFER_TO;
+        case 'b': return HeaderId::REFERRED_BY;
+        case 'x': return HeaderId::SESSION_EXPIRES;
+        default: return HeaderId::UNKNOWN;
+    }
+}
+
+}  // namespace
+
+HeaderId lookupHeader(std::string_view name) {
+    if (name.size() == 1) {
+        return lookupCompact(name[0]);
+    }
+    if (name.empty()) {
+        return HeaderId::UNKNOWN;
+    }
+    const char first = toLower(name[0]);
+    for (const auto& entry : kHeaderNames) {
+        if (entry.name.size() == name.size() && toLower(entry.name[0]) == first &&
+            iequals(entry.name, name)) {
+            return entry.id;
+        }
+    }
+    return HeaderId::UNKNOWN;
+}
+
+// ============================================================================
+// LineTokenizer / MessageTokenizer
+// ============================================================================
+
+bool LineTokenizer::next(std::string_view& line) {
+    if (pos_ >= text_.size()) {
+        return false;
+    }
+    size_t eol = text_.find('\n', pos_);
+    if (eol == std::string_view::npos) {
+        line = text_.substr(pos_);
+        pos_ = text_.size();
+    } else {
+        line = text_.substr(pos_, eol - pos_);
+        pos_ = eol + 1;
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return true;
+}
+
+bool MessageTokenizer::startLine(StartLine& start) {
+    std::string_view line;
+    // RFC 3261 section 7.5: ignore CRLFs preceding the start line
+    do {
+        if (!lines_.next(line)) {
+            return false;
+        }
+    } while (line.empty());
+
+    if (line.substr(0, kSipVersion.size()) == kSipVersion) {
+        // SIP/2.0 status-code reason-phrase
+        std::string_view rest = line;
+        if (nextWord(rest) != kSipVersion) {
+            return false;
+        }
+        std::string_view code = nextWord(rest);
+        auto result = std::from_chars(code.data(), code.data() + code.size(), start.status_code);
+        if (code.empty() || result.ec != std::errc()) {
+            return false;
+        }
+        start.is_request = false;
+        start.reason = trim(rest);
+        return true;
+    }
+
+    if (line.find(kSipVersion) == std::string_view::npos) {
+        return false;
+    }
+
+    // METHOD request-URI SIP/2.0
+    std::string_view rest = line;
+    start.method = nextWord(rest);
+    start.request_uri = nextWord(rest);
+    if (start.request_uri.empty() || nextWord(rest) != kSipVersion) {
+        return false;
+    }
+    start.is_request = true;
+    return true;
+}
+
+bool MessageTokenizer::nextHeader(HeaderField& field) {
+    if (in_body_) {
+        return false;
+    }
+
+    std::string_view line;
+    while (lines_.next(line)) {
+        if (line.empty()) {
+            in_body_ = true;
+            return false;
+        }
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+
+        std::string_view value = line.substr(colon + 1);
+        field.folded = false;
+        while (lines_.atContinuation()) {
+            std::string_view continuation;
+            lines_.next(continuation);
+            value = std::string_view(value.data(), static_cast<size_t>(continuation.data() +
+                                                                       continuation.size() -
+                                                                       value.data()));
+            field.folded = true;
+        }
+
+        field.name = trim(line.substr(0, colon));
+        field.value = trim(value);
+        field.id = lookupHeader(field.name);
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool containsNoCase(std::string_view text, std::string_view needle) {
+    if (needle.size() > text.size()) {
+        return false;
+    }
+    for (size_t i = 0; i + needle.size() <= text.size(); ++i) {
+        if (iequals(text.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseUint(std::string_view text, uint32_t& value) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ptr != text.data() && result.ec == std::errc();
+}
+
+std::string_view headerParameter(std::string_view value, std::string_view name) {
+    size_t pos = 0;
+    while ((pos = value.find(name, pos)) != std::string_view::npos) {
+        size_t start = pos + name.size();
+        bool at_boundary = pos == 0 || value[pos - 1] == ';' || isSpace(value[pos - 1]);
+        if (at_boundary && start < value.size() && value[start] == '=') {
+            ++start;
+            size_t end = value.find_first_of("; \r\n", start);
+            if (end == std::string_view::npos) {
+                end = value.size();
+            }
+            return value.substr(start, end - start);
+        }
+        pos = start;
+    }
+    return {};
+}
+
+std::string_view uriUser(std::string_view text) {
+    size_t pos = 0;
+    while ((pos = text.find("sip:", pos)) != std::string_view::npos) {
+        size_t start = pos + 4;
+        size_t at = text.find('@', start);
+        if (at == std::string_view::npos) {
+            return {};
+        }
+        if (at > start) {
+            return text.substr(start, at - start);
+        }
+        pos = start;
+    }
+    return {};
+}
+
+std::string_view uriHost(std::string_view text) {
+    size_t pos = 0;
+    while ((pos = text.find("sip:", pos)) != std::string_view::npos) {
+        size_t start = pos + 4;
+        size_t at = text.find('@', start);
+        if (at == std::string_view::npos) {
+            return {};
+        }
+        if (at > start) {
+            size_t end = text.find_first_of(":;>", at + 1);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+            if (end > at + 1) {
+                return text.substr(at + 1, end - at - 1);
+            }
+        }
+        pos = start;
+    }
+    return {};
+}
+
+std::string unfold(std::string_view value) {
+    std::string result;
+    result.reserve(value.size());
+    size_t i = 0;
+    while (i < value.size()) {
+        char c = value[i];
+        if (c != '\r' && c != '\n') {
+            result.push_back(c);
+            ++i;
+            continue;
+        }
+        while (!result.empty() && (result.back() == ' ' || result.back() == '\t')) {
+            result.pop_back();
+        }
+        while (i < value.size() && isSpace(value[i])) {
+            ++i;
+        }
+        result.push_back(' ');
+    }
+    return result;
+}
+
+std::string normalizeLineEndings(std::string_view text) {
+    std::string result;
+    result.reserve(text.size() + 1);
+    LineTokenizer lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        result.append(line);
+        result.push_back('\n');
+    }
+    return result;
+}
+
+}  // namespace sip
+}  // namespace callflow
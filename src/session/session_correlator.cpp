@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <random>
 #include <sstream>
-#include <unordered_set>
 
 #include "common/logger.h"
 #include "common/utils.h"
@@ -14,7 +13,11 @@ namespace callflow {
 // EnhancedSessionCorrelator Constructor
 // ============================================================================
 
-EnhancedSessionCorrelator::EnhancedSessionCorrelator() {
+EnhancedSessionCorrelator::EnhancedSessionCorrelator()
+    : EnhancedSessionCorrelator(std::pmr::get_default_resource()) {}
+
+EnhancedSessionCorrelator::EnhancedSessionCorrelator(std::pmr::memory_resource* resource)
+    : resource_(resource), sessions_(resource) {
     // Initialize SIP-only session manager
     sip_only_manager_ = std::make_unique<correlation::SipSessionManager>();
 }
@@ -29,34 +32,27 @@ void EnhancedSessionCorrelator::addMessage(const SessionMessageRef& msg) {
     LOG_DEBUG("Adding message to correlator: " << protocolTypeToString(msg.protocol) << " on "
                                                << interfaceTypeToString(msg.interface));
 
-    // Find ALL matching sessions
-    std::unordered_set<std::string> matching_session_ids;
+    // Find ALL matching sessions (almost always zero or one)
+    SessionHandleList matching_handles;
 
     // Helper to add matches from an index lookup
     auto addFromIndex = [&](auto& index, const auto& key_val) {
         if (key_val.has_value()) {
-            auto it = index.find(key_val.value());
-            if (it != index.end()) {
-                auto& sessions = it->second;
-                for (auto list_it = sessions.begin(); list_it != sessions.end();) {
-                    if (sessions_.find(*list_it) == sessions_.end()) {
-                        // Stale entry, remove it
-                        list_it = sessions.erase(list_it);
-                    } else {
-                        matching_session_ids.insert(*list_it);
-                        ++list_it;
-                    }
+            auto* handles = index.find(key_val.value());
+            if (handles) {
+                // Drop stale entries left behind by sessions merged away
+                handles->removeIf([&](SessionHandle h) { return session_handles_[h] == nullptr; });
+                if (handles->empty()) {
+                    index.erase(key_val.value());
+                    return;
                 }
-                if (sessions.empty()) {
-                    index.erase(it);
+                for (SessionHandle h : *handles) {
+                    matching_handles.add(h);
                 }
             }
         }
     };
 
-    // Numeric index helper - unify logic
-    auto addFromNumericIndex = addFromIndex;
-
     // 1. Search all indices directly (avoiding deadlock by not calling public methods)
     addFromIndex(imsi_index_, msg.correlation_key.imsi);
     addFromIndex(supi_index_, msg.correlation_key.supi);
@@ -65,200 +61,106 @@ void EnhancedSessionCorrelator::addMessage(const SessionMessageRef& msg) {
     addFromIndex(ue_ip_index_, msg.correlation_key.ue_ipv4);
     addFromIndex(ue_ip_index_, msg.correlation_key.ue_ipv6);
 
-    addFromNumericIndex(teid_index_, msg.correlation_key.teid_s1u);
-    addFromNumericIndex(teid_index_, msg.correlation_key.teid_s5u);
-    addFromNumericIndex(seid_index_, msg.correlation_key.seid_n4);
+    addFromIndex(teid_index_, msg.correlation_key.teid_s1u);
+    addFromIndex(teid_index_, msg.correlation_key.teid_s5u);
+    addFromIndex(seid_index_, msg.correlation_key.seid_n4);
 
-    if (matching_session_ids.empty()) {
+    if (matching_handles.empty()) {
         // Scenario 0: No Match -> Create new session
-        std::string new_session_id = createNewSession(msg);
-        LOG_DEBUG("Created new session: " << new_session_id);
+        SessionHandle new_handle = createNewSession(msg);
+        LOG_DEBUG("Created new session: " << session_handles_[new_handle]->session_id);
     } else {
         // Scenario 1 & 2: Match found (single or multiple)
-        std::string primary_session_id = *matching_session_ids.begin();
+        // The oldest session (lowest handle) absorbs the others
+        SessionHandle primary_handle =
+            *std::min_element(matching_handles.begin(), matching_handles.end());
 
         // If multiple matches, merge them
-        if (matching_session_ids.size() > 1) {
-            LOG_INFO("Found " << matching_session_ids.size() << " matching sessions. Merging.");
-            for (const auto& id : matching_session_ids) {
-                if (id != primary_session_id) {
-                    mergeSessions(primary_session_id, id);
+        if (matching_handles.size() > 1) {
+            LOG_INFO("Found " << matching_handles.size() << " matching sessions. Merging.");
+            for (SessionHandle handle : matching_handles) {
+                if (handle != primary_handle) {
+                    mergeSessions(primary_handle, handle);
                 }
             }
         }
 
         // Add message to the (now unified) primary session
-        addMessageToSession(primary_session_id, msg);
+        addMessageToSession(primary_handle, msg);
     }
 }
-std::vector<Session> EnhancedSessionCorrelator::correlateByImsi(const std::string& imsi) const {
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
 
-    auto it = imsi_index_.find(imsi);
-    if (it != imsi_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
+std::vector<Session> EnhancedSessionCorrelator::collectSessions(
+    const SessionHandleList* handles) const {
+    std::vector<Session> result;
+    if (handles) {
+        for (SessionHandle handle : *handles) {
+            if (const Session* session = session_handles_[handle]) {
+                result.push_back(*session);
             }
         }
     }
-
     return result;
 }
 
-std::vector<Session> EnhancedSessionCorrelator::correlateBySupi(const std::string& supi) const {
+std::vector<Session> EnhancedSessionCorrelator::correlateByImsi(const std::string& imsi) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = supi_index_.find(supi);
-    if (it != supi_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
+    return collectSessions(imsi_index_.find(imsi));
+}
 
-    return result;
+std::vector<Session> EnhancedSessionCorrelator::correlateBySupi(const std::string& supi) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return collectSessions(supi_index_.find(supi));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateByTeid(uint32_t teid) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = teid_index_.find(teid);
-    if (it != teid_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
-
-    return result;
+    return collectSessions(teid_index_.find(teid));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateBySeid(uint64_t seid) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = seid_index_.find(seid);
-    if (it != seid_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
-
-    return result;
+    return collectSessions(seid_index_.find(seid));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateByUeIp(const std::string& ue_ip) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = ue_ip_index_.find(ue_ip);
-    if (it != ue_ip_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
-
-    return result;
+    return collectSessions(ue_ip_index_.find(ue_ip));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateByMsisdn(const std::string& msisdn) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = msisdn_index_.find(msisdn);
-    if (it != msisdn_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
-    return result;
+    return collectSessions(msisdn_index_.find(msisdn));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateByIcid(const std::string& icid) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-
-    auto it = icid_index_.find(icid);
-    if (it != icid_index_.end()) {
-        for (const auto& session_id : it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                result.push_back(session_it->second);
-            }
-        }
-    }
-    return result;
+    return collectSessions(icid_index_.find(icid));
 }
 
 std::vector<Session> EnhancedSessionCorrelator::correlateByKey(
     const SessionCorrelationKey& key) const {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
-    std::vector<Session> result;
-    std::unordered_set<std::string> found_session_ids;
-
-    // Search all indices
-    if (key.imsi.has_value()) {
-        auto it = imsi_index_.find(key.imsi.value());
-        if (it != imsi_index_.end()) {
-            found_session_ids.insert(it->second.begin(), it->second.end());
-        }
-    }
-
-    if (key.supi.has_value()) {
-        auto it = supi_index_.find(key.supi.value());
-        if (it != supi_index_.end()) {
-            found_session_ids.insert(it->second.begin(), it->second.end());
-        }
-    }
-
-    if (key.teid_s1u.has_value()) {
-        auto it = teid_index_.find(key.teid_s1u.value());
-        if (it != teid_index_.end()) {
-            found_session_ids.insert(it->second.begin(), it->second.end());
-        }
-    }
+    SessionHandleList found_handles;
 
-    if (key.seid_n4.has_value()) {
-        auto it = seid_index_.find(key.seid_n4.value());
-        if (it != seid_index_.end()) {
-            found_session_ids.insert(it->second.begin(), it->second.end());
-        }
-    }
-
-    if (key.ue_ipv4.has_value()) {
-        auto it = ue_ip_index_.find(key.ue_ipv4.value());
-        if (it != ue_ip_index_.end()) {
-            found_session_ids.insert(it->second.begin(), it->second.end());
+    auto addFromIndex = [&](const auto& index, const auto& key_val) {
+        if (key_val.has_value()) {
+            if (const auto* handles = index.find(key_val.value())) {
+                for (SessionHandle h : *handles) {
+                    found_handles.add(h);
+                }
+            }
         }
-    }
+    };
 
-    // Collect sessions
-    for (const auto& session_id : found_session_ids) {
-        auto session_it = sessions_.find(session_id);
-        if (session_it != sessions_.end()) {
-            result.push_back(session_it->second);
-        }
-    }
+    // Search all indices
+    addFromIndex(imsi_index_, key.imsi);
+    addFromIndex(supi_index_, key.supi);
+    addFromIndex(teid_index_, key.teid_s1u);
+    addFromIndex(seid_index_, key.seid_n4);
+    addFromIndex(ue_ip_index_, key.ue_ipv4);
 
-    return result;
+    return collectSessions(&found_handles);
 }
 
 std::optional<Session> EnhancedSessionCorrelator::getSession(const std::string& session_id) const {
@@ -305,29 +207,21 @@ std::vector<SessionMessageRef> EnhancedSessionCorrelator::getSessionLegs(
     std::lock_guard<std::recursive_mutex> lock(mutex_);
     std::vector<SessionMessageRef> result;
 
-    // Search by IMSI
-    auto imsi_it = imsi_index_.find(identifier);
-    if (imsi_it != imsi_index_.end()) {
-        for (const auto& session_id : imsi_it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                auto msgs = session_it->second.getAllMessages();
-                result.insert(result.end(), msgs.begin(), msgs.end());
-            }
+    auto addLegs = [&](const SessionHandleList* handles) {
+        if (!handles) {
+            return;
         }
-    }
-
-    // Search by SUPI
-    auto supi_it = supi_index_.find(identifier);
-    if (supi_it != supi_index_.end()) {
-        for (const auto& session_id : supi_it->second) {
-            auto session_it = sessions_.find(session_id);
-            if (session_it != sessions_.end()) {
-                auto msgs = session_it->second.getAllMessages();
+        for (SessionHandle handle : *handles) {
+            if (const Session* session = session_handles_[handle]) {
+                auto msgs = session->getAllMessages();
                 result.insert(result.end(), msgs.begin(), msgs.end());
             }
         }
-    }
+    };
+
+    // Search by IMSI, then SUPI
+    addLegs(imsi_index_.find(identifier));
+    addLegs(supi_index_.find(identifier));
 
     // Sort by timestamp
     std::sort(result.begin(), result.end(),
@@ -390,6 +284,7 @@ void EnhancedSessionCorrelator::clear() {
     std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     sessions_.clear();
+    session_handles_.clear();
     imsi_index_.clear();
     supi_index_.clear();
     teid_index_.clear();
@@ -397,6 +292,8 @@ void EnhancedSessionCorrelator::clear() {
     ue_ip_index_.clear();
     mme_ue_id_index_.clear();
     amf_ue_id_index_.clear();
+    msisdn_index_.clear();
+    icid_index_.clear();
 
     LOG_INFO("Session correlator cleared");
 }
@@ -472,9 +369,12 @@ std::optional<std::string> EnhancedSessionCorrelator::findMatchingSession(
     return std::nullopt;
 }
 
-std::string EnhancedSessionCorrelator::createNewSession(const SessionMessageRef& msg) {
-    Session new_session;
-    new_session.session_id = generateSessionId();
+SessionHandle EnhancedSessionCorrelator::createNewSession(const SessionMessageRef& msg) {
+    std::string session_id = generateSessionId();
+
+    // Store session (unordered_map nodes are stable, so the handle can point at it)
+    Session& new_session = sessions_.try_emplace(session_id, resource_).first->second;
+    new_session.session_id = session_id;
     new_session.session_type = EnhancedSessionType::UNKNOWN;
     new_session.correlation_key = msg.correlation_key;
     new_session.start_time = msg.timestamp;
@@ -486,119 +386,68 @@ std::string EnhancedSessionCorrelator::createNewSession(const SessionMessageRef&
     // Add first message
     new_session.addMessage(msg);
 
+    SessionHandle handle = static_cast<SessionHandle>(session_handles_.size());
+    session_handles_.push_back(&new_session);
+
     // Update indices
-    updateIndices(new_session.session_id, msg.correlation_key);
+    updateIndices(handle, msg.correlation_key);
 
     // Update Master Session (Community Correlation)
     updateMasterSession(new_session.session_id, msg);
 
-    // Store session
-    sessions_[new_session.session_id] = new_session;
-
-    return new_session.session_id;
+    return handle;
 }
 
-void EnhancedSessionCorrelator::addMessageToSession(const std::string& session_id,
+void EnhancedSessionCorrelator::addMessageToSession(SessionHandle handle,
                                                     const SessionMessageRef& msg) {
-    auto it = sessions_.find(session_id);
-    if (it == sessions_.end()) {
-        LOG_ERROR("Session not found: " << session_id);
+    Session* session = session_handles_[handle];
+    if (!session) {
+        LOG_ERROR("Session not found for handle: " << handle);
         return;
     }
 
-    Session& session = it->second;
-    session.addMessage(msg);
+    session->addMessage(msg);
 
     // Update indices with new correlation keys
-    updateIndices(session_id, msg.correlation_key);
+    updateIndices(handle, msg.correlation_key);
 
     // Update Master Session (Community Correlation)
-    updateMasterSession(session_id, msg);
+    updateMasterSession(session->session_id, msg);
 }
 
-void EnhancedSessionCorrelator::updateIndices(const std::string& session_id,
+void EnhancedSessionCorrelator::updateIndices(SessionHandle handle,
                                               const SessionCorrelationKey& key) {
-    // Update IMSI index
-    if (key.imsi.has_value()) {
-        auto& sessions = imsi_index_[key.imsi.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-
-    // Update SUPI index
-    if (key.supi.has_value()) {
-        auto& sessions = supi_index_[key.supi.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-
-    // Update TEID indices
-    if (key.teid_s1u.has_value()) {
-        auto& sessions = teid_index_[key.teid_s1u.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-    if (key.teid_s5u.has_value()) {
-        auto& sessions = teid_index_[key.teid_s5u.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-
-    // Update SEID index
-    if (key.seid_n4.has_value()) {
-        auto& sessions = seid_index_[key.seid_n4.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
+    // Subscriber identities
+    if (key.imsi.has_value())
+        imsi_index_.insert(key.imsi.value(), handle);
+    if (key.supi.has_value())
+        supi_index_.insert(key.supi.value(), handle);
+    if (key.msisdn.has_value())
+        msisdn_index_.insert(key.msisdn.value(), handle);
 
-    // Update UE IP indices
-    if (key.ue_ipv4.has_value()) {
-        auto& sessions = ue_ip_index_[key.ue_ipv4.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-    if (key.ue_ipv6.has_value()) {
-        auto& sessions = ue_ip_index_[key.ue_ipv6.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
+    // Tunnel and session endpoint IDs
+    if (key.teid_s1u.has_value())
+        teid_index_.insert(key.teid_s1u.value(), handle);
+    if (key.teid_s5u.has_value())
+        teid_index_.insert(key.teid_s5u.value(), handle);
+    if (key.seid_n4.has_value())
+        seid_index_.insert(key.seid_n4.value(), handle);
 
-    // Update UE context ID indices
-    if (key.mme_ue_s1ap_id.has_value()) {
-        auto& sessions = mme_ue_id_index_[key.mme_ue_s1ap_id.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
-    if (key.amf_ue_ngap_id.has_value()) {
-        auto& sessions = amf_ue_id_index_[key.amf_ue_ngap_id.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
+    // UE IPs
+    if (key.ue_ipv4.has_value())
+        ue_ip_index_.insert(key.ue_ipv4.value(), handle);
+    if (key.ue_ipv6.has_value())
+        ue_ip_index_.insert(key.ue_ipv6.value(), handle);
 
-    // Update MSISDN index
-    if (key.msisdn.has_value()) {
-        auto& sessions = msisdn_index_[key.msisdn.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
+    // UE context IDs
+    if (key.mme_ue_s1ap_id.has_value())
+        mme_ue_id_index_.insert(key.mme_ue_s1ap_id.value(), handle);
+    if (key.amf_ue_ngap_id.has_value())
+        amf_ue_id_index_.insert(key.amf_ue_ngap_id.value(), handle);
 
-    // Update ICID index
-    if (key.icid.has_value()) {
-        auto& sessions = icid_index_[key.icid.value()];
-        if (std::find(sessions.begin(), sessions.end(), session_id) == sessions.end()) {
-            sessions.push_back(session_id);
-        }
-    }
+    // IMS charging ID
+    if (key.icid.has_value())
+        icid_index_.insert(key.icid.value(), handle);
 }
 
 void EnhancedSessionCorrelator::updateMasterSession(const std::string& session_id,
@@ -721,14 +570,9 @@ void EnhancedSessionCorrelator::updateMasterSession(const std::string& session_i
 }
 
 EnhancedSessionType EnhancedSessionCorrelator::detectSessionType(const Session& session) const {
-    // Analyze message sequence to determine session type
-    auto all_messages = session.getAllMessages();
-
-    if (all_messages.empty()) {
-        return EnhancedSessionType::UNKNOWN;
-    }
-
-    // Count message types
+    // Only the interfaces matter here: read the compact records directly
+    // instead of expanding (and decoding) every message
+    bool has_messages = false;
     bool has_s1ap = false;
     bool has_ngap = false;
     bool has_x2ap = false;
@@ -737,25 +581,28 @@ EnhancedSessionType EnhancedSessionCorrelator::detectSessionType(const Session&
     bool has_sip = false;
     bool has_rtp = false;
 
-    for (const auto& msg : all_messages) {
-        // Check protocols
-        if (msg.interface == InterfaceType::S1_MME)
-            has_s1ap = true;
-        if (msg.interface == InterfaceType::N2)
-            has_ngap = true;
-        if (msg.interface == InterfaceType::X2)
-            has_x2ap = true;
-        if (msg.interface == InterfaceType::S1_U || msg.interface == InterfaceType::S11)
-            has_gtp = true;
-        if (msg.interface == InterfaceType::N4)
-            has_pfcp = true;
-        if (msg.interface == InterfaceType::IMS_SIP)
-            has_sip = true;
-        if (msg.interface == InterfaceType::IMS_RTP)
-            has_rtp = true;
-
-        // Check specific message types (would need proper message type enum extensions)
-        // For now, use simplified detection
+    for (const auto& leg : session.legs) {
+        for (const auto& msg : leg.messages) {
+            has_messages = true;
+            if (msg.interface == InterfaceType::S1_MME)
+                has_s1ap = true;
+            if (msg.interface == InterfaceType::N2)
+                has_ngap = true;
+            if (msg.interface == InterfaceType::X2)
+                has_x2ap = true;
+            if (msg.interface == InterfaceType::S1_U || msg.interface == InterfaceType::S11)
+                has_gtp = true;
+            if (msg.interface == InterfaceType::N4)
+                has_pfcp = true;
+            if (msg.interface == InterfaceType::IMS_SIP)
+                has_sip = true;
+            if (msg.interface == InterfaceType::IMS_RTP)
+                has_rtp = true;
+        }
+    }
+
+    if (!has_messages) {
+        return EnhancedSessionType::UNKNOWN;
     }
 
     // Detect session type based on protocol combination
@@ -821,23 +668,22 @@ std::string EnhancedSessionCorrelator::generateSessionId() const {
     return utils::generateUuid();
 }
 
-void EnhancedSessionCorrelator::mergeSessions(const std::string& session_id1,
-                                              const std::string& session_id2) {
-    auto it1 = sessions_.find(session_id1);
-    auto it2 = sessions_.find(session_id2);
+void EnhancedSessionCorrelator::mergeSessions(SessionHandle handle1, SessionHandle handle2) {
+    Session* session1_ptr = session_handles_[handle1];
+    Session* session2_ptr = session_handles_[handle2];
 
-    if (it1 == sessions_.end() || it2 == sessions_.end()) {
+    if (!session1_ptr || !session2_ptr) {
         LOG_ERROR("Cannot merge sessions: one or both not found");
         return;
     }
 
-    Session& session1 = it1->second;
-    Session& session2 = it2->second;
+    Session& session1 = *session1_ptr;
+    Session& session2 = *session2_ptr;
 
     // Merge session2 into session1
     for (const auto& leg : session2.legs) {
-        for (const auto& msg : leg.messages) {
-            session1.addMessage(msg);
+        for (const auto& record : leg.messages) {
+            session1.addMessage(leg.expand(record));
         }
     }
 
@@ -845,19 +691,13 @@ void EnhancedSessionCorrelator::mergeSessions(const std::string& session_id1,
     session1.correlation_key.merge(session2.correlation_key);
 
     // Update indices for session1
-    updateIndices(session_id1, session2.correlation_key);
+    updateIndices(handle1, session2.correlation_key);
 
-    // Clean up indices that point to session_id2
+    // Clean up indices that point to session2; entries added under keys of
+    // later messages are dropped lazily once the handle reads as stale
     const auto& key = session2.correlation_key;
-    auto remove_from_index = [&](auto& index_map, const auto& key_val) {
-        if (index_map.count(key_val)) {
-            auto& sessions = index_map[key_val];
-            sessions.erase(std::remove(sessions.begin(), sessions.end(), session_id2),
-                           sessions.end());
-            if (sessions.empty()) {
-                index_map.erase(key_val);
-            }
-        }
+    auto remove_from_index = [&](auto& index, const auto& key_val) {
+        index.remove(key_val, handle2);
     };
 
     if (key.imsi.has_value())
@@ -884,9 +724,11 @@ void EnhancedSessionCorrelator::mergeSessions(const std::string& session_id1,
         remove_from_index(icid_index_, key.icid.value());
 
     // Remove session2
-    sessions_.erase(session_id2);
+    std::string merged_id = session2.session_id;
+    session_handles_[handle2] = nullptr;
+    sessions_.erase(merged_id);
 
-    LOG_INFO("Merged session " << session_id2 << " into " << session_id1);
+    LOG_INFO("Merged session " << merged_id << " into " << session1.session_id);
 }
 
 callflow::SessionCorrelationKey callflow::EnhancedSessionCorrelator::extractCorrelationKey(
@@ -1296,6 +1138,12 @@ nlohmann::json EnhancedSessionCorrelator::exportAllSessions() const {
     return all_sessions;
 }
 
+void EnhancedSessionCorrelator::forEachSipOnlySession(
+    const std::function<void(const nlohmann::json&)>& callback) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    sip_only_manager_->forEachExportedSession(callback);
+}
+
 void callflow::EnhancedSessionCorrelator::processSipMessage(const SipMessage& msg,
                                                             const PacketMetadata& packet) {
     // 1. Update Dialog Tracker
@@ -2,7 +2,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <set>
+#include <type_traits>
+#include <utility>
 
 namespace callflow {
 
@@ -306,7 +309,7 @@ std::string SessionCorrelationKey::getPrimaryIdentifier() const {
 nlohmann::json SessionMessageRef::toJson() const {
     nlohmann::json j;
     j["message_id"] = message_id;
-    j["packet_id"] = packet_id;
+    j["packet_id"] = packetIdToString(packet_id);
     j["timestamp"] =
         std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
     j["interface"] = interfaceTypeToString(interface);
@@ -332,30 +335,341 @@ nlohmann::json SessionMessageRef::toJson() const {
 }
 
 // ============================================================================
-// SessionLeg Methods
+// StoredMessage blob encoding
 // ============================================================================
 
-nlohmann::json SessionLeg::toJson() const {
+namespace {
+
+// Presence bits of a StoredMessage blob. The blob starts with the 32-bit
+// mask, followed by each present field in bit order: strings as a LEB128
+// length plus bytes, integers in native byte order.
+enum BlobField : uint32_t {
+    kImsi = 1u << 0,
+    kSupi = 1u << 1,
+    kGuti = 1u << 2,
+    kMsisdn = 1u << 3,
+    kTeidS1u = 1u << 4,
+    kTeidS5u = 1u << 5,
+    kSeidN4 = 1u << 6,
+    kPduSessionId = 1u << 7,
+    kEpsBearerId = 1u << 8,
+    kEnbUeS1apId = 1u << 9,
+    kMmeUeS1apId = 1u << 10,
+    kRanUeNgapId = 1u << 11,
+    kAmfUeNgapId = 1u << 12,
+    kUeIpv4 = 1u << 13,
+    kUeIpv6 = 1u << 14,
+    kPgwUpfIp = 1u << 15,
+    kApn = 1u << 16,
+    kDnn = 1u << 17,
+    kNetworkInstance = 1u << 18,
+    kSipCallId = 1u << 19,
+    kIcid = 1u << 20,
+    kRtpSsrc = 1u << 21,
+    kProcedureType = 1u << 22,
+    kMessageIdUuid = 1u << 23,  // Canonical lowercase UUID packed into 16 bytes
+    kMessageIdText = 1u << 24,
+    kSrcIpText = 1u << 25,  // Address text that IpAddress cannot reproduce
+    kDstIpText = 1u << 26,
+    kParsedData = 1u << 27  // MessagePack
+};
+
+template <typename Key, typename Fn>
+void forEachKeyField(Key& key, Fn&& fn) {
+    fn(kImsi, key.imsi);
+    fn(kSupi, key.supi);
+    fn(kGuti, key.guti);
+    fn(kMsisdn, key.msisdn);
+    fn(kTeidS1u, key.teid_s1u);
+    fn(kTeidS5u, key.teid_s5u);
+    fn(kSeidN4, key.seid_n4);
+    fn(kPduSessionId, key.pdu_session_id);
+    fn(kEpsBearerId, key.eps_bearer_id);
+    fn(kEnbUeS1apId, key.enb_ue_s1ap_id);
+    fn(kMmeUeS1apId, key.mme_ue_s1ap_id);
+    fn(kRanUeNgapId, key.ran_ue_ngap_id);
+    fn(kAmfUeNgapId, key.amf_ue_ngap_id);
+    fn(kUeIpv4, key.ue_ipv4);
+    fn(kUeIpv6, key.ue_ipv6);
+    fn(kPgwUpfIp, key.pgw_upf_ip);
+    fn(kApn, key.apn);
+    fn(kDnn, key.dnn);
+    fn(kNetworkInstance, key.network_instance);
+    fn(kSipCallId, key.sip_call_id);
+    fn(kIcid, key.icid);
+    fn(kRtpSsrc, key.rtp_ssrc);
+    fn(kProcedureType, key.procedure_type);
+}
+
+class BlobWriter {
+public:
+    explicit BlobWriter(std::pmr::string& out) : out_(out) {}
+
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void putBytes(const void* data, size_t length) {
+        out_.append(static_cast<const char*>(data), length);
+    }
+
+    void put(const std::string& value) {
+        size_t length = value.size();
+        while (length >= 0x80) {
+            out_.push_back(static_cast<char>(length | 0x80));
+            length >>= 7;
+        }
+        out_.push_back(static_cast<char>(length));
+        out_.append(value);
+    }
+
+private:
+    std::pmr::string& out_;
+};
+
+class BlobReader {
+public:
+    BlobReader(const char* data, size_t length) : pos_(data), end_(data + length) {}
+
+    template <typename T>
+    void get(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(&value, pos_, sizeof(value));
+        pos_ += sizeof(value);
+    }
+
+    void getBytes(void* data, size_t length) {
+        std::memcpy(data, pos_, length);
+        pos_ += length;
+    }
+
+    void get(std::string& value) {
+        size_t length = 0;
+        for (int shift = 0; pos_ < end_; shift += 7) {
+            auto byte = static_cast<uint8_t>(*pos_++);
+            length |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        value.assign(pos_, length);
+        pos_ += length;
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+};
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// Pack a UUID as produced by utils::generateUuid() (8-4-4-4-12 lowercase hex)
+bool packUuid(const std::string& text, uint8_t (&out)[16]) {
+    if (text.size() != 36) {
+        return false;
+    }
+    size_t byte = 0;
+    for (size_t i = 0; i < 36;) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (text[i++] != '-') {
+                return false;
+            }
+            continue;
+        }
+        int hi = hexValue(text[i]);
+        int lo = hexValue(text[i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[byte++] = static_cast<uint8_t>(hi << 4 | lo);
+        i += 2;
+    }
+    return true;
+}
+
+std::string unpackUuid(const uint8_t (&bytes)[16]) {
+    static const char kHex[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(36);
+    for (size_t i = 0; i < 16; ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            text.push_back('-');
+        }
+        text.push_back(kHex[bytes[i] >> 4]);
+        text.push_back(kHex[bytes[i] & 0x0F]);
+    }
+    return text;
+}
+
+// Binary form of an address, or unset if its text would not come back as-is
+IpAddress compactIp(const std::string& text) {
+    IpAddress ip = IpAddress::fromString(text);
+    if (ip.isValid() && ip.toString() != text) {
+        return IpAddress{};
+    }
+    return ip;
+}
+
+// Leg fields other than the expanded messages
+nlohmann::json legSummaryJson(const SessionLeg& leg) {
     nlohmann::json j;
-    j["interface"] = interfaceTypeToString(interface);
-    j["message_count"] = messages.size();
-    j["total_bytes"] = total_bytes;
+    j["interface"] = interfaceTypeToString(leg.interface);
+    j["message_count"] = leg.messages.size();
+    j["total_bytes"] = leg.total_bytes;
     j["start_time"] =
-        std::chrono::duration_cast<std::chrono::milliseconds>(start_time.time_since_epoch())
+        std::chrono::duration_cast<std::chrono::milliseconds>(leg.start_time.time_since_epoch())
             .count();
     j["end_time"] =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end_time.time_since_epoch()).count();
-    j["duration_ms"] = getDurationMs();
+        std::chrono::duration_cast<std::chrono::milliseconds>(leg.end_time.time_since_epoch())
+            .count();
+    j["duration_ms"] = leg.getDurationMs();
+    return j;
+}
+
+}  // namespace
+
+// ============================================================================
+// SessionLeg Methods
+// ============================================================================
+
+nlohmann::json SessionLeg::toJson() const {
+    nlohmann::json j = legSummaryJson(*this);
 
     nlohmann::json msgs_json = nlohmann::json::array();
-    for (const auto& msg : messages) {
-        msgs_json.push_back(msg.toJson());
+    for (const auto& record : messages) {
+        msgs_json.push_back(expand(record).toJson());
     }
     j["messages"] = msgs_json;
 
     return j;
 }
 
+void SessionLeg::append(const SessionMessageRef& msg) {
+    StoredMessage record;
+    record.packet_id = msg.packet_id;
+    record.timestamp = msg.timestamp;
+    record.src_ip = compactIp(msg.src_ip);
+    record.dst_ip = compactIp(msg.dst_ip);
+    record.src_port = msg.src_port;
+    record.dst_port = msg.dst_port;
+    record.interface = msg.interface;
+    record.protocol = msg.protocol;
+    record.message_type = msg.message_type;
+    record.sequence_in_session = msg.sequence_in_session;
+    record.payload_length = msg.payload_length;
+
+    size_t start = blobs.size();
+    uint32_t mask = 0;
+    BlobWriter writer(blobs);
+    writer.put(mask);  // Patched below
+
+    forEachKeyField(msg.correlation_key, [&](uint32_t bit, const auto& field) {
+        if (field.has_value()) {
+            mask |= bit;
+            writer.put(field.value());
+        }
+    });
+
+    uint8_t uuid[16];
+    if (packUuid(msg.message_id, uuid)) {
+        mask |= kMessageIdUuid;
+        writer.putBytes(uuid, sizeof(uuid));
+    } else if (!msg.message_id.empty()) {
+        mask |= kMessageIdText;
+        writer.put(msg.message_id);
+    }
+    if (!record.src_ip.isValid() && !msg.src_ip.empty()) {
+        mask |= kSrcIpText;
+        writer.put(msg.src_ip);
+    }
+    if (!record.dst_ip.isValid() && !msg.dst_ip.empty()) {
+        mask |= kDstIpText;
+        writer.put(msg.dst_ip);
+    }
+    if (!msg.parsed_data.is_null()) {
+        mask |= kParsedData;
+        auto packed = nlohmann::json::to_msgpack(msg.parsed_data);
+        writer.put(std::string(packed.begin(), packed.end()));
+    }
+
+    if (mask == 0) {
+        blobs.resize(start);
+    } else {
+        std::memcpy(&blobs[start], &mask, sizeof(mask));
+        record.blob_offset = static_cast<uint32_t>(start);
+        record.blob_length = static_cast<uint32_t>(blobs.size() - start);
+    }
+    messages.push_back(record);
+}
+
+SessionMessageRef SessionLeg::expand(const StoredMessage& record) const {
+    SessionMessageRef msg;
+    msg.packet_id = record.packet_id;
+    msg.timestamp = record.timestamp;
+    msg.interface = record.interface;
+    msg.protocol = record.protocol;
+    msg.message_type = record.message_type;
+    msg.sequence_in_session = record.sequence_in_session;
+    msg.payload_length = record.payload_length;
+    msg.src_ip = record.src_ip.toString();
+    msg.dst_ip = record.dst_ip.toString();
+    msg.src_port = record.src_port;
+    msg.dst_port = record.dst_port;
+
+    if (record.blob_length == 0) {
+        return msg;
+    }
+
+    BlobReader reader(blobs.data() + record.blob_offset, record.blob_length);
+    uint32_t mask = 0;
+    reader.get(mask);
+
+    forEachKeyField(msg.correlation_key, [&](uint32_t bit, auto& field) {
+        if (mask & bit) {
+            typename std::decay_t<decltype(field)>::value_type value{};
+            reader.get(value);
+            field = std::move(value);
+        }
+    });
+
+    if (mask & kMessageIdUuid) {
+        uint8_t uuid[16];
+        reader.getBytes(uuid, sizeof(uuid));
+        msg.message_id = unpackUuid(uuid);
+    } else if (mask & kMessageIdText) {
+        reader.get(msg.message_id);
+    }
+    if (mask & kSrcIpText) {
+        reader.get(msg.src_ip);
+    }
+    if (mask & kDstIpText) {
+        reader.get(msg.dst_ip);
+    }
+    if (mask & kParsedData) {
+        std::string packed;
+        reader.get(packed);
+        msg.parsed_data = nlohmann::json::from_msgpack(packed);
+    }
+    return msg;
+}
+
+std::vector<SessionMessageRef> SessionLeg::expandAll() const {
+    std::vector<SessionMessageRef> result;
+    result.reserve(messages.size());
+    for (const auto& record : messages) {
+        result.push_back(expand(record));
+    }
+    return result;
+}
+
 uint64_t SessionLeg::getDurationMs() const {
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     return duration.count();
@@ -397,10 +711,23 @@ nlohmann::json Session::toJson() const {
     }
     j["interfaces_involved"] = ifaces_json;
 
-    // Add legs
+    // Expand every message once: the legs, the flattened events and the
+    // participants below all reuse it
+    std::vector<std::pair<Timestamp, nlohmann::json>> events;
+    std::set<std::string> participants_set;
     nlohmann::json legs_json = nlohmann::json::array();
     for (const auto& leg : legs) {
-        legs_json.push_back(leg.toJson());
+        nlohmann::json leg_json = legSummaryJson(leg);
+        nlohmann::json msgs_json = nlohmann::json::array();
+        for (const auto& record : leg.messages) {
+            SessionMessageRef msg = leg.expand(record);
+            participants_set.insert(msg.src_ip + ":" + std::to_string(msg.src_port));
+            participants_set.insert(msg.dst_ip + ":" + std::to_string(msg.dst_port));
+            msgs_json.push_back(msg.toJson());
+            events.emplace_back(msg.timestamp, msgs_json.back());
+        }
+        leg_json["messages"] = std::move(msgs_json);
+        legs_json.push_back(std::move(leg_json));
     }
     j["legs"] = legs_json;
     j["leg_count"] = legs.size();
@@ -411,13 +738,14 @@ nlohmann::json Session::toJson() const {
     }
 
     // Add flattened events array for frontend compatibility (merging all legs)
+    std::stable_sort(events.begin(), events.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
     nlohmann::json events_json = nlohmann::json::array();
-    auto all_msgs = getAllMessages();
-    for (const auto& msg : all_msgs) {
-        events_json.push_back(msg.toJson());
+    for (auto& event : events) {
+        events_json.push_back(std::move(event.second));
     }
     j["events"] = events_json;
-    j["events_count"] = all_msgs.size();
+    j["events_count"] = events.size();
 
     // Add list of protocols involved (unique)
     std::vector<std::string> protocols;
@@ -451,12 +779,7 @@ nlohmann::json Session::toJson() const {
     }
     j["metrics"] = metrics;
 
-    // Extract unique participants (IP:port combinations) for UI compatibility
-    std::set<std::string> participants_set;
-    for (const auto& msg : all_msgs) {
-        participants_set.insert(msg.src_ip + ":" + std::to_string(msg.src_port));
-        participants_set.insert(msg.dst_ip + ":" + std::to_string(msg.dst_port));
-    }
+    // Unique participants (IP:port combinations) for UI compatibility
     nlohmann::json participants_json = nlohmann::json::array();
     for (const auto& p : participants_set) {
         participants_json.push_back(p);
@@ -470,7 +793,9 @@ std::vector<SessionMessageRef> Session::getAllMessages() const {
     std::vector<SessionMessageRef> all_messages;
 
     for (const auto& leg : legs) {
-        all_messages.insert(all_messages.end(), leg.messages.begin(), leg.messages.end());
+        for (const auto& record : leg.messages) {
+            all_messages.push_back(leg.expand(record));
+        }
     }
 
     // Sort by timestamp
@@ -485,7 +810,7 @@ std::vector<SessionMessageRef> Session::getAllMessages() const {
 std::vector<SessionMessageRef> Session::getMessagesForInterface(InterfaceType interface) const {
     for (const auto& leg : legs) {
         if (leg.interface == interface) {
-            return leg.messages;
+            return leg.expandAll();
         }
     }
     return {};
@@ -508,12 +833,12 @@ void Session::addMessage(const SessionMessageRef& msg) {
 
     if (!target_leg) {
         // Create new leg
-        SessionLeg new_leg;
+        SessionLeg new_leg(legs.get_allocator().resource());
         new_leg.interface = msg.interface;
         new_leg.start_time = msg.timestamp;
         new_leg.end_time = msg.timestamp;
         new_leg.total_bytes = 0;
-        legs.push_back(new_leg);
+        legs.push_back(std::move(new_leg));
         target_leg = &legs.back();
 
         // Add to interfaces_involved if not already there
@@ -524,7 +849,7 @@ void Session::addMessage(const SessionMessageRef& msg) {
     }
 
     // Add message to leg
-    target_leg->messages.push_back(msg);
+    target_leg->append(msg);
 
     // Update leg timestamps
     if (msg.timestamp < target_leg->start_time) {
@@ -553,7 +878,7 @@ void Session::finalize() {
     // Sort messages in each leg by timestamp
     for (auto& leg : legs) {
         std::sort(leg.messages.begin(), leg.messages.end(),
-                  [](const SessionMessageRef& a, const SessionMessageRef& b) {
+                  [](const StoredMessage& a, const StoredMessage& b) {
                       return a.timestamp < b.timestamp;
                   });
 
@@ -2,6 +2,7 @@
 
 #include <arpa/inet.h>
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 
@@ -121,12 +122,20 @@ static const uint32_t crc32c_table[256] = {
     0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69, 0xD5CF889D, 0x27A40B9E,
     0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351};
 
-static uint32_t crc32c(const uint8_t* data, size_t len) {
-    uint32_t crc = 0xFFFFFFFF;
+static uint32_t crc32cUpdate(uint32_t crc, const uint8_t* data, size_t len) {
     for (size_t i = 0; i < len; ++i) {
         crc = crc32c_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
     }
-    return ~crc;
+    return crc;
+}
+
+static uint16_t readUint16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+static uint32_t readUint32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | data[3];
 }
 
 // ============================================================================
@@ -340,80 +349,22 @@ std::optional<SctpPacket> SctpParser::parse(const uint8_t* data, size_t len,
         return std::nullopt;
     }
 
-    // Update statistics
-    total_packets_parsed_++;
-    total_bytes_parsed_ += len;
+    processChunks(data, len, five_tuple);
 
-    // Get or create association
-    auto& assoc = getOrCreateAssociation(five_tuple, packet.header.verification_tag);
-    assoc.packets_received++;
-    assoc.bytes_received += len;
-
-    // Process all chunks for state transitions
-    for (const auto& chunk : packet.chunks) {
-        auto chunk_type = static_cast<SctpChunkType>(chunk.type);
-
-        switch (chunk_type) {
-            case SctpChunkType::INIT:
-                if (packet.init_chunk.has_value()) {
-                    const auto& init = packet.init_chunk.value();
-                    assoc.peer_verification_tag = init.initiate_tag;
-                    assoc.num_inbound_streams = init.num_outbound_streams;
-                    assoc.num_outbound_streams = init.num_inbound_streams;
-                    assoc.peer_tsn = init.initial_tsn;
-                    updateAssociationState(assoc, SctpChunkType::INIT);
-                }
-                break;
-            case SctpChunkType::INIT_ACK:
-                updateAssociationState(assoc, SctpChunkType::INIT_ACK);
-                break;
-            case SctpChunkType::COOKIE_ECHO:
-                updateAssociationState(assoc, SctpChunkType::COOKIE_ECHO);
-                break;
-            case SctpChunkType::COOKIE_ACK:
-                updateAssociationState(assoc, SctpChunkType::COOKIE_ACK);
-                break;
-            case SctpChunkType::SHUTDOWN:
-                updateAssociationState(assoc, SctpChunkType::SHUTDOWN);
-                break;
-            case SctpChunkType::SHUTDOWN_ACK:
-                updateAssociationState(assoc, SctpChunkType::SHUTDOWN_ACK);
-                break;
-            case SctpChunkType::SHUTDOWN_COMPLETE:
-                updateAssociationState(assoc, SctpChunkType::SHUTDOWN_COMPLETE);
-                break;
-            case SctpChunkType::HEARTBEAT:
-                LOG_DEBUG("SCTP Association " << assoc.association_id
-                                              << " | HEARTBEAT chunk received");
-                break;
-            case SctpChunkType::HEARTBEAT_ACK:
-                LOG_DEBUG("SCTP Association " << assoc.association_id
-                                              << " | HEARTBEAT_ACK chunk received");
-                break;
-            case SctpChunkType::ABORT:
-                LOG_WARN("SCTP Association " << assoc.association_id
-                                             << " | ABORT chunk received - connection aborted");
-                assoc.state = SctpAssociationState::CLOSED;
-                break;
-            default:
-                break;
-        }
-    }
+    LOG_DEBUG("Parsed SCTP packet with " << packet.chunks.size() << " chunks");
 
-    // Process data chunks
-    if (!packet.data_chunks.empty()) {
-        assoc.data_chunks_received += packet.data_chunks.size();
-        processDataChunks(assoc, packet.data_chunks);
-    }
+    return packet;
+}
 
-    // Process SACK chunks
-    if (!packet.sack_chunks.empty()) {
-        processSackChunks(assoc, packet.sack_chunks);
+bool SctpParser::process(const uint8_t* data, size_t len, const FiveTuple& five_tuple) {
+    if (!isSctp(data, len)) {
+        LOG_DEBUG("Not a valid SCTP packet");
+        parse_errors_++;
+        return false;
     }
 
-    LOG_DEBUG("Parsed SCTP packet with " << packet.chunks.size() << " chunks");
-
-    return packet;
+    processChunks(data, len, five_tuple);
+    return true;
 }
 
 void SctpParser::setMessageCallback(SctpMessageCallback callback) {
@@ -425,7 +376,7 @@ std::optional<SctpAssociation> SctpParser::getAssociation(uint32_t association_i
     if (it == associations_.end()) {
         return std::nullopt;
     }
-    return it->second;
+    return it->second.association;
 }
 
 std::vector<uint32_t> SctpParser::getAssociationIds() const {
@@ -434,15 +385,16 @@ std::vector<uint32_t> SctpParser::getAssociationIds() const {
     for (const auto& pair : associations_) {
         ids.push_back(pair.first);
     }
+    std::sort(ids.begin(), ids.end());
     return ids;
 }
 
 std::optional<SctpStreamReassembler> SctpParser::getReassembler(uint32_t association_id) const {
-    auto it = reassemblers_.find(association_id);
-    if (it == reassemblers_.end()) {
+    auto it = associations_.find(association_id);
+    if (it == associations_.end()) {
         return std::nullopt;
     }
-    return it->second;
+    return it->second.reassembler;
 }
 
 nlohmann::json SctpParser::getStatistics() const {
@@ -454,8 +406,8 @@ nlohmann::json SctpParser::getStatistics() const {
     j["active_associations"] = associations_.size();
 
     nlohmann::json assocs_json = nlohmann::json::array();
-    for (const auto& pair : associations_) {
-        assocs_json.push_back(pair.second.toJson());
+    for (uint32_t id : getAssociationIds()) {
+        assocs_json.push_back(associations_.at(id).association.toJson());
     }
     j["associations"] = assocs_json;
 
@@ -464,7 +416,6 @@ nlohmann::json SctpParser::getStatistics() const {
 
 void SctpParser::clear() {
     associations_.clear();
-    reassemblers_.clear();
     total_packets_parsed_ = 0;
     total_bytes_parsed_ = 0;
     total_associations_ = 0;
@@ -510,8 +461,9 @@ bool SctpParser::parseChunks(const uint8_t* data, size_t len, size_t offset, Sct
         std::memcpy(&chunk_length, data + offset + 2, 2);
         chunk_length = ntohs(chunk_length);
 
-        // Check if we have the full chunk
-        if (offset + chunk_length > len) {
+        // Check if we have the full chunk; a length below the chunk header
+        // would never advance
+        if (chunk_length < 4 || offset + chunk_length > len) {
             LOG_DEBUG("Incomplete chunk at offset " << offset);
             break;
         }
@@ -676,21 +628,20 @@ std::optional<SctpInitChunk> SctpParser::parseInitChunk(const uint8_t* data, siz
     return chunk;
 }
 
-SctpAssociation& SctpParser::getOrCreateAssociation(const FiveTuple& five_tuple,
-                                                    uint32_t verification_tag) {
+SctpParser::AssociationContext& SctpParser::getOrCreateAssociation(const FiveTuple& five_tuple,
+                                                                   uint32_t verification_tag) {
     uint32_t assoc_id = calculateAssociationId(five_tuple);
 
     auto it = associations_.find(assoc_id);
     if (it == associations_.end()) {
         // Create new association
-        SctpAssociation assoc;
-        assoc.association_id = assoc_id;
-        assoc.source_port = five_tuple.src_port;
-        assoc.dest_port = five_tuple.dst_port;
-        assoc.peer_verification_tag = verification_tag;
+        AssociationContext context;
+        context.association.association_id = assoc_id;
+        context.association.source_port = five_tuple.src_port;
+        context.association.dest_port = five_tuple.dst_port;
+        context.association.peer_verification_tag = verification_tag;
 
-        auto result = associations_.emplace(assoc_id, assoc);
-        reassemblers_.emplace(assoc_id, SctpStreamReassembler());
+        auto result = associations_.emplace(assoc_id, std::move(context));
 
         total_associations_++;
         return result.first->second;
@@ -761,79 +712,85 @@ void SctpParser::updateAssociationState(SctpAssociation& assoc, SctpChunkType ch
     }
 }
 
-void SctpParser::processDataChunks(SctpAssociation& assoc,
-                                   const std::vector<SctpDataChunk>& data_chunks) {
-    auto it = reassemblers_.find(assoc.association_id);
-    if (it == reassemblers_.end()) {
-        return;
-    }
-
-    auto& reassembler = it->second;
-
-    for (const auto& data_chunk : data_chunks) {
-        auto fragment = data_chunk.toFragment();
-
-        // Log fragment details
-        LOG_DEBUG("SCTP Association "
-                  << assoc.association_id << " | Stream " << fragment.stream_id
-                  << " | TSN=" << fragment.tsn << " SSN=" << fragment.stream_sequence
-                  << " PPID=" << fragment.payload_protocol << " ("
-                  << getSctpPpidName(fragment.payload_protocol) << ")"
-                  << " | Flags: " << (fragment.beginning ? "B" : "-")
-                  << (fragment.ending ? "E" : "-") << (fragment.unordered ? "U" : "-")
-                  << " | Data: " << fragment.data.size() << " bytes");
+void SctpParser::processChunks(const uint8_t* data, size_t len, const FiveTuple& five_tuple) {
+    total_packets_parsed_++;
+    total_bytes_parsed_ += len;
 
-        auto msg_opt = reassembler.addFragment(fragment);
+    auto& context = getOrCreateAssociation(five_tuple, readUint32(data + 4));
+    auto& assoc = context.association;
+    assoc.packets_received++;
+    assoc.bytes_received += len;
 
-        if (msg_opt.has_value() && message_callback_) {
-            const auto& msg = msg_opt.value();
-            LOG_INFO("SCTP Association "
-                     << assoc.association_id << " | Stream " << msg.stream_id
-                     << " | SSN=" << msg.stream_sequence << " | Reassembled complete message"
-                     << " | PPID=" << msg.payload_protocol << " ("
-                     << getSctpPpidName(msg.payload_protocol) << ")"
-                     << " | TSN range: " << msg.start_tsn << "-" << msg.end_tsn << " | Fragments: "
-                     << msg.fragment_count << " | Total size: " << msg.data.size() << " bytes");
-            message_callback_(msg);
+    size_t offset = 12;
+    while (offset + 4 <= len) {
+        const uint8_t* chunk = data + offset;
+        uint16_t chunk_length = readUint16(chunk + 2);
+        if (chunk_length < 4 || offset + chunk_length > len) {
+            break;
         }
-    }
 
-    // Check for additional complete messages
-    while (reassembler.hasCompleteMessages()) {
-        auto msg_opt = reassembler.getCompleteMessage();
-        if (msg_opt.has_value() && message_callback_) {
-            const auto& msg = msg_opt.value();
-            LOG_INFO("SCTP Association "
-                     << assoc.association_id << " | Retrieved buffered complete message"
-                     << " | Stream " << msg.stream_id << " | SSN=" << msg.stream_sequence);
-            message_callback_(msg);
+        auto chunk_type = static_cast<SctpChunkType>(chunk[0]);
+        switch (chunk_type) {
+            case SctpChunkType::DATA:
+                if (chunk_length >= 16) {
+                    SctpDataChunkView view;
+                    view.unordered = (chunk[1] & 0x04) != 0;
+                    view.beginning = (chunk[1] & 0x02) != 0;
+                    view.ending = (chunk[1] & 0x01) != 0;
+                    view.tsn = readUint32(chunk + 4);
+                    view.stream_id = readUint16(chunk + 8);
+                    view.stream_sequence = readUint16(chunk + 10);
+                    view.payload_protocol = readUint32(chunk + 12);
+                    view.data = ByteView(chunk + 16, chunk_length - 16);
+
+                    assoc.data_chunks_received++;
+                    context.reassembler.addChunk(view, message_callback_);
+                }
+                break;
+            case SctpChunkType::SACK:
+                // Gap Ack Blocks acknowledge the peer's receipt of TSNs sent
+                // in the other direction, so they say nothing about fragments
+                // buffered for this one
+                if (chunk_length >= 16) {
+                    assoc.cumulative_tsn_ack = readUint32(chunk + 4);
+                }
+                break;
+            case SctpChunkType::INIT:
+                if (auto init = parseInitChunk(chunk, chunk_length)) {
+                    assoc.peer_verification_tag = init->initiate_tag;
+                    assoc.num_inbound_streams = init->num_outbound_streams;
+                    assoc.num_outbound_streams = init->num_inbound_streams;
+                    assoc.peer_tsn = init->initial_tsn;
+                    updateAssociationState(assoc, SctpChunkType::INIT);
+                }
+                break;
+            case SctpChunkType::INIT_ACK:
+            case SctpChunkType::COOKIE_ECHO:
+            case SctpChunkType::COOKIE_ACK:
+            case SctpChunkType::SHUTDOWN:
+            case SctpChunkType::SHUTDOWN_ACK:
+            case SctpChunkType::SHUTDOWN_COMPLETE:
+                updateAssociationState(assoc, chunk_type);
+                break;
+            case SctpChunkType::HEARTBEAT:
+                LOG_DEBUG("SCTP Association " << assoc.association_id
+                                              << " | HEARTBEAT chunk received");
+                break;
+            case SctpChunkType::HEARTBEAT_ACK:
+                LOG_DEBUG("SCTP Association " << assoc.association_id
+                                              << " | HEARTBEAT_ACK chunk received");
+                break;
+            case SctpChunkType::ABORT:
+                LOG_WARN("SCTP Association " << assoc.association_id
+                                             << " | ABORT chunk received - connection aborted");
+                assoc.state = SctpAssociationState::CLOSED;
+                break;
+            default:
+                break;
         }
-    }
-}
-
-void SctpParser::processSackChunks(SctpAssociation& assoc,
-                                   const std::vector<SctpSackChunk>& sack_chunks) {
-    auto it = reassemblers_.find(assoc.association_id);
-    if (it == reassemblers_.end()) {
-        return;
-    }
 
-    auto& reassembler = it->second;
-
-    for (const auto& sack : sack_chunks) {
-        assoc.cumulative_tsn_ack = sack.cumulative_tsn_ack;
-
-        // Handle gaps - these indicate packet loss
-        for (const auto& gap : sack.gap_ack_blocks) {
-            uint32_t gap_start = sack.cumulative_tsn_ack + gap.first;
-            uint32_t gap_end = sack.cumulative_tsn_ack + gap.second;
-
-            // Notify all streams about the gap
-            auto stream_ids = reassembler.getStreamIds();
-            for (uint16_t stream_id : stream_ids) {
-                reassembler.handleGap(stream_id, gap_start, gap_end);
-            }
-        }
+        // Move to next chunk (aligned to 4-byte boundary)
+        offset += (chunk_length + 3) & ~3;
     }
 }
 
@@ -852,16 +809,12 @@ bool SctpParser::verifyChecksum(const uint8_t* data, size_t len) {
     std::memcpy(&packet_checksum, data + 8, 4);
     packet_checksum = ntohl(packet_checksum);
 
-    // Create a copy with checksum field set to 0
-    std::vector<uint8_t> data_copy(data, data + len);
-    // Zero out the checksum field (bytes 8-11)
-    data_copy[8] = 0;
-    data_copy[9] = 0;
-    data_copy[10] = 0;
-    data_copy[11] = 0;
-
-    // Calculate CRC32C
-    uint32_t calculated_checksum = crc32c(data_copy.data(), len);
+    // CRC32C over the packet with the checksum field taken as zero
+    static const uint8_t zero_checksum[4] = {0, 0, 0, 0};
+    uint32_t crc = crc32cUpdate(0xFFFFFFFF, data, 8);
+    crc = crc32cUpdate(crc, zero_checksum, 4);
+    crc = crc32cUpdate(crc, data + 12, len - 12);
+    uint32_t calculated_checksum = ~crc;
 
     return calculated_checksum == packet_checksum;
 }
@@ -29,7 +29,7 @@ nlohmann::json SctpReassembledMessage::toJson() const {
     j["stream_id"] = stream_id;
     j["stream_sequence"] = stream_sequence;
     j["payload_protocol"] = payload_protocol;
-    j["data_length"] = data.size();
+    j["data_length"] = payload().size();
     j["start_tsn"] = start_tsn;
     j["end_tsn"] = end_tsn;
     j["fragment_count"] = fragment_count;
@@ -49,30 +49,110 @@ nlohmann::json SctpStreamContext::toJson() const {
     j["bytes_received"] = bytes_received;
     j["fragments_received"] = fragments_received;
     j["out_of_order_count"] = out_of_order_count;
-    j["pending_fragments_count"] = pending_fragments.size();
-    j["unordered_buffer_count"] = unordered_buffer.size();
+    j["buffered_fragments"] = buffered_fragments;
+    j["buffered_bytes"] = buffered_bytes;
+    j["held_messages"] = held_messages.size();
+    j["skipped_ssns"] = skipped_ssns;
     return j;
 }
 
+namespace {
+
+// Serial number arithmetic (RFC 1982): TSNs and SSNs wrap
+bool tsnBefore(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+bool ssnBefore(uint16_t a, uint16_t b) {
+    return static_cast<int16_t>(static_cast<uint16_t>(a - b)) < 0;
+}
+
+}  // namespace
+
 // ============================================================================
 // SctpStreamReassembler Methods
 // ============================================================================
 
 std::optional<SctpReassembledMessage> SctpStreamReassembler::addFragment(
     const SctpDataFragment& fragment) {
+    SctpDataChunkView chunk;
+    chunk.stream_id = fragment.stream_id;
+    chunk.tsn = fragment.tsn;
+    chunk.stream_sequence = fragment.stream_sequence;
+    chunk.payload_protocol = fragment.payload_protocol;
+    chunk.unordered = fragment.unordered;
+    chunk.beginning = fragment.beginning;
+    chunk.ending = fragment.ending;
+    chunk.data = ByteView(fragment.data);
+
+    std::optional<SctpReassembledMessage> first;
+    addChunk(chunk, [&](const SctpReassembledMessage& msg) {
+        SctpReassembledMessage owned = msg;
+        if (owned.data.empty()) {
+            owned.data.assign(msg.view.begin(), msg.view.end());
+        }
+        owned.view = ByteView();
+        if (!first) {
+            first = std::move(owned);
+        } else {
+            complete_messages_.push(std::move(owned));
+        }
+    });
+    return first;
+}
 
+size_t SctpStreamReassembler::addChunk(const SctpDataChunkView& chunk,
+                                       const SctpMessageCallback& deliver) {
     total_fragments_++;
+    trackTsn(chunk.tsn);
 
-    auto& stream = getOrCreateStream(fragment.stream_id);
+    auto& stream = getOrCreateStream(chunk.stream_id);
     stream.fragments_received++;
-    stream.bytes_received += fragment.data.size();
+    stream.bytes_received += chunk.data.size();
+
+    if (!chunk.unordered) {
+        if (stream.ssn_synced) {
+            if (ssnBefore(chunk.stream_sequence,
+                          static_cast<uint16_t>(stream.next_expected_ssn))) {
+                // Already delivered or skipped: retransmission
+                stream.out_of_order_count++;
+                return 0;
+            }
+        } else if (chunk.beginning) {
+            // A capture may start mid-association, so the first message seen
+            // sets the sequence
+            stream.next_expected_ssn = chunk.stream_sequence;
+            stream.ssn_synced = true;
+        }
+    }
 
-    // Handle unordered vs ordered fragments
-    if (fragment.unordered) {
-        return handleUnorderedFragment(stream, fragment);
+    size_t delivered = 0;
+    if (chunk.beginning && chunk.ending) {
+        SctpReassembledMessage msg;
+        msg.stream_id = chunk.stream_id;
+        msg.stream_sequence = chunk.stream_sequence;
+        msg.payload_protocol = chunk.payload_protocol;
+        msg.view = chunk.data;
+        msg.start_tsn = chunk.tsn;
+        msg.end_tsn = chunk.tsn;
+        msg.fragment_count = 1;
+        delivered = deliverOrHold(stream, msg, chunk.unordered, deliver);
     } else {
-        return handleOrderedFragment(stream, fragment);
+        size_t slot = storeFragment(stream, chunk);
+        if (slot == SIZE_MAX) {
+            return 0;
+        }
+        SctpReassembledMessage msg;
+        bool unordered = false;
+        if (tryAssemble(stream, slot, msg, unordered)) {
+            delivered = deliverOrHold(stream, msg, unordered, deliver);
+        }
+    }
+
+    if (buffered_bytes_ > memory_budget_) {
+        delivered += enforceBudget(deliver);
     }
+    return delivered;
 }
 
 bool SctpStreamReassembler::hasCompleteMessages() const {
@@ -84,7 +164,7 @@ std::optional<SctpReassembledMessage> SctpStreamReassembler::getCompleteMessage(
         return std::nullopt;
     }
 
-    auto msg = complete_messages_.front();
+    auto msg = std::move(complete_messages_.front());
     complete_messages_.pop();
     return msg;
 }
@@ -97,29 +177,36 @@ void SctpStreamReassembler::handleGap(uint16_t stream_id, uint32_t gap_start, ui
         return;
     }
 
-    auto& stream = it->second;
-
-    // Remove any fragments in the gap range from unordered buffer
-    auto buf_it = stream.unordered_buffer.begin();
-    while (buf_it != stream.unordered_buffer.end()) {
-        if (buf_it->first >= gap_start && buf_it->first <= gap_end) {
-            buf_it = stream.unordered_buffer.erase(buf_it);
-        } else {
-            ++buf_it;
+    for (auto& slot : it->second.fragments) {
+        if (slot.used && !tsnBefore(slot.tsn, gap_start) && !tsnBefore(gap_end, slot.tsn)) {
+            freeSlot(it->second, slot);
+            dropped_fragments_++;
         }
     }
-
-    // Note: For ordered fragments in pending_fragments, we may need to skip
-    // the affected SSNs if they were part of the gap. This is application-specific.
 }
 
 void SctpStreamReassembler::resetStream(uint16_t stream_id) {
     auto it = streams_.find(stream_id);
-    if (it != streams_.end()) {
-        it->second.state = SctpStreamState::RESET_PENDING;
-        it->second.pending_fragments.clear();
-        it->second.unordered_buffer.clear();
+    if (it == streams_.end()) {
+        return;
+    }
+
+    auto& stream = it->second;
+    stream.state = SctpStreamState::RESET_PENDING;
+    for (auto& slot : stream.fragments) {
+        if (slot.used) {
+            freeSlot(stream, slot);
+        }
+    }
+    for (const auto& held : stream.held_messages) {
+        buffered_bytes_ -= held.data.size();
+        stream.buffered_bytes -= held.data.size();
     }
+    stream.held_messages.clear();
+
+    // SSNs restart at 0 after a reset (RFC 6525); resync on the next message
+    stream.next_expected_ssn = 0;
+    stream.ssn_synced = false;
 }
 
 std::optional<SctpStreamContext> SctpStreamReassembler::getStreamContext(uint16_t stream_id) const {
@@ -136,6 +223,7 @@ std::vector<uint16_t> SctpStreamReassembler::getStreamIds() const {
     for (const auto& pair : streams_) {
         ids.push_back(pair.first);
     }
+    std::sort(ids.begin(), ids.end());
     return ids;
 }
 
@@ -145,13 +233,18 @@ nlohmann::json SctpStreamReassembler::getStatistics() const {
     j["total_messages"] = total_messages_;
     j["total_bytes"] = total_bytes_;
     j["total_gaps"] = total_gaps_;
+    j["tsn_gaps"] = tsn_gaps_;
+    j["missing_tsns"] = missing_tsns_;
+    j["budget_evictions"] = budget_evictions_;
+    j["dropped_fragments"] = dropped_fragments_;
+    j["buffered_bytes"] = buffered_bytes_;
     j["stream_count"] = streams_.size();
     j["pending_messages"] = complete_messages_.size();
 
     // Per-stream statistics
     nlohmann::json streams_json = nlohmann::json::array();
-    for (const auto& pair : streams_) {
-        streams_json.push_back(pair.second.toJson());
+    for (uint16_t id : getStreamIds()) {
+        streams_json.push_back(streams_.at(id).toJson());
     }
     j["streams"] = streams_json;
 
@@ -163,10 +256,18 @@ void SctpStreamReassembler::clear() {
     while (!complete_messages_.empty()) {
         complete_messages_.pop();
     }
+    assembly_.clear();
+    buffered_bytes_ = 0;
+    tsn_seen_ = false;
+    highest_tsn_ = 0;
     total_fragments_ = 0;
     total_messages_ = 0;
     total_bytes_ = 0;
     total_gaps_ = 0;
+    tsn_gaps_ = 0;
+    missing_tsns_ = 0;
+    budget_evictions_ = 0;
+    dropped_fragments_ = 0;
 }
 
 // ============================================================================
@@ -182,203 +283,235 @@ SctpStreamContext& SctpStreamReassembler::getOrCreateStream(uint16_t stream_id)
     return it->second;
 }
 
-std::optional<SctpReassembledMessage> SctpStreamReassembler::handleUnorderedFragment(
-    SctpStreamContext& stream, const SctpDataFragment& fragment) {
-
-    // For unordered delivery, we can process fragments immediately
-    // if they form a complete message (B and E flags both set)
-
-    if (fragment.beginning && fragment.ending) {
-        // Single-fragment message
-        SctpReassembledMessage msg;
-        msg.stream_id = fragment.stream_id;
-        msg.stream_sequence = fragment.stream_sequence;
-        msg.payload_protocol = fragment.payload_protocol;
-        msg.data = fragment.data;
-        msg.start_tsn = fragment.tsn;
-        msg.end_tsn = fragment.tsn;
-        msg.fragment_count = 1;
-
-        stream.messages_received++;
-        total_messages_++;
-        total_bytes_ += msg.data.size();
-
-        complete_messages_.push(msg);
-        return msg;
+void SctpStreamReassembler::trackTsn(uint32_t tsn) {
+    if (!tsn_seen_) {
+        tsn_seen_ = true;
+        highest_tsn_ = tsn;
+        return;
     }
-
-    // Multi-fragment unordered message
-    // Store in unordered buffer and try to reassemble by TSN sequence
-    stream.unordered_buffer[fragment.tsn] = fragment;
-
-    // Try to find a complete sequence
-    // Look for B flag fragment, then consecutive TSNs until E flag
-    for (const auto& pair : stream.unordered_buffer) {
-        const auto& start_frag = pair.second;
-
-        if (!start_frag.beginning) {
-            continue;  // Not a start fragment
-        }
-
-        // Try to build a complete message from this start
-        std::vector<SctpDataFragment> fragments;
-        fragments.push_back(start_frag);
-
-        uint32_t expected_tsn = start_frag.tsn + 1;
-        bool complete = start_frag.ending;
-
-        while (!complete) {
-            auto next_it = stream.unordered_buffer.find(expected_tsn);
-            if (next_it == stream.unordered_buffer.end()) {
-                break;  // Missing fragment
-            }
-
-            fragments.push_back(next_it->second);
-            complete = next_it->second.ending;
-            expected_tsn++;
-        }
-
-        if (complete) {
-            // We have a complete message
-            auto msg = assembleFragments(fragments);
-
-            // Remove fragments from buffer
-            for (const auto& frag : fragments) {
-                stream.unordered_buffer.erase(frag.tsn);
-            }
-
-            stream.messages_received++;
-            total_messages_++;
-            total_bytes_ += msg.data.size();
-
-            complete_messages_.push(msg);
-            return msg;
+    if (tsnBefore(highest_tsn_, tsn)) {
+        uint32_t missing = tsn - highest_tsn_ - 1;
+        if (missing > 0) {
+            tsn_gaps_++;
+            missing_tsns_ += missing;
         }
+        highest_tsn_ = tsn;
     }
-
-    return std::nullopt;
 }
 
-std::optional<SctpReassembledMessage> SctpStreamReassembler::handleOrderedFragment(
-    SctpStreamContext& stream, const SctpDataFragment& fragment) {
+size_t SctpStreamReassembler::deliverOrHold(SctpStreamContext& stream,
+                                            const SctpReassembledMessage& msg, bool unordered,
+                                            const SctpMessageCallback& deliver) {
+    if (unordered) {
+        emit(stream, msg, deliver);
+        return 1;
+    }
 
-    // For ordered delivery, we must respect the Stream Sequence Number (SSN)
+    const uint16_t expected = static_cast<uint16_t>(stream.next_expected_ssn);
+    if (msg.stream_sequence == expected) {
+        stream.next_expected_ssn = static_cast<uint16_t>(expected + 1);
+        emit(stream, msg, deliver);
+        return 1 + releaseHeld(stream, deliver);
+    }
 
-    // Check if this is the next expected SSN
-    if (fragment.stream_sequence < stream.next_expected_ssn) {
-        // Out-of-order or duplicate, ignore
+    // An earlier SSN is missing: keep an owned copy in SSN order
+    auto& held = stream.held_messages;
+    auto pos = std::find_if(held.begin(), held.end(), [&](const SctpReassembledMessage& h) {
+        return !ssnBefore(h.stream_sequence, msg.stream_sequence);
+    });
+    if (pos != held.end() && pos->stream_sequence == msg.stream_sequence) {
         stream.out_of_order_count++;
-        return std::nullopt;
+        return 0;
     }
+    SctpReassembledMessage& copy = *held.insert(pos, msg);
+    if (copy.data.empty()) {
+        copy.data.assign(msg.view.begin(), msg.view.end());
+    }
+    copy.view = ByteView();
+    stream.buffered_bytes += copy.data.size();
+    buffered_bytes_ += copy.data.size();
 
-    // Add fragment to pending list for this SSN
-    auto& fragments = stream.pending_fragments[fragment.stream_sequence];
-    fragments.push_back(fragment);
-
-    // Sort fragments by TSN to ensure correct order
-    std::sort(fragments.begin(), fragments.end(),
-              [](const SctpDataFragment& a, const SctpDataFragment& b) {
-                  return a.tsn < b.tsn;
-              });
-
-    // Check if we can reassemble the message at the next expected SSN
-    while (true) {
-        auto it = stream.pending_fragments.find(stream.next_expected_ssn);
-        if (it == stream.pending_fragments.end()) {
-            break;  // No fragments for next expected SSN
-        }
-
-        auto& frags = it->second;
-        if (!isMessageComplete(frags)) {
-            break;  // Message not complete yet
-        }
-
-        // Reassemble and deliver
-        auto msg = assembleFragments(frags);
-
-        stream.pending_fragments.erase(it);
-        stream.next_expected_ssn++;
-        stream.messages_received++;
-        total_messages_++;
-        total_bytes_ += msg.data.size();
+    if (held.size() <= kMaxHeldMessages) {
+        return 0;
+    }
 
-        complete_messages_.push(msg);
+    // Too many waiting: give up on the missing SSNs
+    stream.skipped_ssns += static_cast<uint16_t>(held.front().stream_sequence - expected);
+    stream.next_expected_ssn = held.front().stream_sequence;
+    return releaseHeld(stream, deliver);
+}
 
-        // Continue checking for next SSN
+void SctpStreamReassembler::emit(SctpStreamContext& stream, const SctpReassembledMessage& msg,
+                                 const SctpMessageCallback& deliver) {
+    stream.messages_received++;
+    total_messages_++;
+    total_bytes_ += msg.payload().size();
+    if (deliver) {
+        deliver(msg);
     }
+}
 
-    // Return the first complete message if available
-    if (hasCompleteMessages()) {
-        return getCompleteMessage();
+size_t SctpStreamReassembler::releaseHeld(SctpStreamContext& stream,
+                                          const SctpMessageCallback& deliver) {
+    size_t released = 0;
+    auto& held = stream.held_messages;
+    while (!held.empty() && held.front().stream_sequence == stream.next_expected_ssn) {
+        SctpReassembledMessage msg = std::move(held.front());
+        held.erase(held.begin());
+        stream.buffered_bytes -= msg.data.size();
+        buffered_bytes_ -= msg.data.size();
+        stream.next_expected_ssn = static_cast<uint16_t>(stream.next_expected_ssn + 1);
+        emit(stream, msg, deliver);
+        released++;
     }
-
-    return std::nullopt;
+    return released;
 }
 
-bool SctpStreamReassembler::isMessageComplete(const std::vector<SctpDataFragment>& fragments) const {
-    if (fragments.empty()) {
-        return false;
+size_t SctpStreamReassembler::storeFragment(SctpStreamContext& stream,
+                                            const SctpDataChunkView& chunk) {
+    if (stream.fragments.empty()) {
+        stream.fragments.resize(8);
     }
 
-    // Check for B flag in first fragment and E flag in last fragment
-    bool has_beginning = false;
-    bool has_ending = false;
-
-    for (const auto& frag : fragments) {
-        if (frag.beginning) {
-            has_beginning = true;
+    size_t index = chunk.tsn & (stream.fragments.size() - 1);
+    while (stream.fragments[index].used) {
+        SctpFragmentSlot& occupant = stream.fragments[index];
+        if (occupant.tsn == chunk.tsn) {
+            // Retransmitted fragment
+            stream.out_of_order_count++;
+            return SIZE_MAX;
         }
-        if (frag.ending) {
-            has_ending = true;
+        if (stream.fragments.size() < kMaxRingSlots) {
+            growRing(stream);
+            index = chunk.tsn & (stream.fragments.size() - 1);
+            continue;
         }
+        // The window is full; the occupant is kMaxRingSlots TSNs away from
+        // this fragment and its message will not complete
+        freeSlot(stream, occupant);
+        dropped_fragments_++;
     }
 
-    if (!has_beginning || !has_ending) {
-        return false;
-    }
+    SctpFragmentSlot& slot = stream.fragments[index];
+    slot.used = true;
+    slot.unordered = chunk.unordered;
+    slot.beginning = chunk.beginning;
+    slot.ending = chunk.ending;
+    slot.tsn = chunk.tsn;
+    slot.stream_sequence = chunk.stream_sequence;
+    slot.payload_protocol = chunk.payload_protocol;
+    slot.data.assign(chunk.data.begin(), chunk.data.end());
+
+    stream.buffered_fragments++;
+    stream.buffered_bytes += slot.data.size();
+    buffered_bytes_ += slot.data.size();
+    return index;
+}
 
-    // Check that fragments form a contiguous sequence
-    // Note: Fragments should already be sorted by TSN
-    for (size_t i = 1; i < fragments.size(); ++i) {
-        if (fragments[i].tsn != fragments[i-1].tsn + 1) {
-            return false;  // Gap in sequence
+void SctpStreamReassembler::growRing(SctpStreamContext& stream) {
+    std::vector<SctpFragmentSlot> grown(stream.fragments.size() * 2);
+    const size_t mask = grown.size() - 1;
+    for (auto& slot : stream.fragments) {
+        if (!slot.used) {
+            continue;
+        }
+        SctpFragmentSlot& target = grown[slot.tsn & mask];
+        if (target.used) {
+            SctpFragmentSlot& older = tsnBefore(target.tsn, slot.tsn) ? target : slot;
+            freeSlot(stream, older);
+            dropped_fragments_++;
+            if (!slot.used) {
+                continue;
+            }
         }
+        target = std::move(slot);
     }
-
-    return true;
+    stream.fragments.swap(grown);
 }
 
-SctpReassembledMessage SctpStreamReassembler::assembleFragments(
-    const std::vector<SctpDataFragment>& fragments) {
-
-    SctpReassembledMessage msg;
-
-    if (fragments.empty()) {
-        return msg;
+bool SctpStreamReassembler::tryAssemble(SctpStreamContext& stream, size_t slot,
+                                        SctpReassembledMessage& msg, bool& unordered) {
+    auto& ring = stream.fragments;
+    const size_t mask = ring.size() - 1;
+    const SctpFragmentSlot& anchor = ring[slot];
+
+    // Neighbouring fragments belong to the same message if they carry the
+    // same flags and, when ordered, the same SSN
+    auto sameMessage = [&](const SctpFragmentSlot& other, uint32_t tsn) {
+        return other.used && other.tsn == tsn && other.unordered == anchor.unordered &&
+               (anchor.unordered || other.stream_sequence == anchor.stream_sequence);
+    };
+
+    uint32_t first = anchor.tsn;
+    for (const SctpFragmentSlot* cur = &anchor; !cur->beginning;) {
+        const SctpFragmentSlot& prev = ring[(first - 1) & mask];
+        if (!sameMessage(prev, first - 1) || prev.ending) {
+            return false;
+        }
+        cur = &prev;
+        first--;
     }
-
-    const auto& first = fragments.front();
-    const auto& last = fragments.back();
-
-    msg.stream_id = first.stream_id;
-    msg.stream_sequence = first.stream_sequence;
-    msg.payload_protocol = first.payload_protocol;
-    msg.start_tsn = first.tsn;
-    msg.end_tsn = last.tsn;
-    msg.fragment_count = fragments.size();
-
-    // Concatenate fragment data
-    size_t total_size = 0;
-    for (const auto& frag : fragments) {
-        total_size += frag.data.size();
+    uint32_t last = anchor.tsn;
+    for (const SctpFragmentSlot* cur = &anchor; !cur->ending;) {
+        const SctpFragmentSlot& next = ring[(last + 1) & mask];
+        if (!sameMessage(next, last + 1) || next.beginning) {
+            return false;
+        }
+        cur = &next;
+        last++;
     }
 
-    msg.data.reserve(total_size);
-    for (const auto& frag : fragments) {
-        msg.data.insert(msg.data.end(), frag.data.begin(), frag.data.end());
+    const SctpFragmentSlot& head = ring[first & mask];
+    msg.stream_id = stream.stream_id;
+    msg.stream_sequence = head.stream_sequence;
+    msg.payload_protocol = head.payload_protocol;
+    msg.start_tsn = first;
+    msg.end_tsn = last;
+    msg.fragment_count = static_cast<size_t>(last - first) + 1;
+    unordered = head.unordered;
+
+    assembly_.clear();
+    for (uint32_t tsn = first;; ++tsn) {
+        SctpFragmentSlot& frag = ring[tsn & mask];
+        assembly_.insert(assembly_.end(), frag.data.begin(), frag.data.end());
+        freeSlot(stream, frag);
+        if (tsn == last) {
+            break;
+        }
     }
+    msg.view = ByteView(assembly_);
+    return true;
+}
 
-    return msg;
+void SctpStreamReassembler::freeSlot(SctpStreamContext& stream, SctpFragmentSlot& slot) {
+    stream.buffered_fragments--;
+    stream.buffered_bytes -= slot.data.size();
+    buffered_bytes_ -= slot.data.size();
+    slot.used = false;
+    slot.data.clear();
+}
+
+size_t SctpStreamReassembler::enforceBudget(const SctpMessageCallback& deliver) {
+    budget_evictions_++;
+
+    size_t delivered = 0;
+    for (auto& pair : streams_) {
+        auto& stream = pair.second;
+        while (!stream.held_messages.empty()) {
+            uint16_t next = stream.held_messages.front().stream_sequence;
+            stream.skipped_ssns +=
+                static_cast<uint16_t>(next - static_cast<uint16_t>(stream.next_expected_ssn));
+            stream.next_expected_ssn = next;
+            delivered += releaseHeld(stream, deliver);
+        }
+        for (auto& slot : stream.fragments) {
+            if (slot.used) {
+                freeSlot(stream, slot);
+                dropped_fragments_++;
+            }
+        }
+    }
+    return delivered;
 }
 
 }  // namespace callflow
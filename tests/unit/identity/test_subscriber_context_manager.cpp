@@ -297,6 +297,40 @@ TEST_F(SubscriberContextManagerTest, LinkImsiTmsi) {
     EXPECT_EQ(context.get(), context_by_tmsi.get());
 }
 
+TEST_F(SubscriberContextManagerTest, ReallocatedTmsiDropsOldIndexEntry) {
+    std::string imsi = "310410123456789";
+    manager_->linkImsiTmsi(imsi, 0x11111111);
+    manager_->linkImsiTmsi(imsi, 0x22222222);
+
+    auto context = manager_->findByImsi(imsi);
+    ASSERT_NE(context, nullptr);
+    EXPECT_EQ(*context->tmsi, 0x22222222u);
+    EXPECT_EQ(manager_->findByTmsi(0x22222222).get(), context.get());
+    EXPECT_EQ(manager_->findByTmsi(0x11111111), nullptr);
+
+    // The old TMSI handed to another UE must not join it to this subscriber
+    manager_->linkImsiTmsi("310410987654321", 0x11111111);
+    EXPECT_NE(manager_->findByTmsi(0x11111111).get(), context.get());
+    EXPECT_EQ(manager_->getAllContexts().size(), 2u);
+}
+
+TEST_F(SubscriberContextManagerTest, ReplacedImsiAndMsisdnDropOldIndexEntries) {
+    std::string ip = "10.0.0.1";
+    manager_->linkImsiUeIp("310410123456789", ip);
+    manager_->linkImsiUeIp("310410111111111", ip);  // IMSI replaced via the shared IP
+
+    auto context = manager_->findByUeIp(ip);
+    ASSERT_NE(context, nullptr);
+    EXPECT_EQ(context->imsi->digits, "310410111111111");
+    EXPECT_EQ(manager_->findByImsi("310410111111111").get(), context.get());
+    EXPECT_EQ(manager_->findByImsi("310410123456789"), nullptr);
+
+    manager_->linkMsisdnUeIp("+12345678901", ip);
+    manager_->linkMsisdnUeIp("+12345678902", ip);
+    EXPECT_EQ(manager_->findByMsisdn("+12345678902").get(), context.get());
+    EXPECT_EQ(manager_->findByMsisdn("+12345678901"), nullptr);
+}
+
 // ============================================================================
 // GTP-U Tunnel Tests
 // ============================================================================
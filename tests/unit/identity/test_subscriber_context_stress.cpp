@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "correlation/identity/subscriber_context_manager.h"
+
+using namespace callflow::correlation;
+
+namespace {
+
+constexpr uint32_t kSubscribers = 1000000;
+constexpr uint32_t kLinksPerSubscriber = 5;
+
+struct Subscriber {
+    std::string imsi;
+    std::string msisdn;
+    std::string imei;
+    std::string ue_ip;
+    uint32_t tmsi;
+};
+
+Subscriber makeSubscriber(uint32_t i) {
+    char buf[32];
+    Subscriber sub;
+    std::snprintf(buf, sizeof(buf), "00101%010u", i);
+    sub.imsi = buf;
+    std::snprintf(buf, sizeof(buf), "4915%09u", i);
+    sub.msisdn = buf;
+    std::snprintf(buf, sizeof(buf), "35%012u", i);  // IMEI without check digit
+    sub.imei = buf;
+    std::snprintf(buf, sizeof(buf), "10.%u.%u.%u", i >> 16, (i >> 8) & 0xFF, i & 0xFF);
+    sub.ue_ip = buf;
+    sub.tmsi = 0xC0000000u | i;
+    return sub;
+}
+
+void applyLink(SubscriberContextManager& manager, const Subscriber& sub, uint32_t link) {
+    switch (link) {
+        case 0:
+            manager.linkImsiMsisdn(sub.imsi, sub.msisdn);
+            break;
+        case 1:
+            manager.linkImsiImei(sub.imsi, sub.imei);
+            break;
+        case 2:
+            manager.linkMsisdnUeIp(sub.msisdn, sub.ue_ip);
+            break;
+        case 3:
+            manager.linkImsiUeIp(sub.imsi, sub.ue_ip);
+            break;
+        default:
+            manager.linkImsiTmsi(sub.imsi, sub.tmsi);
+            break;
+    }
+}
+
+}  // namespace
+
+/**
+ * 5M link events for 1M subscribers in shuffled order. Most subscribers
+ * first appear as several unrelated contexts (e.g. MSISDN+IP and IMSI+IMEI)
+ * that later links have to merge; every identifier must end up resolving
+ * to one context per subscriber.
+ */
+TEST(SubscriberContextStressTest, FiveMillionShuffledLinks) {
+    std::vector<Subscriber> subs;
+    subs.reserve(kSubscribers);
+    for (uint32_t i = 0; i < kSubscribers; ++i) {
+        subs.push_back(makeSubscriber(i));
+    }
+
+    std::vector<uint32_t> events(kSubscribers * kLinksPerSubscriber);
+    std::iota(events.begin(), events.end(), 0);
+    std::shuffle(events.begin(), events.end(), std::mt19937(13));
+
+    SubscriberContextManager manager;
+    for (uint32_t event : events) {
+        applyLink(manager, subs[event / kLinksPerSubscriber], event % kLinksPerSubscriber);
+    }
+    manager.propagateIdentities();
+
+    auto stats = manager.getStats();
+    EXPECT_EQ(stats.total_contexts, kSubscribers);
+    EXPECT_EQ(stats.contexts_with_imsi, kSubscribers);
+    EXPECT_EQ(stats.contexts_with_msisdn, kSubscribers);
+    EXPECT_EQ(stats.contexts_with_imei, kSubscribers);
+    EXPECT_EQ(stats.contexts_with_ue_ip, kSubscribers);
+    EXPECT_GT(stats.merge_operations, 0u);
+    EXPECT_EQ(manager.getAllContexts().size(), kSubscribers);
+
+    for (uint32_t i = 0; i < kSubscribers; i += 997) {
+        const Subscriber& sub = subs[i];
+        auto context = manager.findByImsi(sub.imsi);
+        ASSERT_NE(context, nullptr) << sub.imsi;
+        EXPECT_EQ(context, manager.findByMsisdn(sub.msisdn));
+        EXPECT_EQ(context, manager.findByImei(sub.imei));
+        EXPECT_EQ(context, manager.findByUeIp(sub.ue_ip));
+        EXPECT_EQ(context, manager.findByTmsi(sub.tmsi));
+        ASSERT_TRUE(context->imsi.has_value());
+        EXPECT_EQ(context->imsi->digits, sub.imsi);
+        ASSERT_EQ(context->endpoints.size(), 1u);
+        EXPECT_EQ(context->endpoints[0].ipv4, sub.ue_ip);
+    }
+}
+
+/**
+ * A long chain of pairwise links collapses into one context whichever end
+ * the lookup starts from, and endpoints added outside the link calls are
+ * joined by propagation
+ */
+TEST(SubscriberContextStressTest, ChainAndEndpointPropagation) {
+    constexpr uint32_t kChain = 10000;
+    SubscriberContextManager manager;
+
+    // imsi[i] - ip[i] - msisdn[i] - ip[i+1]... : every link joins the chain
+    for (uint32_t i = 0; i < kChain; ++i) {
+        Subscriber sub = makeSubscriber(i);
+        Subscriber next = makeSubscriber(i + 1);
+        manager.linkImsiUeIp(sub.imsi, sub.ue_ip);
+        manager.linkMsisdnUeIp(sub.msisdn, sub.ue_ip);
+        manager.linkMsisdnUeIp(sub.msisdn, next.ue_ip);
+    }
+    EXPECT_EQ(manager.getStats().total_contexts, 1u);
+    EXPECT_EQ(manager.findByUeIp(makeSubscriber(0).ue_ip),
+              manager.findByUeIp(makeSubscriber(kChain).ue_ip));
+    // Each link replaced the context's IMSI; only the latest stays indexed
+    EXPECT_EQ(manager.findByImsi(makeSubscriber(kChain - 1).imsi),
+              manager.findByUeIp(makeSubscriber(0).ue_ip));
+    EXPECT_EQ(manager.findByImsi(makeSubscriber(0).imsi), nullptr);
+
+    // Two contexts sharing an address pushed directly onto their endpoints
+    auto a = manager.getOrCreateByImsi("001019999999990");
+    auto b = manager.getOrCreateByImsi("001019999999991");
+    NetworkEndpoint shared;
+    shared.ipv4 = "192.0.2.10";
+    a->endpoints.push_back(shared);
+    b->endpoints.push_back(shared);
+    EXPECT_EQ(manager.getStats().total_contexts, 3u);
+
+    manager.propagateIdentities();
+    EXPECT_EQ(manager.getStats().total_contexts, 2u);
+    EXPECT_EQ(manager.findByImsi("001019999999991"), a);
+    EXPECT_EQ(manager.findByUeIp("192.0.2.10"), a);
+    EXPECT_EQ(a->endpoints.size(), 1u);
+}
@@ -359,3 +359,111 @@ TEST_F(RtpStreamTest, UnknownCodec) {
 
     EXPECT_EQ(stream.getCodecName(), "unknown");
 }
+
+// ============================================================================
+// Streaming Accumulator Tests
+// ============================================================================
+
+TEST_F(RtpStreamTest, ReorderedPacketIsNotLost) {
+    auto pkt1 = createPacket(1, 1.0, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 1000, 8000, 12345);
+    RtpStream stream(pkt1);
+
+    stream.addPacket(createPacket(2, 1.02, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 1002, 8320, 12345));
+    stream.addPacket(createPacket(3, 1.03, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 1001, 8160, 12345));
+    // Late copy of an already reordered packet is a duplicate
+    stream.addPacket(createPacket(4, 1.04, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 1001, 8160, 12345));
+    stream.addPacket(createPacket(5, 1.06, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 1003, 8480, 12345));
+
+    auto metrics = stream.calculateMetrics();
+
+    EXPECT_EQ(metrics.packets_received, 5u);
+    EXPECT_EQ(metrics.packets_out_of_order, 1u);
+    EXPECT_EQ(metrics.packets_duplicated, 1u);
+    EXPECT_EQ(metrics.packets_lost, 0u);
+    EXPECT_EQ(metrics.last_seq, 1003);
+}
+
+TEST_F(RtpStreamTest, SenderRestartResyncsSequence) {
+    auto pkt1 = createPacket(1, 1.0, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 100, 8000, 12345);
+    RtpStream stream(pkt1);
+    stream.addPacket(createPacket(2, 1.02, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 101, 8160, 12345));
+
+    // Two consecutive packets far from the old numbering: new sequence space
+    for (uint16_t i = 0; i < 10; ++i) {
+        stream.addPacket(createPacket(3 + i, 1.04 + i * 0.02, "10.0.0.1", 5000, "10.0.0.2", 5001,
+                                      0, static_cast<uint16_t>(40000 + i), 8320 + i * 160, 12345));
+    }
+
+    auto metrics = stream.calculateMetrics();
+
+    EXPECT_EQ(metrics.packets_received, 12u);
+    EXPECT_EQ(metrics.packets_lost, 0u);
+}
+
+TEST_F(RtpStreamTest, HistogramsCoverEveryPacketAndInterval) {
+    auto pkt1 = createPacket(1, 0.0, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 0, 0, 12345);
+    RtpStream stream(pkt1);
+
+    // 12 seconds at 20 ms; the second 5 s interval drops every 10th packet
+    uint32_t frame = 2;
+    for (uint16_t seq = 1; seq < 600; ++seq) {
+        double ts = seq * 0.02;
+        if (ts >= 5.0 && ts < 10.0 && seq % 10 == 0) {
+            continue;
+        }
+        stream.addPacket(createPacket(frame++, ts, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, seq,
+                                      seq * 160u, 12345));
+    }
+
+    auto metrics = stream.calculateMetrics();
+
+    uint32_t jitter_samples = 0;
+    for (uint32_t count : metrics.jitter_histogram) {
+        jitter_samples += count;
+    }
+    EXPECT_EQ(jitter_samples, metrics.packets_received - 1);
+    EXPECT_EQ(metrics.jitter_histogram[0], jitter_samples);  // Perfect pacing
+
+    // Intervals: [0, 5) clean, [5, 10) 10% loss, [10, 12) clean (in progress)
+    EXPECT_EQ(metrics.loss_histogram[0], 2u);
+    EXPECT_EQ(metrics.loss_histogram[4], 1u);
+    EXPECT_EQ(metrics.packets_lost, 25u);
+}
+
+TEST_F(RtpStreamTest, PacketRetentionModes) {
+    auto feed = [&](const RtpPacketRetention& retention) {
+        auto pkt1 = createPacket(1, 1.0, "10.0.0.1", 5000, "10.0.0.2", 5001, 0, 0, 0, 12345);
+        RtpStream stream(pkt1, retention);
+        for (uint16_t seq = 1; seq < 1000; ++seq) {
+            stream.addPacket(createPacket(seq + 1, 1.0 + seq * 0.02, "10.0.0.1", 5000, "10.0.0.2",
+                                          5001, 0, seq, seq * 160u, 12345));
+        }
+        EXPECT_EQ(stream.getPacketCount(), 1000u);
+        EXPECT_EQ(stream.calculateMetrics().packets_lost, 0u);
+        return stream.getPackets();
+    };
+
+    RtpPacketRetention none;
+    none.mode = RtpPacketRetention::Mode::NONE;
+    EXPECT_TRUE(feed(none).empty());
+
+    RtpPacketRetention first;
+    first.mode = RtpPacketRetention::Mode::FIRST_N;
+    first.max_packets = 10;
+    auto first_packets = feed(first);
+    ASSERT_EQ(first_packets.size(), 10u);
+    EXPECT_EQ(first_packets.back().sequence_number, 9);
+
+    RtpPacketRetention sampled;
+    sampled.mode = RtpPacketRetention::Mode::SAMPLED;
+    sampled.sample_interval = 100;
+    sampled.max_packets = 5;
+    auto sampled_packets = feed(sampled);
+    ASSERT_EQ(sampled_packets.size(), 5u);
+    EXPECT_EQ(sampled_packets[1].sequence_number, 100);
+    EXPECT_EQ(sampled_packets[1].frame_number, 101u);
+
+    RtpPacketRetention all;
+    all.mode = RtpPacketRetention::Mode::ALL;
+    EXPECT_EQ(feed(all).size(), 1000u);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "persistence/database.h"
+#include "persistence/database_writer.h"
+
+using namespace callflow;
+
+namespace {
+
+class DatabaseWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() / "callflow_test_writer.db").string();
+        removeDatabase();
+
+        config_.path = path_;
+        config_.auto_vacuum = false;
+        config_.batch_size = 1000;
+        config_.writer_queue_max = 2000;
+        db_ = std::make_shared<DatabaseManager>(config_);
+        ASSERT_TRUE(db_->initialize());
+
+        JobInfo job;
+        job.job_id = "job-1";
+        job.input_filename = "capture.pcap";
+        job.status = JobStatus::COMPLETED;
+        job.progress = 100;
+        job.created_at = std::chrono::system_clock::now();
+        ASSERT_TRUE(db_->insertJob(job));
+    }
+
+    void TearDown() override {
+        db_->close();
+        removeDatabase();
+    }
+
+    void removeDatabase() {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path_ + suffix);
+        }
+    }
+
+    static SessionRecord makeSession(int i) {
+        SessionRecord session;
+        session.session_id = "session-" + std::to_string(i);
+        session.job_id = "job-1";
+        session.session_type = "SIP";
+        session.session_key = "call-" + std::to_string(i);
+        session.start_time = 1700000000000 + i;
+        session.participant_ips = "[]";
+        session.metadata = "{}";
+        return session;
+    }
+
+    static EventRecord makeEvent(const std::string& session_id, int i) {
+        EventRecord event;
+        event.session_id = session_id;
+        event.timestamp = 1700000000000 + i;
+        event.event_type = "message";
+        event.protocol = "SIP";
+        event.src_ip = "10.0.0.1";
+        event.dst_ip = "10.0.0.2";
+        event.message_type = "INVITE";
+        event.payload = "{}";
+        return event;
+    }
+
+    std::string path_;
+    DatabaseConfig config_;
+    std::shared_ptr<DatabaseManager> db_;
+};
+
+}  // namespace
+
+TEST_F(DatabaseWriterTest, InsertBatchSpansSeveralTransactions) {
+    std::vector<SessionRecord> sessions = {makeSession(0), makeSession(1)};
+    std::vector<EventRecord> events;
+    for (int i = 0; i < 2500; ++i) {
+        events.push_back(makeEvent(sessions[i % 2].session_id, i));
+    }
+
+    EXPECT_EQ(db_->insertBatch(sessions, events), sessions.size() + events.size());
+    EXPECT_GT(events.back().event_id, events.front().event_id);
+    EXPECT_EQ(db_->getEventCount("session-0"), 1250);
+    EXPECT_EQ(db_->getEventCount("session-1"), 1250);
+}
+
+TEST_F(DatabaseWriterTest, FailedRowsDoNotAbortTheBatch) {
+    // Duplicate primary key: the second copy fails, the rest still commit
+    std::vector<SessionRecord> sessions = {makeSession(0), makeSession(0), makeSession(1)};
+    EXPECT_FALSE(db_->insertSessions(sessions));
+    EXPECT_TRUE(db_->getSession("session-0").has_value());
+    EXPECT_TRUE(db_->getSession("session-1").has_value());
+
+    // The cached statement is still usable afterwards
+    EXPECT_TRUE(db_->insertSession(makeSession(2)));
+}
+
+TEST_F(DatabaseWriterTest, WriterDrainsQueueInBackground) {
+    DatabaseWriter writer(db_, config_);
+    EXPECT_FALSE(writer.enqueue(makeSession(0)));  // Not started yet
+
+    writer.start();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(writer.enqueue(makeSession(i)));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(writer.enqueue(makeEvent("session-" + std::to_string(i % 10), i)));
+    }
+    writer.flush();
+
+    auto stats = writer.getStats();
+    EXPECT_EQ(stats.rows_queued, 5010u);
+    EXPECT_EQ(stats.rows_written, 5010u);
+    EXPECT_EQ(stats.rows_failed, 0u);
+    EXPECT_GE(stats.batches, 6u);
+    EXPECT_EQ(db_->getEventCount("session-3"), 500);
+
+    // Rows still queued at stop() are written before the thread exits
+    ASSERT_TRUE(writer.enqueue(makeSession(99)));
+    writer.stop();
+    EXPECT_TRUE(db_->getSession("session-99").has_value());
+    EXPECT_FALSE(writer.enqueue(makeSession(100)));
+}
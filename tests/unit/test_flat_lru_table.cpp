@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "common/flat_lru_table.h"
+
+using namespace callflow;
+
+namespace {
+
+using Table = FlatLruTable<uint64_t, std::vector<int>>;
+
+// Few distinct hashes, so probe chains are long and wrap around the table
+uint32_t weakHash(uint64_t key) {
+    return static_cast<uint32_t>(key % 97);
+}
+
+}  // namespace
+
+TEST(FlatLruTableTest, MatchesReferenceMapUnderChurn) {
+    Table table(16);
+    std::unordered_map<uint64_t, uint32_t> reference;
+    std::mt19937 rng(42);
+
+    for (int step = 0; step < 200000; ++step) {
+        uint64_t key = rng() % 2000;
+        auto it = reference.find(key);
+        uint32_t id = table.find(key, weakHash(key));
+        if (it == reference.end()) {
+            ASSERT_EQ(id, Table::kNil) << key;
+            id = table.insert(key, weakHash(key));
+            reference.emplace(key, id);
+        } else {
+            ASSERT_EQ(id, it->second) << key;
+            ASSERT_EQ(table.key(id), key);
+            if (rng() % 2 == 0) {
+                table.erase(id);
+                reference.erase(it);
+            }
+        }
+        ASSERT_EQ(table.size(), reference.size());
+    }
+    for (const auto& [key, id] : reference) {
+        EXPECT_EQ(table.find(key, weakHash(key)), id);
+    }
+}
+
+TEST(FlatLruTableTest, OldestFollowsInsertAndTouchOrder) {
+    Table table(4);
+    uint32_t a = table.insert(1, 1);
+    uint32_t b = table.insert(2, 2);
+    uint32_t c = table.insert(3, 3);
+    EXPECT_EQ(table.oldest(), a);
+    EXPECT_EQ(table.newest(), c);
+
+    table.touch(a);
+    EXPECT_EQ(table.oldest(), b);
+    EXPECT_EQ(table.newest(), a);
+
+    table.erase(b);
+    EXPECT_EQ(table.oldest(), c);
+    table.erase(c);
+    table.erase(a);
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.oldest(), Table::kNil);
+    EXPECT_EQ(table.newest(), Table::kNil);
+}
+
+TEST(FlatLruTableTest, RecycledIdKeepsValue) {
+    Table table;
+    uint32_t id = table.insert(7, 7);
+    table[id].assign(100, 1);
+    table.erase(id);
+
+    uint32_t reused = table.insert(8, 8);
+    EXPECT_EQ(reused, id);
+    EXPECT_EQ(table[reused].size(), 100u);
+    EXPECT_EQ(table.find(7, 7), Table::kNil);
+    EXPECT_EQ(table.find(8, 8), reused);
+}
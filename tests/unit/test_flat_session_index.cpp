@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "session/flat_session_index.h"
+#include "session/session_correlator.h"
+
+using namespace callflow;
+
+namespace {
+
+std::vector<SessionHandle> toVector(const SessionHandleList* list) {
+    if (!list) {
+        return {};
+    }
+    return std::vector<SessionHandle>(list->begin(), list->end());
+}
+
+}  // namespace
+
+TEST(FlatSessionIndexTest, HandleListSpillsPastInlineCapacity) {
+    SessionHandleList list;
+    for (SessionHandle h = 0; h < 10; ++h) {
+        list.add(h);
+        list.add(h);  // Duplicates are ignored
+    }
+    EXPECT_EQ(list.size(), 10u);
+    EXPECT_GT(list.heapBytes(), 0u);
+
+    list.removeIf([](SessionHandle h) { return h % 2 == 0; });
+    EXPECT_EQ(std::vector<SessionHandle>(list.begin(), list.end()),
+              (std::vector<SessionHandle>{1, 3, 5, 7, 9}));
+    EXPECT_FALSE(list.contains(4));
+}
+
+TEST(FlatSessionIndexTest, MatchesReferenceMapUnderChurn) {
+    // Small key space so probe runs collide, grow and get shifted back on erase
+    FlatSessionIndex<uint32_t> index;
+    std::unordered_map<uint32_t, std::vector<SessionHandle>> reference;
+    std::mt19937 rng(7);
+
+    for (int op = 0; op < 200000; ++op) {
+        uint32_t key = rng() % 5000;
+        SessionHandle handle = rng() % 4;
+        auto& expected = reference[key];
+        if (rng() % 3 != 0) {
+            index.insert(key, handle);
+            if (std::find(expected.begin(), expected.end(), handle) == expected.end()) {
+                expected.push_back(handle);
+            }
+        } else {
+            index.remove(key, handle);
+            expected.erase(std::remove(expected.begin(), expected.end(), handle), expected.end());
+        }
+        if (expected.empty()) {
+            reference.erase(key);
+        }
+    }
+
+    EXPECT_EQ(index.size(), reference.size());
+    for (uint32_t key = 0; key < 5000; ++key) {
+        auto it = reference.find(key);
+        if (it == reference.end()) {
+            EXPECT_EQ(index.find(key), nullptr) << key;
+        } else {
+            EXPECT_EQ(toVector(index.find(key)), it->second) << key;
+        }
+    }
+}
+
+TEST(FlatSessionIndexTest, StringKeysAndClear) {
+    FlatSessionIndex<std::string> index;
+    index.reserve(1000);
+    size_t capacity = index.capacity();
+    for (int i = 0; i < 1000; ++i) {
+        index.insert("00101" + std::to_string(1000000000 + i), static_cast<SessionHandle>(i));
+    }
+    EXPECT_EQ(index.capacity(), capacity);  // reserve() avoided rehashing
+    EXPECT_EQ(toVector(index.find("001011000000042")), (std::vector<SessionHandle>{42}));
+    EXPECT_EQ(index.find("001019999999999"), nullptr);
+
+    index.erase("001011000000042");
+    EXPECT_EQ(index.find("001011000000042"), nullptr);
+    EXPECT_EQ(index.size(), 999u);
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.find("001011000000043"), nullptr);
+}
+
+TEST(FlatSessionIndexTest, CorrelatorMergesSessionsSharingKeys) {
+    EnhancedSessionCorrelator correlator;
+
+    SessionMessageRef gtp;
+    gtp.protocol = ProtocolType::GTP_C;
+    gtp.message_type = MessageType::GTP_CREATE_SESSION_REQ;
+    gtp.interface = InterfaceType::S11;
+    gtp.timestamp = std::chrono::system_clock::now();
+    gtp.correlation_key.imsi = "001010123456789";
+    gtp.correlation_key.teid_s1u = 0x1000;
+    correlator.addMessage(gtp);
+
+    SessionMessageRef pfcp;
+    pfcp.protocol = ProtocolType::PFCP;
+    pfcp.message_type = MessageType::PFCP_SESSION_ESTABLISHMENT_REQ;
+    pfcp.interface = InterfaceType::N4;
+    pfcp.timestamp = gtp.timestamp;
+    pfcp.correlation_key.seid_n4 = 0x2000;
+    correlator.addMessage(pfcp);
+    EXPECT_EQ(correlator.getSessionCount(), 2u);
+
+    // A message carrying both keys joins the two sessions into the older one
+    SessionMessageRef both = pfcp;
+    both.correlation_key.teid_s1u = 0x1000;
+    correlator.addMessage(both);
+    EXPECT_EQ(correlator.getSessionCount(), 1u);
+
+    auto by_imsi = correlator.correlateByImsi("001010123456789");
+    auto by_seid = correlator.correlateBySeid(0x2000);
+    ASSERT_EQ(by_imsi.size(), 1u);
+    ASSERT_EQ(by_seid.size(), 1u);
+    EXPECT_EQ(by_imsi[0].session_id, by_seid[0].session_id);
+    EXPECT_EQ(by_imsi[0].getAllMessages().size(), 3u);
+}
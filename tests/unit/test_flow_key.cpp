@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/types.h"
+#include "pcap_ingest/packet_processor.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr int DLT_RAW_IP = 12;
+
+std::vector<uint8_t> buildIpv4Tcp(uint32_t seq, uint8_t flags, const std::string& payload) {
+    std::vector<uint8_t> pkt(40 + payload.size(), 0);
+    size_t total = pkt.size();
+    pkt[0] = 0x45;
+    pkt[2] = static_cast<uint8_t>(total >> 8);
+    pkt[3] = static_cast<uint8_t>(total & 0xFF);
+    pkt[8] = 64;
+    pkt[9] = 6;  // TCP
+    const uint8_t src[] = {10, 0, 0, 1};
+    const uint8_t dst[] = {10, 0, 0, 2};
+    std::copy(src, src + 4, pkt.begin() + 12);
+    std::copy(dst, dst + 4, pkt.begin() + 16);
+    pkt[20] = 0x9C;  // 40000
+    pkt[21] = 0x40;
+    pkt[22] = 0x13;  // 5060
+    pkt[23] = 0xC4;
+    pkt[24] = static_cast<uint8_t>(seq >> 24);
+    pkt[25] = static_cast<uint8_t>(seq >> 16);
+    pkt[26] = static_cast<uint8_t>(seq >> 8);
+    pkt[27] = static_cast<uint8_t>(seq);
+    pkt[32] = 0x50;  // Data offset 5
+    pkt[33] = flags;
+    std::copy(payload.begin(), payload.end(), pkt.begin() + 40);
+    return pkt;
+}
+
+}  // namespace
+
+TEST(FlowKeyTest, RendersIpv4AndIpv6) {
+    const uint8_t v4[] = {192, 168, 1, 20};
+    const uint8_t v6[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01};
+
+    IpAddress a = IpAddress::fromV4(v4);
+    IpAddress b = IpAddress::fromV6(v6);
+
+    EXPECT_EQ(a.toString(), "192.168.1.20");
+    EXPECT_EQ(b.toString(), "2001:db8::1");
+    EXPECT_EQ(a.length(), 4u);
+    EXPECT_EQ(b.length(), 16u);
+    EXPECT_EQ(IpAddress{}.toString(), "");
+    EXPECT_FALSE(IpAddress{}.isValid());
+}
+
+TEST(FlowKeyTest, FamilyIsPartOfIdentity) {
+    // Identical bytes under different families are distinct addresses
+    const uint8_t v4[] = {10, 0, 0, 1};
+    uint8_t v6[16] = {10, 0, 0, 1};
+
+    IpAddress a = IpAddress::fromV4(v4);
+    IpAddress b = IpAddress::fromV6(v6);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(a < b || b < a);
+}
+
+TEST(FlowKeyTest, WorksAsHashKey) {
+    const uint8_t a[] = {10, 0, 0, 1};
+    const uint8_t b[] = {10, 0, 0, 2};
+
+    FlowKey fwd;
+    fwd.src_ip = IpAddress::fromV4(a);
+    fwd.dst_ip = IpAddress::fromV4(b);
+    fwd.src_port = 40000;
+    fwd.dst_port = 5060;
+    fwd.protocol = 6;
+
+    FlowKey rev = fwd;
+    std::swap(rev.src_ip, rev.dst_ip);
+    std::swap(rev.src_port, rev.dst_port);
+
+    std::unordered_map<FlowKey, int> table;
+    table[fwd] = 1;
+    table[rev] = 2;
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table[fwd], 1);
+
+    FiveTuple ft = fwd.toFiveTuple();
+    EXPECT_EQ(ft.src_ip, "10.0.0.1");
+    EXPECT_EQ(ft.dst_ip, "10.0.0.2");
+    EXPECT_EQ(ft.src_port, 40000);
+    EXPECT_EQ(ft.dst_port, 5060);
+    EXPECT_EQ(ft.protocol, 6);
+}
+
+TEST(FlowKeyTest, TcpSipReassemblyUsesBinaryKeys) {
+    std::string invite =
+        "INVITE sip:bob@example.com SIP/2.0\r\n"
+        "Via: SIP/2.0/TCP 10.0.0.1:40000;branch=z9hG4bK-tcp\r\n"
+        "From: <sip:alice@example.com>;tag=1\r\n"
+        "To: <sip:bob@example.com>\r\n"
+        "Call-ID: tcp-call-1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Content-Length: 0\r\n\r\n";
+    std::string first = invite.substr(0, 60);
+    std::string second = invite.substr(60);
+
+    EnhancedSessionCorrelator correlator;
+    PacketProcessor processor(correlator);
+    auto ts = std::chrono::system_clock::now();
+
+    auto syn = buildIpv4Tcp(1000, 0x02, "");
+    auto seg1 = buildIpv4Tcp(1001, 0x18, first);
+    auto seg2 = buildIpv4Tcp(1001 + static_cast<uint32_t>(first.size()), 0x18, second);
+    processor.processPacket(syn.data(), syn.size(), ts, 1, DLT_RAW_IP);
+    processor.processPacket(seg1.data(), seg1.size(), ts, 2, DLT_RAW_IP);
+    processor.processPacket(seg2.data(), seg2.size(), ts, 3, DLT_RAW_IP);
+
+    EXPECT_EQ(correlator.getSipOnlySessionCount(), 1u);
+}
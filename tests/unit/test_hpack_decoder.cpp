@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "protocol_parsers/hpack_huffman.h"
+#include "protocol_parsers/http2_parser.h"
+
+using namespace callflow;
+
+namespace {
+
+std::vector<uint8_t> fromHex(const std::string& hex) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<uint8_t>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+using Fields = std::vector<std::pair<std::string, std::string>>;
+
+Fields decode(HpackDecoder& decoder, const std::string& hex) {
+    auto block = fromHex(hex);
+    std::vector<HpackDecoder::HeaderField> views;
+    EXPECT_TRUE(decoder.decode(block.data(), block.size(), views));
+    Fields fields;
+    for (const auto& field : views) {
+        fields.emplace_back(field.name, field.value);
+    }
+    return fields;
+}
+
+}  // namespace
+
+// RFC 7541 C.4: requests with Huffman coding
+TEST(HpackDecoderTest, RfcRequestExamplesWithHuffman) {
+    HpackDecoder decoder;
+    EXPECT_EQ(decode(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff"),
+              (Fields{{":method", "GET"},
+                      {":scheme", "http"},
+                      {":path", "/"},
+                      {":authority", "www.example.com"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 57u);
+
+    EXPECT_EQ(decode(decoder, "828684be5886a8eb10649cbf"),
+              (Fields{{":method", "GET"},
+                      {":scheme", "http"},
+                      {":path", "/"},
+                      {":authority", "www.example.com"},
+                      {"cache-control", "no-cache"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 110u);
+
+    EXPECT_EQ(decode(decoder, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"),
+              (Fields{{":method", "GET"},
+                      {":scheme", "https"},
+                      {":path", "/index.html"},
+                      {":authority", "www.example.com"},
+                      {"custom-key", "custom-value"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 164u);
+    EXPECT_EQ(decoder.getDynamicTableEntries(), 3u);
+}
+
+// RFC 7541 C.6: responses with Huffman coding and a 256-byte table that evicts
+TEST(HpackDecoderTest, RfcResponseExamplesEvict) {
+    HpackDecoder decoder;
+    decoder.setMaxDynamicTableSize(256);
+
+    EXPECT_EQ(decode(decoder,
+                     "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff6e91"
+                     "9d29ad171863c78f0b97c8e9ae82ae43d3"),
+              (Fields{{":status", "302"},
+                      {"cache-control", "private"},
+                      {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                      {"location", "https://www.example.com"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 222u);
+
+    EXPECT_EQ(decode(decoder, "4883640effc1c0bf"),
+              (Fields{{":status", "307"},
+                      {"cache-control", "private"},
+                      {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                      {"location", "https://www.example.com"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 222u);
+
+    EXPECT_EQ(decode(decoder,
+                     "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e782"
+                     "1dd7f2e6c7b335dfdfcd5b3960d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5"
+                     "b1063d5007"),
+              (Fields{{":status", "200"},
+                      {"cache-control", "private"},
+                      {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                      {"location", "https://www.example.com"},
+                      {"content-encoding", "gzip"},
+                      {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}}));
+    EXPECT_EQ(decoder.getDynamicTableSize(), 215u);
+    EXPECT_EQ(decoder.getDynamicTableEntries(), 3u);
+
+    // The owned-string API sees the same table
+    auto block = fromHex("be");
+    auto headers = decoder.decode(block.data(), block.size());
+    ASSERT_EQ(headers.size(), 1u);
+    EXPECT_EQ(headers[0].name, "set-cookie");
+}
+
+TEST(HpackDecoderTest, HuffmanRoundTripsEveryByte) {
+    std::string text;
+    for (int c = 0; c < 256; ++c) {
+        text.push_back(static_cast<char>(c));
+    }
+    text += "application/json";
+
+    std::vector<uint8_t> encoded;
+    HpackHuffman::encode(text, encoded);
+    EXPECT_EQ(encoded.size(), HpackHuffman::encodedLength(text));
+    std::string decoded;
+    ASSERT_TRUE(HpackHuffman::decode(encoded.data(), encoded.size(), decoded));
+    EXPECT_EQ(decoded, text);
+
+    // "a" is 00011: three padding ones are fine, a zero in the padding, a
+    // whole byte of padding and EOS are not
+    decoded.clear();
+    EXPECT_TRUE(HpackHuffman::decode(std::vector<uint8_t>{0x1F}.data(), 1, decoded));
+    EXPECT_EQ(decoded, "a");
+    EXPECT_FALSE(HpackHuffman::decode(std::vector<uint8_t>{0x1E}.data(), 1, decoded));
+    EXPECT_FALSE(HpackHuffman::decode(std::vector<uint8_t>{0x1F, 0xFF}.data(), 2, decoded));
+    EXPECT_FALSE(
+        HpackHuffman::decode(std::vector<uint8_t>{0xFF, 0xFF, 0xFF, 0xFF}.data(), 4, decoded));
+}
+
+TEST(HpackDecoderTest, TableWrapsAndKeepsEarlierViews) {
+    // Small table: each insertion evicts, so the byte buffer is compacted
+    // repeatedly while views from the same block stay valid
+    HpackDecoder decoder;
+    decoder.setMaxDynamicTableSize(100);
+    std::vector<uint8_t> block;
+    for (int i = 0; i < 40; ++i) {
+        std::string value = "value-" + std::to_string(i);
+        block.push_back(0x40 | 4);  // :path, incremental indexing
+        block.push_back(static_cast<uint8_t>(value.size()));
+        block.insert(block.end(), value.begin(), value.end());
+        block.push_back(0x80 | 62);  // The entry just added
+    }
+
+    std::vector<HpackDecoder::HeaderField> fields;
+    ASSERT_TRUE(decoder.decode(block.data(), block.size(), fields));
+    ASSERT_EQ(fields.size(), 80u);
+    for (int i = 0; i < 40; ++i) {
+        std::string value = "value-" + std::to_string(i);
+        EXPECT_EQ(fields[2 * i].value, value);
+        EXPECT_EQ(fields[2 * i + 1].name, ":path");
+        EXPECT_EQ(fields[2 * i + 1].value, value);
+    }
+    EXPECT_LE(decoder.getDynamicTableSize(), 100u);
+    EXPECT_EQ(decoder.getDynamicTableEntries(), 2u);
+
+    decoder.reset();
+    EXPECT_EQ(decoder.getDynamicTableEntries(), 0u);
+}
+
+TEST(HpackDecoderTest, MalformedBlockKeepsEarlierFields) {
+    HpackDecoder decoder;
+    std::vector<HpackDecoder::HeaderField> fields;
+
+    // :method GET, then dynamic index 62 with an empty table
+    std::vector<uint8_t> bad_index{0x82, 0xBE};
+    EXPECT_FALSE(decoder.decode(bad_index.data(), bad_index.size(), fields));
+    ASSERT_EQ(fields.size(), 1u);
+    EXPECT_EQ(fields[0].value, "GET");
+
+    // String length past the end of the block
+    std::vector<uint8_t> truncated{0x82, 0x44, 0x05, '/', 'a'};
+    EXPECT_FALSE(decoder.decode(truncated.data(), truncated.size(), fields));
+    EXPECT_EQ(fields.size(), 1u);
+    EXPECT_EQ(decoder.getDynamicTableEntries(), 0u);
+
+    // Multi-byte integer cut short
+    std::vector<uint8_t> cut{0xFF, 0x80};
+    EXPECT_FALSE(decoder.decode(cut.data(), cut.size(), fields));
+    EXPECT_TRUE(fields.empty());
+}
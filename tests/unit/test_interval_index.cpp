@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "correlation/interval_index.h"
+#include "correlation/rtp/rtp_correlator.h"
+
+using namespace callflow::correlation;
+
+namespace {
+
+struct Interval {
+    double start;
+    double end;
+    int id;
+};
+
+std::vector<int> bruteForce(const std::vector<Interval>& intervals, double from, double to) {
+    std::vector<int> ids;
+    for (const auto& interval : intervals) {
+        if (interval.start <= to && interval.end >= from) {
+            ids.push_back(interval.id);
+        }
+    }
+    return ids;
+}
+
+RtpPacketInfo makePacket(uint32_t ssrc, double timestamp, uint16_t seq) {
+    RtpPacketInfo packet{};
+    packet.timestamp = timestamp;
+    packet.src_ip = "10.0.0.1";
+    packet.src_port = 4000;
+    packet.dst_ip = "10.0.0.2";
+    packet.dst_port = 5000;
+    packet.version = 2;
+    packet.sequence_number = seq;
+    packet.ssrc = ssrc;
+    return packet;
+}
+
+}  // namespace
+
+TEST(IntervalIndexTest, MatchesBruteForceForEverySize) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> start_dist(0.0, 1000.0);
+    std::uniform_real_distribution<double> length_dist(0.0, 50.0);
+
+    // Sizes around powers of two exercise partial (non-full) trees
+    for (int n : {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 100, 255, 256, 257, 1000, 4099}) {
+        std::vector<Interval> intervals;
+        IntervalIndex<int> index;
+        for (int i = 0; i < n; ++i) {
+            double start = start_dist(rng);
+            // A quarter of the entries are points, like session start times
+            double end = i % 4 == 0 ? start : start + length_dist(rng);
+            intervals.push_back({start, end, i});
+            index.add(start, end, i);
+        }
+        index.build();
+        EXPECT_EQ(index.size(), static_cast<size_t>(n));
+
+        for (int q = 0; q < 200; ++q) {
+            double from = start_dist(rng) - 25.0;
+            double to = from + length_dist(rng);
+            std::vector<int> found;
+            index.forEachOverlap(from, to, [&](int id) { found.push_back(id); });
+
+            auto expected = bruteForce(intervals, from, to);
+            std::sort(found.begin(), found.end());
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(found, expected) << "n=" << n << " window=[" << from << ", " << to << "]";
+        }
+    }
+}
+
+TEST(IntervalIndexTest, ClosedBoundsAndKeyedPartitions) {
+    KeyedIntervalIndex<int> index;
+    index.add("10.0.0.1", 10.0, 10.0, 1);
+    index.add("10.0.0.1", 20.0, 30.0, 2);
+    index.add("10.0.0.2", 10.0, 10.0, 3);
+    index.build();
+    EXPECT_EQ(index.keyCount(), 2u);
+
+    std::vector<int> found;
+    auto collect = [&](int id) { found.push_back(id); };
+
+    // Both window edges are inclusive; results come in start order
+    index.forEachOverlap("10.0.0.1", 10.0, 20.0, collect);
+    EXPECT_EQ(found, (std::vector<int>{1, 2}));
+
+    found.clear();
+    index.forEachOverlap("10.0.0.1", 10.5, 19.5, collect);
+    EXPECT_TRUE(found.empty());
+
+    index.forEachOverlap("10.0.0.3", 0.0, 100.0, collect);
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(IntervalIndexTest, RtpTimeWindowSeesNewPackets) {
+    RtpCorrelator correlator;
+    correlator.addPacket(makePacket(1, 100.0, 1));
+    correlator.addPacket(makePacket(1, 110.0, 2));
+    correlator.addPacket(makePacket(2, 200.0, 1));
+
+    EXPECT_EQ(correlator.findByTimeWindow(105.0, 106.0).size(), 1u);
+    EXPECT_TRUE(correlator.findByTimeWindow(150.0, 190.0).empty());
+
+    // Extending a stream after a query invalidates the index
+    correlator.addPacket(makePacket(1, 160.0, 3));
+    auto streams = correlator.findByTimeWindow(150.0, 190.0);
+    ASSERT_EQ(streams.size(), 1u);
+    EXPECT_EQ(streams[0]->getSsrc(), 1u);
+
+    correlator.clear();
+    EXPECT_TRUE(correlator.findByTimeWindow(0.0, 1000.0).empty());
+}
@@ -0,0 +1,192 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pcap_ingest/ip_reassembler.h"
+
+using namespace callflow;
+
+namespace {
+
+/**
+ * IPv4 fragment: 20-byte header, @p offset in bytes, optional trailing padding
+ */
+std::vector<uint8_t> ipv4Fragment(uint16_t id, uint32_t offset, bool more,
+                                  const std::string& payload, size_t padding = 0) {
+    std::vector<uint8_t> pkt(20 + payload.size() + padding, 0);
+    pkt[0] = 0x45;
+    uint16_t total = htons(static_cast<uint16_t>(20 + payload.size()));
+    std::memcpy(&pkt[2], &total, 2);
+    uint16_t ident = htons(id);
+    std::memcpy(&pkt[4], &ident, 2);
+    uint16_t off = htons(static_cast<uint16_t>((offset / 8) | (more ? 0x2000 : 0)));
+    std::memcpy(&pkt[6], &off, 2);
+    pkt[8] = 64;
+    pkt[9] = 17;  // UDP
+    const uint8_t src[4] = {10, 0, 0, 1};
+    const uint8_t dst[4] = {10, 0, 0, 2};
+    std::memcpy(&pkt[12], src, 4);
+    std::memcpy(&pkt[16], dst, 4);
+    std::memcpy(&pkt[20], payload.data(), payload.size());
+    return pkt;
+}
+
+/**
+ * IPv6 packet with a fragment header (next header UDP)
+ */
+std::vector<uint8_t> ipv6Fragment(uint32_t id, uint32_t offset, bool more,
+                                  const std::string& payload) {
+    std::vector<uint8_t> pkt(48 + payload.size(), 0);
+    pkt[0] = 0x60;
+    uint16_t plen = htons(static_cast<uint16_t>(8 + payload.size()));
+    std::memcpy(&pkt[4], &plen, 2);
+    pkt[6] = 44;  // Fragment header
+    pkt[7] = 64;
+    pkt[8] = 0x20;
+    pkt[9] = 0x01;
+    pkt[23] = 1;
+    pkt[24] = 0x20;
+    pkt[25] = 0x01;
+    pkt[39] = 2;
+    pkt[40] = 17;
+    uint16_t offlg = htons(static_cast<uint16_t>(offset | (more ? 1 : 0)));
+    std::memcpy(&pkt[42], &offlg, 2);
+    uint32_t ident = htonl(id);
+    std::memcpy(&pkt[44], &ident, 4);
+    std::memcpy(&pkt[48], payload.data(), payload.size());
+    return pkt;
+}
+
+class IpReassemblerTest : public ::testing::Test {
+protected:
+    std::optional<ByteView> feed(IpReassembler& r, const std::vector<uint8_t>& pkt,
+                                 int at_sec = 0) {
+        return r.processPacket(pkt.data(), pkt.size(), start_ + std::chrono::seconds(at_sec));
+    }
+
+    static std::string payloadOf(ByteView packet, size_t header_len) {
+        return std::string(reinterpret_cast<const char*>(packet.data()) + header_len,
+                           packet.size() - header_len);
+    }
+
+    Timestamp start_ = Timestamp(std::chrono::seconds(1700000000));
+};
+
+}  // namespace
+
+TEST_F(IpReassemblerTest, UnfragmentedPacketIsReturnedInPlace) {
+    IpReassembler r;
+    auto pkt = ipv4Fragment(1, 0, false, "hello");
+    auto out = feed(r, pkt);
+    ASSERT_TRUE(out.has_value());
+    EXPECT_EQ(out->data(), pkt.data());
+    EXPECT_EQ(r.getStats().fragments, 0u);
+}
+
+TEST_F(IpReassemblerTest, ReassemblesOutOfOrderAndCountsOverlaps) {
+    IpReassembler r;
+    EXPECT_FALSE(feed(r, ipv4Fragment(7, 16, false, "CCCC")).has_value());
+    EXPECT_FALSE(feed(r, ipv4Fragment(7, 0, true, "AAAAAAAA")).has_value());
+    // Covers bytes 0-15; 0-7 were already received and keep their first value
+    auto out = feed(r, ipv4Fragment(7, 0, true, "xxxxxxxxBBBBBBBB"));
+    ASSERT_TRUE(out.has_value());
+
+    EXPECT_EQ(payloadOf(*out, 20), "AAAAAAAABBBBBBBBCCCC");
+    EXPECT_EQ(ntohs(*reinterpret_cast<const uint16_t*>(out->data() + 2)), 40);
+    EXPECT_EQ(out->data()[6] & 0x3f, 0);  // No MF, offset 0
+
+    // The rebuilt header carries a valid checksum
+    uint32_t sum = 0;
+    for (size_t i = 0; i < 20; i += 2) {
+        sum += (out->data()[i] << 8) | out->data()[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    EXPECT_EQ(sum, 0xffffu);
+
+    const auto& stats = r.getStats();
+    EXPECT_EQ(stats.fragments, 3u);
+    EXPECT_EQ(stats.reassembled, 1u);
+    EXPECT_EQ(stats.overlaps, 1u);
+    EXPECT_EQ(r.pendingDatagrams(), 0u);
+    EXPECT_EQ(r.bufferedBytes(), 0u);
+}
+
+TEST_F(IpReassemblerTest, IgnoresLinkLayerPadding) {
+    IpReassembler r;
+    EXPECT_FALSE(feed(r, ipv4Fragment(9, 0, true, "01234567", 6)).has_value());
+    auto out = feed(r, ipv4Fragment(9, 8, false, "89", 26));
+    ASSERT_TRUE(out.has_value());
+    EXPECT_EQ(payloadOf(*out, 20), "0123456789");
+}
+
+TEST_F(IpReassemblerTest, ReassemblesIpv6UsingByteOffsets) {
+    IpReassembler r;
+    EXPECT_FALSE(feed(r, ipv6Fragment(0x1234, 24, false, "tail")).has_value());
+    EXPECT_FALSE(feed(r, ipv6Fragment(0x1234, 0, true, "0123456789abcdef")).has_value());
+    auto out = feed(r, ipv6Fragment(0x1234, 16, true, "ghijklmn"));
+    ASSERT_TRUE(out.has_value());
+
+    EXPECT_EQ(out->size(), 40u + 28);
+    EXPECT_EQ(payloadOf(*out, 40), "0123456789abcdefghijklmntail");
+    EXPECT_EQ(out->data()[6], 17);  // Fragment header removed from the chain
+    EXPECT_EQ(ntohs(*reinterpret_cast<const uint16_t*>(out->data() + 4)), 28);
+}
+
+TEST_F(IpReassemblerTest, ExpiresByCaptureTime) {
+    IpReassembler::Limits limits;
+    limits.timeout = std::chrono::seconds(30);
+    IpReassembler r(limits);
+
+    feed(r, ipv4Fragment(1, 0, true, "AAAAAAAA"), 0);
+    feed(r, ipv4Fragment(2, 0, true, "AAAAAAAA"), 20);
+    EXPECT_EQ(r.pendingDatagrams(), 2u);
+
+    // The completing fragment of datagram 1 arrives too late
+    EXPECT_FALSE(feed(r, ipv4Fragment(1, 8, false, "B"), 31).has_value());
+    EXPECT_EQ(r.getStats().timeouts, 1u);
+    EXPECT_EQ(r.pendingDatagrams(), 2u);  // Datagram 2 plus a new datagram 1
+
+    EXPECT_EQ(r.expire(start_ + std::chrono::seconds(70)), 2u);
+    EXPECT_EQ(r.pendingDatagrams(), 0u);
+    EXPECT_EQ(r.bufferedBytes(), 0u);
+}
+
+TEST_F(IpReassemblerTest, EnforcesDatagramAndMemoryLimits) {
+    IpReassembler::Limits limits;
+    limits.max_datagrams = 2;
+    limits.memory_budget_bytes = 4096;
+    IpReassembler r(limits);
+
+    const std::string chunk(1024, 'z');
+    feed(r, ipv4Fragment(1, 0, true, chunk));
+    feed(r, ipv4Fragment(2, 0, true, chunk));
+    feed(r, ipv4Fragment(3, 0, true, chunk));
+    EXPECT_EQ(r.pendingDatagrams(), 2u);
+    EXPECT_EQ(r.getStats().evicted, 1u);
+
+    // Growing datagram 3 past the budget drops the oldest one (2)
+    feed(r, ipv4Fragment(3, 2048, true, chunk));
+    EXPECT_EQ(r.pendingDatagrams(), 1u);
+    EXPECT_EQ(r.getStats().evicted, 2u);
+    EXPECT_LE(r.bufferedBytes(), limits.memory_budget_bytes);
+}
+
+TEST_F(IpReassemblerTest, DropsInconsistentDatagrams) {
+    IpReassembler r;
+    feed(r, ipv4Fragment(5, 0, true, "AAAAAAAA"));
+    feed(r, ipv4Fragment(5, 16, false, "CCCC"));
+    // A second last fragment with a different end
+    EXPECT_FALSE(feed(r, ipv4Fragment(5, 8, false, "BB")).has_value());
+    EXPECT_EQ(r.getStats().malformed, 1u);
+    EXPECT_EQ(r.pendingDatagrams(), 0u);
+
+    // Non-final fragments must be a multiple of 8 bytes
+    EXPECT_FALSE(feed(r, ipv4Fragment(6, 0, true, "AAAAA")).has_value());
+    EXPECT_EQ(r.getStats().malformed, 2u);
+    EXPECT_EQ(r.pendingDatagrams(), 0u);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/job_arena.h"
+#include "session/session_correlator.h"
+
+using namespace callflow;
+
+namespace {
+
+SessionMessageRef makeMessage(uint32_t subscriber, int phase) {
+    SessionMessageRef msg;
+    msg.message_id = "msg-" + std::to_string(subscriber) + "-" + std::to_string(phase);
+    msg.timestamp = Timestamp(std::chrono::milliseconds(subscriber * 10 + phase));
+    msg.src_ip = "10.0." + std::to_string(subscriber >> 8) + "." + std::to_string(subscriber & 0xFF);
+    msg.dst_ip = "172.16.0.1";
+    msg.payload_length = 100;
+    msg.correlation_key.imsi = "00101" + std::to_string(1000000000 + subscriber);
+    if (phase == 0) {
+        msg.protocol = ProtocolType::GTP_C;
+        msg.message_type = MessageType::GTP_CREATE_SESSION_REQ;
+        msg.interface = InterfaceType::S11;
+        msg.correlation_key.teid_s1u = 0x1000 + subscriber;
+    } else {
+        msg.protocol = ProtocolType::DIAMETER;
+        msg.message_type = MessageType::DIAMETER_CCR;
+        msg.interface = InterfaceType::DIAMETER;
+    }
+    return msg;
+}
+
+}  // namespace
+
+TEST(JobArenaTest, CountsAllocationsAndReleases) {
+    JobArena arena(4096);
+    {
+        std::pmr::vector<uint64_t> values(&arena);
+        for (uint64_t i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        EXPECT_EQ(values[999], 999u);
+    }
+
+    ArenaStats stats = arena.stats();
+    EXPECT_GT(stats.allocations, 1u);
+    EXPECT_GE(stats.bytes_allocated, 1000u * sizeof(uint64_t));
+    // Every buffer the vector outgrew (and the last one) was handed back
+    EXPECT_EQ(stats.bytes_freed, stats.bytes_allocated);
+    // Small buffers wait on free lists in the first chunk; large ones went back to the heap
+    EXPECT_LE(stats.bytes_reserved, 4096u + JobArena::kLargestArenaBlock);
+    EXPECT_EQ(stats.chunks, 1u);
+
+    arena.release();
+    EXPECT_EQ(arena.stats().bytes_reserved, 0u);
+}
+
+TEST(JobArenaTest, ReusesFreedBlocks) {
+    JobArena arena(4096);
+
+    // A small block handed back is the next one of its size
+    void* first = arena.allocate(88);
+    arena.deallocate(first, 88);
+    EXPECT_EQ(arena.allocate(88), first);
+
+    // Large blocks go back to the heap as soon as they are freed
+    uint64_t before = arena.stats().bytes_reserved;
+    void* large = arena.allocate(JobArena::kLargestArenaBlock * 4);
+    EXPECT_EQ(arena.stats().bytes_reserved, before + JobArena::kLargestArenaBlock * 4);
+    arena.deallocate(large, JobArena::kLargestArenaBlock * 4);
+    EXPECT_EQ(arena.stats().bytes_reserved, before);
+
+    // Regrowing vectors do not leave their old buffers behind
+    {
+        std::vector<std::pmr::vector<uint64_t>> legs;
+        for (int i = 0; i < 64; ++i) {
+            legs.emplace_back(&arena);
+            for (uint64_t n = 0; n < 2000; ++n) {
+                legs.back().push_back(n);
+            }
+        }
+        uint64_t live = 64 * 2048 * sizeof(uint64_t);
+        EXPECT_LT(arena.stats().bytes_reserved, live + live / 8);
+    }
+}
+
+TEST(JobArenaTest, CorrelatorOnArenaMatchesDefaultHeap) {
+    JobArena arena;
+    EnhancedSessionCorrelator on_arena(&arena);
+    EnhancedSessionCorrelator on_heap;
+
+    for (int phase = 0; phase < 2; ++phase) {
+        for (uint32_t i = 0; i < 500; ++i) {
+            on_arena.addMessage(makeMessage(i, phase));
+            on_heap.addMessage(makeMessage(i, phase));
+        }
+    }
+    on_arena.finalizeSessions();
+    on_heap.finalizeSessions();
+
+    EXPECT_EQ(on_arena.getSessionCount(), 500u);
+    EXPECT_EQ(on_arena.getSessionCount(), on_heap.getSessionCount());
+    EXPECT_GT(arena.stats().bytes_allocated, 500u * sizeof(StoredMessage) * 2);
+
+    // Copies handed out leave the arena, so they survive its release
+    auto sessions = on_arena.correlateByImsi("001011000000042");
+    ASSERT_EQ(sessions.size(), 1u);
+    EXPECT_NE(sessions[0].legs.get_allocator().resource(), &arena);
+    ASSERT_EQ(sessions[0].legs.size(), 2u);
+    EXPECT_NE(sessions[0].legs[0].messages.get_allocator().resource(), &arena);
+
+    auto messages = sessions[0].getAllMessages();
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].message_id, "msg-42-0");
+    EXPECT_EQ(messages[1].message_id, "msg-42-1");
+    EXPECT_EQ(messages[0].correlation_key.teid_s1u, 0x1000u + 42);
+}
@@ -0,0 +1,284 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "pcap_ingest/ip_reassembler.h"
+#include "pcap_ingest/pcap_reader.h"
+#include "pcap_ingest/pcapng_reader.h"
+
+using namespace callflow;
+
+namespace {
+
+class ByteWriter {
+public:
+    explicit ByteWriter(bool big_endian = false) : big_endian_(big_endian) {}
+
+    void u16(uint16_t v) {
+        uint8_t b[2] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8)};
+        if (big_endian_) {
+            std::swap(b[0], b[1]);
+        }
+        bytes.insert(bytes.end(), b, b + 2);
+    }
+
+    void u32(uint32_t v) {
+        uint8_t b[4];
+        for (int i = 0; i < 4; ++i) {
+            b[big_endian_ ? 3 - i : i] = static_cast<uint8_t>(v >> (8 * i));
+        }
+        bytes.insert(bytes.end(), b, b + 4);
+    }
+
+    void raw(const std::vector<uint8_t>& data) { bytes.insert(bytes.end(), data.begin(), data.end()); }
+
+    std::vector<uint8_t> bytes;
+
+private:
+    bool big_endian_;
+};
+
+std::string writeTempFile(const std::string& name, const std::vector<uint8_t>& bytes) {
+    auto path = (std::filesystem::temp_directory_path() / ("callflow_" + name)).string();
+    FILE* f = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), f);
+    std::fclose(f);
+    return path;
+}
+
+std::vector<uint8_t> makePayload(size_t len, uint8_t seed) {
+    std::vector<uint8_t> data(len);
+    for (size_t i = 0; i < len; ++i) {
+        data[i] = static_cast<uint8_t>(seed + i);
+    }
+    return data;
+}
+
+std::vector<uint8_t> buildPcap(uint32_t magic, bool big_endian,
+                               const std::vector<std::vector<uint8_t>>& packets) {
+    ByteWriter w(big_endian);
+    w.u32(magic);
+    w.u16(2);
+    w.u16(4);
+    w.u32(0);
+    w.u32(0);
+    w.u32(65535);
+    w.u32(1);  // Ethernet
+    for (size_t i = 0; i < packets.size(); ++i) {
+        w.u32(1700000000 + static_cast<uint32_t>(i));
+        w.u32(123456789);  // Fraction: usec files only use it as-is
+        w.u32(static_cast<uint32_t>(packets[i].size()));
+        w.u32(static_cast<uint32_t>(packets[i].size() + 10));
+        w.raw(packets[i]);
+    }
+    return w.bytes;
+}
+
+std::vector<uint8_t> buildPcapng(const std::vector<std::vector<uint8_t>>& packets) {
+    ByteWriter w;
+    // Section Header Block
+    w.u32(0x0A0D0D0A);
+    w.u32(28);
+    w.u32(0x1A2B3C4D);
+    w.u16(1);
+    w.u16(0);
+    w.u32(0xFFFFFFFF);
+    w.u32(0xFFFFFFFF);
+    w.u32(28);
+    // Interface Description Block
+    w.u32(1);
+    w.u32(20);
+    w.u16(1);
+    w.u16(0);
+    w.u32(65535);
+    w.u32(20);
+    // Enhanced Packet Blocks
+    for (const auto& packet : packets) {
+        uint32_t padded = (static_cast<uint32_t>(packet.size()) + 3) & ~3u;
+        uint32_t total = 32 + padded;
+        w.u32(6);
+        w.u32(total);
+        w.u32(0);
+        w.u32(0);
+        w.u32(1000);
+        w.u32(static_cast<uint32_t>(packet.size()));
+        w.u32(static_cast<uint32_t>(packet.size()));
+        w.raw(packet);
+        w.raw(std::vector<uint8_t>(padded - packet.size(), 0));
+        w.u32(total);
+    }
+    return w.bytes;
+}
+
+std::vector<uint8_t> buildIpv4Fragment(uint16_t id, uint16_t offset_units, bool more,
+                                       const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> pkt(20 + payload.size(), 0);
+    pkt[0] = 0x45;
+    pkt[2] = static_cast<uint8_t>(pkt.size() >> 8);
+    pkt[3] = static_cast<uint8_t>(pkt.size());
+    pkt[4] = static_cast<uint8_t>(id >> 8);
+    pkt[5] = static_cast<uint8_t>(id);
+    uint16_t frag = static_cast<uint16_t>((more ? 0x2000 : 0) | offset_units);
+    pkt[6] = static_cast<uint8_t>(frag >> 8);
+    pkt[7] = static_cast<uint8_t>(frag);
+    pkt[8] = 64;
+    pkt[9] = 17;
+    pkt[12] = 10;
+    pkt[15] = 1;
+    pkt[16] = 10;
+    pkt[19] = 2;
+    std::copy(payload.begin(), payload.end(), pkt.begin() + 20);
+    return pkt;
+}
+
+}  // namespace
+
+TEST(MappedCaptureTest, PcapReaderWalksMappedRecords) {
+    std::vector<std::vector<uint8_t>> packets = {makePayload(60, 1), makePayload(1514, 2),
+                                                 makePayload(61, 3)};
+    auto path = writeTempFile("usec.pcap", buildPcap(0xa1b2c3d4, false, packets));
+
+    PcapReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.isMemoryMapped());
+    EXPECT_EQ(reader.getDatalinkType(), 1);
+    EXPECT_EQ(reader.getSnaplen(), 65535);
+
+    pcap_pkthdr header;
+    const uint8_t* data = nullptr;
+    std::vector<const uint8_t*> pointers;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_TRUE(reader.readNextPacket(header, data));
+        EXPECT_EQ(header.caplen, packets[i].size());
+        EXPECT_EQ(header.len, packets[i].size() + 10);
+        EXPECT_EQ(header.ts.tv_sec, 1700000000 + static_cast<long>(i));
+        EXPECT_EQ(std::memcmp(data, packets[i].data(), packets[i].size()), 0);
+        pointers.push_back(data);
+    }
+    EXPECT_FALSE(reader.readNextPacket(header, data));
+
+    // Earlier packets are still readable: pointers refer into the mapping
+    EXPECT_EQ(std::memcmp(pointers[0], packets[0].data(), packets[0].size()), 0);
+    EXPECT_EQ(reader.getStats().packets_processed, 3u);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST(MappedCaptureTest, PcapReaderHandlesSwappedNanosecondFiles) {
+    std::vector<std::vector<uint8_t>> packets = {makePayload(42, 9)};
+    auto path = writeTempFile("nsec_be.pcap", buildPcap(0xa1b23c4d, true, packets));
+
+    PcapReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.isMemoryMapped());
+    EXPECT_EQ(reader.getDatalinkType(), 1);
+
+    pcap_pkthdr header;
+    const uint8_t* data = nullptr;
+    ASSERT_TRUE(reader.readNextPacket(header, data));
+    EXPECT_EQ(header.caplen, 42u);
+    EXPECT_EQ(header.ts.tv_usec, 123456);
+    EXPECT_EQ(std::memcmp(data, packets[0].data(), 42), 0);
+    EXPECT_FALSE(reader.readNextPacket(header, data));
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST(MappedCaptureTest, PcapngReaderPassesPacketsInPlace) {
+    std::vector<std::vector<uint8_t>> packets = {makePayload(61, 1), makePayload(128, 2),
+                                                 makePayload(3, 3)};
+    auto path = writeTempFile("capture.pcapng", buildPcapng(packets));
+
+    for (bool use_mmap : {true, false}) {
+        PcapngReader reader;
+        reader.setUseMmap(use_mmap);
+        ASSERT_TRUE(reader.open(path));
+        EXPECT_EQ(reader.isMemoryMapped(), use_mmap);
+
+        size_t index = 0;
+        size_t count = reader.processPackets(
+            [&](uint32_t interface_id, uint64_t timestamp_ns, const uint8_t* data,
+                uint32_t captured_length, uint32_t original_length, const PcapngPacketMetadata&) {
+                ASSERT_LT(index, packets.size());
+                EXPECT_EQ(interface_id, 0u);
+                EXPECT_EQ(timestamp_ns, 1000u * 1000u);
+                EXPECT_EQ(captured_length, packets[index].size());
+                EXPECT_EQ(original_length, packets[index].size());
+                EXPECT_EQ(std::memcmp(data, packets[index].data(), captured_length), 0);
+                ++index;
+            });
+        EXPECT_EQ(count, packets.size());
+        ASSERT_EQ(reader.getInterfaces().size(), 1u);
+        EXPECT_EQ(reader.getInterfaces()[0].link_type, 1);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(MappedCaptureTest, ReassemblerReturnsViewOfUnfragmentedInput) {
+    IpReassembler reassembler;
+    auto packet = buildIpv4Fragment(1, 0, false, makePayload(40, 0));
+
+    auto view = reassembler.processPacket(packet.data(), packet.size(), Timestamp());
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->data(), packet.data());
+    EXPECT_EQ(view->size(), packet.size());
+}
+
+TEST(MappedCaptureTest, ReassemblerCompletesFragments) {
+    IpReassembler reassembler;
+    auto payload = makePayload(32, 7);
+    std::vector<uint8_t> first_half(payload.begin(), payload.begin() + 16);
+    std::vector<uint8_t> second_half(payload.begin() + 16, payload.end());
+
+    auto first = buildIpv4Fragment(42, 0, true, first_half);
+    auto second = buildIpv4Fragment(42, 2, false, second_half);
+
+    EXPECT_FALSE(reassembler.processPacket(first.data(), first.size(), Timestamp()).has_value());
+    auto view = reassembler.processPacket(second.data(), second.size(), Timestamp());
+    ASSERT_TRUE(view.has_value());
+    ASSERT_EQ(view->size(), 20 + payload.size());
+    EXPECT_NE(view->data(), second.data());
+    EXPECT_EQ(std::memcmp(view->data() + 20, payload.data(), payload.size()), 0);
+}
+
+TEST(MappedCaptureTest, ReadersReportFileOffsetForProgress) {
+    std::vector<std::vector<uint8_t>> packets = {makePayload(60, 1), makePayload(200, 2)};
+    auto pcap_bytes = buildPcap(0xa1b2c3d4, false, packets);
+    auto pcap_path = writeTempFile("offset.pcap", pcap_bytes);
+
+    PcapReader pcap;
+    ASSERT_TRUE(pcap.open(pcap_path));
+    EXPECT_EQ(pcap.getFileSize(), pcap_bytes.size());
+    EXPECT_EQ(pcap.getFileOffset(), 24u);
+
+    pcap_pkthdr header;
+    const uint8_t* data = nullptr;
+    ASSERT_TRUE(pcap.readNextPacket(header, data));
+    EXPECT_EQ(pcap.getFileOffset(), 24u + 16u + 60u);
+    ASSERT_TRUE(pcap.readNextPacket(header, data));
+    EXPECT_EQ(pcap.getFileOffset(), pcap_bytes.size());
+    pcap.close();
+    std::filesystem::remove(pcap_path);
+
+    auto ng_bytes = buildPcapng(packets);
+    auto ng_path = writeTempFile("offset.pcapng", ng_bytes);
+    for (bool use_mmap : {true, false}) {
+        PcapngReader ng;
+        ng.setUseMmap(use_mmap);
+        ASSERT_TRUE(ng.open(ng_path));
+        EXPECT_EQ(ng.getFileSize(), ng_bytes.size());
+        EXPECT_EQ(ng.getFileOffset(), 28u);  // Section Header Block read by open()
+
+        ng.processPackets([](uint32_t, uint64_t, const uint8_t*, uint32_t, uint32_t,
+                             const PcapngPacketMetadata&) {});
+        EXPECT_EQ(ng.getFileOffset(), ng_bytes.size());
+    }
+    std::filesystem::remove(ng_path);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "ndpi_engine/ndpi_flow_cache.h"
+
+using namespace callflow;
+
+namespace {
+
+FlowKey makeFlow(uint16_t src_port) {
+    const uint8_t client[4] = {10, 0, 0, 1};
+    const uint8_t server[4] = {10, 0, 0, 2};
+    FlowKey key;
+    key.src_ip = IpAddress::fromV4(client);
+    key.dst_ip = IpAddress::fromV4(server);
+    key.src_port = src_port;
+    key.dst_port = 5060;
+    key.protocol = 17;
+    return key;
+}
+
+const Timestamp kStart = Timestamp(std::chrono::seconds(1700000000));
+
+Timestamp at(int sec) {
+    return kStart + std::chrono::seconds(sec);
+}
+
+}  // namespace
+
+TEST(NdpiFlowCacheTest, HitsReturnTheSameFlow) {
+    NdpiFlowCache cache(300, 0);
+    cache.getOrCreateFlow(makeFlow(1000), at(0));
+    cache.getOrCreateFlow(makeFlow(1001), at(0));
+    NdpiCachedFlow* again = cache.getOrCreateFlow(makeFlow(1000), at(1));
+
+    EXPECT_EQ(again->packet_count, 1u);
+    EXPECT_EQ(again->last_seen, at(1));
+    EXPECT_EQ(cache.size(), 2u);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.cache_hits, 1u);
+    EXPECT_EQ(stats.cache_misses, 2u);
+    EXPECT_EQ(stats.total_flows, 2u);
+}
+
+TEST(NdpiFlowCacheTest, EvictsLeastRecentlyUsedFlow) {
+    NdpiFlowCache cache(300, 3);
+    for (uint16_t port = 1; port <= 3; ++port) {
+        cache.getOrCreateFlow(makeFlow(port), at(port));
+    }
+    cache.getOrCreateFlow(makeFlow(1), at(10));  // Port 2 is now the LRU flow
+    cache.getOrCreateFlow(makeFlow(4), at(11));
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.getStats().evictions_lru, 1u);
+
+    // Port 2 was evicted and comes back as a fresh flow
+    NdpiCachedFlow* flow = cache.getOrCreateFlow(makeFlow(2), at(12));
+    EXPECT_EQ(flow->packet_count, 0u);
+    EXPECT_EQ(cache.getStats().cache_misses, 5u);
+}
+
+TEST(NdpiFlowCacheTest, ExpiresIdleFlows) {
+    NdpiFlowCache cache(60, 0);
+    for (uint16_t port = 1; port <= 1000; ++port) {
+        cache.getOrCreateFlow(makeFlow(port), at(port <= 500 ? 0 : 50));
+    }
+    // Re-touched flows move to the back of the LRU list
+    cache.getOrCreateFlow(makeFlow(2), at(55));
+
+    EXPECT_EQ(cache.cleanupExpiredFlows(at(100)), 499u);
+    EXPECT_EQ(cache.size(), 501u);
+    EXPECT_EQ(cache.getStats().evictions_timeout, 499u);
+    EXPECT_EQ(cache.getOrCreateFlow(makeFlow(2), at(101))->packet_count, 2u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+}
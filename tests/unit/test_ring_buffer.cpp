@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pcap_ingest/ring_buffer.h"
+
+using namespace callflow;
+
+TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo) {
+    SpscRing<int> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, PreservesOrderAndReportsFull) {
+    SpscRing<std::string> ring(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(std::to_string(i)));
+    }
+    EXPECT_TRUE(ring.full());
+
+    std::string overflow = "x";
+    EXPECT_FALSE(ring.tryPush(std::move(overflow)));
+    EXPECT_EQ(overflow, "x");  // Not consumed on failure
+
+    std::string out;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.tryPop(out));
+        EXPECT_EQ(out, std::to_string(i));
+    }
+    EXPECT_FALSE(ring.tryPop(out));
+}
+
+TEST(SpscRingTest, BatchOperationsArePartialWhenFull) {
+    SpscRing<int> ring(8);
+    std::vector<int> items(12);
+    std::iota(items.begin(), items.end(), 0);
+
+    EXPECT_EQ(ring.tryPushBatch(items.data(), items.size()), 8u);
+
+    std::vector<int> out(16);
+    EXPECT_EQ(ring.tryPopBatch(out.data(), 5), 5u);
+    EXPECT_EQ(ring.tryPushBatch(items.data() + 8, 4), 4u);
+    EXPECT_EQ(ring.tryPopBatch(out.data() + 5, 16), 7u);
+    for (int i = 0; i < 12; ++i) {
+        EXPECT_EQ(out[i], i);
+    }
+}
+
+TEST(SpscRingTest, CloseDrainsRemainingItems) {
+    SpscRing<int> ring(8);
+    EXPECT_TRUE(ring.push(1));
+    EXPECT_TRUE(ring.push(2));
+    ring.close();
+
+    EXPECT_FALSE(ring.push(3));
+    int out = 0;
+    EXPECT_TRUE(ring.pop(out));
+    EXPECT_EQ(out, 1);
+    EXPECT_TRUE(ring.pop(out));
+    EXPECT_EQ(out, 2);
+    EXPECT_FALSE(ring.pop(out));
+}
+
+TEST(SpscRingTest, BlockingHandOffAcrossThreads) {
+    constexpr uint64_t kCount = 200000;
+    SpscRing<uint64_t> ring(64);  // Small ring forces back-pressure
+
+    std::thread producer([&]() {
+        std::vector<uint64_t> batch;
+        for (uint64_t i = 1; i <= kCount; ++i) {
+            batch.push_back(i);
+            if (batch.size() == 16 || i == kCount) {
+                ASSERT_EQ(ring.pushBatch(batch.data(), batch.size()), batch.size());
+                batch.clear();
+            }
+        }
+        ring.close();
+    });
+
+    uint64_t expected = 1;
+    uint64_t sum = 0;
+    std::vector<uint64_t> out(32);
+    while (size_t n = ring.popBatch(out.data(), out.size())) {
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(out[i], expected++);
+            sum += out[i];
+        }
+    }
+    producer.join();
+    EXPECT_EQ(sum, kCount * (kCount + 1) / 2);
+}
+
+TEST(MpmcRingTest, MultipleProducersAndConsumers) {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 3;
+    constexpr uint64_t kPerProducer = 50000;
+    MpmcRing<uint64_t> ring(256);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p]() {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                uint64_t value = p * kPerProducer + i + 1;
+                ASSERT_TRUE(ring.push(std::move(value)));
+            }
+        });
+    }
+
+    std::vector<uint64_t> sums(kConsumers, 0);
+    std::vector<uint64_t> counts(kConsumers, 0);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            uint64_t out[8];
+            while (size_t n = ring.popBatch(out, 8)) {
+                for (size_t i = 0; i < n; ++i) {
+                    sums[c] += out[i];
+                }
+                counts[c] += n;
+            }
+        });
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+    ring.close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    uint64_t total = kProducers * kPerProducer;
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), uint64_t{0}), total);
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), uint64_t{0}), total * (total + 1) / 2);
+}
+
+TEST(MpmcRingTest, FullAndClosedPushFails) {
+    MpmcRing<int> ring(2);
+    EXPECT_TRUE(ring.tryPush(1));
+    EXPECT_TRUE(ring.tryPush(2));
+    EXPECT_FALSE(ring.tryPush(3));
+
+    int out = 0;
+    EXPECT_TRUE(ring.tryPop(out));
+    EXPECT_EQ(out, 1);
+
+    ring.close();
+    EXPECT_FALSE(ring.push(4));
+    EXPECT_TRUE(ring.pop(out));
+    EXPECT_EQ(out, 2);
+    EXPECT_FALSE(ring.pop(out));
+}
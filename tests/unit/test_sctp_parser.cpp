@@ -794,7 +794,7 @@ TEST_F(SctpParserTest, S1APIntegration) {
     ASSERT_EQ(messages.size(), 1);
     EXPECT_EQ(messages[0].payload_protocol, 18);  // S1AP
     EXPECT_EQ(messages[0].stream_id, 0);
-    EXPECT_EQ(messages[0].data.size(), s1ap_payload.size());
+    EXPECT_EQ(messages[0].payload().size(), s1ap_payload.size());
 }
 
 // Test integration with NGAP payload
@@ -871,7 +871,181 @@ TEST_F(SctpParserTest, NGAPIntegration) {
     ASSERT_EQ(messages.size(), 1);
     EXPECT_EQ(messages[0].payload_protocol, 60);  // NGAP
     EXPECT_EQ(messages[0].stream_id, 0);
-    EXPECT_EQ(messages[0].data.size(), ngap_payload.size());
+    EXPECT_EQ(messages[0].payload().size(), ngap_payload.size());
+}
+
+namespace {
+
+SctpDataChunkView chunkView(uint32_t tsn, uint16_t ssn, const std::vector<uint8_t>& data,
+                            bool beginning = true, bool ending = true, bool unordered = false) {
+    SctpDataChunkView chunk;
+    chunk.stream_id = 0;
+    chunk.tsn = tsn;
+    chunk.stream_sequence = ssn;
+    chunk.payload_protocol = 60;
+    chunk.unordered = unordered;
+    chunk.beginning = beginning;
+    chunk.ending = ending;
+    chunk.data = ByteView(data);
+    return chunk;
+}
+
+}  // namespace
+
+// Unfragmented messages reach the callback as views into the packet
+TEST_F(SctpParserTest, ProcessDeliversUnfragmentedMessageAsView) {
+    FiveTuple ft;
+    ft.src_ip = "10.0.0.1";
+    ft.dst_ip = "10.0.0.2";
+    ft.src_port = 38412;
+    ft.dst_port = 38412;
+    ft.protocol = 132;
+
+    std::vector<uint8_t> ngap_payload = {0x00, 0x15, 0x00, 0x2a, 0x00, 0x00, 0x04};
+    auto packet = createSctpPacket(
+        38412, 38412, 0x1234,
+        {createDataChunk(7000, 1, 42, 60, ngap_payload), createDataChunk(7001, 1, 43, 60, {})});
+
+    std::vector<const uint8_t*> payloads;
+    std::vector<uint16_t> ssns;
+    parser_->setMessageCallback([&](const SctpReassembledMessage& msg) {
+        EXPECT_TRUE(msg.data.empty());
+        payloads.push_back(msg.payload().data());
+        ssns.push_back(msg.stream_sequence);
+    });
+    ASSERT_TRUE(parser_->process(packet.data(), packet.size(), ft));
+
+    // The capture starts mid-association: SSN 42 is taken as the first
+    ASSERT_EQ(ssns, (std::vector<uint16_t>{42, 43}));
+    EXPECT_EQ(payloads[0], packet.data() + 12 + 16);
+
+    auto assoc_ids = parser_->getAssociationIds();
+    ASSERT_EQ(assoc_ids.size(), 1u);
+    EXPECT_EQ(parser_->getAssociation(assoc_ids[0])->data_chunks_received, 2u);
+
+    // A corrupted checksum is rejected
+    packet[8] ^= 0xFF;
+    EXPECT_FALSE(parser_->process(packet.data(), packet.size(), ft));
+}
+
+// A chunk length below the chunk header ends the walk instead of looping
+TEST_F(SctpParserTest, ShortChunkLengthStopsParsing) {
+    FiveTuple ft;
+    ft.src_port = 38412;
+    ft.dst_port = 38412;
+    ft.protocol = 132;
+
+    auto packet = createSctpPacket(38412, 38412, 0x1234, {{0x00, 0x03, 0x00, 0x00}});
+    EXPECT_TRUE(parser_->process(packet.data(), packet.size(), ft));
+    auto result = parser_->parse(packet.data(), packet.size(), ft);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->chunks.empty());
+}
+
+TEST_F(SctpParserTest, FragmentsReassembleOutOfOrder) {
+    std::vector<std::vector<uint8_t>> parts = {{0x01, 0x02}, {0x03}, {0x04, 0x05}, {0x06}};
+    std::vector<std::vector<uint8_t>> delivered;
+    auto sink = [&](const SctpReassembledMessage& msg) {
+        delivered.emplace_back(msg.payload().begin(), msg.payload().end());
+        EXPECT_EQ(msg.start_tsn, 200u);
+        EXPECT_EQ(msg.end_tsn, 203u);
+        EXPECT_EQ(msg.fragment_count, 4u);
+    };
+
+    for (uint32_t i : {3u, 1u, 0u}) {
+        EXPECT_EQ(reassembler_->addChunk(chunkView(200 + i, 7, parts[i], i == 0, i == 3), sink),
+                  0u);
+    }
+    EXPECT_EQ(reassembler_->getStreamContext(0)->buffered_fragments, 3u);
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 4u);
+
+    EXPECT_EQ(reassembler_->addChunk(chunkView(202, 7, parts[2], false, false), sink), 1u);
+    ASSERT_EQ(delivered.size(), 1u);
+    EXPECT_EQ(delivered[0], (std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}));
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 0u);
+    EXPECT_EQ(reassembler_->getStreamContext(0)->next_expected_ssn, 8u);
+
+    // TSNs arrived out of order but none were skipped
+    EXPECT_EQ(reassembler_->getMissingTsns(), 0u);
+    EXPECT_EQ(reassembler_->getDroppedFragments(), 0u);
+}
+
+TEST_F(SctpParserTest, OrderedMessagesWaitForMissingSsn) {
+    std::vector<uint8_t> payload = {0xAB};
+    std::vector<uint16_t> order;
+    auto sink = [&](const SctpReassembledMessage& msg) { order.push_back(msg.stream_sequence); };
+
+    EXPECT_EQ(reassembler_->addChunk(chunkView(1, 10, payload), sink), 1u);
+    EXPECT_EQ(reassembler_->addChunk(chunkView(3, 12, payload), sink), 0u);
+    EXPECT_EQ(reassembler_->getStreamContext(0)->held_messages.size(), 1u);
+
+    // The missing SSN releases the held one; its retransmission is ignored
+    EXPECT_EQ(reassembler_->addChunk(chunkView(2, 11, payload), sink), 2u);
+    EXPECT_EQ(reassembler_->addChunk(chunkView(2, 11, payload), sink), 0u);
+    EXPECT_EQ(order, (std::vector<uint16_t>{10, 11, 12}));
+
+    auto stream = reassembler_->getStreamContext(0);
+    EXPECT_EQ(stream->out_of_order_count, 1u);
+    EXPECT_TRUE(stream->held_messages.empty());
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 0u);
+
+    // Unordered messages bypass the sequence
+    EXPECT_EQ(reassembler_->addChunk(chunkView(4, 0, payload, true, true, true), sink), 1u);
+}
+
+TEST_F(SctpParserTest, HeldMessagesSkipMissingSsn) {
+    std::vector<uint8_t> payload = {0x01, 0x02};
+    size_t count = 0;
+    auto sink = [&](const SctpReassembledMessage&) { count++; };
+
+    reassembler_->addChunk(chunkView(1, 0, payload), sink);
+    // SSN 1 never arrives
+    for (uint16_t ssn = 2; ssn < 2 + SctpStreamReassembler::kMaxHeldMessages; ++ssn) {
+        EXPECT_EQ(reassembler_->addChunk(chunkView(ssn, ssn, payload), sink), 0u);
+    }
+    uint16_t last = 2 + SctpStreamReassembler::kMaxHeldMessages;
+    EXPECT_EQ(reassembler_->addChunk(chunkView(last, last, payload), sink),
+              SctpStreamReassembler::kMaxHeldMessages + 1);
+    EXPECT_EQ(count, SctpStreamReassembler::kMaxHeldMessages + 2);
+
+    auto stream = reassembler_->getStreamContext(0);
+    EXPECT_EQ(stream->skipped_ssns, 1u);
+    EXPECT_EQ(stream->next_expected_ssn, last + 1u);
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 0u);
+}
+
+TEST_F(SctpParserTest, TsnGapsAreCounted) {
+    std::vector<uint8_t> payload = {0x01};
+    for (uint32_t tsn : {0xFFFFFFFEu, 0xFFFFFFFFu, 2u, 6u, 4u}) {
+        reassembler_->addChunk(chunkView(tsn, 0, payload, true, true, true), nullptr);
+    }
+    // Skips 0 and 1 across the wrap, then 3 to 5
+    EXPECT_EQ(reassembler_->getTsnGaps(), 2u);
+    EXPECT_EQ(reassembler_->getMissingTsns(), 5u);
+
+    auto stats = reassembler_->getStatistics();
+    EXPECT_EQ(stats["tsn_gaps"], 2);
+    EXPECT_EQ(stats["total_messages"], 5);
+}
+
+TEST_F(SctpParserTest, MemoryBudgetDropsIncompleteFragments) {
+    reassembler_->setMemoryBudget(64);
+    std::vector<uint8_t> payload(40, 0x5A);
+
+    // First fragments of two unordered messages whose remainder never arrives
+    reassembler_->addChunk(chunkView(100, 0, payload, true, false, true), nullptr);
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 40u);
+    reassembler_->addChunk(chunkView(300, 0, payload, true, false, true), nullptr);
+
+    EXPECT_EQ(reassembler_->getBudgetEvictions(), 1u);
+    EXPECT_EQ(reassembler_->getDroppedFragments(), 2u);
+    EXPECT_EQ(reassembler_->getBufferedBytes(), 0u);
+    EXPECT_EQ(reassembler_->getStreamContext(0)->buffered_fragments, 0u);
+
+    // The stream keeps working after the eviction
+    std::vector<uint8_t> small = {0x01};
+    EXPECT_EQ(reassembler_->addChunk(chunkView(301, 0, small, false, true, true), nullptr), 0u);
+    EXPECT_EQ(reassembler_->addChunk(chunkView(302, 0, small, true, true, true), nullptr), 1u);
 }
 
 int main(int argc, char** argv) {
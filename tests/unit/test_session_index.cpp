@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "api_server/session_index.h"
+#include "api_server/session_summary.h"
+
+using namespace callflow;
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("callflow_" + name)).string();
+}
+
+JobInfo makeJob(const std::string& job_id, const std::string& output) {
+    JobInfo job;
+    job.job_id = job_id;
+    job.output_filename = output;
+    job.status = JobStatus::COMPLETED;
+    return job;
+}
+
+void removeResult(const std::string& path) {
+    std::filesystem::remove(path);
+    std::filesystem::remove(SessionIndex::sidecarPath(path));
+    std::filesystem::remove(SessionSummaryTable::sidecarPath(path));
+}
+
+}  // namespace
+
+TEST(SessionIndexTest, WriterProducesValidDocumentAndIndex) {
+    auto path = tempPath("results_writer.json");
+
+    SessionResultWriter writer;
+    ASSERT_TRUE(writer.open(path, {{"job_id", "job-1"}}));
+    writer.addSession({{"master_id", "m-1"}, {"imsi", "001010000000001"}});
+    writer.addSession({{"session_id", "sip-2"}, {"call_id", "abc@host"}});
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(writer.sessionCount(), 2u);
+
+    // The whole document still parses for endpoints that read it in full
+    std::ifstream in(path);
+    nlohmann::json doc;
+    in >> doc;
+    EXPECT_EQ(doc["metadata"]["job_id"], "job-1");
+    ASSERT_EQ(doc["sessions"].size(), 2u);
+
+    auto index = SessionIndex::load(SessionIndex::sidecarPath(path));
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->size(), 2u);
+
+    const auto* entry = index->find("sip-2");
+    ASSERT_NE(entry, nullptr);
+    auto session = SessionIndex::readSession(path, *entry);
+    EXPECT_EQ(session["call_id"], "abc@host");
+    EXPECT_EQ(index->find("missing"), nullptr);
+
+    // The summary rows point at the same byte ranges
+    auto summary = SessionSummaryTable::load(SessionSummaryTable::sidecarPath(path));
+    ASSERT_NE(summary, nullptr);
+    ASSERT_EQ(summary->size(), 2u);
+    EXPECT_EQ(summary->sessionId(0), "m-1");
+    EXPECT_EQ(summary->imsi(0), "001010000000001");
+    EXPECT_EQ(summary->range(1).offset, entry->offset);
+
+    removeResult(path);
+}
+
+TEST(SessionIndexTest, StoreServesIndexedAndCachedSessions) {
+    auto path = tempPath("results_store.json");
+    SessionResultWriter writer;
+    ASSERT_TRUE(writer.open(path, nlohmann::json::object()));
+    for (int i = 0; i < 10; ++i) {
+        writer.addSession({{"session_id", "s-" + std::to_string(i)}, {"n", i}});
+    }
+    ASSERT_TRUE(writer.close());
+
+    SessionStore store(4);
+    JobInfo job = makeJob("job-2", path);
+
+    auto session = store.find(job, "s-7");
+    ASSERT_NE(session, nullptr);
+    EXPECT_EQ((*session)["n"], 7);
+    EXPECT_EQ(store.find(job, "s-99"), nullptr);
+
+    // A cached session is served even after the file is gone
+    std::filesystem::remove(path);
+    auto cached = store.find(job, "s-7");
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached.get(), session.get());
+
+    store.invalidateJob("job-2");
+    std::filesystem::remove(SessionIndex::sidecarPath(path));
+    EXPECT_EQ(store.find(job, "s-7"), nullptr);
+}
+
+TEST(SessionIndexTest, StoreFallsBackToFullScanWithoutIndex) {
+    auto path = tempPath("results_legacy.json");
+    {
+        std::ofstream out(path);
+        nlohmann::json doc = {{"sessions", {{{"master_id", "legacy-1"}, {"n", 1}}}}};
+        out << doc.dump(4);
+    }
+
+    SessionStore store;
+    JobInfo job = makeJob("job-3", path);
+
+    EXPECT_EQ(store.find(job, "legacy-1", false), nullptr);
+    auto session = store.find(job, "legacy-1");
+    ASSERT_NE(session, nullptr);
+    EXPECT_EQ((*session)["n"], 1);
+
+    removeResult(path);
+}
+
+TEST(SessionIndexTest, StoreKeepsRecentSummariesOnly) {
+    SessionStore store(4, 2);
+    std::vector<JobInfo> jobs;
+    for (int i = 0; i < 3; ++i) {
+        auto path = tempPath("results_summary_" + std::to_string(i) + ".json");
+        jobs.push_back(makeJob("job-s" + std::to_string(i), path));
+    }
+
+    // A job without a summary is retried once the sidecar exists
+    EXPECT_EQ(store.summaryFor(jobs[0]), nullptr);
+    for (const auto& job : jobs) {
+        SessionResultWriter writer;
+        ASSERT_TRUE(writer.open(job.output_filename, nlohmann::json::object()));
+        writer.addSession({{"session_id", job.job_id}});
+        ASSERT_TRUE(writer.close());
+    }
+    auto first = store.summaryFor(jobs[0]);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(store.summaryFor(jobs[0]).get(), first.get());
+
+    // Loading a third summary evicts the least recently used one
+    ASSERT_NE(store.summaryFor(jobs[1]), nullptr);
+    ASSERT_NE(store.summaryFor(jobs[2]), nullptr);
+    auto reloaded = store.summaryFor(jobs[0]);
+    ASSERT_NE(reloaded, nullptr);
+    EXPECT_NE(reloaded.get(), first.get());
+
+    // Invalidation drops the summary of a removed job
+    removeResult(jobs[0].output_filename);
+    store.invalidateJob(jobs[0].job_id);
+    EXPECT_EQ(store.summaryFor(jobs[0]), nullptr);
+
+    removeResult(jobs[1].output_filename);
+    removeResult(jobs[2].output_filename);
+}
+
+TEST(SessionIndexTest, StoreKeepsRecentIndexesOnly) {
+    SessionStore store(1, 1, 2);
+    std::vector<JobInfo> jobs;
+    for (int i = 0; i < 3; ++i) {
+        auto path = tempPath("results_index_" + std::to_string(i) + ".json");
+        jobs.push_back(makeJob("job-i" + std::to_string(i), path));
+        SessionResultWriter writer;
+        ASSERT_TRUE(writer.open(path, nlohmann::json::object()));
+        writer.addSession({{"session_id", "a"}});
+        writer.addSession({{"session_id", "b"}});
+        ASSERT_TRUE(writer.close());
+    }
+    for (const auto& job : jobs) {
+        ASSERT_NE(store.find(job, "a", false), nullptr);
+    }
+
+    // Without their sidecars, only jobs whose index is still cached can serve "b"
+    for (const auto& job : jobs) {
+        std::filesystem::remove(SessionIndex::sidecarPath(job.output_filename));
+    }
+    EXPECT_EQ(store.find(jobs[0], "b", false), nullptr);
+    EXPECT_NE(store.find(jobs[2], "b", false), nullptr);
+
+    // Invalidation drops the index along with the cached sessions
+    store.invalidateJob(jobs[2].job_id);
+    EXPECT_EQ(store.find(jobs[2], "b", false), nullptr);
+
+    for (const auto& job : jobs) {
+        removeResult(job.output_filename);
+    }
+}
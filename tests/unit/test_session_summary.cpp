@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include "api_server/session_summary.h"
+
+using namespace callflow;
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("callflow_" + name)).string();
+}
+
+nlohmann::json makeSession(int i) {
+    nlohmann::json session = {{"session_id", "s-" + std::to_string(i)},
+                              {"imsi", "00101000000000" + std::to_string(i % 4)},
+                              {"msisdn", "4670000000" + std::to_string(i % 3)},
+                              {"start_time", 1000 + (i * 7) % 10},
+                              {"end_time", 2000 + i},
+                              {"events", nlohmann::json::array({1, 2, 3})},
+                              {"metrics", {{"packets", i}, {"bytes", 100 * i}}}};
+    if (i % 5 == 0) {
+        session["session_type"] = "SIP_ONLY";
+    }
+    return session;
+}
+
+void fillTable(SessionSummaryTable& table, int rows) {
+    for (int i = 0; i < rows; ++i) {
+        table.add(makeSession(i), {static_cast<uint64_t>(i) * 10, 10});
+    }
+}
+
+}  // namespace
+
+TEST(SessionSummaryTest, SaveAndLoadRoundTrip) {
+    auto path = tempPath("summary_roundtrip.sum");
+    SessionSummaryTable table;
+    fillTable(table, 20);
+    ASSERT_TRUE(table.save(path));
+
+    auto loaded = SessionSummaryTable::load(path);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(loaded->size(), 20u);
+    EXPECT_EQ(loaded->sessionId(7), "s-7");
+    EXPECT_EQ(loaded->type(5), "SIP_ONLY");
+    EXPECT_EQ(loaded->type(6), "MASTER");
+    EXPECT_EQ(loaded->imsi(6), "001010000000002");
+    EXPECT_EQ(loaded->range(3).offset, 30u);
+
+    auto row = loaded->rowToJson(4);
+    EXPECT_EQ(row["packets"], 4);
+    EXPECT_EQ(row["bytes"], 400);
+    EXPECT_EQ(row["event_count"], 3);
+
+    // A truncated sidecar is rejected, not half-loaded
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    EXPECT_EQ(SessionSummaryTable::load(path), nullptr);
+    std::filesystem::remove(path);
+    EXPECT_EQ(SessionSummaryTable::load(path), nullptr);
+}
+
+TEST(SessionSummaryTest, KeysetPagesCoverEveryRowOnce) {
+    SessionSummaryTable table;
+    fillTable(table, 103);
+    for (bool descending : {false, true}) {
+        SessionSummaryTable::Query query;
+        query.limit = 10;
+        query.descending = descending;
+
+        std::set<uint32_t> seen;
+        int64_t previous = descending ? INT64_MAX : INT64_MIN;
+        size_t pages = 0;
+        while (true) {
+            auto page = table.query(query);
+            EXPECT_EQ(page.total, 103u);
+            for (uint32_t row : page.rows) {
+                EXPECT_TRUE(seen.insert(row).second);
+                int64_t start = table.startTime(row);
+                EXPECT_TRUE(descending ? start <= previous : start >= previous);
+                previous = start;
+            }
+            ++pages;
+            if (page.next_cursor.empty()) {
+                break;
+            }
+            query.cursor = page.next_cursor;
+        }
+        EXPECT_EQ(seen.size(), 103u);
+        EXPECT_EQ(pages, 11u);
+    }
+}
+
+TEST(SessionSummaryTest, FiltersAndOffsetPaging) {
+    SessionSummaryTable table;
+    fillTable(table, 60);
+
+    SessionSummaryTable::Query query;
+    query.imsi = "001010000000001";
+    query.limit = 100;
+    auto page = table.query(query);
+    EXPECT_EQ(page.total, 15u);
+    EXPECT_EQ(page.rows.size(), 15u);
+    EXPECT_TRUE(page.next_cursor.empty());
+
+    // IMSI and MSISDN together: i % 4 == 1 and i % 3 == 2
+    query.msisdn = "46700000002";
+    page = table.query(query);
+    EXPECT_EQ(page.total, 5u);
+    for (uint32_t row : page.rows) {
+        EXPECT_EQ(row % 12, 5u);
+    }
+
+    SessionSummaryTable::Query by_type;
+    by_type.type = "SIP_ONLY";
+    by_type.sort = SessionSummaryTable::SortKey::BYTES;
+    by_type.limit = 5;
+    by_type.offset = 5;
+    page = table.query(by_type);
+    EXPECT_EQ(page.total, 12u);
+    ASSERT_EQ(page.rows.size(), 5u);
+    EXPECT_EQ(page.rows.front(), 25u);  // Sixth SIP-only session by bytes
+
+    by_type.type = "UNKNOWN";
+    EXPECT_EQ(table.query(by_type).total, 0u);
+
+    SessionSummaryTable::Query bad;
+    bad.cursor = "not-a-cursor";
+    EXPECT_THROW(table.query(bad), std::invalid_argument);
+}
+
+TEST(SessionSummaryTest, ParseSortKey) {
+    SessionSummaryTable::SortKey key;
+    EXPECT_TRUE(SessionSummaryTable::parseSortKey("duration", key));
+    EXPECT_EQ(key, SessionSummaryTable::SortKey::DURATION);
+    EXPECT_FALSE(SessionSummaryTable::parseSortKey("imsi", key));
+}
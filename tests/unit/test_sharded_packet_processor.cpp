@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pcap_ingest/sharded_packet_processor.h"
+
+using namespace callflow;
+
+namespace {
+
+constexpr int DLT_RAW_IP = 12;
+
+std::vector<uint8_t> buildIpv4Udp(const std::array<uint8_t, 4>& src, const std::array<uint8_t, 4>& dst,
+                                  uint16_t sport, uint16_t dport,
+                                  const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> pkt(28 + payload.size(), 0);
+    size_t total = pkt.size();
+    pkt[0] = 0x45;
+    pkt[2] = static_cast<uint8_t>(total >> 8);
+    pkt[3] = static_cast<uint8_t>(total & 0xFF);
+    pkt[8] = 64;
+    pkt[9] = 17;  // UDP
+    std::copy(src.begin(), src.end(), pkt.begin() + 12);
+    std::copy(dst.begin(), dst.end(), pkt.begin() + 16);
+    pkt[20] = static_cast<uint8_t>(sport >> 8);
+    pkt[21] = static_cast<uint8_t>(sport & 0xFF);
+    pkt[22] = static_cast<uint8_t>(dport >> 8);
+    pkt[23] = static_cast<uint8_t>(dport & 0xFF);
+    size_t udp_len = 8 + payload.size();
+    pkt[24] = static_cast<uint8_t>(udp_len >> 8);
+    pkt[25] = static_cast<uint8_t>(udp_len & 0xFF);
+    std::copy(payload.begin(), payload.end(), pkt.begin() + 28);
+    return pkt;
+}
+
+std::vector<uint8_t> buildGtpu(uint32_t teid, const std::vector<uint8_t>& inner) {
+    std::vector<uint8_t> gtp(8 + inner.size());
+    gtp[0] = 0x30;  // Version 1, PT=1
+    gtp[1] = 0xFF;  // G-PDU
+    gtp[2] = static_cast<uint8_t>(inner.size() >> 8);
+    gtp[3] = static_cast<uint8_t>(inner.size() & 0xFF);
+    gtp[4] = static_cast<uint8_t>(teid >> 24);
+    gtp[5] = static_cast<uint8_t>(teid >> 16);
+    gtp[6] = static_cast<uint8_t>(teid >> 8);
+    gtp[7] = static_cast<uint8_t>(teid);
+    std::copy(inner.begin(), inner.end(), gtp.begin() + 8);
+    return gtp;
+}
+
+std::vector<uint8_t> sipInvite(const std::string& call_id) {
+    std::string msg =
+        "INVITE sip:bob@example.com SIP/2.0\r\n"
+        "Via: SIP/2.0/UDP 10.0.0.1:5060;branch=z9hG4bK-" + call_id + "\r\n"
+        "From: <sip:alice@example.com>;tag=1\r\n"
+        "To: <sip:bob@example.com>\r\n"
+        "Call-ID: " + call_id + "\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "Content-Length: 0\r\n\r\n";
+    return std::vector<uint8_t>(msg.begin(), msg.end());
+}
+
+}  // namespace
+
+TEST(ShardedPacketProcessorTest, FlowHashIsSymmetric) {
+    std::vector<uint8_t> payload(16, 0xAB);
+    auto forward = buildIpv4Udp({10, 0, 0, 1}, {10, 0, 0, 2}, 40000, 5060, payload);
+    auto reverse = buildIpv4Udp({10, 0, 0, 2}, {10, 0, 0, 1}, 5060, 40000, payload);
+    auto other = buildIpv4Udp({10, 0, 0, 3}, {10, 0, 0, 2}, 40000, 5060, payload);
+
+    uint64_t h_fwd = ShardedPacketProcessor::flowHash(forward.data(), forward.size());
+    uint64_t h_rev = ShardedPacketProcessor::flowHash(reverse.data(), reverse.size());
+    uint64_t h_other = ShardedPacketProcessor::flowHash(other.data(), other.size());
+
+    EXPECT_NE(h_fwd, 0u);
+    EXPECT_EQ(h_fwd, h_rev);
+    EXPECT_NE(h_fwd, h_other);
+}
+
+TEST(ShardedPacketProcessorTest, GtpuHashesOnInnerFlow) {
+    std::vector<uint8_t> payload(16, 0x11);
+    auto inner_ul = buildIpv4Udp({172, 16, 0, 5}, {192, 168, 1, 1}, 30000, 5060, payload);
+    auto inner_dl = buildIpv4Udp({192, 168, 1, 1}, {172, 16, 0, 5}, 5060, 30000, payload);
+
+    // Uplink and downlink use different TEIDs and different outer endpoints
+    auto outer_ul = buildIpv4Udp({10, 1, 0, 1}, {10, 2, 0, 1}, 2152, 2152, buildGtpu(0x1000, inner_ul));
+    auto outer_dl = buildIpv4Udp({10, 2, 0, 1}, {10, 1, 0, 1}, 2152, 2152, buildGtpu(0x2000, inner_dl));
+
+    uint64_t h_ul = ShardedPacketProcessor::flowHash(outer_ul.data(), outer_ul.size());
+    uint64_t h_dl = ShardedPacketProcessor::flowHash(outer_dl.data(), outer_dl.size());
+    uint64_t h_inner = ShardedPacketProcessor::flowHash(inner_ul.data(), inner_ul.size());
+
+    EXPECT_EQ(h_ul, h_dl);
+    EXPECT_EQ(h_ul, h_inner);
+}
+
+TEST(ShardedPacketProcessorTest, InvalidDatagramHashesToZero) {
+    std::vector<uint8_t> garbage = {0x00, 0x01, 0x02};
+    EXPECT_EQ(ShardedPacketProcessor::flowHash(garbage.data(), garbage.size()), 0u);
+    EXPECT_EQ(ShardedPacketProcessor::flowHash(nullptr, 0), 0u);
+}
+
+TEST(ShardedPacketProcessorTest, ShardedRunMatchesSingleShard) {
+    std::vector<std::vector<uint8_t>> packets;
+    for (int i = 0; i < 40; ++i) {
+        std::array<uint8_t, 4> ue = {10, 0, static_cast<uint8_t>(i / 200),
+                                     static_cast<uint8_t>(1 + i % 200)};
+        packets.push_back(buildIpv4Udp(ue, {10, 255, 0, 1}, static_cast<uint16_t>(20000 + i), 5060,
+                                       sipInvite("call-" + std::to_string(i))));
+    }
+
+    auto run = [&](size_t shards) {
+        EnhancedSessionCorrelator correlator;
+        ShardedPacketProcessor processor(correlator, shards);
+        auto ts = std::chrono::system_clock::now();
+        uint32_t frame = 0;
+        for (const auto& pkt : packets) {
+            processor.processPacket(pkt.data(), pkt.size(), ts, frame++, DLT_RAW_IP);
+        }
+        processor.finish();
+
+        uint64_t total = 0;
+        for (const auto& s : processor.getShardStats()) {
+            total += s.packets;
+        }
+        EXPECT_EQ(total, packets.size());
+        EXPECT_EQ(processor.getShardCount(), shards);
+        return correlator.getSipOnlySessionCount();
+    };
+
+    size_t single = run(1);
+    size_t sharded = run(4);
+    EXPECT_EQ(single, packets.size());
+    EXPECT_EQ(sharded, single);
+}
+
+TEST(ShardedPacketProcessorTest, MergesDuringIngestInCaptureOrder) {
+    // Several merge intervals, so most output is replayed before finish()
+    const int calls = 3000;
+    std::vector<std::vector<uint8_t>> packets;
+    for (int i = 0; i < calls * 4; ++i) {
+        int call = i % calls;
+        std::array<uint8_t, 4> ue = {10, 1, static_cast<uint8_t>(call / 200),
+                                     static_cast<uint8_t>(1 + call % 200)};
+        packets.push_back(buildIpv4Udp(ue, {10, 255, 0, 1}, static_cast<uint16_t>(20000 + call),
+                                       5060, sipInvite("call-" + std::to_string(call))));
+    }
+
+    auto run = [&](size_t shards) {
+        EnhancedSessionCorrelator correlator;
+        // Shallow queues keep the workers close behind the dispatcher
+        ShardedPacketProcessor processor(correlator, shards, 64);
+        auto ts = std::chrono::system_clock::now();
+        uint32_t frame = 0;
+        for (const auto& pkt : packets) {
+            processor.processPacket(pkt.data(), pkt.size(), ts, frame++, DLT_RAW_IP);
+        }
+        // Sessions reach the correlator before the final merge
+        EXPECT_GT(correlator.getSipOnlySessionCount(), 0u);
+
+        size_t last_merged = 0;
+        processor.finish([&](size_t merged, size_t total) {
+            EXPECT_LE(merged, total);
+            EXPECT_GE(merged, last_merged);
+            last_merged = merged;
+        });
+
+        uint64_t inputs = 0;
+        for (const auto& s : processor.getShardStats()) {
+            inputs += s.correlator_inputs;
+        }
+        if (shards > 1) {
+            EXPECT_EQ(inputs, packets.size());
+        }
+        return correlator.getSipOnlySessionCount();
+    };
+
+    size_t single = run(1);
+    EXPECT_EQ(single, static_cast<size_t>(calls));
+    EXPECT_EQ(run(4), single);
+}
+
+TEST(ShardedPacketProcessorTest, AbortStopsWorkersWithoutMerging) {
+    EnhancedSessionCorrelator correlator;
+    {
+        // Released right after abort(), as a reader unmapping its capture would
+        std::vector<std::vector<uint8_t>> packets;
+        for (int i = 0; i < 2000; ++i) {
+            std::array<uint8_t, 4> ue = {10, 2, static_cast<uint8_t>(i / 200),
+                                         static_cast<uint8_t>(1 + i % 200)};
+            packets.push_back(buildIpv4Udp(ue, {10, 255, 0, 1}, static_cast<uint16_t>(20000 + i),
+                                           5060, sipInvite("call-" + std::to_string(i))));
+        }
+
+        ShardedPacketProcessor processor(correlator, 4);
+        processor.setStableInput(true);
+        auto ts = std::chrono::system_clock::now();
+        uint32_t frame = 0;
+        for (const auto& pkt : packets) {
+            processor.processPacket(pkt.data(), pkt.size(), ts, frame++, DLT_RAW_IP);
+        }
+        processor.abort();
+        packets.clear();
+
+        // finish() after abort() neither merges nor touches the released input
+        processor.finish();
+    }
+    // Fewer packets than one merge interval: nothing reached the correlator
+    EXPECT_EQ(correlator.getSipOnlySessionCount(), 0u);
+}
+
+TEST(ShardedPacketProcessorTest, AbortGuardJoinsWorkersBeforeInputIsReleased) {
+    EnhancedSessionCorrelator correlator;
+    ShardedPacketProcessor processor(correlator, 4);
+    processor.setStableInput(true);
+    try {
+        // Destroyed after the guard, as a reader declared before it would be
+        std::vector<std::vector<uint8_t>> packets;
+        for (int i = 0; i < 2000; ++i) {
+            std::array<uint8_t, 4> ue = {10, 3, static_cast<uint8_t>(i / 200),
+                                         static_cast<uint8_t>(1 + i % 200)};
+            packets.push_back(buildIpv4Udp(ue, {10, 255, 0, 1}, static_cast<uint16_t>(20000 + i),
+                                           5060, sipInvite("guard-" + std::to_string(i))));
+        }
+        ShardAbortGuard shard_guard(processor);
+
+        auto ts = std::chrono::system_clock::now();
+        uint32_t frame = 0;
+        for (const auto& pkt : packets) {
+            processor.processPacket(pkt.data(), pkt.size(), ts, frame++, DLT_RAW_IP);
+        }
+        throw std::runtime_error("ingest failed");
+    } catch (const std::runtime_error&) {
+    }
+
+    processor.finish();
+    EXPECT_EQ(correlator.getSipOnlySessionCount(), 0u);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "pcap_ingest/protocol_framer.h"
+#include "protocol_parsers/sip_scanner.h"
+
+using namespace callflow;
+
+namespace {
+
+const std::vector<sip::ScanIsa> kAllIsas = {sip::ScanIsa::SCALAR, sip::ScanIsa::SSE2,
+                                            sip::ScanIsa::AVX2};
+
+const uint8_t* bytes(const std::string& text) {
+    return reinterpret_cast<const uint8_t*>(text.data());
+}
+
+}  // namespace
+
+TEST(SipScannerTest, FindsHeaderEndAcrossVectorWidths) {
+    // Lone CRLFs before the terminator, which lands on every offset of a
+    // 16 and 32 byte block, plus the scalar tail
+    for (size_t offset = 0; offset < 80; ++offset) {
+        std::string text(offset, 'a');
+        for (size_t i = 2; i < offset; i += 7) {
+            text[i - 2] = '\r';
+            text[i - 1] = '\n';
+        }
+        text += "\r\n\r\nbody";
+        for (auto isa : kAllIsas) {
+            EXPECT_EQ(sip::findHeaderEnd(bytes(text), text.size(), isa), offset + 4)
+                << "offset " << offset << " isa " << sip::scanIsaName(isa);
+            EXPECT_EQ(sip::findHeaderEnd(bytes(text), offset + 3, isa), 0u);
+        }
+    }
+}
+
+TEST(SipScannerTest, MatchesHeaderNamesAtLineStartsOnly) {
+    const std::string headers =
+        "INVITE tel:+491510000002 SIP/2.0\r\n"
+        "To: <tel:+491510000002;phone-context=ims.example.com>\r\n"
+        "X-Content-Length: 99\r\n"
+        "From: <sip:alice@ims.example.com>;tag=1\r\n"
+        "CONTENT-length \t: 129\r\n"
+        "\r\n";
+    for (auto isa : kAllIsas) {
+        size_t value =
+            sip::findHeaderValue(bytes(headers), headers.size(), "Content-Length", 'l', isa);
+        ASSERT_NE(value, sip::kNoMatch) << sip::scanIsaName(isa);
+        EXPECT_EQ(headers.substr(value, 5), " 129\r");
+        EXPECT_EQ(sip::findHeaderValue(bytes(headers), headers.size(), "Max-Forwards", 0, isa),
+                  sip::kNoMatch);
+    }
+    EXPECT_EQ(sip::findContentLength(bytes(headers), headers.size()), 129u);
+
+    // "tel:" / "url:" must not be read as the compact "l" form
+    const std::string compact =
+        "BYE sip:bob@192.0.2.2 SIP/2.0\r\n"
+        "t: <tel:+4915>\r\n"
+        "Call-Info: <http://example.com/url:1>\r\n"
+        "L:42\r\n"
+        "\r\n";
+    for (auto isa : kAllIsas) {
+        EXPECT_EQ(sip::findContentLength(bytes(compact), compact.size(), isa), 42u);
+    }
+
+    const std::string missing = "ACK sip:bob@192.0.2.2 SIP/2.0\r\nTo: <tel:+4915>\r\n\r\n";
+    EXPECT_EQ(sip::findContentLength(bytes(missing), missing.size()), 0u);
+}
+
+TEST(SipScannerTest, CompleteMessageLengthWaitsForBody) {
+    const std::string first =
+        "MESSAGE sip:bob@192.0.2.2 SIP/2.0\r\n"
+        "To: <tel:+4915>\r\n"
+        "Content-Length: 5\r\n"
+        "\r\n"
+        "hello";
+    const std::string stream = first + "OPTIONS sip:bob@192.0.2.2 SIP/2.0\r\nl: 0\r\n\r\n";
+
+    EXPECT_EQ(sip::completeMessageLength(bytes(stream), stream.size()), first.size());
+    EXPECT_EQ(sip::completeMessageLength(bytes(first), first.size() - 1), 0u);
+    EXPECT_EQ(sip::completeMessageLength(bytes(stream) + first.size(),
+                                         stream.size() - first.size()),
+              stream.size() - first.size());
+}
+
+TEST(SipFramerTest, DeliversMessagesSplitAcrossSegments) {
+    const std::string invite =
+        "INVITE sip:bob@192.0.2.2 SIP/2.0\r\n"
+        "To: <tel:+491510000002>\r\n"
+        "Content-Length: 4\r\n"
+        "\r\n"
+        "v=0\n";
+    const std::string bye = "BYE sip:bob@192.0.2.2 SIP/2.0\r\nl: 0\r\n\r\n";
+    const std::string stream = invite + bye + invite;
+
+    SipFramer framer;
+    std::vector<std::string> messages;
+    framer.setMessageCallback([&](const uint8_t* data, size_t len) {
+        messages.emplace_back(reinterpret_cast<const char*>(data), len);
+    });
+
+    // Feed in 7-byte segments so boundaries fall inside headers and bodies
+    for (size_t pos = 0; pos < stream.size(); pos += 7) {
+        size_t len = std::min<size_t>(7, stream.size() - pos);
+        framer.processData(bytes(stream) + pos, len);
+    }
+
+    ASSERT_EQ(messages.size(), 3u);
+    EXPECT_EQ(messages[0], invite);
+    EXPECT_EQ(messages[1], bye);
+    EXPECT_EQ(messages[2], invite);
+    EXPECT_FALSE(framer.flush());
+}
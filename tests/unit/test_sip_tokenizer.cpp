@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "protocol_parsers/sip_parser.h"
+#include "protocol_parsers/sip_tokenizer.h"
+
+using namespace callflow;
+
+namespace {
+
+std::optional<SipMessage> parseText(const std::string& text) {
+    SipParser parser;
+    return parser.parse(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+}  // namespace
+
+TEST(SipTokenizerTest, SplitsStartLineHeadersAndBody) {
+    const std::string text =
+        "\r\n"
+        "SIP/2.0 183 Session Progress\r\n"
+        "Via: SIP/2.0/UDP 192.0.2.1:5060;branch=z9hG4bK1\r\n"
+        "Subject: multi\r\n"
+        " line\r\n"
+        "\r\n"
+        "v=0\r\n";
+
+    sip::MessageTokenizer tokenizer(text);
+    sip::StartLine start;
+    ASSERT_TRUE(tokenizer.startLine(start));
+    EXPECT_FALSE(start.is_request);
+    EXPECT_EQ(start.status_code, 183);
+    EXPECT_EQ(start.reason, "Session Progress");
+
+    sip::HeaderField field;
+    ASSERT_TRUE(tokenizer.nextHeader(field));
+    EXPECT_EQ(field.id, sip::HeaderId::VIA);
+    EXPECT_EQ(field.value, "SIP/2.0/UDP 192.0.2.1:5060;branch=z9hG4bK1");
+    EXPECT_FALSE(field.folded);
+
+    ASSERT_TRUE(tokenizer.nextHeader(field));
+    EXPECT_EQ(field.id, sip::HeaderId::UNKNOWN);
+    EXPECT_EQ(field.name, "Subject");
+    EXPECT_TRUE(field.folded);
+    EXPECT_EQ(sip::unfold(field.value), "multi line");
+
+    EXPECT_FALSE(tokenizer.nextHeader(field));
+    EXPECT_TRUE(tokenizer.hasBody());
+    EXPECT_EQ(tokenizer.body(), "v=0\r\n");
+
+    // Views point into the caller's buffer
+    EXPECT_GE(field.value.data(), text.data());
+    EXPECT_LT(field.value.data(), text.data() + text.size());
+}
+
+TEST(SipTokenizerTest, RejectsNonSipStartLines) {
+    sip::StartLine start;
+    EXPECT_FALSE(sip::MessageTokenizer("GET / HTTP/1.1\r\n\r\n").startLine(start));
+    EXPECT_FALSE(sip::MessageTokenizer("SIP/2.0 abc OK\r\n").startLine(start));
+    EXPECT_FALSE(sip::MessageTokenizer("INVITE SIP/2.0\r\n").startLine(start));
+    EXPECT_FALSE(sip::MessageTokenizer("").startLine(start));
+}
+
+TEST(SipTokenizerTest, LooksUpCompactAndMixedCaseNames) {
+    EXPECT_EQ(sip::lookupHeader("i"), sip::HeaderId::CALL_ID);
+    EXPECT_EQ(sip::lookupHeader("I"), sip::HeaderId::CALL_ID);
+    EXPECT_EQ(sip::lookupHeader("call-id"), sip::HeaderId::CALL_ID);
+    EXPECT_EQ(sip::lookupHeader("k"), sip::HeaderId::SUPPORTED);
+    EXPECT_EQ(sip::lookupHeader("x"), sip::HeaderId::SESSION_EXPIRES);
+    EXPECT_EQ(sip::lookupHeader("p-charging-vector"), sip::HeaderId::P_CHARGING_VECTOR);
+    EXPECT_EQ(sip::lookupHeader("X-Custom"), sip::HeaderId::UNKNOWN);
+    EXPECT_EQ(sip::lookupHeader("z"), sip::HeaderId::UNKNOWN);
+}
+
+TEST(SipTokenizerTest, ExtractsUriParts) {
+    EXPECT_EQ(sip::uriUser("sip:+491510000001@ims.example.com;user=phone"), "+491510000001");
+    EXPECT_EQ(sip::uriHost("sip:alice@pcscf.example.com:5060;lr"), "pcscf.example.com");
+    EXPECT_EQ(sip::uriUser("sip:@bad sip:bob@host"), "bob");
+    EXPECT_EQ(sip::uriUser("tel:+4915"), "");
+    EXPECT_EQ(sip::uriHost("sip:alice@"), "");
+    EXPECT_EQ(sip::headerParameter("<sip:a@b>;xtag=1;tag=abc ", "tag"), "abc");
+}
+
+TEST(SipParserTokenizedTest, ParsesCompactFormMessage) {
+    const std::string text =
+        "INVITE sip:bob@ims.example.com SIP/2.0\r\n"
+        "v: SIP/2.0/UDP 192.0.2.1:5060;branch=z9hG4bKtop\r\n"
+        "v: SIP/2.0/UDP 192.0.2.2:5060;branch=z9hG4bKsecond\r\n"
+        "f: <sip:alice@ims.example.com>;tag=from1\r\n"
+        "t: <sip:bob@ims.example.com>\r\n"
+        "i: compact-call@192.0.2.1\r\n"
+        "CSeq: 1 INVITE\r\n"
+        "m: <sip:alice@192.0.2.1:5060>\r\n"
+        "k: 100rel, timer\r\n"
+        "x: 1800; refresher=uac\r\n"
+        "c: application/sdp\r\n"
+        "l: 52\r\n"
+        "\r\n"
+        "v=0\r\n"
+        "c=IN IP4 192.0.2.1\r\n"
+        "m=audio 49170 RTP/AVP 0\r\n";
+
+    auto msg = parseText(text);
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_TRUE(msg->is_request);
+    EXPECT_EQ(msg->method, "INVITE");
+    EXPECT_EQ(msg->request_uri, "sip:bob@ims.example.com");
+    EXPECT_EQ(msg->call_id, "compact-call@192.0.2.1");
+    EXPECT_EQ(msg->from_tag, "from1");
+    EXPECT_EQ(msg->contact, "<sip:alice@192.0.2.1:5060>");
+    EXPECT_EQ(msg->via_branch, "z9hG4bKtop");
+    ASSERT_EQ(msg->via_list.size(), 2u);
+    ASSERT_EQ(msg->supported.size(), 2u);
+    EXPECT_EQ(msg->supported[1], "timer");
+    ASSERT_TRUE(msg->session_expires.has_value());
+    EXPECT_EQ(msg->session_expires->expires, 1800u);
+    EXPECT_EQ(msg->body, "v=0\nc=IN IP4 192.0.2.1\nm=audio 49170 RTP/AVP 0\n");
+    ASSERT_TRUE(msg->sdp.has_value());
+    EXPECT_EQ(msg->sdp->connection_address, "192.0.2.1");
+    EXPECT_EQ(msg->sdp->rtp_port, 49170);
+    EXPECT_EQ(msg->headers.at("i"), "compact-call@192.0.2.1");
+}
+
+TEST(SipParserTokenizedTest, AccumulatesRepeatedListHeaders) {
+    const std::string text =
+        "SIP/2.0 200 OK\r\n"
+        "call-id: repeated@example.com\r\n"
+        "P-Asserted-Identity: <sip:+491510000001@ims.example.com>\r\n"
+        "P-Asserted-Identity: <tel:+491510000001>\r\n"
+        "Record-Route: <sip:scscf.example.com;lr>\r\n"
+        "Record-Route: <sip:pcscf.example.com;lr>, <sip:sbc.example.com;lr>\r\n"
+        "Min-SE: 90\r\n"
+        "\r\n";
+
+    auto msg = parseText(text);
+    ASSERT_TRUE(msg.has_value());
+    EXPECT_FALSE(msg->is_request);
+    EXPECT_EQ(msg->status_code, 200);
+    EXPECT_EQ(msg->reason_phrase, "OK");
+    EXPECT_EQ(msg->call_id, "repeated@example.com");
+    ASSERT_TRUE(msg->p_asserted_identity.has_value());
+    ASSERT_EQ(msg->p_asserted_identity->size(), 2u);
+    EXPECT_EQ((*msg->p_asserted_identity)[1].uri, "tel:+491510000001");
+    EXPECT_EQ(msg->record_route.size(), 3u);
+    EXPECT_EQ(msg->min_se, 90u);
+    EXPECT_TRUE(msg->body.empty());
+    EXPECT_FALSE(msg->sdp.has_value());
+}
+
+TEST(SipParserTokenizedTest, ExtractCallIdSkipsUriText) {
+    // "sip:" contains "i:", which must not be mistaken for the compact Call-ID
+    const std::string text =
+        "BYE sip:bob@192.0.2.2 SIP/2.0\r\n"
+        "From: <sip:alice@example.com>;tag=1\r\n"
+        "Call-ID: real-id@example.com\r\n"
+        "\r\n";
+    auto call_id = SipParser::extractCallId(reinterpret_cast<const uint8_t*>(text.data()),
+                                            text.size());
+    ASSERT_TRUE(call_id.has_value());
+    EXPECT_EQ(*call_id, "real-id@example.com");
+
+    const std::string compact = "ACK sip:bob@192.0.2.2 SIP/2.0\r\ni:  short-id \r\n\r\n";
+    call_id = SipParser::extractCallId(reinterpret_cast<const uint8_t*>(compact.data()),
+                                       compact.size());
+    ASSERT_TRUE(call_id.has_value());
+    EXPECT_EQ(*call_id, "short-id");
+}
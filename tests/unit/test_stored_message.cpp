@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "common/utils.h"
+#include "session/session_types.h"
+
+using namespace callflow;
+
+namespace {
+
+SessionMessageRef makeMessage(int64_t ms) {
+    SessionMessageRef msg;
+    msg.message_id = utils::generateUuid();
+    msg.packet_id = makePacketId(7, static_cast<uint32_t>(ms));
+    msg.timestamp = Timestamp(std::chrono::milliseconds(ms));
+    msg.interface = InterfaceType::S11;
+    msg.protocol = ProtocolType::GTP_C;
+    msg.message_type = MessageType::GTP_CREATE_SESSION_REQ;
+    msg.payload_length = 180;
+    msg.src_ip = "10.1.2.3";
+    msg.dst_ip = "2001:db8::1";
+    msg.src_port = 2123;
+    msg.dst_port = 2124;
+    return msg;
+}
+
+}  // namespace
+
+TEST(StoredMessageTest, RoundTripsEveryField) {
+    SessionMessageRef msg = makeMessage(1000);
+    auto& key = msg.correlation_key;
+    key.imsi = "001010123456789";
+    key.supi = "imsi-001010123456789";
+    key.guti = "00101-0001-01-c0ffee01";
+    key.msisdn = "491510000001";
+    key.teid_s1u = 0x10000001;
+    key.teid_s5u = 0x20000002;
+    key.seid_n4 = 0x0100000000000003ULL;
+    key.pdu_session_id = 5;
+    key.eps_bearer_id = 6;
+    key.enb_ue_s1ap_id = 7;
+    key.mme_ue_s1ap_id = 8;
+    key.ran_ue_ngap_id = 9;
+    key.amf_ue_ngap_id = 1ULL << 40;
+    key.ue_ipv4 = "10.1.2.3";
+    key.ue_ipv6 = "2001:db8::1";
+    key.pgw_upf_ip = "192.0.2.1";
+    key.apn = "ims";
+    key.dnn = "internet";
+    key.network_instance = "core";
+    key.sip_call_id = std::string(300, 'c');  // Multi-byte length prefix
+    key.icid = "pcscf.ims-0001";
+    key.rtp_ssrc = 0xDEADBEEF;
+    key.procedure_type = ProcedureType::VOLTE_CALL_SETUP;
+    msg.parsed_data = {{"imsi", "001010123456789"},
+                       {"bearer_contexts", {{{"teid", 42}, {"ebi", 5}}}},
+                       {"ratio", 0.25}};
+
+    SessionLeg leg;
+    leg.append(msg);
+    ASSERT_EQ(leg.messages.size(), 1u);
+    SessionMessageRef out = leg.expand(leg.messages[0]);
+
+    EXPECT_EQ(out.message_id, msg.message_id);
+    EXPECT_EQ(out.packet_id, msg.packet_id);
+    EXPECT_EQ(out.timestamp, msg.timestamp);
+    EXPECT_EQ(out.interface, msg.interface);
+    EXPECT_EQ(out.protocol, msg.protocol);
+    EXPECT_EQ(out.message_type, msg.message_type);
+    EXPECT_EQ(out.payload_length, msg.payload_length);
+    EXPECT_EQ(out.src_ip, msg.src_ip);
+    EXPECT_EQ(out.dst_ip, msg.dst_ip);
+    EXPECT_EQ(out.src_port, msg.src_port);
+    EXPECT_EQ(out.dst_port, msg.dst_port);
+    EXPECT_EQ(out.parsed_data, msg.parsed_data);
+    EXPECT_EQ(out.correlation_key.toJson(), key.toJson());
+    EXPECT_EQ(out.correlation_key.procedure_type, ProcedureType::VOLTE_CALL_SETUP);
+}
+
+TEST(StoredMessageTest, KeepsTextThatDoesNotRoundTrip) {
+    SessionMessageRef msg = makeMessage(1);
+    msg.message_id = "msg_1";
+    msg.src_ip = "2001:DB8:0:0::1";  // Not in inet_ntop's canonical form
+    msg.dst_ip = "pcscf.example.com";
+
+    SessionLeg leg;
+    leg.append(msg);
+    SessionMessageRef out = leg.expand(leg.messages[0]);
+    EXPECT_EQ(out.message_id, "msg_1");
+    EXPECT_EQ(out.src_ip, "2001:DB8:0:0::1");
+    EXPECT_EQ(out.dst_ip, "pcscf.example.com");
+    EXPECT_TRUE(out.parsed_data.is_null());
+
+    // A message with no variable-length fields takes no blob space
+    SessionMessageRef bare;
+    bare.src_ip = "10.0.0.1";
+    leg.append(bare);
+    EXPECT_EQ(leg.messages[1].blob_length, 0u);
+    EXPECT_EQ(leg.expand(leg.messages[1]).src_ip, "10.0.0.1");
+}
+
+TEST(StoredMessageTest, FinalizeSortsRecordsAndKeepsBlobs) {
+    Session session;
+    session.start_time = Timestamp(std::chrono::milliseconds(1000));
+    session.end_time = session.start_time;
+    session.total_packets = 0;
+    session.total_bytes = 0;
+
+    std::vector<std::string> ids;
+    for (int64_t ms : {3000, 1000, 2000}) {
+        SessionMessageRef msg = makeMessage(ms);
+        msg.correlation_key.teid_s1u = static_cast<uint32_t>(ms);
+        ids.push_back(msg.message_id);
+        session.addMessage(msg);
+    }
+    session.finalize();
+
+    auto messages = session.getAllMessages();
+    ASSERT_EQ(messages.size(), 3u);
+    EXPECT_EQ(messages[0].message_id, ids[1]);
+    EXPECT_EQ(messages[1].message_id, ids[2]);
+    EXPECT_EQ(messages[2].message_id, ids[0]);
+    for (uint32_t i = 0; i < messages.size(); ++i) {
+        EXPECT_EQ(messages[i].sequence_in_session, i);
+        EXPECT_EQ(messages[i].correlation_key.teid_s1u,
+                  static_cast<uint32_t>(messages[i].timestamp.time_since_epoch() /
+                                        std::chrono::milliseconds(1)));
+    }
+    EXPECT_EQ(session.total_bytes, 3u * 180u);
+    EXPECT_EQ(session.toJson()["events_count"], 3);
+}
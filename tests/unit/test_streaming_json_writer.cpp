@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "event_extractor/json_exporter.h"
+#include "event_extractor/streaming_json_writer.h"
+
+using namespace callflow;
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("callflow_" + name)).string();
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+}  // namespace
+
+TEST(StreamingJsonWriterTest, WritesJsonDocumentWithRanges) {
+    auto path = tempPath("stream.json");
+
+    StreamingJsonWriter::Options options;
+    options.buffer_size = 16;  // Force several flushes
+    StreamingJsonWriter writer(options);
+    ASSERT_TRUE(writer.open(path, {{"job_id", "job-1"}}));
+
+    std::vector<StreamingJsonWriter::Range> ranges;
+    for (int i = 0; i < 50; ++i) {
+        ranges.push_back(writer.writeSession({{"session_id", "s-" + std::to_string(i)}, {"n", i}}));
+    }
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(writer.sessionsWritten(), 50u);
+
+    std::string contents = readFile(path);
+    EXPECT_EQ(writer.bytesWritten(), contents.size());
+
+    auto doc = nlohmann::json::parse(contents);
+    EXPECT_EQ(doc["metadata"]["job_id"], "job-1");
+    ASSERT_EQ(doc["sessions"].size(), 50u);
+
+    auto session = nlohmann::json::parse(contents.substr(ranges[42].offset, ranges[42].length));
+    EXPECT_EQ(session["n"], 42);
+
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingJsonWriterTest, EmptyDocumentIsValid) {
+    auto path = tempPath("stream_empty.json");
+    StreamingJsonWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    ASSERT_TRUE(writer.close());
+
+    auto doc = nlohmann::json::parse(readFile(path));
+    EXPECT_TRUE(doc["sessions"].empty());
+    EXPECT_FALSE(doc.contains("metadata"));
+
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingJsonWriterTest, WritesNdjsonLines) {
+    auto path = tempPath("stream.ndjson");
+    auto options = StreamingJsonWriter::optionsForPath(path);
+    EXPECT_EQ(options.format, StreamingJsonWriter::Format::NDJSON);
+    EXPECT_FALSE(options.gzip);
+
+    StreamingJsonWriter writer(options);
+    ASSERT_TRUE(writer.open(path, {{"job_id", "job-2"}}));
+    writer.writeSession({{"session_id", "a"}});
+    writer.writeSession({{"session_id", "b"}});
+    ASSERT_TRUE(writer.close());
+
+    std::ifstream in(path);
+    std::string line;
+    std::vector<nlohmann::json> lines;
+    while (std::getline(in, line)) {
+        lines.push_back(nlohmann::json::parse(line));
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0]["metadata"]["job_id"], "job-2");
+    EXPECT_EQ(lines[2]["session_id"], "b");
+
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingJsonWriterTest, GzipFollowsBuildSupport) {
+    auto path = tempPath("stream.ndjson.gz");
+    auto options = StreamingJsonWriter::optionsForPath(path);
+    EXPECT_TRUE(options.gzip);
+    EXPECT_EQ(options.format, StreamingJsonWriter::Format::NDJSON);
+
+    StreamingJsonWriter writer(options);
+    bool opened = writer.open(path);
+    EXPECT_EQ(opened, StreamingJsonWriter::gzipSupported());
+    if (opened) {
+        writer.writeSession({{"session_id", "gz"}});
+        ASSERT_TRUE(writer.close());
+
+        // gzip magic number
+        std::string contents = readFile(path);
+        ASSERT_GE(contents.size(), 2u);
+        EXPECT_EQ(static_cast<uint8_t>(contents[0]), 0x1f);
+        EXPECT_EQ(static_cast<uint8_t>(contents[1]), 0x8b);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(StreamingJsonWriterTest, ExporterStreamsSessionsToFile) {
+    auto path = tempPath("export.json");
+
+    auto session = std::make_shared<Session>();
+    session->session_id = "exported-1";
+    std::vector<std::shared_ptr<Session>> sessions = {session, nullptr};
+
+    JsonExporter exporter;
+    ASSERT_TRUE(exporter.exportToFile(path, sessions, true));
+
+    auto doc = nlohmann::json::parse(readFile(path));
+    ASSERT_EQ(doc["sessions"].size(), 1u);
+    EXPECT_EQ(doc["sessions"][0]["session_id"], "exported-1");
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "pcap_ingest/tcp_reassembler.h"
+
+using namespace callflow;
+
+namespace {
+
+const uint8_t kClient[4] = {10, 0, 0, 1};
+const uint8_t kServer[4] = {10, 0, 0, 2};
+
+FlowKey makeFlow(uint16_t src_port) {
+    FlowKey key;
+    key.src_ip = IpAddress::fromV4(kClient);
+    key.dst_ip = IpAddress::fromV4(kServer);
+    key.src_port = src_port;
+    key.dst_port = 3868;
+    key.protocol = 6;
+    return key;
+}
+
+ByteView view(const std::string& text) {
+    return ByteView(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+std::string str(ByteView bytes) {
+    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+class TcpReassemblerTest : public ::testing::Test {
+protected:
+    ByteView segment(TcpReassembler& r, uint16_t port, uint32_t seq, const std::string& data,
+                     bool syn = false, bool fin = false, int at_sec = 0) {
+        return r.processSegment(makeFlow(port), seq, view(data), syn, fin,
+                                start_ + std::chrono::seconds(at_sec));
+    }
+
+    Timestamp start_ = Timestamp(std::chrono::seconds(1700000000));
+};
+
+}  // namespace
+
+TEST_F(TcpReassemblerTest, InOrderDataIsReturnedInPlace) {
+    TcpReassembler r;
+    const std::string syn;
+    const std::string first = "CER part one|";
+    EXPECT_TRUE(segment(r, 40000, 1000, syn, true).empty());
+
+    ByteView out = r.processSegment(makeFlow(40000), 1001, view(first), false, false, start_);
+    EXPECT_EQ(out.data(), view(first).data());
+    EXPECT_EQ(str(out), first);
+    EXPECT_EQ(r.bufferedBytes(), 0u);
+    EXPECT_EQ(r.activeStreams(), 1u);
+}
+
+TEST_F(TcpReassemblerTest, FillsGapsAndTrimsRetransmissions) {
+    TcpReassembler r;
+    EXPECT_EQ(str(segment(r, 40000, 1, "aaaa")), "aaaa");
+
+    // Two segments ahead of a gap, one of them overlapping the other
+    EXPECT_TRUE(segment(r, 40000, 13, "dddd").empty());
+    EXPECT_TRUE(segment(r, 40000, 9, "cccccc").empty());
+    EXPECT_GT(r.bufferedBytes(), 0u);
+
+    // Closing the gap delivers everything buffered behind it, once
+    EXPECT_EQ(str(segment(r, 40000, 5, "bbbb")), "bbbbccccccdd");
+    EXPECT_EQ(r.bufferedBytes(), 0u);
+
+    // Pure retransmission, then one that carries new bytes at its end
+    EXPECT_TRUE(segment(r, 40000, 5, "bbbb").empty());
+    EXPECT_EQ(str(segment(r, 40000, 15, "ddeeee")), "eeee");
+    EXPECT_EQ(r.getStats().segments_buffered, 2u);
+}
+
+TEST_F(TcpReassemblerTest, HandlesSequenceWraparound) {
+    TcpReassembler r;
+    const uint32_t isn = 0xFFFFFFF8u;
+    EXPECT_TRUE(segment(r, 40000, isn, "", true).empty());
+    // isn + 1 + 8 wraps to 1
+    EXPECT_TRUE(segment(r, 40000, 1, "tail").empty());
+    EXPECT_EQ(str(segment(r, 40000, isn + 1, "headhead")), "headheadtail");
+}
+
+TEST_F(TcpReassemblerTest, ExpiresIdleStreamsAndCapsStreamCount) {
+    TcpReassembler::Limits limits;
+    limits.max_streams = 3;
+    limits.idle_timeout = std::chrono::seconds(60);
+    TcpReassembler r(limits);
+
+    for (uint16_t port = 1; port <= 3; ++port) {
+        segment(r, port, 100, "x", false, false, port);
+    }
+    EXPECT_EQ(r.activeStreams(), 3u);
+
+    // A fourth stream evicts the least recently active one (port 1)
+    segment(r, 2, 101, "y", false, false, 10);
+    segment(r, 4, 100, "x", false, false, 11);
+    EXPECT_EQ(r.activeStreams(), 3u);
+    EXPECT_EQ(r.getStats().streams_evicted, 1u);
+
+    // Port 3 has been idle since t=3
+    EXPECT_EQ(r.expire(start_ + std::chrono::seconds(65)), 1u);
+    EXPECT_EQ(r.activeStreams(), 2u);
+
+    // Control segments never create state
+    segment(r, 9, 100, "", false, true, 66);
+    EXPECT_EQ(r.activeStreams(), 2u);
+}
+
+TEST_F(TcpReassemblerTest, MemoryBudgetEvictsOldestBufferingStream) {
+    TcpReassembler::Limits limits;
+    limits.max_window_bytes = 64 * 1024;
+    limits.memory_budget_bytes = 8 * 1024;
+    TcpReassembler r(limits);
+
+    const std::string chunk(3000, 'z');
+    segment(r, 1, 0, "a");
+    segment(r, 2, 0, "a");
+    EXPECT_TRUE(segment(r, 1, 10, chunk).empty());  // 4 KB ring
+    EXPECT_TRUE(segment(r, 2, 10, chunk).empty());  // 4 KB ring, budget full
+    EXPECT_EQ(r.bufferedBytes(), 8u * 1024);
+
+    // Growing stream 2 past the budget evicts stream 1
+    EXPECT_TRUE(segment(r, 2, 4000, chunk).empty());
+    EXPECT_EQ(r.getStats().streams_evicted, 1u);
+    EXPECT_EQ(r.activeStreams(), 1u);
+    EXPECT_EQ(r.bufferedBytes(), 8u * 1024);
+
+    // Data beyond the window is dropped rather than buffered
+    EXPECT_TRUE(segment(r, 2, 70000, chunk).empty());
+    EXPECT_EQ(r.getStats().segments_dropped, 1u);
+}